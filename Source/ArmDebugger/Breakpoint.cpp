@@ -166,6 +166,16 @@ void Breakpoint::remove()
     }
 }
 
+//! @brief Records the state of a copy of the breakpoint applied by another
+//! thread which owns emulated memory.
+//! @param[in] isSet True if the BKPT instruction is in memory.
+//! @param[in] originalInstruction The instruction the breakpoint replaced.
+void Breakpoint::setApplied(bool isSet, uint32_t originalInstruction)
+{
+    _isSet = isSet;
+    _originalInstruction = originalInstruction;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Global Function Definitions
 ////////////////////////////////////////////////////////////////////////////////
@@ -64,6 +64,7 @@ public:
     // Operations
     bool apply();
     void remove();
+    void setApplied(bool isSet, uint32_t originalInstruction);
 private:
     // Internal Fields
     uint32_t *_hostAddress;
@@ -44,7 +44,13 @@ enum class Action : uint32_t
     ExecInto,
     ExecOut,
 
+    ToggleProfiling,
+    ExportProfile,
+    ToggleExecCounting,
+    ToggleTracing,
+
     GotoPC,
+    GotoHottestBlock,
 
     About,
 };
@@ -11,10 +11,16 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <sstream>
+
+#include <QFile>
 #include <QFileDialog>
 #include <QMessageBox>
 
 #include "Ag/Core/Utils.hpp"
+#include "ArmEmu/ExecutionCounters.hpp"
+#include "ArmEmu/ExecutionTrace.hpp"
+#include "ArmEmu/GuestProfiler.hpp"
 
 #include "CommandLineOptions.hpp"
 #include "DebuggerApp.hpp"
@@ -66,6 +72,8 @@ DebuggerApp::DebuggerApp(int &argc, char *argv[]) :
             this, &DebuggerApp::onEmulatorStopped);
     connect(&_session, &EmulatorSession::sessionResumed,
             this, &DebuggerApp::onEmulatorRunning);
+    connect(&_session, &EmulatorSession::sessionSingleStep,
+            this, &DebuggerApp::onEmulatorStopped);
     connect(&_session, &EmulatorSession::sessionStarted,
             this, &DebuggerApp::onEmulatorCreated);
     connect(&_session, &EmulatorSession::sessionEnded,
@@ -360,6 +368,110 @@ void DebuggerApp::onEditDisplayOptions()
     }
 }
 
+void DebuggerApp::onToggleProfiling(bool isEnabled)
+{
+    Arm::IArmSystem *emulator = _session.getEmulator();
+    Arm::GuestProfiler *profiler = (emulator == nullptr) ? nullptr :
+                                                           emulator->getProfiler();
+
+    if (profiler != nullptr)
+    {
+        // Start a fresh profile each time sampling is enabled, but only
+        // while the emulator thread is idle and not recording samples.
+        if (isEnabled && (_session.getState() == EmulatorState::Paused))
+        {
+            profiler->clear();
+        }
+
+        profiler->setEnabled(isEnabled);
+    }
+}
+
+void DebuggerApp::onExportProfile()
+{
+    Arm::IArmSystem *emulator = _session.getEmulator();
+    Arm::GuestProfiler *profiler = (emulator == nullptr) ? nullptr :
+                                                           emulator->getProfiler();
+    const QString foldedFilter = tr("Folded stacks (*.folded)");
+    const QString pprofFilter = tr("pprof profiles (*.pb)");
+    QFileDialog fileBrowser(_mainWindow);
+
+    fileBrowser.setFileMode(QFileDialog::AnyFile);
+    fileBrowser.setNameFilters({ foldedFilter, pprofFilter });
+    fileBrowser.setWindowTitle(tr("Export Profile"));
+    fileBrowser.setAcceptMode(QFileDialog::AcceptSave);
+
+    // Samples can only be read while the emulator thread is idle.
+    if ((profiler != nullptr) &&
+        (_session.getState() == EmulatorState::Paused) &&
+        (fileBrowser.exec() == QDialog::Accepted))
+    {
+        // Name functions using the address labels defined for the session.
+        Arm::GuestSymbolTable symbols;
+
+        for (const auto &label : _session.getSettings().getSymbolMap())
+        {
+            QByteArray utf8Symbol = label.second.toUtf8();
+
+            symbols.addSymbol(label.first,
+                              std::string_view(utf8Symbol.constData(),
+                                               utf8Symbol.size()));
+        }
+
+        std::ostringstream output(std::ios::out | std::ios::binary);
+
+        if (fileBrowser.selectedNameFilter() == pprofFilter)
+        {
+            profiler->writePprofProfile(output, symbols);
+        }
+        else
+        {
+            profiler->writeFoldedStacks(output, symbols);
+        }
+
+        QFile profileFile(fileBrowser.selectedFiles().first());
+        const std::string bytes = output.str();
+
+        if ((profileFile.open(QIODevice::WriteOnly | QIODevice::Truncate) == false) ||
+            (profileFile.write(bytes.data(), static_cast<qint64>(bytes.size())) < 0))
+        {
+            QMessageBox::warning(_mainWindow, tr("Export Error"),
+                                 profileFile.errorString(), QMessageBox::Ok);
+        }
+    }
+}
+
+void DebuggerApp::onToggleExecCounting(bool isEnabled)
+{
+    Arm::IArmSystem *emulator = _session.getEmulator();
+    Arm::ExecutionCounterTable *counters = (emulator == nullptr) ? nullptr :
+                                                                   emulator->getExecutionCounters();
+
+    if (counters != nullptr)
+    {
+        // Start counting afresh each time counting is enabled, but only
+        // while the emulator thread is idle and not updating the counts.
+        if (isEnabled && (_session.getState() == EmulatorState::Paused))
+        {
+            counters->clear();
+        }
+
+        counters->setEnabled(isEnabled);
+    }
+}
+
+void DebuggerApp::onToggleTracing(bool isEnabled)
+{
+    Arm::IArmSystem *emulator = _session.getEmulator();
+    Arm::ExecutionTrace *trace = (emulator == nullptr) ? nullptr :
+                                                         emulator->getExecutionTrace();
+
+    if (trace != nullptr)
+    {
+        trace->setEnabled(isEnabled);
+    }
+}
+
 void DebuggerApp::onShowHelpAbout()
 {
     AboutDialog aboutDialog(_mainWindow.get());
@@ -385,10 +497,24 @@ void DebuggerApp::onEmulatorCreated()
         Action::ExecInto,
         Action::ExecOut,
         Action::GotoPC,
+        Action::GotoHottestBlock,
+        Action::ToggleExecCounting,
+        Action::ToggleTracing,
      });
 
     _actions.updateActionState(false, {
         Action::PauseSession });
+
+    // Profiling is only possible if the session options allowed for it.
+    _actions.updateActionState(hasProfiler(), {
+        Action::ToggleProfiling,
+        Action::ExportProfile,
+    });
+
+    // Profiling, counting and tracing always start disabled in a new emulator.
+    _actions.getAction(Action::ToggleProfiling)->setChecked(false);
+    _actions.getAction(Action::ToggleExecCounting)->setChecked(false);
+    _actions.getAction(Action::ToggleTracing)->setChecked(false);
 }
 
 void DebuggerApp::onEmulatorDestroyed()
@@ -402,6 +528,11 @@ void DebuggerApp::onEmulatorDestroyed()
         Action::ExecInto,
         Action::ExecOut,
         Action::GotoPC,
+        Action::GotoHottestBlock,
+        Action::ToggleProfiling,
+        Action::ExportProfile,
+        Action::ToggleExecCounting,
+        Action::ToggleTracing,
     });
 }
 
@@ -493,10 +624,33 @@ void DebuggerApp::defineActions()
     currentAction->setToolTip("Executes until the current subroutine returns.");
     connect(currentAction, &QAction::triggered, &_session, &EmulatorSession::stepOut);
 
+    currentAction = _actions.addAction(Action::ToggleProfiling, ActionGroup::Debug, tr("&Profile Guest"));
+    currentAction->setCheckable(true);
+    currentAction->setToolTip("Samples the guest call stack while the emulator runs.");
+    connect(currentAction, &QAction::toggled, this, &DebuggerApp::onToggleProfiling);
+
+    currentAction = _actions.addAction(Action::ExportProfile, ActionGroup::Debug, tr("&Export Profile..."));
+    currentAction->setToolTip("Saves the samples gathered by the guest profiler for analysis in external tools.");
+    connect(currentAction, &QAction::triggered, this, &DebuggerApp::onExportProfile);
+
+    currentAction = _actions.addAction(Action::ToggleExecCounting, ActionGroup::Debug, tr("&Count Executions"));
+    currentAction->setCheckable(true);
+    currentAction->setToolTip("Counts how many times each instruction is executed and shows the counts as a heat map.");
+    connect(currentAction, &QAction::toggled, this, &DebuggerApp::onToggleExecCounting);
+
+    currentAction = _actions.addAction(Action::ToggleTracing, ActionGroup::Debug, tr("&Trace Execution"));
+    currentAction->setCheckable(true);
+    currentAction->setToolTip("Records each instruction executed and the registers it changed in the trace view.");
+    connect(currentAction, &QAction::toggled, this, &DebuggerApp::onToggleTracing);
+
     currentAction = _actions.addAction(Action::GotoPC, ActionGroup::CodeView, tr("&Goto PC"), ":/images/GotoPC.svg");
     currentAction->setShortcut(QKeySequence(Qt::Key_F12));
     currentAction->setToolTip("Displays the instruction at the current program counter address.");
 
+    currentAction = _actions.addAction(Action::GotoHottestBlock, ActionGroup::CodeView, tr("Goto &Hottest Block"));
+    currentAction->setShortcut(QKeySequence(Qt::SHIFT | Qt::Key_F12));
+    currentAction->setToolTip("Displays the next of the blocks of code which have consumed the most processor cycles.");
+
     currentAction = _actions.addAction(Action::About, ActionGroup::Help, tr("&About..."));
     currentAction->setShortcut(QKeySequence(QKeySequence::HelpContents));
     currentAction->setToolTip("Displays information about the program.");
@@ -600,9 +754,21 @@ void DebuggerApp::updateActions(bool isEmulatorRunning)
         Action::ExecInto,
         Action::ExecOut,
         Action::GotoPC,
+        Action::GotoHottestBlock,
+    });
+
+    _actions.updateActionState(!isEmulatorRunning && hasProfiler(), {
+        Action::ExportProfile,
     });
 }
 
+bool DebuggerApp::hasProfiler()
+{
+    Arm::IArmSystem *emulator = _session.getEmulator();
+
+    return (emulator != nullptr) && (emulator->getProfiler() != nullptr);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Global Function Definitions
 ////////////////////////////////////////////////////////////////////////////////
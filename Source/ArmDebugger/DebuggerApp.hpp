@@ -62,6 +62,10 @@ private slots:
     void onEditSWIs();
     void onEditLabels();
     void onEditDisplayOptions();
+    void onToggleProfiling(bool isEnabled);
+    void onExportProfile();
+    void onToggleExecCounting(bool isEnabled);
+    void onToggleTracing(bool isEnabled);
     void onShowHelpAbout();
     void onExit();
 
@@ -78,6 +82,7 @@ private:
     bool saveSession(bool forceNewFile);
     void updateTitle();
     void updateActions(bool isEmulatorRunning);
+    bool hasProfiler();
 
     // Internal Fields
     QPointer<QMainWindow> _mainWindow;
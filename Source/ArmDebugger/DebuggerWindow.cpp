@@ -34,6 +34,7 @@
 #include "UI/MemoryViewWidget.hpp"
 #include "UI/OutputViewWidget.hpp"
 #include "UI/RegisterViewWidget.hpp"
+#include "UI/TraceViewWidget.hpp"
 
 
 namespace Mo {
@@ -60,9 +61,11 @@ DebuggerWindow::DebuggerWindow() :
     QMainWindow(nullptr),
     _registersDock(nullptr),
     _outputDock(nullptr),
+    _traceDock(nullptr),
     _memoryView(nullptr),
     _registersView(nullptr),
     _outputView(nullptr),
+    _traceView(nullptr),
     _memoryRegionList(nullptr),
     _gotoAddrField(nullptr)
 {
@@ -199,6 +202,9 @@ void DebuggerWindow::setupWidgets(DebuggerApp *app)
     codeViewBar->addWidget(_gotoAddrField);
 
     codeViewBar->addAction(actions.getAction(Action::GotoPC));
+    codeViewBar->addAction(actions.getAction(Action::GotoHottestBlock));
+    connect(actions.getAction(Action::GotoHottestBlock), &QAction::triggered,
+            _memoryView, &MemoryViewWidget::displayNextHottestBlock);
 
     // Create side panel.
     _registersDock = new QDockWidget(tr("Registers"), this);
@@ -214,10 +220,19 @@ void DebuggerWindow::setupWidgets(DebuggerApp *app)
     _outputView = new OutputViewWidget(_outputDock);
     _outputDock->setWidget(_outputView);
 
+    _traceDock = new QDockWidget(tr("Trace"), this);
+    _traceDock->setAllowedAreas(Qt::DockWidgetArea::LeftDockWidgetArea |
+                                Qt::DockWidgetArea::RightDockWidgetArea |
+                                Qt::DockWidgetArea::BottomDockWidgetArea);
+
+    _traceView = new TraceViewWidget(_traceDock);
+    _traceDock->setWidget(_traceView);
+
     // NOTE: Keep to this ordering for the registers to appear first.
     addDockWidget(Qt::LeftDockWidgetArea, _registersDock);
     addDockWidget(Qt::LeftDockWidgetArea, _outputDock);
     tabifyDockWidget(_outputDock, _registersDock);
+    addDockWidget(Qt::BottomDockWidgetArea, _traceDock);
 
     onSessionEnded(nullptr);
 
@@ -256,6 +271,11 @@ void DebuggerWindow::setupMenus(DebuggerApp *app)
     action->setChecked(true);
     connect(action, &QAction::toggled, _outputDock, &QDockWidget::setVisible);
 
+    action = currentMenu->addAction(tr("Show &Trace"));
+    action->setCheckable(true);
+    action->setChecked(true);
+    connect(action, &QAction::toggled, _traceDock, &QDockWidget::setVisible);
+
     currentMenu->addAction(actions.getAction(Action::EditMemoryDisplayOptions));
 
     currentMenu = menuBar()->addMenu(tr("&Session"));
@@ -268,6 +288,11 @@ void DebuggerWindow::setupMenus(DebuggerApp *app)
     currentMenu->addAction(actions.getAction(Action::ExecInto));
     currentMenu->addAction(actions.getAction(Action::ExecOver));
     currentMenu->addAction(actions.getAction(Action::ExecOut));
+    currentMenu->addSeparator();
+    currentMenu->addAction(actions.getAction(Action::ToggleProfiling));
+    currentMenu->addAction(actions.getAction(Action::ExportProfile));
+    currentMenu->addAction(actions.getAction(Action::ToggleExecCounting));
+    currentMenu->addAction(actions.getAction(Action::ToggleTracing));
 
     currentMenu = menuBar()->addMenu(tr("&Help"));
     currentMenu->addAction(actions.getAction(Action::About));
@@ -35,6 +35,7 @@ class DebuggerApp;
 class MemoryViewWidget;
 class RegisterViewWidget;
 class OutputViewWidget;
+class TraceViewWidget;
 
 namespace Arm {
 class IArmSystem;
@@ -75,9 +76,11 @@ private:
     // Internal Fields
     QDockWidget *_registersDock;
     QDockWidget *_outputDock;
+    QDockWidget *_traceDock;
     MemoryViewWidget *_memoryView;
     RegisterViewWidget *_registersView;
     OutputViewWidget *_outputView;
+    TraceViewWidget *_traceView;
     QComboBox *_memoryRegionList;
     QLineEdit *_gotoAddrField;
 };
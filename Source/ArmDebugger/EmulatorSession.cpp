@@ -12,18 +12,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "EmulatorSession.hpp"
 
-#ifdef _MSC_VER
-// Disable compiler warning C4127: conditional expression is constant.
-// This is produced by including QtConcurrent.
-#pragma warning(disable : 4127)
-#endif
-
-#include <QtConcurrent>
 #include <QMessageBox>
 
+#include "Ag/Core/Utils.hpp"
 #include "Ag/QtInterop/Conversion.hpp"
 #include "ArmEmu/ArmSystemBuilder.hpp"
 #include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/HostMessageID.hpp"
 
 #include "DebuggerApp.hpp"
 #include "MemcIOAdapter.hpp"
@@ -52,39 +47,64 @@ public:
     }
 };
 
+//! @brief Identifies messages the emulator thread posts to the UI thread
+//! through the guest event queue alongside those posted by emulated hardware.
+enum SessionMessageID : uint32_t
+{
+    //! @brief The emulator stopped running, Data1 holds the
+    //! ExecutionMetrics::Result.
+    ExecutionComplete = Arm::HostMessageID::LastHostMessage,
+
+    //! @brief A single instruction was executed.
+    SingleStepComplete,
+
+    //! @brief A ReadMemory command completed, Data1 points to a
+    //! MemoryReadResult to be deleted by the receiver.
+    MemoryReadComplete,
+
+    //! @brief The emulator thread applied or removed a breakpoint, Data1 holds
+    //! the breakpoint ID with bit 16 set if it is in memory, Data2 holds the
+    //! instruction it replaced.
+    BreakpointUpdated,
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Local Data
 ////////////////////////////////////////////////////////////////////////////////
 constexpr uint16_t TempBreakpointID = 0xF000;
 constexpr uint16_t SeedBreakpointID = 0xF001;
 
+} // Anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
-// Local Functions
+// EmulatorSession::Command Member Function Definitions
 ////////////////////////////////////////////////////////////////////////////////
-Arm::ExecutionMetrics runEmulator(Arm::IArmSystem *emulator)
+EmulatorSession::Command::Command() :
+    Address(0),
+    Length(0),
+    Type(CommandType::Pause),
+    IsEnabled(false)
 {
-    return emulator->run();
 }
 
-} // Anonymous namespace
+EmulatorSession::Command::Command(CommandType type) :
+    Address(0),
+    Length(0),
+    Type(type),
+    IsEnabled(false)
+{
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // EmulatorSession Member Function Definitions
 ////////////////////////////////////////////////////////////////////////////////
 EmulatorSession::EmulatorSession(QObject *owner) :
     QObject(owner),
-    _emulatorPollTimer(this),
-    _emulatorWatcher(this),
-    _state(EmulatorState::Uninitialised)
+    _commands(16),
+    _state(EmulatorState::Uninitialised),
+    _areEventsPending(false),
+    _isExitRequested(false)
 {
-    connect(&_emulatorPollTimer, &QTimer::timeout,
-            this, &EmulatorSession::onPollEmulator);
-    connect(&_emulatorWatcher, &QEmulatorFutureWatcher::finished,
-            this, &EmulatorSession::onExecutionComplete);
-
-    _emulatorPollTimer.setSingleShot(false);
-    _emulatorPollTimer.setInterval(1);
-
     // DEBUG: Preset a valid config for quick testing.
     auto sessionOptions = _settings.getEmulatorOptions();
     sessionOptions.setHardwareArchitecture(Arm::SystemModel::Archimedies);
@@ -126,6 +146,13 @@ const BreakpointCollection &EmulatorSession::getBreakpoints() const
     return _breakpoints;
 }
 
+//! @brief Gets the metrics of the last run or single step, only valid
+//! while the session is paused.
+const Arm::ExecutionMetrics &EmulatorSession::getLastRunMetrics() const
+{
+    return _lastRunMetrics;
+}
+
 uint16_t EmulatorSession::addBreakpoint(uint32_t address, bool isLogicalAddress)
 {
     uint16_t id = 0;
@@ -162,7 +189,9 @@ uint16_t EmulatorSession::addBreakpoint(uint32_t address, bool isLogicalAddress)
         }
         else
         {
-            Breakpoint breakpoint(_emulator.get(), address, id, isLogicalAddress);
+            // Only the emulator thread touches emulated memory, it will
+            // report the state of the breakpoint once applied.
+            Breakpoint breakpoint(nullptr, address, id, isLogicalAddress);
 
             auto pos = std::lower_bound(_breakpoints.begin(), _breakpoints.end(),
                                         breakpoint, Breakpoint::CompareByAddress());
@@ -180,13 +209,13 @@ uint16_t EmulatorSession::addBreakpoint(uint32_t address, bool isLogicalAddress)
                     pos = _breakpoints.insert(pos, breakpoint);
                 }
 
-                pos->apply();
+                updateBreakpoint(*pos, true);
             }
             else
             {
                 _breakpoints.push_back(breakpoint);
 
-                _breakpoints.back().apply();
+                updateBreakpoint(_breakpoints.back(), true);
             }
 
             emit breakpointsChanged(this);
@@ -203,7 +232,7 @@ void EmulatorSession::removeBreakpoint(uint16_t id)
 
     if (pos != _breakpoints.end())
     {
-        pos->remove();
+        updateBreakpoint(*pos, false);
         _breakpoints.erase(pos);
 
         emit breakpointsChanged(this);
@@ -226,12 +255,12 @@ bool EmulatorSession::toggleBreakpoint(uint32_t address, bool isLogicalAddress)
 
         if (pos->isEnabled())
         {
-            pos->remove();
+            updateBreakpoint(*pos, false);
             _breakpoints.erase(pos);
         }
         else
         {
-            pos->apply();
+            updateBreakpoint(*pos, true);
         }
 
         emit breakpointsChanged(this);
@@ -257,15 +286,7 @@ bool EmulatorSession::setBreakpointState(uint16_t id, bool isEnabled)
 
     if (pos != _breakpoints.end())
     {
-        if (isEnabled)
-        {
-            isStateSet = pos->apply();
-        }
-        else
-        {
-            pos->remove();
-            isStateSet = true;
-        }
+        isStateSet = updateBreakpoint(*pos, isEnabled);
 
         if (isStateSet)
             emit breakpointsChanged(this);
@@ -307,6 +328,12 @@ void EmulatorSession::create(const Arm::Options &options)
         _emulator = builder.createSystem();
         _settings.setEmulatorOptions(options);
         _state = EmulatorState::Paused;
+        _isExitRequested.store(false);
+
+        // Start the thread which will drive the emulator for its lifetime
+        // and have it wake us when it has something to report.
+        _emulator->setEventListener(this);
+        _emulatorThread = std::thread(&EmulatorSession::runEmulatorThread, this);
 
         switch (options.getHardwareArchitecture())
         {
@@ -329,13 +356,30 @@ void EmulatorSession::destroy()
 {
     if (_emulator)
     {
-        // Stop the running system, if any.
-        if (_emulator->isRunning())
+        // Stop the emulator thread, interrupting the system if it is running.
+        // Messages it posts from now on may be dropped so that it can't
+        // block on a full queue which nobody is draining.
+        _isExitRequested.store(true);
+        postCommand(Command(CommandType::Exit));
+        _emulator->raiseHostInterrupt();
+
+        if (_emulatorThread.joinable())
         {
-            _emulator->raiseHostInterrupt();
+            _emulatorThread.join();
+        }
+
+        _appliedBreakpoints.clear();
+
+        // Discard any outstanding messages.
+        _emulator->setEventListener(nullptr);
+        Arm::GuestEvent emulatorEvent;
 
-            // Wait for emulator to stop running.
-            _emulatorWatcher.waitForFinished();
+        while (_emulator->tryGetNextMessage(emulatorEvent))
+        {
+            if (emulatorEvent.Type == SessionMessageID::MemoryReadComplete)
+            {
+                delete reinterpret_cast<MemoryReadResult *>(emulatorEvent.Data1);
+            }
         }
 
         _breakpoints.clear();
@@ -368,13 +412,13 @@ void EmulatorSession::restart()
 
         for (const auto &oldBreakpoint : oldBreakpoints)
         {
-            auto &bkpt = _breakpoints.emplace_back(_emulator.get(),
+            auto &bkpt = _breakpoints.emplace_back(nullptr,
                                                    oldBreakpoint.getAddress(),
                                                    oldBreakpoint.getBreakpointID(),
                                                    oldBreakpoint.isLogicalAddress());
-            if (oldBreakpoint.isEnabled() == false)
+            if (oldBreakpoint.isEnabled())
             {
-                bkpt.remove();
+                updateBreakpoint(bkpt, true);
             }
         }
     }
@@ -384,12 +428,11 @@ void EmulatorSession::step()
 {
     if (_emulator && (_state == EmulatorState::Paused))
     {
-        _emulator->runSingleStep();
-
-        // Drain the guest event queue.
-        onPollEmulator();
+        emit sessionResumed(_emulator.get());
 
-        emit sessionSingleStep(_emulator.get());
+        // The emulator thread will report back when the step is complete.
+        postCommand(Command(CommandType::Step));
+        _state = EmulatorState::Running;
     }
 }
 
@@ -417,27 +460,10 @@ void EmulatorSession::resume()
     {
         emit sessionResumed(_emulator.get());
 
-        // Determine if we are at a breakpoint which we need to step past.
-        uint32_t currentPC = _emulator->getCoreRegister(Arm::CoreRegister::PC);
-        size_t index;
-
-        if (tryFindBreakpointIndex(currentPC, index) &&
-            _breakpoints[index].isEnabled())
-        {
-            // We are on a breakpoint, restore the original instruction and
-            // execute it before continuing.
-            auto &currentBreakpoint = _breakpoints[index];
-            currentBreakpoint.remove();
-
-            _emulator->runSingleStep();
-            currentBreakpoint.apply();
-        }
-
-        beginPollingEmulator();
-
-        // Set the emulator to run without restriction.
-        QEmulatorFuture pendingResult = QtConcurrent::run(runEmulator, _emulator.get());
-        _emulatorWatcher.setFuture(pendingResult);
+        // Set the emulator to run without restriction, it will step past any
+        // breakpoint it is currently stopped on.
+        postCommand(Command(CommandType::Run));
+        _state = EmulatorState::Running;
     }
 }
 
@@ -445,15 +471,9 @@ void EmulatorSession::pause()
 {
     if (_emulator && (_state == EmulatorState::Running))
     {
-        // Raise a host interrupt in the emulator.
-        _emulator->raiseHostInterrupt();
-
-        // Wait for emulator to stop.
-        _emulatorWatcher.waitForFinished();
-
-        // Stop polling for event, but drain the guest event queue.
-        endPollingEmulator();
-        onPollEmulator();
+        // Interrupt the emulator, the sessionPaused() signal will be emitted
+        // once it has stopped.
+        postCommand(Command(CommandType::Pause));
     }
 }
 
@@ -464,115 +484,433 @@ void EmulatorSession::stop()
         if (_state == EmulatorState::Running)
         {
             pause();
+            waitUntilPaused();
         }
 
         _state = EmulatorState::Stopped;
 
         // Undo all break points so that the memory is in the correct state.
-        for (auto &breakpoint : _breakpoints)
+        for (const auto &breakpoint : _breakpoints)
         {
-            breakpoint.remove();
+            if (breakpoint.isEnabled())
+            {
+                updateBreakpoint(breakpoint, false);
+            }
         }
     }
 }
 
-void EmulatorSession::onPollEmulator()
+//! @brief Requests a copy of a region of emulated memory, the memoryRead()
+//! signal is emitted when it is available.
+//! @param[in] logicalAddr The logical address of the first byte to read.
+//! @param[in] length The count of bytes to read.
+//! @note If the system is running it will be briefly interrupted.
+void EmulatorSession::requestMemoryRead(uint32_t logicalAddr, uint32_t length)
 {
     if (_emulator)
     {
-        // Drain the emulator guest event queue.
-        Arm::GuestEvent emulatorEvent;
+        Command readCommand(CommandType::ReadMemory);
+        readCommand.Address = logicalAddr;
+        readCommand.Length = length;
 
-        while (_emulator->tryGetNextMessage(emulatorEvent))
+        postCommand(std::move(readCommand));
+    }
+}
+
+// Inherited from Arm::IGuestEventListener.
+void EmulatorSession::onGuestEventsPending()
+{
+    // Called on the emulator thread, wake the UI thread to drain the queue,
+    // whether it is idle in the event loop or blocked in waitUntilPaused().
+    QMetaObject::invokeMethod(this, &EmulatorSession::onProcessGuestEvents,
+                              Qt::QueuedConnection);
+
+    {
+        std::lock_guard<std::mutex> lock(_eventLock);
+        _areEventsPending = true;
+    }
+
+    _eventSignal.notify_one();
+}
+
+void EmulatorSession::onProcessGuestEvents()
+{
+    if (_emulator)
+    {
+        // Drain the emulator guest event queue a batch at a time.
+        Arm::GuestEvent batch[32];
+        size_t batchSize;
+
+        while ((batchSize = _emulator->tryGetNextMessages(batch, std::size(batch))) > 0)
         {
-            // Process guest event in the main thread.
-            if (_ioAdapter)
-                _ioAdapter->handleGuestEvent(emulatorEvent);
+            for (size_t i = 0; i < batchSize; ++i)
+            {
+                handleGuestEvent(batch[i]);
+            }
         }
     }
 }
 
+void EmulatorSession::handleGuestEvent(const Arm::GuestEvent &emulatorEvent)
+{
+    switch (emulatorEvent.Type)
+    {
+    case SessionMessageID::ExecutionComplete:
+        onExecutionComplete();
+        break;
+
+    case SessionMessageID::SingleStepComplete:
+        _state = EmulatorState::Paused;
+        emit sessionSingleStep(_emulator.get());
+        break;
+
+    case SessionMessageID::MemoryReadComplete: {
+        std::unique_ptr<MemoryReadResult> result(reinterpret_cast<MemoryReadResult *>(emulatorEvent.Data1));
+
+        emit memoryRead(result->Address, result->Data);
+    } break;
+
+    case SessionMessageID::BreakpointUpdated:
+        onBreakpointUpdated(static_cast<uint16_t>(emulatorEvent.Data1),
+                            (emulatorEvent.Data1 & 0x10000) != 0,
+                            static_cast<uint32_t>(emulatorEvent.Data2));
+        break;
+
+    default:
+        // Process guest event in the main thread.
+        if (_ioAdapter)
+            _ioAdapter->handleGuestEvent(emulatorEvent);
+        break;
+    }
+}
+
 void EmulatorSession::onExecutionComplete()
 {
     if (_emulator)
     {
+        // The emulator thread is now idle, we can access the system directly.
+        // It has already stepped back from any breakpoint it stopped on.
         _state = EmulatorState::Paused;
 
-        // Stop polling for emulator events and drain the queue.
-        _emulatorPollTimer.stop();
-        onPollEmulator();
+        emit sessionPaused(_emulator.get());
+    }
+}
+
+//! @brief Requests that a breakpoint is patched into or out of emulated memory.
+//! @param[in] breakpoint The breakpoint to update.
+//! @param[in] isEnabled True to write the BKPT instruction, false to restore
+//! the original instruction.
+//! @retval true The request was passed to the emulator thread.
+//! @retval false There is no emulated system to update.
+//! @details The emulator thread owns emulated memory whether running or not,
+//! so it patches its own copy of the breakpoint and reports the outcome,
+//! see onBreakpointUpdated().
+bool EmulatorSession::updateBreakpoint(const Breakpoint &breakpoint, bool isEnabled)
+{
+    bool isPosted = false;
+
+    if (_emulator)
+    {
+        Command command(CommandType::SetBreakpoint);
+        command.Target = breakpoint;
+        command.IsEnabled = isEnabled;
+
+        postCommand(std::move(command));
+        isPosted = true;
+    }
+
+    return isPosted;
+}
+
+//! @brief Records the state of a breakpoint reported by the emulator thread.
+//! @param[in] id The identifier of the breakpoint.
+//! @param[in] isSet True if the BKPT instruction is in emulated memory.
+//! @param[in] originalInstruction The instruction the breakpoint replaced.
+void EmulatorSession::onBreakpointUpdated(uint16_t id, bool isSet,
+                                          uint32_t originalInstruction)
+{
+    auto pos = std::find_if(_breakpoints.begin(), _breakpoints.end(),
+                            EqualsBreakpointID(id));
+
+    // The breakpoint may have been deleted since the update was requested.
+    if (pos != _breakpoints.end())
+    {
+        pos->setApplied(isSet, originalInstruction);
 
-        size_t breakpointIndex;
-        uint32_t lastPC = _emulator->getCoreRegister(Arm::CoreRegister::PC) - 4;
+        emit breakpointsChanged(this);
+    }
+}
+
+//! @brief Passes a command to the emulator thread, interrupting the emulated
+//! system if it is running so that the command is processed promptly.
+//! @param[in] command The command to post.
+void EmulatorSession::postCommand(Command &&command)
+{
+    _commands.enqueue(std::move(command));
 
-        // If we stopped after executing a breakpoint, disable it and step
-        // back so that next time we execute the actual instruction.
-        if (tryFindBreakpointIndex(lastPC, breakpointIndex))
+    if (_state == EmulatorState::Running)
+    {
+        _emulator->raiseHostInterrupt();
+    }
+}
+
+//! @brief Blocks the UI thread until the emulator thread reports that the
+//! emulated system has stopped running.
+//! @details The thread sleeps until messages are posted and drains them each
+//! time it wakes, as the emulator thread may need space in the queue before
+//! it can report that it has stopped.
+void EmulatorSession::waitUntilPaused()
+{
+    onProcessGuestEvents();
+
+    while (_emulator && (_state == EmulatorState::Running))
+    {
         {
-            _breakpoints[breakpointIndex].remove();
-            _emulator->setCoreRegister(Arm::CoreRegister::PC, lastPC);
+            std::unique_lock<std::mutex> lock(_eventLock);
+            _eventSignal.wait(lock, [this]() { return _areEventsPending; });
+            _areEventsPending = false;
         }
-        else if (_stepBreakpoint.getAddress() == lastPC)
+
+        onProcessGuestEvents();
+    }
+}
+
+//! @brief The entry point of the thread which drives the emulated system.
+void EmulatorSession::runEmulatorThread()
+{
+    Command command;
+    bool isRunning = false;
+    bool isExiting = false;
+
+    while (isExiting == false)
+    {
+        if (isRunning)
         {
-            _emulator->setCoreRegister(Arm::CoreRegister::PC, lastPC);
+            // Process commands which arrived while the system was running.
+            while ((isExiting == false) && _commands.try_dequeue(command))
+            {
+                processCommand(command, isRunning, isExiting);
+            }
+        }
+        else
+        {
+            // Wait for something to do.
+            _commands.wait_dequeue(command);
+            processCommand(command, isRunning, isExiting);
         }
 
-        // Ensure any temporary breakpoint applied for a step command
-        // is disabled.
-        _stepBreakpoint.remove();
+        if (isRunning && (isExiting == false))
+        {
+            _lastRunMetrics = _emulator->run();
 
-        emit sessionPaused(_emulator.get());
+            if (_lastRunMetrics.ExecResult != Arm::ExecutionMetrics::Result::HostIrq)
+            {
+                // The system stopped of its own accord, e.g. at a breakpoint.
+                isRunning = false;
+                rewindFromBreakpoint();
+                postSessionMessage(SessionMessageID::ExecutionComplete,
+                                   Ag::toScalar(_lastRunMetrics.ExecResult), 0);
+            }
+        }
     }
 }
 
-bool EmulatorSession::tryFindBreakpointIndex(uint32_t address,
-                                             size_t &index) const
+//! @brief Performs a command on the emulator thread.
+//! @param[in] command The command to perform.
+//! @param[in,out] isRunning Whether the emulated system should be running.
+//! @param[out] isExiting Set to true if the thread should exit.
+void EmulatorSession::processCommand(const Command &command, bool &isRunning,
+                                     bool &isExiting)
 {
-    bool isFound = false;
-    Breakpoint key(nullptr, address, 0, true);
+    switch (command.Type)
+    {
+    case CommandType::Run:
+        if (isRunning == false)
+        {
+            stepPastBreakpoint();
+        }
 
-    // Try searching by logical address first.
-    auto pos = std::lower_bound(_breakpoints.begin(), _breakpoints.end(),
-                                key, Breakpoint::CompareByAddress());
+        isRunning = true;
+        break;
 
-    if ((pos != _breakpoints.end()) &&
-        (pos->getAddress() == address) &&
-        (pos->isLogicalAddress() == true))
+    case CommandType::Step:
+        if (isRunning == false)
+        {
+            _lastRunMetrics = _emulator->runSingleStep();
+            postSessionMessage(SessionMessageID::SingleStepComplete, 0, 0);
+        }
+        break;
+
+    case CommandType::Pause:
+        if (isRunning)
+        {
+            isRunning = false;
+            postSessionMessage(SessionMessageID::ExecutionComplete,
+                               Ag::toScalar(Arm::ExecutionMetrics::Result::HostIrq), 0);
+        }
+        break;
+
+    case CommandType::SetBreakpoint:
+        applyBreakpoint(command.Target, command.IsEnabled);
+        break;
+
+    case CommandType::ReadMemory: {
+        auto result = std::make_unique<MemoryReadResult>();
+        result->Address = command.Address;
+        result->Data.resize(static_cast<qsizetype>(command.Length));
+
+        uint32_t bytesRead = Arm::readFromLogicalAddress(_emulator.get(), command.Address,
+                                                         result->Data.data(), command.Length);
+        result->Data.truncate(static_cast<qsizetype>(bytesRead));
+
+        if (postSessionMessage(SessionMessageID::MemoryReadComplete,
+                               reinterpret_cast<uintptr_t>(result.get()), 0))
+        {
+            // The UI thread now owns the result.
+            result.release();
+        }
+    } break;
+
+    case CommandType::Exit:
+        isRunning = false;
+        isExiting = true;
+        break;
+    }
+}
+
+//! @brief Patches a breakpoint into or out of emulated memory on the
+//! emulator thread and reports the outcome to the UI thread.
+//! @param[in] target A description of the breakpoint to update.
+//! @param[in] isEnabled True to write the BKPT instruction, false to restore
+//! the original instruction.
+void EmulatorSession::applyBreakpoint(const Breakpoint &target, bool isEnabled)
+{
+    auto pos = std::find_if(_appliedBreakpoints.begin(), _appliedBreakpoints.end(),
+                            EqualsBreakpointID(target.getBreakpointID()));
+
+    if (pos != _appliedBreakpoints.end())
     {
-        isFound = true;
-        index = std::distance(_breakpoints.begin(), pos);
+        if (isEnabled == false)
+        {
+            pos->remove();
+            postBreakpointState(*pos);
+            _appliedBreakpoints.erase(pos);
+        }
+        else
+        {
+            postBreakpointState(*pos);
+        }
     }
     else
     {
-        // Try searching physical addresses.
-        key = Breakpoint(nullptr, address, 0, false);
+        // Capture the original instruction on the thread which owns memory.
+        Breakpoint breakpoint(_emulator.get(), target.getAddress(),
+                              target.getBreakpointID(),
+                              target.isLogicalAddress());
+
+        if (isEnabled && breakpoint.apply())
+        {
+            _appliedBreakpoints.push_back(breakpoint);
+        }
 
-        pos = std::lower_bound(_breakpoints.begin(), _breakpoints.end(),
-                               key, Breakpoint::CompareByAddress());
+        postBreakpointState(breakpoint);
+    }
+}
+
+//! @brief Finds a breakpoint applied by the emulator thread.
+//! @param[in] address The logical or physical address of the breakpoint.
+//! @return The breakpoint or nullptr if none is applied at the address.
+Breakpoint *EmulatorSession::findAppliedBreakpoint(uint32_t address)
+{
+    Breakpoint *match = nullptr;
 
-        if ((pos != _breakpoints.end()) &&
-            (pos->getAddress() == address) &&
-            (pos->isLogicalAddress() == false))
+    for (auto &breakpoint : _appliedBreakpoints)
+    {
+        if (breakpoint.getAddress() == address)
         {
-            isFound = true;
-            index = std::distance(_breakpoints.begin(), pos);
+            match = &breakpoint;
+            break;
         }
     }
 
-    return isFound;
+    return match;
 }
 
-void EmulatorSession::beginPollingEmulator()
+//! @brief Executes the instruction replaced by a breakpoint the emulated
+//! system is stopped on before re-instating it, so that running resumes.
+void EmulatorSession::stepPastBreakpoint()
 {
-    if (_emulator)
+    uint32_t currentPC = _emulator->getCoreRegister(Arm::CoreRegister::PC);
+    Breakpoint *current = findAppliedBreakpoint(currentPC);
+
+    if (current != nullptr)
+    {
+        current->remove();
+        _emulator->runSingleStep();
+        current->apply();
+    }
+}
+
+//! @brief Steps the program counter back after the emulated system stopped
+//! on a breakpoint, removing it so that next time the actual instruction is
+//! executed.
+void EmulatorSession::rewindFromBreakpoint()
+{
+    uint32_t lastPC = _emulator->getCoreRegister(Arm::CoreRegister::PC) - 4;
+    Breakpoint *breakpoint = findAppliedBreakpoint(lastPC);
+
+    if (breakpoint != nullptr)
+    {
+        breakpoint->remove();
+        postBreakpointState(*breakpoint);
+        _appliedBreakpoints.erase(_appliedBreakpoints.begin() +
+                                  (breakpoint - _appliedBreakpoints.data()));
+        _emulator->setCoreRegister(Arm::CoreRegister::PC, lastPC);
+    }
+    else if (_stepBreakpoint.getAddress() == lastPC)
     {
-        _emulatorPollTimer.start();
+        _emulator->setCoreRegister(Arm::CoreRegister::PC, lastPC);
     }
+
+    // Ensure any temporary breakpoint applied for a step command
+    // is disabled.
+    _stepBreakpoint.remove();
+}
+
+//! @brief Reports the state of a breakpoint from the emulator thread to the
+//! UI thread.
+//! @param[in] breakpoint The breakpoint which has been updated.
+void EmulatorSession::postBreakpointState(const Breakpoint &breakpoint)
+{
+    uintptr_t state = breakpoint.getBreakpointID();
+
+    if (breakpoint.isEnabled())
+    {
+        state |= 0x10000;
+    }
+
+    postSessionMessage(SessionMessageID::BreakpointUpdated, state,
+                       breakpoint.getInstruction());
 }
 
-void EmulatorSession::endPollingEmulator()
+//! @brief Posts a message from the emulator thread to the UI thread, waiting
+//! for space in the queue rather than losing it.
+//! @retval true The message was posted.
+//! @retval false The session is being destroyed and the queue was full, so
+//! the message was dropped rather than waiting for a UI thread which is
+//! waiting for this thread to exit.
+bool EmulatorSession::postSessionMessage(uint32_t type, uintptr_t data1,
+                                         uintptr_t data2)
 {
-    _emulatorPollTimer.stop();
+    bool isPosted = _emulator->postMessageToHost(type, data1, data2);
+
+    while ((isPosted == false) && (_isExitRequested.load() == false))
+    {
+        std::this_thread::yield();
+        isPosted = _emulator->postMessageToHost(type, data1, data2);
+    }
+
+    return isPosted;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
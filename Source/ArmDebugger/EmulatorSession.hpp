@@ -13,12 +13,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
-#include <QFutureWatcher>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <QByteArray>
 #include <QObject>
-#include <QTimer>
+
+#include "readerwriterqueue.h"
 
 #include "ArmEmu/EmuOptions.hpp"
 #include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/GuestEventQueue.hpp"
 
 #include "Breakpoint.hpp"
 #include "EmulatorIOAdapter.hpp"
@@ -50,7 +57,13 @@ enum class EmulatorState
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief An object which manages the running emulated machine.
-class EmulatorSession : public QObject
+//! @details The emulated system is driven by a dedicated thread which lives
+//! as long as the system does. It receives commands through a lock-free queue
+//! and reports back through the system's guest event queue. While the session
+//! is Paused the thread is idle and the UI thread may read the system state
+//! directly, but emulated memory is only ever patched on the emulator thread,
+//! which reports the resulting state of each breakpoint back to the UI.
+class EmulatorSession : public QObject, public Arm::IGuestEventListener
 {
 Q_OBJECT
 public:
@@ -67,6 +80,7 @@ public:
     SessionSettings &getSettings();
     const SessionSettings &getSettings() const;
     const BreakpointCollection &getBreakpoints() const;
+    const Arm::ExecutionMetrics &getLastRunMetrics() const;
 
     // Operations
     uint16_t addBreakpoint(uint32_t address, bool isLogicalAddress);
@@ -76,6 +90,11 @@ public:
     bool tryFindBreakpoint(uint32_t address, bool isLogicalAddress, uint16_t &id) const;
 
     void create(const Arm::Options &options);
+    void requestMemoryRead(uint32_t logicalAddr, uint32_t length);
+
+    // Overrides
+    // Inherited from Arm::IGuestEventListener.
+    virtual void onGuestEventsPending() override;
 
 public slots:
     void destroy();
@@ -94,28 +113,81 @@ signals:
     void sessionResumed(Arm::IArmSystem *emulator);
     void sessionSingleStep(Arm::IArmSystem *emulator);
     void breakpointsChanged(const EmulatorSession *session);
+    void memoryRead(uint32_t logicalAddr, const QByteArray &data);
 
 private slots:
-    void onPollEmulator();
-    void onExecutionComplete();
+    void onProcessGuestEvents();
 private:
     // Internal Types
-    using QEmulatorFuture = QFuture<Arm::ExecutionMetrics>;
-    using QEmulatorFutureWatcher = QFutureWatcher<Arm::ExecutionMetrics>;
+    //! @brief Identifies an operation requested of the emulator thread.
+    enum class CommandType : uint8_t
+    {
+        Run,
+        Step,
+        Pause,
+        SetBreakpoint,
+        ReadMemory,
+        Exit,
+    };
+
+    //! @brief Describes an operation requested of the emulator thread.
+    struct Command
+    {
+        //! @brief The breakpoint to apply or remove.
+        Breakpoint Target;
+        uint32_t Address;
+        uint32_t Length;
+        CommandType Type;
+        bool IsEnabled;
+
+        Command();
+        Command(CommandType type);
+    };
+
+    //! @brief The result of a ReadMemory command, owned by the UI thread
+    //! once posted.
+    struct MemoryReadResult
+    {
+        QByteArray Data;
+        uint32_t Address;
+    };
+
+    using CommandQueue = moodycamel::BlockingReaderWriterQueue<Command>;
 
     // Internal Functions
-    bool tryFindBreakpointIndex(uint32_t address, size_t &index) const;
-    void beginPollingEmulator();
-    void endPollingEmulator();
+    bool updateBreakpoint(const Breakpoint &breakpoint, bool isEnabled);
+    void onBreakpointUpdated(uint16_t id, bool isSet, uint32_t originalInstruction);
+    void postCommand(Command &&command);
+    void waitUntilPaused();
+    void handleGuestEvent(const Arm::GuestEvent &emulatorEvent);
+    void onExecutionComplete();
+    void runEmulatorThread();
+    void processCommand(const Command &command, bool &isRunning, bool &isExiting);
+    void applyBreakpoint(const Breakpoint &target, bool isEnabled);
+    Breakpoint *findAppliedBreakpoint(uint32_t address);
+    void stepPastBreakpoint();
+    void rewindFromBreakpoint();
+    void postBreakpointState(const Breakpoint &breakpoint);
+    bool postSessionMessage(uint32_t type, uintptr_t data1, uintptr_t data2);
 
     // Internal Fields
-    QTimer _emulatorPollTimer;
-    QEmulatorFutureWatcher _emulatorWatcher;
+    CommandQueue _commands;
+    std::thread _emulatorThread;
+    Arm::ExecutionMetrics _lastRunMetrics;
     Arm::IArmSystemUPtr _emulator;
     IEmulatorIOAdapterUPtr _ioAdapter;
     BreakpointCollection _breakpoints;
     SessionSettings _settings;
     EmulatorState _state;
+
+    // Fields shared with the emulator thread.
+    std::mutex _eventLock;
+    std::condition_variable _eventSignal;
+    bool _areEventsPending;
+    std::atomic_bool _isExitRequested;
+
+    // Fields owned by the emulator thread.
+    BreakpointCollection _appliedBreakpoints;
     Breakpoint _stepBreakpoint;
 };
 
@@ -113,6 +113,8 @@ void writeOptions(QJsonObject &parent, Ag::utf8_cptr_t key,
     setJsonValue(jsonOpts, "Processor", Arm::getProcessorModelType(),
                  options.getProcessorVariant());
     setJsonValue(jsonOpts, "ProcessorSpeed", options.getProcessorSpeedMHz());
+    jsonOpts.insert("RealTimePacing", options.isRealTimePacingEnabled());
+    jsonOpts.insert("GuestProfiling", options.isGuestProfilingEnabled());
     setJsonValue(jsonOpts, "RAMSize", options.getRamSizeKb());
     setJsonValue(jsonOpts, "SystemROM", Arm::getSystemROMPresetType(),
                  options.getSystemRom());
@@ -158,6 +160,18 @@ bool readOptions(const QJsonObject &parent, Ag::utf8_cptr_t key,
             options.setProcessorSpeedMHz(static_cast<uint16_t>(uint32Value));
         }
 
+        bool boolValue;
+
+        if (tryGetJsonValue(jsonOpts, "RealTimePacing", boolValue))
+        {
+            options.setRealTimePacing(boolValue);
+        }
+
+        if (tryGetJsonValue(jsonOpts, "GuestProfiling", boolValue))
+        {
+            options.setGuestProfiling(boolValue);
+        }
+
         if (tryGetJsonValue(jsonOpts, "RAMSize", uint32Value))
         {
             options.setRamSizeKb(uint32Value);
@@ -203,6 +203,21 @@ bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, uint32_t &v
     return hasValue;
 }
 
+bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, bool &value)
+{
+    QJsonValue jsonValue;
+    bool hasValue = false;
+    value = false;
+
+    if (tryGetJsonValue(parent, key, jsonValue) && jsonValue.isBool())
+    {
+        value = jsonValue.toBool();
+        hasValue = true;
+    }
+
+    return hasValue;
+}
+
 bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, QString &value)
 {
     QJsonValue jsonValue;
@@ -73,6 +73,7 @@ bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, QJsonValue
 bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, QJsonObject &value);
 bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, QJsonArray &value);
 bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, uint32_t &value);
+bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, bool &value);
 bool tryGetJsonValue(const QJsonObject &parent, Ag::utf8_cptr_t key, QString &value);
 
 template<typename TEnum, typename TEnumSymbol = Ag::EnumSymbol<TEnum>>
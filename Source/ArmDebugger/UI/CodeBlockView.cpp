@@ -257,12 +257,26 @@ void CodeBlockView::draw(const BlockViewContext &context,
     auto *formatter = context.getInstructionFormatter();
     formatter->setFlags(context.getOptions().getAssemblyFormatFlags());
 
+    const Arm::ExecutionCounterTable *counters = context.getExecutionCounters();
+
     while ((clientY < updateRegion.bottom()) &&
             tryGetNextInstruction(info))
     {
         QRectF lineBounds(context.getMarginWidth() - scrollOrigin.x(),
                           clientY, getExtents().width(), _lineHeight);
 
+        // Draw the execution count heat map in the gutter of the margin.
+        Arm::ExecutionCount count;
+        QRectF gutterBounds(-scrollOrigin.x(), clientY,
+                            context.getMarginWidth() * HeatGutterProportion,
+                            _lineHeight);
+
+        if ((counters != nullptr) && gutterBounds.intersects(updateRegion) &&
+            counters->tryGetCount(info.ExecAddress, count))
+        {
+            painter->fillRect(gutterBounds, context.getHeatColour(count));
+        }
+
         if (lineBounds.intersects(updateRegion))
         {
             // Draw the instruction text.
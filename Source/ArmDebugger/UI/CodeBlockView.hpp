@@ -113,6 +113,10 @@ private:
 
     static constexpr uint32_t FormatFlags = Asm::FormatterOptions::UseCoreRegAliases;
     static constexpr double Spacing = 4.0;
+
+    //! @brief The proportion of the margin width used to display the
+    //! execution count heat map.
+    static constexpr double HeatGutterProportion = 0.25;
 };
 ////////////////////////////////////////////////////////////////////////////////
 // Function Declarations
@@ -11,6 +11,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
 #include <set>
 
 #include "MemoryBlockView.hpp"
@@ -119,6 +121,8 @@ public:
 // BlockViewContext Member Function Definitions
 ////////////////////////////////////////////////////////////////////////////////
 BlockViewContext::BlockViewContext(const SessionSettings &settings) :
+    _execCounters(nullptr),
+    _heatScale(0.0),
     _spacing(4),
     _marginWidth(16),
     _addressWidth(0),
@@ -251,6 +255,40 @@ Asm::FormatterOptions *BlockViewContext::getInstructionFormatter() const
     return _formatter.get();
 }
 
+const Arm::ExecutionCounterTable *BlockViewContext::getExecutionCounters() const
+{
+    return _execCounters;
+}
+
+void BlockViewContext::setExecutionCounters(const Arm::ExecutionCounterTable *counters)
+{
+    _execCounters = nullptr;
+    _heatScale = 0.0;
+
+    if ((counters != nullptr) && (counters->isEmpty() == false))
+    {
+        // Scale logarithmically so that code executed a handful of times
+        // can be distinguished from code which never executed.
+        uint64_t maxExecutions = counters->getMaxExecutions();
+
+        if (maxExecutions > 0)
+        {
+            _execCounters = counters;
+            _heatScale = 1.0 / std::log1p(static_cast<double>(maxExecutions));
+        }
+    }
+}
+
+QColor BlockViewContext::getHeatColour(const Arm::ExecutionCount &count) const
+{
+    // Shade from blue for rarely executed code to red for the hottest.
+    constexpr double ColdHue = 240.0 / 360.0;
+    double heat = std::clamp(std::log1p(static_cast<double>(count.Executions)) * _heatScale,
+                             0.0, 1.0);
+
+    return QColor::fromHsvF(ColdHue * (1.0 - heat), 1.0, 1.0);
+}
+
 void BlockViewContext::resetSizes()
 {
     if (_metrics)
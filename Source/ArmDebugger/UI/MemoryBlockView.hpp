@@ -22,6 +22,7 @@
 
 #include "Ag/Core/LinearSortedMap.hpp"
 
+#include "ArmEmu/ExecutionCounters.hpp"
 #include "AsmTools/InstructionInfo.hpp"
 
 #include "SessionSettings.hpp"
@@ -95,6 +96,9 @@ public:
     const QColor &getColour(TokenType tokenClass) const;
     const QColor &getColour(BlockElementType elementType) const;
     Asm::FormatterOptions *getInstructionFormatter() const;
+    const Arm::ExecutionCounterTable *getExecutionCounters() const;
+    void setExecutionCounters(const Arm::ExecutionCounterTable *counters);
+    QColor getHeatColour(const Arm::ExecutionCount &count) const;
 
     // Operations
     void resetSizes();
@@ -115,6 +119,8 @@ private:
     QFont _codeFont;
     QFontMetricsFUPtr _metrics;
     FormatterOptionsUPtr _formatter;
+    const Arm::ExecutionCounterTable *_execCounters;
+    double _heatScale;
     QColor _defaultColor;
     std::map<uint32_t, QColor> _tokenColours;
     double _spacing;
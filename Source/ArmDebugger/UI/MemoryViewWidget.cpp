@@ -558,7 +558,8 @@ MemoryViewWidget::MemoryViewWidget(QWidget *ownerObject, const SessionSettings &
     _blockContext(settings),
     _emulator(nullptr),
     _extents(0, 0),
-    _currentOffset(0)
+    _currentOffset(0),
+    _nextHotBlock(0)
 {
     setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
@@ -575,6 +576,8 @@ MemoryViewWidget::MemoryViewWidget(QWidget *ownerObject, const SessionSettings &
                 this, &MemoryViewWidget::updateStateFromEmulator);
         connect(&app->getSession(), &EmulatorSession::sessionPaused,
                 this, &MemoryViewWidget::updateStateFromEmulator);
+        connect(&app->getSession(), &EmulatorSession::sessionResumed,
+                this, &MemoryViewWidget::onSessionResumed);
 
         connect(&app->getSession(), &EmulatorSession::breakpointsChanged,
                 this, &MemoryViewWidget::onBreakpointChange);
@@ -861,6 +864,30 @@ void MemoryViewWidget::mouseReleaseEvent(QMouseEvent *args)
     }
 }
 
+void MemoryViewWidget::displayNextHottestBlock()
+{
+    // The number of blocks cycled through by repeated navigation.
+    constexpr size_t MaxHotBlocks = 16;
+
+    const Arm::ExecutionCounterTable *counters = _blockContext.getExecutionCounters();
+
+    if ((_emulator != nullptr) && (counters != nullptr))
+    {
+        std::vector<Arm::HotBlock> hotBlocks = counters->findHottestBlocks(MaxHotBlocks);
+
+        if (hotBlocks.empty() == false)
+        {
+            if (_nextHotBlock >= hotBlocks.size())
+            {
+                // Wrap around to the hottest block.
+                _nextHotBlock = 0;
+            }
+
+            displayAddress(_emulator, hotBlocks[_nextHotBlock++].StartAddr);
+        }
+    }
+}
+
 void MemoryViewWidget::onSessionStarted(const Arm::Options &/*options*/,
                                         Arm::IArmSystem *emulator)
 {
@@ -870,26 +897,24 @@ void MemoryViewWidget::onSessionStarted(const Arm::Options &/*options*/,
 void MemoryViewWidget::onSessionEnded(Arm::IArmSystem */*emulator*/)
 {
     _emulator = nullptr;
+    _blockContext.setExecutionCounters(nullptr);
 }
 
-void MemoryViewWidget::updateStateFromEmulator(Arm::IArmSystem *emulator)
+void MemoryViewWidget::onSessionResumed(Arm::IArmSystem */*emulator*/)
 {
-    Arm::IAddressRegionPtr region;
-    Arm::PageMapping mapping;
-    uint32_t offset, bytesRemaining;
-    uint32_t currentPC = emulator->getCoreRegister(Arm::CoreRegister::PC);
-
-    if (_logicalMemory.containsAddress(currentPC))
+    // Execution counts can't be read while the emulator updates them.
+    if (_blockContext.getExecutionCounters() != nullptr)
     {
-        displayRegion(_logicalMemory, currentPC - _logicalMemory.BaseAddress);
+        _blockContext.setExecutionCounters(nullptr);
+        updateMargin();
     }
-    else if (emulator->getReadAddresses().tryFindRegion(currentPC, region,
-                                                        offset, bytesRemaining))
-    {
-        MemoryRegion selectedRegion(currentPC - offset, region->getSize(), false);
+}
 
-        displayRegion(selectedRegion, offset);
-    }
+void MemoryViewWidget::updateStateFromEmulator(Arm::IArmSystem *emulator)
+{
+    refreshExecutionCounters(emulator);
+
+    displayAddress(emulator, emulator->getCoreRegister(Arm::CoreRegister::PC));
 }
 
 void MemoryViewWidget::onColourSchemeChange(Qt::ColorScheme /*newColourScheme*/)
@@ -1104,6 +1129,34 @@ void MemoryViewWidget::updateMargin()
     }
 }
 
+void MemoryViewWidget::displayAddress(Arm::IArmSystem *emulator, uint32_t address)
+{
+    Arm::IAddressRegionPtr region;
+    uint32_t offset, bytesRemaining;
+
+    if (_logicalMemory.containsAddress(address))
+    {
+        displayRegion(_logicalMemory, address - _logicalMemory.BaseAddress);
+    }
+    else if (emulator->getReadAddresses().tryFindRegion(address, region,
+                                                        offset, bytesRemaining))
+    {
+        MemoryRegion selectedRegion(address - offset, region->getSize(), false);
+
+        displayRegion(selectedRegion, offset);
+    }
+}
+
+void MemoryViewWidget::refreshExecutionCounters(Arm::IArmSystem *emulator)
+{
+    // The emulator is paused, so any counts gathered can be safely read.
+    _blockContext.setExecutionCounters(emulator->getExecutionCounters());
+
+    // Start hottest block navigation from the top again.
+    _nextHotBlock = 0;
+    updateMargin();
+}
+
 bool MemoryViewWidget::tryFindBlockByAddress(uint32_t address, size_t &index) const
 {
     bool isFound = false;
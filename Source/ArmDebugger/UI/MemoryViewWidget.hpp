@@ -59,9 +59,12 @@ public:
     virtual void paintEvent(QPaintEvent *args) override;
     virtual void resizeEvent(QResizeEvent *args) override;
     virtual void mouseReleaseEvent(QMouseEvent *args) override;
+public slots:
+    void displayNextHottestBlock();
 private slots:
     void onSessionStarted(const Arm::Options &options, Arm::IArmSystem *emulator);
     void onSessionEnded(Arm::IArmSystem *emulator);
+    void onSessionResumed(Arm::IArmSystem *emulator);
     void updateStateFromEmulator(Arm::IArmSystem *emulator);
     void onColourSchemeChange(Qt::ColorScheme newColourScheme);
     void onDisplayOptionsChange();
@@ -76,6 +79,8 @@ private:
     void onExtentsUpdated(bool resetScrollOffsets = false);
     void paintBreakpoints(QPainter *painter, const MemoryBlockView *block);
     void updateMargin();
+    void displayAddress(Arm::IArmSystem *emulator, uint32_t address);
+    void refreshExecutionCounters(Arm::IArmSystem *emulator);
 
     bool tryFindBlockByAddress(uint32_t address, size_t &index) const;
     bool tryFindBlockByPosition(double offsetY, size_t &index) const;
@@ -88,6 +93,7 @@ private:
     MemoryRegion _logicalMemory;
     MemoryRegion _currentRegion;
     uint32_t _currentOffset;
+    size_t _nextHotBlock;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -432,6 +432,8 @@ NewSessionDialog::NewSessionDialog(QWidget *ownerWidget,
 
     onSystemRomChanged(_options.getSystemRom());
 
+    _ui._realTimePacingCheckBox->setChecked(_options.isRealTimePacingEnabled());
+    _ui._guestProfilingCheckBox->setChecked(_options.isGuestProfilingEnabled());
     _ui._startPausedCheckBox->setChecked(_startPaused);
 
     connect(_ui._sysArchList, &QComboBox::currentIndexChanged,
@@ -548,6 +550,8 @@ void NewSessionDialog::updateOptionsFromUI()
     _options.setHardwareArchitecture(getSelectedItem<SystemModel>(*_ui._sysArchList));
     _options.setProcessorVariant(getSelectedItem<ProcessorModel>(*_ui._cpuList));
     _options.setProcessorSpeedMHz(static_cast<uint16_t>(_ui._cpuSpeed->value()));
+    _options.setRealTimePacing(_ui._realTimePacingCheckBox->isChecked());
+    _options.setGuestProfiling(_ui._guestProfilingCheckBox->isChecked());
     _options.setRamSizeKb(getSelectedData(*_ui._ramSizeList));
     _options.setSystemRom(getSelectedItem<SystemROMPreset>(*_ui._systemRomPresetList));
 
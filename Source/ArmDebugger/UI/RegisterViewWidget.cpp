@@ -149,6 +149,7 @@ void RegisterViewWidget::onSessionResumed(Arm::IArmSystem *emulator)
 void RegisterViewWidget::onSingleStep(Arm::IArmSystem *emulator)
 {
     sampleState(emulator);
+    enableEditing(true);
 }
 
 RegisterViewWidget::RegisterWidget::RegisterWidget() :
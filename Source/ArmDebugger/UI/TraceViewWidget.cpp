@@ -0,0 +1,401 @@
+//! @file ArmDebugger/UI/TraceViewWidget.cpp
+//! @brief The definition of a widget which displays the trace of the
+//! instructions executed by the emulator.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include "TraceViewWidget.hpp"
+
+#include <sstream>
+
+#include <QComboBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "Ag/Core/Utils.hpp"
+#include "Ag/QtInterop/Conversion.hpp"
+#include "ArmEmu/ArmSystem.hpp"
+#include "AsmTools/InstructionInfo.hpp"
+
+#include "DebuggerApp.hpp"
+#include "EmulatorSession.hpp"
+
+namespace Mo {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The maximum count of decoded records retained.
+constexpr size_t MaxRecords = 1 << 16;
+
+//! @brief The maximum count of records displayed.
+constexpr size_t MaxDisplayedRecords = 4096;
+
+//! @brief The interval at which the trace is drained while running.
+constexpr int DrainIntervalMs = 20;
+
+static constexpr uint32_t DisasmFlags = Asm::InstructionInfo::ARMv6 |
+                                        Asm::InstructionInfo::AllowFPA |
+                                        Asm::InstructionInfo::UseStackModesOnR13;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Formats a 32-bit value as a hexadecimal string.
+QString toHex(uint32_t value)
+{
+    return QString("0x%1").arg(value, 8, 16, QChar('0'));
+}
+
+//! @brief Parses an optional hexadecimal address entered by the user.
+//! @param[in] text The text to parse, possibly empty.
+//! @param[in] defaultValue The value to use if the text is empty.
+//! @param[out] address Receives the parsed address.
+bool tryParseAddress(const QString &text, uint32_t defaultValue, uint32_t &address)
+{
+    const QString trimmed = text.trimmed();
+    bool isOK = true;
+
+    if (trimmed.isEmpty())
+    {
+        address = defaultValue;
+    }
+    else
+    {
+        address = trimmed.toUInt(&isOK, 16);
+    }
+
+    return isOK;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// TraceViewWidget Member Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+TraceViewWidget::TraceViewWidget(QWidget *ownerWidget) :
+    QWidget(ownerWidget),
+    _buffer(1 << 16),
+    _trace(nullptr),
+    _drainTimer(new QTimer(this)),
+    _fromField(new QLineEdit(this)),
+    _toField(new QLineEdit(this)),
+    _modeList(new QComboBox(this)),
+    _recordButton(new QPushButton(tr("&Record..."), this)),
+    _clearButton(new QPushButton(tr("C&lear"), this)),
+    _recordList(new QTreeWidget(this))
+{
+    _fromField->setPlaceholderText(tr("From"));
+    _fromField->setToolTip(tr("The lowest address of the instructions to show."));
+    _toField->setPlaceholderText(tr("To"));
+    _toField->setToolTip(tr("The highest address of the instructions to show."));
+
+    _modeList->addItem(tr("All Modes"), QVariant());
+
+    for (const auto &symbol : Arm::getProcessorModeType().getSymbols())
+    {
+        _modeList->addItem(QString::fromUtf8(symbol.getDisplayName()),
+                           static_cast<uint32_t>(Ag::toScalar(symbol.getId())));
+    }
+
+    _recordButton->setCheckable(true);
+    _recordButton->setToolTip(tr("Records the raw trace to a file which can be decoded by ATrace."));
+
+    _recordList->setColumnCount(5);
+    _recordList->setHeaderLabels({ tr("Address"), tr("Mode"), tr("Cycles"),
+                                   tr("Instruction"), tr("Changes") });
+    _recordList->setRootIsDecorated(false);
+    _recordList->setUniformRowHeights(true);
+    _recordList->header()->setStretchLastSection(true);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(_fromField);
+    filterLayout->addWidget(_toField);
+    filterLayout->addWidget(_modeList);
+    filterLayout->addWidget(_recordButton);
+    filterLayout->addWidget(_clearButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(filterLayout);
+    layout->addWidget(_recordList);
+
+    _drainTimer->setInterval(DrainIntervalMs);
+
+    connect(_drainTimer, &QTimer::timeout, this, &TraceViewWidget::onDrainTimer);
+    connect(_fromField, &QLineEdit::editingFinished, this, &TraceViewWidget::onFilterChanged);
+    connect(_toField, &QLineEdit::editingFinished, this, &TraceViewWidget::onFilterChanged);
+    connect(_modeList, &QComboBox::currentIndexChanged, this, &TraceViewWidget::onFilterChanged);
+    connect(_recordButton, &QPushButton::toggled, this, &TraceViewWidget::onRecordToggled);
+    connect(_clearButton, &QPushButton::clicked, this, &TraceViewWidget::onClear);
+
+    if (auto *app = qobject_cast<DebuggerApp *>(QCoreApplication::instance()))
+    {
+        auto *session = &app->getSession();
+
+        connect(session, &EmulatorSession::sessionStarted,
+                this, &TraceViewWidget::onSessionStarted);
+        connect(session, &EmulatorSession::sessionEnded,
+                this, &TraceViewWidget::onSessionEnded);
+        connect(session, &EmulatorSession::sessionPaused,
+                this, &TraceViewWidget::onSessionPaused);
+        connect(session, &EmulatorSession::sessionResumed,
+                this, &TraceViewWidget::onSessionResumed);
+        connect(session, &EmulatorSession::sessionSingleStep,
+                this, &TraceViewWidget::onSingleStep);
+    }
+
+    setEnabled(false);
+}
+
+void TraceViewWidget::onSessionStarted(const Arm::Options &/*options*/,
+                                       Arm::IArmSystem *emulator)
+{
+    _trace = emulator->getExecutionTrace();
+    onClear();
+
+    setEnabled(_trace != nullptr);
+}
+
+void TraceViewWidget::onSessionEnded(Arm::IArmSystem */*emulator*/)
+{
+    _drainTimer->stop();
+
+    if (_trace != nullptr)
+    {
+        drain();
+        refresh();
+    }
+
+    _recordButton->setChecked(false);
+    _trace = nullptr;
+    setEnabled(false);
+}
+
+void TraceViewWidget::onSessionPaused(Arm::IArmSystem */*emulator*/)
+{
+    _drainTimer->stop();
+    drain();
+    refresh();
+}
+
+void TraceViewWidget::onSessionResumed(Arm::IArmSystem */*emulator*/)
+{
+    if (_trace != nullptr)
+    {
+        _drainTimer->start();
+    }
+}
+
+void TraceViewWidget::onSingleStep(Arm::IArmSystem */*emulator*/)
+{
+    _drainTimer->stop();
+    drain();
+    refresh();
+}
+
+void TraceViewWidget::onDrainTimer()
+{
+    drain();
+}
+
+void TraceViewWidget::onFilterChanged()
+{
+    refresh();
+}
+
+void TraceViewWidget::onRecordToggled(bool isRecording)
+{
+    if (isRecording && (_trace != nullptr))
+    {
+        QString fileName = QFileDialog::getSaveFileName(this, tr("Record Trace"),
+                                                        QString(),
+                                                        tr("Execution traces (*.motrace)"));
+
+        _recordFile.setFileName(fileName);
+
+        if (fileName.isEmpty())
+        {
+            _recordButton->setChecked(false);
+        }
+        else if (_recordFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            std::ostringstream header(std::ios::out | std::ios::binary);
+            Arm::ExecutionTraceWriter::writeFileHeader(header);
+
+            const std::string bytes = header.str();
+            _recordFile.write(bytes.data(), static_cast<qint64>(bytes.size()));
+
+            // Ensure the file can be decoded from its first record.
+            _trace->requestKeyFrame();
+        }
+        else
+        {
+            QMessageBox::warning(this, tr("Record Trace"),
+                                 _recordFile.errorString(), QMessageBox::Ok);
+            _recordButton->setChecked(false);
+        }
+    }
+    else
+    {
+        stopRecording();
+    }
+}
+
+void TraceViewWidget::onClear()
+{
+    _records.clear();
+    _decoder.reset();
+    _recordList->clear();
+
+    if (_trace != nullptr)
+    {
+        // Continue decoding from the next key frame.
+        _trace->requestKeyFrame();
+    }
+}
+
+//! @brief Reads all words from the trace ring, recording them to a file
+//! if required, and decodes them.
+void TraceViewWidget::drain()
+{
+    size_t count = 0;
+
+    while ((_trace != nullptr) &&
+           ((count = _trace->getRing().read(_buffer.data(), _buffer.size())) > 0))
+    {
+        if (_recordFile.isOpen())
+        {
+            _recordFile.write(reinterpret_cast<const char *>(_buffer.data()),
+                              static_cast<qint64>(count * sizeof(uint32_t)));
+        }
+
+        _decoder.append(_buffer.data(), count);
+
+        Arm::TraceRecord record;
+
+        while (_decoder.tryDecodeNext(record))
+        {
+            _records.push_back(record);
+
+            if (_records.size() > MaxRecords)
+            {
+                _records.pop_front();
+            }
+        }
+    }
+}
+
+//! @brief Displays the most recent records which match the filter.
+void TraceViewWidget::refresh()
+{
+    Arm::TraceFilter filter;
+    std::vector<const Arm::TraceRecord *> matches;
+
+    _recordList->clear();
+
+    // Gather the most recent matching records, none if the filter is invalid.
+    const bool isFilterValid = tryGetFilter(filter);
+
+    for (auto pos = _records.rbegin();
+         isFilterValid && (pos != _records.rend()) &&
+         (matches.size() < MaxDisplayedRecords);
+         ++pos)
+    {
+        if (filter.matches(*pos))
+        {
+            matches.push_back(&*pos);
+        }
+    }
+
+    QList<QTreeWidgetItem *> items;
+    items.reserve(static_cast<qsizetype>(matches.size()));
+
+    for (auto pos = matches.rbegin(); pos != matches.rend(); ++pos)
+    {
+        const Arm::TraceRecord &record = **pos;
+        Asm::InstructionInfo instruction;
+        QString statement;
+
+        if (instruction.disassemble(record.Instruction, record.Address, DisasmFlags))
+        {
+            Asm::FormatterOptions formatter(record.Address, DisasmFlags);
+            statement = Ag::Qt::toQString(instruction.toString(&formatter));
+        }
+        else
+        {
+            statement = tr("EQUD %1").arg(toHex(record.Instruction));
+        }
+
+        QStringList changes;
+
+        for (uint32_t regIndex = 0; regIndex < 15; ++regIndex)
+        {
+            if (record.ChangedRegs & (1u << regIndex))
+            {
+                changes.append(QString("R%1=%2").arg(regIndex).arg(toHex(record.Regs[regIndex])));
+            }
+        }
+
+        auto modeName = Arm::getProcessorModeType().toString(record.Mode);
+
+        QTreeWidgetItem *item = new QTreeWidgetItem();
+        item->setText(0, toHex(record.Address));
+        item->setText(1, QString::fromUtf8(modeName.data(),
+                                           static_cast<qsizetype>(modeName.length())));
+        item->setText(2, QString::number(record.Cycles));
+        item->setText(3, statement);
+        item->setText(4, changes.join(", "));
+        items.append(item);
+    }
+
+    _recordList->addTopLevelItems(items);
+    _recordList->scrollToBottom();
+}
+
+//! @brief Closes the file the raw trace is being recorded to, if any.
+void TraceViewWidget::stopRecording()
+{
+    if (_recordFile.isOpen())
+    {
+        drain();
+        _recordFile.close();
+    }
+}
+
+//! @brief Creates a trace filter from the values entered by the user.
+//! @param[out] filter Receives the filter.
+//! @retval true The filter was valid.
+//! @retval false An address field was invalid.
+bool TraceViewWidget::tryGetFilter(Arm::TraceFilter &filter) const
+{
+    bool isOK = tryParseAddress(_fromField->text(), 0, filter.MinAddress) &&
+                tryParseAddress(_toField->text(), ~0u, filter.MaxAddress);
+
+    QVariant modeData = _modeList->currentData();
+
+    if (modeData.isValid())
+    {
+        filter.addMode(static_cast<Arm::ProcessorMode>(modeData.toUInt()));
+    }
+
+    return isOK;
+}
+
+} // namespace Mo
+////////////////////////////////////////////////////////////////////////////////
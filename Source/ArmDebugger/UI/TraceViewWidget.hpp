@@ -0,0 +1,92 @@
+//! @file ArmDebugger/UI/TraceViewWidget.hpp
+//! @brief The declaration of a widget which displays the trace of the
+//! instructions executed by the emulator.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_DEBUGGER_TRACE_VIEW_WIDGET_HPP__
+#define __ARM_DEBUGGER_TRACE_VIEW_WIDGET_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <deque>
+#include <vector>
+
+#include <QFile>
+#include <QWidget>
+
+#include "ArmEmu/ExecutionTrace.hpp"
+
+class QComboBox;
+class QLineEdit;
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+
+namespace Mo {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+namespace Arm {
+class Options;
+class IArmSystem;
+}
+
+//! @brief A widget which drains the execution trace of the emulator and
+//! displays the most recent instructions which match a filter.
+//! @details The widget is the only consumer of the trace. While the emulator
+//! runs the trace is drained periodically so that few records are dropped,
+//! the display is only updated when the emulator pauses. The raw trace can
+//! also be recorded to a file for decoding by the ATrace tool.
+class TraceViewWidget : public QWidget
+{
+Q_OBJECT
+public:
+    // Construction/Destruction
+    TraceViewWidget(QWidget *ownerWidget);
+    virtual ~TraceViewWidget() = default;
+
+    // Signal Handlers
+private slots:
+    void onSessionStarted(const Arm::Options &options, Arm::IArmSystem *emulator);
+    void onSessionEnded(Arm::IArmSystem *emulator);
+    void onSessionPaused(Arm::IArmSystem *emulator);
+    void onSessionResumed(Arm::IArmSystem *emulator);
+    void onSingleStep(Arm::IArmSystem *emulator);
+    void onDrainTimer();
+    void onFilterChanged();
+    void onRecordToggled(bool isRecording);
+    void onClear();
+
+private:
+    // Internal Functions
+    void drain();
+    void refresh();
+    void stopRecording();
+    bool tryGetFilter(Arm::TraceFilter &filter) const;
+
+    // Internal Fields
+    std::deque<Arm::TraceRecord> _records;
+    std::vector<uint32_t> _buffer;
+    Arm::ExecutionTraceDecoder _decoder;
+    QFile _recordFile;
+    Arm::ExecutionTrace *_trace;
+    QTimer *_drainTimer;
+    QLineEdit *_fromField;
+    QLineEdit *_toField;
+    QComboBox *_modeList;
+    QPushButton *_recordButton;
+    QPushButton *_clearButton;
+    QTreeWidget *_recordList;
+};
+
+} // namespace Mo
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,462 @@
+//! @file AFrame_Main.cpp
+//! @brief The definition of the entry point for the AFrame CLI tool which
+//! dumps frames exported through shared memory by an emulated system.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "Ag/Core.hpp"
+#include "ArmEmu.hpp"
+
+// A bit lazy, but it's only one file.
+using namespace Ag;
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The default time to wait for each frame, in milliseconds.
+constexpr uint32_t DefaultTimeoutMs = 5000;
+
+//! @brief The period between checks for a new frame.
+constexpr std::chrono::milliseconds PollInterval(5);
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+enum class AFrameCommand
+{
+    Auto,
+    ShowHelp,
+    ShowInfo,
+    Dump,
+};
+
+//! @brief Defines command line arguments for the AFrame tool.
+class AFrameArgs : public Cli::ProgramArguments
+{
+private:
+    // Internal Types
+    enum Option
+    {
+        ShowHelp,
+        ShowInfo,
+        OutputFile,
+        FrameCount,
+        Timeout,
+    };
+
+    // Internal Fields
+    String _bufferName;
+    String _outputFile;
+    uint32_t _frameCount;
+    uint32_t _timeoutMs;
+    AFrameCommand _command;
+
+    // Internal Functions
+    static Cli::Schema createSchema()
+    {
+        Cli::SchemaBuilder builder;
+        builder.setDescription("Dumps frames exported through shared memory "
+                               "by an emulated system to PPM image files.");
+        builder.defineValueArgument("buffer name", Cli::UpToOne);
+
+        builder.defineOption(Option::ShowHelp, "Display command line help.",
+                             Cli::OptionValue::None);
+        builder.defineAlias(Option::ShowHelp, U'?');
+        builder.defineAlias(Option::ShowHelp, "help");
+
+        builder.defineOption(Option::ShowInfo,
+                             "Display the state of the frame buffer and exit.",
+                             Cli::OptionValue::None);
+        builder.defineAlias(Option::ShowInfo, U'i');
+        builder.defineAlias(Option::ShowInfo, "info");
+
+        builder.defineOption(Option::OutputFile,
+                             "Specifies the output image file, the frame "
+                             "sequence number is appended when dumping "
+                             "more than one frame.",
+                             Cli::OptionValue::Mandatory, "output file");
+        builder.defineAlias(Option::OutputFile, U'o');
+        builder.defineAlias(Option::OutputFile, "output");
+
+        builder.defineOption(Option::FrameCount,
+                             "The count of successive frames to dump, 1 by default.",
+                             Cli::OptionValue::Mandatory, "count");
+        builder.defineAlias(Option::FrameCount, U'n');
+        builder.defineAlias(Option::FrameCount, "count");
+
+        builder.defineOption(Option::Timeout,
+                             "The time to wait for each frame in milliseconds, "
+                             "5000 by default.",
+                             Cli::OptionValue::Mandatory, "ms");
+        builder.defineAlias(Option::Timeout, U't');
+        builder.defineAlias(Option::Timeout, "timeout");
+
+        return builder.createSchema();
+    }
+public:
+    // Construction/Destruction
+    AFrameArgs() :
+        Cli::ProgramArguments(createSchema()),
+        _frameCount(1),
+        _timeoutMs(DefaultTimeoutMs),
+        _command(AFrameCommand::Auto)
+    {
+    }
+
+    virtual ~AFrameArgs() = default;
+
+    // Accessors
+    AFrameCommand getCommand() const { return _command; }
+    string_cref_t getBufferName() const { return _bufferName; }
+    string_cref_t getOutputFile() const { return _outputFile; }
+    uint32_t getFrameCount() const { return _frameCount; }
+    uint32_t getTimeoutMs() const { return _timeoutMs; }
+
+protected:
+    // Overrides
+    // Inherited from Cli::ProgramArguments.
+    virtual bool processOption(uint32_t id, const String &value, String &error) override
+    {
+        bool isOK = true;
+
+        switch (id)
+        {
+        case ShowHelp:
+            _command = AFrameCommand::ShowHelp;
+            break;
+
+        case ShowInfo:
+            if (_command != AFrameCommand::ShowHelp)
+            {
+                _command = AFrameCommand::ShowInfo;
+            }
+            break;
+
+        case OutputFile:
+            _outputFile = value;
+            break;
+
+        case FrameCount:
+            if ((value.tryParseScalar(_frameCount) == false) || (_frameCount == 0))
+            {
+                error = String::format("'{0}' is not a valid frame count.", { value });
+                isOK = false;
+            }
+            break;
+
+        case Timeout:
+            if (value.tryParseScalar(_timeoutMs) == false)
+            {
+                error = String::format("'{0}' is not a valid timeout.", { value });
+                isOK = false;
+            }
+            break;
+
+        default:
+            isOK = false;
+            break;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual bool processArgument(const String &argument, String &error) override
+    {
+        bool isOK = true;
+
+        if (_bufferName.isEmpty())
+        {
+            _bufferName = argument;
+        }
+        else
+        {
+            error = "Only one frame buffer can be specified.";
+            isOK = false;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual bool validate(String &error) const override
+    {
+        bool isOK = false;
+
+        if (_command == AFrameCommand::ShowHelp)
+        {
+            isOK = true;
+        }
+        else if (_bufferName.isEmpty())
+        {
+            error = "The name of a frame buffer must be specified.";
+        }
+        else if ((_command != AFrameCommand::ShowInfo) && _outputFile.isEmpty())
+        {
+            error = "An output file must be specified.";
+        }
+        else
+        {
+            isOK = true;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual void postProcess() override
+    {
+        if (_command == AFrameCommand::Auto)
+        {
+            _command = AFrameCommand::Dump;
+        }
+    }
+};
+
+//! @brief The object representing the root application object.
+class AFrameApp : public App
+{
+private:
+    // Internal Fields
+    String _bufferName;
+    String _outputFile;
+    uint32_t _frameCount;
+    uint32_t _timeoutMs;
+    AFrameCommand _command;
+
+    // Internal Functions
+    //! @brief Writes a summary of the frame buffer header to stdout.
+    static void showInfo(const SharedFrameReader &reader)
+    {
+        const SharedFrameHeader *header = reader.getHeader();
+        uint32_t dirtyLineCount = 0;
+
+        for (uint64_t word : header->DirtyLines)
+        {
+            for (; word != 0; word &= word - 1)
+            {
+                ++dirtyLineCount;
+            }
+        }
+
+        printf("Capacity:     %u x %u\n", header->MaxWidth, header->MaxHeight);
+        printf("Frame:        %u x %u\n", header->Width, header->Height);
+        printf("Updates:      %llu\n",
+               static_cast<unsigned long long>(header->UpdateCount.load() / 2));
+        printf("Sequence:     %llu\n",
+               static_cast<unsigned long long>(header->FrameSequence));
+        printf("Dirty Lines:  %u\n", dirtyLineCount);
+    }
+
+    //! @brief Writes a frame as a binary PPM image.
+    static bool tryWriteImage(const std::string &path, const std::vector<uint32_t> &pixels,
+                              uint32_t width, uint32_t height)
+    {
+        String error;
+        FILE *output = nullptr;
+        bool isWritten = false;
+
+        if (tryOpenFile(path.c_str(), "wb", output, error))
+        {
+            StdFilePtr outputManager(output);
+            std::vector<uint8_t> line(width * 3);
+
+            fprintf(output, "P6\n%u %u\n255\n", width, height);
+            isWritten = true;
+
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                const uint32_t *source = pixels.data() + (static_cast<size_t>(y) * width);
+
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    line[(x * 3) + 0] = static_cast<uint8_t>(source[x] >> 16);
+                    line[(x * 3) + 1] = static_cast<uint8_t>(source[x] >> 8);
+                    line[(x * 3) + 2] = static_cast<uint8_t>(source[x]);
+                }
+
+                isWritten &= (fwrite(line.data(), 1, line.size(), output) == line.size());
+            }
+        }
+
+        return isWritten;
+    }
+
+    //! @brief Creates the path of the image file for a frame.
+    std::string getImagePath(uint64_t sequence) const
+    {
+        std::filesystem::path path(_outputFile.getUtf8Bytes());
+
+        if (_frameCount > 1)
+        {
+            std::filesystem::path stem = path.stem();
+            stem += "_" + std::to_string(sequence);
+            stem += path.extension();
+            path.replace_filename(stem);
+        }
+
+        return path.string();
+    }
+
+    //! @brief Waits for successive frames and writes each to an image file.
+    int dump(const SharedFrameReader &reader) const
+    {
+        std::vector<uint32_t> pixels;
+        uint64_t lastUpdate = 0;
+        int processResult = 0;
+
+        for (uint32_t frameIndex = 0; (frameIndex < _frameCount) && (processResult == 0);
+             ++frameIndex)
+        {
+            const auto deadline = std::chrono::steady_clock::now() +
+                                  std::chrono::milliseconds(_timeoutMs);
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint64_t sequence = 0;
+            bool isCopied = false;
+
+            // Wait for an update which hasn't already been dumped.
+            while ((isCopied == false) && (processResult == 0))
+            {
+                const uint64_t update = reader.beginRead();
+
+                if ((update != lastUpdate) && ((update & 1) == 0) &&
+                    reader.tryCopyFrame(pixels, width, height, sequence))
+                {
+                    lastUpdate = update;
+                    isCopied = true;
+                }
+                else if (std::chrono::steady_clock::now() > deadline)
+                {
+                    fprintf(stderr, "Error: Timed out waiting for a frame.\n");
+                    processResult = 1;
+                }
+                else
+                {
+                    std::this_thread::sleep_for(PollInterval);
+                }
+            }
+
+            if (isCopied)
+            {
+                const std::string path = getImagePath(sequence);
+
+                if (tryWriteImage(path, pixels, width, height))
+                {
+                    printf("Frame %llu (%u x %u) written to '%s'.\n",
+                           static_cast<unsigned long long>(sequence),
+                           width, height, path.c_str());
+                }
+                else
+                {
+                    fprintf(stderr, "Error: Could not write image file '%s'.\n",
+                            path.c_str());
+                    processResult = 1;
+                }
+            }
+        }
+
+        return processResult;
+    }
+public:
+    // Construction/Destruction
+    AFrameApp() :
+        _frameCount(1),
+        _timeoutMs(DefaultTimeoutMs),
+        _command(AFrameCommand::Auto)
+    {
+    }
+
+    virtual ~AFrameApp() = default;
+
+protected:
+    // Overrides
+    // Inherited from App.
+    virtual CommandLineUPtr createCommandLineArguments() const override
+    {
+        return std::make_unique<AFrameArgs>();
+    }
+
+    // Inherited from App.
+    virtual bool initialise(const Cli::ProgramArguments *args)
+    {
+        bool isOK = false;
+
+        if (const AFrameArgs *frameArgs = dynamic_cast<const AFrameArgs *>(args))
+        {
+            _command = frameArgs->getCommand();
+
+            if (_command == AFrameCommand::ShowHelp)
+            {
+                // Display command line help.
+                puts(frameArgs->getSchema().getHelpText(100).getUtf8Bytes());
+            }
+            else
+            {
+                _bufferName = frameArgs->getBufferName();
+                _outputFile = frameArgs->getOutputFile();
+                _frameCount = frameArgs->getFrameCount();
+                _timeoutMs = frameArgs->getTimeoutMs();
+            }
+
+            isOK = true;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from App.
+    virtual int run()
+    {
+        int processResult = 0;
+
+        if (_bufferName.isEmpty() == false)
+        {
+            SharedFrameReader reader;
+            std::string error;
+
+            if (reader.tryOpen(_bufferName.getUtf8Bytes(), error) == false)
+            {
+                fprintf(stderr, "Error: %s\n", error.c_str());
+                processResult = 1;
+            }
+            else if (_command == AFrameCommand::ShowInfo)
+            {
+                showInfo(reader);
+            }
+            else
+            {
+                processResult = dump(reader);
+            }
+        }
+
+        return processResult;
+    }
+};
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+
+////////////////////////////////////////////////////////////////////////////////
+// Global Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_MAIN(Mo::Arm::AFrameApp);
+
+////////////////////////////////////////////////////////////////////////////////
@@ -490,6 +490,26 @@ public:
 
         return result | ExecResult::FlushPipeline;
     }
+
+    void captureState(SystemSnapshot &snapshot) const
+    {
+        snapshot.writeValue(_coreRegisters);
+        snapshot.writeValue(_cpsr);
+        snapshot.writeValue(_userModeRegBank);
+        snapshot.writeValue(_firqModeRegBank);
+        snapshot.writeValue(_irqModeRegBank);
+        snapshot.writeValue(_svcModeRegBank);
+    }
+
+    void restoreState(SnapshotReader &reader)
+    {
+        reader.readValue(_coreRegisters);
+        reader.readValue(_cpsr);
+        reader.readValue(_userModeRegBank);
+        reader.readValue(_firqModeRegBank);
+        reader.readValue(_irqModeRegBank);
+        reader.readValue(_svcModeRegBank);
+    }
 };
 
 //! @brief an implementation of the register file of an ARMv2a processor.
@@ -573,6 +593,18 @@ public:
 
         return ARMv2CoreRegisterFile<THardware>::raiseReset();
     }
+
+    void captureState(SystemSnapshot &snapshot) const
+    {
+        ARMv2CoreRegisterFile<THardware>::captureState(snapshot);
+        snapshot.writeValue(_cp15Registers);
+    }
+
+    void restoreState(SnapshotReader &reader)
+    {
+        ARMv2CoreRegisterFile<THardware>::restoreState(reader);
+        reader.readValue(_cp15Registers);
+    }
 };
 
 }} // namespace Mo::Arm
@@ -20,6 +20,7 @@
 #include "ArmCore.hpp"
 
 #include "AluInstructions.inl"
+#include "CounterCoProcessor.inl"
 #include "DataTransferInstructions.inl"
 
 namespace Mo {
@@ -28,6 +29,221 @@ namespace Arm {
 ////////////////////////////////////////////////////////////////////////////////
 // Templates
 ////////////////////////////////////////////////////////////////////////////////
+//! @brief Executes the MRC instruction to copy a register from the emulator
+//! counter co-processor to a core register.
+//! @tparam THardware The data type of the hardware which owns the
+//! co-processor, modelled on GenericHardware.
+//! @tparam TRegisterFile The data type of the register file encapsulating the
+//! state of the processor.
+//! @param[in] hw The hardware which owns the co-processor.
+//! @param[in] regs The register file holding the current state of the processor.
+//! @param[in] instruction The instruction word to interpret, which should
+//! match CounterCoProcessor::MrcMask.
+//! @return An execution result based on constants defined in the ExecResult
+//! structure.
+template<typename THardware, typename TRegisterFile>
+uint32_t execMrcCounterCoProc(THardware &hw, TRegisterFile &regs,
+                              uint32_t instruction)
+{
+    // MRC CP7,0,Rd,CRn,CR0,0 => MOV Rd,CRn
+    uint32_t result = 1;
+    CounterCoProcessor &coProc = hw.getCounterCoProcessor();
+
+    if (coProc.isPresent())
+    {
+        GeneralRegister rd = Ag::Bin::extractEnum<GeneralRegister, 12, 4>(instruction);
+        uint32_t value = coProc.readRegister(Ag::Bin::extractEnum<CoProcRegister, 16, 4>(instruction));
+
+        if (rd == GeneralRegister::R15)
+        {
+            regs.setStatusFlags(Ag::Bin::extractBits<uint8_t, PsrShift::Status, 4>(value));
+        }
+        else
+        {
+            regs.setRn(rd, value);
+        }
+    }
+    else
+    {
+        // The co-processor hasn't been enabled, so doesn't exist.
+        result = regs.raiseUndefinedInstruction();
+    }
+
+    return result;
+}
+
+//! @brief Fills in the state of the processor to pass to a high level
+//! emulation hook.
+//! @tparam TRegisterFile The data type of the register file encapsulating the
+//! state of the processor.
+//! @param[in] regs The register file holding the current state of the processor.
+//! @param[out] call The call state to fill in.
+template<typename TRegisterFile>
+void prepareHleCall(const TRegisterFile &regs, HleCall &call)
+{
+    for (uint8_t i = 0; i < HleCall::RegisterCount; ++i)
+    {
+        call.Registers[i] = regs.getRn(static_cast<GeneralRegister>(i));
+    }
+
+    call.System = nullptr;
+    call.Address = regs.getPC() - 8;
+    call.SwiNumber = 0;
+    call.Flags = Ag::Bin::extractBits<uint8_t, PsrShift::Status, 4>(regs.getPSR());
+    call.Cycles = 3;
+    call.IsXSwi = false;
+}
+
+//! @brief Copies the state of the processor updated by a high level
+//! emulation hook back to the register file.
+//! @tparam TRegisterFile The data type of the register file encapsulating the
+//! state of the processor.
+//! @param[in] regs The register file to update.
+//! @param[in] call The call state updated by the hook.
+//! @param[in] outcome The result returned by the hook, which determines the
+//! state of the V flag.
+template<typename TRegisterFile>
+void applyHleCall(TRegisterFile &regs, const HleCall &call, HleResult outcome)
+{
+    for (uint8_t i = 0; i < HleCall::RegisterCount; ++i)
+    {
+        regs.setRn(static_cast<GeneralRegister>(i), call.Registers[i]);
+    }
+
+    uint8_t flags = call.Flags;
+
+    if (outcome == HleResult::Failed)
+    {
+        flags |= PsrMask::LowOverflow;
+    }
+    else
+    {
+        flags &= ~PsrMask::LowOverflow;
+    }
+
+    regs.setStatusFlags(flags);
+}
+
+//! @brief Executes the SWI instruction, servicing it on the host if it is
+//! a host filing system SWI or has a high level emulation hook, otherwise
+//! raising the SWI exception.
+//! @tparam THardware The data type of the hardware which owns the host
+//! filing system and hooks, modelled on GenericHardware.
+//! @tparam TRegisterFile The data type of the register file encapsulating the
+//! state of the processor.
+//! @param[in] hw The hardware which owns the host filing system and hooks.
+//! @param[in] regs The register file holding the current state of the processor.
+//! @param[in] instruction The SWI instruction word to interpret.
+//! @return An execution result based on constants defined in the ExecResult
+//! structure.
+template<typename THardware, typename TRegisterFile>
+uint32_t execSoftwareInterrupt(THardware &hw, TRegisterFile &regs,
+                               uint32_t instruction)
+{
+    uint32_t result = 3;
+    HostFileSystem &hostFs = hw.getHostFileSystem();
+    HleHookTable &hooks = hw.getHleHooks();
+    size_t hookId;
+
+    if (hostFs.isPresent() && HostFileSystem::isHostSwi(instruction))
+    {
+        // Service the SWI without entering the guest SWI handler, returning
+        // errors with V set as for the X form of a RISC OS SWI.
+        uint32_t args[HostFileSystem::ArgumentCount];
+
+        for (uint8_t i = 0; i < HostFileSystem::ArgumentCount; ++i)
+        {
+            args[i] = regs.getRn(static_cast<GeneralRegister>(i));
+        }
+
+        uint8_t flags = Ag::Bin::extractBits<uint8_t, PsrShift::Status, 4>(regs.getPSR());
+
+        if (hostFs.service(instruction, args))
+        {
+            flags &= ~PsrMask::LowOverflow;
+        }
+        else
+        {
+            flags |= PsrMask::LowOverflow;
+        }
+
+        for (uint8_t i = 0; i < HostFileSystem::ArgumentCount; ++i)
+        {
+            regs.setRn(static_cast<GeneralRegister>(i), args[i]);
+        }
+
+        regs.setStatusFlags(flags);
+    }
+    else if (hooks.tryFindSwiHook(instruction, hookId))
+    {
+        HleCall call;
+        prepareHleCall(regs, call);
+        call.SwiNumber = instruction & 0xFDFFFF;
+        call.IsXSwi = (instruction & 0x20000) != 0;
+
+        HleResult outcome = hooks.callHook(hookId, call);
+
+        if (outcome == HleResult::Declined)
+        {
+            // Let the guest SWI handler deal with it.
+            result = regs.raiseSoftwareInterrupt();
+        }
+        else
+        {
+            applyHleCall(regs, call, outcome);
+            result = call.Cycles;
+        }
+    }
+    else
+    {
+        result = regs.raiseSoftwareInterrupt();
+    }
+
+    return result;
+}
+
+//! @brief Executes the trap placed at the entry point of a guest routine
+//! by a high level emulation hook.
+//! @tparam TDecoder The data type of the instruction decoder used to
+//! execute the instruction displaced by the trap.
+//! @tparam THardware The data type of the hardware which owns the hooks,
+//! modelled on GenericHardware.
+//! @tparam TRegisterFile The data type of the register file encapsulating the
+//! state of the processor.
+//! @param[in] decoder The decoder to execute the displaced instruction with.
+//! @param[in] hw The hardware which owns the hooks.
+//! @param[in] regs The register file holding the current state of the processor.
+//! @param[in] hookId The identifier of the hook which placed the trap.
+//! @return An execution result based on constants defined in the ExecResult
+//! structure.
+//! @note If the hook completes, execution continues at the address in R14.
+template<typename TDecoder, typename THardware, typename TRegisterFile>
+uint32_t execHleTrap(TDecoder &decoder, THardware &hw, TRegisterFile &regs,
+                     size_t hookId)
+{
+    uint32_t result;
+    HleHookTable &hooks = hw.getHleHooks();
+    HleCall call;
+    prepareHleCall(regs, call);
+
+    HleResult outcome = hooks.callHook(hookId, call);
+
+    if (outcome == HleResult::Declined)
+    {
+        // Execute the guest routine as if the trap wasn't there.
+        result = decoder.decodeAndExecute(hooks.getDisplacedInstruction(hookId));
+    }
+    else
+    {
+        // Return from the routine.
+        applyHleCall(regs, call, outcome);
+        regs.setPC(call.Registers[14]);
+        result = call.Cycles | ExecResult::FlushPipeline;
+    }
+
+    return result;
+}
+
 //! @brief An instruction decoder implementation which executes instructions
 //! for basic ARMv2 processor variants.
 template<typename THardware, typename TRegisterFile>
@@ -64,6 +280,7 @@ public:
         uint32_t result = 1;
         uint32_t op1, op2;
         uint8_t carryOut, opCode;
+        size_t hookId;
 
         // Switch on major op-code.
         switch (Ag::Bin::extractBits<uint8_t, 25, 3>(instruction))
@@ -189,13 +406,23 @@ public:
             break;
 
         case 0x03:
-            // Load/Store with register offset.
-            op1 = _registers.getRn(Ag::Bin::extractEnum<GeneralRegister, 16, 4>(instruction));
-            op2 = calculateDataTransferOffset(_registers, instruction);
+            if (((instruction & HleHookTable::TrapMask) == HleHookTable::TrapBits) &&
+                _hardware.getHleHooks().tryFindRoutineHook(_registers.getPC() - 8,
+                                                          instruction, hookId))
+            {
+                // It's an undefined form placed as a trap by a routine hook.
+                result = execHleTrap(*this, _hardware, _registers, hookId);
+            }
+            else
+            {
+                // Load/Store with register offset.
+                op1 = _registers.getRn(Ag::Bin::extractEnum<GeneralRegister, 16, 4>(instruction));
+                op2 = calculateDataTransferOffset(_registers, instruction);
 
-            result =
-                (instruction & 0x100000) ? execLoad(_hardware, _registers, instruction, op1, op2) :
-                execStore(_hardware, _registers, instruction, op1, op2);
+                result =
+                    (instruction & 0x100000) ? execLoad(_hardware, _registers, instruction, op1, op2) :
+                    execStore(_hardware, _registers, instruction, op1, op2);
+            }
             break;
 
         case 0x04:
@@ -224,8 +451,13 @@ public:
             // Co-processor register transfer.
             if (Ag::Bin::extractBit<24>(instruction))
             {
-                // It's a software interrupt.
-                result = _registers.raiseSoftwareInterrupt();
+                // It's a software interrupt, possibly serviced by the host.
+                result = execSoftwareInterrupt(_hardware, _registers, instruction);
+            }
+            else if ((instruction & CounterCoProcessor::MrcMask) == CounterCoProcessor::MrcBits)
+            {
+                // It's MRC from the emulator counter co-processor, if present.
+                result = execMrcCounterCoProc(_hardware, _registers, instruction);
             }
             else
             {
@@ -351,6 +583,7 @@ public:
         uint32_t result = 1;
         uint32_t op1, op2;
         uint8_t carryOut, opCode;
+        size_t hookId;
 
         // Switch on major op-code.
         switch (Ag::Bin::extractBits<uint8_t, 25, 3>(instruction))
@@ -482,13 +715,23 @@ public:
             break;
 
         case 0x03:
-            // Load/Store with register offset.
-            op1 = _registers.getRn(Ag::Bin::extractEnum<GeneralRegister, 16, 4>(instruction));
-            op2 = calculateDataTransferOffset(_registers, instruction);
+            if (((instruction & HleHookTable::TrapMask) == HleHookTable::TrapBits) &&
+                _hardware.getHleHooks().tryFindRoutineHook(_registers.getPC() - 8,
+                                                          instruction, hookId))
+            {
+                // It's an undefined form placed as a trap by a routine hook.
+                result = execHleTrap(*this, _hardware, _registers, hookId);
+            }
+            else
+            {
+                // Load/Store with register offset.
+                op1 = _registers.getRn(Ag::Bin::extractEnum<GeneralRegister, 16, 4>(instruction));
+                op2 = calculateDataTransferOffset(_registers, instruction);
 
-            result =
-                (instruction & 0x100000) ? execLoad(_hardware, _registers, instruction, op1, op2) :
-                execStore(_hardware, _registers, instruction, op1, op2);
+                result =
+                    (instruction & 0x100000) ? execLoad(_hardware, _registers, instruction, op1, op2) :
+                    execStore(_hardware, _registers, instruction, op1, op2);
+            }
             break;
 
         case 0x04:
@@ -517,8 +760,8 @@ public:
             // Co-processor register transfer.
             if (Ag::Bin::extractBit<24>(instruction))
             {
-                // It's a software interrupt.
-                result = _registers.raiseSoftwareInterrupt();
+                // It's a software interrupt, possibly serviced by the host.
+                result = execSoftwareInterrupt(_hardware, _registers, instruction);
             }
             else if ((instruction & 0x0EE00FFF) == 0x0E000F10)
             {
@@ -534,6 +777,11 @@ public:
                     result = execMcrARMv2aCP15(_registers, instruction);
                 }
             }
+            else if ((instruction & CounterCoProcessor::MrcMask) == CounterCoProcessor::MrcBits)
+            {
+                // It's MRC from the emulator counter co-processor, if present.
+                result = execMrcCounterCoProc(_hardware, _registers, instruction);
+            }
             else
             {
                 result = _registers.raiseUndefinedInstruction();
@@ -0,0 +1,426 @@
+//! @file ATrace_Main.cpp
+//! @brief The definition of the entry point for the ATrace CLI tool which
+//! decodes and filters execution trace files.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <fstream>
+#include <vector>
+
+#include "Ag/Core.hpp"
+#include "ArmEmu.hpp"
+#include "AsmTools.hpp"
+
+// A bit lazy, but it's only one file.
+using namespace Ag;
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+enum class ATraceCommand
+{
+    Auto,
+    ShowHelp,
+    Decode,
+};
+
+//! @brief Defines command line arguments for the ATrace tool.
+class ATraceArgs : public Cli::ProgramArguments
+{
+private:
+    // Internal Types
+    enum Option
+    {
+        ShowHelp,
+        OutputFile,
+        FromAddress,
+        ToAddress,
+        Mode,
+    };
+
+    // Internal Fields
+    String _inputFile;
+    String _outputFile;
+    TraceFilter _filter;
+    ATraceCommand _command;
+
+    // Internal Functions
+    static Cli::Schema createSchema()
+    {
+        Cli::SchemaBuilder builder;
+        builder.setDescription("Decodes an ARM execution trace file.");
+        builder.defineValueArgument("trace file", Cli::UpToOne);
+
+        builder.defineOption(Option::ShowHelp, "Display command line help.",
+                             Cli::OptionValue::None);
+        builder.defineAlias(Option::ShowHelp, U'?');
+        builder.defineAlias(Option::ShowHelp, "help");
+
+        builder.defineOption(Option::OutputFile, "Specifies the output text file.",
+                             Cli::OptionValue::Mandatory, "output file");
+        builder.defineAlias(Option::OutputFile, U'o');
+        builder.defineAlias(Option::OutputFile, "output");
+
+        builder.defineOption(Option::FromAddress,
+                             "Only show instructions at or above an address.",
+                             Cli::OptionValue::Mandatory, "address");
+        builder.defineAlias(Option::FromAddress, U'f');
+        builder.defineAlias(Option::FromAddress, "from");
+
+        builder.defineOption(Option::ToAddress,
+                             "Only show instructions at or below an address.",
+                             Cli::OptionValue::Mandatory, "address");
+        builder.defineAlias(Option::ToAddress, U't');
+        builder.defineAlias(Option::ToAddress, "to");
+
+        std::string description;
+        description.assign("Only show instructions executed in a processor "
+                           "mode, can be specified more than once. ");
+        Cli::appendValidValues(description, getProcessorModeType());
+
+        builder.defineOption(Option::Mode, description.c_str(),
+                             Cli::OptionValue::Mandatory, "mode");
+        builder.defineAlias(Option::Mode, U'm');
+        builder.defineAlias(Option::Mode, "mode");
+
+        return builder.createSchema();
+    }
+
+    static bool tryParseAddress(const String &value, uint32_t &address)
+    {
+        ScalarParser parser(LocaleInfo::getNeutral());
+        parser.setPreferredRadix(16);
+        parser.enableExponent(false);
+        parser.enableFraction(false);
+        parser.enableRadixPrefix(true);
+        parser.enableSign(false);
+
+        return parser.tryProcessString(value.toUtf8View()) &&
+               parser.tryGetValue(address);
+    }
+public:
+    // Construction/Destruction
+    ATraceArgs() :
+        Cli::ProgramArguments(createSchema()),
+        _command(ATraceCommand::Auto)
+    {
+    }
+
+    virtual ~ATraceArgs() = default;
+
+    // Accessors
+    ATraceCommand getCommand() const { return _command; }
+    const TraceFilter &getFilter() const { return _filter; }
+    string_cref_t getInputFile() const { return _inputFile; }
+    string_cref_t getOutputFile() const { return _outputFile; }
+
+protected:
+    // Overrides
+    // Inherited from Cli::ProgramArguments.
+    virtual bool processOption(uint32_t id, const String &value, String &error) override
+    {
+        ProcessorMode mode = ProcessorMode::Max;
+        bool isOK = true;
+
+        switch (id)
+        {
+        case ShowHelp:
+            _command = ATraceCommand::ShowHelp;
+            break;
+
+        case OutputFile:
+            _outputFile = value;
+            break;
+
+        case FromAddress:
+            if (tryParseAddress(value, _filter.MinAddress) == false)
+            {
+                error = String::format("'{0}' is not a valid address.", { value });
+                isOK = false;
+            }
+            break;
+
+        case ToAddress:
+            if (tryParseAddress(value, _filter.MaxAddress) == false)
+            {
+                error = String::format("'{0}' is not a valid address.", { value });
+                isOK = false;
+            }
+            break;
+
+        case Mode:
+            if (getProcessorModeType().tryParse(value.toUtf8View(), mode))
+            {
+                _filter.addMode(mode);
+            }
+            else
+            {
+                error = String::format("'{0}' is not a valid processor mode.",
+                                       { value });
+                isOK = false;
+            }
+            break;
+
+        default:
+            isOK = false;
+            break;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual bool processArgument(const String &argument, String &error) override
+    {
+        bool isOK = true;
+
+        if (_inputFile.isEmpty())
+        {
+            _inputFile = argument;
+        }
+        else
+        {
+            error = "Only one trace file can be specified.";
+            isOK = false;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual bool validate(String &error) const override
+    {
+        bool isOK = false;
+
+        if (_command != ATraceCommand::Decode)
+        {
+            isOK = true;
+        }
+        else if (_inputFile.isEmpty())
+        {
+            error = "An input file must be specified.";
+        }
+        else if (_filter.MinAddress > _filter.MaxAddress)
+        {
+            error = "The address range is empty.";
+        }
+        else
+        {
+            isOK = true;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from Cli::ProgramArguments.
+    virtual void postProcess() override
+    {
+        if (_command == ATraceCommand::Auto)
+        {
+            _command = ATraceCommand::Decode;
+        }
+    }
+};
+
+//! @brief The object representing the root application object.
+class ATraceApp : public App
+{
+private:
+    // Internal Fields
+    String _inputFile;
+    String _outputFile;
+    TraceFilter _filter;
+
+    // Internal Functions
+    static void writeRecord(const TraceRecord &record, FILE *output)
+    {
+        constexpr uint32_t DisasmFlags = Asm::InstructionInfo::ModelMask |
+                                         Asm::InstructionInfo::AllowFPA |
+                                         Asm::InstructionInfo::UseStackModesOnR13;
+        Asm::InstructionInfo instruction;
+        const auto modeName = getProcessorModeType().toString(record.Mode);
+
+        fprintf(output, "0x%.8X %-5.*s %3u  ", record.Address,
+                static_cast<int>(modeName.length()), modeName.data(),
+                static_cast<unsigned>(record.Cycles));
+
+        if (instruction.disassemble(record.Instruction, record.Address, DisasmFlags))
+        {
+            Asm::FormatterOptions formatter(record.Address, DisasmFlags);
+            String statement = instruction.toString(&formatter);
+
+            fprintf(output, "%-40s", statement.getUtf8Bytes());
+        }
+        else
+        {
+            fprintf(output, "EQUD 0x%.8X%-26s", record.Instruction, "");
+        }
+
+        // Show the registers which changed, or all of them at a key frame.
+        const char *separator = "; ";
+
+        for (uint32_t regIndex = 0; regIndex < 15; ++regIndex)
+        {
+            if (record.ChangedRegs & (1u << regIndex))
+            {
+                fprintf(output, "%sR%u=0x%.8X", separator, regIndex,
+                        record.Regs[regIndex]);
+                separator = ", ";
+            }
+        }
+
+        fputc('\n', output);
+    }
+
+    int decode(std::istream &input, FILE *output) const
+    {
+        ExecutionTraceDecoder decoder;
+        std::string error;
+        int processResult = 0;
+
+        if (ExecutionTraceDecoder::tryReadFileHeader(input, error))
+        {
+            std::vector<uint32_t> buffer(1 << 16);
+            TraceRecord record;
+            uint64_t matchCount = 0;
+
+            while (input)
+            {
+                input.read(reinterpret_cast<char *>(buffer.data()),
+                           static_cast<std::streamsize>(buffer.size() * sizeof(uint32_t)));
+
+                decoder.append(buffer.data(),
+                               static_cast<size_t>(input.gcount()) / sizeof(uint32_t));
+
+                while (decoder.tryDecodeNext(record))
+                {
+                    if (_filter.matches(record))
+                    {
+                        writeRecord(record, output);
+                        ++matchCount;
+                    }
+                }
+            }
+
+            fprintf(output, "; %llu of %llu instructions shown, %llu skipped before the first key frame.\n",
+                    static_cast<unsigned long long>(matchCount),
+                    static_cast<unsigned long long>(decoder.getDecodedCount()),
+                    static_cast<unsigned long long>(decoder.getSkippedCount()));
+        }
+        else
+        {
+            fprintf(stderr, "Error: %s\n", error.c_str());
+            processResult = 1;
+        }
+
+        return processResult;
+    }
+public:
+    // Construction/Destruction
+    ATraceApp() = default;
+    virtual ~ATraceApp() = default;
+
+protected:
+    // Overrides
+    // Inherited from App.
+    virtual CommandLineUPtr createCommandLineArguments() const override
+    {
+        return std::make_unique<ATraceArgs>();
+    }
+
+    // Inherited from App.
+    virtual bool initialise(const Cli::ProgramArguments *args)
+    {
+        bool isOK = false;
+
+        if (const ATraceArgs *traceArgs = dynamic_cast<const ATraceArgs *>(args))
+        {
+            if (traceArgs->getCommand() == ATraceCommand::Decode)
+            {
+                _inputFile = traceArgs->getInputFile();
+                _outputFile = traceArgs->getOutputFile();
+                _filter = traceArgs->getFilter();
+            }
+            else
+            {
+                // Display command line help.
+                puts(traceArgs->getSchema().getHelpText(100).getUtf8Bytes());
+            }
+
+            isOK = true;
+        }
+
+        return isOK;
+    }
+
+    // Inherited from App.
+    virtual int run()
+    {
+        int processResult = 0;
+
+        if (_inputFile.isEmpty() == false)
+        {
+            std::ifstream input(_inputFile.getUtf8Bytes(), std::ios::binary);
+
+            if (input.is_open())
+            {
+                String error;
+                StdFilePtr outputManager;
+                FILE *outputStream = nullptr;
+
+                if (_outputFile.isEmpty())
+                {
+                    // Output to stdout.
+                    outputStream = stdout;
+                }
+                else if (tryOpenFile(_outputFile.getUtf8Bytes(), "w",
+                                     outputStream, error))
+                {
+                    // Ensure the stream is closed at completion.
+                    outputManager.reset(outputStream);
+                }
+                else
+                {
+                    fprintf(stderr, "Error: Could not open output file '%s' for writing.\n",
+                            _outputFile.getUtf8Bytes());
+                    processResult = 1;
+                }
+
+                if (processResult == 0)
+                {
+                    processResult = decode(input, outputStream);
+                }
+            }
+            else
+            {
+                fprintf(stderr, "Error: Could not open input file '%s'.\n",
+                        _inputFile.getUtf8Bytes());
+                processResult = 1;
+            }
+        }
+
+        return processResult;
+    }
+};
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+
+////////////////////////////////////////////////////////////////////////////////
+// Global Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+IMPLEMENT_MAIN(Mo::Arm::ATraceApp);
+
+////////////////////////////////////////////////////////////////////////////////
@@ -14,8 +14,11 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <cstdint>
 
+#include <algorithm>
+
 #include "AcornKeyboardController.hpp"
 #include "ArmEmu/IOC.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Macro Definitions
@@ -76,8 +79,48 @@ AcornKeyboardController::AcornKeyboardController() :
     _name("Keyboard Controller"),
     _description("Maps host key and mouse events to guest-compatible scan codes."),
     _ioController(nullptr),
-    _state(ControllerState::PreReset)
+    _scanCodeBeingSent(0),
+    _state(ControllerState::PreReset),
+    _mouseButtons(0),
+    _mouseDeltaX(0),
+    _mouseDeltaY(0)
+{
+    std::fill_n(_keyStates, KeyStateWordCount, 0u);
+}
+
+//! @brief Determines whether the host has reported a key as being held down.
+//! @param[in] guestScanCode The Acorn keyboard scan code of the key.
+bool AcornKeyboardController::isKeyDown(uint8_t guestScanCode) const
 {
+    bool isDown = false;
+
+    if (guestScanCode < (KeyStateWordCount * 32))
+    {
+        isDown = (_keyStates[guestScanCode >> 5] & (1u << (guestScanCode & 31))) != 0;
+    }
+
+    return isDown;
+}
+
+//! @brief Gets the mouse buttons the host has reported as being held down.
+//! @return A combination of MouseButton values.
+uint32_t AcornKeyboardController::getMouseButtonState() const
+{
+    return _mouseButtons;
+}
+
+//! @brief Records the latest state of a key reported by the host.
+//! @param[in] guestScanCode The Acorn keyboard scan code of the key.
+//! @param[in] isDown True if the key is held down, false if it was released.
+void AcornKeyboardController::updateKeyState(uint32_t guestScanCode, bool isDown)
+{
+    if (guestScanCode < (KeyStateWordCount * 32))
+    {
+        uint32_t &word = _keyStates[guestScanCode >> 5];
+        uint32_t bit = 1u << (guestScanCode & 31);
+
+        word = isDown ? (word | bit) : (word & ~bit);
+    }
 }
 
 //! @brief Processes a byte sent from IOC via the KART interface.
@@ -161,6 +204,22 @@ void AcornKeyboardController::connect(const ConnectionContext &context)
     }
 }
 
+// Inherited from IHardwareDevice.
+void AcornKeyboardController::captureState(SystemSnapshot &snapshot) const
+{
+    // Only the state of the KART protocol is captured, the latest host input
+    // is retained when the state is restored.
+    snapshot.writeValue(_scanCodeBeingSent);
+    snapshot.writeValue(_state);
+}
+
+// Inherited from IHardwareDevice.
+void AcornKeyboardController::restoreState(SnapshotReader &reader)
+{
+    reader.readValue(_scanCodeBeingSent);
+    reader.readValue(_state);
+}
+
 // Inherited from IKeyboardController.
 void AcornKeyboardController::keyDown(uint32_t hostScanCode)
 {
@@ -168,6 +227,8 @@ void AcornKeyboardController::keyDown(uint32_t hostScanCode)
 
     if (_scanCodeMap.tryFind(hostScanCode, guestScanCode))
     {
+        updateKeyState(guestScanCode, true);
+
         // TODO: Queue traffic to send to the KART for a key press.
     }
 }
@@ -179,6 +240,8 @@ void AcornKeyboardController::keyUp(uint32_t hostScanCode)
 
     if (_scanCodeMap.tryFind(hostScanCode, guestScanCode))
     {
+        updateKeyState(guestScanCode, false);
+
         // TODO: Queue traffic to send to the KART for a key release.
     }
 }
@@ -190,6 +253,8 @@ void AcornKeyboardController::mouseButtonDown(AcornKeyboardController::MouseButt
 
     if (tryMapMouseButton(button, guestScanCode))
     {
+        _mouseButtons |= button & ButtonMask;
+
         // TODO: Queue traffic to send to the KART for a mouse button release.
     }
 }
@@ -201,13 +266,19 @@ void AcornKeyboardController::mouseButtonUp(AcornKeyboardController::MouseButton
 
     if (tryMapMouseButton(button, guestScanCode))
     {
+        _mouseButtons &= ~(button & ButtonMask);
+
         // TODO: Queue traffic to send to the KART for a mouse button release.
     }
 }
 
 // Inherited from IKeyboardController.
-void AcornKeyboardController::mouseDelta(int32_t /* deltaX */, int32_t /* deltaY */)
+void AcornKeyboardController::mouseDelta(int32_t deltaX, int32_t deltaY)
 {
+    // Accumulate movement until it can be reported.
+    _mouseDeltaX += deltaX;
+    _mouseDeltaY += deltaY;
+
     // TODO: Queue traffic to send to the KART to report a mouse movement.
 }
 
@@ -69,6 +69,8 @@ public:
     virtual ~AcornKeyboardController() = default;
 
     // Accessors
+    bool isKeyDown(uint8_t guestScanCode) const;
+    uint32_t getMouseButtonState() const;
 
     // Operations
     void receiveKARTByte(uint8_t nextByte);
@@ -77,6 +79,8 @@ public:
     virtual Ag::string_cref_t getName() const override;
     virtual Ag::string_cref_t getDescription() const override;
     virtual void connect(const ConnectionContext &context) override;
+    virtual void captureState(SystemSnapshot &snapshot) const override;
+    virtual void restoreState(SnapshotReader &reader) override;
 
     virtual void keyDown(uint32_t hostScanCode) override;
     virtual void keyUp(uint32_t hostScanCode) override;
@@ -97,7 +101,11 @@ private:
 
     };
 
+    // Internal Constants
+    static constexpr uint8_t KeyStateWordCount = 4;
+
     // Internal Functions
+    void updateKeyState(uint32_t guestScanCode, bool isDown);
 
     // Internal Fields
     Ag::String _name;
@@ -106,6 +114,13 @@ private:
     IOC *_ioController;
     uint32_t _scanCodeBeingSent;
     ControllerState _state;
+
+    // The latest input from the host. This is deliberately excluded from
+    // snapshots so that it survives the emulated system being rolled back.
+    uint32_t _keyStates[KeyStateWordCount];
+    uint32_t _mouseButtons;
+    int32_t _mouseDeltaX;
+    int32_t _mouseDeltaY;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
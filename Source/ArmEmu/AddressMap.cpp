@@ -117,6 +117,21 @@ PageMapping::PageMapping(uint32_t virtBaseAddr, uint32_t physBaseAddr,
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// IHardwareDevice Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The base implementation captures no state.
+void IHardwareDevice::captureState(SystemSnapshot &/*snapshot*/) const
+{
+    ;
+}
+
+//! @brief The base implementation restores no state.
+void IHardwareDevice::restoreState(SnapshotReader &/*reader*/)
+{
+    ;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ConnectionContext Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
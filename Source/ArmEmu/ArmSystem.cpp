@@ -221,6 +221,7 @@ uint32_t writeToPhysicalAddress(IArmSystem *sys, uint32_t physicalAddr,
 
                 std::memcpy(block + mappingOffset, target + bytesWritten,
                             bytesToWrite);
+                sys->markHostWrite(physAddr, bytesToWrite);
 
                 bytesWritten += bytesToWrite;
             }
@@ -14,6 +14,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
 #include <set>
 
 #include "Ag/Core/Utils.hpp"
@@ -22,6 +23,8 @@
 #include "ArmEmu/GuestEventQueue.hpp"
 #include "ArmEmu/EmuOptions.hpp"
 #include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemMetrics.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
 #include "SystemConfigurations.inl"
 
 namespace Mo {
@@ -41,6 +44,11 @@ private:
     using RegisterFile = typename TSysTraits::RegisterFileType;
     using ExecutionUnit = typename TSysTraits::ExecutionUnitType;
 
+    // Internal Constants
+    //! @brief The count of times metrics are sampled in each second of
+    //! emulated time.
+    static constexpr uint64_t MetricsSamplesPerSecond = 10;
+
     // Internal Fields
     GuestEventQueueUPtr _eventQueue;
     SystemContext _interop;
@@ -50,47 +58,190 @@ private:
     AddressMap _addrDecoderReadMap;
     AddressMap _addrDecoderWriteMap;
     HardwareDevicePool _devices;
+    GuestTask _runLimitTask;
+    GuestTask _metricsTask;
+    SystemCounters _lastCounters;
+
+    // Snapshot timings are updated by the const captureState().
+    mutable SystemMetrics _metrics;
+    mutable SystemMetricsPublisher _metricsPublisher;
     std::atomic_bool _isRunning;
+    bool _isRunLimitReached;
 
     // Internal Functions
-
-    //! @brief Performs shared initialisation tasks from the constructor.
-    void initialise()
+    //! @brief Calls a function once for each device in the system, whether
+    //! owned by the system or only appearing in the address maps.
+    //! @tparam TFn The data type of a function taking an IHardwreDevicePtr.
+    //! @param[in] fn The function to call, devices are always visited in the
+    //! same order.
+    template<typename TFn>
+    void forEachDevice(TFn fn) const
     {
-        // Connect all devices together and to inter-op services.
-        ConnectionContext connection(&_interop, _devices, _addrDecoderReadMap,
-                                     _addrDecoderWriteMap);
-
-        // Use a map to ensure that each device is only initialised once.
-        std::set<IHardwreDevicePtr> initialisedDevices;
+        // Use a map to ensure that each device is only visited once.
+        std::set<IHardwreDevicePtr> visitedDevices;
 
         for (auto &devicePtr : _devices)
         {
-            auto insertResult = initialisedDevices.insert(devicePtr.get());
+            auto insertResult = visitedDevices.insert(devicePtr.get());
 
             if (insertResult.second)
             {
-                // The device was newly inserted, connect it.
-                devicePtr->connect(connection);
+                // The device was newly inserted, visit it.
+                fn(devicePtr.get());
             }
         }
 
         for (uint8_t i = 0; i < 2; ++i)
         {
-            AddressMap &map = (i == 0) ? _addrDecoderReadMap : _addrDecoderWriteMap;
+            const AddressMap &map = (i == 0) ? _addrDecoderReadMap : _addrDecoderWriteMap;
 
             for (auto &mapping : map.getMappings())
             {
-                auto insertResult = initialisedDevices.insert(mapping.Region);
+                auto insertResult = visitedDevices.insert(mapping.Region);
 
                 if (insertResult.second)
                 {
-                    // The device was newly inserted, connect it.
-                    mapping.Region->connect(connection);
+                    // The device was newly inserted, visit it.
+                    fn(mapping.Region);
                 }
             }
         }
     }
+
+    //! @brief Performs shared initialisation tasks from the constructor.
+    //! @param[in] options An object describing the preferred configuration of
+    //! the emulated system.
+    void initialise(const Options &options)
+    {
+        // Connect all devices together and to inter-op services.
+        ConnectionContext connection(&_interop, _devices, _addrDecoderReadMap,
+                                     _addrDecoderWriteMap);
+
+        forEachDevice([&connection](IHardwreDevicePtr device) {
+            device->connect(connection);
+        });
+
+        // Allow the profiler, if compiled in, to inspect the stack.
+        _execUnit.getSampler().connect(&_addrDecoderReadMap);
+
+        // Make emulator counters visible to guest code, if required.
+        if (options.isCounterCoProcessorEnabled())
+        {
+            _hardware.getCounterCoProcessor().connect(&_interop,
+                                                      &_execUnit.getInstructionCount());
+        }
+
+        // Give guest code direct access to host files, if required.
+        if (options.getHostFileSystemRoot().isEmpty() == false)
+        {
+            const Ag::String rootPath = options.getHostFileSystemRoot().toString();
+
+            _hardware.getHostFileSystem().connect(this, rootPath.getUtf8Bytes());
+        }
+
+        // Allow high level emulation hooks to access guest memory.
+        _hardware.getHleHooks().connect(this);
+
+        _runLimitTask.At = 0;
+        _runLimitTask.Context = reinterpret_cast<uintptr_t>(this);
+        _runLimitTask.Next = nullptr;
+        _runLimitTask.Task = &ArmSystem::onRunLimitReached;
+
+        // Sample metrics periodically while running.
+        _metricsTask.At = getMetricsSamplePeriod();
+        _metricsTask.Context = reinterpret_cast<uintptr_t>(this);
+        _metricsTask.Next = nullptr;
+        _metricsTask.Task = &ArmSystem::onMetricsSampleDue;
+        _interop.scheduleTask(&_metricsTask);
+
+        _lastCounters.HostTimeNs = SystemCounters::getHostTimeNs();
+    }
+
+    //! @brief Gets the count of master clock ticks between samples of the
+    //! system metrics.
+    uint64_t getMetricsSamplePeriod() const
+    {
+        return std::max<uint64_t>(_interop.getMasterClockFrequency() /
+                                  MetricsSamplesPerSecond, 1);
+    }
+
+    //! @brief Reads the running totals kept by components of the system.
+    //! @param[out] counters Receives the totals.
+    void readCounters(SystemCounters &counters) const
+    {
+        counters.HostTimeNs = SystemCounters::getHostTimeNs();
+        counters.InstructionCount = _execUnit.getInstructionCount();
+        counters.CycleCount = _interop.getCPUClockTicks();
+        counters.IrqCount = _execUnit.getIrqCount();
+        counters.FastIrqCount = _execUnit.getFastIrqCount();
+
+        if constexpr (Hardware::CountsMmio)
+        {
+            counters.MmioAccessCount = _hardware.getMmioAccessCount();
+        }
+
+        counters.HostIdleTimeNs = _interop.getHostIdleTimeNs();
+    }
+
+    //! @brief Starts measuring a new period of metrics as the processor
+    //! starts running, so that time spent stopped isn't included.
+    void beginMetricsPeriod()
+    {
+        readCounters(_lastCounters);
+        _metrics.IsRunning = 1;
+        publishMetrics();
+    }
+
+    //! @brief Calculates metrics from the counters of the system and
+    //! publishes them to other threads.
+    //! @param[in] isRunning True if the processor is running.
+    void sampleMetrics(bool isRunning)
+    {
+        SystemCounters counters;
+        readCounters(counters);
+
+        _metrics.calculateRates(_lastCounters, counters);
+        _metrics.IsRunning = isRunning ? 1 : 0;
+        _metrics.ScheduledTaskCount = _interop.getScheduledTaskCount();
+        _metrics.EventQueueBacklog = _eventQueue->getBacklog();
+        publishMetrics();
+
+        _lastCounters = counters;
+    }
+
+    //! @brief Makes the current metrics visible to other threads.
+    void publishMetrics() const
+    {
+        _metricsPublisher.publish(_metrics);
+        ++_metrics.Sequence;
+    }
+
+    //! @brief A guest task which samples the system metrics at regular
+    //! intervals of emulated time.
+    //! @param[in] taskContext A pointer to the ArmSystem being run.
+    static void onMetricsSampleDue(SystemContext &guestContext,
+                                   uintptr_t taskContext)
+    {
+        ArmSystem *system = reinterpret_cast<ArmSystem *>(taskContext);
+
+        system->sampleMetrics(true);
+
+        // Re-schedule for the end of the next period.
+        system->_metricsTask.At += system->getMetricsSamplePeriod();
+        guestContext.scheduleTask(&system->_metricsTask);
+    }
+
+    //! @brief A guest task which stops execution at the end of the period
+    //! passed to runFor().
+    //! @param[in] taskContext A pointer to the ArmSystem being run.
+    static void onRunLimitReached(SystemContext &/*guestContext*/,
+                                  uintptr_t taskContext)
+    {
+        ArmSystem *system = reinterpret_cast<ArmSystem *>(taskContext);
+
+        system->_isRunLimitReached = true;
+        system->_hardware.setHostIrq(true);
+    }
 public:
     // Construction/Destruction
     //! @brief Constructs an emulator for a system which has no additional
@@ -105,10 +256,11 @@ public:
         _execUnit(_hardware, _registers, _interop),
         _addrDecoderReadMap(_hardware.createMasterReadMap()),
         _addrDecoderWriteMap(_hardware.createMasterWriteMap()),
-        _isRunning(false)
+        _isRunning(false),
+        _isRunLimitReached(false)
     {
         // Perform shared initialisation.
-        initialise();
+        initialise(options);
 
         // Set the hardware to the power-on state.
         reset();
@@ -132,15 +284,17 @@ public:
         _registers(_hardware),
         _execUnit(_hardware, _registers, _interop),
         _devices(std::move(devices)),
-        _isRunning(false)
+        _isRunning(false),
+        _isRunLimitReached(false)
     {
-        // Perform shared initialisation.
-        initialise();
-
-        // Initialise address maps after RAM and ROM.
+        // Initialise address maps after RAM and ROM, but before connecting
+        // devices so that they can find those mapped by the hardware.
         _addrDecoderReadMap = _hardware.createMasterReadMap();
         _addrDecoderWriteMap = _hardware.createMasterWriteMap();
 
+        // Perform shared initialisation.
+        initialise(options);
+
         // Set the hardware and processor to the power-on state.
         reset();
     }
@@ -254,11 +408,112 @@ public:
         return _hardware.logicalToPhysicalAddress(logicalAddr, mapping);
     }
 
+    virtual bool isTurboEnabled() const override
+    {
+        return _interop.isTurboEnabled();
+    }
+
+    virtual void setTurbo(bool isEnabled) override
+    {
+        _interop.setTurbo(isEnabled);
+    }
+
+    virtual uint8_t getHeldOutputs() const override
+    {
+        return _interop.getHeldOutputs();
+    }
+
+    virtual void setHeldOutputs(uint8_t outputs) override
+    {
+        _interop.setHeldOutputs(outputs);
+    }
+
+    virtual GuestProfiler *getProfiler() override
+    {
+        return _execUnit.getSampler().getProfiler();
+    }
+
+    virtual ExecutionCounterTable *getExecutionCounters() override
+    {
+        return _execUnit.getCounter().getCounters();
+    }
+
+    virtual GuestCoverageMap *getCoverage() override
+    {
+        return _execUnit.getCoverage().getCoverage();
+    }
+
+    virtual ExecutionTrace *getExecutionTrace() override
+    {
+        return _execUnit.getTracer().getTrace();
+    }
+
+    virtual const SystemMetricsPublisher &getMetrics() const override
+    {
+        return _metricsPublisher;
+    }
+
+    virtual VideoFrameExchange *getVideoFrames() override
+    {
+        return _hardware.getVideoFrames();
+    }
+
+    virtual SoundSampleRing *getSoundSamples() override
+    {
+        return _hardware.getSoundSamples();
+    }
+
+    virtual HleHookTable &getHleHooks() override
+    {
+        return _hardware.getHleHooks();
+    }
+
     // Operations
     virtual ExecutionMetrics run()  override
     {
         Ag::ValueScope<std::atomic_bool, bool> isRunning(_isRunning, true);
-        return _execUnit.runPipeline(false);
+
+        beginMetricsPeriod();
+        ExecutionMetrics metrics = _execUnit.runPipeline(false);
+        sampleMetrics(false);
+
+        return metrics;
+    }
+
+    virtual ExecutionMetrics runFor(uint32_t microseconds) override
+    {
+        Ag::ValueScope<std::atomic_bool, bool> isRunning(_isRunning, true);
+
+        // Schedule a task to interrupt execution when the period is up.
+        uint64_t period = (_interop.getMasterClockFrequency() * microseconds) / 1000000;
+        _runLimitTask.At = _interop.getMasterClockTicks() + std::max<uint64_t>(period, 1);
+        _isRunLimitReached = false;
+        _interop.scheduleTask(&_runLimitTask);
+
+        beginMetricsPeriod();
+        ExecutionMetrics metrics = _execUnit.runPipeline(false);
+        sampleMetrics(false);
+
+        if (_isRunLimitReached)
+        {
+            if (metrics.ExecResult == ExecutionMetrics::Result::HostIrq)
+            {
+                metrics.ExecResult = ExecutionMetrics::Result::TimeLimit;
+            }
+            else
+            {
+                // Execution stopped for another reason at the same moment,
+                // don't let the limit stop the next run.
+                _hardware.setHostIrq(false);
+            }
+        }
+        else
+        {
+            // Execution stopped early.
+            _interop.cancelTask(&_runLimitTask);
+        }
+
+        return metrics;
     }
 
     virtual ExecutionMetrics runSingleStep() override
@@ -272,10 +527,78 @@ public:
         _hardware.setHostIrq(true);
     }
 
+    virtual void markHostWrite(uint32_t physicalAddr, uint32_t length) override
+    {
+        _hardware.markHostWrite(physicalAddr, length);
+    }
+
     virtual bool tryGetNextMessage(GuestEvent &next) override
     {
         return _eventQueue->tryDeque(next);
     }
+
+    virtual size_t tryGetNextMessages(GuestEvent *messages, size_t maxCount) override
+    {
+        return _eventQueue->tryDequeMany(messages, maxCount);
+    }
+
+    virtual void setEventListener(IGuestEventListener *listener) override
+    {
+        _eventQueue->setListener(listener);
+    }
+
+    virtual bool postMessageToHost(uint32_t type, uintptr_t data1, uintptr_t data2) override
+    {
+        return _interop.postMessageToHost(type, data1, data2);
+    }
+
+    virtual void captureState(SystemSnapshot &snapshot) const override
+    {
+        // NOTE: The instruction pipeline is always flushed between runs, so
+        // it has no state worth capturing.
+        const uint64_t startTime = SystemCounters::getHostTimeNs();
+        snapshot.clear();
+        snapshot.writeValue(reinterpret_cast<uintptr_t>(this));
+
+        _interop.captureState(snapshot);
+        _hardware.captureState(snapshot);
+        _registers.captureState(snapshot);
+
+        forEachDevice([&snapshot](IHardwreDevicePtr device) {
+            device->captureState(snapshot);
+        });
+
+        _metrics.LastCaptureTimeNs = SystemCounters::getHostTimeNs() - startTime;
+        publishMetrics();
+    }
+
+    virtual bool restoreState(const SystemSnapshot &snapshot) override
+    {
+        const uint64_t startTime = SystemCounters::getHostTimeNs();
+        SnapshotReader reader(snapshot);
+        uintptr_t owner = 0;
+        bool isRestored = false;
+
+        if (reader.readValue(owner) &&
+            (owner == reinterpret_cast<uintptr_t>(this)))
+        {
+            _interop.restoreState(reader);
+            _hardware.restoreState(reader);
+            _registers.restoreState(reader);
+
+            forEachDevice([&reader](IHardwreDevicePtr device) {
+                device->restoreState(reader);
+            });
+
+            _execUnit.flushPipeline();
+            isRestored = reader.isComplete();
+
+            _metrics.LastRestoreTimeNs = SystemCounters::getHostTimeNs() - startTime;
+            publishMetrics();
+        }
+
+        return isRestored;
+    }
 };
 
 }} // namespace Mo::Arm
@@ -15,6 +15,8 @@
 #include "Ag/Core/Format.hpp"
 #include "Ag/Core/Variant.hpp"
 #include "ArmEmu/ArmSystemBuilder.hpp"
+#include "ArmEmu/IdeController.hpp"
+#include "ArmEmu/WD1772.hpp"
 
 #include "ArmSystem.inl"
 #include "SystemConfigurations.inl"
@@ -36,6 +38,66 @@ Ag::String makePlatformProcessorError(const Options &options)
                                 getProcessorModelType().toDisplayName(options.getProcessorVariant()) });
 }
 
+//! @brief Creates a system of a specified configuration, with or without
+//! guest profiling, coverage or tracing support as specified by the options.
+//! @tparam TSysTraits The traits describing the system configuration.
+//! @note Profiled systems include the tracer. Options::validate() has already
+//! rejected coverage combined with either, so no option is silently dropped.
+template<typename TSysTraits>
+IArmSystem *createProfiledSystem(const Options &options, HardwareDevicePool &&devices,
+                                   const AddressMap &readMap, const AddressMap &writeMap)
+{
+    IArmSystem *sys = nullptr;
+
+    if (options.isGuestCoverageEnabled())
+    {
+        sys = new ArmSystem<CoverageSystemTraits<TSysTraits>>(options, std::move(devices),
+                                                              readMap, writeMap);
+    }
+    else if (options.isGuestProfilingEnabled())
+    {
+        sys = new ArmSystem<ProfiledSystemTraits<TSysTraits>>(options, std::move(devices),
+                                                              readMap, writeMap);
+    }
+    else if (options.isExecutionTracingEnabled())
+    {
+        sys = new ArmSystem<TracedSystemTraits<TSysTraits>>(options, std::move(devices),
+                                                            readMap, writeMap);
+    }
+    else
+    {
+        sys = new ArmSystem<TSysTraits>(options, std::move(devices),
+                                        readMap, writeMap);
+    }
+
+    return sys;
+}
+
+//! @brief Creates a system of a specified configuration, with or without
+//! guest profiling and instruction class instrumentation as specified by
+//! the options.
+//! @tparam TSysTraits The traits describing the system configuration.
+template<typename TSysTraits>
+IArmSystem *createConfiguredSystem(const Options &options, HardwareDevicePool &&devices,
+                                   const AddressMap &readMap, const AddressMap &writeMap)
+{
+    IArmSystem *sys = nullptr;
+
+    if (options.isInstrumentationEnabled())
+    {
+        sys = createProfiledSystem<InstrumentedSystemTraits<TSysTraits>>(options,
+                                                                          std::move(devices),
+                                                                          readMap, writeMap);
+    }
+    else
+    {
+        sys = createProfiledSystem<TSysTraits>(options, std::move(devices),
+                                               readMap, writeMap);
+    }
+
+    return sys;
+}
+
 } // Anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -145,6 +207,39 @@ void ArmSystemBuilder::addMapping(IAddressRegionUPtr &&region, uint32_t baseAddr
     addDevice(std::move(region));
 }
 
+//! @brief Adds a WD1772 floppy disc controller and the latch which selects
+//! its drives to the system being constructed at their Archimedes addresses.
+//! @return A pointer to the controller, which the emulated system will own,
+//! allowing disc images to be inserted. The count of drives and whether fast
+//! disc mode is enabled are taken from the options the builder was reset with.
+WD1772 *ArmSystemBuilder::addFloppyDiscController()
+{
+    WD1772 *controller = new WD1772(_baseOptions);
+    IAddressRegionUPtr region(controller);
+
+    addMapping(std::move(region), WD1772::BaseAddress, MemoryAccess::ReadWrite);
+    addMapping(&controller->getDriveLatch(), FloppyDriveLatch::BaseAddress,
+               MemoryAccess::WriteOnly);
+
+    return controller;
+}
+
+//! @brief Adds an IDE hard disc interface to the system being constructed
+//! at its A5000 address.
+//! @return A pointer to the interface, which the emulated system will own,
+//! allowing disc images to be attached. The count of drives is taken from
+//! the options the builder was reset with, none unless the hard disc
+//! interface selected is IDE.
+IdeController *ArmSystemBuilder::addIdeController()
+{
+    IdeController *controller = new IdeController(_baseOptions);
+    IAddressRegionUPtr region(controller);
+
+    addMapping(std::move(region), IdeController::BaseAddress, MemoryAccess::ReadWrite);
+
+    return controller;
+}
+
 //! @brief Resets the state of the object back to an initial set of options.
 //! @param[in] baseOptions The initial options used to instantiate the correct
 //! IArmSystem implementation.
@@ -175,16 +270,16 @@ IArmSystemUPtr ArmSystemBuilder::createSystem()
             if (_baseOptions.getProcessorVariant() == ProcessorModel::ARM2)
             {
                 // A test system with an ARM 2 processor.
-                sys = new ArmSystem<ArmV2TestSystemTraits>(_baseOptions,
-                                                           std::move(_devices),
-                                                           _readMap, _writeMap);
+                sys = createConfiguredSystem<ArmV2TestSystemTraits>(_baseOptions,
+                                                                    std::move(_devices),
+                                                                    _readMap, _writeMap);
             }
             else if (_baseOptions.getProcessorVariant() == ProcessorModel::ARM3)
             {
                 // A test system with an ARM 3 processor.
-                sys = new ArmSystem<ArmV2aTestSystemTraits>(_baseOptions,
-                                                            std::move(_devices),
-                                                            _readMap, _writeMap);
+                sys = createConfiguredSystem<ArmV2aTestSystemTraits>(_baseOptions,
+                                                                     std::move(_devices),
+                                                                     _readMap, _writeMap);
             }
             else
             {
@@ -201,15 +296,15 @@ IArmSystemUPtr ArmSystemBuilder::createSystem()
         case SystemModel::ASeries:
             if (_baseOptions.getProcessorVariant() == ProcessorModel::ARM2)
             {
-                sys = new ArmSystem<ArmV2MemcSystemTraits>(_baseOptions,
-                                                           std::move(_devices),
-                                                           _readMap, _writeMap);
+                sys = createConfiguredSystem<ArmV2MemcSystemTraits>(_baseOptions,
+                                                                    std::move(_devices),
+                                                                    _readMap, _writeMap);
             }
             else if (_baseOptions.getProcessorVariant() == ProcessorModel::ARM3)
             {
-                sys = new ArmSystem<ArmV2aMemcSystemTraits>(_baseOptions,
-                                                            std::move(_devices),
-                                                            _readMap, _writeMap);
+                sys = createConfiguredSystem<ArmV2aMemcSystemTraits>(_baseOptions,
+                                                                     std::move(_devices),
+                                                                     _readMap, _writeMap);
             }
             else
             {
@@ -0,0 +1,260 @@
+//! @file Bench_Alu.cpp
+//! @brief The definition of micro-benchmarks of ALU operations, condition
+//! evaluation and register file primitives.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+
+#include "AluInstructions.inl"
+#include "ARMv2CoreRegisterFile.inl"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The minimal hardware required by a register file.
+struct BenchHardware
+{
+    uint8_t IrqMask;
+    bool IsPrivilegedMode;
+
+    BenchHardware() :
+        IrqMask(0),
+        IsPrivilegedMode(false)
+    {
+    }
+
+    void updateIrqMask(uint8_t mask, uint8_t significantBits) noexcept
+    {
+        IrqMask = (IrqMask & ~significantBits) | (mask & significantBits);
+    }
+
+    void setPrivilegedMode(bool isPrivileged) noexcept
+    {
+        IsPrivilegedMode = isPrivileged;
+    }
+};
+
+using BenchRegisterFile = ARMv2CoreRegisterFile<BenchHardware>;
+
+using AluOperationFn = uint32_t (*)(uint32_t, uint32_t, uint8_t &);
+using LongMultiplyFn = uint8_t (*)(LongWord &, uint32_t, uint32_t, uint8_t);
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Operand pairs which produce a mix of status flag results.
+const uint32_t AluOperands[][2] = {
+    { 0x00000000, 0x00000000 },
+    { 0x7FFFFFFF, 0x00000001 },
+    { 0xFFFFFFFF, 0x00000001 },
+    { 0x80000000, 0x80000000 },
+    { 0x12345678, 0x9ABCDEF0 },
+    { 0x0000FFFF, 0xFFFF0000 },
+    { 0xDEADBEEF, 0x00000BAD },
+    { 0x00000003, 0xFFFFFFFE },
+};
+
+constexpr int64_t OperandCount = static_cast<int64_t>(std::size(AluOperands));
+
+//! @brief Data processing instructions covering each barrel shifter mode:
+//! MOV R0,R1,LSL #3; MOV R0,R1,LSR R2; MOV R0,R1,ASR #31; MOV R0,R1,ROR R3;
+//! MOV R0,R1,RRX; MOV R0,R1,LSL R2
+const uint32_t ShiftedOperandInstructions[] = {
+    0xE1A00181, 0xE1A00231, 0xE1A00FC1, 0xE1A00371,
+    0xE1A00061, 0xE1A00211,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Measures an ALU operation which takes two operands.
+template<AluOperationFn TOperation>
+void AluOperation(benchmark::State &state)
+{
+    uint8_t flags = StatusFlag_C;
+
+    for (auto _ : state)
+    {
+        for (const auto &operands : AluOperands)
+        {
+            uint32_t result = TOperation(operands[0], operands[1], flags);
+
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(flags);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * OperandCount);
+}
+
+BENCHMARK_TEMPLATE(AluOperation, ALU_Add);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Sub);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Adc);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Sbc);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Rsc);
+BENCHMARK_TEMPLATE(AluOperation, ALU_And);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Or);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Xor);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Bic);
+BENCHMARK_TEMPLATE(AluOperation, ALU_Mul);
+
+void AluLogicFlags(benchmark::State &state)
+{
+    uint8_t flags = StatusFlag_C | StatusFlag_V;
+
+    for (auto _ : state)
+    {
+        for (const auto &operands : AluOperands)
+        {
+            flags = ALU_Logic_Flags(operands[0], flags);
+
+            benchmark::DoNotOptimize(flags);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * OperandCount);
+}
+
+BENCHMARK(AluLogicFlags);
+
+void AluMla(benchmark::State &state)
+{
+    uint8_t flags = 0;
+
+    for (auto _ : state)
+    {
+        for (const auto &operands : AluOperands)
+        {
+            uint32_t result = ALU_Mla(operands[0], operands[1], operands[0], flags);
+
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(flags);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * OperandCount);
+}
+
+BENCHMARK(AluMla);
+
+//! @brief Measures a long multiply operation.
+template<LongMultiplyFn TOperation>
+void AluLongMultiply(benchmark::State &state)
+{
+    LongWord accumulator;
+    accumulator.Scalar = 0;
+    uint8_t flags = 0;
+
+    for (auto _ : state)
+    {
+        for (const auto &operands : AluOperands)
+        {
+            flags = TOperation(accumulator, operands[0], operands[1], flags);
+
+            benchmark::DoNotOptimize(accumulator);
+            benchmark::DoNotOptimize(flags);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * OperandCount);
+}
+
+BENCHMARK_TEMPLATE(AluLongMultiply, ALU_Umull);
+BENCHMARK_TEMPLATE(AluLongMultiply, ALU_Umlal);
+BENCHMARK_TEMPLATE(AluLongMultiply, ALU_Smull);
+BENCHMARK_TEMPLATE(AluLongMultiply, ALU_Smlal);
+
+//! @brief Evaluates every condition code against every combination of
+//! status flags.
+void CanExecuteInstruction(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        for (uint32_t condition = 0; condition < 16; ++condition)
+        {
+            const uint32_t instruction = (condition << 28) | 0x01A00000;
+
+            for (uint8_t flags = 0; flags < 16; ++flags)
+            {
+                bool canExecute = canExecuteInstruction(instruction, flags);
+
+                benchmark::DoNotOptimize(canExecute);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 256);
+}
+
+BENCHMARK(CanExecuteInstruction);
+
+void CalculateShiftedAluOperand(benchmark::State &state)
+{
+    BenchHardware hardware;
+    BenchRegisterFile regs(hardware);
+    regs.setPSR(0x0C000003);
+    regs.setRn(GeneralRegister::R1, 0x80000001);
+    regs.setRn(GeneralRegister::R2, 7);
+    regs.setRn(GeneralRegister::R3, 40);
+
+    for (auto _ : state)
+    {
+        for (uint32_t instruction : ShiftedOperandInstructions)
+        {
+            uint8_t carryOut = 0;
+            uint32_t operand = calculateShiftedAluOperand(regs, instruction, carryOut);
+
+            benchmark::DoNotOptimize(operand);
+            benchmark::DoNotOptimize(carryOut);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(std::size(ShiftedOperandInstructions)));
+}
+
+BENCHMARK(CalculateShiftedAluOperand);
+
+//! @brief Measures register bank switching by alternating between two modes
+//! via setPSR(), the public path to the register file's changeMode().
+void ChangeMode(benchmark::State &state)
+{
+    // Pair Supervisor mode with IRQ mode or, with a non-zero argument, FIRQ
+    // mode which banks more registers.
+    const uint32_t otherMode = (state.range(0) == 0) ? 0x0C000002 : 0x0C000001;
+    BenchHardware hardware;
+    BenchRegisterFile regs(hardware);
+    regs.setPSR(0x0C000003);
+
+    for (auto _ : state)
+    {
+        uint32_t result = regs.setPSR(otherMode);
+        benchmark::DoNotOptimize(result);
+
+        result = regs.setPSR(0x0C000003);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(ChangeMode)->Arg(0)->Arg(1);
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,151 @@
+//! @file Bench_FrameConverter.cpp
+//! @brief The definition of micro-benchmarks of converting VIDC video memory
+//! into host pixels.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "ArmEmu/FrameConverter.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The width of the display area converted, as in a standard
+//! 640 x 256 desktop mode.
+constexpr uint32_t DisplayWidth = 640;
+
+//! @brief The height of the display area converted.
+constexpr uint32_t DisplayHeight = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Converts a whole display area with the bits per pixel as a power
+//! of 2 given by the first argument and the SimdLevel given by the second.
+void FrameConverterConvertPixels(benchmark::State &state)
+{
+    const uint8_t bppPow2 = static_cast<uint8_t>(state.range(0));
+    const SimdLevel level = static_cast<SimdLevel>(state.range(1));
+
+    if (level > FrameConverter::getSupportedSimdLevel())
+    {
+        state.SkipWithError("Not supported by the host.");
+    }
+    else
+    {
+        const uint32_t bytesPerLine = (DisplayWidth << bppPow2) / 8;
+        std::vector<uint8_t> videoMemory(bytesPerLine * DisplayHeight);
+        std::vector<uint32_t> frame(DisplayWidth * DisplayHeight);
+
+        for (size_t i = 0; i < videoMemory.size(); ++i)
+        {
+            videoMemory[i] = static_cast<uint8_t>(i * 0x9D);
+        }
+
+        VidcPalette palette;
+
+        for (uint8_t i = 0; i < VidcPalette::ColourCount; ++i)
+        {
+            palette.Colours[i] = static_cast<uint16_t>(i * 0x111);
+        }
+
+        FrameConverter converter(level);
+        converter.setPalette(palette);
+
+        for (auto _ : state)
+        {
+            for (uint32_t y = 0; y < DisplayHeight; ++y)
+            {
+                converter.convertPixels(videoMemory.data() + (y * bytesPerLine),
+                                        frame.data() + (y * DisplayWidth),
+                                        DisplayWidth, bppPow2);
+            }
+
+            benchmark::DoNotOptimize(frame.data());
+            benchmark::ClobberMemory();
+        }
+
+        state.SetLabel(std::to_string(1 << bppPow2) + " bpp " +
+                       FrameConverter::getSimdLevelName(level));
+        state.SetItemsProcessed(state.iterations() * DisplayWidth * DisplayHeight);
+    }
+}
+
+BENCHMARK(FrameConverterConvertPixels)->ArgsProduct({ { 0, 1, 2, 3 }, { 0, 1, 2 } });
+
+//! @brief Renders a whole 4 bpp frame a line at a time, including border
+//! and cursor.
+void FrameConverterRenderLine(benchmark::State &state)
+{
+    VidcTiming timing;
+    timing.BitsPerPixelPow2 = 2;
+    timing.HorzCycle = 1024;
+    timing.HorzBorderStart = 100;
+    timing.HorzDisplayStart = 132;
+    timing.HorzDisplayEnd = timing.HorzDisplayStart + DisplayWidth;
+    timing.HorzBorderEnd = timing.HorzDisplayEnd + 32;
+    timing.HorzCursorStart = 400;
+    timing.VertCycle = 312;
+    timing.VertBorderStart = 20;
+    timing.VertDisplayStart = 36;
+    timing.VertDisplayEnd = timing.VertDisplayStart + DisplayHeight;
+    timing.VertBorderEnd = timing.VertDisplayEnd + 16;
+    timing.VertCursorStart = 100;
+    timing.VertCursorEnd = 132;
+
+    const uint32_t bytesPerLine = timing.getDisplayBytesPerLine();
+    const uint32_t frameWidth = timing.getFrameWidth();
+    std::vector<uint8_t> videoMemory(bytesPerLine * DisplayHeight, 0x5A);
+    std::vector<uint8_t> cursor(VidcTiming::CursorBytesPerLine, 0x1B);
+    std::vector<uint32_t> frame(frameWidth * timing.getFrameHeight());
+
+    FrameConverter converter;
+    converter.setPalette(VidcPalette());
+
+    for (auto _ : state)
+    {
+        uint32_t *target = frame.data();
+
+        for (uint16_t line = timing.VertBorderStart; line < timing.VertBorderEnd;
+             ++line, target += frameWidth)
+        {
+            const bool isDisplay = (line >= timing.VertDisplayStart) &&
+                                   (line < timing.VertDisplayEnd);
+            const bool isCursor = (line >= timing.VertCursorStart) &&
+                                  (line < timing.VertCursorEnd);
+            const uint8_t *source = isDisplay ?
+                videoMemory.data() + ((line - timing.VertDisplayStart) * bytesPerLine) :
+                nullptr;
+
+            converter.renderLine(timing, source, isCursor ? cursor.data() : nullptr,
+                                 target);
+        }
+
+        benchmark::DoNotOptimize(frame.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * frame.size());
+}
+
+BENCHMARK(FrameConverterRenderLine);
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
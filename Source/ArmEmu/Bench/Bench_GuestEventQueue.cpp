@@ -0,0 +1,83 @@
+//! @file Bench_GuestEventQueue.cpp
+//! @brief The definition of micro-benchmarks of passing events from the
+//! emulator thread to the host through GuestEventQueue.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <benchmark/benchmark.h>
+
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "ArmEmu/GuestEventQueue.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The count of events passed between threads in each iteration.
+constexpr size_t EventsPerIteration = 100000;
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Passes events from a producer thread to a consumer which dequeues
+//! them in batches of the size given by the benchmark argument.
+void DequeThroughput(benchmark::State &state)
+{
+    const size_t batchSize = static_cast<size_t>(state.range(0));
+    std::vector<GuestEvent> batch(batchSize);
+
+    for (auto _ : state)
+    {
+        GuestEventQueue queue(0x1234);
+
+        auto producer = std::async(std::launch::async, [&queue]()
+        {
+            for (size_t i = 0; i < EventsPerIteration; ++i)
+            {
+                // Spin while the queue is full, as the emulator would.
+                while (queue.enque(1, i, 0) == false)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        size_t received = 0;
+
+        while (received < EventsPerIteration)
+        {
+            size_t count = queue.tryDequeMany(batch.data(), batch.size());
+            received += count;
+
+            if (count == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        producer.wait();
+        benchmark::DoNotOptimize(batch.data());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * EventsPerIteration));
+}
+
+BENCHMARK(DequeThroughput)->Arg(1)->Arg(32)->UseRealTime();
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,217 @@
+//! @file Bench_Memory.cpp
+//! @brief The definition of micro-benchmarks of guest address decoding and
+//! translation.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "MemcHardware.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The count of logical pages mapped for translation benchmarks.
+constexpr uint32_t MappedPageCount = 64;
+
+//! @brief The size of the pages mapped for translation benchmarks.
+constexpr uint32_t PageSize = 0x2000;
+
+//! @brief The count of addresses looked up per benchmark iteration.
+constexpr uint32_t LookupCount = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A MEMC with the first 64 logical pages identity mapped using 8 KB
+//! pages, as the MEMC test ROM does.
+class MappedMemc
+{
+private:
+    AddressMap _readDevices;
+    AddressMap _writeDevices;
+    MemcHardware _memc;
+public:
+    MappedMemc() :
+        _memc(Options(), _readDevices, _writeDevices)
+    {
+        _memc.reset();
+        _memc.setPrivilegedMode(true);
+
+        // Select 8 KB pages.
+        _memc.write<uint32_t>(0x36E0004, 0);
+
+        for (uint32_t page = 0; page < MappedPageCount; ++page)
+        {
+            // Encode an identity mapping in a CAM address.
+            uint32_t mapping = 0x3800000;
+            mapping |= (page & 0x3F) << 1;
+            mapping |= (page & 0x40) >> 6;
+            mapping |= (page & 0x3FF) << 13;
+            mapping |= (page & 0xC00) << 10;
+
+            _memc.write<uint32_t>(mapping, 0);
+        }
+    }
+
+    MemcHardware &get() { return _memc; }
+};
+
+//! @brief Generates the addresses looked up by the benchmarks, visiting each
+//! mapped page in a non-sequential order.
+std::vector<uint32_t> createLogicalAddresses()
+{
+    std::vector<uint32_t> addresses;
+    addresses.reserve(LookupCount);
+
+    for (uint32_t i = 0; i < LookupCount; ++i)
+    {
+        const uint32_t page = (i * 37) % MappedPageCount;
+        addresses.push_back((page * PageSize) + (((i * 52) % PageSize) & ~3u));
+    }
+
+    return addresses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+void MemcTranslateAddress(benchmark::State &state)
+{
+    auto memc = std::make_unique<MappedMemc>();
+    const std::vector<uint32_t> addresses = createLogicalAddresses();
+
+    for (auto _ : state)
+    {
+        for (uint32_t logicalAddr : addresses)
+        {
+            uint32_t physAddr = 0;
+            uint8_t result = memc->get().translateAddress(logicalAddr, physAddr, false);
+
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(physAddr);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+BENCHMARK(MemcTranslateAddress);
+
+void MemcTryGetReadHostMapping(benchmark::State &state)
+{
+    auto memc = std::make_unique<MappedMemc>();
+    const std::vector<uint32_t> addresses = createLogicalAddresses();
+
+    for (auto _ : state)
+    {
+        for (uint32_t logicalAddr : addresses)
+        {
+            void *hostBlock = nullptr;
+            uint32_t length = 0;
+            uint8_t result = memc->get().tryGetReadHostMapping(logicalAddr, hostBlock, length);
+
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(hostBlock);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+BENCHMARK(MemcTryGetReadHostMapping);
+
+//! @brief Writes words to mapped RAM. If the benchmark argument is non-zero
+//! the video buffer covers all of the mapped pages so that every store is
+//! tracked as a change to the display.
+void MemcWriteWord(benchmark::State &state)
+{
+    auto memc = std::make_unique<MappedMemc>();
+    const std::vector<uint32_t> addresses = createLogicalAddresses();
+
+    if (state.range(0) != 0)
+    {
+        // Set Vstart to 0 and Vend to the end of the mapped pages.
+        memc->get().write<uint32_t>(0x3620000, 0);
+        memc->get().write<uint32_t>(0x3640000 | ((((MappedPageCount * PageSize) - 16) >> 4) << 2), 0);
+    }
+
+    for (auto _ : state)
+    {
+        for (uint32_t logicalAddr : addresses)
+        {
+            bool isWritten = memc->get().write<uint32_t>(logicalAddr, logicalAddr);
+
+            benchmark::DoNotOptimize(isWritten);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+BENCHMARK(MemcWriteWord)->Arg(0)->Arg(1);
+
+//! @brief Finds regions in an address map holding a number of 4 KB
+//! regions given by the benchmark argument.
+void AddressMapTryFindRegion(benchmark::State &state)
+{
+    constexpr uint32_t RegionSize = 0x1000;
+    const uint32_t regionCount = static_cast<uint32_t>(state.range(0));
+
+    std::vector<uint8_t> hostMemory(RegionSize);
+    std::vector<std::unique_ptr<GenericHostBlock>> regions;
+    AddressMap specimen;
+
+    for (uint32_t i = 0; i < regionCount; ++i)
+    {
+        // Leave a gap between regions so that misses are also exercised.
+        regions.push_back(std::make_unique<GenericHostBlock>("Block", "A benchmark block",
+                                                             hostMemory.data(),
+                                                             RegionSize));
+        specimen.tryInsert(i * RegionSize * 2, regions.back().get());
+    }
+
+    std::vector<uint32_t> addresses;
+    const uint32_t addressSpan = regionCount * RegionSize * 2;
+
+    for (uint32_t i = 0; i < LookupCount; ++i)
+    {
+        addresses.push_back(((i * 0x9E3779B1u) % addressSpan) & ~3u);
+    }
+
+    for (auto _ : state)
+    {
+        for (uint32_t address : addresses)
+        {
+            IAddressRegion *region = nullptr;
+            uint32_t offset = 0, remaining = 0;
+            bool isFound = specimen.tryFindRegion(address, region, offset, remaining);
+
+            benchmark::DoNotOptimize(isFound);
+            benchmark::DoNotOptimize(region);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * LookupCount);
+}
+
+BENCHMARK(AddressMapTryFindRegion)->RangeMultiplier(4)->Range(4, 256);
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
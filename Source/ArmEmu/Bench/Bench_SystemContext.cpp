@@ -0,0 +1,166 @@
+//! @file Bench_SystemContext.cpp
+//! @brief The definition of micro-benchmarks of emulated time keeping and
+//! task scheduling.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "ArmEmu/EmuOptions.hpp"
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A time far enough in the future that background tasks never run.
+constexpr uint64_t Never = UINT64_MAX;
+
+//! @brief The count of CPU cycles between runs of a recurring task.
+constexpr uint32_t TaskPeriodCycles = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A task which runs at a fixed interval.
+struct RecurringTask
+{
+    GuestTask Task;
+    uint64_t PeriodTicks;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+void doNothing(SystemContext &/*guestContext*/, uintptr_t /*taskContext*/)
+{
+}
+
+//! @brief A task which re-schedules itself a fixed number of master clock
+//! ticks in the future, as the IOC timers do.
+void reschedule(SystemContext &guestContext, uintptr_t taskContext)
+{
+    RecurringTask *recurring = reinterpret_cast<RecurringTask *>(taskContext);
+
+    recurring->Task.At += recurring->PeriodTicks;
+    guestContext.scheduleTask(&recurring->Task);
+}
+
+//! @brief Fills a collection of tasks which are scheduled at evenly spaced
+//! times between the current time and the end of time.
+void scheduleBackgroundTasks(SystemContext &context, std::vector<GuestTask> &tasks)
+{
+    const uint64_t spacing = (Never / 2) / (tasks.size() + 1);
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        GuestTask &task = tasks[i];
+        task.At = spacing * (i + 1);
+        task.Context = 0;
+        task.Next = nullptr;
+        task.Task = doNothing;
+
+        context.scheduleTask(&task);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Inserts a task into the middle of a queue of the length given
+//! by the benchmark argument, then cancels it so the queue is unchanged.
+void ScheduleTask(benchmark::State &state)
+{
+    Options opts;
+    GuestEventQueue eventQueue;
+    SystemContext context(opts, eventQueue, nullptr);
+    std::vector<GuestTask> background(static_cast<size_t>(state.range(0)));
+
+    scheduleBackgroundTasks(context, background);
+
+    GuestTask task;
+    task.At = Never / 4;
+    task.Context = 0;
+    task.Next = nullptr;
+    task.Task = doNothing;
+
+    for (auto _ : state)
+    {
+        context.scheduleTask(&task);
+        context.cancelTask(&task);
+    }
+}
+
+BENCHMARK(ScheduleTask)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+
+//! @brief Advances the clock when no task is due, the path taken after
+//! almost every instruction.
+void IncrementCPUClock(benchmark::State &state)
+{
+    Options opts;
+    GuestEventQueue eventQueue;
+    SystemContext context(opts, eventQueue, nullptr);
+    std::vector<GuestTask> background(4);
+
+    scheduleBackgroundTasks(context, background);
+
+    for (auto _ : state)
+    {
+        context.incrementCPUClock(1);
+    }
+
+    benchmark::DoNotOptimize(context.getMasterClockTicks());
+}
+
+BENCHMARK(IncrementCPUClock);
+
+//! @brief Advances the clock far enough to run a task which re-schedules
+//! itself on every call.
+void IncrementCPUClockDispatch(benchmark::State &state)
+{
+    Options opts;
+    GuestEventQueue eventQueue;
+    SystemContext context(opts, eventQueue, nullptr);
+    std::vector<GuestTask> background(4);
+
+    scheduleBackgroundTasks(context, background);
+
+    // The master clock runs at a multiple of the CPU clock.
+    const uint64_t cpuFreq = static_cast<uint64_t>(opts.getProcessorSpeedMHz()) * 1000000u;
+
+    RecurringTask recurring;
+    recurring.PeriodTicks = TaskPeriodCycles * (context.getMasterClockFrequency() / cpuFreq);
+    recurring.Task.At = recurring.PeriodTicks;
+    recurring.Task.Context = reinterpret_cast<uintptr_t>(&recurring);
+    recurring.Task.Next = nullptr;
+    recurring.Task.Task = reschedule;
+    context.scheduleTask(&recurring.Task);
+
+    for (auto _ : state)
+    {
+        // Advance to the next time the task is due.
+        context.incrementCPUClock(TaskPeriodCycles);
+    }
+
+    benchmark::DoNotOptimize(context.getMasterClockTicks());
+}
+
+BENCHMARK(IncrementCPUClockDispatch);
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
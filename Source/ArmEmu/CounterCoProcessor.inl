@@ -0,0 +1,137 @@
+//! @file ArmEmu/CounterCoProcessor.inl
+//! @brief The declaration of an emulator-only co-processor which allows guest
+//! code to read the counters maintained by the emulator.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_COUNTER_CO_PROCESSOR_INL__
+#define __ARM_EMU_COUNTER_CO_PROCESSOR_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemMetrics.hpp"
+
+#include "ArmCore.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An emulator-only co-processor, numbered 7, which guest code can
+//! read with MRC to time routines precisely.
+//! @details The co-processor only exists if enabled with
+//! Options::setCounterCoProcessor(), otherwise accessing it raises an
+//! undefined instruction exception like any other absent co-processor. It can
+//! be read in any processor mode using MRC CP7,0,Rd,CRn,CR0,0 where CRn
+//! selects the value:
+//! - CR0/CR1: The low/high words of the count of emulated CPU cycles.
+//! - CR2/CR3: The low/high words of the count of instructions executed.
+//! - CR4/CR5: The low/high words of a host monotonic time in nanoseconds.
+//!
+//! Reading a low word latches the matching high word, so that a 64-bit value
+//! can be read consistently with two instructions. Counts don't include the
+//! MRC instruction doing the reading.
+class CounterCoProcessor
+{
+public:
+    // Public Constants
+    //! @brief The co-processor number the counters are accessed through.
+    static constexpr uint8_t Number = 7;
+
+    //! @brief The mask and value to apply to an instruction word to
+    //! identify an MRC CP7,0,Rd,CRn,CR0,0 instruction.
+    static constexpr uint32_t MrcMask = 0x0FF00FFF;
+    static constexpr uint32_t MrcBits = 0x0E100010 | (Number << 8);
+
+    // Construction/Destruction
+    //! @brief Constructs a co-processor which isn't connected to any
+    //! counters and so doesn't appear to exist.
+    CounterCoProcessor() :
+        _context(nullptr),
+        _instructionCount(nullptr),
+        _latchedHighWord(0)
+    {
+    }
+
+    // Accessors
+    //! @brief Determines whether the co-processor is present in the
+    //! emulated system.
+    bool isPresent() const noexcept { return _context != nullptr; }
+
+    // Operations
+    //! @brief Connects the co-processor to the counters it exposes, making it
+    //! visible to guest code.
+    //! @param[in] context The object which keeps track of emulated time.
+    //! @param[in] instructionCount The running total of instructions
+    //! executed maintained by the execution unit.
+    void connect(const SystemContext *context, const uint64_t *instructionCount)
+    {
+        _context = context;
+        _instructionCount = instructionCount;
+        _latchedHighWord = 0;
+    }
+
+    //! @brief Reads a co-processor register.
+    //! @param[in] regId The register to read.
+    //! @return The value of the register, CR6-CR15 always read as zero.
+    uint32_t readRegister(CoProcRegister regId) noexcept
+    {
+        uint32_t value = 0;
+
+        switch (regId)
+        {
+        case CoProcRegister::CR0:
+            value = latchValue(_context->getCPUClockTicks());
+            break;
+
+        case CoProcRegister::CR2:
+            value = latchValue(*_instructionCount);
+            break;
+
+        case CoProcRegister::CR4:
+            value = latchValue(SystemCounters::getHostTimeNs());
+            break;
+
+        case CoProcRegister::CR1:
+        case CoProcRegister::CR3:
+        case CoProcRegister::CR5:
+            value = _latchedHighWord;
+            break;
+
+        default:
+            break;
+        }
+
+        return value;
+    }
+
+private:
+    // Internal Functions
+    //! @brief Latches the high word of a 64-bit value to be read later.
+    //! @param[in] value The value being read.
+    //! @return The low word of the value.
+    uint32_t latchValue(uint64_t value) noexcept
+    {
+        _latchedHighWord = static_cast<uint32_t>(value >> 32);
+
+        return static_cast<uint32_t>(value);
+    }
+
+    // Internal Fields
+    const SystemContext *_context;
+    const uint64_t *_instructionCount;
+    uint32_t _latchedHighWord;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
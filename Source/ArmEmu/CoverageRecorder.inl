@@ -0,0 +1,82 @@
+//! @file ArmEmu/CoverageRecorder.inl
+//! @brief The declaration of components which an execution unit uses to
+//! record which instructions have been executed, or not.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_COVERAGE_RECORDER_INL__
+#define __ARM_EMU_COVERAGE_RECORDER_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "ArmEmu/GuestCoverage.hpp"
+
+#include "ArmCore.hpp"
+#include "RegisterFile.inl"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Takes the place of CoverageRecorder in execution units which don't
+//! record coverage, so the system has no coverage map to expose.
+class NullCoverageRecorder
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit not to pass the address of each
+    //! instruction to beforeInstruction(), which isn't defined here.
+    static constexpr bool IsEnabled = false;
+
+    // Accessors
+    //! @brief Gets the coverage map, always nullptr.
+    GuestCoverageMap *getCoverage() { return nullptr; }
+};
+
+//! @brief An object which marks the address of each instruction executed in
+//! a coverage bitmap.
+class CoverageRecorder
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit to pass the address of each
+    //! instruction to beforeInstruction().
+    static constexpr bool IsEnabled = true;
+
+    // Accessors
+    //! @brief Gets the map of instructions executed.
+    GuestCoverageMap *getCoverage() { return &_coverage; }
+
+    // Operations
+    //! @brief Records the instruction about to be executed.
+    //! @tparam TRegisterFile The data type of the register file modelled on
+    //! GenericCoreRegisterFile.
+    //! @param[in] regs The register file containing the PC.
+    //! @param[in] isFlushPending True if the PC points to the next
+    //! instruction to execute rather than the next to fetch.
+    template<typename TRegisterFile>
+    void beforeInstruction(const TRegisterFile &regs, bool isFlushPending)
+    {
+        constexpr uint32_t AddrMask = TRegisterFile::HasCombinedPcPsr ?
+                                      ~PsrMask26::PrivilageBits : ~3u;
+
+        // The PC is normally 8 bytes beyond the next instruction to execute.
+        const uint32_t pc = regs.getPC() & AddrMask;
+        _coverage.mark(isFlushPending ? pc : pc - 8);
+    }
+private:
+    // Internal Fields
+    GuestCoverageMap _coverage;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
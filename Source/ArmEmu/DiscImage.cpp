@@ -0,0 +1,417 @@
+//! @file ArmEmu/DiscImage.cpp
+//! @brief The definition of an object which maps a floppy disc image file
+//! into memory and tracks the sectors written to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ArmEmu/DiscImage.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The layouts of the ADFS floppy disc formats a WD1772 can read.
+const DiscGeometry KnownGeometries[] = {
+    DiscGeometry(80, 2, 5, 1024),   // ADFS D/E, 800 KB
+    DiscGeometry(80, 2, 16, 256),   // ADFS L, 640 KB
+    DiscGeometry(80, 1, 16, 256),   // ADFS M, 320 KB
+    DiscGeometry(40, 1, 16, 256),   // ADFS S, 160 KB
+};
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// DiscGeometry Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty, invalid, disc layout.
+DiscGeometry::DiscGeometry() :
+    TrackCount(0),
+    SideCount(0),
+    SectorsPerTrack(0),
+    SectorSize(0)
+{
+}
+
+//! @brief Constructs a description of a disc layout.
+//! @param[in] trackCount The count of tracks on each side.
+//! @param[in] sideCount The count of sides.
+//! @param[in] sectorsPerTrack The count of sectors on each track.
+//! @param[in] sectorSize The count of bytes in each sector.
+DiscGeometry::DiscGeometry(uint16_t trackCount, uint8_t sideCount,
+                           uint8_t sectorsPerTrack, uint16_t sectorSize) :
+    TrackCount(trackCount),
+    SideCount(sideCount),
+    SectorsPerTrack(sectorsPerTrack),
+    SectorSize(sectorSize)
+{
+}
+
+//! @brief Determines whether the layout describes a disc which can be
+//! formatted by a double density controller.
+bool DiscGeometry::isValid() const
+{
+    return (TrackCount > 0) && (TrackCount <= 84) &&
+           (SideCount > 0) && (SideCount <= 2) &&
+           (SectorsPerTrack > 0) &&
+           ((SectorSize == 128) || (SectorSize == 256) ||
+            (SectorSize == 512) || (SectorSize == 1024));
+}
+
+//! @brief Gets the total count of sectors on the disc.
+uint32_t DiscGeometry::getSectorCount() const
+{
+    return static_cast<uint32_t>(TrackCount) * SideCount * SectorsPerTrack;
+}
+
+//! @brief Gets the count of bytes on each track of one side.
+uint32_t DiscGeometry::getTrackSize() const
+{
+    return static_cast<uint32_t>(SectorsPerTrack) * SectorSize;
+}
+
+//! @brief Gets the count of bytes in an image of the whole disc.
+uint32_t DiscGeometry::getImageSize() const
+{
+    return getSectorCount() * SectorSize;
+}
+
+//! @brief Gets the sector length code recorded in each sector ID field,
+//! 0 for 128 bytes to 3 for 1024 bytes.
+uint8_t DiscGeometry::getSectorSizeCode() const
+{
+    uint8_t code = 0;
+
+    while ((code < 3) && ((128u << code) < SectorSize))
+    {
+        ++code;
+    }
+
+    return code;
+}
+
+//! @brief Attempts to deduce the layout of a disc from the size of its image.
+//! @param[in] imageSize The count of bytes in the image file.
+//! @param[out] geometry Receives the layout if it was recognised.
+//! @retval true The size matched a known ADFS format.
+//! @retval false The image wasn't recognised.
+bool DiscGeometry::tryDeduce(uint64_t imageSize, DiscGeometry &geometry)
+{
+    bool isKnown = false;
+
+    for (const DiscGeometry &candidate : KnownGeometries)
+    {
+        if (candidate.getImageSize() == imageSize)
+        {
+            geometry = candidate;
+            isKnown = true;
+            break;
+        }
+    }
+
+    return isKnown;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// DiscImage Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object with no disc image mapped.
+DiscImage::DiscImage() :
+    _data(nullptr),
+    _size(0),
+    _dirtySectorCount(0),
+    _isWriteProtected(true)
+{
+}
+
+//! @brief Writes back any changed sectors and unmaps the image.
+DiscImage::~DiscImage()
+{
+    close();
+}
+
+//! @brief Determines whether an image file is mapped.
+bool DiscImage::isOpen() const
+{
+    return _data != nullptr;
+}
+
+//! @brief Determines whether sectors of the disc can be written.
+bool DiscImage::isWriteProtected() const
+{
+    return _isWriteProtected;
+}
+
+//! @brief Gets the name of the image file mapped.
+const std::string &DiscImage::getFileName() const
+{
+    return _fileName;
+}
+
+//! @brief Gets the layout of the disc, invalid if no image is mapped.
+const DiscGeometry &DiscImage::getGeometry() const
+{
+    return _geometry;
+}
+
+//! @brief Gets the count of sectors written since the image was last flushed.
+uint32_t DiscImage::getDirtySectorCount() const
+{
+    return _dirtySectorCount;
+}
+
+//! @brief Determines whether a sector has been written since the image was
+//! last flushed.
+//! @param[in] track The 0-based physical track.
+//! @param[in] side The 0-based side of the disc.
+//! @param[in] sector The ID of the sector, from 0.
+bool DiscImage::isSectorDirty(uint16_t track, uint8_t side, uint8_t sector) const
+{
+    const int32_t index = getSectorIndex(track, side, sector);
+
+    return (index >= 0) &&
+           ((_dirtySectors[index >> 6] & (uint64_t(1) << (index & 63))) != 0);
+}
+
+//! @brief Gets the data of a sector to read.
+//! @param[in] track The 0-based physical track.
+//! @param[in] side The 0-based side of the disc.
+//! @param[in] sector The ID of the sector, from 0.
+//! @return A pointer to DiscGeometry::SectorSize bytes, or nullptr if the
+//! sector isn't on the disc.
+const uint8_t *DiscImage::getSector(uint16_t track, uint8_t side,
+                                    uint8_t sector) const
+{
+    const int32_t index = getSectorIndex(track, side, sector);
+
+    return (index < 0) ? nullptr :
+                         _data + (static_cast<size_t>(index) * _geometry.SectorSize);
+}
+
+//! @brief Gets the data of a sector to be overwritten and marks it as dirty.
+//! @param[in] track The 0-based physical track.
+//! @param[in] side The 0-based side of the disc.
+//! @param[in] sector The ID of the sector, from 0.
+//! @return A pointer to DiscGeometry::SectorSize bytes, or nullptr if the
+//! sector isn't on the disc or the disc is write protected.
+uint8_t *DiscImage::getWritableSector(uint16_t track, uint8_t side, uint8_t sector)
+{
+    const int32_t index = getSectorIndex(track, side, sector);
+    uint8_t *data = nullptr;
+
+    if ((index >= 0) && (_isWriteProtected == false))
+    {
+        uint64_t &word = _dirtySectors[index >> 6];
+        const uint64_t bit = uint64_t(1) << (index & 63);
+
+        if ((word & bit) == 0)
+        {
+            word |= bit;
+            ++_dirtySectorCount;
+        }
+
+        data = _data + (static_cast<size_t>(index) * _geometry.SectorSize);
+    }
+
+    return data;
+}
+
+//! @brief Attempts to map a disc image file into memory.
+//! @param[in] fileName The path to the image file, its size must match one
+//! of the ADFS floppy disc formats.
+//! @param[in] isWriteProtected True to map the image read-only. Images which
+//! can't be opened for writing are always write protected.
+//! @param[out] error Receives a description of why the image couldn't be
+//! mapped.
+//! @retval true The image was mapped, replacing any mapped before.
+//! @retval false The image couldn't be mapped, error is updated.
+bool DiscImage::tryOpen(const std::string &fileName, bool isWriteProtected,
+                        std::string &error)
+{
+    bool isOpened = false;
+    close();
+
+#ifdef _WIN32
+    (void)fileName;
+    (void)isWriteProtected;
+    error = "Mapping disc images is not supported on this platform.";
+#else
+    int handle = isWriteProtected ? -1 : ::open(fileName.c_str(), O_RDWR);
+
+    if (handle < 0)
+    {
+        isWriteProtected = true;
+        handle = ::open(fileName.c_str(), O_RDONLY);
+    }
+
+    struct stat status;
+    DiscGeometry geometry;
+    void *region = MAP_FAILED;
+
+    if (handle < 0)
+    {
+        error = "Could not open disc image '" + fileName + "': " +
+                std::strerror(errno);
+    }
+    else if (::fstat(handle, &status) != 0)
+    {
+        error = "Could not get the size of disc image '" + fileName + "': " +
+                std::strerror(errno);
+    }
+    else if (DiscGeometry::tryDeduce(static_cast<uint64_t>(status.st_size),
+                                     geometry) == false)
+    {
+        error = "The size of disc image '" + fileName +
+                "' doesn't match a known floppy disc format.";
+    }
+    else
+    {
+        // Share the mapping with the file so that writes need no copying,
+        // only the dirty pages are synchronised by flush().
+        region = ::mmap(nullptr, static_cast<size_t>(status.st_size),
+                        isWriteProtected ? PROT_READ : (PROT_READ | PROT_WRITE),
+                        MAP_SHARED, handle, 0);
+
+        if (region == MAP_FAILED)
+        {
+            error = "Could not map disc image '" + fileName + "': " +
+                    std::strerror(errno);
+        }
+    }
+
+    if (handle >= 0)
+    {
+        // The mapping keeps the file open.
+        ::close(handle);
+    }
+
+    if (region != MAP_FAILED)
+    {
+        // The controller seeks between the catalogue and file tracks, and a
+        // floppy image is small enough to keep resident, so fault it all in.
+        ::madvise(region, static_cast<size_t>(status.st_size), MADV_WILLNEED);
+
+        _fileName = fileName;
+        _geometry = geometry;
+        _data = static_cast<uint8_t *>(region);
+        _size = static_cast<size_t>(status.st_size);
+        _dirtySectors.assign((geometry.getSectorCount() + 63) / 64, 0);
+        _dirtySectorCount = 0;
+        _isWriteProtected = isWriteProtected;
+        isOpened = true;
+    }
+#endif
+
+    return isOpened;
+}
+
+//! @brief Writes sectors changed since the last flush back to the image file.
+//! @return The count of dirty sectors written back.
+//! @note Only the pages holding dirty sectors are synchronised.
+uint32_t DiscImage::flush()
+{
+    uint32_t flushedCount = 0;
+
+#ifndef _WIN32
+    if (_dirtySectorCount > 0)
+    {
+        const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        const uint32_t sectorCount = _geometry.getSectorCount();
+        uint32_t index = 0;
+
+        while (index < sectorCount)
+        {
+            if ((_dirtySectors[index >> 6] & (uint64_t(1) << (index & 63))) == 0)
+            {
+                ++index;
+            }
+            else
+            {
+                // Synchronise each run of consecutive dirty sectors at once.
+                const uint32_t first = index;
+
+                while ((index < sectorCount) &&
+                       (_dirtySectors[index >> 6] & (uint64_t(1) << (index & 63))))
+                {
+                    ++index;
+                }
+
+                const size_t start = static_cast<size_t>(first) * _geometry.SectorSize;
+                const size_t end = static_cast<size_t>(index) * _geometry.SectorSize;
+                const size_t pageStart = start & ~(pageSize - 1);
+
+                ::msync(_data + pageStart, end - pageStart, MS_SYNC);
+                flushedCount += index - first;
+            }
+        }
+
+        std::fill(_dirtySectors.begin(), _dirtySectors.end(), 0);
+        _dirtySectorCount = 0;
+    }
+#endif
+
+    return flushedCount;
+}
+
+//! @brief Writes back any changed sectors and unmaps the image.
+void DiscImage::close()
+{
+    if (_data != nullptr)
+    {
+        flush();
+
+#ifndef _WIN32
+        ::munmap(_data, _size);
+#endif
+    }
+
+    _fileName.clear();
+    _dirtySectors.clear();
+    _geometry = DiscGeometry();
+    _data = nullptr;
+    _size = 0;
+    _dirtySectorCount = 0;
+    _isWriteProtected = true;
+}
+
+//! @brief Gets the position of a sector within the image.
+//! @param[in] track The 0-based physical track.
+//! @param[in] side The 0-based side of the disc.
+//! @param[in] sector The ID of the sector, from 0.
+//! @return The 0-based index of the sector, or -1 if it isn't on the disc.
+int32_t DiscImage::getSectorIndex(uint16_t track, uint8_t side, uint8_t sector) const
+{
+    int32_t index = -1;
+
+    if ((_data != nullptr) && (track < _geometry.TrackCount) &&
+        (side < _geometry.SideCount) && (sector < _geometry.SectorsPerTrack))
+    {
+        index = (((static_cast<int32_t>(track) * _geometry.SideCount) + side) *
+                 _geometry.SectorsPerTrack) + sector;
+    }
+
+    return index;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -80,7 +80,18 @@ Options::Options() :
     _floppyDriveCount(1),
     _joystickType(JoystickInterface::Digital),
     _joystickCount(2),
-    _systemRom(SystemROMPreset::Custom)
+    _systemRom(SystemROMPreset::Custom),
+    _isRealTimePacingEnabled(false),
+    _isGuestProfilingEnabled(false),
+    _isInstrumentationEnabled(false),
+    _isGuestCoverageEnabled(false),
+    _isExecutionTracingEnabled(false),
+    _isCounterCoProcessorEnabled(false),
+    _isVideoOutputEnabled(false),
+    _isScanlineTimingEnabled(false),
+    _isSoundOutputEnabled(false),
+    _isSoundPacingEnabled(false),
+    _isFastDiscEnabled(false)
 {
 }
 
@@ -123,6 +134,195 @@ void Options::setProcessorSpeedMHz(uint16_t clockFreqMHz)
     _processorSpeedMHz = clockFreqMHz;
 }
 
+//! @brief Determines whether the emulated system should be throttled so that
+//! it executes at the speed given by getProcessorSpeedMHz() rather than as fast
+//! as the host allows.
+bool Options::isRealTimePacingEnabled() const
+{
+    return _isRealTimePacingEnabled;
+}
+
+//! @brief Sets whether the emulated system should be throttled to run at
+//! the configured processor speed in real time.
+//! @param[in] isEnabled True to pace emulation against the wall clock,
+//! false to run flat out.
+void Options::setRealTimePacing(bool isEnabled)
+{
+    _isRealTimePacingEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system should be built with an
+//! execution unit which can sample the guest call stack.
+bool Options::isGuestProfilingEnabled() const
+{
+    return _isGuestProfilingEnabled;
+}
+
+//! @brief Sets whether the emulated system should be built with support for
+//! sampling the guest call stack and counting the instructions executed at
+//! each address, see IArmSystem::getProfiler() and
+//! IArmSystem::getExecutionCounters().
+//! @param[in] isEnabled True to include the profiler, false to build a system
+//! with no profiling overhead.
+void Options::setGuestProfiling(bool isEnabled)
+{
+    _isGuestProfilingEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system should be built with an
+//! instruction pipeline which counts the instructions it executes by class.
+bool Options::isInstrumentationEnabled() const
+{
+    return _isInstrumentationEnabled;
+}
+
+//! @brief Sets whether the emulated system should be built with an
+//! instruction pipeline which counts instructions by class, pipeline flushes,
+//! mode changes and memory mapped I/O accesses, see
+//! ExecutionMetrics::Breakdown.
+//! @param[in] isEnabled True to include instrumentation, false to build a
+//! system with none of its overhead.
+void Options::setInstrumentation(bool isEnabled)
+{
+    _isInstrumentationEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system should be built with an
+//! execution unit which records the address of every instruction executed.
+bool Options::isGuestCoverageEnabled() const
+{
+    return _isGuestCoverageEnabled;
+}
+
+//! @brief Sets whether the emulated system should be built with an execution
+//! unit which records the address of every instruction executed, see
+//! IArmSystem::getCoverage().
+//! @param[in] isEnabled True to record coverage, false to build a system
+//! with none of its overhead.
+//! @note Coverage can't be combined with guest profiling or execution
+//! tracing, validate() rejects such options.
+void Options::setGuestCoverage(bool isEnabled)
+{
+    _isGuestCoverageEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system should be built with an
+//! execution unit which can write a trace of the instructions it executes.
+bool Options::isExecutionTracingEnabled() const
+{
+    return _isExecutionTracingEnabled;
+}
+
+//! @brief Sets whether the emulated system should be built with an execution
+//! unit which can write a trace of the instructions it executes, see
+//! IArmSystem::getExecutionTrace().
+//! @param[in] isEnabled True to include the tracer, false to build a system
+//! with none of its overhead.
+//! @note Systems built with guest profiling always include the tracer.
+void Options::setExecutionTracing(bool isEnabled)
+{
+    _isExecutionTracingEnabled = isEnabled;
+}
+
+//! @brief Determines whether guest code can read emulator counters through
+//! an emulator-only co-processor.
+bool Options::isCounterCoProcessorEnabled() const
+{
+    return _isCounterCoProcessorEnabled;
+}
+
+//! @brief Sets whether guest code can read emulator counters through an
+//! emulator-only co-processor, see CounterCoProcessor.
+//! @param[in] isEnabled True to make the co-processor visible to MRC
+//! instructions, false for it to raise an undefined instruction exception
+//! as it would on real hardware.
+void Options::setCounterCoProcessor(bool isEnabled)
+{
+    _isCounterCoProcessorEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system publishes snapshots of its
+//! display at vertical sync.
+bool Options::isVideoOutputEnabled() const
+{
+    return _isVideoOutputEnabled;
+}
+
+//! @brief Sets whether the emulated system publishes snapshots of its
+//! display at vertical sync, see IArmSystem::getVideoFrames().
+//! @param[in] isEnabled True to publish a VideoFrame and post a
+//! HostMessageID::VideoFrameReady message each time the display changes,
+//! false for a headless system.
+void Options::setVideoOutput(bool isEnabled)
+{
+    _isVideoOutputEnabled = isEnabled;
+}
+
+//! @brief Determines whether video DMA is emulated a raster line at a time.
+bool Options::isScanlineTimingEnabled() const
+{
+    return _isScanlineTimingEnabled;
+}
+
+//! @brief Sets whether video DMA is emulated a raster line at a time.
+//! @param[in] isEnabled True to take the processor cycles used by video and
+//! cursor DMA at the start of each raster line, false to take the cycles for
+//! a whole frame at vertical flyback, which is faster, but less precise.
+void Options::setScanlineTiming(bool isEnabled)
+{
+    _isScanlineTimingEnabled = isEnabled;
+}
+
+//! @brief Determines whether the emulated system queues the sound it plays
+//! for the host.
+bool Options::isSoundOutputEnabled() const
+{
+    return _isSoundOutputEnabled;
+}
+
+//! @brief Sets whether the emulated system queues the sound it plays for the
+//! host, see IArmSystem::getSoundSamples().
+//! @param[in] isEnabled True to convert each block of sound DMA to linear
+//! stereo and post a HostMessageID::SoundSamplesReady message, false to
+//! fetch and discard sound data.
+void Options::setSoundOutput(bool isEnabled)
+{
+    _isSoundOutputEnabled = isEnabled;
+}
+
+//! @brief Determines whether emulation is paced by the consumption of
+//! sound samples.
+bool Options::isSoundPacingEnabled() const
+{
+    return _isSoundPacingEnabled;
+}
+
+//! @brief Sets whether emulation is paced by the consumption of sound
+//! samples, only effective if sound output is enabled.
+//! @param[in] isEnabled True to wait for the host to make room for samples
+//! before queuing them, so that the emulated system runs at the speed sound
+//! is played, false to drop samples the host hasn't made room for.
+void Options::setSoundPacing(bool isEnabled)
+{
+    _isSoundPacingEnabled = isEnabled;
+}
+
+//! @brief Determines whether floppy disc commands complete as soon as the
+//! data has been transferred.
+bool Options::isFastDiscEnabled() const
+{
+    return _isFastDiscEnabled;
+}
+
+//! @brief Sets whether floppy disc commands complete as soon as the data
+//! has been transferred.
+//! @param[in] isEnabled True to skip the time taken to spin up, step and
+//! find sectors, false to emulate the timing of a real drive.
+void Options::setFastDisc(bool isEnabled)
+{
+    _isFastDiscEnabled = isEnabled;
+}
+
 //! @brief Gets the size of the dynamic RAM in the emulated system in KB.
 uint32_t Options::getRamSizeKb() const
 {
@@ -319,6 +519,22 @@ void Options::setCustomRom(const Ag::Fs::Path &romPath)
     }
 }
 
+//! @brief Gets the host directory which guest code can access through host
+//! filing system SWIs, empty if the host filing system is disabled.
+const Ag::Fs::Path &Options::getHostFileSystemRoot() const
+{
+    return _hostFsRootPath;
+}
+
+//! @brief Sets the host directory which guest code can access through host
+//! filing system SWIs, see HostFileSystem.
+//! @param[in] rootPath The directory to expose or an empty path for host
+//! filing system SWIs to be passed to the guest like any other SWI.
+void Options::setHostFileSystemRoot(const Ag::Fs::Path &rootPath)
+{
+    _hostFsRootPath = rootPath;
+}
+
 //! @brief Attempts to validate the combination of options currently set.
 //! @param[out] error Receives details of the first error discovered.
 //! @retval true The combination of options specified is valid.
@@ -327,6 +543,16 @@ bool Options::validate(Ag::String &error) const
 {
     error = Ag::String::Empty;
 
+    // Coverage uses its own execution unit, which can't also host the
+    // profiler or the tracer.
+    if (_isGuestCoverageEnabled &&
+        (_isGuestProfilingEnabled || _isExecutionTracingEnabled))
+    {
+        error = "Guest coverage cannot be recorded in a system which is also "
+                "built for guest profiling or execution tracing.";
+        return false;
+    }
+
     if (_model == SystemModel::TestBed)
     {
         // TODO: Expand the selection as support for new processors is added.
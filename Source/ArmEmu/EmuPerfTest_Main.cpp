@@ -11,17 +11,20 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <fstream>
+
 #include "Ag/Core.hpp"
 #include "AsmTools.hpp"
 
 #include "ArmEmu.hpp"
-#include "DhrystoneProgram.hpp"
 #include "ArmEmu/ArmSystemBuilder.hpp"
 #include "TestBedHardware.inl"
 
-// A bit lazy, but it's only one file.
-// TODO: If EmuPerfTest is expanded to more than a single file, resolve the Ag
-// namespaced element references.
+#include "PerfTestResults.hpp"
+#include "PerfTestWorkloads.hpp"
+
+// A bit lazy, but it's confined to the entry point, the other EmuPerfTest
+// source files qualify their Ag namespaced element references.
 using namespace Ag;
 
 namespace Mo {
@@ -36,6 +39,7 @@ enum class EmuPerfTestCommand
     Auto,
     ShowHelp,
     ListConfigs,
+    ListWorkloads,
     RunTest,
 };
 
@@ -50,6 +54,8 @@ enum Configuration
     ArmV3_FPA_Test,
     ArmV4_Test,
     ArmV4_FPA_Test,
+    ArmV2_Archimedes,
+    ArmV2a_ASeries,
 };
 
 const EnumInfo<Configuration> &getConfigMetadata()
@@ -62,11 +68,43 @@ const EnumInfo<Configuration> &getConfigMetadata()
         { Configuration::ArmV3_FPA_Test, "ARMv3-FPA-Test" },
         { Configuration::ArmV4_Test, "ARMv4-Test" },
         { Configuration::ArmV4_FPA_Test, "ARMv4-FPA-Test" },
+        { Configuration::ArmV2_Archimedes, "ARMv2-Archimedes" },
+        { Configuration::ArmV2a_ASeries, "ARMv2a-ASeries" },
     });
 
     return instance;
 }
 
+//! @brief Determines whether a configuration emulates a MEMC-based system
+//! booted from the MEMC test ROM rather than a test bed.
+bool isMemcConfiguration(Configuration config)
+{
+    return (config == Configuration::ArmV2_Archimedes) ||
+           (config == Configuration::ArmV2a_ASeries);
+}
+
+//! @brief Gets the test bed configuration with the same processor as a
+//! MEMC-based configuration, which it is measured relative to.
+Configuration getTestBedEquivalent(Configuration config)
+{
+    Configuration testBed = Configuration::None;
+
+    switch (config)
+    {
+    case Configuration::ArmV2_Archimedes: testBed = Configuration::ArmV2_Test; break;
+    case Configuration::ArmV2a_ASeries: testBed = Configuration::ArmV2a_Test; break;
+    default: break;
+    }
+
+    return testBed;
+}
+
+//! @brief The exit code returned if a significant regression was found.
+constexpr int RegressionExitCode = 2;
+
+//! @brief The count of times each workload is run by default.
+constexpr uint32_t DefaultRepeatCount = 5;
+
 //! @brief Defines command line arguments for the EmuPerfTest tools.
 class EmuPerfTestArgs : public Cli::ProgramArguments
 {
@@ -76,14 +114,59 @@ private:
     {
         ShowHelp,
         CycleCount,
+        Breakdown,
+        Workload,
+        RepeatCount,
+        OutputFile,
+        BaselineFile,
     };
 
     // Internal Fields
+    std::vector<const PerfWorkload *> _workloads;
+    std::string _outputPath;
+    std::string _baselinePath;
     EmuPerfTestCommand _command;
     Configuration _config;
     uint32_t _cycleCount;
+    uint32_t _repeatCount;
+    bool _showBreakdown;
 
     // Internal Functions
+    //! @brief Adds workloads from a comma-separated list of names.
+    bool tryAddWorkloads(const String &names, String &error)
+    {
+        bool isOK = true;
+        std::string_view remaining = names.toUtf8View();
+
+        while (isOK && (remaining.empty() == false))
+        {
+            const size_t separator = remaining.find(',');
+            const std::string_view name = remaining.substr(0, separator);
+            remaining = (separator == std::string_view::npos) ? std::string_view() :
+                                                                remaining.substr(separator + 1);
+
+            if (name == "all")
+            {
+                for (const PerfWorkload &workload : getPerfWorkloads())
+                {
+                    _workloads.push_back(&workload);
+                }
+            }
+            else if (const PerfWorkload *workload = findPerfWorkload(name))
+            {
+                _workloads.push_back(workload);
+            }
+            else
+            {
+                isOK = false;
+                error = String::format(FormatInfo::getDisplay(),
+                                       "Unknown workload '{0}'.",
+                                       { String(name.data(), name.length()) });
+            }
+        }
+
+        return isOK;
+    }
 public:
     static Cli::Schema createSchema()
     {
@@ -93,7 +176,8 @@ public:
 
         builder.defineOption(Option::ShowHelp,
                              "Display command line help. Specify 'configs' to "
-                             "list valid test configurations.",
+                             "list valid test configurations or 'workloads' to "
+                             "list the benchmark workloads.",
                              Cli::OptionValue::Optional, "topic name");
         builder.defineAlias(Option::ShowHelp, U'?');
         builder.defineAlias(Option::ShowHelp, "help");
@@ -104,6 +188,41 @@ public:
         builder.defineAlias(Option::CycleCount, U'c');
         builder.defineAlias(Option::CycleCount, "cycles");
 
+        builder.defineOption(Option::Breakdown,
+                             "Builds an instrumented system and displays the mix "
+                             "of instructions executed.",
+                             Cli::OptionValue::None);
+        builder.defineAlias(Option::Breakdown, U'b');
+        builder.defineAlias(Option::Breakdown, "breakdown");
+
+        builder.defineOption(Option::Workload,
+                             "Selects a comma-separated list of workloads to run, "
+                             "or 'all', the default. Specify '--help workloads' "
+                             "to list them.",
+                             Cli::OptionValue::Mandatory, "workload names");
+        builder.defineAlias(Option::Workload, U'w');
+        builder.defineAlias(Option::Workload, "workload");
+
+        builder.defineOption(Option::RepeatCount,
+                             "Specifies the number of times to run each workload.",
+                             Cli::OptionValue::Mandatory, "run count");
+        builder.defineAlias(Option::RepeatCount, U'r');
+        builder.defineAlias(Option::RepeatCount, "repeat");
+
+        builder.defineOption(Option::OutputFile,
+                             "Writes the results to a JSON file which can be "
+                             "used as a baseline.",
+                             Cli::OptionValue::Mandatory, "output file");
+        builder.defineAlias(Option::OutputFile, U'o');
+        builder.defineAlias(Option::OutputFile, "output");
+
+        builder.defineOption(Option::BaselineFile,
+                             "Compares the results against those in a JSON file "
+                             "and reports statistically significant differences.",
+                             Cli::OptionValue::Mandatory, "baseline file");
+        builder.defineAlias(Option::BaselineFile, U'p');
+        builder.defineAlias(Option::BaselineFile, "compare");
+
         return builder.createSchema();
     }
 
@@ -112,7 +231,9 @@ public:
         Cli::ProgramArguments(createSchema()),
         _command(EmuPerfTestCommand::Auto),
         _config(Configuration::None),
-        _cycleCount(0)
+        _cycleCount(0),
+        _repeatCount(0),
+        _showBreakdown(false)
     {
     }
 
@@ -122,6 +243,11 @@ public:
     EmuPerfTestCommand getCommand() const { return _command; }
     Configuration getConfiguration() const { return _config; }
     uint32_t getCycleCount() const { return _cycleCount; }
+    uint32_t getRepeatCount() const { return _repeatCount; }
+    bool isBreakdownRequired() const { return _showBreakdown; }
+    const std::vector<const PerfWorkload *> &getWorkloads() const { return _workloads; }
+    const std::string &getOutputPath() const { return _outputPath; }
+    const std::string &getBaselinePath() const { return _baselinePath; }
 
 protected:
     // Overrides
@@ -141,6 +267,10 @@ protected:
             {
                 _command = EmuPerfTestCommand::ListConfigs;
             }
+            else if (value.compareIgnoreCase("WORKLOADS") == 0)
+            {
+                _command = EmuPerfTestCommand::ListWorkloads;
+            }
             else
             {
                 isOK = false;
@@ -160,6 +290,32 @@ protected:
             }
             break;
 
+        case Breakdown:
+            _showBreakdown = true;
+            break;
+
+        case Workload:
+            isOK = tryAddWorkloads(value, error);
+            break;
+
+        case RepeatCount:
+            if ((value.tryParseScalar(_repeatCount) == false) || (_repeatCount == 0))
+            {
+                error = String::format(FormatInfo::getDisplay(),
+                                       "Invalid repeat count '{0}' specified.",
+                                       { value });
+                isOK = false;
+            }
+            break;
+
+        case OutputFile:
+            _outputPath.assign(value.getUtf8Bytes());
+            break;
+
+        case BaselineFile:
+            _baselinePath.assign(value.getUtf8Bytes());
+            break;
+
         default:
             isOK = false;
             break;
@@ -212,14 +368,17 @@ protected:
                 _config = Configuration::ArmV2_Test;
             }
 
-            if (_cycleCount == 0)
+            if (_workloads.empty())
+            {
+                for (const PerfWorkload &workload : getPerfWorkloads())
+                {
+                    _workloads.push_back(&workload);
+                }
+            }
+
+            if (_repeatCount == 0)
             {
-                // Set the default count of loops to execute.
-#ifdef _DEBUG
-                _cycleCount = 500000;
-#else
-                _cycleCount = 3000000;
-#endif
+                _repeatCount = DefaultRepeatCount;
             }
         }
     }
@@ -258,18 +417,46 @@ class EmuPerfTestApp : public App
 {
 private:
     // Internal Fields
+    std::vector<const PerfWorkload *> _workloads;
+    std::vector<uint8_t> _memcRom;
+    WorkloadImage _memcHarness;
+    std::string _outputPath;
+    std::string _baselinePath;
     EmuPerfTestCommand _command;
     Configuration _config;
+    uint32_t _memcRomHaltAddress;
     uint32_t _cycleCount;
+    uint32_t _repeatCount;
+    bool _showBreakdown;
 
     // Internal Functions
-    IArmSystemUPtr initialiseEmbeddedTestSystem(Options &systemOptions) const
+    //! @brief Writes a branch instruction into the test bed ROM.
+    static void writeRomBranch(IArmSystem *testSystem, uint32_t romAddr,
+                               uint32_t targetAddr)
+    {
+        Ag::String error;
+        uint32_t instruction = 0;
+        Asm::InstructionInfo branch(Asm::InstructionMnemonic::B,
+                                    Asm::OperationClass::Branch);
+        branch.getBranchParameters().Address = targetAddr;
+
+        if (branch.assemble(instruction, romAddr, error) == false)
+        {
+            throw Ag::OperationException("Could not assemble hardware vector branch.");
+        }
+
+        writeToLogicalAddress(testSystem, romAddr, &instruction, 4, true);
+    }
+
+    IArmSystemUPtr initialiseEmbeddedTestSystem(Configuration config,
+                                                Options &systemOptions,
+                                                const WorkloadImage &workload) const
     {
         IArmSystemUPtr testSystem;
         systemOptions.setSystemRom(SystemROMPreset::Custom);
         systemOptions.setHardwareArchitecture(SystemModel::TestBed);
 
-        switch (_config)
+        switch (config)
         {
         case ArmV2_Test:
             systemOptions.setProcessorVariant(ProcessorModel::ARM2);
@@ -319,28 +506,27 @@ private:
                             TestBedHardware::RomSize / 4,
                             GenerateBreakPoint());
 
-            // Create an instruction which at the hardware reset vector which
-            // branches to the first work in memory.
-            Asm::InstructionInfo resetBranch(Asm::InstructionMnemonic::B,
-                                             Asm::OperationClass::Branch);
-            resetBranch.getBranchParameters().Address = TestBedHardware::RamBase;
-
-            if (resetBranch.assemble(rom.front(), TestBedHardware::RomBase, error) == false)
-            {
-                throw Ag::OperationException("Could not assemble reset vector.");
-            }
-
-            // Fill the ROM with breakpoints and a branch to RAM on reset.
+            // Fill the ROM with breakpoints.
             writeToLogicalAddress(testSystem.get(), TestBedHardware::RomBase,
                                   rom.data(), static_cast<uint32_t>(rom.size() * 4),
                                   true);
 
-            // Copy the assembled code into RAM.
-            size_t byteCount;
-            const void *program = getDhrystoneData(byteCount);
+            // Create an instruction at the hardware reset vector which
+            // branches to the first word in memory and another at the
+            // software interrupt vector if the workload handles them.
+            writeRomBranch(testSystem.get(), TestBedHardware::RomBase,
+                           workload.LoadAddress);
+
+            if (workload.SwiHandlerAddress != 0)
+            {
+                writeRomBranch(testSystem.get(), TestBedHardware::RomBase + 0x08,
+                               workload.SwiHandlerAddress);
+            }
 
-            writeToLogicalAddress(testSystem.get(), TestBedHardware::RamBase,
-                                  program, static_cast<uint32_t>(byteCount));
+            // Copy the assembled code into RAM.
+            writeToLogicalAddress(testSystem.get(), workload.LoadAddress,
+                                  workload.Code.data(),
+                                  static_cast<uint32_t>(workload.Code.size()));
 
             // Setup a full-descending stack in R13 after the reset.
             uint32_t ramEnd = TestBedHardware::RamEnd - 4;
@@ -355,6 +541,127 @@ private:
         return testSystem;
     }
 
+    //! @brief Creates a MEMC-based system, boots it from the MEMC test ROM
+    //! and prepares it to run a workload from logically mapped RAM with IOC
+    //! timer interrupts active.
+    IArmSystemUPtr initialiseMemcSystem(Configuration config,
+                                        Options &systemOptions,
+                                        const WorkloadImage &workload) const
+    {
+        IArmSystemUPtr memcSystem;
+        systemOptions.setSystemRom(SystemROMPreset::Custom);
+        systemOptions.setRamSizeKb(1024);
+
+        switch (config)
+        {
+        case ArmV2_Archimedes:
+            systemOptions.setHardwareArchitecture(SystemModel::Archimedies);
+            systemOptions.setProcessorVariant(ProcessorModel::ARM2);
+            systemOptions.setProcessorSpeedMHz(8);
+            break;
+
+        case ArmV2a_ASeries:
+            systemOptions.setHardwareArchitecture(SystemModel::ASeries);
+            systemOptions.setProcessorVariant(ProcessorModel::ARM3);
+            systemOptions.setProcessorSpeedMHz(25);
+            break;
+
+        default:
+            puts("Error: Emulated system configuration not supported.");
+            return memcSystem;
+        }
+
+        Ag::String error;
+
+        if (systemOptions.validate(error))
+        {
+            ArmSystemBuilder builder(systemOptions);
+            memcSystem = builder.createSystem();
+
+            // Load the test ROM and run it until it halts having initialised
+            // MEMC, IOC, the page mappings and the RAM-based vectors.
+            writeToPhysicalAddress(memcSystem.get(), MemcLowRomBase, _memcRom.data(),
+                                   static_cast<uint32_t>(_memcRom.size()), true);
+            memcSystem->run();
+
+            const uint32_t haltPC = memcSystem->getCoreRegister(CoreRegister::PC);
+
+            if ((haltPC < _memcRomHaltAddress) || (haltPC > _memcRomHaltAddress + 12))
+            {
+                printf("Error: The MEMC test ROM failed to boot, halting at 0x%.8X.\n",
+                       haltPC);
+                memcSystem.reset();
+            }
+            else
+            {
+                // Copy the harness and workload into logically mapped RAM
+                // and enter the harness once the system is run again.
+                writeToLogicalAddress(memcSystem.get(), _memcHarness.LoadAddress,
+                                      _memcHarness.Code.data(),
+                                      static_cast<uint32_t>(_memcHarness.Code.size()));
+                writeToLogicalAddress(memcSystem.get(), workload.LoadAddress,
+                                      workload.Code.data(),
+                                      static_cast<uint32_t>(workload.Code.size()));
+
+                memcSystem->setCoreRegister(CoreRegister::R1, workload.LoadAddress);
+                memcSystem->setCoreRegister(CoreRegister::R2, workload.SwiHandlerAddress);
+                memcSystem->setCoreRegister(CoreRegister::PC, _memcHarness.LoadAddress);
+            }
+        }
+        else
+        {
+            // Option validation failed.
+            printf("Error: %s\n", error.getUtf8Bytes());
+        }
+
+        return memcSystem;
+    }
+
+    //! @brief Determines whether a workload ended by taking an unexpected
+    //! exception and displays the state of the processor if so.
+    static bool checkForCrash(IArmSystem *testSystem, const WorkloadImage &workload)
+    {
+        const uint32_t stopPC = testSystem->getCoreRegister(CoreRegister::PC);
+        const uint32_t endPC = stopPC - 12;
+        const uint32_t workloadEnd = workload.LoadAddress +
+                                     static_cast<uint32_t>(workload.Code.size());
+        bool hasCrashed = false;
+
+        if ((stopPC < workload.LoadAddress) || (endPC >= workloadEnd))
+        {
+            // The workload didn't end on its own break point. On the test bed
+            // the exception vectors hold break points identifying the cause,
+            // on MEMC systems the test ROM handlers stop in ROM.
+            const char *reason = "Stopped outside the workload";
+            hasCrashed = true;
+
+            if (endPC < 0x20)
+            {
+                switch (endPC >> 2)
+                {
+                case 0x00: reason = "Reset"; break;
+                case 0x01: reason = "Unidentified instruction"; break;
+                case 0x02: reason = "Software interrupt"; break;
+                case 0x03: reason = "Pre-fetch abort"; break;
+                case 0x04: reason = "Data abort"; break;
+                case 0x05: reason = "Address exception"; break;
+                case 0x06: reason = "Interrupt request"; break;
+                case 0x07: reason = "Fast interrupt request"; break;
+                }
+            }
+
+            printf("Program crashed: %s\nRegisters:\n", reason);
+            for (uint8_t i = 0; i < 16; i += 2)
+            {
+                printf("\tR%u = 0x%.8X, R%u = 0x%.8X\n",
+                       i, testSystem->getCoreRegister(fromScalar<CoreRegister>(i)),
+                       i + 1, testSystem->getCoreRegister(fromScalar<CoreRegister>(i + 1)));
+            }
+        }
+
+        return hasCrashed;
+    }
+
     void displayConfigs() const
     {
         std::string buffer;
@@ -364,76 +671,282 @@ private:
         puts(buffer.c_str());
     }
 
-    bool runTest() const
+    static void displayWorkloads()
+    {
+        puts("Workloads:");
+
+        for (const PerfWorkload &workload : getPerfWorkloads())
+        {
+            printf("\t%-16s%s%s\n", workload.Name, workload.Description,
+                   workload.RequiresMemc ? " (MEMC only)" : "");
+        }
+    }
+
+    //! @brief Displays the mix of instructions executed by an instrumented
+    //! system.
+    static void displayBreakdown(const ExecutionBreakdown &breakdown)
+    {
+        const double total = static_cast<double>(std::max(breakdown.getInstructionCount(),
+                                                          static_cast<uint64_t>(1)));
+
+        puts("Instruction mix:");
+
+        for (size_t i = 0; i < ExecutionBreakdown::ClassCount; ++i)
+        {
+            const InstructionClass type = static_cast<InstructionClass>(i);
+            const uint64_t count = breakdown.getClassCount(type);
+
+            printf("\t%-24s%14llu %6.2f%%\n", ExecutionBreakdown::getClassName(type),
+                   static_cast<unsigned long long>(count), (count * 100.0) / total);
+        }
+
+        puts("LDM/STM register counts:");
+
+        for (size_t i = 0; i <= ExecutionBreakdown::MaxTransferRegisters; ++i)
+        {
+            if (breakdown.MultiTransferSizes[i] > 0)
+            {
+                printf("\t%2u registers%27llu\n", static_cast<unsigned>(i),
+                       static_cast<unsigned long long>(breakdown.MultiTransferSizes[i]));
+            }
+        }
+
+        printf("Pipeline flushes: %llu\n"
+               "Mode changes: %llu\n"
+               "Memory mapped I/O accesses: %llu\n",
+               static_cast<unsigned long long>(breakdown.PipelineFlushes),
+               static_cast<unsigned long long>(breakdown.ModeChanges),
+               static_cast<unsigned long long>(breakdown.MmioAccesses));
+    }
+
+    //! @brief Runs a workload repeatedly on a specified configuration.
+    //! @param[in] config The configuration of the system to run it on.
+    //! @param[in] workload The workload to run.
+    //! @param[out] result Receives the measurements of each run.
+    //! @retval true The workload ran successfully every time.
+    //! @retval false The workload couldn't be prepared or crashed.
+    bool runWorkload(Configuration config, const PerfWorkload &workload,
+                     WorkloadResult &result) const
     {
-        Options testSystemOptions;
-        IArmSystemUPtr testSystem = initialiseEmbeddedTestSystem(testSystemOptions);
+        const bool isMemc = isMemcConfiguration(config);
+        WorkloadImage image;
+        std::string error;
 
-        if (!testSystem)
+        if (tryAssembleWorkload(workload, isMemc ? MemcWorkloadAddress : TestBedHardware::RamBase,
+                                image, error) == false)
+        {
+            puts(error.c_str());
             return false;
+        }
+
+        const bool isDhrystone = (workload.Source == nullptr);
+        const uint32_t iterations = (isDhrystone && (_cycleCount > 0)) ? _cycleCount :
+                                                                         getDefaultIterations(workload);
+
+        result.Configuration.assign(getConfigMetadata().toString(config));
+        result.Workload.assign(workload.Name);
+        result.Iterations = iterations;
+
+        ExecutionMetrics lastMetrics;
+
+        for (uint32_t run = 0; run < _repeatCount; ++run)
+        {
+            Options testSystemOptions;
+            testSystemOptions.setInstrumentation(_showBreakdown);
+
+            IArmSystemUPtr testSystem = isMemc ? initialiseMemcSystem(config, testSystemOptions, image) :
+                                                 initialiseEmbeddedTestSystem(config, testSystemOptions, image);
 
-        // Pass the look count to the program.
-        testSystem->setCoreRegister(CoreRegister::R0, _cycleCount);
+            if (!testSystem)
+                return false;
 
-        std::string output;
-        appendFormat(FormatInfo::getDisplay(),
-                     "Selected {0} processor.\n"
-                     "Running {1} loops of the Dhrystone 2.1 benchmark...", output,
-                     { getProcessorModelType().toDisplayName(testSystemOptions.getProcessorVariant()),
-                       _cycleCount });
+            // Pass the loop count to the program.
+            testSystem->setCoreRegister(CoreRegister::R0, iterations);
 
-        puts(output.c_str());
-        ExecutionMetrics metrics = testSystem->run();
+            lastMetrics = testSystem->run();
 
-        uint32_t endPC = testSystem->getCoreRegister(CoreRegister::PC) - 12;
+            if (checkForCrash(testSystem.get(), image))
+                return false;
 
-        if (endPC < 0x20)
+            result.Instructions = lastMetrics.InstructionCount;
+            result.Cycles = lastMetrics.CycleCount;
+            result.MipsSamples.push_back(lastMetrics.calculateSpeedInMIPS());
+            result.SecondsSamples.push_back(HighResMonotonicTimer::getTimeSpan(lastMetrics.ElapsedTime));
+        }
+
+        const SampleStatistics mips = SampleStatistics::calculate(result.MipsSamples);
+        const SampleStatistics seconds = SampleStatistics::calculate(result.SecondsSamples);
+
+        printf("%-16s%-18s%14llu%10.3f s%10.2f MIPS +/- %.2f%10.2f MHz",
+               workload.Name, result.Configuration.c_str(),
+               static_cast<unsigned long long>(result.Instructions),
+               seconds.Mean, mips.Mean, mips.StdDev,
+               lastMetrics.calculateClockFrequency() / 1.0e6);
+
+        if (isDhrystone && (seconds.Mean > 0.0))
+        {
+            printf(" (~%.0f Dhrystones per second)", std::floor(iterations / seconds.Mean));
+        }
+
+        putchar('\n');
+
+        if (_showBreakdown)
         {
-            const char *reason = "Unknown";
+            displayBreakdown(lastMetrics.Breakdown);
+        }
+
+        return true;
+    }
+
+    //! @brief Compares the results of the suite with a baseline.
+    //! @return True if any workload has significantly regressed.
+    bool compareWithBaseline(const SuiteResults &results) const
+    {
+        std::ifstream input(_baselinePath, std::ios::in | std::ios::binary);
+        SuiteResults baseline;
+        std::string error;
+        bool hasRegressed = false;
 
-            switch (endPC >> 2)
+        if (!input)
+        {
+            throw Ag::OperationException("Could not open the baseline file.");
+        }
+
+        if (baseline.tryRead(input, error) == false)
+        {
+            throw Ag::OperationException(error.c_str());
+        }
+
+        const HostInfo &baseHost = baseline.getHost();
+        printf("\nComparison with baseline measured %s on %s (%s build):\n",
+               baseHost.Timestamp.c_str(), baseHost.Processor.c_str(),
+               baseHost.BuildType.c_str());
+
+        if ((baseHost.Processor != results.getHost().Processor) ||
+            (baseHost.BuildType != results.getHost().BuildType))
+        {
+            puts("Warning: The baseline was measured on a different host or build type.");
+        }
+
+        for (const ResultComparison &comparison : results.compare(baseline))
+        {
+            const char *verdict = "";
+
+            if (comparison.IsRegression)
+            {
+                verdict = "REGRESSION";
+                hasRegressed = true;
+            }
+            else if (comparison.IsImprovement)
             {
-            case 0x00: reason = "Reset"; break;
-            case 0x01: reason = "Unidentified instruction"; break;
-            case 0x02: reason = "Software interrupt"; break;
-            case 0x03: reason = "Pre-fetch abort"; break;
-            case 0x04: reason = "Data abort"; break;
-            case 0x05: reason = "Address exception"; break;
-            case 0x06: reason = "Interrupt request"; break;
-            case 0x07: reason = "Fast interrupt request"; break;
+                verdict = "improvement";
             }
 
-            printf("Program crashed: %s\nRegisters:\n", reason);
-            for (uint8_t i = 0; i < 16; i += 2)
+            printf("%-16s%10.2f ->%10.2f MIPS %+7.2f%% (p = %.4f) %s\n",
+                   comparison.Workload.c_str(), comparison.Baseline.Mean,
+                   comparison.Current.Mean, comparison.RelativeChange * 100.0,
+                   comparison.PValue, verdict);
+        }
+
+        return hasRegressed;
+    }
+
+    //! @brief Runs the selected workloads and reports the results.
+    //! @return The process exit code.
+    int runSuite()
+    {
+        SuiteResults results;
+        results.setHost(HostInfo::query());
+
+        const bool isMemc = isMemcConfiguration(_config);
+        const std::string_view configName = getConfigMetadata().toString(_config);
+        printf("Selected %.*s configuration, running each workload %u times...\n",
+               static_cast<int>(configName.length()), configName.data(), _repeatCount);
+
+        if (isMemc)
+        {
+            // Prepare the code used to boot the system and start each workload.
+            std::string error;
+
+            if ((tryPrepareMemcBootRom(_memcRom, _memcRomHaltAddress, error) == false) ||
+                (tryAssembleMemcHarness(_memcHarness, error) == false))
             {
-                printf("\tR%u = 0x%.8X, R%u = 0x%.8X\n",
-                       i, testSystem->getCoreRegister(fromScalar<CoreRegister>(i)),
-                       i + 1, testSystem->getCoreRegister(fromScalar<CoreRegister>(i + 1)));
+                puts(error.c_str());
+                return 1;
             }
         }
 
-        double durationInSeconds = HighResMonotonicTimer::getTimeSpan(metrics.ElapsedTime);
-        double clockSpeedHz = metrics.calculateClockFrequency();
+        for (const PerfWorkload *workload : _workloads)
+        {
+            if (workload->RequiresMemc && (isMemc == false))
+            {
+                printf("%-16sskipped, requires MEMC hardware.\n", workload->Name);
+                continue;
+            }
 
-        output.clear();
-        appendFormat(FormatInfo::getDisplay(),
-                     "Executed {0} CPU cycles in {1:F2} seconds (~{2:F0} Dhrystone's per second).\n"
-                     "Simulated clock speed: {3:F2} MHz\n"
-                     "Simulated performance: {4:F2} MIPS\n", output,
-                     { metrics.CycleCount, durationInSeconds,
-                       std::floor(_cycleCount / durationInSeconds),
-                       clockSpeedHz / 1.0e6,
-                       metrics.calculateSpeedInMIPS() });
+            WorkloadResult baseResult;
 
-        puts(output.c_str());
-        return true;
+            if (isMemc && (workload->RequiresMemc == false))
+            {
+                // Measure the same workload on the equivalent test bed so
+                // that the cost of the MEMC hardware can be reported.
+                if (runWorkload(getTestBedEquivalent(_config), *workload, baseResult) == false)
+                    return 1;
+
+                results.addResult(baseResult);
+            }
+
+            WorkloadResult result;
+
+            if (runWorkload(_config, *workload, result) == false)
+                return 1;
+
+            results.addResult(result);
+
+            if (baseResult.MipsSamples.empty() == false)
+            {
+                const double baseMips = SampleStatistics::calculate(baseResult.MipsSamples).Mean;
+                const double memcMips = SampleStatistics::calculate(result.MipsSamples).Mean;
+
+                if (memcMips > 0.0)
+                {
+                    printf("%-16s%.2fx slower than %s\n", "", baseMips / memcMips,
+                           baseResult.Configuration.c_str());
+                }
+            }
+        }
+
+        int exitCode = 0;
+
+        if (_outputPath.empty() == false)
+        {
+            std::ofstream jsonOutput(_outputPath, std::ios::out | std::ios::trunc);
+            results.write(jsonOutput);
+
+            if (!jsonOutput)
+            {
+                printf("Error: Failed to write results to '%s'.\n", _outputPath.c_str());
+                exitCode = 1;
+            }
+        }
+
+        if ((exitCode == 0) && (_baselinePath.empty() == false) &&
+            compareWithBaseline(results))
+        {
+            exitCode = RegressionExitCode;
+        }
+
+        return exitCode;
     }
 public:
     // Construction/Destruction
     EmuPerfTestApp() :
         _command(EmuPerfTestCommand::Auto),
         _config(Configuration::None),
-        _cycleCount(100)
+        _memcRomHaltAddress(0),
+        _cycleCount(0),
+        _repeatCount(DefaultRepeatCount),
+        _showBreakdown(false)
     {
     }
 
@@ -462,6 +975,11 @@ protected:
                 // Extract the options we need.
                 _config = testArgs->getConfiguration();
                 _cycleCount = testArgs->getCycleCount();
+                _repeatCount = testArgs->getRepeatCount();
+                _showBreakdown = testArgs->isBreakdownRequired();
+                _workloads = testArgs->getWorkloads();
+                _outputPath = testArgs->getOutputPath();
+                _baselinePath = testArgs->getBaselinePath();
             }
             else if (_command == EmuPerfTestCommand::Auto)
             {
@@ -489,8 +1007,12 @@ protected:
             displayConfigs();
             break;
 
+        case EmuPerfTestCommand::ListWorkloads:
+            displayWorkloads();
+            break;
+
         case EmuPerfTestCommand::RunTest:
-            processResult = runTest() ? 0 : 1;
+            processResult = runSuite();
             break;
 
         default:
@@ -0,0 +1,189 @@
+//! @file ArmEmu/ExecutionCounters.cpp
+//! @brief The definition of an object which counts how many times each
+//! instruction in the guest address space has been executed.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "ArmEmu/ExecutionCounters.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionCounterTable Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty table with counting initially disabled.
+ExecutionCounterTable::ExecutionCounterTable() :
+    _pageCount(0),
+    _isEnabled(false)
+{
+}
+
+//! @brief Determines whether instructions are being counted.
+bool ExecutionCounterTable::isEnabled() const
+{
+    return _isEnabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Starts or stops the counting of executed instructions.
+//! @param[in] isEnabled True to count instructions, false to stop.
+//! @note This member function can be called from any thread.
+void ExecutionCounterTable::setEnabled(bool isEnabled)
+{
+    _isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+//! @brief Determines if no instructions have been counted.
+bool ExecutionCounterTable::isEmpty() const
+{
+    return _pageCount == 0;
+}
+
+//! @brief Gets the count of pages of counters allocated.
+size_t ExecutionCounterTable::getPageCount() const
+{
+    return _pageCount;
+}
+
+//! @brief Gets the counts accumulated for a specific address.
+//! @param[in] address The logical address of the instruction to query.
+//! @param[out] count Receives the counts for the instruction.
+//! @retval true The instruction has been executed at least once.
+//! @retval false The instruction has never been executed while counting.
+bool ExecutionCounterTable::tryGetCount(uint32_t address, ExecutionCount &count) const
+{
+    const uint32_t pageIndex = address >> PageShift;
+    bool hasCount = false;
+
+    if ((pageIndex < _pages.size()) && _pages[pageIndex])
+    {
+        count = _pages[pageIndex]->Counts[(address >> 2) & (WordsPerPage - 1)];
+        hasCount = (count.Executions > 0);
+    }
+
+    return hasCount;
+}
+
+//! @brief Gets the highest execution count of any instruction, which can be
+//! used to scale a heat map.
+uint64_t ExecutionCounterTable::getMaxExecutions() const
+{
+    uint64_t maxExecutions = 0;
+
+    for (const PageUPtr &page : _pages)
+    {
+        if (page)
+        {
+            for (const ExecutionCount &count : page->Counts)
+            {
+                maxExecutions = std::max(maxExecutions, count.Executions);
+            }
+        }
+    }
+
+    return maxExecutions;
+}
+
+//! @brief Disposes of all counts, but leaves counting enabled or disabled.
+void ExecutionCounterTable::clear()
+{
+    _pages.clear();
+    _pageCount = 0;
+}
+
+//! @brief Finds the blocks of code which consumed the most processor cycles.
+//! @param[in] maxCount The maximum count of blocks to return.
+//! @return A collection of runs of consecutive instructions with the same
+//! non-zero execution count, ordered by descending cycle count.
+std::vector<HotBlock> ExecutionCounterTable::findHottestBlocks(size_t maxCount) const
+{
+    std::vector<HotBlock> blocks;
+    HotBlock current = { 0, 0, 0, 0 };
+
+    for (uint32_t pageIndex = 0; pageIndex < _pages.size(); ++pageIndex)
+    {
+        const Page *page = _pages[pageIndex].get();
+
+        if (page == nullptr)
+            continue;
+
+        const uint32_t pageBase = pageIndex << PageShift;
+
+        for (uint32_t wordIndex = 0; wordIndex < WordsPerPage; ++wordIndex)
+        {
+            const ExecutionCount &count = page->Counts[wordIndex];
+            const uint32_t address = pageBase + (wordIndex * 4);
+
+            if ((current.Executions > 0) &&
+                ((count.Executions != current.Executions) ||
+                 (address != current.EndAddr)))
+            {
+                // The run of instructions has come to an end.
+                blocks.push_back(current);
+                current.Executions = 0;
+            }
+
+            if (count.Executions > 0)
+            {
+                if (current.Executions == 0)
+                {
+                    // Start a new block.
+                    current.StartAddr = address;
+                    current.Executions = count.Executions;
+                    current.Cycles = 0;
+                }
+
+                current.EndAddr = address + 4;
+                current.Cycles += count.Cycles;
+            }
+        }
+    }
+
+    if (current.Executions > 0)
+    {
+        blocks.push_back(current);
+    }
+
+    // Rank the blocks by the time spent in them.
+    const size_t resultCount = std::min(maxCount, blocks.size());
+
+    std::partial_sort(blocks.begin(), blocks.begin() + resultCount, blocks.end(),
+                      [](const HotBlock &lhs, const HotBlock &rhs) {
+                          return (lhs.Cycles > rhs.Cycles) ||
+                                 ((lhs.Cycles == rhs.Cycles) &&
+                                  (lhs.StartAddr < rhs.StartAddr));
+                      });
+
+    blocks.resize(resultCount);
+
+    return blocks;
+}
+
+//! @brief Allocates a zeroed page of counters for the first instruction
+//! executed within its address range.
+//! @param[in] pageIndex The index of the page to allocate.
+//! @return A pointer to the new page.
+ExecutionCounterTable::Page *ExecutionCounterTable::allocatePage(uint32_t pageIndex)
+{
+    if (pageIndex >= _pages.size())
+    {
+        _pages.resize(static_cast<size_t>(pageIndex) + 1);
+    }
+
+    _pages[pageIndex] = std::make_unique<Page>();
+    ++_pageCount;
+
+    return _pages[pageIndex].get();
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -11,11 +11,107 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
 #include "ArmEmu/ExecutionMetrics.hpp"
 
 namespace Mo {
 namespace Arm {
 
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionBreakdown Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates an empty breakdown of execution.
+ExecutionBreakdown::ExecutionBreakdown()
+{
+    reset();
+}
+
+//! @brief Determines whether no instructions or events have been counted.
+bool ExecutionBreakdown::isEmpty() const
+{
+    return (getInstructionCount() == 0) && (PipelineFlushes == 0) &&
+           (ModeChanges == 0) && (MmioAccesses == 0);
+}
+
+//! @brief Gets the count of instructions executed in a specific class.
+//! @param[in] instructionClass The class of instruction to query.
+uint64_t ExecutionBreakdown::getClassCount(InstructionClass instructionClass) const
+{
+    const size_t index = static_cast<size_t>(instructionClass);
+
+    return (index < ClassCount) ? ClassCounts[index] : 0;
+}
+
+//! @brief Gets the total count of instructions counted in all classes,
+//! including those whose condition failed.
+uint64_t ExecutionBreakdown::getInstructionCount() const
+{
+    return std::accumulate(std::begin(ClassCounts), std::end(ClassCounts),
+                           static_cast<uint64_t>(0));
+}
+
+//! @brief Gets a short display name for a class of instruction.
+//! @param[in] instructionClass The class of instruction to name.
+const char *ExecutionBreakdown::getClassName(InstructionClass instructionClass)
+{
+    static const char *names[] = {
+        "ALU immediate",
+        "ALU register",
+        "ALU shift by register",
+        "Multiply",
+        "LDR/STR",
+        "SWP",
+        "LDM/STM",
+        "Branch",
+        "SWI",
+        "Co-processor",
+        "Other",
+        "Condition failed",
+    };
+
+    static_assert(std::size(names) == ClassCount,
+                  "Instruction class names don't match InstructionClass.");
+
+    const size_t index = static_cast<size_t>(instructionClass);
+
+    return (index < ClassCount) ? names[index] : "Unknown";
+}
+
+//! @brief Resets all counts back to zero.
+void ExecutionBreakdown::reset()
+{
+    std::fill(std::begin(ClassCounts), std::end(ClassCounts), 0);
+    std::fill(std::begin(MultiTransferSizes), std::end(MultiTransferSizes), 0);
+    PipelineFlushes = 0;
+    ModeChanges = 0;
+    MmioAccesses = 0;
+}
+
+//! @brief Adds the counts of another breakdown to the current object.
+//! @param[in] rhs The breakdown to add to the current one.
+//! @return A reference to the current object.
+ExecutionBreakdown &ExecutionBreakdown::operator+=(const ExecutionBreakdown &rhs)
+{
+    for (size_t i = 0; i < ClassCount; ++i)
+    {
+        ClassCounts[i] += rhs.ClassCounts[i];
+    }
+
+    for (size_t i = 0; i <= MaxTransferRegisters; ++i)
+    {
+        MultiTransferSizes[i] += rhs.MultiTransferSizes[i];
+    }
+
+    PipelineFlushes += rhs.PipelineFlushes;
+    ModeChanges += rhs.ModeChanges;
+    MmioAccesses += rhs.MmioAccesses;
+
+    return *this;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ExecutionMetrics Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +120,7 @@ ExecutionMetrics::ExecutionMetrics() :
     CycleCount(0),
     InstructionCount(0),
     ElapsedTime(0),
+    HostIdleTimeNs(0),
     ExecResult(Result::Unset)
 {
 }
@@ -64,12 +161,32 @@ double ExecutionMetrics::calculateSpeedInMIPS() const
     return mips;
 }
 
+//! @brief Calculates the proportion of the elapsed time for which the
+//! emulation thread was occupying a host processor core.
+//! @return A value from 0.0 (entirely idle) to 1.0 (running flat out).
+double ExecutionMetrics::calculateHostUtilisation() const
+{
+    double utilisation = 0.0;
+
+    if (ElapsedTime > 0)
+    {
+        double timeSpan = Ag::HighResMonotonicTimer::getTimeSpan(ElapsedTime);
+        double idleSpan = HostIdleTimeNs * 1e-9;
+
+        utilisation = std::clamp((timeSpan - idleSpan) / timeSpan, 0.0, 1.0);
+    }
+
+    return utilisation;
+}
+
 //! @brief Resets all metric properties back to zero.
 void ExecutionMetrics::reset()
 {
     CycleCount = 0;
     InstructionCount = 0;
     ElapsedTime = 0;
+    HostIdleTimeNs = 0;
+    Breakdown.reset();
 }
 
 //! @brief Calculates the sum of the current and another set of metrics.
@@ -81,6 +198,8 @@ ExecutionMetrics ExecutionMetrics::operator+(const ExecutionMetrics &rhs) const
     result.CycleCount += CycleCount;
     result.InstructionCount += InstructionCount;
     result.ElapsedTime += ElapsedTime;
+    result.HostIdleTimeNs += HostIdleTimeNs;
+    result.Breakdown += Breakdown;
 
     return result;
 }
@@ -93,6 +212,8 @@ ExecutionMetrics &ExecutionMetrics::operator+=(const ExecutionMetrics &rhs)
     CycleCount += rhs.CycleCount;
     InstructionCount += rhs.InstructionCount;
     ElapsedTime += rhs.ElapsedTime;
+    HostIdleTimeNs += rhs.HostIdleTimeNs;
+    Breakdown += rhs.Breakdown;
 
     return *this;
 }
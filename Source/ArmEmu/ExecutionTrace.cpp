@@ -0,0 +1,517 @@
+//! @file ArmEmu/ExecutionTrace.cpp
+//! @brief The definition of objects which capture, store and decode a
+//! compact trace of the instructions executed by an emulated processor.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include "Ag/Core/Binary.hpp"
+#include "ArmEmu/ExecutionTrace.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The count of words the writer drains from the ring in one go.
+constexpr size_t WriterChunkSize = 1 << 16;
+
+//! @brief The time the writer sleeps for when the ring is empty.
+constexpr std::chrono::milliseconds WriterIdleTime(2);
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates the count of words in a record from its header.
+//! @param[in] header The second word of the record.
+size_t getRecordLength(uint32_t header)
+{
+    size_t length = 2 + Ag::Bin::popCount(header & TraceFormat::ChangedRegsMask);
+
+    if (header & TraceFormat::ExplicitAddress)
+    {
+        ++length;
+    }
+
+    if (header & TraceFormat::PsrFollows)
+    {
+        ++length;
+    }
+
+    return length;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// TraceFilter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a filter which accepts all records.
+TraceFilter::TraceFilter() :
+    MinAddress(0),
+    MaxAddress(~0u),
+    ModeMask(0)
+{
+}
+
+//! @brief Adds a processor mode to those in which records are accepted.
+//! @param[in] mode The mode to accept.
+void TraceFilter::addMode(ProcessorMode mode)
+{
+    ModeMask |= 1u << (static_cast<uint32_t>(mode) & TraceFormat::ModeMask);
+}
+
+//! @brief Determines whether a record should be reported.
+//! @param[in] record The decoded record to test.
+bool TraceFilter::matches(const TraceRecord &record) const
+{
+    const uint32_t modeBit = 1u << (static_cast<uint32_t>(record.Mode) &
+                                    TraceFormat::ModeMask);
+
+    return (record.Address >= MinAddress) && (record.Address <= MaxAddress) &&
+           ((ModeMask == 0) || (ModeMask & modeBit));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionTraceRing Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty ring buffer.
+//! @param[in] capacity The minimum count of words the buffer can hold, it
+//! will be rounded up to a power of 2.
+ExecutionTraceRing::ExecutionTraceRing(size_t capacity) :
+    _mask(0),
+    _head(0),
+    _tail(0)
+{
+    size_t actualCapacity = 64;
+
+    while (actualCapacity < capacity)
+    {
+        actualCapacity <<= 1;
+    }
+
+    _words = std::make_unique<uint32_t[]>(actualCapacity);
+    _mask = actualCapacity - 1;
+}
+
+//! @brief Gets the count of words the buffer can hold.
+size_t ExecutionTraceRing::getCapacity() const
+{
+    return _mask + 1;
+}
+
+//! @brief Gets the count of words written but not yet read.
+size_t ExecutionTraceRing::getAvailable() const
+{
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+}
+
+//! @brief Attempts to write a block of words to the buffer.
+//! @param[in] words The words to write.
+//! @param[in] count The count of words to write.
+//! @retval true The words were written and published to the reader.
+//! @retval false There was insufficient space, nothing was written.
+//! @note This member function should only be called on the producer thread.
+bool ExecutionTraceRing::tryWrite(const uint32_t *words, size_t count)
+{
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t tail = _tail.load(std::memory_order_acquire);
+    bool isWritten = false;
+
+    if ((getCapacity() - (head - tail)) >= count)
+    {
+        const size_t start = head & _mask;
+        const size_t firstPart = std::min(count, getCapacity() - start);
+
+        std::memcpy(_words.get() + start, words, firstPart * sizeof(uint32_t));
+        std::memcpy(_words.get(), words + firstPart,
+                    (count - firstPart) * sizeof(uint32_t));
+
+        _head.store(head + count, std::memory_order_release);
+        isWritten = true;
+    }
+
+    return isWritten;
+}
+
+//! @brief Reads words written to the buffer.
+//! @param[out] buffer The buffer to receive the words.
+//! @param[in] maxCount The maximum count of words to read.
+//! @return The count of words read, which may end part way through a record.
+//! @note This member function should only be called on the consumer thread.
+size_t ExecutionTraceRing::read(uint32_t *buffer, size_t maxCount)
+{
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_acquire);
+    const size_t count = std::min(head - tail, maxCount);
+
+    if (count > 0)
+    {
+        const size_t start = tail & _mask;
+        const size_t firstPart = std::min(count, getCapacity() - start);
+
+        std::memcpy(buffer, _words.get() + start, firstPart * sizeof(uint32_t));
+        std::memcpy(buffer + firstPart, _words.get(),
+                    (count - firstPart) * sizeof(uint32_t));
+
+        _tail.store(tail + count, std::memory_order_release);
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionTrace Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object to transfer a trace with tracing disabled.
+//! @param[in] capacity The minimum count of words to buffer.
+ExecutionTrace::ExecutionTrace(size_t capacity) :
+    _ring(capacity),
+    _recordCount(0),
+    _droppedCount(0),
+    _isEnabled(false),
+    _isKeyFrameRequested(false)
+{
+}
+
+//! @brief Determines whether instructions are being recorded.
+bool ExecutionTrace::isEnabled() const
+{
+    return _isEnabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Starts or stops recording instructions.
+//! @param[in] isEnabled True to record instructions as they are executed.
+//! @note The first record written after tracing is enabled is a key frame.
+void ExecutionTrace::setEnabled(bool isEnabled)
+{
+    _isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+//! @brief Gets the count of records written to the ring.
+uint64_t ExecutionTrace::getRecordCount() const
+{
+    return _recordCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Gets the count of records discarded because the ring was full.
+uint64_t ExecutionTrace::getDroppedCount() const
+{
+    return _droppedCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Gets the ring buffer from which the consumer reads records.
+ExecutionTraceRing &ExecutionTrace::getRing()
+{
+    return _ring;
+}
+
+//! @brief Requests that the next record written is a key frame.
+//! @note This member function can be called from any thread.
+void ExecutionTrace::requestKeyFrame()
+{
+    _isKeyFrameRequested.store(true, std::memory_order_relaxed);
+}
+
+//! @brief Attempts to append an encoded record to the trace.
+//! @param[in] words The words of the record.
+//! @param[in] count The count of words in the record.
+//! @retval true The record was written.
+//! @retval false The ring was full and the record was dropped.
+bool ExecutionTrace::tryAppend(const uint32_t *words, size_t count)
+{
+    const bool isWritten = _ring.tryWrite(words, count);
+
+    // Only the producer thread updates the counts, so there is no need
+    // for an atomic read-modify-write.
+    std::atomic_uint64_t &counter = isWritten ? _recordCount : _droppedCount;
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+
+    return isWritten;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionTraceWriter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an idle writer.
+ExecutionTraceWriter::ExecutionTraceWriter() :
+    _trace(nullptr),
+    _isStopping(false)
+{
+}
+
+//! @brief Ensures the background thread is stopped and the file is closed.
+ExecutionTraceWriter::~ExecutionTraceWriter()
+{
+    stop();
+}
+
+//! @brief Determines if the writer is draining a trace to a file.
+bool ExecutionTraceWriter::isRunning() const
+{
+    return _thread.joinable();
+}
+
+//! @brief Creates a trace file and starts draining a trace to it.
+//! @param[in] trace The trace to drain, which must outlive the writer or
+//! the next call to stop().
+//! @param[in] fileName The path to the trace file to create.
+//! @param[out] error Receives a description of why the file couldn't be
+//! created.
+//! @retval true The file was created and the background thread started.
+//! @retval false The writer was already running or the file couldn't be
+//! created.
+bool ExecutionTraceWriter::tryStart(ExecutionTrace &trace,
+                                    const std::string &fileName,
+                                    std::string &error)
+{
+    bool isStarted = false;
+
+    if (isRunning())
+    {
+        error = "A trace is already being written.";
+    }
+    else
+    {
+        _output.open(fileName, std::ios::binary | std::ios::trunc);
+
+        if (_output.is_open())
+        {
+            writeFileHeader(_output);
+
+            // Ensure the file can be decoded from its first record.
+            trace.requestKeyFrame();
+
+            _trace = &trace;
+            _buffer.resize(WriterChunkSize);
+            _isStopping.store(false);
+            _thread = std::thread(&ExecutionTraceWriter::run, this);
+            isStarted = true;
+        }
+        else
+        {
+            error = "Failed to create trace file '" + fileName + "'.";
+        }
+    }
+
+    return isStarted;
+}
+
+//! @brief Stops the background thread after writing any words remaining in
+//! the trace and closes the file.
+void ExecutionTraceWriter::stop()
+{
+    if (_thread.joinable())
+    {
+        _isStopping.store(true);
+        _thread.join();
+
+        drain();
+        _output.close();
+        _trace = nullptr;
+    }
+}
+
+//! @brief Writes the signature and version which start a trace file.
+//! @param[in] output The binary stream to write to.
+//! @note Trace files are written in host byte order.
+void ExecutionTraceWriter::writeFileHeader(std::ostream &output)
+{
+    const uint32_t header[] = { TraceFormat::FileSignature,
+                                TraceFormat::FileVersion };
+
+    output.write(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+//! @brief The entry point of the background thread.
+void ExecutionTraceWriter::run()
+{
+    while (_isStopping.load() == false)
+    {
+        if (_trace->getRing().getAvailable() > 0)
+        {
+            drain();
+        }
+        else
+        {
+            std::this_thread::sleep_for(WriterIdleTime);
+        }
+    }
+}
+
+//! @brief Writes all words currently in the ring to the file.
+void ExecutionTraceWriter::drain()
+{
+    ExecutionTraceRing &ring = _trace->getRing();
+    size_t count;
+
+    while ((count = ring.read(_buffer.data(), _buffer.size())) > 0)
+    {
+        _output.write(reinterpret_cast<const char *>(_buffer.data()),
+                      static_cast<std::streamsize>(count * sizeof(uint32_t)));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ExecutionTraceDecoder Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a decoder with no words to decode.
+ExecutionTraceDecoder::ExecutionTraceDecoder()
+{
+    reset();
+}
+
+//! @brief Gets the count of records decoded so far.
+uint64_t ExecutionTraceDecoder::getDecodedCount() const
+{
+    return _decodedCount;
+}
+
+//! @brief Gets the count of records skipped while waiting for a key frame.
+uint64_t ExecutionTraceDecoder::getSkippedCount() const
+{
+    return _skippedCount;
+}
+
+//! @brief Discards all pending words and processor state.
+void ExecutionTraceDecoder::reset()
+{
+    _pending.clear();
+    _position = 0;
+    _decodedCount = 0;
+    _skippedCount = 0;
+    std::memset(&_state, 0, sizeof(_state));
+    _isSynchronised = false;
+}
+
+//! @brief Appends words to those to decode.
+//! @param[in] words The words read from a ring or trace file.
+//! @param[in] count The count of words.
+void ExecutionTraceDecoder::append(const uint32_t *words, size_t count)
+{
+    // Discard words already decoded before the buffer grows.
+    if (_position > 0)
+    {
+        _pending.erase(_pending.begin(),
+                       _pending.begin() + static_cast<ptrdiff_t>(_position));
+        _position = 0;
+    }
+
+    _pending.insert(_pending.end(), words, words + count);
+}
+
+//! @brief Attempts to decode the next complete record.
+//! @param[out] record Receives the state of the processor after the
+//! instruction executed.
+//! @retval true A record was decoded.
+//! @retval false More words are needed to complete the next record.
+bool ExecutionTraceDecoder::tryDecodeNext(TraceRecord &record)
+{
+    bool isDecoded = false;
+
+    while ((isDecoded == false) && ((_pending.size() - _position) >= 2))
+    {
+        const uint32_t *words = _pending.data() + _position;
+        const uint32_t header = words[1];
+        const size_t length = getRecordLength(header);
+
+        if ((_pending.size() - _position) < length)
+        {
+            // Wait for the rest of the record.
+            break;
+        }
+
+        _position += length;
+
+        if ((_isSynchronised == false) &&
+            ((header & TraceFormat::KeyFrame) == 0))
+        {
+            // The state of the processor is unknown until a key frame.
+            ++_skippedCount;
+            continue;
+        }
+
+        _isSynchronised = true;
+
+        const uint32_t *next = words + 2;
+        _state.Instruction = words[0];
+        _state.Address = (header & TraceFormat::ExplicitAddress) ? *next++ :
+                                                                   _state.Address + 4;
+
+        if (header & TraceFormat::PsrFollows)
+        {
+            _state.PSR = *next++;
+        }
+
+        _state.ChangedRegs = static_cast<uint16_t>(header & TraceFormat::ChangedRegsMask);
+
+        for (uint32_t regIndex = 0; regIndex < 15; ++regIndex)
+        {
+            if (_state.ChangedRegs & (1u << regIndex))
+            {
+                _state.Regs[regIndex] = *next++;
+            }
+        }
+
+        _state.Cycles = static_cast<uint8_t>((header >> TraceFormat::CycleCountShift) &
+                                             TraceFormat::CycleCountMask);
+        _state.Mode = static_cast<ProcessorMode>((header >> TraceFormat::ModeShift) &
+                                                 TraceFormat::ModeMask);
+
+        record = _state;
+        ++_decodedCount;
+        isDecoded = true;
+    }
+
+    return isDecoded;
+}
+
+//! @brief Reads and verifies the signature and version of a trace file.
+//! @param[in] input The binary stream to read from.
+//! @param[out] error Receives a description of why the file isn't valid.
+//! @retval true The file is a trace file which can be decoded.
+//! @retval false The file isn't a trace file or its version is unsupported.
+bool ExecutionTraceDecoder::tryReadFileHeader(std::istream &input,
+                                              std::string &error)
+{
+    uint32_t header[2] = { 0, 0 };
+    bool isValid = false;
+
+    if (!input.read(reinterpret_cast<char *>(header), sizeof(header)))
+    {
+        error = "The file is too short to be an execution trace.";
+    }
+    else if (header[0] != TraceFormat::FileSignature)
+    {
+        error = "The file is not an execution trace.";
+    }
+    else if (header[1] != TraceFormat::FileVersion)
+    {
+        error = "The execution trace format version is not supported.";
+    }
+    else
+    {
+        isValid = true;
+    }
+
+    return isValid;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,193 @@
+//! @file ArmEmu/ExecutionTracer.inl
+//! @brief The declaration of components which an execution unit uses to
+//! write a trace of the instructions it executes, or not.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_EXECUTION_TRACER_INL__
+#define __ARM_EMU_EXECUTION_TRACER_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <iterator>
+
+#include "ArmEmu/ExecutionTrace.hpp"
+
+#include "ArmCore.hpp"
+#include "RegisterFile.inl"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Takes the place of ExecutionTracer in execution units which can't
+//! be traced, so the system has no trace ring to expose.
+class NullExecutionTracer
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit not to capture register state before
+    //! and after each instruction.
+    static constexpr bool IsEnabled = false;
+
+    // Accessors
+    //! @brief Gets the trace, always nullptr.
+    ExecutionTrace *getTrace() { return nullptr; }
+};
+
+//! @brief An object which encodes a record of each instruction executed
+//! while tracing is enabled and appends it to a trace ring.
+//! @details Each record only holds the state which changed since the
+//! previous record. The state is held here so that the register file
+//! doesn't need to track changes itself.
+class ExecutionTracer
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit to pass register state to
+    //! beforeInstruction() and afterInstruction() around each instruction.
+    static constexpr bool IsEnabled = true;
+
+    // Construction/Destruction
+    //! @brief Constructs a tracer with tracing initially disabled.
+    ExecutionTracer() :
+        _execAddr(0),
+        _nextAddr(0),
+        _instruction(0),
+        _psr(0),
+        _mode(0),
+        _needsKeyFrame(true),
+        _isTracing(false)
+    {
+        std::fill(std::begin(_regs), std::end(_regs), 0u);
+    }
+
+    // Accessors
+    //! @brief Gets the trace the records are written to.
+    ExecutionTrace *getTrace() { return &_trace; }
+
+    // Operations
+    //! @brief Captures the address, instruction word and mode of the
+    //! instruction about to be executed.
+    //! @tparam THardware The data type of the memory map modelled on
+    //! GenericHardware.
+    //! @tparam TRegisterFile The data type of the register file modelled on
+    //! GenericCoreRegisterFile.
+    //! @param[in] hw The memory map to read the instruction word from.
+    //! @param[in] regs The register file containing the PC.
+    //! @param[in] isFlushPending True if the PC points to the next
+    //! instruction to execute rather than the next to fetch.
+    template<typename THardware, typename TRegisterFile>
+    void beforeInstruction(THardware &hw, const TRegisterFile &regs,
+                           bool isFlushPending)
+    {
+        constexpr uint32_t AddrMask = TRegisterFile::HasCombinedPcPsr ?
+                                      ~PsrMask26::PrivilageBits : ~3u;
+
+        const bool wasTracing = _isTracing;
+        _isTracing = _trace.isEnabled();
+
+        if (_isTracing)
+        {
+            // Start with a key frame as the state recorded may be stale.
+            _needsKeyFrame = _needsKeyFrame || (wasTracing == false) ||
+                             _trace.tryTakeKeyFrameRequest();
+
+            // The PC is normally 8 bytes beyond the next instruction to execute.
+            const uint32_t pc = regs.getPC() & AddrMask;
+            _execAddr = isFlushPending ? pc : pc - 8;
+            _mode = static_cast<uint32_t>(regs.getMode()) & TraceFormat::ModeMask;
+
+            // Read the word again rather than expose the pipeline. A failed
+            // read will abort when executed, so the word doesn't matter.
+            if (hw.read(_execAddr, _instruction) == false)
+            {
+                _instruction = 0;
+            }
+        }
+    }
+
+    //! @brief Encodes the instruction captured by beforeInstruction() along
+    //! with the state it changed.
+    //! @tparam TRegisterFile The data type of the register file modelled on
+    //! GenericCoreRegisterFile.
+    //! @param[in] regs The register file after the instruction executed.
+    //! @param[in] cycleCount The count of cycles the instruction took.
+    template<typename TRegisterFile>
+    void afterInstruction(const TRegisterFile &regs, uint32_t cycleCount)
+    {
+        if (_isTracing)
+        {
+            uint32_t record[TraceFormat::MaxRecordWords];
+            uint32_t header = (std::min(cycleCount, TraceFormat::CycleCountMask) <<
+                               TraceFormat::CycleCountShift) |
+                              (_mode << TraceFormat::ModeShift);
+            size_t length = 2;
+
+            record[0] = _instruction;
+
+            if (_needsKeyFrame || (_execAddr != _nextAddr))
+            {
+                header |= TraceFormat::ExplicitAddress;
+                record[length++] = _execAddr;
+            }
+
+            const uint32_t psr = regs.getPSR();
+
+            if (_needsKeyFrame || (psr != _psr))
+            {
+                header |= TraceFormat::PsrFollows;
+                record[length++] = psr;
+                _psr = psr;
+            }
+
+            for (uint32_t regIndex = 0; regIndex < 15; ++regIndex)
+            {
+                const uint32_t value = regs.getRn(static_cast<GeneralRegister>(regIndex));
+
+                if (_needsKeyFrame || (value != _regs[regIndex]))
+                {
+                    header |= 1u << regIndex;
+                    record[length++] = value;
+                    _regs[regIndex] = value;
+                }
+            }
+
+            if (_needsKeyFrame)
+            {
+                header |= TraceFormat::KeyFrame;
+            }
+
+            record[1] = header;
+            _nextAddr = _execAddr + 4;
+
+            // If the record was dropped the reader can't follow the deltas, so
+            // re-synchronise it with a key frame.
+            _needsKeyFrame = (_trace.tryAppend(record, length) == false);
+        }
+    }
+private:
+    // Internal Fields
+    ExecutionTrace _trace;
+    uint32_t _regs[15];
+    uint32_t _execAddr;
+    uint32_t _nextAddr;
+    uint32_t _instruction;
+    uint32_t _psr;
+    uint32_t _mode;
+    bool _needsKeyFrame;
+    bool _isTracing;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
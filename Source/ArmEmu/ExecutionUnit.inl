@@ -15,6 +15,10 @@
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
 #include "ArmCore.hpp"
+#include "CoverageRecorder.inl"
+#include "ExecutionTracer.inl"
+#include "InstructionCounter.inl"
+#include "ProfileSampler.inl"
 
 namespace Mo {
 namespace Arm {
@@ -31,7 +35,23 @@ namespace Arm {
 //! @tparam TPrimaryPipeline The pipeline which executes instructions for the
 //! single operating mode the execution units supports modelled on
 //! InstructionPipeline.
-template<typename THardware, typename TRegisterFile, typename TPrimaryPipeline>
+//! @tparam TProfileSampler The data type of the object which samples the
+//! guest call stack, either ProfileSampler or NullProfileSampler, which
+//! removes all profiling code from the execution loop.
+//! @tparam TInstructionCounter The data type of the object which counts
+//! instructions executed at each address, either InstructionCounter or
+//! NullInstructionCounter, which removes all counting code.
+//! @tparam TCoverageRecorder The data type of the object which records the
+//! addresses of instructions executed, either CoverageRecorder or
+//! NullCoverageRecorder, which removes all recording code.
+//! @tparam TExecutionTracer The data type of the object which writes a trace
+//! of the instructions executed, either ExecutionTracer or
+//! NullExecutionTracer, which removes all tracing code.
+template<typename THardware, typename TRegisterFile, typename TPrimaryPipeline,
+         typename TProfileSampler = NullProfileSampler,
+         typename TInstructionCounter = NullInstructionCounter,
+         typename TCoverageRecorder = NullCoverageRecorder,
+         typename TExecutionTracer = NullExecutionTracer>
 class SingleModeExecutionUnit
 {
 public:
@@ -39,6 +59,10 @@ public:
     using PrimaryPipeline = TPrimaryPipeline;
     using Hardware = THardware;
     using RegisterFile = TRegisterFile;
+    using Sampler = TProfileSampler;
+    using Counter = TInstructionCounter;
+    using Coverage = TCoverageRecorder;
+    using Tracer = TExecutionTracer;
 
 private:
     // Internal Fields
@@ -46,6 +70,13 @@ private:
     RegisterFile &_regs;
     SystemContext &_context;
     PrimaryPipeline _pipeline;
+    Sampler _sampler;
+    Counter _counter;
+    Coverage _coverage;
+    Tracer _tracer;
+    uint64_t _instructionCount;
+    uint64_t _irqCount;
+    uint64_t _fastIrqCount;
 
 public:
     // Construction/Destruction
@@ -63,7 +94,10 @@ public:
         _hardware(hw),
         _regs(regs),
         _context(context),
-        _pipeline(_hardware, _regs)
+        _pipeline(_hardware, _regs),
+        _instructionCount(0),
+        _irqCount(0),
+        _fastIrqCount(0)
     {
     }
 
@@ -77,6 +111,29 @@ public:
     //! 8 bytes beyond the next instruction to execute.
     bool isFlushPending() const { return _pipeline.isFlushPending(); }
 
+    //! @brief Gets the total count of instructions executed.
+    //! @note A reference is returned so that the count can be monitored by
+    //! the CounterCoProcessor.
+    const uint64_t &getInstructionCount() const { return _instructionCount; }
+
+    //! @brief Gets the total count of normal interrupts taken.
+    uint64_t getIrqCount() const { return _irqCount; }
+
+    //! @brief Gets the total count of fast interrupts taken.
+    uint64_t getFastIrqCount() const { return _fastIrqCount; }
+
+    //! @brief Gets the object which samples the guest call stack.
+    Sampler &getSampler() { return _sampler; }
+
+    //! @brief Gets the object which counts instructions at each address.
+    Counter &getCounter() { return _counter; }
+
+    //! @brief Gets the object which records the instructions executed.
+    Coverage &getCoverage() { return _coverage; }
+
+    //! @brief Gets the object which writes a trace of instructions executed.
+    Tracer &getTracer() { return _tracer; }
+
     // Operations
     //! @brief Flushes the pre-fetch instruction queue after a direct write to
     //! the PC.
@@ -91,6 +148,17 @@ public:
     {
         ExecutionMetrics metrics;
         uint64_t startTicks = _context.getCPUClockTicks();
+        uint64_t startIdleTime = _context.getHostIdleTimeNs();
+        uint64_t startInstructions = _instructionCount;
+        uint64_t startMmioAccesses = 0;
+
+        if constexpr (Hardware::CountsMmio)
+        {
+            startMmioAccesses = _hardware.getMmioAccessCount();
+        }
+
+        // Ensure time spent stopped isn't seen as time to catch up on.
+        _context.resynchronisePacing();
 
         // Ensure the pipeline only runs once in single-step mode.
         bool runPipeline = true;
@@ -103,9 +171,16 @@ public:
 
         _pipeline.flushPipeline();
 
-        // Clear any external interrupts before running.
+        // Clear any debug interrupt left by the last run. A host interrupt
+        // is only cleared when acknowledged below, so that one raised by
+        // another thread just before the run starts isn't lost. Single steps
+        // are synchronous, so they ignore any stale host interrupt.
         _hardware.setDebugIrq(false);
-        _hardware.setHostIrq(false);
+
+        if (singleStep)
+        {
+            _hardware.setHostIrq(false);
+        }
 
         // Capture the start time.
         Ag::MonotonicTicks startTime = Ag::HighResMonotonicTimer::getTime();
@@ -124,29 +199,82 @@ public:
                     // Exit the pipeline without processing anything.
                     runPipeline = false;
 
-                    metrics.ExecResult =
-                        (pendingIrqs & IrqState::DebugPending) ? ExecutionMetrics::Result::DebugIrq :
-                                                                 ExecutionMetrics::Result::HostIrq;
-                }
-                else if (pendingIrqs & IrqState::FastIrqPending)
-                {
-                    // A fast interrupt has been signalled.
-                    result = _regs.handleFirq();
+                    if (pendingIrqs & IrqState::DebugPending)
+                    {
+                        metrics.ExecResult = ExecutionMetrics::Result::DebugIrq;
+                    }
+                    else
+                    {
+                        // Acknowledge the host interrupt.
+                        metrics.ExecResult = ExecutionMetrics::Result::HostIrq;
+                        _hardware.setHostIrq(false);
+                    }
                 }
-                else // if (pendingIrqs & IS_IrqPending)
+                else
                 {
-                    // A normal interrupt has been signalled.
-                    result = _regs.handleIrq();
+                    if (pendingIrqs & IrqState::FastIrqPending)
+                    {
+                        // A fast interrupt has been signalled.
+                        result = _regs.handleFirq();
+                        ++_fastIrqCount;
+                    }
+                    else // if (pendingIrqs & IS_IrqPending)
+                    {
+                        // A normal interrupt has been signalled.
+                        result = _regs.handleIrq();
+                        ++_irqCount;
+                    }
+
+                    // Only account for the result of entering the handler,
+                    // a host exit leaves the last instruction's result behind.
+                    if constexpr (PrimaryPipeline::Instrumentation::IsEnabled)
+                    {
+                        _pipeline.getInstrumentation().onResult(result);
+                    }
                 }
             }
             else // if (pendingIrqs == 0)
             {
+                if constexpr (Counter::IsEnabled)
+                {
+                    _counter.beforeInstruction(_regs, _pipeline.isFlushPending());
+                }
+
+                if constexpr (Coverage::IsEnabled)
+                {
+                    _coverage.beforeInstruction(_regs, _pipeline.isFlushPending());
+                }
+
+                if constexpr (Tracer::IsEnabled)
+                {
+                    _tracer.beforeInstruction(_hardware, _regs,
+                                              _pipeline.isFlushPending());
+                }
+
                 // Decode and execute the next instruction.
                 result = _pipeline.executeNext();
 
-                // Update metrics.
-                ++metrics.InstructionCount;
+                // Update metrics, the running total is sampled by the
+                // system while the pipeline runs.
+                ++_instructionCount;
                 _context.incrementCPUClock(result & ExecResult::CycleCountMask);
+
+                if constexpr (Counter::IsEnabled)
+                {
+                    _counter.afterInstruction(result & ExecResult::CycleCountMask);
+                }
+
+                if constexpr (Tracer::IsEnabled)
+                {
+                    _tracer.afterInstruction(_regs, result & ExecResult::CycleCountMask);
+                }
+
+                if constexpr (Sampler::IsEnabled)
+                {
+                    _sampler.onCyclesElapsed(result & ExecResult::CycleCountMask,
+                                             _hardware, _regs,
+                                             _pipeline.isFlushPending());
+                }
             } // if (pendingIrqs == 0)
 
             // TODO if (result & ExecResult::ModeChange) in a multi-pipeline
@@ -156,6 +284,19 @@ public:
         // Capture the end time and therefore the duration of the run.
         metrics.ElapsedTime = Ag::HighResMonotonicTimer::getDuration(startTime);
         metrics.CycleCount = _context.getCPUClockTicks() - startTicks;
+        metrics.InstructionCount = _instructionCount - startInstructions;
+        metrics.HostIdleTimeNs = _context.getHostIdleTimeNs() - startIdleTime;
+
+        if constexpr (PrimaryPipeline::Instrumentation::IsEnabled)
+        {
+            _pipeline.getInstrumentation().harvest(metrics.Breakdown);
+        }
+
+        if constexpr (Hardware::CountsMmio)
+        {
+            metrics.Breakdown.MmioAccesses = _hardware.getMmioAccessCount() -
+                                             startMmioAccesses;
+        }
 
         // Ensure the PC reflects the next instruction to EXECUTE, not the
         // next one to FETCH.
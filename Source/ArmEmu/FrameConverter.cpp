@@ -0,0 +1,493 @@
+//! @file ArmEmu/FrameConverter.cpp
+//! @brief The definition of an object which converts palettised VIDC video
+//! memory into host pixels.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define FRAME_CONVERTER_USE_X64
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+// MSVC allows any intrinsic to be used in any function.
+#define FRAME_CONVERTER_TARGET_AVX2
+#else
+#define FRAME_CONVERTER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#include "ArmEmu/FrameConverter.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The offsets of the expanded table for each pixel size within
+//! FrameConverter::_tables, indexed by bits per pixel as a power of 2.
+//! @details Each table has 256 rows holding the host pixels a byte of video
+//! memory expands to.
+constexpr size_t TableOffsets[] = { 0, 256 * 8, 256 * (8 + 4), 256 * (8 + 4 + 2) };
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Converts pixels one at a time using a palette lookup.
+//! @tparam TBitsPerPixelPow2 The count of bits per pixel as a power of 2.
+//! @param[in] palette The host colours of each possible pixel value.
+//! @param[in] source The packed pixels, left-most in the least significant
+//! bits of each byte.
+//! @param[out] target Receives the host pixels.
+//! @param[in] pixelCount The count of pixels to convert.
+template<uint8_t TBitsPerPixelPow2>
+void convertReference(const uint32_t *palette, const uint8_t *source,
+                      uint32_t *target, uint32_t pixelCount)
+{
+    constexpr uint32_t BitsPerPixel = 1u << TBitsPerPixelPow2;
+    constexpr uint32_t PixelsPerBytePow2 = 3 - TBitsPerPixelPow2;
+    constexpr uint32_t PixelMask = (1u << BitsPerPixel) - 1;
+
+    for (uint32_t i = 0; i < pixelCount; ++i)
+    {
+        uint32_t shift = (i & ((1u << PixelsPerBytePow2) - 1)) * BitsPerPixel;
+        uint32_t pixel = (source[i >> PixelsPerBytePow2] >> shift) & PixelMask;
+
+        target[i] = palette[pixel];
+    }
+}
+
+//! @brief The scalar reference implementation of whole bytes of video
+//! memory.
+template<uint8_t TBitsPerPixelPow2>
+void convertScalar(const uint32_t *palette, const uint8_t *source,
+                   uint32_t *target, uint32_t byteCount)
+{
+    convertReference<TBitsPerPixelPow2>(palette, source, target,
+                                        byteCount << (3 - TBitsPerPixelPow2));
+}
+
+#ifdef FRAME_CONVERTER_USE_X64
+//! @brief Converts 1 bpp video memory, 8 pixels per byte, 2 x 128-bits.
+void convertSSE2_1bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    for (uint32_t i = 0; i < byteCount; ++i, target += 8)
+    {
+        const __m128i *row = reinterpret_cast<const __m128i *>(table + (source[i] * 8));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_loadu_si128(row));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target + 4), _mm_loadu_si128(row + 1));
+    }
+}
+
+//! @brief Converts 2 bpp video memory, 4 pixels per byte, 128-bits.
+void convertSSE2_2bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    for (uint32_t i = 0; i < byteCount; ++i, target += 4)
+    {
+        const __m128i *row = reinterpret_cast<const __m128i *>(table + (source[i] * 4));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target), _mm_loadu_si128(row));
+    }
+}
+
+//! @brief Converts 4 bpp video memory, 2 pixels per byte, combining
+//! 2 bytes into 128-bits.
+void convertSSE2_4bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    uint32_t i = 0;
+
+    for (; (i + 2) <= byteCount; i += 2, target += 4)
+    {
+        __m128i low = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(table + (source[i] * 2)));
+        __m128i high = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(table + (source[i + 1] * 2)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target),
+                         _mm_unpacklo_epi64(low, high));
+    }
+
+    if (i < byteCount)
+    {
+        target[0] = table[source[i] * 2];
+        target[1] = table[(source[i] * 2) + 1];
+    }
+}
+
+//! @brief Converts 8 bpp video memory, 1 pixel per byte, combining 4 bytes
+//! into 128-bits.
+void convertSSE2_8bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    uint32_t i = 0;
+
+    for (; (i + 4) <= byteCount; i += 4, target += 4)
+    {
+        __m128i pixels = _mm_setr_epi32(static_cast<int>(table[source[i]]),
+                                        static_cast<int>(table[source[i + 1]]),
+                                        static_cast<int>(table[source[i + 2]]),
+                                        static_cast<int>(table[source[i + 3]]));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target), pixels);
+    }
+
+    convertScalar<3>(table, source + i, target, byteCount - i);
+}
+
+//! @brief Converts 1 bpp video memory, 8 pixels per byte, 256-bits.
+FRAME_CONVERTER_TARGET_AVX2
+void convertAVX2_1bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    for (uint32_t i = 0; i < byteCount; ++i, target += 8)
+    {
+        const __m256i *row = reinterpret_cast<const __m256i *>(table + (source[i] * 8));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), _mm256_loadu_si256(row));
+    }
+}
+
+//! @brief Converts 2 bpp video memory, 4 pixels per byte, combining 2 bytes
+//! into 256-bits.
+FRAME_CONVERTER_TARGET_AVX2
+void convertAVX2_2bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    uint32_t i = 0;
+
+    for (; (i + 2) <= byteCount; i += 2, target += 8)
+    {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table + (source[i] * 4)));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table + (source[i + 1] * 4)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target),
+                            _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1));
+    }
+
+    if (i < byteCount)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i *>(table + (source[i] * 4))));
+    }
+}
+
+//! @brief Converts 4 bpp video memory, 2 pixels per byte, gathering pixel
+//! pairs for 4 bytes into 256-bits.
+FRAME_CONVERTER_TARGET_AVX2
+void convertAVX2_4bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    const long long *pairs = reinterpret_cast<const long long *>(table);
+    uint32_t i = 0;
+
+    for (; (i + 4) <= byteCount; i += 4, target += 8)
+    {
+        int packed;
+        std::copy_n(source + i, sizeof(packed), reinterpret_cast<uint8_t *>(&packed));
+
+        __m128i indices = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+        __m256i pixels = _mm256_i32gather_epi64(pairs, indices, 8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), pixels);
+    }
+
+    for (; i < byteCount; ++i, target += 2)
+    {
+        target[0] = table[source[i] * 2];
+        target[1] = table[(source[i] * 2) + 1];
+    }
+}
+
+//! @brief Converts 8 bpp video memory, 1 pixel per byte, gathering 8 pixels
+//! into 256-bits.
+FRAME_CONVERTER_TARGET_AVX2
+void convertAVX2_8bpp(const uint32_t *table, const uint8_t *source,
+                      uint32_t *target, uint32_t byteCount)
+{
+    const int *colours = reinterpret_cast<const int *>(table);
+    uint32_t i = 0;
+
+    for (; (i + 8) <= byteCount; i += 8, target += 8)
+    {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i));
+        __m256i pixels = _mm256_i32gather_epi32(colours, _mm256_cvtepu8_epi32(packed), 4);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), pixels);
+    }
+
+    convertScalar<3>(table, source + i, target, byteCount - i);
+}
+
+//! @brief Determines whether the host processor and operating system
+//! support AVX2 instructions.
+bool isAVX2Supported()
+{
+#ifdef _MSC_VER
+    int regs[4];
+    bool isSupported = false;
+
+    __cpuid(regs, 0);
+
+    if (regs[0] >= 7)
+    {
+        __cpuid(regs, 1);
+
+        // Check for AVX and OS support for saving YMM registers.
+        constexpr int OSXSaveAndAVX = (1 << 27) | (1 << 28);
+
+        if (((regs[2] & OSXSaveAndAVX) == OSXSaveAndAVX) &&
+            ((_xgetbv(0) & 6) == 6))
+        {
+            __cpuidex(regs, 7, 0);
+            isSupported = (regs[1] & (1 << 5)) != 0;
+        }
+    }
+
+    return isSupported;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// FrameConverter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a converter using the best instructions supported by
+//! the host with an all-black palette.
+FrameConverter::FrameConverter() :
+    FrameConverter(getSupportedSimdLevel())
+{
+}
+
+//! @brief Constructs a converter with an all-black palette.
+//! @param[in] level The vector instructions to convert with, limited to
+//! the best supported by the host.
+FrameConverter::FrameConverter(SimdLevel level) :
+    _hostBorder(0),
+    _level(std::min(level, getSupportedSimdLevel()))
+{
+    // Select the reference implementation by default.
+    _kernels[0] = convertScalar<0>;
+    _kernels[1] = convertScalar<1>;
+    _kernels[2] = convertScalar<2>;
+    _kernels[3] = convertScalar<3>;
+
+    // The reference implementation looks up pixels in the logical palette,
+    // except in 8 bpp modes, where all 256 colours must be pre-calculated.
+    _kernelTables[0] = _hostPalette;
+    _kernelTables[1] = _hostPalette;
+    _kernelTables[2] = _hostPalette;
+    _kernelTables[3] = _tables + TableOffsets[3];
+
+#ifdef FRAME_CONVERTER_USE_X64
+    if (_level >= SimdLevel::SSE2)
+    {
+        for (uint8_t mode = 0; mode < ModeCount; ++mode)
+        {
+            _kernelTables[mode] = _tables + TableOffsets[mode];
+        }
+
+        if (_level == SimdLevel::AVX2)
+        {
+            _kernels[0] = convertAVX2_1bpp;
+            _kernels[1] = convertAVX2_2bpp;
+            _kernels[2] = convertAVX2_4bpp;
+            _kernels[3] = convertAVX2_8bpp;
+        }
+        else
+        {
+            _kernels[0] = convertSSE2_1bpp;
+            _kernels[1] = convertSSE2_2bpp;
+            _kernels[2] = convertSSE2_4bpp;
+            _kernels[3] = convertSSE2_8bpp;
+        }
+    }
+#endif
+
+    rebuildTables();
+}
+
+//! @brief Gets the vector instructions used to convert pixels.
+SimdLevel FrameConverter::getSimdLevel() const
+{
+    return _level;
+}
+
+//! @brief Gets the best set of vector instructions supported by the host.
+SimdLevel FrameConverter::getSupportedSimdLevel()
+{
+#ifdef FRAME_CONVERTER_USE_X64
+    // SSE2 is part of the x64 baseline.
+    static const SimdLevel supportedLevel = isAVX2Supported() ? SimdLevel::AVX2 :
+                                                                SimdLevel::SSE2;
+#else
+    static const SimdLevel supportedLevel = SimdLevel::Scalar;
+#endif
+
+    return supportedLevel;
+}
+
+//! @brief Gets the display name of a set of vector instructions.
+const char *FrameConverter::getSimdLevelName(SimdLevel level)
+{
+    static const char *names[] = { "Scalar", "SSE2", "AVX2" };
+
+    return (level < SimdLevel::Max) ? names[static_cast<size_t>(level)] : "Unknown";
+}
+
+//! @brief Gets the palette pixels are currently converted with.
+const VidcPalette &FrameConverter::getPalette() const
+{
+    return _palette;
+}
+
+//! @brief Sets the palette pixels are converted with.
+//! @param[in] palette The colours programmed into the VIDC.
+//! @retval true The colours changed and the conversion tables were rebuilt,
+//! previously converted pixels are out of date.
+//! @retval false The palette was already in use.
+bool FrameConverter::setPalette(const VidcPalette &palette)
+{
+    bool isChanged = false;
+
+    if (palette != _palette)
+    {
+        _palette = palette;
+        rebuildTables();
+        isChanged = true;
+    }
+
+    return isChanged;
+}
+
+//! @brief Converts packed pixels into host pixels.
+//! @param[in] source The packed pixels, left-most in the least significant
+//! bits of each byte.
+//! @param[out] target Receives pixelCount host pixels.
+//! @param[in] pixelCount The count of pixels to convert.
+//! @param[in] bitsPerPixelPow2 The size of each packed pixel as a power of 2,
+//! 0 to 3 for 1, 2, 4 or 8 bits.
+void FrameConverter::convertPixels(const uint8_t *source, uint32_t *target,
+                                   uint32_t pixelCount,
+                                   uint8_t bitsPerPixelPow2) const
+{
+    const uint8_t mode = bitsPerPixelPow2 & 3;
+    const uint32_t pixelsPerBytePow2 = 3u - mode;
+    const uint32_t byteCount = pixelCount >> pixelsPerBytePow2;
+
+    _kernels[mode](_kernelTables[mode], source, target, byteCount);
+
+    // Convert any pixels which don't fill a whole byte.
+    const uint32_t remainder = pixelCount - (byteCount << pixelsPerBytePow2);
+
+    if (remainder > 0)
+    {
+        source += byteCount;
+        target += byteCount << pixelsPerBytePow2;
+
+        switch (mode)
+        {
+        case 0: convertReference<0>(_hostPalette, source, target, remainder); break;
+        case 1: convertReference<1>(_hostPalette, source, target, remainder); break;
+        case 2: convertReference<2>(_hostPalette, source, target, remainder); break;
+        }
+    }
+}
+
+//! @brief Renders a raster line including the border and cursor.
+//! @param[in] timing The display geometry to render, which must be valid.
+//! @param[in] source The video memory of the display area of the line or
+//! nullptr if the line is entirely border.
+//! @param[in] cursor The VidcTiming::CursorBytesPerLine bytes of 2 bpp cursor
+//! image for the line or nullptr if the cursor doesn't appear on the line.
+//! @param[out] target Receives VidcTiming::getFrameWidth() host pixels.
+void FrameConverter::renderLine(const VidcTiming &timing, const uint8_t *source,
+                                const uint8_t *cursor, uint32_t *target) const
+{
+    const uint32_t frameWidth = timing.getFrameWidth();
+
+    if (source == nullptr)
+    {
+        std::fill_n(target, frameWidth, _hostBorder);
+    }
+    else
+    {
+        const uint32_t displayLeft = timing.HorzDisplayStart - timing.HorzBorderStart;
+        const uint32_t displayRight = displayLeft + timing.getDisplayWidth();
+
+        std::fill_n(target, displayLeft, _hostBorder);
+        convertPixels(source, target + displayLeft, timing.getDisplayWidth(),
+                      timing.BitsPerPixelPow2);
+        std::fill(target + displayRight, target + frameWidth, _hostBorder);
+    }
+
+    if (cursor != nullptr)
+    {
+        const int32_t cursorLeft = static_cast<int32_t>(timing.HorzCursorStart) -
+                                   static_cast<int32_t>(timing.HorzBorderStart);
+
+        for (int32_t i = 0; i < VidcTiming::CursorWidth; ++i)
+        {
+            const int32_t x = cursorLeft + i;
+            const uint8_t pixel = (cursor[i >> 2] >> ((i & 3) * 2)) & 3;
+
+            // Cursor pixel value 0 is transparent.
+            if ((pixel != 0) && (x >= 0) && (x < static_cast<int32_t>(frameWidth)))
+            {
+                target[x] = _hostCursor[pixel - 1];
+            }
+        }
+    }
+}
+
+//! @brief Calculates host colours and the expanded conversion tables from
+//! the current palette.
+void FrameConverter::rebuildTables()
+{
+    for (uint8_t i = 0; i < VidcPalette::ColourCount; ++i)
+    {
+        _hostPalette[i] = VidcPalette::toHostColour(_palette.Colours[i]);
+    }
+
+    for (uint8_t i = 0; i < VidcPalette::CursorColourCount; ++i)
+    {
+        _hostCursor[i] = VidcPalette::toHostColour(_palette.Cursor[i]);
+    }
+
+    _hostBorder = VidcPalette::toHostColour(_palette.Border);
+
+    uint32_t *table1bpp = _tables + TableOffsets[0];
+    uint32_t *table2bpp = _tables + TableOffsets[1];
+    uint32_t *table4bpp = _tables + TableOffsets[2];
+    uint32_t *table8bpp = _tables + TableOffsets[3];
+
+    for (uint32_t value = 0; value < 256; ++value)
+    {
+        const uint8_t byte = static_cast<uint8_t>(value);
+
+        convertReference<0>(_hostPalette, &byte, table1bpp + (value * 8), 8);
+        convertReference<1>(_hostPalette, &byte, table2bpp + (value * 4), 4);
+        convertReference<2>(_hostPalette, &byte, table4bpp + (value * 2), 2);
+        table8bpp[value] = VidcPalette::toHostColour(_palette.getColour256(byte));
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,244 @@
+//! @file ArmEmu/GuestCoverage.cpp
+//! @brief The definition of objects which record which guest instructions
+//! have been executed and report the coverage against guest source code.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <iterator>
+
+#include "Ag/Core/Binary.hpp"
+#include "ArmEmu/GuestCoverage.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// GuestCoverageMap Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a map in which no instructions have been executed.
+GuestCoverageMap::GuestCoverageMap() :
+    _pageCount(0)
+{
+}
+
+//! @brief Determines if no instructions have been recorded.
+bool GuestCoverageMap::isEmpty() const
+{
+    return _pageCount == 0;
+}
+
+//! @brief Gets the count of pages of bits allocated.
+size_t GuestCoverageMap::getPageCount() const
+{
+    return _pageCount;
+}
+
+//! @brief Determines if the instruction at a specific address was executed.
+//! @param[in] address The logical address of the instruction to query.
+bool GuestCoverageMap::isCovered(uint32_t address) const
+{
+    const uint32_t pageIndex = address >> PageShift;
+    bool isSet = false;
+
+    if ((pageIndex < _pages.size()) && _pages[pageIndex])
+    {
+        const uint32_t wordIndex = (address >> 2) & (WordsPerPage - 1);
+
+        isSet = (_pages[pageIndex]->Bits[wordIndex >> 6] >> (wordIndex & 63)) & 1;
+    }
+
+    return isSet;
+}
+
+//! @brief Determines if any instruction within a range of addresses was
+//! executed.
+//! @param[in] address The logical address of the first instruction.
+//! @param[in] size The count of bytes in the range.
+bool GuestCoverageMap::isRangeCovered(uint32_t address, uint32_t size) const
+{
+    bool isSet = false;
+
+    for (uint32_t offset = 0; (isSet == false) && (offset < size); offset += 4)
+    {
+        isSet = isCovered(address + offset);
+    }
+
+    return isSet;
+}
+
+//! @brief Gets the count of distinct instruction words which were executed.
+size_t GuestCoverageMap::getCoveredWordCount() const
+{
+    size_t count = 0;
+
+    for (const PageUPtr &page : _pages)
+    {
+        if (page)
+        {
+            for (uint64_t bits : page->Bits)
+            {
+                count += Ag::Bin::popCount(static_cast<uint32_t>(bits));
+                count += Ag::Bin::popCount(static_cast<uint32_t>(bits >> 32));
+            }
+        }
+    }
+
+    return count;
+}
+
+//! @brief Disposes of all recorded coverage.
+void GuestCoverageMap::clear()
+{
+    _pages.clear();
+    _pageCount = 0;
+}
+
+//! @brief Adds the coverage recorded in another map to the current one,
+//! for example to combine the results of several test runs.
+//! @param[in] rhs The map to merge.
+void GuestCoverageMap::merge(const GuestCoverageMap &rhs)
+{
+    for (uint32_t pageIndex = 0; pageIndex < rhs._pages.size(); ++pageIndex)
+    {
+        const Page *source = rhs._pages[pageIndex].get();
+
+        if (source == nullptr)
+            continue;
+
+        Page *target = (pageIndex < _pages.size()) ? _pages[pageIndex].get() :
+                                                     nullptr;
+
+        if (target == nullptr)
+        {
+            target = allocatePage(pageIndex);
+        }
+
+        for (size_t i = 0; i < std::size(target->Bits); ++i)
+        {
+            target->Bits[i] |= source->Bits[i];
+        }
+    }
+}
+
+//! @brief Allocates a zeroed page of bits for the first instruction executed
+//! within its address range.
+//! @param[in] pageIndex The index of the page to allocate.
+//! @return A pointer to the new page.
+GuestCoverageMap::Page *GuestCoverageMap::allocatePage(uint32_t pageIndex)
+{
+    if (pageIndex >= _pages.size())
+    {
+        _pages.resize(static_cast<size_t>(pageIndex) + 1);
+    }
+
+    _pages[pageIndex] = std::make_unique<Page>();
+    ++_pageCount;
+
+    return _pages[pageIndex].get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GuestLineTable Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Determines if the table maps no source lines.
+bool GuestLineTable::isEmpty() const
+{
+    return _lines.empty();
+}
+
+//! @brief Gets the count of address ranges mapped to source lines.
+size_t GuestLineTable::getCount() const
+{
+    return _lines.size();
+}
+
+//! @brief Removes all source line mappings.
+void GuestLineTable::clear()
+{
+    _lines.clear();
+    _fileNames.clear();
+    _fileIndexByName.clear();
+}
+
+//! @brief Maps a range of instructions to the source line which produced it.
+//! @param[in] address The logical address of the first instruction.
+//! @param[in] size The count of bytes of instructions.
+//! @param[in] fileName The name of the source file.
+//! @param[in] lineNo The 1-based index of the line within the file.
+//! @details Asm::ObjectCode::getLineTable() provides the mappings for
+//! assembled code.
+void GuestLineTable::addLine(uint32_t address, uint32_t size,
+                             std::string_view fileName, int lineNo)
+{
+    auto pos = _fileIndexByName.find(fileName);
+
+    if (pos == _fileIndexByName.end())
+    {
+        const uint32_t fileIndex = static_cast<uint32_t>(_fileNames.size());
+
+        _fileNames.emplace_back(fileName);
+        pos = _fileIndexByName.emplace(_fileNames.back(), fileIndex).first;
+    }
+
+    _lines.push_back({ address, size, pos->second, lineNo });
+}
+
+//! @brief Writes the coverage of each mapped source line as an lcov
+//! tracefile, as read by genhtml and most CI coverage services.
+//! @param[in] output The stream to write the tracefile to.
+//! @param[in] coverage The instructions which were executed.
+//! @param[in] testName The name of the test which was run, can be empty.
+//! @details A line is hit if any instruction it produced was executed. The
+//! map only records whether an instruction executed, so hit lines have a
+//! count of 1.
+void GuestLineTable::writeLcovTrace(std::ostream &output,
+                                    const GuestCoverageMap &coverage,
+                                    std::string_view testName) const
+{
+    // Gather the lines of each file in line order, a line may appear more
+    // than once if it produced non-contiguous code.
+    std::vector<std::map<int, bool>> hitsByFile(_fileNames.size());
+
+    for (const Line &line : _lines)
+    {
+        bool &isHit = hitsByFile[line.FileIndex][line.LineNo];
+
+        isHit = isHit || coverage.isRangeCovered(line.Address, line.Size);
+    }
+
+    output << "TN:" << testName << '\n';
+
+    for (size_t fileIndex = 0; fileIndex < _fileNames.size(); ++fileIndex)
+    {
+        const auto &hits = hitsByFile[fileIndex];
+        size_t hitCount = 0;
+
+        output << "SF:" << _fileNames[fileIndex] << '\n';
+
+        for (const auto &lineHit : hits)
+        {
+            output << "DA:" << lineHit.first << ','
+                   << (lineHit.second ? 1 : 0) << '\n';
+
+            if (lineHit.second)
+            {
+                ++hitCount;
+            }
+        }
+
+        output << "LF:" << hits.size() << '\n'
+               << "LH:" << hitCount << '\n'
+               << "end_of_record\n";
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -50,13 +50,29 @@ GuestEvent::GuestEvent(uintptr_t sourceID, int32_t type,
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// GuestEventQueue::CoalescedEvent Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an unused coalesced event slot.
+GuestEventQueue::CoalescedEvent::CoalescedEvent() :
+    Sequence(0),
+    Data1(0),
+    Data2(0),
+    IsQueued(false),
+    Type(0)
+{
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // GuestEventQueue Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief Constructs an empty inter-thread event queue.
 GuestEventQueue::GuestEventQueue() :
     _queue(63),
-    _sourceID(0)
+    _sourceID(0),
+    _listener(nullptr),
+    _isWakeupPending(false),
+    _coalescedCount(0)
 {
 }
 
@@ -65,7 +81,10 @@ GuestEventQueue::GuestEventQueue() :
 //! the queue.
 GuestEventQueue::GuestEventQueue(uintptr_t sourceID) :
     _queue(63),
-    _sourceID(sourceID)
+    _sourceID(sourceID),
+    _listener(nullptr),
+    _isWakeupPending(false),
+    _coalescedCount(0)
 {
 }
 
@@ -80,6 +99,62 @@ void GuestEventQueue::setSourceID(uintptr_t sourceID)
     _sourceID = sourceID;
 }
 
+//! @brief Gets the object notified when events are posted to an empty queue.
+//! @returns The listener or nullptr if the queue must be polled.
+IGuestEventListener *GuestEventQueue::getListener() const { return _listener; }
+
+//! @brief Sets the object to be notified when events are posted to the
+//! queue after it has been drained.
+//! @param[in] listener The object to notify or nullptr to rely on polling.
+//! @note This should only be called while no events are being posted.
+void GuestEventQueue::setListener(IGuestEventListener *listener)
+{
+    _listener = listener;
+    _isWakeupPending.store(false);
+}
+
+//! @brief Gets the approximate count of events waiting to be dequeued.
+//! @note The count can be read from any thread, but may be out of date by
+//! the time it is returned.
+size_t GuestEventQueue::getBacklog() const
+{
+    return _queue.size_approx();
+}
+
+//! @brief Determines whether events of a specified type are coalesced.
+//! @param[in] type The event type to query.
+bool GuestEventQueue::isCoalesced(uint32_t type) const
+{
+    for (uint8_t i = 0; i < _coalescedCount; ++i)
+    {
+        if (_coalescedEvents[i].Type == type)
+            return true;
+    }
+
+    return false;
+}
+
+//! @brief Marks an event type as being coalesced, so that while one event of
+//! that type is waiting in the queue, posting another only updates the data
+//! it will be delivered with.
+//! @param[in] type The type of high-rate event to coalesce, such as a
+//! notification that a video or sound buffer is ready.
+//! @retval true The event type will be coalesced.
+//! @retval false Too many event types are already being coalesced.
+//! @note This should only be called before any events are posted.
+bool GuestEventQueue::tryEnableCoalescing(uint32_t type)
+{
+    bool isEnabled = isCoalesced(type);
+
+    if ((isEnabled == false) && (_coalescedCount < MaxCoalescedTypes))
+    {
+        _coalescedEvents[_coalescedCount++].Type = type;
+        isEnabled = true;
+    }
+
+    return isEnabled;
+}
+
 //! @brief Attempts to add a guest event to the queue.
 //! @param[in] type The type of event to add.
 //! @param[in] data1 The first event-type-specific parameter.
@@ -87,9 +162,50 @@ void GuestEventQueue::setSourceID(uintptr_t sourceID)
 //! @retval true The event was successfully added to the queue.
 //! @retval false The queue was full and could not be extended quickly, so the
 //! event was not queued.
+//! @note If the event type is coalesced and an event of the same type is
+//! already waiting, the waiting event will be delivered with the new data.
 bool GuestEventQueue::enque(int32_t type, uintptr_t data1, uintptr_t data2)
 {
-    return _queue.try_emplace(_sourceID, type, data1, data2);
+    CoalescedEvent *coalesced = findCoalescedEvent(static_cast<uint32_t>(type));
+    bool isQueued = true;
+    bool needsEvent = true;
+
+    if (coalesced != nullptr)
+    {
+        // Publish the latest data under the sequence lock.
+        uint32_t sequence = coalesced->Sequence.load(std::memory_order_relaxed);
+        coalesced->Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        coalesced->Data1.store(data1, std::memory_order_relaxed);
+        coalesced->Data2.store(data2, std::memory_order_relaxed);
+        coalesced->Sequence.store(sequence + 2, std::memory_order_release);
+
+        // If an event is already waiting, it will pick up the new data.
+        needsEvent = (coalesced->IsQueued.exchange(true) == false);
+    }
+
+    if (needsEvent)
+    {
+        isQueued = _queue.try_emplace(_sourceID, type, data1, data2);
+
+        if (isQueued == false)
+        {
+            if (coalesced != nullptr)
+            {
+                // Allow the next event of the type to try again.
+                coalesced->IsQueued.store(false);
+            }
+        }
+        else if ((_listener != nullptr) &&
+                 (_isWakeupPending.exchange(true) == false))
+        {
+            // The observer isn't already due to drain the queue, wake it up.
+            _listener->onGuestEventsPending();
+        }
+    }
+
+    return isQueued;
 }
 
 //! @brief Attempts to retrieve an item from the queue.
@@ -98,7 +214,74 @@ bool GuestEventQueue::enque(int32_t type, uintptr_t data1, uintptr_t data2)
 //! @retval false There were no events waiting in the queue.
 bool GuestEventQueue::tryDeque(GuestEvent &next)
 {
-    return _queue.try_dequeue(next);
+    return tryDequeMany(&next, 1) == 1;
+}
+
+//! @brief Attempts to retrieve a batch of events from the queue in one call.
+//! @param[out] events An array to receive the events.
+//! @param[in] maxCount The count of elements in events.
+//! @return The count of events written to the start of events, 0 if the
+//! queue was empty.
+size_t GuestEventQueue::tryDequeMany(GuestEvent *events, size_t maxCount)
+{
+    size_t count = 0;
+
+    while ((count < maxCount) && _queue.try_dequeue(events[count]))
+    {
+        resolveCoalescedEvent(events[count++]);
+    }
+
+    if ((count < maxCount) && (_listener != nullptr))
+    {
+        // Re-arm the notification before looking again so that an event
+        // posted in between isn't left in the queue without a wake-up.
+        _isWakeupPending.store(false);
+
+        while ((count < maxCount) && _queue.try_dequeue(events[count]))
+        {
+            resolveCoalescedEvent(events[count++]);
+        }
+    }
+
+    return count;
+}
+
+//! @brief Finds the slot holding the latest data for a coalesced event type.
+//! @param[in] type The event type to look up.
+//! @return The slot or nullptr if the type isn't coalesced.
+GuestEventQueue::CoalescedEvent *GuestEventQueue::findCoalescedEvent(uint32_t type)
+{
+    for (uint8_t i = 0; i < _coalescedCount; ++i)
+    {
+        if (_coalescedEvents[i].Type == type)
+            return _coalescedEvents + i;
+    }
+
+    return nullptr;
+}
+
+//! @brief Updates a dequeued event with the latest data posted with it if
+//! its type is coalesced.
+//! @param[in,out] event The event which has just been dequeued.
+void GuestEventQueue::resolveCoalescedEvent(GuestEvent &event)
+{
+    if (CoalescedEvent *coalesced = findCoalescedEvent(event.Type))
+    {
+        // Allow the producer to queue a new event before reading the data, so
+        // that data published after the read will always have an event.
+        coalesced->IsQueued.store(false);
+
+        uint32_t sequence;
+
+        do
+        {
+            sequence = coalesced->Sequence.load(std::memory_order_acquire);
+            event.Data1 = coalesced->Data1.load(std::memory_order_relaxed);
+            event.Data2 = coalesced->Data2.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) ||
+                 (sequence != coalesced->Sequence.load(std::memory_order_relaxed)));
+    }
 }
 
 }} // namespace Mo::Arm
@@ -0,0 +1,528 @@
+//! @file ArmEmu/GuestProfiler.cpp
+//! @brief The definition of objects which gather and export statistical
+//! profiles of where an emulated system spends its time.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#include "ArmEmu/GuestProfiler.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which encodes the subset of the protocol buffers wire
+//! format needed to produce a profile.proto message.
+class ProtoWriter
+{
+public:
+    // Construction/Destruction
+    ProtoWriter() = default;
+    ~ProtoWriter() = default;
+
+    // Accessors
+    const std::string &getBytes() const { return _bytes; }
+
+    // Operations
+    //! @brief Writes a varint field.
+    void writeUInt(uint32_t field, uint64_t value)
+    {
+        writeVarint(static_cast<uint64_t>(field) << 3);
+        writeVarint(value);
+    }
+
+    //! @brief Writes a length-delimited field.
+    void writeBytes(uint32_t field, std::string_view bytes)
+    {
+        writeVarint((static_cast<uint64_t>(field) << 3) | 2);
+        writeVarint(bytes.size());
+        _bytes.append(bytes);
+    }
+
+    //! @brief Writes a nested message as a length-delimited field.
+    void writeMessage(uint32_t field, const ProtoWriter &message)
+    {
+        writeBytes(field, message.getBytes());
+    }
+
+    //! @brief Writes a packed array of varint values.
+    template<typename TIter>
+    void writePacked(uint32_t field, TIter begin, TIter end)
+    {
+        ProtoWriter packed;
+
+        for (TIter pos = begin; pos != end; ++pos)
+        {
+            packed.writeVarint(static_cast<uint64_t>(*pos));
+        }
+
+        writeBytes(field, packed.getBytes());
+    }
+private:
+    //! @brief Appends a base-128 variable length encoded integer.
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            _bytes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        _bytes.push_back(static_cast<char>(value));
+    }
+
+    // Internal Fields
+    std::string _bytes;
+};
+
+//! @brief Assigns indices to unique strings for the profile.proto string table.
+class StringTable
+{
+public:
+    //! @brief Constructs a table where index 0 is the empty string, as
+    //! required by the format.
+    StringTable()
+    {
+        getIndex(std::string());
+    }
+
+    //! @brief Gets the index of a string, adding it if not already present.
+    uint64_t getIndex(const std::string &text)
+    {
+        auto insertResult = _indices.try_emplace(text, _strings.size());
+
+        if (insertResult.second)
+        {
+            _strings.push_back(text);
+        }
+
+        return insertResult.first->second;
+    }
+
+    //! @brief Writes the strings in index order.
+    void write(uint32_t field, ProtoWriter &writer) const
+    {
+        for (const std::string &text : _strings)
+        {
+            writer.writeBytes(field, text);
+        }
+    }
+private:
+    std::unordered_map<std::string, uint64_t> _indices;
+    std::vector<std::string> _strings;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Field numbers of the profile.proto messages used by pprof.
+namespace Pprof {
+    // Profile message.
+    constexpr uint32_t SampleType = 1;
+    constexpr uint32_t Sample = 2;
+    constexpr uint32_t Mapping = 3;
+    constexpr uint32_t Location = 4;
+    constexpr uint32_t Function = 5;
+    constexpr uint32_t StringTable = 6;
+    constexpr uint32_t PeriodType = 11;
+    constexpr uint32_t Period = 12;
+
+    // ValueType message.
+    constexpr uint32_t ValueTypeType = 1;
+    constexpr uint32_t ValueTypeUnit = 2;
+
+    // Sample message.
+    constexpr uint32_t SampleLocationId = 1;
+    constexpr uint32_t SampleValue = 2;
+
+    // Mapping message.
+    constexpr uint32_t MappingId = 1;
+    constexpr uint32_t MappingStart = 2;
+    constexpr uint32_t MappingLimit = 3;
+    constexpr uint32_t MappingFilename = 5;
+    constexpr uint32_t MappingHasFunctions = 7;
+
+    // Location message.
+    constexpr uint32_t LocationId = 1;
+    constexpr uint32_t LocationMappingId = 2;
+    constexpr uint32_t LocationAddress = 3;
+    constexpr uint32_t LocationLine = 4;
+
+    // Line message.
+    constexpr uint32_t LineFunctionId = 1;
+
+    // Function message.
+    constexpr uint32_t FunctionId = 1;
+    constexpr uint32_t FunctionName = 2;
+    constexpr uint32_t FunctionSystemName = 3;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Writes a profile.proto ValueType message.
+void writeValueType(ProtoWriter &writer, uint32_t field, StringTable &strings,
+                    const char *type, const char *unit)
+{
+    ProtoWriter valueType;
+    valueType.writeUInt(Pprof::ValueTypeType, strings.getIndex(type));
+    valueType.writeUInt(Pprof::ValueTypeUnit, strings.getIndex(unit));
+
+    writer.writeMessage(field, valueType);
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// GuestSymbolTable Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Determines whether the table contains no symbols.
+bool GuestSymbolTable::isEmpty() const
+{
+    return _symbols.empty();
+}
+
+//! @brief Gets the count of symbols in the table.
+size_t GuestSymbolTable::getCount() const
+{
+    return _symbols.size();
+}
+
+//! @brief Attempts to find the symbol at or preceding an address.
+//! @param[in] address The guest address to look up.
+//! @param[out] name Receives the name of the symbol found.
+//! @param[out] offset Receives the offset of address from the symbol.
+//! @retval true A symbol was found.
+//! @retval false No symbol preceded the address.
+bool GuestSymbolTable::tryFindSymbol(uint32_t address, std::string_view &name,
+                                     uint32_t &offset) const
+{
+    Symbol key;
+    key.Address = address;
+    bool isFound = false;
+
+    // Find the first symbol beyond the address and step back one.
+    auto pos = std::upper_bound(_symbols.begin(), _symbols.end(), key);
+
+    if (pos != _symbols.begin())
+    {
+        --pos;
+        name = pos->Name;
+        offset = address - pos->Address;
+        isFound = true;
+    }
+
+    return isFound;
+}
+
+//! @brief Gets the name of the function containing an address, or the
+//! address in hexadecimal if it couldn't be resolved.
+//! @param[in] address The guest address to look up.
+std::string GuestSymbolTable::getFunctionName(uint32_t address) const
+{
+    std::string_view symbol;
+    uint32_t offset;
+    std::string name;
+
+    if (tryFindSymbol(address, symbol, offset))
+    {
+        name.assign(symbol);
+    }
+    else
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "0x%.8X", address);
+        name.assign(buffer);
+    }
+
+    return name;
+}
+
+//! @brief Removes all symbols from the table.
+void GuestSymbolTable::clear()
+{
+    _symbols.clear();
+}
+
+//! @brief Adds a symbol to the table.
+//! @param[in] address The guest address the symbol labels.
+//! @param[in] name The name of the symbol.
+//! @note If a symbol already labels the address, it is replaced.
+void GuestSymbolTable::addSymbol(uint32_t address, std::string_view name)
+{
+    Symbol symbol;
+    symbol.Address = address;
+    symbol.Name.assign(name);
+
+    auto pos = std::lower_bound(_symbols.begin(), _symbols.end(), symbol);
+
+    if ((pos != _symbols.end()) && (pos->Address == address))
+    {
+        pos->Name = std::move(symbol.Name);
+    }
+    else
+    {
+        _symbols.insert(pos, std::move(symbol));
+    }
+}
+
+//! @brief Adds a set of symbols to the table, such as those returned by
+//! Asm::ObjectCode::getSymbols().
+//! @param[in] symbols A map of symbol names to the addresses they label.
+void GuestSymbolTable::addSymbols(const std::unordered_map<Ag::String, uint32_t> &symbols)
+{
+    _symbols.reserve(_symbols.size() + symbols.size());
+
+    for (const auto &mapping : symbols)
+    {
+        addSymbol(mapping.second,
+                  std::string_view(mapping.first.getUtf8Bytes(),
+                                   mapping.first.getUtf8Length()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GuestProfiler Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates an FNV-1a hash of the addresses in a call stack.
+size_t GuestProfiler::StackHash::operator()(const std::vector<uint32_t> &stack) const
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (uint32_t address : stack)
+    {
+        hash ^= address;
+        hash *= 0x100000001B3ull;
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+//! @brief Constructs a profiler which is initially disabled.
+GuestProfiler::GuestProfiler() :
+    _sampleCount(0),
+    _samplePeriod(DefaultSamplePeriod),
+    _isEnabled(false)
+{
+    _sampleStack.reserve(MaxStackDepth);
+}
+
+//! @brief Determines whether samples are being recorded.
+bool GuestProfiler::isEnabled() const
+{
+    return _isEnabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Starts or stops the recording of samples.
+//! @param[in] isEnabled True to record samples, false to stop.
+//! @note This member function can be called from any thread.
+void GuestProfiler::setEnabled(bool isEnabled)
+{
+    _isEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+//! @brief Gets the count of emulated processor cycles between samples.
+uint32_t GuestProfiler::getSamplePeriod() const
+{
+    return _samplePeriod.load(std::memory_order_relaxed);
+}
+
+//! @brief Sets the count of emulated processor cycles between samples.
+//! @param[in] cycleCount The new sample period, which must be non-zero.
+//! @note This member function can be called from any thread, the new
+//! period takes effect after the next sample.
+void GuestProfiler::setSamplePeriod(uint32_t cycleCount)
+{
+    _samplePeriod.store(std::max(cycleCount, 1u), std::memory_order_relaxed);
+}
+
+//! @brief Gets the total count of samples recorded.
+uint64_t GuestProfiler::getSampleCount() const
+{
+    return _sampleCount;
+}
+
+//! @brief Gets the count of distinct call stacks sampled.
+size_t GuestProfiler::getUniqueStackCount() const
+{
+    return _stackCounts.size();
+}
+
+//! @brief Disposes of all samples recorded so far.
+void GuestProfiler::clear()
+{
+    _stackCounts.clear();
+    _sampleCount = 0;
+}
+
+//! @brief Records a single sample of a guest call stack.
+//! @param[in] frames The addresses in the call stack, the address being
+//! executed first followed by return addresses.
+//! @param[in] depth The count of addresses in frames, truncated to
+//! MaxStackDepth.
+void GuestProfiler::recordSample(const uint32_t *frames, uint8_t depth)
+{
+    if (depth > 0)
+    {
+        // Re-use the same buffer for look-ups so that only new stacks
+        // allocate memory.
+        _sampleStack.assign(frames, frames + std::min(depth, MaxStackDepth));
+
+        auto pos = _stackCounts.find(_sampleStack);
+
+        if (pos == _stackCounts.end())
+        {
+            _stackCounts.emplace(_sampleStack, 1);
+        }
+        else
+        {
+            ++pos->second;
+        }
+
+        ++_sampleCount;
+    }
+}
+
+//! @brief Writes the samples in the folded stack format consumed by
+//! flamegraph.pl and compatible tools.
+//! @param[in] output The stream to write lines of text to.
+//! @param[in] symbols The symbols used to name the functions in each frame.
+//! @details Each line lists the functions in a stack from the outermost
+//! caller to the function being executed, separated by semi-colons, followed
+//! by the count of samples. Stacks which only differ by address within the
+//! same functions are merged.
+void GuestProfiler::writeFoldedStacks(std::ostream &output,
+                                      const GuestSymbolTable &symbols) const
+{
+    // Use an ordered map so that the output is deterministic.
+    std::map<std::string, uint64_t> foldedCounts;
+    std::string folded;
+
+    for (const auto &stackCount : _stackCounts)
+    {
+        const std::vector<uint32_t> &stack = stackCount.first;
+        folded.clear();
+
+        for (auto pos = stack.rbegin(); pos != stack.rend(); ++pos)
+        {
+            if (folded.empty() == false)
+            {
+                folded.push_back(';');
+            }
+
+            folded.append(symbols.getFunctionName(*pos));
+        }
+
+        foldedCounts[folded] += stackCount.second;
+    }
+
+    for (const auto &foldedCount : foldedCounts)
+    {
+        output << foldedCount.first << ' ' << foldedCount.second << '\n';
+    }
+}
+
+//! @brief Writes the samples as an uncompressed profile.proto message which
+//! can be read by pprof.
+//! @param[in] output The binary stream to write the profile to.
+//! @param[in] symbols The symbols used to name the function at each location.
+//! @details Each sample has a count and the equivalent count of processor
+//! cycles. All guest addresses belong to a single mapping marked as already
+//! symbolised so that pprof doesn't try to resolve them against host binaries.
+void GuestProfiler::writePprofProfile(std::ostream &output,
+                                      const GuestSymbolTable &symbols) const
+{
+    ProtoWriter profile;
+    StringTable strings;
+    std::unordered_map<uint32_t, uint64_t> locationIds;
+    std::unordered_map<std::string, uint64_t> functionIds;
+    std::vector<uint64_t> sampleLocations;
+    const uint64_t period = getSamplePeriod();
+    constexpr uint64_t GuestMappingId = 1;
+
+    writeValueType(profile, Pprof::SampleType, strings, "samples", "count");
+    writeValueType(profile, Pprof::SampleType, strings, "cycles", "count");
+
+    for (const auto &stackCount : _stackCounts)
+    {
+        sampleLocations.clear();
+
+        for (uint32_t address : stackCount.first)
+        {
+            auto locationPos = locationIds.try_emplace(address, locationIds.size() + 1);
+
+            if (locationPos.second)
+            {
+                // A new location, ensure its function is defined.
+                std::string name = symbols.getFunctionName(address);
+                auto functionPos = functionIds.try_emplace(name, functionIds.size() + 1);
+
+                if (functionPos.second)
+                {
+                    ProtoWriter function;
+                    uint64_t nameId = strings.getIndex(name);
+                    function.writeUInt(Pprof::FunctionId, functionPos.first->second);
+                    function.writeUInt(Pprof::FunctionName, nameId);
+                    function.writeUInt(Pprof::FunctionSystemName, nameId);
+
+                    profile.writeMessage(Pprof::Function, function);
+                }
+
+                ProtoWriter line;
+                line.writeUInt(Pprof::LineFunctionId, functionPos.first->second);
+
+                ProtoWriter location;
+                location.writeUInt(Pprof::LocationId, locationPos.first->second);
+                location.writeUInt(Pprof::LocationMappingId, GuestMappingId);
+                location.writeUInt(Pprof::LocationAddress, address);
+                location.writeMessage(Pprof::LocationLine, line);
+
+                profile.writeMessage(Pprof::Location, location);
+            }
+
+            sampleLocations.push_back(locationPos.first->second);
+        }
+
+        const uint64_t values[] = { stackCount.second, stackCount.second * period };
+
+        ProtoWriter sample;
+        sample.writePacked(Pprof::SampleLocationId, sampleLocations.begin(),
+                           sampleLocations.end());
+        sample.writePacked(Pprof::SampleValue, std::begin(values), std::end(values));
+
+        profile.writeMessage(Pprof::Sample, sample);
+    }
+
+    ProtoWriter mapping;
+    mapping.writeUInt(Pprof::MappingId, GuestMappingId);
+    mapping.writeUInt(Pprof::MappingStart, 0);
+    mapping.writeUInt(Pprof::MappingLimit, 0x100000000ull);
+    mapping.writeUInt(Pprof::MappingFilename, strings.getIndex("guest"));
+    mapping.writeUInt(Pprof::MappingHasFunctions, 1);
+    profile.writeMessage(Pprof::Mapping, mapping);
+
+    writeValueType(profile, Pprof::PeriodType, strings, "cycles", "count");
+    profile.writeUInt(Pprof::Period, period);
+
+    // The string table must be complete before it is written.
+    strings.write(Pprof::StringTable, profile);
+
+    const std::string &bytes = profile.getBytes();
+    output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,625 @@
+//! @file ArmEmu/HardDiscImage.cpp
+//! @brief The definition of an object which presents a hard disc image
+//! shared read-only between emulated systems with a private, sparse
+//! copy-on-write overlay of the blocks each one has written.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ArmEmu/HardDiscImage.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The layout of the start of an overlay file. Values are stored in
+//! host byte order.
+struct OverlayHeader
+{
+    //! @brief Identifies the file format, see OverlaySignature.
+    char Signature[8];
+
+    //! @brief The version of the file format, see OverlayVersion.
+    uint32_t Version;
+
+    //! @brief The count of bytes in each block.
+    uint32_t BlockSize;
+
+    //! @brief The size of the base image the overlay was created for.
+    uint64_t BaseSize;
+
+    //! @brief A hash of the start of the base image the overlay was created
+    //! for, used to detect an overlay being used with the wrong base image.
+    uint64_t BaseFingerprint;
+
+    //! @brief The count of entries in the block allocation table.
+    uint32_t BlockCount;
+
+    //! @brief The count of blocks stored in the overlay.
+    uint32_t AllocatedBlockCount;
+
+    //! @brief The offset of the first block from the start of the file.
+    uint32_t DataOffset;
+
+    //! @brief Reserved, zero.
+    uint8_t Reserved[20];
+};
+
+static_assert(sizeof(OverlayHeader) == 64, "The overlay header format has changed.");
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The signature at the start of an overlay file.
+constexpr char OverlaySignature[8] = { 'M', 'O', 'H', 'D', 'C', 'O', 'W', '1' };
+
+//! @brief The version of the overlay file format written.
+constexpr uint32_t OverlayVersion = 1;
+
+//! @brief The alignment of blocks within an overlay, which allows them to
+//! be mapped and synchronised as whole pages.
+constexpr uint32_t OverlayAlignment = 4096;
+
+//! @brief The maximum count of bytes at the start of the base image used to
+//! calculate its fingerprint.
+constexpr size_t FingerprintSize = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates a 64-bit FNV-1a hash of the start of a base image.
+//! @param[in] base The mapped base image.
+//! @param[in] size The count of bytes in the base image.
+uint64_t calculateFingerprint(const uint8_t *base, size_t size)
+{
+    const size_t length = std::min(size, FingerprintSize);
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= base[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+//! @brief Calculates the offset of the first block in an overlay.
+//! @param[in] blockCount The count of entries in the block allocation table.
+uint32_t calculateDataOffset(uint32_t blockCount)
+{
+    const uint64_t tableEnd = sizeof(OverlayHeader) +
+                              (static_cast<uint64_t>(blockCount) * sizeof(uint32_t));
+
+    return static_cast<uint32_t>((tableEnd + OverlayAlignment - 1) &
+                                 ~static_cast<uint64_t>(OverlayAlignment - 1));
+}
+
+//! @brief Determines whether every entry of an overlay's block allocation
+//! table refers to a distinct block stored in the overlay.
+//! @param[in] table The block allocation table, in which an entry holds the
+//! 1-based index of the stored block or 0 if the block isn't stored.
+//! @param[in] blockCount The count of entries in the table.
+//! @param[in] allocatedBlockCount The count of blocks stored in the overlay.
+//! @retval true The table is consistent.
+//! @retval false An entry was out of range or shared with another block.
+bool isAllocationTableValid(const uint32_t *table, uint32_t blockCount,
+                            uint32_t allocatedBlockCount)
+{
+    std::vector<bool> isSlotUsed(allocatedBlockCount, false);
+    bool isValid = true;
+
+    for (uint32_t block = 0; isValid && (block < blockCount); ++block)
+    {
+        const uint32_t entry = table[block];
+
+        if (entry != 0)
+        {
+            isValid = (entry <= allocatedBlockCount) && (isSlotUsed[entry - 1] == false);
+
+            if (isValid)
+            {
+                isSlotUsed[entry - 1] = true;
+            }
+        }
+    }
+
+    return isValid;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// HardDiscImage Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object with no disc image mapped.
+HardDiscImage::HardDiscImage() :
+    _base(nullptr),
+    _overlay(nullptr),
+    _allocationTable(nullptr),
+    _overlayBlocks(nullptr),
+    _baseSize(0),
+    _overlayMapSize(0),
+    _overlayHandle(-1),
+    _sectorCount(0),
+    _blockSize(0),
+    _blockCount(0),
+    _dirtyBlockCount(0)
+{
+}
+
+//! @brief Writes back any changed blocks and unmaps the image.
+HardDiscImage::~HardDiscImage()
+{
+    close();
+}
+
+//! @brief Determines whether a base image is mapped.
+bool HardDiscImage::isOpen() const
+{
+    return _base != nullptr;
+}
+
+//! @brief Determines whether sectors can be written, i.e. an overlay is
+//! mapped to receive them.
+bool HardDiscImage::isWriteProtected() const
+{
+    return _overlay == nullptr;
+}
+
+//! @brief Gets the name of the base image file shared by emulated systems.
+const std::string &HardDiscImage::getBaseFileName() const
+{
+    return _baseFileName;
+}
+
+//! @brief Gets the name of the file holding the blocks written, empty if
+//! the image is write protected.
+const std::string &HardDiscImage::getOverlayFileName() const
+{
+    return _overlayFileName;
+}
+
+//! @brief Gets the count of sectors on the disc.
+uint32_t HardDiscImage::getSectorCount() const
+{
+    return _sectorCount;
+}
+
+//! @brief Gets the count of bytes copied into the overlay when a block is
+//! first written.
+uint32_t HardDiscImage::getBlockSize() const
+{
+    return _blockSize;
+}
+
+//! @brief Gets the count of blocks the disc is divided into.
+uint32_t HardDiscImage::getBlockCount() const
+{
+    return _blockCount;
+}
+
+//! @brief Gets the count of blocks which have been copied into the overlay.
+uint32_t HardDiscImage::getAllocatedBlockCount() const
+{
+    return (_overlay == nullptr) ? 0 :
+                                   reinterpret_cast<const OverlayHeader *>(_overlay)->AllocatedBlockCount;
+}
+
+//! @brief Determines whether a block is held in the overlay rather than the
+//! base image.
+//! @param[in] block The 0-based index of the block.
+bool HardDiscImage::isBlockAllocated(uint32_t block) const
+{
+    return (_allocationTable != nullptr) && (block < _blockCount) &&
+           (_allocationTable[block] != 0);
+}
+
+//! @brief Gets the data of a sector to read.
+//! @param[in] lba The logical block address of the sector.
+//! @return A pointer to SectorSize bytes, or nullptr if the sector isn't on
+//! the disc.
+const uint8_t *HardDiscImage::getSector(uint32_t lba) const
+{
+    const uint8_t *data = nullptr;
+
+    if (lba < _sectorCount)
+    {
+        const uint64_t offset = static_cast<uint64_t>(lba) * SectorSize;
+        const uint32_t block = static_cast<uint32_t>(offset / _blockSize);
+
+        if (isBlockAllocated(block))
+        {
+            // The block has been written, use the private copy.
+            data = _overlayBlocks +
+                   (static_cast<size_t>(_allocationTable[block] - 1) * _blockSize) +
+                   (offset % _blockSize);
+        }
+        else
+        {
+            data = _base + offset;
+        }
+    }
+
+    return data;
+}
+
+//! @brief Gets the data of a sector to be overwritten, copying the block
+//! containing it into the overlay if it hasn't been written before.
+//! @param[in] lba The logical block address of the sector.
+//! @return A pointer to SectorSize bytes, or nullptr if the sector isn't on
+//! the disc, the image is write protected or the overlay couldn't grow.
+uint8_t *HardDiscImage::getWritableSector(uint32_t lba)
+{
+    uint8_t *data = nullptr;
+
+    if ((lba < _sectorCount) && (_overlay != nullptr))
+    {
+        const uint64_t offset = static_cast<uint64_t>(lba) * SectorSize;
+        const uint32_t block = static_cast<uint32_t>(offset / _blockSize);
+
+        if (isBlockAllocated(block) || tryAllocateBlock(block))
+        {
+            uint64_t &word = _dirtyBlocks[block >> 6];
+            const uint64_t bit = uint64_t(1) << (block & 63);
+
+            if ((word & bit) == 0)
+            {
+                word |= bit;
+                ++_dirtyBlockCount;
+            }
+
+            data = _overlayBlocks +
+                   (static_cast<size_t>(_allocationTable[block] - 1) * _blockSize) +
+                   (offset % _blockSize);
+        }
+    }
+
+    return data;
+}
+
+//! @brief Attempts to map a base disc image and the overlay holding the
+//! blocks written to it.
+//! @param[in] baseFileName The path to a raw image of the disc, its size
+//! must be a whole number of sectors. It is only ever read.
+//! @param[in] overlayFileName The path to the overlay private to the
+//! emulated system. A new overlay is created if the file doesn't exist or
+//! is empty. If empty, the image is write protected.
+//! @param[out] error Receives a description of why the image couldn't be
+//! mapped.
+//! @param[in] blockSize The size of the blocks of a new overlay, a power of
+//! 2 from 4 KB to 1 MB. The size of an existing overlay is kept.
+//! @retval true The image was mapped, replacing any mapped before.
+//! @retval false The image couldn't be mapped, error is updated.
+bool HardDiscImage::tryOpen(const std::string &baseFileName,
+                            const std::string &overlayFileName,
+                            std::string &error, uint32_t blockSize /* = DefaultBlockSize */)
+{
+    bool isOpened = false;
+    close();
+
+#ifdef _WIN32
+    (void)baseFileName;
+    (void)overlayFileName;
+    (void)blockSize;
+    error = "Mapping hard disc images is not supported on this platform.";
+#else
+    int baseHandle = ::open(baseFileName.c_str(), O_RDONLY);
+    struct stat status;
+    void *baseRegion = MAP_FAILED;
+    size_t baseSize = 0;
+
+    if ((blockSize < OverlayAlignment) || (blockSize > (1u << 20)) ||
+        (blockSize & (blockSize - 1)))
+    {
+        error = "The block size of a hard disc overlay must be a "
+                "power of 2 from 4 KB to 1 MB.";
+    }
+    else if (baseHandle < 0)
+    {
+        error = "Could not open hard disc image '" + baseFileName + "': " +
+                std::strerror(errno);
+    }
+    else if (::fstat(baseHandle, &status) != 0)
+    {
+        error = "Could not get the size of hard disc image '" + baseFileName +
+                "': " + std::strerror(errno);
+    }
+    else if ((status.st_size <= 0) || (status.st_size % SectorSize) ||
+             ((static_cast<uint64_t>(status.st_size) / SectorSize) >
+              std::numeric_limits<uint32_t>::max()))
+    {
+        error = "The size of hard disc image '" + baseFileName +
+                "' isn't a whole number of sectors.";
+    }
+    else
+    {
+        // The base image is only read, so every emulated system mapping it
+        // shares the same pages.
+        baseSize = static_cast<size_t>(status.st_size);
+        baseRegion = ::mmap(nullptr, baseSize, PROT_READ, MAP_SHARED, baseHandle, 0);
+
+        if (baseRegion == MAP_FAILED)
+        {
+            error = "Could not map hard disc image '" + baseFileName + "': " +
+                    std::strerror(errno);
+        }
+    }
+
+    if (baseHandle >= 0)
+    {
+        // The mapping keeps the file open.
+        ::close(baseHandle);
+    }
+
+    if (baseRegion != MAP_FAILED)
+    {
+        _baseFileName = baseFileName;
+        _base = static_cast<const uint8_t *>(baseRegion);
+        _baseSize = baseSize;
+        _sectorCount = static_cast<uint32_t>(baseSize / SectorSize);
+        _blockSize = blockSize;
+        isOpened = true;
+    }
+
+    if (isOpened && (overlayFileName.empty() == false))
+    {
+        const uint64_t fingerprint = calculateFingerprint(_base, _baseSize);
+        OverlayHeader header;
+        std::memset(&header, 0, sizeof(header));
+        isOpened = false;
+
+        _overlayHandle = ::open(overlayFileName.c_str(), O_RDWR | O_CREAT, 0644);
+
+        if (_overlayHandle < 0)
+        {
+            error = "Could not open hard disc overlay '" + overlayFileName +
+                    "': " + std::strerror(errno);
+        }
+        else if (::fstat(_overlayHandle, &status) != 0)
+        {
+            error = "Could not get the size of hard disc overlay '" +
+                    overlayFileName + "': " + std::strerror(errno);
+        }
+        else if (status.st_size == 0)
+        {
+            // Create an overlay with no blocks allocated.
+            std::memcpy(header.Signature, OverlaySignature, sizeof(header.Signature));
+            header.Version = OverlayVersion;
+            header.BlockSize = blockSize;
+            header.BaseSize = _baseSize;
+            header.BaseFingerprint = fingerprint;
+            header.BlockCount = static_cast<uint32_t>((_baseSize + blockSize - 1) / blockSize);
+            header.AllocatedBlockCount = 0;
+            header.DataOffset = calculateDataOffset(header.BlockCount);
+
+            if ((::ftruncate(_overlayHandle, header.DataOffset) != 0) ||
+                (::pwrite(_overlayHandle, &header, sizeof(header), 0) !=
+                 static_cast<ssize_t>(sizeof(header))))
+            {
+                error = "Could not initialise hard disc overlay '" +
+                        overlayFileName + "': " + std::strerror(errno);
+            }
+            else
+            {
+                isOpened = true;
+            }
+        }
+        else if (::pread(_overlayHandle, &header, sizeof(header), 0) !=
+                 static_cast<ssize_t>(sizeof(header)))
+        {
+            error = "Could not read hard disc overlay '" + overlayFileName +
+                    "': " + std::strerror(errno);
+        }
+        else if ((std::memcmp(header.Signature, OverlaySignature, sizeof(header.Signature)) != 0) ||
+                 (header.Version != OverlayVersion))
+        {
+            error = "The file '" + overlayFileName + "' isn't a hard disc overlay.";
+        }
+        else if ((header.BaseSize != _baseSize) ||
+                 (header.BaseFingerprint != fingerprint))
+        {
+            error = "The hard disc overlay '" + overlayFileName +
+                    "' was created for a different base image.";
+        }
+        else if ((header.BlockSize < OverlayAlignment) ||
+                 (header.BlockSize & (header.BlockSize - 1)) ||
+                 (header.BlockCount != ((_baseSize + header.BlockSize - 1) / header.BlockSize)) ||
+                 (header.AllocatedBlockCount > header.BlockCount) ||
+                 (header.DataOffset != calculateDataOffset(header.BlockCount)) ||
+                 (static_cast<uint64_t>(status.st_size) <
+                  (header.DataOffset + (static_cast<uint64_t>(header.AllocatedBlockCount) *
+                                        header.BlockSize))))
+        {
+            error = "The hard disc overlay '" + overlayFileName + "' is corrupt.";
+        }
+        else
+        {
+            isOpened = true;
+        }
+
+        if (isOpened)
+        {
+            // Reserve address space for every block being written, only
+            // the pages backed by the file are touched.
+            const size_t mapSize = header.DataOffset +
+                                   (static_cast<size_t>(header.BlockCount) * header.BlockSize);
+            void *overlayRegion = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+                                         MAP_SHARED, _overlayHandle, 0);
+
+            if (overlayRegion == MAP_FAILED)
+            {
+                error = "Could not map hard disc overlay '" + overlayFileName +
+                        "': " + std::strerror(errno);
+                isOpened = false;
+            }
+            else if (isAllocationTableValid(reinterpret_cast<const uint32_t *>(static_cast<uint8_t *>(overlayRegion) +
+                                                                                sizeof(OverlayHeader)),
+                                            header.BlockCount,
+                                            header.AllocatedBlockCount) == false)
+            {
+                // Entries are used as indices into the stored blocks.
+                ::munmap(overlayRegion, mapSize);
+                error = "The hard disc overlay '" + overlayFileName + "' is corrupt.";
+                isOpened = false;
+            }
+            else
+            {
+                _overlayFileName = overlayFileName;
+                _overlay = static_cast<uint8_t *>(overlayRegion);
+                _overlayMapSize = mapSize;
+                _allocationTable = reinterpret_cast<uint32_t *>(_overlay + sizeof(OverlayHeader));
+                _overlayBlocks = _overlay + header.DataOffset;
+                _blockSize = header.BlockSize;
+                _blockCount = header.BlockCount;
+                _dirtyBlocks.assign((_blockCount + 63) / 64, 0);
+                _dirtyBlockCount = 0;
+            }
+        }
+
+        if (isOpened == false)
+        {
+            close();
+        }
+    }
+    else if (isOpened)
+    {
+        _blockCount = static_cast<uint32_t>((_baseSize + _blockSize - 1) / _blockSize);
+    }
+#endif
+
+    return isOpened;
+}
+
+//! @brief Writes blocks changed since the last flush back to the overlay.
+//! @return The count of dirty blocks written back.
+//! @note Only the pages of the allocation table and the dirty blocks are
+//! synchronised.
+uint32_t HardDiscImage::flush()
+{
+    uint32_t flushedCount = 0;
+
+#ifndef _WIN32
+    if (_dirtyBlockCount > 0)
+    {
+        for (uint32_t block = 0; block < _blockCount; ++block)
+        {
+            if (_dirtyBlocks[block >> 6] & (uint64_t(1) << (block & 63)))
+            {
+                ::msync(_overlayBlocks + (static_cast<size_t>(_allocationTable[block] - 1) * _blockSize),
+                        _blockSize, MS_SYNC);
+                ++flushedCount;
+            }
+        }
+
+        // Write the table after the blocks it refers to.
+        ::msync(_overlay, static_cast<size_t>(_overlayBlocks - _overlay), MS_SYNC);
+
+        std::fill(_dirtyBlocks.begin(), _dirtyBlocks.end(), 0);
+        _dirtyBlockCount = 0;
+    }
+#endif
+
+    return flushedCount;
+}
+
+//! @brief Writes back any changed blocks and unmaps the image.
+void HardDiscImage::close()
+{
+    flush();
+
+#ifndef _WIN32
+    if (_overlay != nullptr)
+    {
+        ::munmap(_overlay, _overlayMapSize);
+    }
+
+    if (_overlayHandle >= 0)
+    {
+        ::close(_overlayHandle);
+    }
+
+    if (_base != nullptr)
+    {
+        ::munmap(const_cast<uint8_t *>(_base), _baseSize);
+    }
+#endif
+
+    _baseFileName.clear();
+    _overlayFileName.clear();
+    _dirtyBlocks.clear();
+    _base = nullptr;
+    _overlay = nullptr;
+    _allocationTable = nullptr;
+    _overlayBlocks = nullptr;
+    _baseSize = 0;
+    _overlayMapSize = 0;
+    _overlayHandle = -1;
+    _sectorCount = 0;
+    _blockSize = 0;
+    _blockCount = 0;
+    _dirtyBlockCount = 0;
+}
+
+//! @brief Attempts to copy a block from the base image to the end of the
+//! overlay.
+//! @param[in] block The 0-based index of the block.
+//! @retval true The block was copied and its allocation table entry updated.
+//! @retval false The overlay file couldn't be extended.
+bool HardDiscImage::tryAllocateBlock(uint32_t block)
+{
+    bool isAllocated = false;
+
+#ifndef _WIN32
+    OverlayHeader *header = reinterpret_cast<OverlayHeader *>(_overlay);
+    const uint32_t slot = header->AllocatedBlockCount;
+    const off_t fileSize = static_cast<off_t>(header->DataOffset) +
+                           (static_cast<off_t>(slot + 1) * _blockSize);
+
+    // The new pages of the mapping can only be touched once the file
+    // covers them.
+    if (::ftruncate(_overlayHandle, fileSize) == 0)
+    {
+        const size_t offset = static_cast<size_t>(block) * _blockSize;
+        const size_t length = std::min<size_t>(_blockSize, _baseSize - offset);
+
+        // The tail of a partial last block is left zero.
+        std::memcpy(_overlayBlocks + (static_cast<size_t>(slot) * _blockSize),
+                    _base + offset, length);
+
+        // Only refer to the copy once it is complete.
+        _allocationTable[block] = slot + 1;
+        header->AllocatedBlockCount = slot + 1;
+        isAllocated = true;
+    }
+#else
+    (void)block;
+#endif
+
+    return isAllocated;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -20,9 +20,18 @@
 
 #include "Ag/Core/Binary.hpp"
 
+#include "ArmEmu/HleHooks.hpp"
+#include "ArmEmu/HostFileSystem.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+
+#include "CounterCoProcessor.inl"
+
 namespace Mo {
 namespace Arm {
 
+class SoundSampleRing;
+class VideoFrameExchange;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Data Type Declarations
 ////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +111,12 @@ using HostBuffer = std::vector<uint8_t>;
 //! register files and data transfer.
 class GenericHardware
 {
+    //! @brief Indicates whether the hardware counts the reads and writes
+    //! passed to memory mapped devices, and so implements
+    //! getMmioAccessCount(). Only hardware used by instrumented systems
+    //! does, so that other systems don't pay for the count.
+    static constexpr bool CountsMmio = false;
+
     // IRQ Management
     //! @brief Gets the bit field indicating which unmasked interrupts are
     //! pending, if any.
@@ -110,11 +125,36 @@ class GenericHardware
     //! IrqState structure.
     uint8_t getIrqStatus() const noexcept;
 
+    //! @brief Gets the emulator-only co-processor which allows guest code to
+    //! read emulator counters.
+    CounterCoProcessor &getCounterCoProcessor() noexcept;
+
+    //! @brief Gets the object which services host filing system SWIs.
+    HostFileSystem &getHostFileSystem() noexcept;
+
+    //! @brief Gets the table of host functions which replace guest SWIs
+    //! and routines.
+    HleHookTable &getHleHooks() noexcept;
+
+    //! @brief Gets the object which publishes snapshots of the display at
+    //! vertical sync, or nullptr if the hardware has no video output.
+    VideoFrameExchange *getVideoFrames() noexcept;
+
+    //! @brief Gets the ring which queues sound samples for the host, or
+    //! nullptr if the hardware has no sound output.
+    SoundSampleRing *getSoundSamples() noexcept;
+
     // Operations
     //! @brief Signals the effect of a system reset on the hardware, returning
     //! it to a known power-on state.
     void reset();
 
+    //! @brief Records that the host has written directly to physical memory
+    //! so that any state derived from it can be refreshed.
+    //! @param[in] physAddr The physical address of the first byte written.
+    //! @param[in] byteCount The count of bytes written.
+    void markHostWrite(uint32_t physAddr, uint32_t byteCount);
+
     //! @brief Updates the bits of the interrupt mask field.
     //! @param[in] mask The new pattern of bits to apply to the mask.
     //! @param[in] significantBits The bits describing which digits of mask
@@ -249,6 +289,11 @@ class GenericHardware
     bool logicalToPhysicalAddress(uint32_t logicalAddr,
                                   PageMapping &mapping) const;
 
+    //! @brief Gets the count of reads and writes which have been passed to
+    //! memory mapped devices rather than host memory.
+    //! @note Only required if CountsMmio is true.
+    uint64_t getMmioAccessCount() const;
+
     //! @brief Gets a map describing the entities read from indexed by physical
     //! address.
     const AddressMap &getReadAddressMap() const;
@@ -264,6 +309,45 @@ class GenericHardware
     //! @brief Create a map of all writeable memory regions in the system,
     //! including ranges of addresses with fixed decoding logic.
     AddressMap createMasterWriteMap();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // State Capture
+    ///////////////////////////////////////////////////////////////////////////
+    //! @brief Appends the state of the hardware, including RAM, to a snapshot.
+    //! @param[in] snapshot The snapshot to append to.
+    //! @note Devices which appear in the address maps capture their own state.
+    void captureState(SystemSnapshot &snapshot) const;
+
+    //! @brief Restores state written by captureState().
+    //! @param[in] reader The object to read state from.
+    //! @note Pending host and debug interrupts are not affected.
+    void restoreState(SnapshotReader &reader);
+};
+
+//! @brief An implementation of the services GenericHardware provides to guest
+//! code which are implemented by the host rather than emulated hardware.
+//! @details Hardware classes inherit this alongside BasicIrqManagerHardware,
+//! the services are connected to the system by ArmSystem.
+class HostServicesHardware
+{
+private:
+    // Internal Fields
+    CounterCoProcessor _counterCoProc;
+    HostFileSystem _hostFileSystem;
+    HleHookTable _hleHooks;
+
+public:
+    // Accessors
+    //! @brief Gets the emulator-only co-processor which allows guest code to
+    //! read emulator counters.
+    CounterCoProcessor &getCounterCoProcessor() noexcept { return _counterCoProc; }
+
+    //! @brief Gets the object which services host filing system SWIs.
+    HostFileSystem &getHostFileSystem() noexcept { return _hostFileSystem; }
+
+    //! @brief Gets the table of host functions which replace guest SWIs
+    //! and routines.
+    HleHookTable &getHleHooks() noexcept { return _hleHooks; }
 };
 
 //! @brief An implementation of the common interrupt management requirements of
@@ -313,7 +397,19 @@ public:
     //! IrqState structure.
     uint8_t getIrqStatus() const noexcept { return _irqStatus & ~_irqMask; }
 
+    //! @brief Gets the object which publishes snapshots of the display at
+    //! vertical sync, or nullptr if the hardware has no video output.
+    VideoFrameExchange *getVideoFrames() noexcept { return nullptr; }
+
+    //! @brief Gets the ring which queues sound samples for the host, or
+    //! nullptr if the hardware has no sound output.
+    SoundSampleRing *getSoundSamples() noexcept { return nullptr; }
+
     // Operations
+    //! @brief Records that the host has written directly to physical memory,
+    //! which has no effect as the hardware has no video output.
+    void markHostWrite(uint32_t /*physAddr*/, uint32_t /*byteCount*/) noexcept {}
+
     //! @brief Updates the bits of the interrupt mask field.
     //! @param[in] mask The new pattern of bits to apply to the mask.
     //! @param[in] significantBits The bits describing which digits of mask
@@ -398,6 +494,31 @@ public:
     //! @brief Create a map of all writeable memory regions in the system,
     //! including ranges of addresses with fixed decoding logic.
     AddressMap createMasterWriteMap() { return _masterWriteMap; }
+
+    //! @brief Appends the guest interrupt and privilege state to a snapshot.
+    //! @param[in] snapshot The snapshot to append to.
+    void captureState(SystemSnapshot &snapshot) const
+    {
+        snapshot.writeValue(static_cast<uint8_t>(_irqStatus & IrqState::GuestIrqsMask));
+        snapshot.writeValue(_irqMask);
+        snapshot.writeValue(_isPriviledged);
+    }
+
+    //! @brief Restores state written by captureState().
+    //! @param[in] reader The object to read state from.
+    //! @note Host and debug interrupts are left as they are, so that a request
+    //! to stop made while the state was being changed isn't lost.
+    void restoreState(SnapshotReader &reader)
+    {
+        uint8_t guestIrqs = 0;
+
+        reader.readValue(guestIrqs);
+        reader.readValue(_irqMask);
+        reader.readValue(_isPriviledged);
+
+        _irqStatus = static_cast<uint8_t>((_irqStatus & IrqState::HostIrqsMask) |
+                                          (guestIrqs & IrqState::GuestIrqsMask));
+    }
 };
 
 }} // namespace Mo::Arm
@@ -0,0 +1,489 @@
+//! @file ArmEmu/HleHooks.cpp
+//! @brief The definition of a table of host functions which replace
+//! selected guest SWIs and routines, high level emulation.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <atomic>
+
+#include "ArmEmu/AddressMap.hpp"
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/HleHooks.hpp"
+#include "ArmEmu/SystemMetrics.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The mask to apply to a SWI instruction to extract the SWI number
+//! without the X bit.
+constexpr uint32_t SwiNumberMask = 0x00FDFFFF;
+
+//! @brief The mask to apply to an instruction to extract its condition code.
+constexpr uint32_t ConditionMask = 0xF0000000;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Encodes the identifier of a routine hook into a trap instruction.
+//! @param[in] hookId The index of the hook in the table.
+//! @param[in] displaced The instruction the trap replaces, whose condition
+//! code the trap shares.
+uint32_t encodeTrap(size_t hookId, uint32_t displaced)
+{
+    const uint32_t id = static_cast<uint32_t>(hookId);
+
+    return (displaced & ConditionMask) | HleHookTable::TrapBits |
+           ((id & 0xFFF0) << 4) | (id & 0x0F);
+}
+
+//! @brief Decodes the identifier of a routine hook from a trap instruction.
+size_t decodeTrap(uint32_t instruction)
+{
+    return ((instruction >> 4) & 0xFFF0) | (instruction & 0x0F);
+}
+
+//! @brief Finds the host memory backing a run of guest logical addresses.
+//! @param[in] system The system to query.
+//! @param[in] map The physical address map to search, which determines
+//! whether the memory is readable or writable.
+//! @param[in] logicalAddr The first logical address of the run.
+//! @param[in] length The count of bytes required.
+//! @param[out] spanLength Receives the count of bytes which can be accessed
+//! through the pointer returned, up to the end of the page.
+//! @return A pointer to the host memory or nullptr if the address doesn't
+//! map to RAM or ROM.
+uint8_t *findHostSpan(IArmSystem *system, const AddressMap &map,
+                      uint32_t logicalAddr, uint32_t length,
+                      uint32_t &spanLength)
+{
+    uint8_t *span = nullptr;
+    PageMapping mapping;
+    IAddressRegionPtr region = nullptr;
+    uint32_t offset = 0;
+    uint32_t remainingLength = 0;
+
+    spanLength = 0;
+
+    if (system->logicalToPhysicalAddress(logicalAddr, mapping) &&
+        (mapping.Access & PageMapping::IsPresent))
+    {
+        const uint32_t pageOffset = logicalAddr - mapping.VirtualBaseAddr;
+
+        if (map.tryFindRegion(mapping.PageBaseAddr + pageOffset, region,
+                              offset, remainingLength) &&
+            (region->getType() == RegionType::HostBlock))
+        {
+            span = reinterpret_cast<uint8_t *>(static_cast<IHostBlockPtr>(region)->getHostAddress()) +
+                   offset;
+            spanLength = std::min({ length, mapping.PageSize - pageOffset,
+                                    remainingLength });
+        }
+    }
+
+    return span;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// HleCall Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Gets a pointer to host memory which holds guest memory which can
+//! be read, for hooks which process guest memory directly.
+//! @param[in] logicalAddr The logical address of the first byte to read.
+//! @param[in] length The count of bytes to read.
+//! @param[out] spanLength Receives the count of bytes which can be read
+//! through the pointer returned, which may be less than length if the
+//! run crosses a page boundary.
+//! @return A pointer to the first byte or nullptr if the address isn't
+//! mapped to RAM or ROM.
+const uint8_t *HleCall::getReadableSpan(uint32_t logicalAddr, uint32_t length,
+                                        uint32_t &spanLength) const
+{
+    return findHostSpan(System, System->getReadAddresses(), logicalAddr,
+                        length, spanLength);
+}
+
+//! @brief Gets a pointer to host memory which holds guest memory which can
+//! be written, for hooks which process guest memory directly.
+//! @param[in] logicalAddr The logical address of the first byte to write.
+//! @param[in] length The count of bytes to write.
+//! @param[out] spanLength Receives the count of bytes which can be written
+//! through the pointer returned, which may be less than length if the
+//! run crosses a page boundary.
+//! @return A pointer to the first byte or nullptr if the address isn't
+//! mapped to RAM.
+//! @note The hook must call releaseWritableSpan() once it has finished
+//! writing through the pointer.
+uint8_t *HleCall::getWritableSpan(uint32_t logicalAddr, uint32_t length,
+                                  uint32_t &spanLength) const
+{
+    return findHostSpan(System, System->getWriteAddresses(), logicalAddr,
+                        length, spanLength);
+}
+
+//! @brief Records that a hook has finished writing to guest memory through
+//! a pointer returned by getWritableSpan(), so that the hardware can
+//! refresh any state derived from it, such as the display.
+//! @param[in] logicalAddr The logical address passed to getWritableSpan().
+//! @param[in] bytesWritten The count of bytes written through the span.
+void HleCall::releaseWritableSpan(uint32_t logicalAddr,
+                                  uint32_t bytesWritten) const
+{
+    PageMapping mapping;
+
+    if ((bytesWritten > 0) &&
+        System->logicalToPhysicalAddress(logicalAddr, mapping))
+    {
+        const uint32_t pageOffset = logicalAddr - mapping.VirtualBaseAddr;
+
+        System->markHostWrite(mapping.PageBaseAddr + pageOffset, bytesWritten);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HleHookTable Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes a hook and accumulates its statistics.
+struct HleHookTable::Hook
+{
+    std::string Name;
+    HleHookFn Function;
+    uintptr_t Context;
+    uint32_t SwiNumber;
+    uint32_t Address;
+    uint32_t DisplacedInstruction;
+    bool IsSwiHook;
+    std::atomic<bool> IsEnabled;
+    std::atomic<uint64_t> CallCount;
+    std::atomic<uint64_t> DeclinedCount;
+    std::atomic<uint64_t> BypassedCount;
+    std::atomic<uint64_t> HostTimeNs;
+
+    Hook(std::string_view name, HleHookFn fn, uintptr_t context) :
+        Name(name),
+        Function(fn),
+        Context(context),
+        SwiNumber(0),
+        Address(0),
+        DisplacedInstruction(0),
+        IsSwiHook(false),
+        IsEnabled(true),
+        CallCount(0),
+        DeclinedCount(0),
+        BypassedCount(0),
+        HostTimeNs(0)
+    {
+    }
+};
+
+//! @brief Constructs an empty table which isn't connected to a system.
+HleHookTable::HleHookTable() :
+    _system(nullptr)
+{
+}
+
+//! @brief Disposes of the hooks, routines remain patched.
+HleHookTable::~HleHookTable()
+{
+}
+
+//! @brief Gets the count of hooks added, the upper limit of hook identifiers.
+size_t HleHookTable::getHookCount() const
+{
+    return _hooks.size();
+}
+
+//! @brief Gets the configuration and activity of a hook.
+//! @param[in] hookId The identifier returned when the hook was added.
+HleHookStatistics HleHookTable::getStatistics(size_t hookId) const
+{
+    HleHookStatistics stats;
+    const Hook &hook = *_hooks.at(hookId);
+
+    stats.Name = hook.Name;
+    stats.SwiNumber = hook.SwiNumber;
+    stats.Address = hook.Address;
+    stats.IsSwiHook = hook.IsSwiHook;
+    stats.IsEnabled = hook.IsEnabled.load(std::memory_order_relaxed);
+    stats.CallCount = hook.CallCount.load(std::memory_order_relaxed);
+    stats.DeclinedCount = hook.DeclinedCount.load(std::memory_order_relaxed);
+    stats.BypassedCount = hook.BypassedCount.load(std::memory_order_relaxed);
+    stats.HostTimeNs = hook.HostTimeNs.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+//! @brief Determines whether a hook is called in place of the guest
+//! implementation.
+//! @param[in] hookId The identifier returned when the hook was added.
+bool HleHookTable::isHookEnabled(size_t hookId) const
+{
+    return _hooks.at(hookId)->IsEnabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Sets whether a hook is called in place of the guest
+//! implementation.
+//! @param[in] hookId The identifier returned when the hook was added.
+//! @param[in] isEnabled True to call the hook, false to always execute the
+//! guest implementation, to compare the results of the two.
+void HleHookTable::setHookEnabled(size_t hookId, bool isEnabled)
+{
+    _hooks.at(hookId)->IsEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+//! @brief Sets the statistics of all hooks back to zero.
+void HleHookTable::resetStatistics()
+{
+    for (const HookUPtr &hook : _hooks)
+    {
+        hook->CallCount.store(0, std::memory_order_relaxed);
+        hook->DeclinedCount.store(0, std::memory_order_relaxed);
+        hook->BypassedCount.store(0, std::memory_order_relaxed);
+        hook->HostTimeNs.store(0, std::memory_order_relaxed);
+    }
+}
+
+//! @brief Attempts to find the hook which replaces a SWI.
+//! @param[in] instruction The SWI instruction word, the condition code and
+//! X bit are ignored.
+//! @param[out] hookId Receives the identifier of the hook, if found.
+//! @retval true A hook replaces the SWI.
+//! @retval false The SWI should be executed by the guest.
+bool HleHookTable::tryFindSwiHook(uint32_t instruction, size_t &hookId) const
+{
+    bool isFound = false;
+
+    if (_swiHooks.empty() == false)
+    {
+        auto pos = _swiHooks.find(instruction & SwiNumberMask);
+
+        if (pos != _swiHooks.end())
+        {
+            hookId = pos->second;
+            isFound = true;
+        }
+    }
+
+    return isFound;
+}
+
+//! @brief Attempts to find the hook which placed a trap instruction.
+//! @param[in] address The logical address of the instruction.
+//! @param[in] instruction The instruction word, which matched TrapMask.
+//! @param[out] hookId Receives the identifier of the hook, if found.
+//! @retval true The instruction is a trap placed by a routine hook.
+//! @retval false The instruction wasn't placed by a hook, possibly it
+//! was copied elsewhere, and should be executed as normal.
+bool HleHookTable::tryFindRoutineHook(uint32_t address, uint32_t instruction,
+                                      size_t &hookId) const
+{
+    const size_t id = decodeTrap(instruction);
+    const bool isFound = (id < _hooks.size()) &&
+                         (_hooks[id]->IsSwiHook == false) &&
+                         (_hooks[id]->Address == address);
+
+    if (isFound)
+    {
+        hookId = id;
+    }
+
+    return isFound;
+}
+
+//! @brief Gets the guest instruction replaced by the trap of a routine hook.
+//! @param[in] hookId The identifier of the routine hook.
+uint32_t HleHookTable::getDisplacedInstruction(size_t hookId) const
+{
+    return _hooks[hookId]->DisplacedInstruction;
+}
+
+//! @brief Connects the table to the system whose memory hooks access.
+//! @param[in] system The system to connect to.
+void HleHookTable::connect(IArmSystem *system)
+{
+    _system = system;
+}
+
+//! @brief Attempts to add a hook which replaces a SWI.
+//! @param[in] name A name to identify the hook in statistics.
+//! @param[in] swiNumber The number of the SWI to replace, the hook is called
+//! for both the X and non-X forms.
+//! @param[in] fn The function which implements the SWI.
+//! @param[in] context A value to pass to the function.
+//! @param[out] hookId Receives the identifier of the new hook.
+//! @param[out] error Receives the reason the hook couldn't be added.
+//! @retval true The hook was added.
+//! @retval false The hook was invalid or the SWI already had a hook.
+//! @note Host filing system SWIs are serviced before hooks are considered.
+bool HleHookTable::tryAddSwiHook(std::string_view name, uint32_t swiNumber,
+                                 HleHookFn fn, uintptr_t context,
+                                 size_t &hookId, std::string &error)
+{
+    bool isAdded = false;
+    const uint32_t key = swiNumber & SwiNumberMask;
+
+    if (_swiHooks.find(key) != _swiHooks.end())
+    {
+        error = "The SWI is already replaced by a hook.";
+    }
+    else if (tryCreateHook(name, fn, context, error))
+    {
+        hookId = _hooks.size() - 1;
+
+        Hook &hook = *_hooks.back();
+        hook.SwiNumber = key;
+        hook.IsSwiHook = true;
+
+        _swiHooks[key] = static_cast<uint32_t>(hookId);
+        isAdded = true;
+    }
+
+    return isAdded;
+}
+
+//! @brief Attempts to add a hook which replaces a guest routine.
+//! @param[in] name A name to identify the hook in statistics.
+//! @param[in] address The logical address of the routine entry point or
+//! vector, which must be mapped to RAM or ROM.
+//! @param[in] fn The function which implements the routine. Execution
+//! continues at the address in R14 after the function completes.
+//! @param[in] context A value to pass to the function.
+//! @param[out] hookId Receives the identifier of the new hook.
+//! @param[out] error Receives the reason the hook couldn't be added.
+//! @retval true The hook was added and a trap placed at the address.
+//! @retval false The hook was invalid or the address couldn't be patched.
+//! @note The trap is placed immediately, so the address must already hold
+//! the routine, and the routine must stay at the same logical address.
+bool HleHookTable::tryAddRoutineHook(std::string_view name, uint32_t address,
+                                     HleHookFn fn, uintptr_t context,
+                                     size_t &hookId, std::string &error)
+{
+    bool isAdded = false;
+    uint32_t displaced = 0;
+
+    if (_system == nullptr)
+    {
+        error = "The hook table isn't connected to a system.";
+    }
+    else if (address & 3)
+    {
+        error = "The routine address isn't word-aligned.";
+    }
+    else if (readFromLogicalAddress(_system, address, &displaced,
+                                    sizeof(displaced)) != sizeof(displaced))
+    {
+        error = "The routine address isn't mapped.";
+    }
+    else if ((displaced & TrapMask) == TrapBits)
+    {
+        error = "The routine is already replaced by a hook.";
+    }
+    else if (tryCreateHook(name, fn, context, error))
+    {
+        const size_t id = _hooks.size() - 1;
+        const uint32_t trap = encodeTrap(id, displaced);
+        uint32_t patched = 0;
+
+        // Write through the read map so that routines in ROM can be patched.
+        writeToLogicalAddress(_system, address, &trap, sizeof(trap), true);
+        readFromLogicalAddress(_system, address, &patched, sizeof(patched));
+
+        if (patched == trap)
+        {
+            Hook &hook = *_hooks.back();
+            hook.Address = address;
+            hook.DisplacedInstruction = displaced;
+
+            hookId = id;
+            isAdded = true;
+        }
+        else
+        {
+            _hooks.pop_back();
+            error = "The routine address couldn't be patched.";
+        }
+    }
+
+    return isAdded;
+}
+
+//! @brief Calls a hook, if enabled, and updates its statistics.
+//! @param[in] hookId The identifier of the hook to call.
+//! @param[in,out] call The state of the processor, updated by the hook.
+//! @return The outcome of the call, HleResult::Declined if the hook is
+//! disabled.
+HleResult HleHookTable::callHook(size_t hookId, HleCall &call)
+{
+    Hook &hook = *_hooks[hookId];
+    HleResult result = HleResult::Declined;
+
+    if (hook.IsEnabled.load(std::memory_order_relaxed))
+    {
+        call.System = _system;
+
+        const uint64_t startTime = SystemCounters::getHostTimeNs();
+        result = hook.Function(call, hook.Context);
+        hook.HostTimeNs.fetch_add(SystemCounters::getHostTimeNs() - startTime,
+                                  std::memory_order_relaxed);
+
+        if (result == HleResult::Declined)
+        {
+            hook.DeclinedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            hook.CallCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        hook.BypassedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+//! @brief Appends a new hook to the table.
+//! @param[in] name A name to identify the hook in statistics.
+//! @param[in] fn The function which implements the hook.
+//! @param[in] context A value to pass to the function.
+//! @param[out] error Receives the reason the hook couldn't be created.
+//! @retval true The hook was appended to _hooks.
+//! @retval false The parameters were invalid or the table was full.
+bool HleHookTable::tryCreateHook(std::string_view name, HleHookFn fn,
+                                 uintptr_t context, std::string &error)
+{
+    bool isCreated = false;
+
+    if (fn == nullptr)
+    {
+        error = "No hook function was specified.";
+    }
+    else if (_hooks.size() >= MaxHookCount)
+    {
+        error = "The table holds the maximum count of hooks.";
+    }
+    else
+    {
+        _hooks.push_back(std::make_unique<Hook>(name, fn, context));
+        isCreated = true;
+    }
+
+    return isCreated;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
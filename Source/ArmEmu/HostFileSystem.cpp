@@ -0,0 +1,592 @@
+//! @file ArmEmu/HostFileSystem.cpp
+//! @brief The definition of an object which services a range of emulator-only
+//! SWIs giving guest code direct access to files in a host directory.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/HostFileSystem.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The bit in a SWI number which selects the form of the SWI which
+//! returns errors rather than raising them.
+constexpr uint32_t SwiXBit = 0x20000;
+
+//! @brief The mask to apply to a SWI instruction to extract the SWI number.
+constexpr uint32_t SwiNumberMask = 0x00FFFFFF;
+
+//! @brief The maximum count of bytes, including the terminator, in an
+//! object name passed by guest code.
+constexpr uint32_t MaxNameLength = 256;
+
+//! @brief The count of bytes copied between the host and guest memory at
+//! a time.
+constexpr uint32_t TransferBlockSize = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Converts a RISC OS object name to a host path relative to the
+//! root of the host filing system.
+//! @param[in] name The null terminated object name read from guest memory.
+//! @param[out] relativePath Receives the equivalent host path.
+//! @retval true The name was valid and has been converted.
+//! @retval false The name contained wildcards, special directories or
+//! characters which can't be represented on the host.
+bool tryConvertGuestName(const char *name, std::filesystem::path &relativePath)
+{
+    bool isValid = true;
+    std::string component;
+
+    relativePath.clear();
+
+    // Skip the root directory specifier, if any.
+    if (name[0] == '$')
+    {
+        name += (name[1] == '.') ? 2 : 1;
+    }
+
+    for (const char *next = name; isValid; ++next)
+    {
+        const char ch = *next;
+
+        if ((ch == '.') || (ch == '\0'))
+        {
+            // Reject empty components and any which refer to special
+            // directories on either side.
+            if (component.empty() || (component == ".") || (component == "..") ||
+                ((component.length() == 1) &&
+                 (std::strchr("^@%&\\", component.front()) != nullptr)))
+            {
+                isValid = (ch == '\0') && (next == name);
+            }
+            else
+            {
+                relativePath /= component;
+                component.clear();
+            }
+
+            if (ch == '\0')
+            {
+                break;
+            }
+        }
+        else if ((static_cast<uint8_t>(ch) < 0x20) ||
+                 (std::strchr(":\\*#\"|<>", ch) != nullptr))
+        {
+            // Wildcards and characters special to the host are rejected.
+            isValid = false;
+        }
+        else
+        {
+            // The roles of '/' and '.' are swapped between RISC OS and
+            // the host.
+            component.push_back((ch == '/') ? '.' : ch);
+        }
+    }
+
+    return isValid;
+}
+
+//! @brief Converts the name of a host object to the equivalent RISC OS name.
+//! @param[in] hostName The name of a directory entry on the host.
+//! @return The RISC OS form of the name or an empty string if the name
+//! can't be represented.
+std::string convertHostName(const std::string &hostName)
+{
+    std::string guestName;
+    guestName.reserve(hostName.length());
+
+    for (char ch : hostName)
+    {
+        if ((static_cast<uint8_t>(ch) < 0x20) || (ch == '/'))
+        {
+            guestName.clear();
+            break;
+        }
+
+        guestName.push_back((ch == '.') ? '/' : ch);
+    }
+
+    return guestName;
+}
+
+//! @brief Converts a 64-bit length to a 32-bit register value.
+uint32_t clampLength(uintmax_t length)
+{
+    return static_cast<uint32_t>(std::min<uintmax_t>(length, UINT32_MAX));
+}
+
+//! @brief Determines the error to report when a file operation can't find
+//! a file.
+//! @param[in] hostPath The path to the object which isn't a file.
+HostFsError getFileTypeError(const std::filesystem::path &hostPath)
+{
+    std::error_code error;
+
+    return std::filesystem::is_directory(hostPath, error) ? HostFsError::WrongType :
+                                                            HostFsError::NotFound;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// HostFileSystem Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a host filing system which isn't connected to a
+//! system and so doesn't service any SWIs.
+HostFileSystem::HostFileSystem() :
+    _system(nullptr)
+{
+}
+
+//! @brief Determines whether SWIs should be serviced by the object.
+bool HostFileSystem::isPresent() const
+{
+    return _system != nullptr;
+}
+
+//! @brief Gets the host directory which guest objects are relative to.
+const std::filesystem::path &HostFileSystem::getRootPath() const
+{
+    return _rootPath;
+}
+
+//! @brief Determines whether a SWI instruction calls the host filing system.
+//! @param[in] instruction The SWI instruction word, the condition code and
+//! X bit are ignored.
+bool HostFileSystem::isHostSwi(uint32_t instruction)
+{
+    return (((instruction & SwiNumberMask & ~SwiXBit) - SwiBase) < SwiChunkSize);
+}
+
+//! @brief Connects the object to the emulated system to service SWIs for.
+//! @param[in] system The system whose memory will be accessed.
+//! @param[in] rootPath The host directory which guest objects are relative
+//! to. An empty path leaves the object disconnected.
+void HostFileSystem::connect(IArmSystem *system, const std::filesystem::path &rootPath)
+{
+    std::error_code error;
+
+    _rootPath = rootPath.empty() ? rootPath :
+                                   std::filesystem::weakly_canonical(rootPath, error);
+    _system = (_rootPath.empty() || error) ? nullptr : system;
+}
+
+//! @brief Services a host filing system SWI.
+//! @param[in] instruction The SWI instruction word which was executed,
+//! identified by isHostSwi().
+//! @param[in,out] args The values of R0-R4 on entry to the SWI, updated with
+//! the results of the operation.
+//! @retval true The operation succeeded.
+//! @retval false The operation failed and R0 has been set to a HostFsError
+//! value. The V flag should be set.
+bool HostFileSystem::service(uint32_t instruction, uint32_t (&args)[ArgumentCount])
+{
+    const uint32_t operation = (instruction & SwiNumberMask & ~SwiXBit) - SwiBase;
+    HostFsError error = HostFsError::None;
+    std::filesystem::path hostPath;
+    std::error_code hostError;
+
+    if (operation >= static_cast<uint32_t>(HostFsOperation::Max))
+    {
+        error = HostFsError::BadOperation;
+    }
+    else if (tryReadName(args[0], hostPath, error))
+    {
+        const bool isRoot = (hostPath == _rootPath);
+
+        switch (static_cast<HostFsOperation>(operation))
+        {
+        case HostFsOperation::ReadInfo:
+            error = readInfo(hostPath, args);
+            break;
+
+        case HostFsOperation::Load:
+            error = readBlock(hostPath, args, 0, true);
+            break;
+
+        case HostFsOperation::Save:
+            error = isRoot ? HostFsError::BadName :
+                             writeBlock(hostPath, args, 0, true);
+            break;
+
+        case HostFsOperation::ReadBlock:
+            error = readBlock(hostPath, args, args[3], false);
+            break;
+
+        case HostFsOperation::WriteBlock:
+            error = isRoot ? HostFsError::BadName :
+                             writeBlock(hostPath, args, args[3], false);
+            break;
+
+        case HostFsOperation::Delete:
+            if (isRoot)
+            {
+                error = HostFsError::BadName;
+            }
+            else if (isStorageHeld())
+            {
+                // Report the result without removing the object.
+                if (std::filesystem::exists(hostPath, hostError) == false)
+                {
+                    error = hostError ? HostFsError::HostError : HostFsError::NotFound;
+                }
+            }
+            else if (std::filesystem::remove(hostPath, hostError) == false)
+            {
+                error = hostError ? HostFsError::HostError : HostFsError::NotFound;
+            }
+            break;
+
+        case HostFsOperation::CreateDirectory:
+            if (std::filesystem::is_directory(hostPath, hostError) == false)
+            {
+                if (std::filesystem::exists(hostPath, hostError))
+                {
+                    error = HostFsError::WrongType;
+                }
+                else if (std::filesystem::is_directory(hostPath.parent_path(),
+                                                       hostError) == false)
+                {
+                    error = HostFsError::NotFound;
+                }
+                else if ((isStorageHeld() == false) &&
+                         (std::filesystem::create_directory(hostPath, hostError) == false))
+                {
+                    error = HostFsError::HostError;
+                }
+            }
+            break;
+
+        case HostFsOperation::ReadDirectory:
+            error = readDirectory(hostPath, args);
+            break;
+
+        default:
+            error = HostFsError::BadOperation;
+            break;
+        }
+    }
+
+    if (error != HostFsError::None)
+    {
+        args[0] = static_cast<uint32_t>(error);
+    }
+
+    return error == HostFsError::None;
+}
+
+//! @brief Determines whether changes to host files should be withheld
+//! because the system is holding back storage output.
+bool HostFileSystem::isStorageHeld() const
+{
+    return (_system->getHeldOutputs() & HeldOutput::Storage) != 0;
+}
+
+//! @brief Reads an object name from guest memory and converts it to a host
+//! path.
+//! @param[in] address The logical address of the null terminated name.
+//! @param[out] hostPath Receives the full path to the host object.
+//! @param[out] error Receives the reason the name couldn't be converted.
+//! @retval true The name was converted and refers to an object within the
+//! root directory.
+//! @retval false The name couldn't be read or was invalid.
+bool HostFileSystem::tryReadName(uint32_t address, std::filesystem::path &hostPath,
+                                 HostFsError &error) const
+{
+    char name[MaxNameLength];
+    std::filesystem::path relativePath;
+    const uint32_t length = readFromLogicalAddress(_system, address, name,
+                                                   MaxNameLength);
+
+    if (std::memchr(name, '\0', length) == nullptr)
+    {
+        error = (length < MaxNameLength) ? HostFsError::BadAddress :
+                                           HostFsError::BadName;
+    }
+    else if (tryConvertGuestName(name, relativePath) == false)
+    {
+        error = HostFsError::BadName;
+    }
+    else if (relativePath.empty())
+    {
+        hostPath = _rootPath;
+    }
+    else
+    {
+        // Ensure links don't lead outside the root directory.
+        std::error_code hostError;
+        hostPath = std::filesystem::weakly_canonical(_rootPath / relativePath,
+                                                     hostError);
+        const std::filesystem::path rootRelative = hostPath.lexically_relative(_rootPath);
+
+        if (hostError || rootRelative.empty() || (rootRelative == ".") ||
+            (*rootRelative.begin() == std::filesystem::path("..")))
+        {
+            error = HostFsError::BadName;
+        }
+    }
+
+    return error == HostFsError::None;
+}
+
+//! @brief Services HostFsOperation::ReadInfo.
+//! @param[in] hostPath The path to the object to query.
+//! @param[in,out] args The SWI registers to receive the object type and
+//! length.
+//! @return HostFsError::None, objects which don't exist aren't an error.
+HostFsError HostFileSystem::readInfo(const std::filesystem::path &hostPath,
+                                     uint32_t (&args)[ArgumentCount]) const
+{
+    std::error_code error;
+    const std::filesystem::file_status status = std::filesystem::status(hostPath, error);
+    HostFsObjectType type = HostFsObjectType::NotFound;
+    uint32_t length = 0;
+
+    if (std::filesystem::is_regular_file(status))
+    {
+        type = HostFsObjectType::File;
+        length = clampLength(std::filesystem::file_size(hostPath, error));
+    }
+    else if (std::filesystem::is_directory(status))
+    {
+        type = HostFsObjectType::Directory;
+    }
+
+    args[1] = static_cast<uint32_t>(type);
+    args[2] = length;
+
+    return HostFsError::None;
+}
+
+//! @brief Services HostFsOperation::Load and HostFsOperation::ReadBlock.
+//! @param[in] hostPath The path to the file to read.
+//! @param[in,out] args The SWI registers holding the guest address and
+//! byte count, updated with the count of bytes read.
+//! @param[in] offset The offset of the first byte of the file to read.
+//! @param[in] isWholeFile True to also return the length of the file in R3.
+//! @return The reason the operation failed or HostFsError::None.
+HostFsError HostFileSystem::readBlock(const std::filesystem::path &hostPath,
+                                      uint32_t (&args)[ArgumentCount],
+                                      uint64_t offset, bool isWholeFile)
+{
+    HostFsError error = HostFsError::None;
+    std::error_code hostError;
+    uint32_t bytesRead = 0;
+
+    if (std::filesystem::is_regular_file(hostPath, hostError) == false)
+    {
+        error = getFileTypeError(hostPath);
+    }
+    else
+    {
+        const uintmax_t fileSize = std::filesystem::file_size(hostPath, hostError);
+        std::ifstream input(hostPath, std::ios::binary);
+
+        if (hostError || !input.seekg(static_cast<std::streamoff>(offset)))
+        {
+            error = HostFsError::HostError;
+        }
+        else
+        {
+            const uint32_t byteCount = (offset < fileSize) ?
+                clampLength(std::min<uintmax_t>(args[2], fileSize - offset)) : 0;
+
+            _buffer.resize(TransferBlockSize);
+
+            while ((bytesRead < byteCount) && (error == HostFsError::None))
+            {
+                const uint32_t blockSize = std::min(byteCount - bytesRead,
+                                                    TransferBlockSize);
+
+                if (!input.read(reinterpret_cast<char *>(_buffer.data()), blockSize))
+                {
+                    error = HostFsError::HostError;
+                }
+                else if (writeToLogicalAddress(_system, args[1] + bytesRead,
+                                               _buffer.data(), blockSize) != blockSize)
+                {
+                    error = HostFsError::BadAddress;
+                }
+                else
+                {
+                    bytesRead += blockSize;
+                }
+            }
+        }
+
+        if (isWholeFile)
+        {
+            args[3] = clampLength(fileSize);
+        }
+    }
+
+    args[2] = bytesRead;
+
+    return error;
+}
+
+//! @brief Services HostFsOperation::Save and HostFsOperation::WriteBlock.
+//! @param[in] hostPath The path to the file to write.
+//! @param[in,out] args The SWI registers holding the guest address and
+//! byte count, updated with the count of bytes written.
+//! @param[in] offset The offset within the file to write the first byte.
+//! @param[in] isReplaced True to discard any existing contents of the file.
+//! @return The reason the operation failed or HostFsError::None.
+//! @note While storage output is held the guest data is read, but the file
+//! is left untouched.
+HostFsError HostFileSystem::writeBlock(const std::filesystem::path &hostPath,
+                                       uint32_t (&args)[ArgumentCount],
+                                       uint64_t offset, bool isReplaced)
+{
+    HostFsError error = HostFsError::None;
+    std::error_code hostError;
+    uint32_t bytesWritten = 0;
+
+    if (std::filesystem::is_directory(hostPath, hostError))
+    {
+        error = HostFsError::WrongType;
+    }
+    else if (std::filesystem::is_directory(hostPath.parent_path(), hostError) == false)
+    {
+        error = HostFsError::NotFound;
+    }
+    else
+    {
+        const bool isHeld = isStorageHeld();
+        std::fstream output;
+
+        if (isHeld == false)
+        {
+            // Existing contents are only kept when writing part of a file.
+            std::ios::openmode mode = std::ios::binary | std::ios::out;
+
+            if ((isReplaced == false) && std::filesystem::exists(hostPath, hostError))
+            {
+                mode |= std::ios::in;
+            }
+
+            output.open(hostPath, mode);
+
+            if (!output.seekp(static_cast<std::streamoff>(offset)))
+            {
+                error = HostFsError::HostError;
+            }
+        }
+
+        _buffer.resize(TransferBlockSize);
+
+        while ((bytesWritten < args[2]) && (error == HostFsError::None))
+        {
+            const uint32_t blockSize = std::min(args[2] - bytesWritten,
+                                                TransferBlockSize);
+
+            if (readFromLogicalAddress(_system, args[1] + bytesWritten,
+                                       _buffer.data(), blockSize) != blockSize)
+            {
+                error = HostFsError::BadAddress;
+            }
+            else if ((isHeld == false) &&
+                     !output.write(reinterpret_cast<const char *>(_buffer.data()),
+                                   blockSize))
+            {
+                error = HostFsError::HostError;
+            }
+            else
+            {
+                bytesWritten += blockSize;
+            }
+        }
+    }
+
+    args[2] = bytesWritten;
+
+    return error;
+}
+
+//! @brief Services HostFsOperation::ReadDirectory.
+//! @param[in] hostPath The path to the directory to read.
+//! @param[in,out] args The SWI registers holding the guest buffer and
+//! first entry to read, updated with the entries read.
+//! @return The reason the operation failed or HostFsError::None.
+//! @note Host objects whose names can't be represented in RISC OS are
+//! skipped.
+HostFsError HostFileSystem::readDirectory(const std::filesystem::path &hostPath,
+                                          uint32_t (&args)[ArgumentCount])
+{
+    HostFsError error = HostFsError::None;
+    std::error_code hostError;
+    std::vector<std::string> names;
+
+    if (std::filesystem::is_directory(hostPath, hostError) == false)
+    {
+        error = std::filesystem::exists(hostPath, hostError) ? HostFsError::WrongType :
+                                                               HostFsError::NotFound;
+    }
+    else
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(hostPath, hostError))
+        {
+            std::string name = convertHostName(entry.path().filename().string());
+
+            if (name.empty() == false)
+            {
+                names.push_back(std::move(name));
+            }
+        }
+
+        // Sort so that the index of an entry doesn't change between calls.
+        std::sort(names.begin(), names.end());
+
+        uint32_t index = args[3];
+        uint32_t nameCount = 0;
+        _buffer.clear();
+
+        while ((index < names.size()) &&
+               ((_buffer.size() + names[index].length() + 1) <= args[2]))
+        {
+            const std::string &name = names[index++];
+
+            _buffer.insert(_buffer.end(), name.begin(), name.end());
+            _buffer.push_back(0);
+            ++nameCount;
+        }
+
+        const uint32_t byteCount = static_cast<uint32_t>(_buffer.size());
+
+        if (writeToLogicalAddress(_system, args[1], _buffer.data(),
+                                  byteCount) != byteCount)
+        {
+            error = HostFsError::BadAddress;
+        }
+        else
+        {
+            args[3] = (index < names.size()) ? index : UINT32_MAX;
+            args[4] = nameCount;
+        }
+    }
+
+    return error;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -13,6 +13,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <stdlib.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "Ag/Core/Binary.hpp"
 #include "Ag/Core/Utils.hpp"
 
@@ -22,20 +25,38 @@
 #include "ArmEmu/IOC.hpp"
 #include "ArmEmu/HostMessageID.hpp"
 #include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
 
 namespace Mo {
 namespace Arm {
 
+//! @brief The IRQ raised by the IR pin, connected to the VIDC vertical
+//! flyback signal.
+constexpr uint8_t VerticalFlybackIrq = 3;
+
+//! @brief The IRQ raised by MEMC when sound DMA moves to the next buffer.
+constexpr uint8_t SoundBufferIrq = 9;
+
 //! @brief The IRQ raised when transmission of a KART byte has completed.
 constexpr uint8_t KartTxIrq = 14;
 
 //! @brief The IRQ raised when the KART has received a byte.
 constexpr uint8_t KartRxIrq = 15;
 
+//! @brief The count of times per second of emulated time that changes to
+//! inputs made by the host are applied.
+constexpr uint64_t HostInputPollsPerSecond = 1000;
+
+//! @brief The bit of a queued host pin change holding the new pin state.
+constexpr uint8_t HostPinStateBit = 0x80;
+
+//! @brief The bits of a queued host pin change holding the pin number.
+constexpr uint8_t HostPinIdMask = 0x3F;
+
 ////////////////////////////////////////////////////////////////////////////////
 // IocIrqState Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
-//! @brief Constructs an object which holds state shared between threads.
+//! @brief Constructs an object which holds the interrupt state of the IOC.
 IocIrqState::IocIrqState() :
     _irqStatus(0),
     _irqMask(0xFFFF),
@@ -52,14 +73,14 @@ IocIrqState::IocIrqState() :
 //! @retval false No IRQs are pending.
 bool IocIrqState::getIrqPinState() const
 {
-    return ((_irqStatus.load() | 0x80) & ~_irqMask.load()) != 0;
+    return ((_irqStatus | 0x80) & ~_irqMask) != 0;
 }
 
 //! @brief Gets the current state of all pending interrupts, ignoring masks.
 //! @return A bitfield describing which interrupts are pending.
 uint16_t IocIrqState::getUnmaskedIrqState() const
 {
-    return _irqStatus.load() | 0x80;
+    return _irqStatus | 0x80;
 }
 
 //! @brief Gets the masked state of interrupts, i.e. which unmasked interrupts
@@ -67,14 +88,14 @@ uint16_t IocIrqState::getUnmaskedIrqState() const
 //! @return A bitfield describing which unmasked interrupts are pending.
 uint16_t IocIrqState::getMaskedIrqState() const
 {
-    return (_irqStatus.load() | 0x80) & ~_irqMask.load();
+    return (_irqStatus | 0x80) & ~_irqMask;
 }
 
 //! @brief Gets the current interrupt mask.
 //! @return A bit field indicating which interrupts are currently masked.
 uint16_t IocIrqState::getIrqMask() const
 {
-    return _irqMask.load();
+    return _irqMask;
 }
 
 //! @brief Sets the contents IRQ Mask register A.
@@ -83,7 +104,7 @@ uint16_t IocIrqState::getIrqMask() const
 //! @retval false No unmasked interrupts are pending.
 bool IocIrqState::setIrqMaskLow(uint8_t mask)
 {
-    _irqMask.store((_irqMask.load() & 0xFF00) | mask);
+    _irqMask = static_cast<uint16_t>((_irqMask & 0xFF00) | mask);
 
     return getIrqPinState();
 }
@@ -94,7 +115,7 @@ bool IocIrqState::setIrqMaskLow(uint8_t mask)
 //! @retval false No unmasked interrupts are pending.
 bool IocIrqState::setIrqMaskHigh(uint8_t mask)
 {
-    _irqMask.store((_irqMask.load() & 0xFF) | (static_cast<uint16_t>(mask) << 8));
+    _irqMask = static_cast<uint16_t>((_irqMask & 0xFF) | (static_cast<uint16_t>(mask) << 8));
 
     return getIrqPinState();
 }
@@ -118,7 +139,7 @@ bool IocIrqState::setIrqState(uint8_t irq, bool state)
 //! @retval false No FIRQs are pending.
 bool IocIrqState::getFirqPinState() const
 {
-    return (_firqStatus.load() & _firqMask.load()) != 0;
+    return (_firqStatus & _firqMask) != 0;
 }
 
 //! @brief Gets the current state of all pending fast interrupts,
@@ -126,7 +147,7 @@ bool IocIrqState::getFirqPinState() const
 //! @return A bitfield describing which fast interrupts are pending.
 uint8_t IocIrqState::getUnmaskedFirqState() const
 {
-    return _firqStatus.load();
+    return _firqStatus;
 }
 
 //! @brief Gets the masked state of fast interrupts, i.e. which unmasked
@@ -134,13 +155,13 @@ uint8_t IocIrqState::getUnmaskedFirqState() const
 //! @return A bitfield describing which unmasked fast interrupts are pending.
 uint8_t IocIrqState::getMaskedFirqState() const
 {
-    return _firqStatus.load() & ~_firqMask.load();
+    return _firqStatus & ~_firqMask;
 }
 
 //! @brief Gets a bitfield defining which fast interrupts are masked.
 uint8_t IocIrqState::getFirqMask() const
 {
-    return _firqMask.load();
+    return _firqMask;
 }
 
 //! @brief Sets the contents of the FIRQ Mask register.
@@ -151,7 +172,7 @@ bool IocIrqState::setFirqMask(uint8_t mask)
 {
     bool oldFirqState = getFirqPinState();
 
-    _firqMask.store(mask);
+    _firqMask = mask;
 
     return (oldFirqState == false) && getFirqPinState();
 }
@@ -178,14 +199,14 @@ uint8_t IocIrqState::readCtrlRegister() const
     // is enabled.
     // Bit 6 is the state of the IF latched interrupt (IRQ register A, bit 2).
     // Bit 7 is the state of the IR latched interrupt (IRQ register A, bit 3).
-    return static_cast<uint8_t>((_ctrlInput.load() & 0x3F) | ((_irqStatus.load() & 0x0C) << 4));
+    return static_cast<uint8_t>((_ctrlInput & 0x3F) | ((_irqStatus & 0x0C) << 4));
 }
 
 //! @brief Processes a write to the IOC control register by the CPU.
 //! @param[in] value The byte written to the control register hardware address.
 void IocIrqState::writeCtrlRegister(uint8_t value)
 {
-    _ctrlState.store((value & 0x3F) | 0xC0);
+    _ctrlState = static_cast<uint8_t>((value & 0x3F) | 0xC0);
 }
 
 //! @brief Get the output state of IOC pins C[0:5], these will either be driven
@@ -202,9 +223,9 @@ uint8_t IocIrqState::getControlPinOutputState() const
     // When written LOW the output pin is driven LOW.
     // Those outputs are open-drain, and if programmed HIGH the pin is undriven
     // and may be treated as input.
-    uint8_t outputMask = _ctrlState.load() & 0x3F;
+    uint8_t outputMask = _ctrlState & 0x3F;
 
-    return _ctrlOutput.load() & outputMask;
+    return _ctrlOutput & outputMask;
 }
 
 //! @brief Sets the input state of one of the control lines C0-C5.
@@ -218,7 +239,7 @@ bool IocIrqState::setControlPinInputState(uint8_t pin, bool state)
 
         // Only bits C[3:5] are connected to FIRQs.
         // Update the _firqStatus based on the new values of the control pins.
-        _firqStatus &= (_firqStatus & ~0x38) | (_ctrlInput & 0x38);
+        _firqStatus = static_cast<uint8_t>((_firqStatus & ~0x38) | (_ctrlInput & 0x38));
     }
 
     return getFirqPinState();
@@ -264,7 +285,7 @@ bool IocIrqState::raiseIrq(uint8_t id)
 //    if (id < 8)
 //    {
 //        state = _firqStatus |= static_cast<uint8_t>(1 << id);
-//        state &= ~_firqMask.load();
+//        state &= ~_firqMask;
 //    }
 //
 //    // Raise an interrupt if an unmasked interrupt is in progress.
@@ -280,10 +301,11 @@ IOC::IOC(MemcHardware &parent) :
     _synchronisedData(IocSyncStateTraits::create()),
     _parent(parent),
     _context(nullptr),
-    _irqState(&_synchronisedData->InterruptState),
     _keyboard(nullptr),
+    _hostInputPollTicks(0),
     _kartRxQueue(&_synchronisedData->RxQueue),
     _kartTxQueue(&_synchronisedData->TxQueue),
+    _hostPinQueue(&_synchronisedData->PinQueue),
     _kartRxByte(0)
 {
     // Enable HW counters 0 and 1 to raise interrupts.
@@ -303,23 +325,57 @@ IOC::IOC(MemcHardware &parent) :
     // Use HW counter 3 to service the KART interface.
     _kartCounter.setTriggerCallback(IOC::onKartCounterReachesZero,
                                     reinterpret_cast<uintptr_t>(this));
+
+    // Periodically apply changes to input pins made by the host.
+    Ag::zeroFill(_hostInputTask);
+    _hostInputTask.Task = IOC::onPollHostInput;
+    _hostInputTask.Context = reinterpret_cast<uintptr_t>(this);
 }
 
 //! @brief Gets the state of the 5 control pins.
+//! @note This member function should only be called on the emulation thread.
 uint8_t IOC::getCtrlPinInputState() const
 {
-    return _irqState->getControlPinOutputState();
+    return _irqState.getControlPinOutputState();
 }
 
+//! @brief Sets the input state of one of the control lines C0-C5 from the
+//! host system.
+//! @param[in] pin The 0-based index of the pin state to update.
+//! @param[in] state The new state of the pin.
+//! @note The change is queued and applied by the emulation thread the next
+//! time it polls for host input. Only a single host thread should call this
+//! member function.
 void IOC::setCtrlPinInputState(uint8_t pin, bool state)
 {
-    _irqState->setControlPinInputState(pin, state);
+    if (pin < 6)
+    {
+        _hostPinQueue->enqueue(static_cast<uint8_t>(pin | (state ? HostPinStateBit : 0)));
+    }
 }
 
 //! @brief Raises the POR interrupt as if the system had just been switched on..
 void IOC::powerOnReset()
 {
-    _parent.setGuestIrq(_irqState->raiseIrq(4));
+    _parent.setGuestIrq(_irqState.raiseIrq(4));
+}
+
+//! @brief Raises the IR interrupt, signalled by VIDC at the start of vertical
+//! flyback.
+void IOC::raiseVerticalFlyback()
+{
+    _parent.setGuestIrq(_irqState.raiseIrq(VerticalFlybackIrq));
+}
+
+//! @brief Sets the state of the SIRQ interrupt, signalled by MEMC when the
+//! next sound buffer has been started.
+//! @param[in] state True to raise the interrupt, false to clear it.
+void IOC::setSoundBufferInterrupt(bool state)
+{
+    _irqState.setIrqState(SoundBufferIrq, state);
+
+    // Other interrupts may still be pending after this one is cleared.
+    _parent.setGuestIrq(_irqState.getIrqPinState());
 }
 
 //! @brief Activates one of the IL pins, i.e. drives it low.
@@ -334,18 +390,18 @@ void IOC::setInterruptLow(uint8_t ilNo, bool state)
     if (ilNo == 0)
     {
         // IL[0] affects IRQ-8 and FIRQ-6.
-        _parent.setGuestIrq(_irqState->setIrqState(8, !state));
-        _parent.setGuestFastIrq(_irqState->setFirqState(6, !state));
+        _parent.setGuestIrq(_irqState.setIrqState(8, !state));
+        _parent.setGuestFastIrq(_irqState.setFirqState(6, !state));
     }
     else if (ilNo < 6)
     {
         // IL[1:5].
-        _parent.setGuestIrq(_irqState->setIrqState(ilNo + 8, !state));
+        _parent.setGuestIrq(_irqState.setIrqState(ilNo + 8, !state));
     }
     else if (ilNo < 8)
     {
         // IL[6:7].
-        _parent.setGuestIrq(_irqState->setIrqState(ilNo - 6, !state));
+        _parent.setGuestIrq(_irqState.setIrqState(ilNo - 6, !state));
     }
 }
 
@@ -358,7 +414,7 @@ void IOC::setFastHighInterrupt(uint8_t fhNo, bool state)
     if (fhNo < 2)
     {
         // The FH pins tragger FIRQ-0 and 1.
-        _parent.setGuestFastIrq(_irqState->setFirqState(fhNo, state));
+        _parent.setGuestFastIrq(_irqState.setFirqState(fhNo, state));
     }
 }
 
@@ -368,17 +424,19 @@ void IOC::setFastHighInterrupt(uint8_t fhNo, bool state)
 void IOC::setFastLowInterrupt(bool state)
 {
     // The FL pin is an active low triggering FIRQ-2
-    _parent.setGuestFastIrq(_irqState->setFirqState(2, !state));
+    _parent.setGuestFastIrq(_irqState.setFirqState(2, !state));
 }
 
 //! @brief Sets the input state of one of the control lines C0-C5.
 //! @param[in] ctrlLine The 0-based index of the pin state to update.
 //! @param[in] state The new state of the pin.
+//! @note This member function should only be called on the emulation thread,
+//! the host should use setCtrlPinInputState().
 void IOC::setControlPinInput(uint8_t ctrlLine, bool state)
 {
     if (ctrlLine < 6)
     {
-        _parent.setGuestFastIrq(_irqState->setControlPinInputState(ctrlLine, state));
+        _parent.setGuestFastIrq(_irqState.setControlPinInputState(ctrlLine, state));
     }
 }
 
@@ -416,16 +474,84 @@ void IOC::flushKart()
     }
 }
 
+//! @brief Appends the contents of a KART byte queue to a snapshot.
+//! @param[in] snapshot The snapshot to append to.
+//! @param[in] queue The queue to capture, which is left unchanged.
+//! @note This must only be called on the emulation thread, as the queue is
+//! emptied and refilled.
+void IOC::captureQueue(SystemSnapshot &snapshot, SynchronisedByteQueue &queue)
+{
+    std::vector<uint8_t> contents;
+    uint8_t next;
+
+    contents.reserve(queue.size_approx());
+
+    while (queue.try_dequeue(next))
+    {
+        contents.push_back(next);
+    }
+
+    for (uint8_t byte : contents)
+    {
+        queue.enqueue(byte);
+    }
+
+    snapshot.writeValue(static_cast<uint32_t>(contents.size()));
+    snapshot.write(contents.data(), contents.size());
+}
+
+//! @brief Replaces the contents of a KART byte queue with those captured
+//! by captureQueue().
+//! @param[in] reader The object to read the captured bytes from.
+//! @param[in] queue The queue to overwrite.
+void IOC::restoreQueue(SnapshotReader &reader, SynchronisedByteQueue &queue)
+{
+    uint32_t count = 0;
+    uint8_t next;
+
+    while (queue.pop())
+    {
+        ;
+    }
+
+    reader.readValue(count);
+
+    for (uint32_t i = 0; (i < count) && reader.readValue(next); ++i)
+    {
+        queue.enqueue(next);
+    }
+}
+
+//! @brief Applies changes to the state of input pins queued by the host.
+void IOC::applyHostPinChanges()
+{
+    uint8_t pinChange;
+    bool hasChanged = false;
+    bool isFirqPending = false;
+
+    while (_hostPinQueue->try_dequeue(pinChange))
+    {
+        isFirqPending = _irqState.setControlPinInputState(pinChange & HostPinIdMask,
+                                                          (pinChange & HostPinStateBit) != 0);
+        hasChanged = true;
+    }
+
+    if (hasChanged)
+    {
+        _parent.setGuestFastIrq(isFirqPending);
+    }
+}
+
 //void IOC::raiseIrq(uint8_t id)
 //{
 //    // Raise an interrupt if an unmasked interrupt is in progress.
-//    _parent.setGuestIrq(_irqState->raiseIrq(id));
+//    _parent.setGuestIrq(_irqState.raiseIrq(id));
 //}
 //
 //void IOC::raiseFirq(uint8_t id)
 //{
 //    // Raise an interrupt if an unmasked interrupt is in progress.
-//    _parent.setGuestFastIrq(_irqState->raiseFirq(id));
+//    _parent.setGuestFastIrq(_irqState.raiseFirq(id));
 //}
 
 // Inherited from IAddressRegion.
@@ -469,60 +595,60 @@ uint32_t IOC::read(uint32_t offset)
         {
         case 0:  // IOC Control Register
             result &= 0xFFFFFF00;
-            result |= _irqState->readCtrlRegister();
+            result |= _irqState.readCtrlRegister();
             break;
 
         case 1:  // Serial Rx Data
             result = _kartRxByte;
 
             // Clear the interrupt condition.
-            _parent.setGuestIrq(_irqState->setIrqState(KartRxIrq, false));
+            _parent.setGuestIrq(_irqState.setIrqState(KartRxIrq, false));
             break;
 
         case 4:  // IRQ Status A (read-only)
             result &= 0xFFFFFF00;
             // Bit 7 is always set
-            result |= static_cast<uint8_t>(_irqState->getUnmaskedIrqState());
+            result |= static_cast<uint8_t>(_irqState.getUnmaskedIrqState());
             break;
 
         case 5:  // IRQ Request A (read)/IRQ Clear (write)
             result &= 0xFFFFFF00;
-            result |= static_cast<uint8_t>(_irqState->getMaskedIrqState());
+            result |= static_cast<uint8_t>(_irqState.getMaskedIrqState());
             break;
 
         case 6:  // IRQ Mask A
             result &= 0xFFFFFF00;
-            result |= static_cast<uint8_t>(_irqState->getIrqMask());
+            result |= static_cast<uint8_t>(_irqState.getIrqMask());
             break;
 
         case 8:  // IRQ Status B
             result &= 0xFFFFFF00;
-            result |= static_cast<uint8_t>(_irqState->getUnmaskedIrqState() >> 8);
+            result |= static_cast<uint8_t>(_irqState.getUnmaskedIrqState() >> 8);
             break;
 
         case 9:  // IRQ Request B
             result &= 0xFFFFFF00;
-            result |= static_cast<uint8_t>(_irqState->getMaskedIrqState() >> 8);
+            result |= static_cast<uint8_t>(_irqState.getMaskedIrqState() >> 8);
             break;
 
         case 10: // IRQ Mask B
             result &= 0xFFFFFF00;
-            result |= static_cast<uint8_t>(_irqState->getIrqMask() >> 8);
+            result |= static_cast<uint8_t>(_irqState.getIrqMask() >> 8);
             break;
 
         case 12: // FIRQ Status
             result &= 0xFFFFFF00;
-            result |= _irqState->getUnmaskedFirqState();
+            result |= _irqState.getUnmaskedFirqState();
             break;
 
         case 13: // FIRQ Request
             result &= 0xFFFFFF00;
-            result |= _irqState->getMaskedFirqState();
+            result |= _irqState.getMaskedFirqState();
             break;
 
         case 14: // FIRQ Mask
             result &= 0xFFFFFF00;
-            result |= _irqState->getFirqMask();
+            result |= _irqState.getFirqMask();
             break;
 
         case 2:  // Unused
@@ -571,30 +697,30 @@ void IOC::write(uint32_t offset, uint32_t value)
         switch (regId)
         {
         case 0:  // IOC Control Register
-            _irqState->writeCtrlRegister(static_cast<uint8_t>(value));
+            _irqState.writeCtrlRegister(static_cast<uint8_t>(value));
             break;
 
         case 1:  // Serial Tx Data
             _kartTxQueue->enqueue(static_cast<uint8_t>(value));
 
             // Clear the pending KART Tx interrupt.
-            _parent.setGuestIrq(_irqState->setIrqState(KartTxIrq, false));
+            _parent.setGuestIrq(_irqState.setIrqState(KartTxIrq, false));
             break;
 
         case 5:  // IRQ Request A (read)/IRQ Clear (write)
-            _parent.setGuestIrq(_irqState->clearIrqs(static_cast<uint8_t>(value)));
+            _parent.setGuestIrq(_irqState.clearIrqs(static_cast<uint8_t>(value)));
             break;
 
         case 6:  // IRQ Mask A
-            _parent.setGuestIrq(_irqState->setIrqMaskLow(static_cast<uint8_t>(value)));
+            _parent.setGuestIrq(_irqState.setIrqMaskLow(static_cast<uint8_t>(value)));
             break;
 
         case 10: // IRQ Mask B
-            _parent.setGuestIrq(_irqState->setIrqMaskHigh(static_cast<uint8_t>(value)));
+            _parent.setGuestIrq(_irqState.setIrqMaskHigh(static_cast<uint8_t>(value)));
             break;
 
         case 14: // FIRQ Mask
-            _parent.setGuestFastIrq(_irqState->setFirqMask(static_cast<uint8_t>(value)));
+            _parent.setGuestFastIrq(_irqState.setFirqMask(static_cast<uint8_t>(value)));
             break;
 
         case 2:  // Unused
@@ -663,12 +789,54 @@ void IOC::connect(const ConnectionContext &context)
     _context = context.getInteropContext();
     IHardwareDevice *keyboardDevice = nullptr;
 
+    // Start polling for input from the host.
+    _hostInputPollTicks = std::max<uint64_t>(_context->getMasterClockFrequency() /
+                                                 HostInputPollsPerSecond, 1);
+    _hostInputTask.At = _context->getMasterClockTicks() + _hostInputPollTicks;
+    _context->scheduleTask(&_hostInputTask);
+
     if (context.tryFindDevice("Keyboard Controller", keyboardDevice))
     {
         _keyboard = dynamic_cast<AcornKeyboardController *>(keyboardDevice);
     }
 }
 
+// Inherited from IHardwareDevice.
+void IOC::captureState(SystemSnapshot &snapshot) const
+{
+    // NOTE: Pending host pin changes aren't captured, they represent input
+    // which should survive the state being rolled back.
+    snapshot.writeValue(_irqState);
+
+    for (const Counter &counter : _counters)
+    {
+        counter.captureState(snapshot);
+    }
+
+    _kartCounter.captureState(snapshot);
+    snapshot.writeValue(_kartRxByte);
+
+    captureQueue(snapshot, *_kartRxQueue);
+    captureQueue(snapshot, *_kartTxQueue);
+}
+
+// Inherited from IHardwareDevice.
+void IOC::restoreState(SnapshotReader &reader)
+{
+    reader.readValue(_irqState);
+
+    for (Counter &counter : _counters)
+    {
+        counter.restoreState(reader);
+    }
+
+    _kartCounter.restoreState(reader);
+    reader.readValue(_kartRxByte);
+
+    restoreQueue(reader, *_kartRxQueue);
+    restoreQueue(reader, *_kartTxQueue);
+}
+
 //! @brief Constructs an object representing a hardware counter.
 IOC::Counter::Counter() :
     _masterTicksPerCount(1),
@@ -740,6 +908,27 @@ void IOC::Counter::latch(SystemContext *context)
     _outputLatch = _inputLatch - static_cast<uint16_t>(elapsedTicks % _inputLatch);
 }
 
+//! @brief Appends the state of the counter to a snapshot.
+//! @param[in] snapshot The snapshot to append to.
+//! @note The scheduling of the trigger task is captured by the SystemContext.
+void IOC::Counter::captureState(SystemSnapshot &snapshot) const
+{
+    snapshot.writeValue(_masterTicksPerCount);
+    snapshot.writeValue(_startTime);
+    snapshot.writeValue(_inputLatch);
+    snapshot.writeValue(_outputLatch);
+}
+
+//! @brief Restores the state of the counter written by captureState().
+//! @param[in] reader The object to read the state from.
+void IOC::Counter::restoreState(SnapshotReader &reader)
+{
+    reader.readValue(_masterTicksPerCount);
+    reader.readValue(_startTime);
+    reader.readValue(_inputLatch);
+    reader.readValue(_outputLatch);
+}
+
 void IOC::Counter::start(SystemContext *context, uint64_t countFactor)
 {
     _startTime = context->getMasterClockTicks();
@@ -787,7 +976,7 @@ void IOC::onCounterReachesZero(SystemContext &guestContext, uintptr_t taskContex
     if (counter.isActive())
     {
         // Raise the interrupt.
-        ioc->_parent.setGuestIrq(ioc->_irqState->raiseIrq(context->Irq));
+        ioc->_parent.setGuestIrq(ioc->_irqState.raiseIrq(context->Irq));
 
         // Reset the counter.
         counter.go(&guestContext);
@@ -811,7 +1000,7 @@ void IOC::onKartCounterReachesZero(SystemContext &guestContext,
         if (ioc->_kartRxQueue->try_dequeue(ioc->_kartRxByte))
         {
             // A byte was received, raise an interrupt.
-            ioc->_irqState->raiseIrq(KartRxIrq);
+            ioc->_parent.setGuestIrq(ioc->_irqState.raiseIrq(KartRxIrq));
         }
 
         // Check for bytes we need to send to the keyboard, or the host
@@ -830,6 +1019,21 @@ void IOC::onKartCounterReachesZero(SystemContext &guestContext,
     }
 }
 
+//! @brief A recurring task which applies changes made to the IOC inputs by
+//! the host system on the emulation thread.
+//! @param[in] guestContext The context which scheduled the task.
+//! @param[in] taskContext A pointer to the IOC instance to update.
+void IOC::onPollHostInput(SystemContext &guestContext, uintptr_t taskContext)
+{
+    IOC *ioc = reinterpret_cast<IOC *>(taskContext);
+
+    ioc->applyHostPinChanges();
+
+    // Re-schedule for the next poll.
+    ioc->_hostInputTask.At += ioc->_hostInputPollTicks;
+    guestContext.scheduleTask(&ioc->_hostInputTask);
+}
+
 }} // namespace Mo::Arm
 ////////////////////////////////////////////////////////////////////////////////
 
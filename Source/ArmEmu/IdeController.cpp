@@ -0,0 +1,874 @@
+//! @file ArmEmu/IdeController.cpp
+//! @brief The definition of an object which emulates an IDE hard disc
+//! interface and the drives attached to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstring>
+
+#include "Ag/Core/Binary.hpp"
+
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/EmuOptions.hpp"
+#include "ArmEmu/IdeController.hpp"
+#include "ArmEmu/IOC.hpp"
+#include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the bits of the status register.
+struct StatusBit
+{
+    static constexpr uint8_t Error = 0x01;
+    static constexpr uint8_t DataRequest = 0x08;
+    static constexpr uint8_t SeekComplete = 0x10;
+    static constexpr uint8_t DeviceReady = 0x40;
+};
+
+//! @brief Identifies the bits of the error register.
+struct ErrorBit
+{
+    static constexpr uint8_t Aborted = 0x04;
+    static constexpr uint8_t IdNotFound = 0x10;
+};
+
+//! @brief Identifies the bits of the device/head and device control
+//! registers.
+struct ControlBit
+{
+    static constexpr uint8_t Device1 = 0x10;
+    static constexpr uint8_t LbaMode = 0x40;
+    static constexpr uint8_t InterruptDisable = 0x02;
+    static constexpr uint8_t SoftReset = 0x04;
+};
+
+//! @brief Identifies the ATA commands supported.
+struct Command
+{
+    static constexpr uint8_t Recalibrate = 0x10;
+    static constexpr uint8_t ReadSectors = 0x20;
+    static constexpr uint8_t ReadSectorsNoRetry = 0x21;
+    static constexpr uint8_t WriteSectors = 0x30;
+    static constexpr uint8_t WriteSectorsNoRetry = 0x31;
+    static constexpr uint8_t ReadVerify = 0x40;
+    static constexpr uint8_t ReadVerifyNoRetry = 0x41;
+    static constexpr uint8_t Seek = 0x70;
+    static constexpr uint8_t InitialiseDeviceParameters = 0x91;
+    static constexpr uint8_t StandbyImmediate = 0xE0;
+    static constexpr uint8_t CheckPowerMode = 0xE5;
+    static constexpr uint8_t FlushCache = 0xE7;
+    static constexpr uint8_t IdentifyDevice = 0xEC;
+    static constexpr uint8_t SetFeatures = 0xEF;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The default count of heads reported for a drive.
+constexpr uint8_t DefaultHeads = 16;
+
+//! @brief The default count of sectors per track reported for a drive.
+constexpr uint8_t DefaultSectorsPerTrack = 63;
+
+//! @brief The maximum count of cylinders reported by Identify Device.
+constexpr uint32_t MaxDefaultCylinders = 16383;
+
+//! @brief The word offset of the alternate status/device control register.
+constexpr uint8_t ControlRegister = 14;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Writes a little-endian word of identity data.
+void setIdentityWord(uint8_t *identity, uint8_t index, uint16_t value)
+{
+    identity[index * 2] = static_cast<uint8_t>(value);
+    identity[(index * 2) + 1] = static_cast<uint8_t>(value >> 8);
+}
+
+//! @brief Writes a space-padded string of identity data, with the first
+//! character of each pair in the most significant byte, as ATA requires.
+void setIdentityString(uint8_t *identity, uint8_t index, uint8_t wordCount,
+                       const char *text)
+{
+    const size_t length = std::strlen(text);
+
+    for (uint8_t i = 0; i < wordCount * 2; ++i)
+    {
+        identity[(index * 2) + (i ^ 1)] = (i < length) ? static_cast<uint8_t>(text[i]) : ' ';
+    }
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// IdeController Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an emulation of an IDE interface with no discs attached.
+//! @param[in] options The configuration of the emulated system, which
+//! specifies the count of drives if the interface is IDE.
+IdeController::IdeController(const Options &options) :
+    _context(nullptr),
+    _ioController(nullptr),
+    _readBuffer(nullptr),
+    _writeBuffer(nullptr),
+    _transferOffset(0),
+    _sectorsRemaining(0),
+    _driveCount(0),
+    _command(0),
+    _error(0),
+    _features(0),
+    _sectorCount(0),
+    _sectorNumber(0),
+    _cylinderLow(0),
+    _cylinderHigh(0),
+    _deviceHead(0),
+    _deviceControl(0),
+    _phase(Phase::Idle),
+    _isErrorActive(false),
+    _isInterruptPending(false)
+{
+    if (options.getHardDiskTechnology() == HardDiskInterface::IDE)
+    {
+        _driveCount = std::min(options.getHardDriveCount(), MaxDriveCount);
+    }
+
+    std::fill_n(_identity, std::size(_identity), static_cast<uint8_t>(0));
+    std::fill_n(_heldSector, std::size(_heldSector), static_cast<uint8_t>(0));
+    std::fill_n(_geometries, MaxDriveCount, Geometry { 0, 0, 0 });
+    softReset();
+}
+
+//! @brief Gets the count of drives attached to the interface.
+uint8_t IdeController::getDriveCount() const
+{
+    return _driveCount;
+}
+
+//! @brief Gets the disc image attached to a drive.
+//! @param[in] drive The 0-based index of the drive.
+//! @return The image, which will not be open if the drive is empty.
+const HardDiscImage &IdeController::getDisc(uint8_t drive) const
+{
+    return _discs[drive % MaxDriveCount];
+}
+
+//! @brief Attempts to attach a disc image to a drive.
+//! @param[in] drive The 0-based index of the drive.
+//! @param[in] baseFileName The path to the raw disc image, which can be
+//! shared between emulated systems.
+//! @param[in] overlayFileName The path to the copy-on-write overlay which
+//! receives the blocks written, empty to write protect the disc.
+//! @param[out] error Receives a description of why the disc couldn't be
+//! attached.
+//! @retval true The image was mapped, replacing any disc attached before.
+//! @retval false The image couldn't be mapped, error is updated.
+//! @note This member function should only be called while the emulated
+//! system isn't running.
+bool IdeController::tryAttachDisc(uint8_t drive, const std::string &baseFileName,
+                                  const std::string &overlayFileName,
+                                  std::string &error)
+{
+    bool isAttached = false;
+
+    if (drive >= _driveCount)
+    {
+        error = "The hard drive specified isn't attached.";
+    }
+    else
+    {
+        detachDisc(drive);
+        isAttached = _discs[drive].tryOpen(baseFileName, overlayFileName, error);
+    }
+
+    if (isAttached)
+    {
+        // Report a translation which covers as much of the disc as possible.
+        const uint32_t sectors = _discs[drive].getSectorCount();
+        Geometry &geometry = _geometries[drive];
+
+        geometry.Heads = DefaultHeads;
+        geometry.SectorsPerTrack = DefaultSectorsPerTrack;
+        geometry.Cylinders = static_cast<uint16_t>(std::clamp(sectors / (DefaultHeads * DefaultSectorsPerTrack),
+                                                              1u, MaxDefaultCylinders));
+    }
+
+    return isAttached;
+}
+
+//! @brief Removes the disc from a drive, writing back any changed blocks.
+//! @param[in] drive The 0-based index of the drive.
+void IdeController::detachDisc(uint8_t drive)
+{
+    if (drive < _driveCount)
+    {
+        if ((drive == ((_deviceHead & ControlBit::Device1) ? 1 : 0)) &&
+            (_phase != Phase::Idle))
+        {
+            // Abandon the transfer from the disc being removed.
+            abortCommand(ErrorBit::Aborted);
+        }
+
+        _discs[drive].close();
+        _geometries[drive] = Geometry { 0, 0, 0 };
+    }
+}
+
+//! @brief Writes back blocks changed on all discs attached.
+//! @return The count of dirty blocks written back.
+uint32_t IdeController::flushDiscs()
+{
+    uint32_t flushedCount = 0;
+
+    for (uint8_t drive = 0; drive < _driveCount; ++drive)
+    {
+        flushedCount += _discs[drive].flush();
+    }
+
+    return flushedCount;
+}
+
+// Inherited from IAddressRegion.
+RegionType IdeController::getType() const
+{
+    return RegionType::MMIO;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t IdeController::getName() const
+{
+    static const Ag::String name("IDE");
+
+    return name;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t IdeController::getDescription() const
+{
+    static const Ag::String description("The IDE hard disc interface");
+
+    return description;
+}
+
+// Inherited from IAddressRegion.
+uint32_t IdeController::getSize() const
+{
+    return 0x40;
+}
+
+// Inherited from IMMIOBlock.
+uint32_t IdeController::read(uint32_t offset)
+{
+    uint32_t result = 0xFF;
+
+    switch (Ag::Bin::extractBits<uint8_t, 2, 4>(offset))
+    {
+    case 0: result = readData(); break;
+    case 1: result = _error; break;
+    case 2: result = _sectorCount; break;
+    case 3: result = _sectorNumber; break;
+    case 4: result = _cylinderLow; break;
+    case 5: result = _cylinderHigh; break;
+    case 6: result = _deviceHead | 0xA0; break;
+
+    case 7:
+        // Reading the status acknowledges the interrupt.
+        result = getStatus();
+        setInterruptRequest(false);
+        break;
+
+    case ControlRegister:
+        result = getStatus();
+        break;
+    }
+
+    return result;
+}
+
+// Inherited from IMMIOBlock.
+void IdeController::write(uint32_t offset, uint32_t value)
+{
+    const uint8_t byte = static_cast<uint8_t>(value);
+
+    switch (Ag::Bin::extractBits<uint8_t, 2, 4>(offset))
+    {
+    case 0: writeData(static_cast<uint16_t>(value)); break;
+    case 1: _features = byte; break;
+    case 2: _sectorCount = byte; break;
+    case 3: _sectorNumber = byte; break;
+    case 4: _cylinderLow = byte; break;
+    case 5: _cylinderHigh = byte; break;
+    case 6: _deviceHead = byte; break;
+
+    case 7:
+        if (getSelectedDisc() != nullptr)
+        {
+            executeCommand(byte);
+        }
+        break;
+
+    case ControlRegister:
+        if ((_deviceControl & ControlBit::SoftReset) &&
+            ((byte & ControlBit::SoftReset) == 0))
+        {
+            // The reset completes as SRST is released.
+            softReset();
+        }
+
+        _deviceControl = byte;
+
+        // nIEN may have changed.
+        setInterruptRequest(_isInterruptPending);
+        break;
+    }
+}
+
+// Inherited from IMMIOBlock.
+void IdeController::connect(const ConnectionContext &context)
+{
+    IHardwreDevicePtr iocDevice = nullptr;
+
+    _context = context.getInteropContext();
+
+    if (context.tryFindDevice("IOC", iocDevice))
+    {
+        _ioController = dynamic_cast<IOC *>(iocDevice);
+    }
+}
+
+// Inherited from IHardwareDevice.
+void IdeController::captureState(SystemSnapshot &snapshot) const
+{
+    // NOTE: The contents of discs aren't captured, they are external media.
+    snapshot.write(_geometries, sizeof(_geometries));
+    snapshot.write(_identity, sizeof(_identity));
+    snapshot.writeValue(_transferOffset);
+    snapshot.writeValue(_sectorsRemaining);
+    snapshot.writeValue(_command);
+    snapshot.writeValue(_error);
+    snapshot.writeValue(_features);
+    snapshot.writeValue(_sectorCount);
+    snapshot.writeValue(_sectorNumber);
+    snapshot.writeValue(_cylinderLow);
+    snapshot.writeValue(_cylinderHigh);
+    snapshot.writeValue(_deviceHead);
+    snapshot.writeValue(_deviceControl);
+    snapshot.writeValue(static_cast<uint8_t>(_phase));
+    snapshot.writeValue(_isErrorActive);
+    snapshot.writeValue(_isInterruptPending);
+}
+
+// Inherited from IHardwareDevice.
+void IdeController::restoreState(SnapshotReader &reader)
+{
+    uint8_t phase = 0;
+
+    reader.read(_geometries, sizeof(_geometries));
+    reader.read(_identity, sizeof(_identity));
+    reader.readValue(_transferOffset);
+    reader.readValue(_sectorsRemaining);
+    reader.readValue(_command);
+    reader.readValue(_error);
+    reader.readValue(_features);
+    reader.readValue(_sectorCount);
+    reader.readValue(_sectorNumber);
+    reader.readValue(_cylinderLow);
+    reader.readValue(_cylinderHigh);
+    reader.readValue(_deviceHead);
+    reader.readValue(_deviceControl);
+    reader.readValue(phase);
+    reader.readValue(_isErrorActive);
+    reader.readValue(_isInterruptPending);
+
+    _phase = static_cast<Phase>(phase);
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+
+    if (_phase == Phase::Idle)
+    {
+        // Nothing to transfer.
+    }
+    else if (_command == Command::IdentifyDevice)
+    {
+        _readBuffer = _identity;
+    }
+    else
+    {
+        const uint32_t offset = _transferOffset;
+
+        if (attachTransfer())
+        {
+            _transferOffset = offset;
+        }
+        else
+        {
+            // The disc has changed since the snapshot was taken.
+            abortCommand(ErrorBit::IdNotFound);
+        }
+    }
+
+    setInterruptRequest(_isInterruptPending);
+}
+
+//! @brief Gets the disc attached to the selected drive, or nullptr if the
+//! drive isn't fitted or is empty.
+HardDiscImage *IdeController::getSelectedDisc()
+{
+    const uint8_t drive = (_deviceHead & ControlBit::Device1) ? 1 : 0;
+    HardDiscImage *disc = nullptr;
+
+    if ((drive < _driveCount) && _discs[drive].isOpen())
+    {
+        disc = &_discs[drive];
+    }
+
+    return disc;
+}
+
+//! @brief Calculates the value of the status register.
+uint8_t IdeController::getStatus() const
+{
+    const uint8_t drive = (_deviceHead & ControlBit::Device1) ? 1 : 0;
+    uint8_t status = 0;
+
+    if ((drive < _driveCount) && _discs[drive].isOpen())
+    {
+        status = StatusBit::DeviceReady | StatusBit::SeekComplete;
+
+        if (_phase != Phase::Idle)
+        {
+            status |= StatusBit::DataRequest;
+        }
+
+        if (_isErrorActive)
+        {
+            status |= StatusBit::Error;
+        }
+    }
+
+    return status;
+}
+
+//! @brief Sets whether the drive is requesting an interrupt and updates the
+//! INTRQ line, connected to IOC IL3, unless masked by nIEN.
+void IdeController::setInterruptRequest(bool isPending)
+{
+    _isInterruptPending = isPending;
+
+    if (_ioController != nullptr)
+    {
+        // The IL lines are active low.
+        _ioController->setInterruptLow(3, (isPending == false) ||
+                                          (_deviceControl & ControlBit::InterruptDisable));
+    }
+}
+
+//! @brief Converts the address in the task file registers to a logical
+//! block address.
+//! @param[out] lba Receives the address.
+//! @retval true The address is on the selected disc.
+//! @retval false The address is invalid or no disc is selected.
+bool IdeController::tryGetAddress(uint32_t &lba) const
+{
+    const uint8_t drive = (_deviceHead & ControlBit::Device1) ? 1 : 0;
+    const Geometry &geometry = _geometries[drive];
+    bool isValid = false;
+
+    if (_deviceHead & ControlBit::LbaMode)
+    {
+        lba = (static_cast<uint32_t>(_deviceHead & 0x0F) << 24) |
+              (static_cast<uint32_t>(_cylinderHigh) << 16) |
+              (static_cast<uint32_t>(_cylinderLow) << 8) | _sectorNumber;
+        isValid = true;
+    }
+    else
+    {
+        const uint32_t cylinder = (static_cast<uint32_t>(_cylinderHigh) << 8) | _cylinderLow;
+        const uint8_t head = _deviceHead & 0x0F;
+
+        if ((_sectorNumber > 0) && (_sectorNumber <= geometry.SectorsPerTrack) &&
+            (head < geometry.Heads) && (cylinder < geometry.Cylinders))
+        {
+            lba = (((cylinder * geometry.Heads) + head) * geometry.SectorsPerTrack) +
+                  (_sectorNumber - 1);
+            isValid = true;
+        }
+    }
+
+    return isValid && (drive < _driveCount) &&
+           (lba < _discs[drive].getSectorCount());
+}
+
+//! @brief Writes a logical block address to the task file registers in the
+//! addressing mode of the command being executed.
+//! @param[in] lba The address to write.
+void IdeController::setAddress(uint32_t lba)
+{
+    if (_deviceHead & ControlBit::LbaMode)
+    {
+        _sectorNumber = static_cast<uint8_t>(lba);
+        _cylinderLow = static_cast<uint8_t>(lba >> 8);
+        _cylinderHigh = static_cast<uint8_t>(lba >> 16);
+        _deviceHead = (_deviceHead & 0xF0) | static_cast<uint8_t>((lba >> 24) & 0x0F);
+    }
+    else
+    {
+        const Geometry &geometry = _geometries[(_deviceHead & ControlBit::Device1) ? 1 : 0];
+        const uint32_t track = lba / geometry.SectorsPerTrack;
+        const uint32_t cylinder = track / geometry.Heads;
+
+        _sectorNumber = static_cast<uint8_t>((lba % geometry.SectorsPerTrack) + 1);
+        _cylinderLow = static_cast<uint8_t>(cylinder);
+        _cylinderHigh = static_cast<uint8_t>(cylinder >> 8);
+        _deviceHead = (_deviceHead & 0xF0) | static_cast<uint8_t>(track % geometry.Heads);
+    }
+}
+
+//! @brief Executes a command written to the command register.
+//! @param[in] command The ATA command code.
+void IdeController::executeCommand(uint8_t command)
+{
+    HardDiscImage *disc = getSelectedDisc();
+    Geometry &geometry = _geometries[(_deviceHead & ControlBit::Device1) ? 1 : 0];
+    uint32_t lba = 0;
+
+    _command = command;
+    _error = 0;
+    _isErrorActive = false;
+    _phase = Phase::Idle;
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    _sectorsRemaining = (_sectorCount == 0) ? 256 : _sectorCount;
+
+    switch (command)
+    {
+    case Command::IdentifyDevice:
+        identifyDevice();
+        _readBuffer = _identity;
+        _transferOffset = 0;
+        _sectorsRemaining = 1;
+        _phase = Phase::DataIn;
+        setInterruptRequest(true);
+        break;
+
+    case Command::ReadSectors:
+    case Command::ReadSectorsNoRetry:
+        _phase = Phase::DataIn;
+
+        if (attachTransfer())
+        {
+            setInterruptRequest(true);
+        }
+        else
+        {
+            abortCommand(ErrorBit::IdNotFound);
+        }
+        break;
+
+    case Command::WriteSectors:
+    case Command::WriteSectorsNoRetry:
+        if (disc->isWriteProtected())
+        {
+            abortCommand(ErrorBit::Aborted);
+        }
+        else
+        {
+            // The first sector is requested without an interrupt.
+            _phase = Phase::DataOut;
+
+            if (attachTransfer() == false)
+            {
+                abortCommand(ErrorBit::IdNotFound);
+            }
+        }
+        break;
+
+    case Command::ReadVerify:
+    case Command::ReadVerifyNoRetry:
+        if (tryGetAddress(lba) &&
+            ((lba + _sectorsRemaining) <= disc->getSectorCount()))
+        {
+            // Nothing can fail to verify, leave the address of the last.
+            setAddress(lba + _sectorsRemaining - 1);
+            setInterruptRequest(true);
+        }
+        else
+        {
+            abortCommand(ErrorBit::IdNotFound);
+        }
+        break;
+
+    case Command::InitialiseDeviceParameters:
+        if (_sectorCount == 0)
+        {
+            abortCommand(ErrorBit::Aborted);
+        }
+        else
+        {
+            // Change the CHS translation.
+            const uint32_t trackSize = _sectorCount * ((_deviceHead & 0x0F) + 1u);
+
+            geometry.Heads = (_deviceHead & 0x0F) + 1;
+            geometry.SectorsPerTrack = _sectorCount;
+            geometry.Cylinders = static_cast<uint16_t>(std::min(disc->getSectorCount() / trackSize,
+                                                                0xFFFFu));
+            setInterruptRequest(true);
+        }
+        break;
+
+    case Command::FlushCache:
+        disc->flush();
+        setInterruptRequest(true);
+        break;
+
+    case Command::CheckPowerMode:
+        // Always active.
+        _sectorCount = 0xFF;
+        setInterruptRequest(true);
+        break;
+
+    case Command::SetFeatures:
+    case Command::StandbyImmediate:
+    case Command::StandbyImmediate + 1: // Idle Immediate
+    case Command::StandbyImmediate + 2: // Standby
+    case Command::StandbyImmediate + 3: // Idle
+        // Accepted, but have no effect.
+        setInterruptRequest(true);
+        break;
+
+    default:
+        if ((command & 0xF0) == Command::Recalibrate)
+        {
+            _cylinderLow = 0;
+            _cylinderHigh = 0;
+            setInterruptRequest(true);
+        }
+        else if ((command & 0xF0) == Command::Seek)
+        {
+            if (tryGetAddress(lba))
+            {
+                setInterruptRequest(true);
+            }
+            else
+            {
+                abortCommand(ErrorBit::IdNotFound);
+            }
+        }
+        else
+        {
+            abortCommand(ErrorBit::Aborted);
+        }
+        break;
+    }
+}
+
+//! @brief Ends the command being executed with an error.
+//! @param[in] errorBits The value of the error register.
+void IdeController::abortCommand(uint8_t errorBits)
+{
+    _error = errorBits;
+    _isErrorActive = true;
+    _phase = Phase::Idle;
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    setInterruptRequest(true);
+}
+
+//! @brief Fills the Identify Device data of the selected drive.
+void IdeController::identifyDevice()
+{
+    const uint8_t drive = (_deviceHead & ControlBit::Device1) ? 1 : 0;
+    const HardDiscImage &disc = _discs[drive];
+    const Geometry &current = _geometries[drive];
+    const uint32_t sectors = disc.getSectorCount();
+    const uint32_t defaultCylinders = std::clamp(sectors / (DefaultHeads * DefaultSectorsPerTrack),
+                                                 1u, MaxDefaultCylinders);
+    const uint32_t currentCapacity = static_cast<uint32_t>(current.Cylinders) *
+                                     current.Heads * current.SectorsPerTrack;
+
+    std::fill_n(_identity, std::size(_identity), static_cast<uint8_t>(0));
+
+    setIdentityWord(_identity, 0, 0x0040);              // Fixed disc.
+    setIdentityWord(_identity, 1, static_cast<uint16_t>(defaultCylinders));
+    setIdentityWord(_identity, 3, DefaultHeads);
+    setIdentityWord(_identity, 6, DefaultSectorsPerTrack);
+    setIdentityString(_identity, 10, 10, (drive == 0) ? "MO-IDE-0" : "MO-IDE-1");
+    setIdentityString(_identity, 23, 4, "1.0");
+    setIdentityString(_identity, 27, 20, "Mighty Oak Virtual Disc");
+    setIdentityWord(_identity, 47, 0x8000);             // No multiple transfers.
+    setIdentityWord(_identity, 49, 0x0200);             // LBA supported.
+    setIdentityWord(_identity, 53, 0x0001);             // Words 54-58 valid.
+    setIdentityWord(_identity, 54, current.Cylinders);
+    setIdentityWord(_identity, 55, current.Heads);
+    setIdentityWord(_identity, 56, current.SectorsPerTrack);
+    setIdentityWord(_identity, 57, static_cast<uint16_t>(currentCapacity));
+    setIdentityWord(_identity, 58, static_cast<uint16_t>(currentCapacity >> 16));
+    setIdentityWord(_identity, 60, static_cast<uint16_t>(sectors));
+    setIdentityWord(_identity, 61, static_cast<uint16_t>(sectors >> 16));
+}
+
+//! @brief Connects the data register to the sector addressed by the task
+//! file registers.
+//! @retval true The sector was found.
+//! @retval false The address was invalid or the overlay couldn't grow.
+//! @note While storage output is held, see HeldOutput::Storage, data written
+//! to an existing sector goes to a scratch buffer and is discarded.
+bool IdeController::attachTransfer()
+{
+    HardDiscImage *disc = getSelectedDisc();
+    uint32_t lba = 0;
+
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    _transferOffset = 0;
+
+    if ((disc != nullptr) && tryGetAddress(lba))
+    {
+        if (_phase == Phase::DataOut)
+        {
+            if ((_context != nullptr) &&
+                _context->isOutputHeld(HeldOutput::Storage))
+            {
+                // Fail in the same way, but leave the disc image alone.
+                if ((disc->isWriteProtected() == false) &&
+                    (disc->getSector(lba) != nullptr))
+                {
+                    _writeBuffer = _heldSector;
+                }
+            }
+            else
+            {
+                _writeBuffer = disc->getWritableSector(lba);
+            }
+        }
+        else
+        {
+            _readBuffer = disc->getSector(lba);
+        }
+    }
+
+    return (_readBuffer != nullptr) || (_writeBuffer != nullptr);
+}
+
+//! @brief Moves on to the next sector once the data of the last has been
+//! transferred.
+void IdeController::completeSector()
+{
+    uint32_t lba = 0;
+
+    --_sectorsRemaining;
+
+    if (_command == Command::IdentifyDevice)
+    {
+        _phase = Phase::Idle;
+        _readBuffer = nullptr;
+    }
+    else
+    {
+        if (_phase == Phase::DataOut)
+        {
+            // Each sector written is acknowledged.
+            setInterruptRequest(true);
+        }
+
+        if (_sectorsRemaining == 0)
+        {
+            // The task file is left addressing the last sector.
+            _phase = Phase::Idle;
+            _readBuffer = nullptr;
+            _writeBuffer = nullptr;
+        }
+        else if (tryGetAddress(lba))
+        {
+            setAddress(lba + 1);
+
+            if (attachTransfer() == false)
+            {
+                abortCommand(ErrorBit::IdNotFound);
+            }
+            else if (_phase == Phase::DataIn)
+            {
+                setInterruptRequest(true);
+            }
+        }
+        else
+        {
+            abortCommand(ErrorBit::IdNotFound);
+        }
+    }
+}
+
+//! @brief Reads the next 16 bits of data being transferred to the host.
+uint16_t IdeController::readData()
+{
+    uint16_t value = 0xFFFF;
+
+    if ((_phase == Phase::DataIn) && (_readBuffer != nullptr))
+    {
+        value = static_cast<uint16_t>(_readBuffer[_transferOffset] |
+                                      (_readBuffer[_transferOffset + 1] << 8));
+        _transferOffset += 2;
+
+        if (_transferOffset >= HardDiscImage::SectorSize)
+        {
+            completeSector();
+        }
+    }
+
+    return value;
+}
+
+//! @brief Writes the next 16 bits of data being transferred to the disc.
+//! @param[in] value The data written.
+void IdeController::writeData(uint16_t value)
+{
+    if ((_phase == Phase::DataOut) && (_writeBuffer != nullptr))
+    {
+        _writeBuffer[_transferOffset] = static_cast<uint8_t>(value);
+        _writeBuffer[_transferOffset + 1] = static_cast<uint8_t>(value >> 8);
+        _transferOffset += 2;
+
+        if (_transferOffset >= HardDiscImage::SectorSize)
+        {
+            completeSector();
+        }
+    }
+}
+
+//! @brief Returns the task file to its power-on state, abandoning any
+//! command in progress.
+void IdeController::softReset()
+{
+    _phase = Phase::Idle;
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    _transferOffset = 0;
+    _sectorsRemaining = 0;
+
+    // The diagnostic code and signature of an ATA device.
+    _error = 0x01;
+    _sectorCount = 0x01;
+    _sectorNumber = 0x01;
+    _cylinderLow = 0;
+    _cylinderHigh = 0;
+    _deviceHead = 0;
+    _isErrorActive = false;
+    setInterruptRequest(false);
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,107 @@
+//! @file ArmEmu/InstructionCounter.inl
+//! @brief The declaration of components which an execution unit uses to
+//! count the instructions executed at each address, or not.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_INSTRUCTION_COUNTER_INL__
+#define __ARM_EMU_INSTRUCTION_COUNTER_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "ArmEmu/ExecutionCounters.hpp"
+
+#include "ArmCore.hpp"
+#include "RegisterFile.inl"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Takes the place of InstructionCounter in execution units which
+//! don't attribute execution counts and cycles to guest addresses.
+class NullInstructionCounter
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit not to report the address and cycle
+    //! count of each instruction.
+    static constexpr bool IsEnabled = false;
+
+    // Accessors
+    //! @brief Gets the table of counts, always nullptr.
+    ExecutionCounterTable *getCounters() { return nullptr; }
+};
+
+//! @brief An object which accumulates execution and cycle counts for the
+//! address of each instruction executed while counting is enabled.
+class InstructionCounter
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit to report the address and cycle count
+    //! of each instruction.
+    static constexpr bool IsEnabled = true;
+
+    // Construction/Destruction
+    //! @brief Constructs a counter with counting initially disabled.
+    InstructionCounter() :
+        _execAddr(0),
+        _isCounting(false)
+    {
+    }
+
+    // Accessors
+    //! @brief Gets the table of counts accumulated.
+    ExecutionCounterTable *getCounters() { return &_counters; }
+
+    // Operations
+    //! @brief Captures the address of the instruction about to be executed.
+    //! @tparam TRegisterFile The data type of the register file modelled on
+    //! GenericCoreRegisterFile.
+    //! @param[in] regs The register file containing the PC.
+    //! @param[in] isFlushPending True if the PC points to the next
+    //! instruction to execute rather than the next to fetch.
+    template<typename TRegisterFile>
+    void beforeInstruction(const TRegisterFile &regs, bool isFlushPending)
+    {
+        constexpr uint32_t AddrMask = TRegisterFile::HasCombinedPcPsr ?
+                                      ~PsrMask26::PrivilageBits : ~3u;
+
+        _isCounting = _counters.isEnabled();
+
+        if (_isCounting)
+        {
+            // The PC is normally 8 bytes beyond the next instruction to execute.
+            const uint32_t pc = regs.getPC() & AddrMask;
+            _execAddr = isFlushPending ? pc : pc - 8;
+        }
+    }
+
+    //! @brief Accounts for the instruction captured by beforeInstruction().
+    //! @param[in] cycleCount The count of cycles the instruction took.
+    void afterInstruction(uint32_t cycleCount)
+    {
+        if (_isCounting)
+        {
+            _counters.record(_execAddr, cycleCount);
+        }
+    }
+private:
+    // Internal Fields
+    ExecutionCounterTable _counters;
+    uint32_t _execAddr;
+    bool _isCounting;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
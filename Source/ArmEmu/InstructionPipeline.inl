@@ -22,6 +22,7 @@
 
 #include "AluInstructions.inl"
 #include "DataTransferInstructions.inl"
+#include "PipelineInstrumentation.inl"
 
 namespace Mo {
 namespace Arm {
@@ -40,6 +41,7 @@ public:
     using RegisterFile = typename TPipelineTraits::RegisterFileType;
     using Decoder = typename TPipelineTraits::DecoderType;
     using InstructionType = typename TPipelineTraits::InstructionWordType;
+    using Instrumentation = typename TPipelineTraits::InstrumentationType;
     static constexpr uint8_t PipelineIncrement = static_cast<uint8_t>(1) << TPipelineTraits::InstructionSizePow2;
     static constexpr uint8_t PipelineShift = TPipelineTraits::InstructionSizePow2 + 1;
     static constexpr uint8_t PipelineAdjust = static_cast<uint8_t>(1) << PipelineShift;
@@ -50,6 +52,7 @@ private:
     Hardware &_hardware;
     RegisterFile &_registers;
     Decoder _decoder;
+    Instrumentation _instrumentation;
     uint8_t _flushPending;
 
 public:
@@ -71,6 +74,10 @@ public:
     //! 8 bytes beyond the next instruction to execute.
     bool isFlushPending() const { return _flushPending != 0; }
 
+    //! @brief Gets the object which classifies executed instructions, either
+    //! InstructionClassCounter or NullPipelineInstrumentation.
+    Instrumentation &getInstrumentation() { return _instrumentation; }
+
     // Operations
     //! @brief Flushes the pre-fetch instruction queue after a direct write to
     //! the PC.
@@ -109,9 +116,18 @@ public:
             if (canExecuteInstruction(instruction,
                                       static_cast<uint8_t>(_registers.getPSR() >> 28)))
             {
+                if constexpr (Instrumentation::IsEnabled)
+                {
+                    _instrumentation.onInstructionExecuted(instruction);
+                }
+
                 // Further decode and execute the instruction.
                 execResult = _decoder.decodeAndExecute(instruction);
             }
+            else if constexpr (Instrumentation::IsEnabled)
+            {
+                _instrumentation.onConditionFailed();
+            }
 
             const uint32_t pcIncrement =
                 ((execResult & ExecResult::FlushPipeline) ^
@@ -126,6 +142,11 @@ public:
             execResult = _registers.raisePreFetchAbort();
         }
 
+        if constexpr (Instrumentation::IsEnabled)
+        {
+            _instrumentation.onResult(execResult);
+        }
+
         // Set _flushPending to either 0 or 1 without branching.
         _flushPending = static_cast<uint8_t>(execResult >> ExecResult::FlushShift) & 1;
 
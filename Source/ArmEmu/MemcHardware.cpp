@@ -18,6 +18,9 @@
 #include "Ag/Core/Stream.hpp"
 #include "Ag/Core/Utils.hpp"
 
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
 #include "MemcHardware.hpp"
 
 namespace Mo {
@@ -126,6 +129,11 @@ public:
 static constexpr size_t LowRomSize  = 0x400000;
 static constexpr size_t HighRomSize = 0x800000;
 
+//! @brief The longest time sound DMA waits for the host to consume samples
+//! when sound pacing is enabled, after which the block is dropped so that
+//! a stalled audio device cannot stall emulation.
+static constexpr std::chrono::milliseconds SoundPacingTimeout(5);
+
 } // Anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -152,78 +160,59 @@ void MemcHardware::writeMEMC(uint32_t offset, uint32_t value)
     if (offset < 0x3600000)
     {
         // Its a write to the VIDC area. The address is not significant,
-        // the identifier of the register written to is in buts 24-32, but
-        // bits 24-25 should always be zero.
-        // For ease of decoding, we omit the two least significant bits.
-        uint8_t vidcRegisterId = Ag::Bin::extractBits<uint8_t, 26, 6>(value);
-
-        if (vidcRegisterId < 20) // 0x00 - 0x4C
-        {
-            // Write to a palette register.
-            // 0-15 - video palette.
-            // 16 - border
-            // 17-19 - cursor
-            //uint16_t physicalColour = Ag::Bin::extractBits<uint16_t, 0, 13>(value);
-        }
-        else if (vidcRegisterId < 24) // 0x50 - ox5C
-        {
-            // Reserved.
-        }
-        else if (vidcRegisterId < 32) // 0x60 - 0x7C
-        {
-            // 24-31 - Stereo image registers
-            //uint8_t stereoPosition = Ag::Bin::extractBits<uint8_t, 0, 3>(value);
-        }
-        else
-        {
-            switch (vidcRegisterId)
-            {
-            case 32: // 0x80 - Horizontal cycle register.
-            case 33: // 0x84 - Horizontal sync width register.
-            case 34: // 0x88 - Horizontal border start register.
-            case 35: // 0x8C - Horizontal display start register.
-            case 36: // 0x90 - Horizontal display end register.
-            case 37: // 0x94 - Horizontal border end register.
-            case 38: // 0x98 - Horizontal cursor start register.
-            case 39: // 0x9C - Horizontal interlace register.
-            case 40: // 0xA0 - Vertical cycle register.
-            case 41: // 0xA4 - Vertical sync width register.
-            case 42: // 0xA8 - Vertical border start register.
-            case 43: // 0xAC - Vertical display start register.
-            case 44: // 0xB0 - Vertical display end register.
-            case 45: // 0xB4 - Vertical border end register.
-            case 46: // 0xB8 - Vertical cursor start register.
-            case 47: // 0xBC - Vertical cursor end register.
-                // uint16_t data = Ag::Bin::extractBits<uint16_t, 14, 10>(value);
-
-            case 48: // 0xC0 - Sound frequency register.
-                // Theoretically 9 bits, but bit 8 is for testing only.
-                // uint8_t data = static_cast<uint8_t>(value);
-
-            case 56: // 0xE0 - VIDC Control Register
-                // Theoretically 16 bits, but only the least significant
-                // 8 bits are useful outside of testing.
-                // uint8_t data = static_cast<uint8_t>(value);
-                break;
-            }
-        }
+        // the identifier of the register written to is in the data.
+        _vidc.writeRegister(value);
     }
     else if ((offset & 0x3E00000) == 0x3600000)
     {
-        // The address is a MEMC register
+        // The address is a MEMC register. DMA address registers hold a
+        // physical address in bits 2-16 of the address written to, in units
+        // of 16 bytes. See MEMC data sheet page 22.
+        uint32_t dmaAddress = Ag::Bin::extractBits<uint32_t, 2, 15>(offset) << 4;
+
         switch (Ag::Bin::extractBits<uint8_t, 17, 3>(offset))
         {
         case 0: // Vinit
+            _isFrameInvalid |= (_videoInit != dmaAddress);
+            _videoInit = dmaAddress;
+            updateVideoWindow();
+            break;
+
         case 1: // Vstart
+            _isFrameInvalid |= (_videoStart != dmaAddress);
+            _videoStart = dmaAddress;
+            updateVideoWindow();
+            break;
+
         case 2: // Vend
+            _isFrameInvalid |= (_videoEnd != dmaAddress);
+            _videoEnd = dmaAddress;
+            updateVideoWindow();
+            break;
+
         case 3: // Cinit
+            _cursorInit = dmaAddress;
+            break;
+
         case 4: // Sstart
+            // Programming the next buffer acknowledges the interrupt.
+            _soundStart = dmaAddress;
+            _ioc.setSoundBufferInterrupt(false);
+            break;
+
         case 5: // SendN
+            _soundEndNext = dmaAddress;
+            break;
+
         case 6: // Sptr
+            // The address is ignored, the next buffer is started immediately.
+            _soundPtr = _soundStart;
+            _soundEnd = _soundEndNext;
             break;
 
         case 7: // MEMC Control Register
             setPageSize(Ag::Bin::extractBits<uint8_t, 2, 2>(offset) + 12);
+            _isFrameInvalid |= (_videoDMAEnabled != Ag::Bin::extractBit<10>(offset));
             _videoDMAEnabled = Ag::Bin::extractBit<10>(offset);
             _soundDMAEnabled = Ag::Bin::extractBit<11>(offset);
             _osMode = Ag::Bin::extractBit<12>(offset);
@@ -312,6 +301,122 @@ void MemcHardware::writeMEMC(uint32_t offset, uint32_t value)
     }
 }
 
+//! @brief Reads a line of video memory as the video DMA would.
+//! @param[in,out] address The physical address of the video DMA pointer,
+//! updated to point past the bytes read.
+//! @param[in] byteCount The count of bytes to read.
+//! @param[in] buffer A buffer to gather the line into if it isn't contiguous.
+//! @return A pointer to byteCount bytes of video memory.
+//! @note The pointer wraps to Vstart after reading the 16 bytes at Vend.
+const uint8_t *MemcHardware::readVideoLine(uint32_t &address, uint32_t byteCount,
+                                           std::vector<uint8_t> &buffer) const
+{
+    const uint32_t bufferEnd = _videoEnd + 16;
+    const uint8_t *line;
+
+    if (((address + byteCount) <= bufferEnd) &&
+        ((address + byteCount) <= _ram.size()))
+    {
+        // The line is in one piece, read it in place.
+        line = _ram.data() + address;
+        address += byteCount;
+
+        if (address >= bufferEnd)
+        {
+            address = _videoStart;
+        }
+    }
+    else
+    {
+        buffer.resize(byteCount);
+
+        for (uint32_t i = 0; i < byteCount; ++i, ++address)
+        {
+            if (address >= bufferEnd)
+            {
+                address = _videoStart;
+            }
+
+            buffer[i] = (address < _ram.size()) ? _ram[address] : 0;
+        }
+
+        line = buffer.data();
+    }
+
+    return line;
+}
+
+//! @brief Recalculates the range of physical RAM video DMA can read from
+//! after the video DMA registers have changed.
+void MemcHardware::updateVideoWindow()
+{
+    const uint32_t bufferEnd = _videoEnd + 16;
+
+    // Video DMA starts at Vinit, which may be below Vstart, and proceeds
+    // up to the end of the 16 bytes at Vend.
+    _videoWindowStart = std::min(_videoInit, _videoStart);
+    _videoWindowSize = (bufferEnd > _videoWindowStart) ? bufferEnd - _videoWindowStart : 0;
+}
+
+//! @brief Marks blocks of physical RAM within the video buffer as having
+//! been modified since the last frame was rendered.
+//! @param[in] offset The offset of the first byte written into physical RAM.
+//! @param[in] byteCount The count of bytes written.
+void MemcHardware::markVideoDirty(uint32_t offset, uint32_t byteCount)
+{
+    if (byteCount > 0)
+    {
+        const uint32_t blockCount = static_cast<uint32_t>(_dirtyVideoBlocks.size() * 64);
+        const uint32_t endBlock = std::min(((offset + byteCount - 1) >> DirtyBlockSizePow2) + 1,
+                                           blockCount);
+
+        for (uint32_t block = offset >> DirtyBlockSizePow2; block < endBlock; ++block)
+        {
+            _dirtyVideoBlocks[block / 64] |= static_cast<uint64_t>(1) << (block % 64);
+        }
+    }
+}
+
+//! @brief Determines whether a line of video memory has been modified since
+//! the last frame was rendered.
+//! @param[in] address The physical RAM offset of the start of the line.
+//! @param[in] byteCount The count of bytes in the line.
+//! @retval true At least part of the line has been written to, or the video
+//! DMA registers don't describe a buffer which can be tracked.
+//! @retval false The line is unchanged.
+//! @note The line wraps to Vstart after the 16 bytes at Vend in the same way
+//! as readVideoLine().
+bool MemcHardware::isVideoLineDirty(uint32_t address, uint32_t byteCount) const
+{
+    const uint32_t bufferEnd = _videoEnd + 16;
+    const uint32_t blockCount = static_cast<uint32_t>(_dirtyVideoBlocks.size() * 64);
+    bool isDirty = (_videoWindowSize == 0) || (_videoStart >= bufferEnd);
+
+    while ((byteCount > 0) && (isDirty == false))
+    {
+        if (address >= bufferEnd)
+        {
+            address = _videoStart;
+        }
+
+        const uint32_t span = std::min(byteCount, bufferEnd - address);
+        const uint32_t endBlock = std::min(((address + span - 1) >> DirtyBlockSizePow2) + 1,
+                                           blockCount);
+
+        // Blocks beyond the end of RAM always read as zero and never change.
+        for (uint32_t block = address >> DirtyBlockSizePow2;
+             (block < endBlock) && (isDirty == false); ++block)
+        {
+            isDirty = ((_dirtyVideoBlocks[block / 64] >> (block % 64)) & 1) != 0;
+        }
+
+        address += span;
+        byteCount -= span;
+    }
+
+    return isDirty;
+}
+
 //! @brief Attempts to translate a logical to physical address and determine
 //! whether the processor has enough privileges to access it.
 //! @param[in] logicalAddr The logical address to translate.
@@ -576,15 +681,30 @@ MemcHardware::MemcHardware(const Options &options,
                            const AddressMap &writeMap) :
     BasicIrqManagerHardware(readMap, writeMap),
     _ioc(*this),
-    _vidc(*this),
+    _vidc(*this, options),
     _readAddrDecoder(readMap),
     _writeAddrDecoder(writeMap),
+    _frameSequence(0),
+    _videoInit(0),
+    _videoStart(0),
+    _videoEnd(0),
+    _cursorInit(0),
+    _soundStart(0),
+    _soundEndNext(0),
+    _soundPtr(0),
+    _soundEnd(0),
+    _videoWindowStart(0),
+    _videoWindowSize(0),
+    _renderedLineCount(0),
     _pageOffsetMask(0),
     _physicalPageCount(0),
     _pageSizePow2(0),
     _osMode(false),
     _videoDMAEnabled(false),
     _soundDMAEnabled(false),
+    _isFrameInvalid(true),
+    _isVideoOutputEnabled(options.isVideoOutputEnabled()),
+    _isSoundPacingEnabled(options.isSoundPacingEnabled()),
     _physicalRamBlock("Physical RAM", "The system RAM without any logical address mapping"),
     _lowRomBlock("System ROM", "The low ROM area, usually containing the operating system."),
     _highRomBlock("Extension ROM", "The high ROM area, usually containing extensions ROMs.")
@@ -592,6 +712,11 @@ MemcHardware::MemcHardware(const Options &options,
     // Generate random fuzz to use when memory can be accessed, but isn't mapped.
     std::generate_n(_fuzz, std::size(_fuzz), GenerateFuzz());
 
+    if (options.isSoundOutputEnabled())
+    {
+        _soundRing = std::make_unique<SoundSampleRing>();
+    }
+
     // Add IOC and VIDC to the address map.
     if ((_readAddrDecoder.tryInsert(0x3200000, &_ioc) == false) ||
         (_writeAddrDecoder.tryInsert(0x3200000, &_ioc) == false))
@@ -626,6 +751,11 @@ MemcHardware::MemcHardware(const Options &options,
     _physicalRamBlock.updateHostMapping(_ram.data(),
                                         static_cast<uint32_t>(_ram.size()));
 
+    // Allocate one bit for each block of RAM which could be displayed.
+    const size_t dirtyBlockCount = _ram.size() >> DirtyBlockSizePow2;
+    _dirtyVideoBlocks.resize((dirtyBlockCount + 63) / 64, 0);
+    updateVideoWindow();
+
     // Set the initial page size to 4 KB.
     setPageSize(12);
 
@@ -651,11 +781,13 @@ MemcHardware::MemcHardware(const Options &options,
         {
             romFile->read(_lowRom.data(), _lowRom.size());
         }
-
-        _lowRomBlock.updateHostMapping(_lowRom.data(),
-                                       static_cast<uint32_t>(_lowRom.size()));
     }
 
+    // Map the low ROM even if no image was loaded so that it can be
+    // populated by the host.
+    _lowRomBlock.updateHostMapping(_lowRom.data(),
+                                   static_cast<uint32_t>(_lowRom.size()));
+
     // TODO: Load high ROM?
     _highRom.clear();
     _highRom.reserve(HighRomSize);
@@ -697,6 +829,307 @@ void MemcHardware::setHighRom(const uint8_t *romBytes, size_t byteCount)
     _highRomBlock.updateHostMapping(_highRom.data(), HighRomSize);
 }
 
+//! @brief Captures the changes to the display since the last capture.
+//! @param[in,out] frame The snapshot to update, only the video memory of the
+//! lines which have changed is copied.
+//! @param[in] isCarryingChanges True to also mark the lines changed in the
+//! previous capture as dirty because they may not have been rendered.
+//! @param[out] changedLineCount Receives the count of lines which have
+//! changed since the previous capture, excluding those carried.
+//! @retval true The frame was captured.
+//! @retval false The VIDC timing registers don't describe a valid frame,
+//! nothing was captured.
+//! @note If only carried changes are found, the video memory isn't copied as
+//! the snapshot being replaced already holds it.
+bool MemcHardware::captureFrame(VideoFrame &frame, bool isCarryingChanges,
+                                uint32_t &changedLineCount)
+{
+    const VidcTiming timing = _vidc.getTiming();
+    bool isCaptured = false;
+
+    if (timing.isValid())
+    {
+        const VidcPalette &palette = _vidc.getPalette();
+        const bool isFullRefresh = _isFrameInvalid || (palette != _lastPalette) ||
+                                   (timing.isSameDisplay(_lastTiming) == false);
+        const uint32_t bytesPerLine = timing.getDisplayBytesPerLine();
+
+        frame.Palette = palette;
+        frame.Timing = timing;
+        frame.IsDisplayEnabled = _videoDMAEnabled;
+        frame.Display.resize(timing.getDisplayHeight() * bytesPerLine);
+        frame.DirtyLines.assign((timing.getFrameHeight() + 63) / 64, 0);
+        frame.Cursor.clear();
+
+        if (isCarryingChanges && (_carriedLines.size() == frame.DirtyLines.size()))
+        {
+            frame.DirtyLines = _carriedLines;
+        }
+
+        // Gather the cursor image so that changes to it, or its position,
+        // can be detected.
+        if (_videoDMAEnabled && (timing.VertCursorEnd > timing.VertCursorStart))
+        {
+            frame.Cursor.resize((timing.VertCursorEnd - timing.VertCursorStart) *
+                                VidcTiming::CursorBytesPerLine, 0);
+
+            if (_cursorInit < _ram.size())
+            {
+                std::copy_n(_ram.data() + _cursorInit,
+                            std::min(frame.Cursor.size(), _ram.size() - _cursorInit),
+                            frame.Cursor.data());
+            }
+        }
+
+        const bool isCursorChanged = (frame.Cursor != _lastCursorImage) ||
+                                     (timing.HorzCursorStart != _lastTiming.HorzCursorStart) ||
+                                     (timing.VertCursorStart != _lastTiming.VertCursorStart) ||
+                                     (timing.VertCursorEnd != _lastTiming.VertCursorEnd);
+
+        std::vector<uint8_t> wrappedLine;
+        uint32_t videoAddr = _videoInit;
+        changedLineCount = 0;
+
+        for (uint16_t line = timing.VertBorderStart; line < timing.VertBorderEnd; ++line)
+        {
+            const uint16_t index = line - timing.VertBorderStart;
+            const bool isCursorLine = (line >= timing.VertCursorStart) &&
+                                      (line < timing.VertCursorEnd);
+            const bool wasCursorLine = (line >= _lastTiming.VertCursorStart) &&
+                                       (line < _lastTiming.VertCursorEnd);
+            bool isLineChanged = isFullRefresh ||
+                                 (isCursorChanged && (isCursorLine || wasCursorLine));
+
+            if (_videoDMAEnabled &&
+                (line >= timing.VertDisplayStart) && (line < timing.VertDisplayEnd))
+            {
+                isLineChanged |= isVideoLineDirty(videoAddr, bytesPerLine);
+                readVideoLine(videoAddr, bytesPerLine, wrappedLine);
+            }
+
+            if (isLineChanged)
+            {
+                frame.markLineDirty(index);
+                ++changedLineCount;
+            }
+        }
+
+        if (_videoDMAEnabled && (changedLineCount > 0))
+        {
+            // Copy the video memory of every dirty line, including those
+            // carried from the previous capture.
+            videoAddr = _videoInit;
+
+            for (uint16_t line = timing.VertDisplayStart; line < timing.VertDisplayEnd; ++line)
+            {
+                const uint8_t *source = readVideoLine(videoAddr, bytesPerLine, wrappedLine);
+
+                if (frame.isLineDirty(line - timing.VertBorderStart))
+                {
+                    std::copy_n(source, bytesPerLine, frame.Display.data() +
+                                ((line - timing.VertDisplayStart) * bytesPerLine));
+                }
+            }
+        }
+
+        // The snapshot now reflects the current state of video memory.
+        std::fill(_dirtyVideoBlocks.begin(), _dirtyVideoBlocks.end(), 0);
+        _carriedLines = frame.DirtyLines;
+        _lastCursorImage = frame.Cursor;
+        _lastPalette = palette;
+        _lastTiming = timing;
+        _isFrameInvalid = false;
+        isCaptured = true;
+    }
+    else
+    {
+        // Ensure the next valid frame is captured in its entirety.
+        _isFrameInvalid = true;
+    }
+
+    return isCaptured;
+}
+
+//! @brief Renders the frame described by the VIDC registers from the video
+//! memory described by the MEMC video DMA registers.
+//! @param[in] converter The object to convert pixels with, its palette is
+//! updated from the VIDC.
+//! @param[in,out] target Receives VidcTiming::getFrameHeight() lines of
+//! VidcTiming::getFrameWidth() host pixels. It is expected to hold the frame
+//! previously rendered, only lines which have changed since are re-rendered.
+//! @param[in] stride The count of host pixels between the start of each line
+//! in target.
+//! @retval true The frame was rendered.
+//! @retval false The VIDC timing registers don't describe a valid frame,
+//! nothing was rendered.
+//! @note When video DMA is disabled the display area is rendered as border.
+//! Changes to the palette, display geometry or video DMA registers cause the
+//! entire frame to be rendered. Call invalidateFrame() if target or converter
+//! no longer hold the results of the previous call. This should not be used
+//! at the same time as the frames published by publishFrame().
+bool MemcHardware::renderFrame(FrameConverter &converter, uint32_t *target,
+                               size_t stride)
+{
+    uint32_t changedLineCount = 0;
+    const bool isRendered = captureFrame(_renderedFrame, false, changedLineCount);
+
+    _renderedLineCount = isRendered ? _renderedFrame.render(converter, target, stride) : 0;
+
+    return isRendered;
+}
+
+//! @brief Captures the changes to the display at vertical sync and publishes
+//! them to the render thread through the object returned by getVideoFrames().
+//! @param[out] sequence Receives the VideoFrame::Sequence of the snapshot
+//! published.
+//! @param[out] dirtyLineCount Receives the count of lines which changed.
+//! @retval true A snapshot was published.
+//! @retval false Video output is disabled, the VIDC timing is invalid or
+//! nothing has changed since the last snapshot, nothing was published.
+//! @note This member function should only be called on the emulation thread.
+bool MemcHardware::publishFrame(uint64_t &sequence, uint32_t &dirtyLineCount)
+{
+    bool isPublished = false;
+    sequence = 0;
+    dirtyLineCount = 0;
+
+    if (_isVideoOutputEnabled)
+    {
+        if (_frameExchange.tryTakeRefreshRequest())
+        {
+            _isFrameInvalid = true;
+        }
+
+        // If the last snapshot published hasn't been picked up yet, it will
+        // be replaced, so its changes must be carried forward.
+        VideoFrame &frame = _frameExchange.getBackFrame();
+
+        uint32_t changedLineCount = 0;
+
+        if (captureFrame(frame, _frameExchange.isPending(), changedLineCount) &&
+            (changedLineCount > 0))
+        {
+            dirtyLineCount = frame.getDirtyLineCount();
+            frame.Sequence = ++_frameSequence;
+            sequence = frame.Sequence;
+            _frameExchange.publish();
+            isPublished = true;
+        }
+    }
+
+    return isPublished;
+}
+
+//! @brief Performs a sound DMA request, fetching the next block of samples
+//! for the VIDC and queueing them for the host.
+//! @param[in] context The context of the emulation thread, which accounts
+//! for any time spent waiting for the host to consume samples.
+//! @param[out] samples Receives SoundDmaBlockSize logarithmic samples.
+//! @param[out] isQueued Receives true if the samples were converted and
+//! written to the object returned by getSoundSamples().
+//! @retval true The samples were fetched.
+//! @retval false Sound DMA is disabled, nothing was fetched.
+//! @note This member function should only be called on the emulation thread.
+//! @note While sound output is held, see HeldOutput::Sound, the samples are
+//! fetched but neither queued nor waited upon.
+bool MemcHardware::performSoundDma(SystemContext &context, uint8_t *samples,
+                                   bool &isQueued)
+{
+    bool isFetched = false;
+    isQueued = false;
+
+    if (_soundDMAEnabled)
+    {
+        if ((_soundPtr + SoundDmaBlockSize) <= _ram.size())
+        {
+            std::copy_n(_ram.data() + _soundPtr, SoundDmaBlockSize, samples);
+        }
+        else
+        {
+            // Silence.
+            std::fill_n(samples, SoundDmaBlockSize, static_cast<uint8_t>(0));
+        }
+
+        if (_soundPtr >= _soundEnd)
+        {
+            // The last block of the buffer has been fetched, swap to the
+            // next buffer and ask for another. See MEMC data sheet page 23.
+            _soundPtr = _soundStart;
+            _soundEnd = _soundEndNext;
+            _ioc.setSoundBufferInterrupt(true);
+        }
+        else
+        {
+            _soundPtr += SoundDmaBlockSize;
+        }
+
+        if (_soundRing && (context.isOutputHeld(HeldOutput::Sound) == false))
+        {
+            uint8_t positions[SoundMixer::ChannelCount];
+            StereoSample converted[SoundDmaBlockSize];
+
+            for (uint8_t channel = 0; channel < SoundMixer::ChannelCount; ++channel)
+            {
+                positions[channel] = _vidc.getStereoPosition(channel);
+            }
+
+            _soundMixer.setStereoPositions(positions);
+            _soundMixer.mix(samples, converted, SoundDmaBlockSize);
+            _soundRing->setSampleRate(_vidc.getSoundSampleRate());
+
+            if (_isSoundPacingEnabled)
+            {
+                // Let the host audio device set the pace of emulation. If
+                // the ring stays full the write below drops the block.
+                using WaitClock = std::chrono::steady_clock;
+                const WaitClock::time_point waitStart = WaitClock::now();
+
+                _soundRing->waitForSpace(SoundDmaBlockSize, SoundPacingTimeout);
+                context.addHostIdleTime(WaitClock::now() - waitStart);
+            }
+
+            isQueued = _soundRing->tryWrite(converted, SoundDmaBlockSize);
+        }
+
+        isFetched = true;
+    }
+
+    return isFetched;
+}
+
+//! @brief Forces the entire frame to be rendered by the next call to
+//! renderFrame().
+void MemcHardware::invalidateFrame()
+{
+    _isFrameInvalid = true;
+}
+
+//! @brief Records a write to physical RAM made directly by the host, rather
+//! than by the emulated processor, so that it is displayed.
+//! @param[in] physAddr The physical address of the first byte written.
+//! @param[in] byteCount The count of bytes written.
+//! @note Writes which fall outside physical RAM are ignored.
+void MemcHardware::markHostWrite(uint32_t physAddr, uint32_t byteCount)
+{
+    const uint32_t ramSize = static_cast<uint32_t>(_ram.size());
+    const uint32_t offset = physAddr - MEMC::PhysRamStart;
+
+    if ((physAddr >= MEMC::PhysRamStart) && (offset < ramSize))
+    {
+        const uint32_t writeEnd = offset + std::min(byteCount, ramSize - offset);
+        const uint32_t windowEnd = _videoWindowStart + _videoWindowSize;
+
+        // Only mark the part of the run which overlaps the video buffer.
+        const uint32_t dirtyStart = std::max(offset, _videoWindowStart);
+        const uint32_t dirtyEnd = std::min(writeEnd, windowEnd);
+
+        if (dirtyStart < dirtyEnd)
+        {
+            markVideoDirty(dirtyStart, dirtyEnd - dirtyStart);
+        }
+    }
+}
+
 // Based on GenericHardware::reset().
 void MemcHardware::reset()
 {
@@ -734,9 +1167,62 @@ void MemcHardware::reset()
     _ioc.powerOnReset();
 }
 
-// Based on GenericHardware::writeWords().
-bool MemcHardware::writeWords(uint32_t logicalAddr, const uint32_t *values,
-                              uint8_t count)
+// Based on GenericHardware::captureState().
+void MemcHardware::captureState(SystemSnapshot &snapshot) const
+{
+    BasicIrqManagerHardware::captureState(snapshot);
+
+    // IOC and VIDC appear in the address map and capture their own state.
+    snapshot.writeValue(_pageSizePow2);
+    snapshot.writeValue(_osMode);
+    snapshot.writeValue(_videoDMAEnabled);
+    snapshot.writeValue(_soundDMAEnabled);
+    snapshot.writeValue(_videoInit);
+    snapshot.writeValue(_videoStart);
+    snapshot.writeValue(_videoEnd);
+    snapshot.writeValue(_cursorInit);
+    snapshot.writeValue(_soundStart);
+    snapshot.writeValue(_soundEndNext);
+    snapshot.writeValue(_soundPtr);
+    snapshot.writeValue(_soundEnd);
+    snapshot.write(_pageMappings.data(), _pageMappings.size() * sizeof(uint16_t));
+    snapshot.write(_ram.data(), _ram.size());
+}
+
+// Based on GenericHardware::restoreState().
+void MemcHardware::restoreState(SnapshotReader &reader)
+{
+    BasicIrqManagerHardware::restoreState(reader);
+
+    uint8_t pageSizePow2 = _pageSizePow2;
+    reader.readValue(pageSizePow2);
+    setPageSize(pageSizePow2);
+
+    reader.readValue(_osMode);
+    reader.readValue(_videoDMAEnabled);
+    reader.readValue(_soundDMAEnabled);
+    reader.readValue(_videoInit);
+    reader.readValue(_videoStart);
+    reader.readValue(_videoEnd);
+    reader.readValue(_cursorInit);
+    reader.readValue(_soundStart);
+    reader.readValue(_soundEndNext);
+    reader.readValue(_soundPtr);
+    reader.readValue(_soundEnd);
+    reader.read(_pageMappings.data(), _pageMappings.size() * sizeof(uint16_t));
+    reader.read(_ram.data(), _ram.size());
+
+    // The contents of video memory have changed wholesale.
+    updateVideoWindow();
+    invalidateFrame();
+}
+
+//! @brief Writes successive words to a logical address, reporting accesses
+//! to memory mapped devices to a counter.
+//! @note Based on GenericHardware::writeWords().
+template<typename TMmioCounter>
+bool MemcHardware::dispatchWriteWords(uint32_t logicalAddr, const uint32_t *values,
+                                      uint8_t count, TMmioCounter &mmioCounter)
 {
     uint8_t wordsWritten = 0;
     bool isWritten = false;
@@ -760,6 +1246,7 @@ bool MemcHardware::writeWords(uint32_t logicalAddr, const uint32_t *values,
 
             std::copy_n(values + wordsWritten, wordsToWrite,
                         reinterpret_cast<uint32_t *>(hostBlock));
+            markVideoWrite(hostBlock, wordsToWrite * 4);
 
             wordsWritten += static_cast<uint8_t>(wordsToWrite);
         }
@@ -782,6 +1269,8 @@ bool MemcHardware::writeWords(uint32_t logicalAddr, const uint32_t *values,
                     writeMEMC(offset + (i * 4), values[wordsWritten + i]);
                 }
 
+                mmioCounter.onAccess(wordsToWrite);
+
                 // Assume we write all remaining words.
                 wordsWritten += static_cast<uint8_t>(wordsToWrite);
             }
@@ -805,6 +1294,8 @@ bool MemcHardware::writeWords(uint32_t logicalAddr, const uint32_t *values,
                     {
                         mmio->write(offset + (i * 4), values[wordsWritten + i]);
                     }
+
+                    mmioCounter.onAccess(wordsToWrite);
                 }
 
                 wordsWritten += static_cast<uint8_t>(wordsToWrite);
@@ -826,8 +1317,12 @@ bool MemcHardware::writeWords(uint32_t logicalAddr, const uint32_t *values,
     return isWritten;
 }
 
-// Based on GenericHardware::readWords().
-bool MemcHardware::readWords(uint32_t logicalAddr, uint32_t *results, uint8_t count)
+//! @brief Reads successive words from a logical address, reporting accesses
+//! to memory mapped devices to a counter.
+//! @note Based on GenericHardware::readWords().
+template<typename TMmioCounter>
+bool MemcHardware::dispatchReadWords(uint32_t logicalAddr, uint32_t *results,
+                                     uint8_t count, TMmioCounter &mmioCounter)
 {
     uint8_t wordsRead = 0;
     bool isRead = false;
@@ -881,6 +1376,8 @@ bool MemcHardware::readWords(uint32_t logicalAddr, uint32_t *results, uint8_t co
                     {
                         results[wordsRead + i] = mmio->read(offset + (i * 4));
                     }
+
+                    mmioCounter.onAccess(wordsToRead);
                 }
 
                 // Update the count.
@@ -906,6 +1403,16 @@ bool MemcHardware::readWords(uint32_t logicalAddr, uint32_t *results, uint8_t co
     return isRead;
 }
 
+// Instantiate the block transfers for plain and counting hardware.
+template bool MemcHardware::dispatchWriteWords<NullMmioCounter>(uint32_t, const uint32_t *,
+                                                                uint8_t, NullMmioCounter &);
+template bool MemcHardware::dispatchWriteWords<MmioAccessCounter>(uint32_t, const uint32_t *,
+                                                                  uint8_t, MmioAccessCounter &);
+template bool MemcHardware::dispatchReadWords<NullMmioCounter>(uint32_t, uint32_t *,
+                                                               uint8_t, NullMmioCounter &);
+template bool MemcHardware::dispatchReadWords<MmioAccessCounter>(uint32_t, uint32_t *,
+                                                                 uint8_t, MmioAccessCounter &);
+
 // Based on GenericHardware::logicalToPhysicalAddress().
 bool MemcHardware::logicalToPhysicalAddress(uint32_t logicalAddr,
                                             PageMapping &mapping) const
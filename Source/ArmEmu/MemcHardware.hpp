@@ -19,8 +19,11 @@
 
 #include "ArmEmu/EmuOptions.hpp"
 #include "ArmEmu/AddressMap.hpp"
+#include "ArmEmu/FrameConverter.hpp"
 #include "ArmEmu/IOC.hpp"
+#include "ArmEmu/SoundOutput.hpp"
 #include "ArmEmu/VIDC10.hpp"
+#include "ArmEmu/VideoOutput.hpp"
 
 #include "ArmCore.hpp"
 #include "Hardware.inl"
@@ -79,16 +82,42 @@ struct AddrMapResult
     static constexpr uint8_t Success            = HasMapping | AccessAllowed;
 };
 
+//! @brief The MMIO access counter passed to MemcHardware data transfers in
+//! systems which aren't instrumented, an empty object whose only member
+//! function is inlined away.
+struct NullMmioCounter
+{
+    //! @brief Ignores accesses to memory mapped devices.
+    void onAccess(uint32_t /*count*/) {}
+};
+
+//! @brief Totals the reads and writes passed to memory mapped devices by
+//! CountingMemcHardware.
+struct MmioAccessCounter
+{
+    //! @brief The count of accesses so far.
+    uint64_t Count = 0;
+
+    //! @brief Adds a run of accesses to memory mapped devices to the total.
+    //! @param[in] count The count of words read or written.
+    void onAccess(uint32_t count) { Count += count; }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief An object which emulates the hardware of a MEMC1/1a-based system.
-class MemcHardware : public BasicIrqManagerHardware
+class MemcHardware : public BasicIrqManagerHardware,
+                     public HostServicesHardware
 {
 private:
     // Internal Constants
     static constexpr size_t FuzzSize = 256;
 
+    //! @brief The size of the blocks of physical RAM in which changes to the
+    //! video buffer are tracked, as a power of 2.
+    static constexpr uint8_t DirtyBlockSizePow2 = 8;
+
     // Internal Fields
     IOC _ioc;
     VIDC10 _vidc;
@@ -98,13 +127,37 @@ private:
     std::vector<uint8_t> _lowRom;
     std::vector<uint8_t> _highRom;
     std::vector<uint16_t> _pageMappings;
+    std::vector<uint64_t> _dirtyVideoBlocks;
+    std::vector<uint64_t> _carriedLines;
+    std::vector<uint8_t> _lastCursorImage;
+    VidcPalette _lastPalette;
+    VidcTiming _lastTiming;
+    VideoFrame _renderedFrame;
+    VideoFrameExchange _frameExchange;
+    SoundMixer _soundMixer;
+    std::unique_ptr<SoundSampleRing> _soundRing;
     uint8_t _fuzz[FuzzSize];
+    uint64_t _frameSequence;
+    uint32_t _videoInit;
+    uint32_t _videoStart;
+    uint32_t _videoEnd;
+    uint32_t _cursorInit;
+    uint32_t _soundStart;
+    uint32_t _soundEndNext;
+    uint32_t _soundPtr;
+    uint32_t _soundEnd;
+    uint32_t _videoWindowStart;
+    uint32_t _videoWindowSize;
+    uint32_t _renderedLineCount;
     uint32_t _pageOffsetMask;
     uint16_t _physicalPageCount;
     uint8_t _pageSizePow2;
     bool _osMode;
     bool _videoDMAEnabled;
     bool _soundDMAEnabled;
+    bool _isFrameInvalid;
+    bool _isVideoOutputEnabled;
+    bool _isSoundPacingEnabled;
 
     // Non-cache intensive.
     GenericHostBlock _physicalRamBlock;
@@ -114,30 +167,150 @@ private:
     // Internal Functions
     void setPageSize(uint8_t pageSizePow2);
     void writeMEMC(uint32_t offset, uint32_t value);
+    const uint8_t *readVideoLine(uint32_t &address, uint32_t byteCount,
+                                 std::vector<uint8_t> &buffer) const;
+    void updateVideoWindow();
+    void markVideoDirty(uint32_t offset, uint32_t byteCount);
+    bool isVideoLineDirty(uint32_t address, uint32_t byteCount) const;
+    bool captureFrame(VideoFrame &frame, bool isCarryingChanges,
+                      uint32_t &changedLineCount);
+
+    //! @brief Records a store to physical RAM if it may be displayed.
+    //! @param[in] hostAddr The host address of the first byte written.
+    //! @param[in] byteCount The count of bytes written.
+    //! @note A single unsigned comparison filters out stores outside the
+    //! video buffer so that other stores are not slowed down.
+    void markVideoWrite(const void *hostAddr, uint32_t byteCount)
+    {
+        const uint32_t offset = static_cast<uint32_t>(static_cast<const uint8_t *>(hostAddr) -
+                                                      _ram.data());
 
-    uint8_t translateAddress(uint32_t logicalAddr, uint32_t &physAddr, bool isWrite) const;
-    uint8_t tryGetReadHostMapping(uint32_t physAddr, void *&hostBlock,
-                                  uint32_t &length);
-    uint8_t tryGetWriteHostMapping(uint32_t physAddr, void *&hostBlock,
-                                   uint32_t &length);
+        if ((offset - _videoWindowStart) < _videoWindowSize)
+        {
+            markVideoDirty(offset, byteCount);
+        }
+    }
 
 public:
+    // Public Constants
+    //! @brief The count of bytes fetched by each sound DMA request.
+    static constexpr uint32_t SoundDmaBlockSize = 16;
+
+    // For compatibility with GenericHardware, see CountingMemcHardware.
+    static constexpr bool CountsMmio = false;
+
     // Construction/Destruction
     MemcHardware(const Options &options, const AddressMap &readMap,
                  const AddressMap &writeMap);
     ~MemcHardware() = default;
 
+    // Accessors
+    const VIDC10 &getVideoController() const { return _vidc; }
+    IOC &getIOController() { return _ioc; }
+    bool isVideoDmaEnabled() const { return _videoDMAEnabled; }
+    uint32_t getRenderedLineCount() const { return _renderedLineCount; }
+
+    // For compatibility with GenericHardware.
+    VideoFrameExchange *getVideoFrames() noexcept
+    {
+        return _isVideoOutputEnabled ? &_frameExchange : nullptr;
+    }
+
+    // For compatibility with GenericHardware.
+    SoundSampleRing *getSoundSamples() noexcept { return _soundRing.get(); }
+
+    uint8_t translateAddress(uint32_t logicalAddr, uint32_t &physAddr, bool isWrite) const;
+    uint8_t tryGetReadHostMapping(uint32_t physAddr, void *&hostBlock,
+                                  uint32_t &length);
+    uint8_t tryGetWriteHostMapping(uint32_t physAddr, void *&hostBlock,
+                                   uint32_t &length);
+
     // Operations
     void setLowRom(const uint8_t *romBytes, size_t byteCount);
     void setHighRom(const uint8_t *romBytes, size_t byteCount);
+    bool renderFrame(FrameConverter &converter, uint32_t *target,
+                     size_t stride);
+    void invalidateFrame();
+    void markHostWrite(uint32_t physAddr, uint32_t byteCount);
+    bool publishFrame(uint64_t &sequence, uint32_t &dirtyLineCount);
+    bool performSoundDma(SystemContext &context, uint8_t *samples,
+                         bool &isQueued);
 
     // Overrides
     // For compatibility with GenericHardware.
     void reset();
+    void captureState(SystemSnapshot &snapshot) const;
+    void restoreState(SnapshotReader &reader);
 
     // For compatibility with GenericHardware.
     template<typename T>
     bool write(uint32_t logicalAddr, T value)
+    {
+        NullMmioCounter mmioCounter;
+
+        return dispatchWrite(logicalAddr, value, mmioCounter);
+    }
+
+    // For compatibility with GenericHardware.
+    template<typename T>
+    bool read(uint32_t logicalAddr, T &value)
+    {
+        NullMmioCounter mmioCounter;
+
+        return dispatchRead(logicalAddr, value, mmioCounter);
+    }
+
+    // For compatibility with GenericHardware.
+    template<typename T>
+    bool exchange(uint32_t logicalAddr, T writeValue, T &readValue)
+    {
+        void *hostBlock;
+        uint32_t length;
+        uint8_t result = tryGetWriteHostMapping(logicalAddr, hostBlock, length);
+        bool isWritten = false;
+
+        // NOTE: Poetic license here: If the address doesn't map to some
+        // kind of conventional RAM, raise the abort signal.
+        if (result == AddrMapResult::Success)
+        {
+            T *target = reinterpret_cast<T *>(hostBlock);
+
+            // TODO: Use atomic exchange? Is it worth it?
+            readValue = *target;
+            *target = writeValue;
+            markVideoWrite(hostBlock, sizeof(T));
+            isWritten = true;
+        }
+
+        return isWritten;
+    }
+
+    bool logicalToPhysicalAddress(uint32_t logicalAddr, PageMapping &mapping) const;
+
+    // For compatibility with GenericHardware.
+    bool writeWords(uint32_t logicalAddr, const uint32_t *values, uint8_t count)
+    {
+        NullMmioCounter mmioCounter;
+
+        return dispatchWriteWords(logicalAddr, values, count, mmioCounter);
+    }
+
+    // For compatibility with GenericHardware.
+    bool readWords(uint32_t logicalAddr, uint32_t *results, uint8_t count)
+    {
+        NullMmioCounter mmioCounter;
+
+        return dispatchReadWords(logicalAddr, results, count, mmioCounter);
+    }
+
+    AddressMap createMasterReadMap();
+    AddressMap createMasterWriteMap();
+protected:
+    // Internal Functions
+    //! @brief Writes a value to a logical address, reporting accesses to
+    //! memory mapped devices to a counter.
+    template<typename T, typename TMmioCounter>
+    bool dispatchWrite(uint32_t logicalAddr, T value, TMmioCounter &mmioCounter)
     {
         void *hostBlock;
         uint32_t length;
@@ -149,6 +322,7 @@ public:
             // The block maps to host memory and the processor has enough
             // privileges to write to it.
             *reinterpret_cast<T *>(hostBlock) = value;
+            markVideoWrite(hostBlock, sizeof(T));
             isWritten = true;
         }
         else if (result == AddrMapResult::AccessAllowed)
@@ -163,6 +337,7 @@ public:
                 // i.e. the data doesn't matter, the address encodes the value
                 // being written.
                 writeMEMC(logicalAddr, replicate(value));
+                mmioCounter.onAccess(1);
             }
             else if (_writeAddrDecoder.tryFindRegion(logicalAddr, region, offset, length))
             {
@@ -175,6 +350,7 @@ public:
                 else
                 {
                     reinterpret_cast<IMMIOBlockPtr>(region)->write(offset, value);
+                    mmioCounter.onAccess(1);
                 }
             }
         }
@@ -187,9 +363,10 @@ public:
         return isWritten;
     }
 
-    // For compatibility with GenericHardware.
-    template<typename T>
-    bool read(uint32_t logicalAddr, T &value)
+    //! @brief Reads a value from a logical address, reporting accesses to
+    //! memory mapped devices to a counter.
+    template<typename T, typename TMmioCounter>
+    bool dispatchRead(uint32_t logicalAddr, T &value, TMmioCounter &mmioCounter)
     {
         void *hostBlock;
         uint32_t length;
@@ -220,6 +397,7 @@ public:
                 {
                     // Read from memory mapped I/O.
                     uint32_t word = reinterpret_cast<IMMIOBlockPtr>(region)->read(offset);
+                    mmioCounter.onAccess(1);
 
                     // Truncate the value.
                     value = static_cast<T>(word);
@@ -240,37 +418,59 @@ public:
         return isRead;
     }
 
+    template<typename TMmioCounter>
+    bool dispatchWriteWords(uint32_t logicalAddr, const uint32_t *values,
+                            uint8_t count, TMmioCounter &mmioCounter);
+    template<typename TMmioCounter>
+    bool dispatchReadWords(uint32_t logicalAddr, uint32_t *results,
+                           uint8_t count, TMmioCounter &mmioCounter);
+};
+
+//! @brief MEMC-based hardware for systems built with instrumentation, which
+//! also counts the reads and writes passed to memory mapped devices.
+class CountingMemcHardware : public MemcHardware
+{
+public:
+    // Public Constants
     // For compatibility with GenericHardware.
-    template<typename T>
-    bool exchange(uint32_t logicalAddr, T writeValue, T &readValue)
-    {
-        void *hostBlock;
-        uint32_t length;
-        uint8_t result = tryGetWriteHostMapping(logicalAddr, hostBlock, length);
-        bool isWritten = false;
+    static constexpr bool CountsMmio = true;
 
-        // NOTE: Poetic license here: If the address doesn't map to some
-        // kind of conventional RAM, raise the abort signal.
-        if (result == AddrMapResult::Success)
-        {
-            T *target = reinterpret_cast<T *>(hostBlock);
+    // Construction/Destruction
+    using MemcHardware::MemcHardware;
 
-            // TODO: Use atomic exchange? Is it worth it?
-            readValue = *target;
-            *target = writeValue;
-            isWritten = true;
-        }
+    // Accessors
+    // For compatibility with GenericHardware.
+    uint64_t getMmioAccessCount() const { return _mmioCounter.Count; }
 
-        return isWritten;
+    // Operations
+    // For compatibility with GenericHardware.
+    template<typename T>
+    bool write(uint32_t logicalAddr, T value)
+    {
+        return dispatchWrite(logicalAddr, value, _mmioCounter);
     }
 
-    bool logicalToPhysicalAddress(uint32_t logicalAddr, PageMapping &mapping) const;
+    // For compatibility with GenericHardware.
+    template<typename T>
+    bool read(uint32_t logicalAddr, T &value)
+    {
+        return dispatchRead(logicalAddr, value, _mmioCounter);
+    }
 
-    bool writeWords(uint32_t logicalAddr, const uint32_t *values, uint8_t count);
-    bool readWords(uint32_t logicalAddr, uint32_t *results, uint8_t count);
+    // For compatibility with GenericHardware.
+    bool writeWords(uint32_t logicalAddr, const uint32_t *values, uint8_t count)
+    {
+        return dispatchWriteWords(logicalAddr, values, count, _mmioCounter);
+    }
 
-    AddressMap createMasterReadMap();
-    AddressMap createMasterWriteMap();
+    // For compatibility with GenericHardware.
+    bool readWords(uint32_t logicalAddr, uint32_t *results, uint8_t count)
+    {
+        return dispatchReadWords(logicalAddr, results, count, _mmioCounter);
+    }
+private:
+    // Internal Fields
+    MmioAccessCounter _mmioCounter;
 };
 
 }} // namespace Mo::Arm
@@ -0,0 +1,926 @@
+//! @file ArmEmu/PerfTestResults.cpp
+//! @brief The definition of objects which record, store and compare the
+//! results of EmuPerfTest benchmark runs.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <locale>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PERF_TEST_USE_MSVC_CPUID
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define PERF_TEST_USE_GCC_CPUID
+#endif
+
+#ifndef _WIN32
+#include <sys/utsname.h>
+#endif
+
+#include "PerfTestResults.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A node in a tree of parsed JSON values.
+struct JsonValue
+{
+    enum class Type
+    {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    Type ValueType = Type::Null;
+    bool Boolean = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<JsonValue> Items;
+    std::vector<std::pair<std::string, JsonValue>> Members;
+
+    //! @brief Finds a member of an object by name.
+    const JsonValue *find(const char *name) const
+    {
+        const JsonValue *member = nullptr;
+
+        for (const auto &pair : Members)
+        {
+            if (pair.first == name)
+            {
+                member = &pair.second;
+                break;
+            }
+        }
+
+        return member;
+    }
+
+    //! @brief Gets a string member of an object, or an empty string.
+    std::string getString(const char *name) const
+    {
+        const JsonValue *member = find(name);
+
+        return ((member != nullptr) && (member->ValueType == Type::String)) ?
+               member->String : std::string();
+    }
+
+    //! @brief Gets a numeric member of an object, or 0.
+    double getNumber(const char *name) const
+    {
+        const JsonValue *member = find(name);
+
+        return ((member != nullptr) && (member->ValueType == Type::Number)) ?
+               member->Number : 0.0;
+    }
+
+    //! @brief Gets an array of numbers from a member of an object.
+    std::vector<double> getNumbers(const char *name) const
+    {
+        std::vector<double> numbers;
+        const JsonValue *member = find(name);
+
+        if ((member != nullptr) && (member->ValueType == Type::Array))
+        {
+            for (const JsonValue &item : member->Items)
+            {
+                if (item.ValueType == Type::Number)
+                {
+                    numbers.push_back(item.Number);
+                }
+            }
+        }
+
+        return numbers;
+    }
+};
+
+//! @brief A recursive descent parser of the subset of JSON written by
+//! SuiteResults::write().
+class JsonParser
+{
+public:
+    //! @brief Constructs a parser over a complete document.
+    explicit JsonParser(const std::string &text) :
+        _text(text),
+        _pos(0)
+    {
+    }
+
+    //! @brief Parses the document as a single value.
+    bool tryParse(JsonValue &root, std::string &error)
+    {
+        bool isOK = parseValue(root, 0);
+
+        if (isOK)
+        {
+            skipSpace();
+
+            if (_pos < _text.length())
+            {
+                isOK = false;
+                _error = "Unexpected text after the end of the document";
+            }
+        }
+
+        if (!isOK)
+        {
+            error = _error + " at offset " + std::to_string(_pos) + '.';
+        }
+
+        return isOK;
+    }
+private:
+    //! @brief The maximum nesting of arrays and objects accepted.
+    static constexpr int MaxDepth = 32;
+
+    void skipSpace()
+    {
+        while ((_pos < _text.length()) &&
+               ((_text[_pos] == ' ') || (_text[_pos] == '\t') ||
+                (_text[_pos] == '\r') || (_text[_pos] == '\n')))
+        {
+            ++_pos;
+        }
+    }
+
+    bool tryConsume(char next)
+    {
+        skipSpace();
+        bool isConsumed = (_pos < _text.length()) && (_text[_pos] == next);
+
+        if (isConsumed)
+        {
+            ++_pos;
+        }
+
+        return isConsumed;
+    }
+
+    bool tryConsumeWord(const char *word)
+    {
+        const size_t length = std::strlen(word);
+        bool isConsumed = (_text.compare(_pos, length, word) == 0);
+
+        if (isConsumed)
+        {
+            _pos += length;
+        }
+
+        return isConsumed;
+    }
+
+    bool fail(const char *message)
+    {
+        _error = message;
+        return false;
+    }
+
+    bool parseString(std::string &value)
+    {
+        value.clear();
+
+        if (tryConsume('"') == false)
+            return fail("Expected a string");
+
+        while (_pos < _text.length())
+        {
+            char next = _text[_pos++];
+
+            if (next == '"')
+            {
+                return true;
+            }
+            else if (next != '\\')
+            {
+                value.push_back(next);
+            }
+            else if (_pos < _text.length())
+            {
+                char escaped = _text[_pos++];
+
+                switch (escaped)
+                {
+                case 'b': value.push_back('\b'); break;
+                case 'f': value.push_back('\f'); break;
+                case 'n': value.push_back('\n'); break;
+                case 'r': value.push_back('\r'); break;
+                case 't': value.push_back('\t'); break;
+                case 'u':
+                    // Only characters in the ASCII range are written.
+                    if (_pos + 4 > _text.length())
+                        return fail("Truncated character escape");
+
+                    value.push_back(static_cast<char>(std::stoul(_text.substr(_pos, 4),
+                                                                 nullptr, 16) & 0x7F));
+                    _pos += 4;
+                    break;
+
+                default: value.push_back(escaped); break;
+                }
+            }
+        }
+
+        return fail("Unterminated string");
+    }
+
+    bool parseValue(JsonValue &value, int depth)
+    {
+        skipSpace();
+
+        if (_pos >= _text.length())
+            return fail("Unexpected end of document");
+
+        if (depth > MaxDepth)
+            return fail("Values are nested too deeply");
+
+        bool isOK = true;
+        const char next = _text[_pos];
+
+        if (next == '{')
+        {
+            ++_pos;
+            value.ValueType = JsonValue::Type::Object;
+
+            if (tryConsume('}') == false)
+            {
+                do
+                {
+                    std::pair<std::string, JsonValue> member;
+
+                    isOK = parseString(member.first) &&
+                           (tryConsume(':') || fail("Expected ':'")) &&
+                           parseValue(member.second, depth + 1);
+
+                    if (isOK)
+                    {
+                        value.Members.push_back(std::move(member));
+                    }
+                } while (isOK && tryConsume(','));
+
+                isOK = isOK && (tryConsume('}') || fail("Expected '}'"));
+            }
+        }
+        else if (next == '[')
+        {
+            ++_pos;
+            value.ValueType = JsonValue::Type::Array;
+
+            if (tryConsume(']') == false)
+            {
+                do
+                {
+                    value.Items.emplace_back();
+                    isOK = parseValue(value.Items.back(), depth + 1);
+                } while (isOK && tryConsume(','));
+
+                isOK = isOK && (tryConsume(']') || fail("Expected ']'"));
+            }
+        }
+        else if (next == '"')
+        {
+            value.ValueType = JsonValue::Type::String;
+            isOK = parseString(value.String);
+        }
+        else if (tryConsumeWord("true") || tryConsumeWord("false"))
+        {
+            value.ValueType = JsonValue::Type::Boolean;
+            value.Boolean = (next == 't');
+        }
+        else if (tryConsumeWord("null"))
+        {
+            value.ValueType = JsonValue::Type::Null;
+        }
+        else
+        {
+            std::istringstream input(_text.substr(_pos, 32));
+            input.imbue(std::locale::classic());
+
+            if (input >> value.Number)
+            {
+                value.ValueType = JsonValue::Type::Number;
+                const std::streamoff length = input.eof() ? 32 : static_cast<std::streamoff>(input.tellg());
+                _pos = std::min(_text.length(), _pos + static_cast<size_t>(length));
+            }
+            else
+            {
+                isOK = fail("Unexpected character");
+            }
+        }
+
+        return isOK;
+    }
+
+    const std::string &_text;
+    size_t _pos;
+    std::string _error;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Writes a value as a quoted JSON string.
+void writeJsonString(std::ostream &output, const std::string &value)
+{
+    output.put('"');
+
+    for (char next : value)
+    {
+        switch (next)
+        {
+        case '"': output << "\\\""; break;
+        case '\\': output << "\\\\"; break;
+        case '\n': output << "\\n"; break;
+        case '\r': output << "\\r"; break;
+        case '\t': output << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(next) < 0x20)
+            {
+                output << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                       << static_cast<int>(next) << std::dec << std::setfill(' ');
+            }
+            else
+            {
+                output.put(next);
+            }
+            break;
+        }
+    }
+
+    output.put('"');
+}
+
+//! @brief Writes an array of numbers in JSON format.
+void writeJsonNumbers(std::ostream &output, const std::vector<double> &values)
+{
+    output.put('[');
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i > 0)
+        {
+            output << ", ";
+        }
+
+        output << values[i];
+    }
+
+    output.put(']');
+}
+
+//! @brief Gets the brand string of the host processor.
+std::string getProcessorName()
+{
+    std::string name;
+
+#if defined(PERF_TEST_USE_MSVC_CPUID) || defined(PERF_TEST_USE_GCC_CPUID)
+    uint32_t brand[12] = { 0 };
+    uint32_t maxLeaf = 0;
+
+#ifdef PERF_TEST_USE_MSVC_CPUID
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    maxLeaf = static_cast<uint32_t>(regs[0]);
+
+    if (maxLeaf >= 0x80000004)
+    {
+        for (int leaf = 0; leaf < 3; ++leaf)
+        {
+            __cpuid(reinterpret_cast<int *>(brand + (leaf * 4)), 0x80000002 + leaf);
+        }
+    }
+#else
+    maxLeaf = __get_cpuid_max(0x80000000, nullptr);
+
+    if (maxLeaf >= 0x80000004)
+    {
+        for (uint32_t leaf = 0; leaf < 3; ++leaf)
+        {
+            __get_cpuid(0x80000002 + leaf, brand + (leaf * 4), brand + (leaf * 4) + 1,
+                        brand + (leaf * 4) + 2, brand + (leaf * 4) + 3);
+        }
+    }
+#endif
+
+    name.assign(reinterpret_cast<const char *>(brand),
+                strnlen(reinterpret_cast<const char *>(brand), sizeof(brand)));
+#endif
+
+#ifdef __linux__
+    if (name.empty())
+    {
+        // Fall back to the kernel's description of the processor.
+        std::ifstream cpuInfo("/proc/cpuinfo");
+        std::string line;
+
+        while (name.empty() && std::getline(cpuInfo, line))
+        {
+            if ((line.compare(0, 10, "model name") == 0) ||
+                (line.compare(0, 8, "Hardware") == 0))
+            {
+                size_t separator = line.find(':');
+
+                if (separator != std::string::npos)
+                {
+                    name = line.substr(separator + 1);
+                }
+            }
+        }
+    }
+#endif
+
+    // Trim leading and trailing white space.
+    const size_t first = name.find_first_not_of(" \t");
+    const size_t last = name.find_last_not_of(" \t");
+
+    if (first == std::string::npos)
+    {
+        name.assign("Unknown");
+    }
+    else
+    {
+        name = name.substr(first, last + 1 - first);
+    }
+
+    return name;
+}
+
+//! @brief Gets a description of the host operating system.
+std::string getOperatingSystemName()
+{
+#ifdef _WIN32
+    return "Windows";
+#else
+    std::string name;
+    utsname info;
+
+    if (uname(&info) == 0)
+    {
+        name.assign(info.sysname);
+        name.push_back(' ');
+        name.append(info.release);
+    }
+    else
+    {
+        name.assign("Unknown");
+    }
+
+    return name;
+#endif
+}
+
+//! @brief Gets the name and version of the compiler the tool was built with.
+std::string getCompilerName()
+{
+#if defined(_MSC_VER)
+    return "MSVC " + std::to_string(_MSC_FULL_VER);
+#elif defined(__clang__)
+    return "Clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "GCC " __VERSION__;
+#else
+    return "Unknown";
+#endif
+}
+
+//! @brief Gets the current UTC time in ISO 8601 format.
+std::string getTimestamp()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc;
+    char buffer[32] = { 0 };
+
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+    return buffer;
+}
+
+//! @brief Evaluates the continued fraction for the incomplete beta function
+//! using the modified Lentz method.
+double calculateBetaContinuedFraction(double a, double b, double x)
+{
+    constexpr int MaxIterations = 300;
+    constexpr double Epsilon = 3.0e-14;
+    constexpr double Tiny = 1.0e-300;
+
+    const double qab = a + b;
+    const double qap = a + 1.0;
+    const double qam = a - 1.0;
+    double c = 1.0;
+    double d = 1.0 - (qab * x / qap);
+
+    if (std::fabs(d) < Tiny)
+        d = Tiny;
+
+    d = 1.0 / d;
+    double h = d;
+
+    for (int m = 1; m <= MaxIterations; ++m)
+    {
+        const double m2 = 2.0 * m;
+
+        // The even step of the recurrence.
+        double aa = m * (b - m) * x / ((qam + m2) * (a + m2));
+        d = 1.0 + (aa * d);
+        c = 1.0 + (aa / c);
+
+        if (std::fabs(d) < Tiny)
+            d = Tiny;
+
+        if (std::fabs(c) < Tiny)
+            c = Tiny;
+
+        d = 1.0 / d;
+        h *= d * c;
+
+        // The odd step of the recurrence.
+        aa = -(a + m) * (qab + m) * x / ((a + m2) * (qap + m2));
+        d = 1.0 + (aa * d);
+        c = 1.0 + (aa / c);
+
+        if (std::fabs(d) < Tiny)
+            d = Tiny;
+
+        if (std::fabs(c) < Tiny)
+            c = Tiny;
+
+        d = 1.0 / d;
+        const double delta = d * c;
+        h *= delta;
+
+        if (std::fabs(delta - 1.0) < Epsilon)
+            break;
+    }
+
+    return h;
+}
+
+//! @brief Calculates the regularised incomplete beta function I_x(a, b).
+double calculateIncompleteBeta(double a, double b, double x)
+{
+    double result = 0.0;
+
+    if (x >= 1.0)
+    {
+        result = 1.0;
+    }
+    else if (x > 0.0)
+    {
+        const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) -
+                                      std::lgamma(b) + (a * std::log(x)) +
+                                      (b * std::log(1.0 - x)));
+
+        // Use the symmetry relation where the continued fraction converges
+        // more rapidly.
+        if (x < ((a + 1.0) / (a + b + 2.0)))
+        {
+            result = front * calculateBetaContinuedFraction(a, b, x) / a;
+        }
+        else
+        {
+            result = 1.0 - (front * calculateBetaContinuedFraction(b, a, 1.0 - x) / b);
+        }
+    }
+
+    return result;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// HostInfo Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty description of a host.
+HostInfo::HostInfo() :
+    LogicalCores(0)
+{
+}
+
+//! @brief Describes the host the tool is running on.
+HostInfo HostInfo::query()
+{
+    HostInfo info;
+    info.OperatingSystem = getOperatingSystemName();
+    info.Processor = getProcessorName();
+    info.Compiler = getCompilerName();
+#ifdef _DEBUG
+    info.BuildType = "Debug";
+#else
+    info.BuildType = "Release";
+#endif
+    info.Timestamp = getTimestamp();
+    info.LogicalCores = std::thread::hardware_concurrency();
+
+    return info;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SampleStatistics Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates the summary statistics of a set of samples.
+//! @param[in] samples The measurements to summarise.
+SampleStatistics SampleStatistics::calculate(const std::vector<double> &samples)
+{
+    SampleStatistics stats = { samples.size(), 0.0, 0.0, 0.0, 0.0 };
+
+    if (samples.empty() == false)
+    {
+        stats.Mean = std::accumulate(samples.begin(), samples.end(), 0.0) /
+                     static_cast<double>(samples.size());
+
+        auto range = std::minmax_element(samples.begin(), samples.end());
+        stats.Min = *range.first;
+        stats.Max = *range.second;
+
+        if (samples.size() > 1)
+        {
+            double sumOfSquares = 0.0;
+
+            for (double sample : samples)
+            {
+                const double delta = sample - stats.Mean;
+                sumOfSquares += delta * delta;
+            }
+
+            stats.StdDev = std::sqrt(sumOfSquares / static_cast<double>(samples.size() - 1));
+        }
+    }
+
+    return stats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// WorkloadResult Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty set of measurements.
+WorkloadResult::WorkloadResult() :
+    Iterations(0),
+    Instructions(0),
+    Cycles(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SuiteResults Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Gets the description of the host the results were measured on.
+const HostInfo &SuiteResults::getHost() const
+{
+    return _host;
+}
+
+//! @brief Sets the description of the host the results were measured on.
+void SuiteResults::setHost(const HostInfo &host)
+{
+    _host = host;
+}
+
+//! @brief Gets the results of each workload in the order they were run.
+const std::vector<WorkloadResult> &SuiteResults::getResults() const
+{
+    return _results;
+}
+
+//! @brief Finds the results of a specific workload.
+//! @param[in] configuration The name of the emulated system configuration.
+//! @param[in] workload The name of the workload.
+//! @return A pointer to the results or nullptr if the workload wasn't run on
+//! the configuration.
+const WorkloadResult *SuiteResults::findResult(const std::string &configuration,
+                                               const std::string &workload) const
+{
+    auto pos = std::find_if(_results.begin(), _results.end(),
+                            [&](const WorkloadResult &result) {
+                                return (result.Configuration == configuration) &&
+                                       (result.Workload == workload);
+                            });
+
+    return (pos == _results.end()) ? nullptr : &(*pos);
+}
+
+//! @brief Appends the results of a workload.
+void SuiteResults::addResult(const WorkloadResult &result)
+{
+    _results.push_back(result);
+}
+
+//! @brief Writes the results as a JSON document.
+//! @param[in] output The stream to write to.
+void SuiteResults::write(std::ostream &output) const
+{
+    output.imbue(std::locale::classic());
+    output << std::setprecision(10);
+
+    output << "{\n"
+              "  \"tool\": \"EmuPerfTest\",\n"
+              "  \"formatVersion\": 1,\n"
+              "  \"host\": {\n"
+              "    \"os\": ";
+    writeJsonString(output, _host.OperatingSystem);
+    output << ",\n    \"cpu\": ";
+    writeJsonString(output, _host.Processor);
+    output << ",\n    \"logicalCores\": " << _host.LogicalCores
+           << ",\n    \"compiler\": ";
+    writeJsonString(output, _host.Compiler);
+    output << ",\n    \"buildType\": ";
+    writeJsonString(output, _host.BuildType);
+    output << ",\n    \"timestamp\": ";
+    writeJsonString(output, _host.Timestamp);
+    output << "\n  },\n  \"results\": [";
+
+    for (size_t i = 0; i < _results.size(); ++i)
+    {
+        const WorkloadResult &result = _results[i];
+
+        output << ((i == 0) ? "\n" : ",\n") << "    {\n      \"config\": ";
+        writeJsonString(output, result.Configuration);
+        output << ",\n      \"workload\": ";
+        writeJsonString(output, result.Workload);
+        output << ",\n      \"iterations\": " << result.Iterations
+               << ",\n      \"instructions\": " << result.Instructions
+               << ",\n      \"cycles\": " << result.Cycles
+               << ",\n      \"mips\": ";
+        writeJsonNumbers(output, result.MipsSamples);
+        output << ",\n      \"seconds\": ";
+        writeJsonNumbers(output, result.SecondsSamples);
+        output << "\n    }";
+    }
+
+    output << "\n  ]\n}\n";
+}
+
+//! @brief Replaces the current results with those read from a JSON document
+//! created by write().
+//! @param[in] input The stream to read from.
+//! @param[out] error Receives a description of why the document couldn't
+//! be read.
+//! @retval true The results were successfully read.
+//! @retval false The document was not valid, the current results are
+//! unchanged.
+bool SuiteResults::tryRead(std::istream &input, std::string &error)
+{
+    std::string text(std::istreambuf_iterator<char>(input), {});
+    JsonParser parser(text);
+    JsonValue root;
+    bool isOK = parser.tryParse(root, error);
+
+    if (isOK)
+    {
+        const JsonValue *host = root.find("host");
+        const JsonValue *results = root.find("results");
+
+        if ((root.getString("tool") != "EmuPerfTest") ||
+            (host == nullptr) || (results == nullptr) ||
+            (results->ValueType != JsonValue::Type::Array))
+        {
+            isOK = false;
+            error = "The document does not contain EmuPerfTest results.";
+        }
+        else
+        {
+            _host.OperatingSystem = host->getString("os");
+            _host.Processor = host->getString("cpu");
+            _host.LogicalCores = static_cast<uint32_t>(host->getNumber("logicalCores"));
+            _host.Compiler = host->getString("compiler");
+            _host.BuildType = host->getString("buildType");
+            _host.Timestamp = host->getString("timestamp");
+            _results.clear();
+
+            for (const JsonValue &item : results->Items)
+            {
+                WorkloadResult result;
+                result.Configuration = item.getString("config");
+                result.Workload = item.getString("workload");
+                result.Iterations = static_cast<uint32_t>(item.getNumber("iterations"));
+                result.Instructions = static_cast<uint64_t>(item.getNumber("instructions"));
+                result.Cycles = static_cast<uint64_t>(item.getNumber("cycles"));
+                result.MipsSamples = item.getNumbers("mips");
+                result.SecondsSamples = item.getNumbers("seconds");
+
+                _results.push_back(std::move(result));
+            }
+        }
+    }
+
+    return isOK;
+}
+
+//! @brief Compares the speed of each workload against a baseline.
+//! @param[in] baseline The results to compare against.
+//! @param[in] significance The p-value below which a difference is
+//! considered statistically significant.
+//! @param[in] minimumChange The smallest relative change in mean speed which
+//! is flagged as a regression or improvement.
+//! @return A comparison for each workload present in both sets of results.
+std::vector<ResultComparison> SuiteResults::compare(const SuiteResults &baseline,
+                                                    double significance,
+                                                    double minimumChange) const
+{
+    std::vector<ResultComparison> comparisons;
+
+    for (const WorkloadResult &current : _results)
+    {
+        const WorkloadResult *previous = baseline.findResult(current.Configuration,
+                                                             current.Workload);
+
+        if (previous == nullptr)
+            continue;
+
+        ResultComparison comparison;
+        comparison.Configuration = current.Configuration;
+        comparison.Workload = current.Workload;
+        comparison.Baseline = SampleStatistics::calculate(previous->MipsSamples);
+        comparison.Current = SampleStatistics::calculate(current.MipsSamples);
+        comparison.RelativeChange = (comparison.Baseline.Mean > 0.0) ?
+            (comparison.Current.Mean - comparison.Baseline.Mean) / comparison.Baseline.Mean :
+            0.0;
+        comparison.PValue = calculateWelchPValue(comparison.Baseline, comparison.Current);
+
+        const bool isSignificant = (comparison.PValue < significance);
+        comparison.IsRegression = isSignificant &&
+                                  (comparison.RelativeChange < -minimumChange);
+        comparison.IsImprovement = isSignificant &&
+                                   (comparison.RelativeChange > minimumChange);
+
+        comparisons.push_back(comparison);
+    }
+
+    return comparisons;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Global Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates the probability that two sets of samples with the
+//! given statistics have the same mean using Welch's unequal variances t-test.
+//! @param[in] lhs The statistics of the first set of samples.
+//! @param[in] rhs The statistics of the second set of samples.
+//! @return The two-tailed p-value, 1.0 if either set has fewer than two
+//! samples so that no conclusion can be drawn.
+double calculateWelchPValue(const SampleStatistics &lhs,
+                            const SampleStatistics &rhs)
+{
+    double pValue = 1.0;
+
+    if ((lhs.Count > 1) && (rhs.Count > 1))
+    {
+        const double lhsVar = (lhs.StdDev * lhs.StdDev) / static_cast<double>(lhs.Count);
+        const double rhsVar = (rhs.StdDev * rhs.StdDev) / static_cast<double>(rhs.Count);
+        const double errorVar = lhsVar + rhsVar;
+
+        if (errorVar > 0.0)
+        {
+            const double t = (lhs.Mean - rhs.Mean) / std::sqrt(errorVar);
+
+            // The Welch-Satterthwaite approximation of degrees of freedom.
+            const double dof = (errorVar * errorVar) /
+                               (((lhsVar * lhsVar) / static_cast<double>(lhs.Count - 1)) +
+                                ((rhsVar * rhsVar) / static_cast<double>(rhs.Count - 1)));
+
+            pValue = calculateIncompleteBeta(dof * 0.5, 0.5, dof / (dof + (t * t)));
+        }
+        else if (lhs.Mean != rhs.Mean)
+        {
+            // Both sets are perfectly consistent, but different.
+            pValue = 0.0;
+        }
+    }
+
+    return pValue;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,184 @@
+//! @file ArmEmu/PerfTestResults.hpp
+//! @brief The declaration of objects which record, store and compare the
+//! results of EmuPerfTest benchmark runs.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_PERF_TEST_RESULTS_HPP__
+#define __ARM_EMU_PERF_TEST_RESULTS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes the host machine a set of results was measured on.
+struct HostInfo
+{
+    //! @brief The name of the host operating system.
+    std::string OperatingSystem;
+
+    //! @brief The brand name of the host processor.
+    std::string Processor;
+
+    //! @brief The compiler the tool was built with.
+    std::string Compiler;
+
+    //! @brief Debug or Release.
+    std::string BuildType;
+
+    //! @brief The UTC time the results were measured in ISO 8601 format.
+    std::string Timestamp;
+
+    //! @brief The count of hardware threads the host supports.
+    uint32_t LogicalCores;
+
+    HostInfo();
+
+    static HostInfo query();
+};
+
+//! @brief Summary statistics of a set of repeated measurements.
+struct SampleStatistics
+{
+    //! @brief The count of samples.
+    size_t Count;
+
+    //! @brief The arithmetic mean of the samples.
+    double Mean;
+
+    //! @brief The sample standard deviation, 0 if there are fewer than
+    //! two samples.
+    double StdDev;
+
+    //! @brief The smallest sample.
+    double Min;
+
+    //! @brief The largest sample.
+    double Max;
+
+    static SampleStatistics calculate(const std::vector<double> &samples);
+};
+
+//! @brief The measurements taken from repeated runs of a workload on a
+//! specific system configuration.
+struct WorkloadResult
+{
+    //! @brief The name of the emulated system configuration.
+    std::string Configuration;
+
+    //! @brief The name of the workload, see PerfWorkload::Name.
+    std::string Workload;
+
+    //! @brief The count of iterations of the workload in each run.
+    uint32_t Iterations;
+
+    //! @brief The count of guest instructions executed in each run.
+    uint64_t Instructions;
+
+    //! @brief The count of emulated processor cycles in each run.
+    uint64_t Cycles;
+
+    //! @brief The emulated speed achieved in each run in millions of
+    //! instructions per host second.
+    std::vector<double> MipsSamples;
+
+    //! @brief The host time taken by each run in seconds.
+    std::vector<double> SecondsSamples;
+
+    WorkloadResult();
+};
+
+//! @brief The outcome of comparing the results of a workload against a
+//! baseline.
+struct ResultComparison
+{
+    //! @brief The name of the emulated system configuration.
+    std::string Configuration;
+
+    //! @brief The name of the workload compared.
+    std::string Workload;
+
+    //! @brief The speed measured in the baseline in MIPS.
+    SampleStatistics Baseline;
+
+    //! @brief The speed measured in the current run in MIPS.
+    SampleStatistics Current;
+
+    //! @brief The relative change in mean speed, negative if slower.
+    double RelativeChange;
+
+    //! @brief The two-tailed probability that a difference at least this
+    //! large would be seen if the true speeds were equal.
+    double PValue;
+
+    //! @brief True if the current run is significantly slower.
+    bool IsRegression;
+
+    //! @brief True if the current run is significantly faster.
+    bool IsImprovement;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The complete set of results from a run of the benchmark suite.
+class SuiteResults
+{
+public:
+    // Public Constants
+    //! @brief The significance level below which a difference is reported.
+    static constexpr double DefaultSignificance = 0.05;
+
+    //! @brief The smallest relative change in speed which is reported, so
+    //! that tiny but consistent differences aren't flagged.
+    static constexpr double DefaultMinimumChange = 0.02;
+
+    // Construction/Destruction
+    SuiteResults() = default;
+    ~SuiteResults() = default;
+
+    // Accessors
+    const HostInfo &getHost() const;
+    void setHost(const HostInfo &host);
+    const std::vector<WorkloadResult> &getResults() const;
+    const WorkloadResult *findResult(const std::string &configuration,
+                                     const std::string &workload) const;
+
+    // Operations
+    void addResult(const WorkloadResult &result);
+    void write(std::ostream &output) const;
+    bool tryRead(std::istream &input, std::string &error);
+    std::vector<ResultComparison> compare(const SuiteResults &baseline,
+                                          double significance = DefaultSignificance,
+                                          double minimumChange = DefaultMinimumChange) const;
+private:
+    // Internal Fields
+    HostInfo _host;
+    std::vector<WorkloadResult> _results;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Function Declarations
+////////////////////////////////////////////////////////////////////////////////
+double calculateWelchPValue(const SampleStatistics &lhs,
+                            const SampleStatistics &rhs);
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
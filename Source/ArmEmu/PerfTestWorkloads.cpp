@@ -0,0 +1,399 @@
+//! @file ArmEmu/PerfTestWorkloads.cpp
+//! @brief The definition of the guest programs which the EmuPerfTest tool
+//! runs to measure the performance of emulated systems.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstring>
+
+#include "Ag/Core.hpp"
+#include "AsmTools.hpp"
+
+#include "DhrystoneProgram.hpp"
+#include "MemcTestRom.hpp"
+#include "PerfTestWorkloads.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+// Workloads which need scratch memory use two 4 KB buffers 8 KB beyond their
+// main loop so that they are position independent and fit within the 32 KB of
+// RAM on the test bed.
+
+//! @brief Copies a 4 KB buffer a word at a time.
+const char *MemoryCopySource =
+    "    ADR R8,Main\n"
+    "    ADD R8,R8,#0x2000          ; Source buffer\n"
+    "    ADD R9,R8,#0x1000          ; Destination buffer\n"
+    ".Main\n"
+    "    MOV R1,R8\n"
+    "    MOV R2,R9\n"
+    "    MOV R3,#1024\n"
+    ".Copy\n"
+    "    LDR R4,[R1],#4\n"
+    "    STR R4,[R2],#4\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Copy\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n";
+
+//! @brief Copies a 4 KB buffer 8 words at a time using LDM/STM.
+const char *BlockTransferSource =
+    "    ADR R8,Main\n"
+    "    ADD R8,R8,#0x2000          ; Source buffer\n"
+    "    ADD R9,R8,#0x1000          ; Destination buffer\n"
+    ".Main\n"
+    "    MOV R1,R8\n"
+    "    MOV R2,R9\n"
+    "    MOV R3,#128\n"
+    ".Copy\n"
+    "    LDMIA R1!,{R4-R7,R10-R12,R14}\n"
+    "    STMIA R2!,{R4-R7,R10-R12,R14}\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Copy\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n";
+
+//! @brief Follows a data-dependent pattern of taken and not-taken branches
+//! and subroutine calls.
+const char *BranchSource =
+    "    MOV R5,#0\n"
+    ".Main\n"
+    "    MOV R3,#256\n"
+    ".Inner\n"
+    "    ADD R5,R5,R3\n"
+    "    TST R5,#1\n"
+    "    BNE Odd\n"
+    "    TST R5,#2\n"
+    "    BEQ Next\n"
+    "    BL Leaf\n"
+    "    B Next\n"
+    ".Odd\n"
+    "    BL Leaf\n"
+    ".Next\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Inner\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n"
+    "    B Done\n"
+    ".Leaf\n"
+    "    ADD R6,R6,#1\n"
+    "    MOV PC,R14\n";
+
+//! @brief Performs a chain of dependent MUL and MLA instructions with
+//! operands of varying magnitude.
+const char *MultiplySource =
+    "    MOV R4,#3\n"
+    "    MOV R5,#7\n"
+    ".Main\n"
+    "    MOV R3,#256\n"
+    ".Inner\n"
+    "    MUL R6,R4,R5\n"
+    "    MLA R7,R6,R4,R5\n"
+    "    MUL R4,R7,R5\n"
+    "    ADD R4,R4,#1\n"
+    "    MLA R5,R4,R6,R3\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Inner\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n";
+
+//! @brief Repeatedly raises a software interrupt with a minimal handler.
+const char *SoftwareInterruptSource =
+    ".Main\n"
+    "    MOV R3,#64\n"
+    ".Inner\n"
+    "    SWI 0x10\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Inner\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n"
+    "    B Done\n"
+    ".SwiHandler\n"
+    "    ADD R6,R6,#1\n"
+    "    MOVS PC,R14\n";
+
+//! @brief Polls the IOC interrupt status registers.
+const char *MmioPollingSource =
+    "    MOV R8,#0x3200000          ; IOC base address\n"
+    ".Main\n"
+    "    MOV R3,#256\n"
+    ".Inner\n"
+    "    LDRB R4,[R8,#0x10]         ; IRQ status A\n"
+    "    LDRB R5,[R8,#0x20]         ; IRQ status B\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Inner\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n";
+
+//! @brief Reads and writes a word in each of 64 consecutive 8 KB pages of
+//! logically mapped RAM.
+const char *PageTranslationSource =
+    "    MOV R8,#0x40000            ; Logical address 256 KB\n"
+    ".Main\n"
+    "    MOV R1,R8\n"
+    "    MOV R3,#64\n"
+    ".Inner\n"
+    "    LDR R4,[R1]\n"
+    "    STR R4,[R1,#4]\n"
+    "    ADD R1,R1,#0x2000\n"
+    "    SUBS R3,R3,#1\n"
+    "    BNE Inner\n"
+    "    SUBS R0,R0,#1\n"
+    "    BNE Main\n";
+
+//! @brief Starts IOC timer 0 at 100 Hz and routes exceptions to the workload
+//! before entering it on a system booted from the MEMC test ROM.
+//! @details Expects the iteration count in R0, the workload entry point in R1
+//! and the address of its software interrupt handler, or 0, in R2. The test
+//! ROM vectors each exception through an address stored 32 bytes beyond its
+//! hardware vector.
+const char *MemcHarnessSource =
+    "    MOV R8,#0x3200000          ; IOC base address\n"
+    "    MOV R3,#0\n"
+    "    STRB R3,[R8,#0x28]         ; Mask IRQ B, including the KART\n"
+    "    STRB R3,[R8,#0x18]         ; Mask IRQ A\n"
+    "    ADR R4,TimerIrqHandler\n"
+    "    STR R4,[R3,#0x38]          ; Route IRQs to the timer handler\n"
+    "    CMP R2,#0\n"
+    "    STRNE R2,[R3,#0x28]        ; Route SWIs to the workload\n"
+    "    MOV R4,#0x1F               ; Latch 19999 at 2 MHz for 100 Hz\n"
+    "    STRB R4,[R8,#0x40]         ; Timer 0 latch low\n"
+    "    MOV R4,#0x4E\n"
+    "    STRB R4,[R8,#0x44]         ; Timer 0 latch high\n"
+    "    STRB R4,[R8,#0x48]         ; Timer 0 go\n"
+    "    MOV R4,#0x20\n"
+    "    STRB R4,[R8,#0x14]         ; Clear any pending timer 0 IRQ\n"
+    "    STRB R4,[R8,#0x18]         ; Enable only the timer 0 IRQ\n"
+    "    MOV PC,R1\n"
+    ".TimerIrqHandler\n"
+    "    STMFD R13!,{R0,R1}\n"
+    "    MOV R0,#0x3200000\n"
+    "    MOV R1,#0x20\n"
+    "    STRB R1,[R0,#0x14]         ; Acknowledge timer 0\n"
+    "    LDMFD R13!,{R0,R1}\n"
+    "    SUBS PC,R14,#4\n";
+
+//! @brief The idle loop the MEMC test ROM ends with: B $
+constexpr uint32_t MemcRomIdleLoop = 0xEAFFFFFE;
+
+//! @brief The instruction the idle loop is replaced with: BKPT 0
+constexpr uint32_t MemcRomHalt = 0xE1200070;
+
+//! @brief The common end of all workloads, subroutines branch to it.
+const char *WorkloadEpilogue =
+    "\n"
+    ".Done\n"
+    "    BKPT 0\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Assembles the source code of a workload or harness.
+//! @param[in] name The name of the program to report in errors.
+//! @param[in] source The complete assembly language source code.
+//! @param[in] loadAddress The logical address the code will be loaded at.
+//! @param[out] image Receives the machine code and entry points.
+//! @param[out] error Receives an error message on failure.
+//! @retval true The program was successfully assembled.
+//! @retval false The source code contained errors.
+bool tryAssembleSource(const char *name, const std::string &source,
+                       uint32_t loadAddress, WorkloadImage &image,
+                       std::string &error)
+{
+    bool isOK = true;
+    image.Code.clear();
+    image.LoadAddress = loadAddress;
+    image.SwiHandlerAddress = 0;
+
+    Asm::Options opts;
+    opts.setLoadAddress(loadAddress);
+    opts.setInstructionSet(Asm::InstructionSet::ArmV4);
+
+    Asm::Messages log;
+    Asm::ObjectCode objectCode = Asm::assembleText(source, opts, log);
+
+    if (log.hasErrors())
+    {
+        isOK = false;
+        error.assign("Failed to assemble '");
+        error.append(name);
+        error.append("':\n");
+
+        for (const auto &msg : log.getMessages())
+        {
+            error.append(msg.toString().getUtf8Bytes());
+            error.push_back('\n');
+        }
+    }
+    else
+    {
+        const uint8_t *code = static_cast<const uint8_t *>(objectCode.getCode());
+        image.Code.assign(code, code + objectCode.getCodeSize());
+
+        const Asm::SymbolMap &symbols = objectCode.getSymbols();
+        auto handlerPos = symbols.find(Ag::String("SwiHandler"));
+
+        if (handlerPos != symbols.end())
+        {
+            image.SwiHandlerAddress = handlerPos->second;
+        }
+    }
+
+    return isOK;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// Global Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Gets the collection of workloads in the order they should be run.
+const std::vector<PerfWorkload> &getPerfWorkloads()
+{
+    static const std::vector<PerfWorkload> workloads = {
+        { "dhrystone", "The Dhrystone 2.1 benchmark.", nullptr, 3000000, false },
+        { "memcpy", "Word-by-word LDR/STR memory copy.", MemoryCopySource, 5000, false },
+        { "ldm-stm", "LDM/STM block memory copy.", BlockTransferSource, 20000, false },
+        { "branch", "Data-dependent branches and subroutine calls.", BranchSource, 10000, false },
+        { "multiply", "Dependent MUL/MLA chains.", MultiplySource, 10000, false },
+        { "swi", "Software interrupt entry and exit.", SoftwareInterruptSource, 50000, false },
+        { "mmio-poll", "Polling IOC registers via memory mapped I/O.", MmioPollingSource, 10000, true },
+        { "memc-translated", "Access to RAM via MEMC page translation.", PageTranslationSource, 50000, true },
+    };
+
+    return workloads;
+}
+
+//! @brief Attempts to find a workload by name.
+//! @param[in] name The case-sensitive name of the workload.
+//! @return A pointer to the workload or nullptr if not found.
+const PerfWorkload *findPerfWorkload(std::string_view name)
+{
+    const PerfWorkload *found = nullptr;
+
+    for (const PerfWorkload &workload : getPerfWorkloads())
+    {
+        if (name == workload.Name)
+        {
+            found = &workload;
+            break;
+        }
+    }
+
+    return found;
+}
+
+//! @brief Gets the count of iterations to run a workload for by default,
+//! which is reduced in debug builds.
+//! @param[in] workload The workload to query.
+uint32_t getDefaultIterations(const PerfWorkload &workload)
+{
+#ifdef _DEBUG
+    return std::max(workload.DefaultIterations / 6, 1u);
+#else
+    return workload.DefaultIterations;
+#endif
+}
+
+//! @brief Prepares the machine code of a workload.
+//! @param[in] workload The workload to prepare.
+//! @param[in] loadAddress The logical address the code will be loaded at.
+//! @param[out] image Receives the machine code and entry points.
+//! @param[out] error Receives an error message on failure.
+//! @retval true The workload was successfully prepared.
+//! @retval false The workload source code could not be assembled.
+bool tryAssembleWorkload(const PerfWorkload &workload, uint32_t loadAddress,
+                         WorkloadImage &image, std::string &error)
+{
+    bool isOK = true;
+
+    if (workload.Source == nullptr)
+    {
+        // The Dhrystone benchmark is pre-assembled and position independent.
+        size_t byteCount = 0;
+        const uint8_t *program = static_cast<const uint8_t *>(getDhrystoneData(byteCount));
+
+        image.Code.assign(program, program + byteCount);
+        image.LoadAddress = loadAddress;
+        image.SwiHandlerAddress = 0;
+    }
+    else
+    {
+        std::string source(workload.Source);
+        source.append(WorkloadEpilogue);
+
+        isOK = tryAssembleSource(workload.Name, source, loadAddress, image, error);
+    }
+
+    return isOK;
+}
+
+//! @brief Prepares the harness which installs an interrupt handler, starts
+//! an IOC timer and then enters a workload on a system booted from the MEMC
+//! test ROM.
+//! @param[out] image Receives the machine code of the harness to be loaded
+//! at MemcHarnessAddress.
+//! @param[out] error Receives an error message on failure.
+//! @retval true The harness was successfully prepared.
+//! @retval false The harness source code could not be assembled.
+bool tryAssembleMemcHarness(WorkloadImage &image, std::string &error)
+{
+    return tryAssembleSource("MEMC harness", MemcHarnessSource,
+                             MemcHarnessAddress, image, error);
+}
+
+//! @brief Prepares a copy of the MEMC test ROM which halts once it has
+//! initialised the system rather than entering an idle loop.
+//! @param[out] rom Receives the bytes of the ROM image to load at
+//! MemcLowRomBase.
+//! @param[out] haltAddress Receives the logical address of the break point
+//! the ROM will halt on.
+//! @param[out] error Receives an error message on failure.
+//! @retval true The ROM image was successfully prepared.
+//! @retval false The idle loop at the end of the ROM could not be found.
+bool tryPrepareMemcBootRom(std::vector<uint8_t> &rom, uint32_t &haltAddress,
+                           std::string &error)
+{
+    size_t byteCount = 0;
+    const uint8_t *romData = static_cast<const uint8_t *>(getMemcTestRomData(byteCount));
+
+    rom.assign(romData, romData + byteCount);
+    haltAddress = 0;
+
+    // Find the last idle loop instruction, which the ROM ends with.
+    for (size_t offset = byteCount & ~static_cast<size_t>(3); offset >= 4; offset -= 4)
+    {
+        uint32_t instruction;
+        std::memcpy(&instruction, rom.data() + offset - 4, sizeof(instruction));
+
+        if (instruction == MemcRomIdleLoop)
+        {
+            std::memcpy(rom.data() + offset - 4, &MemcRomHalt, sizeof(MemcRomHalt));
+            haltAddress = MemcLowRomBase + static_cast<uint32_t>(offset - 4);
+            break;
+        }
+    }
+
+    if (haltAddress == 0)
+    {
+        error.assign("The MEMC test ROM does not end with an idle loop.");
+    }
+
+    return haltAddress != 0;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,98 @@
+//! @file ArmEmu/PerfTestWorkloads.hpp
+//! @brief The declaration of the guest programs which the EmuPerfTest tool
+//! runs to measure the performance of emulated systems.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_PERF_TEST_WORKLOADS_HPP__
+#define __ARM_EMU_PERF_TEST_WORKLOADS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ArmEmu/ArmSystem.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Constant Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The physical address of the low ROM on a MEMC-based system.
+constexpr uint32_t MemcLowRomBase = 0x3400000;
+
+//! @brief The logical address the harness which starts a workload on a
+//! MEMC-based system is loaded at.
+constexpr uint32_t MemcHarnessAddress = 0x10000;
+
+//! @brief The logical address workloads are loaded at on a MEMC-based system.
+constexpr uint32_t MemcWorkloadAddress = 0x20000;
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes a guest program which exercises a specific aspect of
+//! the emulator.
+//! @details Each workload expects the count of iterations to run in R0 and a
+//! full-descending stack in R13. It runs in supervisor mode and stops on a
+//! break point when complete.
+struct PerfWorkload
+{
+    //! @brief The short name used to select the workload and identify its
+    //! results.
+    const char *Name;
+
+    //! @brief A description of what the workload measures.
+    const char *Description;
+
+    //! @brief The assembly language source of the workload, or nullptr to use
+    //! the pre-assembled Dhrystone benchmark.
+    const char *Source;
+
+    //! @brief The count of iterations to run in a release build.
+    uint32_t DefaultIterations;
+
+    //! @brief True if the workload accesses memory mapped I/O or logically
+    //! mapped RAM, so can only run on a MEMC-based system.
+    bool RequiresMemc;
+};
+
+//! @brief The machine code of a workload ready to be written into guest
+//! memory.
+struct WorkloadImage
+{
+    //! @brief The bytes of machine code.
+    std::vector<uint8_t> Code;
+
+    //! @brief The logical address the code was assembled to run at.
+    uint32_t LoadAddress;
+
+    //! @brief The logical address of the workload's software interrupt
+    //! handler, or 0 if it doesn't define one.
+    uint32_t SwiHandlerAddress;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Function Declarations
+////////////////////////////////////////////////////////////////////////////////
+const std::vector<PerfWorkload> &getPerfWorkloads();
+const PerfWorkload *findPerfWorkload(std::string_view name);
+uint32_t getDefaultIterations(const PerfWorkload &workload);
+bool tryAssembleWorkload(const PerfWorkload &workload, uint32_t loadAddress,
+                         WorkloadImage &image, std::string &error);
+bool tryAssembleMemcHarness(WorkloadImage &image, std::string &error);
+bool tryPrepareMemcBootRom(std::vector<uint8_t> &rom, uint32_t &haltAddress,
+                           std::string &error);
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
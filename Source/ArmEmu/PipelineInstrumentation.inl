@@ -0,0 +1,171 @@
+//! @file ArmEmu/PipelineInstrumentation.inl
+//! @brief The declaration of components which an instruction pipeline uses to
+//! classify the instructions it executes, or not.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_PIPELINE_INSTRUMENTATION_INL__
+#define __ARM_EMU_PIPELINE_INSTRUMENTATION_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "Ag/Core/Binary.hpp"
+
+#include "ArmEmu/ExecutionMetrics.hpp"
+
+#include "ArmCore.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Takes the place of InstructionClassCounter in pipelines which
+//! don't classify the instructions they execute, leaving
+//! ExecutionMetrics::Breakdown empty.
+class NullPipelineInstrumentation
+{
+public:
+    // Public Constants
+    //! @brief Tells the pipeline not to classify instructions or results,
+    //! and the execution unit not to harvest counts after a run.
+    static constexpr bool IsEnabled = false;
+
+    // Operations
+    //! @brief Does nothing, no counts are accumulated.
+    void harvest(ExecutionBreakdown &/*breakdown*/) {}
+};
+
+//! @brief An object which counts the instructions executed by a pipeline by
+//! class along with pipeline flushes and mode changes.
+class InstructionClassCounter
+{
+public:
+    // Public Constants
+    //! @brief Tells the pipeline to classify each instruction and result.
+    static constexpr bool IsEnabled = true;
+
+    // Construction/Destruction
+    InstructionClassCounter() = default;
+
+    // Operations
+    //! @brief Accounts for an instruction which passed its condition test.
+    //! @param[in] instruction The 32-bit ARM instruction word executed.
+    void onInstructionExecuted(uint32_t instruction)
+    {
+        InstructionClass type = InstructionClass::Other;
+
+        switch ((instruction >> 25) & 0x07)
+        {
+        case 0x00:
+            if ((instruction & 0x90) == 0x90)
+            {
+                // Bits 7 and 4 are set: multiply, swap or an extension
+                // instruction the ARMv2 doesn't implement.
+                if ((instruction & 0x60) == 0)
+                {
+                    const uint32_t subOp = (instruction >> 23) & 0x03;
+
+                    if (subOp == 0)
+                    {
+                        type = InstructionClass::Multiply;
+                    }
+                    else if (subOp == 2)
+                    {
+                        type = InstructionClass::Swap;
+                    }
+                }
+            }
+            else if ((instruction & 0x01900000) == 0x01000000)
+            {
+                // A TST, TEQ, CMP or CMN which doesn't set the flags, space
+                // later architectures use for MRS, MSR and BKPT.
+                type = InstructionClass::Other;
+            }
+            else if (instruction & 0x10)
+            {
+                type = InstructionClass::AluShiftByRegister;
+            }
+            else
+            {
+                type = InstructionClass::AluRegister;
+            }
+            break;
+
+        case 0x01:
+            type = InstructionClass::AluImmediate;
+            break;
+
+        case 0x02:
+            type = InstructionClass::SingleTransfer;
+            break;
+
+        case 0x03:
+            // Bit 4 set with a register offset is an undefined instruction.
+            if ((instruction & 0x10) == 0)
+            {
+                type = InstructionClass::SingleTransfer;
+            }
+            break;
+
+        case 0x04:
+            type = InstructionClass::MultiTransfer;
+            ++_breakdown.MultiTransferSizes[Ag::Bin::popCount(instruction & 0xFFFF)];
+            break;
+
+        case 0x05:
+            type = InstructionClass::Branch;
+            break;
+
+        case 0x06:
+            type = InstructionClass::CoProcessor;
+            break;
+
+        case 0x07:
+            type = (instruction & 0x01000000) ? InstructionClass::SoftwareInterrupt :
+                                                InstructionClass::CoProcessor;
+            break;
+        }
+
+        ++_breakdown.ClassCounts[static_cast<size_t>(type)];
+    }
+
+    //! @brief Accounts for an instruction skipped because its condition
+    //! wasn't met.
+    void onConditionFailed()
+    {
+        ++_breakdown.ClassCounts[static_cast<size_t>(InstructionClass::ConditionFailed)];
+    }
+
+    //! @brief Accounts for the side effects of executing an instruction or
+    //! handling an exception.
+    //! @param[in] execResult The ExecResult flags and cycle count produced.
+    void onResult(uint32_t execResult)
+    {
+        _breakdown.PipelineFlushes += (execResult >> ExecResult::FlushShift) & 1;
+        _breakdown.ModeChanges += (execResult & ExecResult::ModeChange) ? 1 : 0;
+    }
+
+    //! @brief Adds the counts accumulated since the last harvest to a
+    //! breakdown and resets them.
+    //! @param[in,out] breakdown The breakdown to add the counts to.
+    void harvest(ExecutionBreakdown &breakdown)
+    {
+        breakdown += _breakdown;
+        _breakdown.reset();
+    }
+private:
+    // Internal Fields
+    ExecutionBreakdown _breakdown;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,219 @@
+//! @file ArmEmu/ProfileSampler.inl
+//! @brief The declaration of components which an execution unit uses to
+//! periodically sample the guest call stack, or not.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_PROFILE_SAMPLER_INL__
+#define __ARM_EMU_PROFILE_SAMPLER_INL__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "Ag/Core/Utils.hpp"
+
+#include "ArmEmu/AddressMap.hpp"
+#include "ArmEmu/GuestProfiler.hpp"
+
+#include "ArmCore.hpp"
+#include "RegisterFile.inl"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Takes the place of ProfileSampler in execution units which don't
+//! sample the guest call stack, it has no profiler and ignores the address
+//! map a sampler would read stack memory through.
+class NullProfileSampler
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit not to report the cycles elapsed
+    //! after each instruction.
+    static constexpr bool IsEnabled = false;
+
+    // Accessors
+    //! @brief Gets the profiler which accumulates samples, always nullptr.
+    GuestProfiler *getProfiler() { return nullptr; }
+
+    // Operations
+    //! @brief Does nothing.
+    void connect(const AddressMap * /*masterReadMap*/) { }
+};
+
+//! @brief A sampler which records the guest call stack every time a
+//! configurable count of processor cycles has elapsed.
+//! @details The call stack is approximated from the PC, R14 and any words on
+//! the stack below R13 which look like return addresses, i.e. ones which
+//! follow a BL instruction. Memory is only inspected if it is backed by host
+//! memory, so sampling never has side effects on emulated hardware.
+class ProfileSampler
+{
+public:
+    // Public Constants
+    //! @brief Tells the execution unit to report the cycles elapsed after
+    //! each instruction, so that samples can be taken at a fixed period.
+    static constexpr bool IsEnabled = true;
+
+    //! @brief The maximum count of stack words examined for return addresses.
+    static constexpr uint32_t MaxStackScanWords = 256;
+
+    // Construction/Destruction
+    //! @brief Constructs a sampler with profiling initially disabled.
+    ProfileSampler() :
+        _masterReadMap(nullptr),
+        _cyclesToNextSample(GuestProfiler::DefaultSamplePeriod)
+    {
+    }
+
+    // Accessors
+    //! @brief Gets the profiler which accumulates samples.
+    GuestProfiler *getProfiler() { return &_profiler; }
+
+    // Operations
+    //! @brief Provides the map of physical memory used to inspect the stack.
+    //! @param[in] masterReadMap The map of all readable physical memory, or
+    //! nullptr to only sample the PC and R14.
+    void connect(const AddressMap *masterReadMap)
+    {
+        _masterReadMap = masterReadMap;
+    }
+
+    //! @brief Accounts for processor cycles and samples the call stack if
+    //! a sample period has elapsed.
+    //! @tparam THardware The data type of the hardware modelled on
+    //! GenericHardware.
+    //! @tparam TRegisterFile The data type of the register file modelled on
+    //! GenericCoreRegisterFile.
+    //! @param[in] cycleCount The count of cycles the last instruction took.
+    //! @param[in] hw The hardware used to translate logical addresses.
+    //! @param[in] regs The register file to extract the call stack from.
+    //! @param[in] isFlushPending True if the PC points to the next
+    //! instruction to execute rather than the next to fetch.
+    template<typename THardware, typename TRegisterFile>
+    void onCyclesElapsed(uint32_t cycleCount, const THardware &hw,
+                         const TRegisterFile &regs, bool isFlushPending)
+    {
+        if (_cyclesToNextSample > cycleCount)
+        {
+            _cyclesToNextSample -= cycleCount;
+        }
+        else
+        {
+            _cyclesToNextSample = _profiler.getSamplePeriod();
+
+            if (_profiler.isEnabled())
+            {
+                sample(hw, regs, isFlushPending);
+            }
+        }
+    }
+private:
+    // Internal Functions
+    //! @brief Records the current call stack.
+    template<typename THardware, typename TRegisterFile>
+    void sample(const THardware &hw, const TRegisterFile &regs, bool isFlushPending)
+    {
+        constexpr uint32_t AddrMask = TRegisterFile::HasCombinedPcPsr ?
+                                      ~PsrMask26::PrivilageBits : ~3u;
+
+        uint32_t frames[GuestProfiler::MaxStackDepth];
+        uint8_t depth = 0;
+
+        // The PC is normally 8 bytes beyond the next instruction to execute.
+        uint32_t pc = regs.getPC() & AddrMask;
+        frames[depth++] = isFlushPending ? pc : pc - 8;
+
+        // R14 holds the return address of a leaf function.
+        uint32_t linkAddr = regs.getRn(GeneralRegister::R14) & AddrMask;
+
+        if (isReturnAddress(hw, linkAddr))
+        {
+            frames[depth++] = linkAddr;
+        }
+
+        // Scan up the stack for return addresses pushed by callers.
+        uint32_t stackAddr = regs.getRn(GeneralRegister::R13) & ~3u;
+
+        for (uint32_t i = 0; (i < MaxStackScanWords) &&
+                             (depth < GuestProfiler::MaxStackDepth); ++i)
+        {
+            uint32_t stackWord;
+
+            if (tryPeekWord(hw, stackAddr + (i * 4), stackWord) == false)
+            {
+                // Walked off the top of the stack.
+                break;
+            }
+
+            uint32_t returnAddr = stackWord & AddrMask;
+
+            if ((returnAddr != frames[depth - 1]) &&
+                isReturnAddress(hw, returnAddr))
+            {
+                frames[depth++] = returnAddr;
+            }
+        }
+
+        _profiler.recordSample(frames, depth);
+    }
+
+    //! @brief Determines whether an address immediately follows a BL
+    //! instruction and is therefore likely to be a return address.
+    template<typename THardware>
+    bool isReturnAddress(const THardware &hw, uint32_t address) const
+    {
+        uint32_t instruction = 0;
+
+        return (address >= 4) &&
+               tryPeekWord(hw, address - 4, instruction) &&
+               ((instruction & 0x0F000000) == 0x0B000000) &&
+               ((instruction >> 28) != 0x0F);
+    }
+
+    //! @brief Reads a word from guest memory without side effects.
+    //! @retval true The word was read from host memory.
+    //! @retval false The address was unmapped or mapped to a device.
+    template<typename THardware>
+    bool tryPeekWord(const THardware &hw, uint32_t logicalAddr, uint32_t &word) const
+    {
+        PageMapping mapping;
+        bool isRead = false;
+
+        if ((_masterReadMap != nullptr) &&
+            hw.logicalToPhysicalAddress(logicalAddr, mapping))
+        {
+            uint32_t physAddr = mapping.PageBaseAddr +
+                                ((logicalAddr & ~3u) - mapping.VirtualBaseAddr);
+            IAddressRegionPtr region = nullptr;
+            uint32_t offset, length;
+
+            if (_masterReadMap->tryFindRegion(physAddr, region, offset, length) &&
+                (region->getType() == RegionType::HostBlock))
+            {
+                void *hostBlock = static_cast<IHostBlockPtr>(region)->getHostAddress();
+                word = *Ag::offsetPtr<uint32_t>(hostBlock, offset);
+                isRead = true;
+            }
+        }
+
+        return isRead;
+    }
+
+    // Internal Fields
+    GuestProfiler _profiler;
+    const AddressMap *_masterReadMap;
+    uint32_t _cyclesToNextSample;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
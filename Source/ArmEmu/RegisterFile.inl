@@ -276,6 +276,15 @@ public:
     //! @returns A mask of InstructionResult bits indicating whether a
     //! pipeline flush or mode change occurred.
     uint32_t handleFirq() noexcept;
+
+    //! @brief Appends the contents of all registers, including banked and
+    //! co-processor registers, to a snapshot.
+    //! @param[in] snapshot The snapshot to append to.
+    void captureState(SystemSnapshot &snapshot) const;
+
+    //! @brief Restores register contents written by captureState().
+    //! @param[in] reader The object to read register contents from.
+    void restoreState(SnapshotReader &reader);
 };
 
 }} // namespace Mo::Arm
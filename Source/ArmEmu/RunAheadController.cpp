@@ -0,0 +1,275 @@
+//! @file ArmEmu/RunAheadController.cpp
+//! @brief The definition of an object which reduces input latency by
+//! speculatively running an emulated system ahead of real time.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/RunAheadController.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// RunAheadMetrics Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates an empty set of run-ahead metrics.
+RunAheadMetrics::RunAheadMetrics() :
+    FrameCount(0),
+    SpeculativeFrameCount(0),
+    BudgetOverrunCount(0),
+    FrameTime(0),
+    CaptureTime(0),
+    SpeculationTime(0),
+    RestoreTime(0)
+{
+}
+
+//! @brief Gets the total host time spent on running ahead rather than
+//! running frames for real.
+Ag::MonotonicTicks RunAheadMetrics::getOverheadTime() const
+{
+    return CaptureTime + SpeculationTime + RestoreTime;
+}
+
+//! @brief Calculates the cost of running ahead relative to the cost of
+//! running frames for real.
+//! @return The ratio of overhead time to real frame time, e.g. 1.5 means
+//! running ahead costs half as much again as emulation itself.
+double RunAheadMetrics::calculateOverhead() const
+{
+    double overhead = 0.0;
+
+    if (FrameTime > 0)
+    {
+        overhead = Ag::HighResMonotonicTimer::getTimeSpan(getOverheadTime()) /
+                   Ag::HighResMonotonicTimer::getTimeSpan(FrameTime);
+    }
+
+    return overhead;
+}
+
+//! @brief Calculates the average host time added to each real frame by
+//! running ahead.
+//! @return The average overhead in milliseconds.
+double RunAheadMetrics::calculateOverheadPerFrameMs() const
+{
+    double overhead = 0.0;
+
+    if (FrameCount > 0)
+    {
+        overhead = Ag::HighResMonotonicTimer::getTimeSpan(getOverheadTime()) * 1000.0;
+        overhead /= static_cast<double>(FrameCount);
+    }
+
+    return overhead;
+}
+
+//! @brief Resets all metrics to zero.
+void RunAheadMetrics::reset()
+{
+    FrameCount = 0;
+    SpeculativeFrameCount = 0;
+    BudgetOverrunCount = 0;
+    FrameTime = 0;
+    CaptureTime = 0;
+    SpeculationTime = 0;
+    RestoreTime = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RunAheadController Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object which runs an emulated system ahead of
+//! real time.
+//! @param[in] system The system to run, which must outlive this object.
+//! @note Running ahead is initially disabled, see setFramesAhead().
+RunAheadController::RunAheadController(IArmSystem *system) :
+    _system(system),
+    _framePeriod(DefaultFramePeriod),
+    _frameBudget(0),
+    _framesAhead(0)
+{
+}
+
+//! @brief Gets the count of frames run speculatively after each real frame.
+uint8_t RunAheadController::getFramesAhead() const
+{
+    return _framesAhead;
+}
+
+//! @brief Sets the count of frames run speculatively after each real frame.
+//! @param[in] frameCount The count of frames, 0 to disable running ahead.
+void RunAheadController::setFramesAhead(uint8_t frameCount)
+{
+    _framesAhead = frameCount;
+}
+
+//! @brief Gets the period of emulated time in each frame in microseconds.
+uint32_t RunAheadController::getFramePeriod() const
+{
+    return _framePeriod;
+}
+
+//! @brief Sets the period of emulated time in each frame.
+//! @param[in] microseconds The frame period, which must be non-zero.
+void RunAheadController::setFramePeriod(uint32_t microseconds)
+{
+    _framePeriod = std::max(microseconds, 1u);
+}
+
+//! @brief Gets the host time in microseconds each frame can spend on running
+//! ahead, 0 if unlimited.
+uint32_t RunAheadController::getFrameBudget() const
+{
+    return _frameBudget;
+}
+
+//! @brief Sets the host time each frame can spend on running ahead.
+//! @param[in] microseconds The budget, or 0 to always run the configured
+//! count of frames ahead.
+//! @note When the budget is exhausted, fewer frames are run ahead and
+//! RunAheadMetrics::BudgetOverrunCount is incremented.
+void RunAheadController::setFrameBudget(uint32_t microseconds)
+{
+    _frameBudget = microseconds;
+}
+
+//! @brief Gets the statistics gathered since the metrics were last reset.
+const RunAheadMetrics &RunAheadController::getMetrics() const
+{
+    return _metrics;
+}
+
+//! @brief Runs a single frame of the emulated system for real, followed by
+//! any speculative frames, leaving the system in the state at the end of
+//! the real frame.
+//! @return The metrics of the real frame. If the result is anything other
+//! than TimeLimit, the frame was cut short and no frames were run ahead.
+//! @note When running ahead, the video of the real frame is held back and
+//! only the last speculative frame publishes any. If speculation is
+//! abandoned early, no video is published until the next call.
+ExecutionMetrics RunAheadController::runFrame()
+{
+    using Timer = Ag::HighResMonotonicTimer;
+
+    const uint8_t heldOutputs = _system->getHeldOutputs();
+
+    if (_framesAhead > 0)
+    {
+        _system->setHeldOutputs(static_cast<uint8_t>(heldOutputs | HeldOutput::Video));
+    }
+
+    ExecutionMetrics metrics = _system->runFor(_framePeriod);
+
+    ++_metrics.FrameCount;
+    _metrics.FrameTime += metrics.ElapsedTime;
+
+    if ((metrics.ExecResult == ExecutionMetrics::Result::TimeLimit) &&
+        (_framesAhead > 0))
+    {
+        Ag::MonotonicTicks startTime = Timer::getTime();
+        _system->captureState(_snapshot);
+        _metrics.CaptureTime += Timer::getDuration(startTime);
+
+        // Speculative frames should run flat out, whatever the pacing.
+        bool wasTurboEnabled = _system->isTurboEnabled();
+        bool isHostInterrupted = false;
+        bool isSpeculating = true;
+        _system->setTurbo(true);
+
+        Ag::MonotonicTicks speculationStart = Timer::getTime();
+
+        for (uint8_t frame = 0; isSpeculating && (frame < _framesAhead); ++frame)
+        {
+            // Decide beforehand whether this is the last frame, so that it
+            // can present its video.
+            bool isLastFrame = ((frame + 1) == _framesAhead);
+
+            if ((isLastFrame == false) && (frame > 0) && isBudgetExhausted(startTime))
+            {
+                ++_metrics.BudgetOverrunCount;
+                isLastFrame = true;
+            }
+
+            // The sound and storage writes of frames which will be rolled
+            // back must never reach the host.
+            _system->setHeldOutputs(isLastFrame ?
+                                    static_cast<uint8_t>(HeldOutput::Sound | HeldOutput::Storage) :
+                                    HeldOutput::All);
+
+            ExecutionMetrics aheadMetrics = _system->runFor(_framePeriod);
+            ++_metrics.SpeculativeFrameCount;
+
+            if (aheadMetrics.ExecResult != ExecutionMetrics::Result::TimeLimit)
+            {
+                // Abandon speculation. A break point will be hit for real
+                // later, but a host interrupt must be passed on.
+                isHostInterrupted = (aheadMetrics.ExecResult == ExecutionMetrics::Result::HostIrq);
+                isSpeculating = false;
+            }
+            else if (isLastFrame)
+            {
+                isSpeculating = false;
+            }
+        }
+
+        _metrics.SpeculationTime += Timer::getDuration(speculationStart);
+
+        // Release storage before rolling back so that disc transfers in
+        // progress are re-attached to the real media.
+        _system->setHeldOutputs(heldOutputs);
+
+        Ag::MonotonicTicks restoreStart = Timer::getTime();
+        _system->restoreState(_snapshot);
+        _metrics.RestoreTime += Timer::getDuration(restoreStart);
+
+        _system->setTurbo(wasTurboEnabled);
+
+        if (isHostInterrupted)
+        {
+            // Ensure the next call to run the system returns promptly.
+            _system->raiseHostInterrupt();
+        }
+    }
+
+    _system->setHeldOutputs(heldOutputs);
+
+    return metrics;
+}
+
+//! @brief Resets the statistics gathered by runFrame().
+void RunAheadController::resetMetrics()
+{
+    _metrics.reset();
+}
+
+//! @brief Determines whether the host time spent running ahead in the
+//! current frame has used up the budget.
+//! @param[in] startTime The time at which running ahead started.
+bool RunAheadController::isBudgetExhausted(Ag::MonotonicTicks startTime) const
+{
+    bool isExhausted = false;
+
+    if (_frameBudget > 0)
+    {
+        double elapsed = Ag::HighResMonotonicTimer::getTimeSpan(
+            Ag::HighResMonotonicTimer::getDuration(startTime));
+
+        isExhausted = (elapsed * 1e6) >= _frameBudget;
+    }
+
+    return isExhausted;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
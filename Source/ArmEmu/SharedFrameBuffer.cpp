@@ -0,0 +1,476 @@
+//! @file ArmEmu/SharedFrameBuffer.cpp
+//! @brief The definition of objects which export the rendered display of an
+//! emulated system through shared memory so that other processes can observe
+//! it without copies or sockets.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ArmEmu/SharedFrameBuffer.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates the name of a POSIX shared memory object, which must start
+//! with a single slash.
+std::string toSharedObjectName(const std::string &name)
+{
+    return (name.empty() || (name.front() != '/')) ? ('/' + name) : name;
+}
+
+//! @brief Calculates the size of a region holding frames of a maximum size.
+size_t calculateRegionSize(uint32_t maxWidth, uint32_t maxHeight)
+{
+    return SharedFrameHeader::PixelOffset +
+           (static_cast<size_t>(maxWidth) * maxHeight * sizeof(uint32_t));
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// SharedFrameWriter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object with no shared memory region.
+SharedFrameWriter::SharedFrameWriter() :
+    _header(nullptr),
+    _pixels(nullptr),
+    _regionSize(0)
+{
+}
+
+//! @brief Removes any shared memory region created.
+SharedFrameWriter::~SharedFrameWriter()
+{
+    close();
+}
+
+//! @brief Determines whether a shared memory region has been created.
+bool SharedFrameWriter::isOpen() const
+{
+    return _header != nullptr;
+}
+
+//! @brief Gets the name of the shared memory object created.
+const std::string &SharedFrameWriter::getName() const
+{
+    return _name;
+}
+
+//! @brief Gets the header at the start of the shared memory region, or
+//! nullptr if none was created.
+const SharedFrameHeader *SharedFrameWriter::getHeader() const
+{
+    return _header;
+}
+
+//! @brief Gets the first pixel of the frame in the shared memory region, or
+//! nullptr if none was created.
+const uint32_t *SharedFrameWriter::getPixels() const
+{
+    return _pixels;
+}
+
+//! @brief Attempts to create a named shared memory region to export frames
+//! through.
+//! @param[in] name The name of the shared memory object, a leading slash is
+//! added if not present. Any existing object of the same name is replaced.
+//! @param[out] error Receives a description of why the region could not be
+//! created.
+//! @param[in] maxWidth The maximum width of the frames exported, in pixels.
+//! @param[in] maxHeight The maximum height of the frames exported, no more
+//! than SharedFrameHeader::MaxLineCount.
+//! @retval true The region was created and mapped.
+//! @retval false The region could not be created, error is updated.
+bool SharedFrameWriter::tryCreate(const std::string &name, std::string &error,
+                                  uint32_t maxWidth, uint32_t maxHeight)
+{
+    bool isCreated = false;
+
+    if (isOpen())
+    {
+        error = "A shared frame buffer has already been created.";
+    }
+    else if (name.empty())
+    {
+        error = "No name was specified for the shared frame buffer.";
+    }
+    else if ((maxWidth == 0) || (maxHeight == 0) ||
+             (maxHeight > SharedFrameHeader::MaxLineCount))
+    {
+        error = "The maximum frame dimensions are not valid.";
+    }
+#ifdef _WIN32
+    else
+    {
+        error = "Shared frame buffers are not supported on this platform.";
+    }
+#else
+    else
+    {
+        const std::string objectName = toSharedObjectName(name);
+        const size_t regionSize = calculateRegionSize(maxWidth, maxHeight);
+        const int handle = ::shm_open(objectName.c_str(), O_CREAT | O_TRUNC | O_RDWR,
+                                      S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        void *region = MAP_FAILED;
+
+        if (handle < 0)
+        {
+            error = "Could not create shared memory object '" + objectName + "': " +
+                    std::strerror(errno);
+        }
+        else if (::ftruncate(handle, static_cast<off_t>(regionSize)) != 0)
+        {
+            error = "Could not size shared memory object '" + objectName + "': " +
+                    std::strerror(errno);
+        }
+        else
+        {
+            region = ::mmap(nullptr, regionSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, handle, 0);
+
+            if (region == MAP_FAILED)
+            {
+                error = "Could not map shared memory object '" + objectName +
+                        "': " + std::strerror(errno);
+            }
+        }
+
+        if (handle >= 0)
+        {
+            // The mapping keeps the object alive.
+            ::close(handle);
+        }
+
+        if (region != MAP_FAILED)
+        {
+            // The object is zero-filled by ftruncate().
+            _header = new(region) SharedFrameHeader();
+            _header->Magic = SharedFrameHeader::MagicNumber;
+            _header->Version = SharedFrameHeader::CurrentVersion;
+            _header->PixelDataOffset = SharedFrameHeader::PixelOffset;
+            _header->MaxWidth = maxWidth;
+            _header->MaxHeight = maxHeight;
+            _header->UpdateCount.store(0, std::memory_order_release);
+
+            _pixels = reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(region) +
+                                                   SharedFrameHeader::PixelOffset);
+            _regionSize = regionSize;
+            _name = objectName;
+            _geometry = VidcTiming();
+            isCreated = true;
+        }
+        else if (handle >= 0)
+        {
+            ::shm_unlink(objectName.c_str());
+        }
+    }
+#endif
+
+    return isCreated;
+}
+
+//! @brief Unmaps and removes the shared memory region, if created.
+//! @note Readers which have already mapped the region keep their mapping.
+void SharedFrameWriter::close()
+{
+#ifndef _WIN32
+    if (_header != nullptr)
+    {
+        ::munmap(_header, _regionSize);
+        ::shm_unlink(_name.c_str());
+    }
+#endif
+
+    _header = nullptr;
+    _pixels = nullptr;
+    _regionSize = 0;
+    _name.clear();
+}
+
+//! @brief Renders the latest snapshot published by the emulated system
+//! directly into the shared memory region.
+//! @param[in] source The exchange frames are published to by the emulated
+//! system, see IArmSystem::getVideoFrames().
+//! @retval true The frame in shared memory was updated.
+//! @retval false No region was created, no snapshot was pending or the
+//! snapshot could not be applied.
+//! @note This member function acts as the sole consumer of the exchange and
+//! shouldn't be used alongside a VideoRenderThread.
+bool SharedFrameWriter::tryPublish(VideoFrameExchange &source)
+{
+    bool isUpdated = false;
+    const VideoFrame *frame = isOpen() ? source.tryAcquire() : nullptr;
+
+    if (frame != nullptr)
+    {
+        const uint32_t width = frame->Timing.getFrameWidth();
+        const uint32_t height = frame->Timing.getFrameHeight();
+
+        if ((width > _header->MaxWidth) || (height > _header->MaxHeight))
+        {
+            // The frame can't be exported, ensure the next which fits is
+            // written in its entirety.
+            _geometry = VidcTiming();
+        }
+        else if ((frame->Timing.isSameDisplay(_geometry) == false) &&
+                 (frame->getDirtyLineCount() != height))
+        {
+            // A partial update can't be applied to a frame of a different
+            // shape, wait for the whole frame.
+            source.requestFullRefresh();
+        }
+        else
+        {
+            const uint64_t updateCount = _header->UpdateCount.load(std::memory_order_relaxed);
+
+            // Mark the frame as being updated before changing anything.
+            _header->UpdateCount.store(updateCount + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            _header->Width = width;
+            _header->Height = height;
+            _header->FrameSequence = frame->Sequence;
+
+            const size_t wordCount = std::min<size_t>(frame->DirtyLines.size(),
+                                                      SharedFrameHeader::DirtyWordCount);
+
+            std::fill_n(_header->DirtyLines, SharedFrameHeader::DirtyWordCount, 0);
+            std::copy_n(frame->DirtyLines.begin(), wordCount, _header->DirtyLines);
+
+            frame->render(_converter, _pixels, _header->MaxWidth);
+
+            _header->UpdateCount.store(updateCount + 2, std::memory_order_release);
+            _geometry = frame->Timing;
+            isUpdated = true;
+        }
+    }
+
+    return isUpdated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SharedFrameReader Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object with no shared memory region mapped.
+SharedFrameReader::SharedFrameReader() :
+    _header(nullptr),
+    _pixels(nullptr),
+    _regionSize(0)
+{
+}
+
+//! @brief Unmaps any shared memory region.
+SharedFrameReader::~SharedFrameReader()
+{
+    close();
+}
+
+//! @brief Determines whether a shared memory region is mapped.
+bool SharedFrameReader::isOpen() const
+{
+    return _header != nullptr;
+}
+
+//! @brief Gets the header at the start of the mapped region, or nullptr if
+//! none is mapped.
+const SharedFrameHeader *SharedFrameReader::getHeader() const
+{
+    return _header;
+}
+
+//! @brief Gets the first pixel of the frame in the mapped region, or nullptr
+//! if none is mapped.
+//! @note Lines are SharedFrameHeader::MaxWidth pixels apart and should only
+//! be read between beginRead() and isReadConsistent().
+const uint32_t *SharedFrameReader::getPixels() const
+{
+    return _pixels;
+}
+
+//! @brief Attempts to map a region created by a SharedFrameWriter for
+//! reading.
+//! @param[in] name The name the region was created with.
+//! @param[out] error Receives a description of why the region could not be
+//! mapped.
+//! @retval true The region was mapped.
+//! @retval false The region doesn't exist or isn't a frame buffer, error is
+//! updated.
+bool SharedFrameReader::tryOpen(const std::string &name, std::string &error)
+{
+    bool isOpened = false;
+
+    if (isOpen())
+    {
+        error = "A shared frame buffer is already open.";
+    }
+#ifdef _WIN32
+    else
+    {
+        static_cast<void>(name);
+        error = "Shared frame buffers are not supported on this platform.";
+    }
+#else
+    else
+    {
+        const std::string objectName = toSharedObjectName(name);
+        const int handle = ::shm_open(objectName.c_str(), O_RDONLY, 0);
+        struct stat status;
+        void *region = MAP_FAILED;
+
+        if (handle < 0)
+        {
+            error = "Could not open shared memory object '" + objectName + "': " +
+                    std::strerror(errno);
+        }
+        else if ((::fstat(handle, &status) != 0) ||
+                 (static_cast<size_t>(status.st_size) < SharedFrameHeader::PixelOffset))
+        {
+            error = "'" + objectName + "' is not a shared frame buffer.";
+        }
+        else
+        {
+            region = ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ,
+                            MAP_SHARED, handle, 0);
+
+            if (region == MAP_FAILED)
+            {
+                error = "Could not map shared memory object '" + objectName +
+                        "': " + std::strerror(errno);
+            }
+        }
+
+        if (handle >= 0)
+        {
+            ::close(handle);
+        }
+
+        if (region != MAP_FAILED)
+        {
+            const SharedFrameHeader *header = static_cast<const SharedFrameHeader *>(region);
+            const size_t regionSize = static_cast<size_t>(status.st_size);
+
+            if ((header->Magic != SharedFrameHeader::MagicNumber) ||
+                (header->Version != SharedFrameHeader::CurrentVersion) ||
+                (header->PixelDataOffset < sizeof(SharedFrameHeader)) ||
+                (header->MaxHeight > SharedFrameHeader::MaxLineCount) ||
+                (regionSize < header->PixelDataOffset +
+                     (static_cast<size_t>(header->MaxWidth) * header->MaxHeight *
+                      sizeof(uint32_t))))
+            {
+                error = "'" + objectName + "' is not a compatible shared frame buffer.";
+                ::munmap(region, regionSize);
+            }
+            else
+            {
+                _header = header;
+                _pixels = reinterpret_cast<const uint32_t *>(
+                    static_cast<const uint8_t *>(region) + header->PixelDataOffset);
+                _regionSize = regionSize;
+                isOpened = true;
+            }
+        }
+    }
+#endif
+
+    return isOpened;
+}
+
+//! @brief Unmaps the shared memory region, if mapped.
+void SharedFrameReader::close()
+{
+#ifndef _WIN32
+    if (_header != nullptr)
+    {
+        ::munmap(const_cast<SharedFrameHeader *>(_header), _regionSize);
+    }
+#endif
+
+    _header = nullptr;
+    _pixels = nullptr;
+    _regionSize = 0;
+}
+
+//! @brief Marks the start of reading the frame in place.
+//! @return The update count to pass to isReadConsistent(), odd if an update
+//! is in progress, in which case anything read will be inconsistent.
+uint64_t SharedFrameReader::beginRead() const
+{
+    return (_header == nullptr) ? 1 :
+                                  _header->UpdateCount.load(std::memory_order_acquire);
+}
+
+//! @brief Determines whether everything read since beginRead() belongs to
+//! the same update.
+//! @param[in] updateCount The value returned by beginRead().
+bool SharedFrameReader::isReadConsistent(uint64_t updateCount) const
+{
+    bool isConsistent = false;
+
+    if ((_header != nullptr) && ((updateCount & 1) == 0))
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        isConsistent = (_header->UpdateCount.load(std::memory_order_relaxed) == updateCount);
+    }
+
+    return isConsistent;
+}
+
+//! @brief Attempts to take a consistent copy of the current frame.
+//! @param[out] pixels Receives width x height pixels.
+//! @param[out] width Receives the width of the frame.
+//! @param[out] height Receives the height of the frame.
+//! @param[out] sequence Receives the VideoFrame::Sequence of the frame.
+//! @retval true A frame was copied.
+//! @retval false No region is mapped, no frame has been written or the
+//! frame was being updated during the copy, which should be retried.
+bool SharedFrameReader::tryCopyFrame(std::vector<uint32_t> &pixels, uint32_t &width,
+                                     uint32_t &height, uint64_t &sequence) const
+{
+    const uint64_t updateCount = beginRead();
+    bool isCopied = false;
+
+    if ((updateCount & 1) == 0)
+    {
+        width = std::min(_header->Width, _header->MaxWidth);
+        height = std::min(_header->Height, _header->MaxHeight);
+        sequence = _header->FrameSequence;
+        pixels.resize(static_cast<size_t>(width) * height);
+
+        for (uint32_t line = 0; line < height; ++line)
+        {
+            std::memcpy(pixels.data() + (static_cast<size_t>(line) * width),
+                        _pixels + (static_cast<size_t>(line) * _header->MaxWidth),
+                        width * sizeof(uint32_t));
+        }
+
+        isCopied = (width > 0) && (height > 0) && isReadConsistent(updateCount);
+    }
+
+    return isCopied;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,584 @@
+//! @file ArmEmu/SoundOutput.cpp
+//! @brief The definition of objects which convert the logarithmic samples
+//! played by the VIDC into linear stereo and hand them from the emulation
+//! thread to a host audio thread.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SOUND_MIXER_USE_X64
+#endif
+
+#include "ArmEmu/SoundOutput.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Generates the table of linear equivalents of each 8-bit
+//! logarithmic sample at compile time.
+struct LinearTable
+{
+    int16_t Values[256];
+
+    constexpr LinearTable() :
+        Values()
+    {
+        for (int sample = 0; sample < 256; ++sample)
+        {
+            // Bit 0 is the sign, bits 5-7 the chord and 1-4 the step within
+            // it, as with mu-law, giving a 13-bit magnitude. Scale it to fill
+            // 16 bits.
+            const int chord = (sample >> 5) & 7;
+            const int step = (sample >> 1) & 15;
+            const int magnitude = (((step * 2) + 33) << chord) - 33;
+
+            Values[sample] = static_cast<int16_t>((sample & 1) ? -magnitude * 4 :
+                                                                 magnitude * 4);
+        }
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The linear equivalent of each logarithmic sample.
+constexpr LinearTable LinearSamples;
+
+//! @brief The full-scale gain of a channel, 1.0 as a signed 0.15 fixed
+//! point value.
+constexpr int32_t UnityGain = 32767;
+
+//! @brief The count of samples the WAV writer drains from the ring in one go.
+constexpr size_t WriterChunkSize = 1 << 14;
+
+//! @brief The time the WAV writer sleeps for when the ring is empty.
+constexpr std::chrono::milliseconds WriterIdleTime(5);
+
+//! @brief The time the producer sleeps for while waiting for the consumer to
+//! make space in the ring.
+constexpr std::chrono::microseconds ProducerIdleTime(250);
+
+//! @brief The size of the RIFF, fmt and data chunk headers at the start of a
+//! WAV file.
+constexpr uint32_t WaveHeaderSize = 44;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Scales a linear sample by a gain as the vector implementation
+//! does, taking the high half of the product and doubling it.
+int16_t applyGain(int16_t sample, int16_t gain)
+{
+    return static_cast<int16_t>(((static_cast<int32_t>(sample) * gain) >> 16) * 2);
+}
+
+//! @brief The scalar reference implementation of mixing samples.
+//! @param[in] linear The linear equivalent of each logarithmic sample.
+//! @param[in] gains The left and right gains of each channel.
+//! @param[in] source The logarithmic samples, the first for channel 0.
+//! @param[out] target Receives a stereo sample for each source sample.
+//! @param[in] sampleCount The count of samples to convert.
+void mixScalar(const int16_t *linear, const int16_t *gains,
+               const uint8_t *source, StereoSample *target,
+               uint32_t sampleCount)
+{
+    for (uint32_t i = 0; i < sampleCount; ++i)
+    {
+        const int16_t sample = linear[source[i]];
+        const uint32_t channel = i & (SoundMixer::ChannelCount - 1);
+
+        target[i].Left = applyGain(sample, gains[channel * 2]);
+        target[i].Right = applyGain(sample, gains[(channel * 2) + 1]);
+    }
+}
+
+#ifdef SOUND_MIXER_USE_X64
+//! @brief Mixes 8 samples at a time, one for each channel, applying the
+//! left and right gains of 4 channels per vector.
+void mixSSE2(const int16_t *linear, const int16_t *gains,
+             const uint8_t *source, StereoSample *target,
+             uint32_t sampleCount)
+{
+    const __m128i lowGains = _mm_loadu_si128(reinterpret_cast<const __m128i *>(gains));
+    const __m128i highGains = _mm_loadu_si128(reinterpret_cast<const __m128i *>(gains + 8));
+    uint32_t i = 0;
+
+    for (; (i + SoundMixer::ChannelCount) <= sampleCount; i += SoundMixer::ChannelCount)
+    {
+        const __m128i samples = _mm_setr_epi16(linear[source[i]], linear[source[i + 1]],
+                                               linear[source[i + 2]], linear[source[i + 3]],
+                                               linear[source[i + 4]], linear[source[i + 5]],
+                                               linear[source[i + 6]], linear[source[i + 7]]);
+
+        // Duplicate each sample into a left/right pair.
+        const __m128i lowPairs = _mm_unpacklo_epi16(samples, samples);
+        const __m128i highPairs = _mm_unpackhi_epi16(samples, samples);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target + i),
+                         _mm_slli_epi16(_mm_mulhi_epi16(lowPairs, lowGains), 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(target + i + 4),
+                         _mm_slli_epi16(_mm_mulhi_epi16(highPairs, highGains), 1));
+    }
+
+    // The remainder always starts at channel 0.
+    mixScalar(linear, gains, source + i, target + i, sampleCount - i);
+}
+#endif
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// SoundMixer Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a mixer using the best instructions supported by the
+//! host with all channels centred.
+SoundMixer::SoundMixer() :
+    SoundMixer(FrameConverter::getSupportedSimdLevel())
+{
+}
+
+//! @brief Constructs a mixer with all channels centred.
+//! @param[in] level The vector instructions to mix with, limited to the best
+//! supported by the host.
+SoundMixer::SoundMixer(SimdLevel level) :
+    _kernel(mixScalar),
+    _level(std::min(level, FrameConverter::getSupportedSimdLevel()))
+{
+    std::fill_n(_positions, ChannelCount, static_cast<uint8_t>(0xFF));
+
+    const uint8_t centred[ChannelCount] = { 4, 4, 4, 4, 4, 4, 4, 4 };
+    setStereoPositions(centred);
+
+#ifdef SOUND_MIXER_USE_X64
+    if (_level >= SimdLevel::SSE2)
+    {
+        // The 256-bit registers offer nothing as the samples must be looked
+        // up individually.
+        _kernel = mixSSE2;
+        _level = SimdLevel::SSE2;
+    }
+#endif
+}
+
+//! @brief Gets the vector instructions used to mix samples.
+SimdLevel SoundMixer::getSimdLevel() const
+{
+    return _level;
+}
+
+//! @brief Converts a logarithmic sample to a 16-bit linear sample.
+int16_t SoundMixer::toLinear(uint8_t logSample)
+{
+    return LinearSamples.Values[logSample];
+}
+
+//! @brief Calculates the gains applied to the left and right outputs for a
+//! stereo image register value.
+//! @param[in] position The 3-bit stereo position, 1 for full left to 7 for
+//! full right. The undefined value 0 is treated as centre.
+//! @param[out] left Receives the left gain as a signed 0.15 fixed point value.
+//! @param[out] right Receives the right gain.
+void SoundMixer::getStereoGains(uint8_t position, int16_t &left, int16_t &right)
+{
+    // Positions step from 100% left to 100% right in sixths.
+    const int32_t step = ((position & 7) == 0) ? 3 : (position & 7) - 1;
+
+    left = static_cast<int16_t>(((6 - step) * UnityGain) / 6);
+    right = static_cast<int16_t>((step * UnityGain) / 6);
+}
+
+//! @brief Sets the stereo positions of each channel.
+//! @param[in] positions The values of the ChannelCount stereo image registers.
+//! @retval true The positions changed.
+//! @retval false The positions were already in use.
+bool SoundMixer::setStereoPositions(const uint8_t *positions)
+{
+    bool isChanged = false;
+
+    if (std::equal(positions, positions + ChannelCount, _positions) == false)
+    {
+        std::copy_n(positions, ChannelCount, _positions);
+
+        for (uint8_t channel = 0; channel < ChannelCount; ++channel)
+        {
+            getStereoGains(positions[channel], _gains[channel * 2],
+                           _gains[(channel * 2) + 1]);
+        }
+
+        isChanged = true;
+    }
+
+    return isChanged;
+}
+
+//! @brief Converts logarithmic samples into positioned linear stereo.
+//! @param[in] source The logarithmic samples, the first for channel 0.
+//! @param[out] target Receives a stereo sample for each source sample.
+//! @param[in] sampleCount The count of samples to convert.
+void SoundMixer::mix(const uint8_t *source, StereoSample *target,
+                     uint32_t sampleCount) const
+{
+    _kernel(LinearSamples.Values, _gains, source, target, sampleCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SoundSampleRing Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty ring buffer.
+//! @param[in] capacity The minimum count of samples the buffer can hold, it
+//! will be rounded up to a power of 2.
+SoundSampleRing::SoundSampleRing(size_t capacity) :
+    _mask(0),
+    _sampleRate(0),
+    _droppedCount(0),
+    _head(0),
+    _tail(0)
+{
+    size_t actualCapacity = 64;
+
+    while (actualCapacity < capacity)
+    {
+        actualCapacity <<= 1;
+    }
+
+    _samples = std::make_unique<StereoSample[]>(actualCapacity);
+    _mask = actualCapacity - 1;
+}
+
+//! @brief Gets the count of samples the buffer can hold.
+size_t SoundSampleRing::getCapacity() const
+{
+    return _mask + 1;
+}
+
+//! @brief Gets the count of samples written but not yet read.
+size_t SoundSampleRing::getAvailable() const
+{
+    return _head.load(std::memory_order_acquire) -
+           _tail.load(std::memory_order_acquire);
+}
+
+//! @brief Gets the rate at which the samples most recently written should
+//! be played, in Hz, 0 if none have been written.
+uint32_t SoundSampleRing::getSampleRate() const
+{
+    return _sampleRate.load(std::memory_order_acquire);
+}
+
+//! @brief Sets the rate at which samples written from now on should be
+//! played.
+//! @param[in] sampleRate The sample rate in Hz.
+//! @note This member function should only be called on the producer thread.
+void SoundSampleRing::setSampleRate(uint32_t sampleRate)
+{
+    _sampleRate.store(sampleRate, std::memory_order_release);
+}
+
+//! @brief Gets the total count of samples successfully written.
+uint64_t SoundSampleRing::getWrittenCount() const
+{
+    return _head.load(std::memory_order_acquire);
+}
+
+//! @brief Gets the total count of samples discarded because the consumer
+//! didn't keep up.
+uint64_t SoundSampleRing::getDroppedCount() const
+{
+    return _droppedCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Attempts to write a block of samples to the buffer.
+//! @param[in] samples The samples to write.
+//! @param[in] count The count of samples to write.
+//! @retval true The samples were written and published to the reader.
+//! @retval false There was insufficient space, the samples were dropped.
+//! @note This member function should only be called on the producer thread.
+bool SoundSampleRing::tryWrite(const StereoSample *samples, size_t count)
+{
+    const size_t head = _head.load(std::memory_order_relaxed);
+    const size_t tail = _tail.load(std::memory_order_acquire);
+    bool isWritten = false;
+
+    if ((getCapacity() - (head - tail)) >= count)
+    {
+        const size_t start = head & _mask;
+        const size_t firstPart = std::min(count, getCapacity() - start);
+
+        std::copy_n(samples, firstPart, _samples.get() + start);
+        std::copy_n(samples + firstPart, count - firstPart, _samples.get());
+
+        _head.store(head + count, std::memory_order_release);
+        isWritten = true;
+    }
+    else
+    {
+        _droppedCount.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    return isWritten;
+}
+
+//! @brief Waits for the consumer to make space in the buffer.
+//! @param[in] count The count of samples which need to be written.
+//! @param[in] timeout The maximum time to wait, so that the producer can't
+//! be blocked indefinitely by a consumer which has gone away.
+//! @retval true There is space for the samples.
+//! @retval false The wait timed out.
+//! @note This member function should only be called on the producer thread.
+bool SoundSampleRing::waitForSpace(size_t count,
+                                   std::chrono::milliseconds timeout) const
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point deadline = Clock::now() + timeout;
+    bool hasSpace = (getCapacity() - getAvailable()) >= count;
+
+    while ((hasSpace == false) && (Clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(ProducerIdleTime);
+        hasSpace = (getCapacity() - getAvailable()) >= count;
+    }
+
+    return hasSpace;
+}
+
+//! @brief Reads samples written to the buffer.
+//! @param[out] buffer The buffer to receive the samples.
+//! @param[in] maxCount The maximum count of samples to read.
+//! @return The count of samples read.
+//! @note This member function should only be called on the consumer thread.
+size_t SoundSampleRing::read(StereoSample *buffer, size_t maxCount)
+{
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_acquire);
+    const size_t count = std::min(head - tail, maxCount);
+
+    if (count > 0)
+    {
+        const size_t start = tail & _mask;
+        const size_t firstPart = std::min(count, getCapacity() - start);
+
+        std::copy_n(_samples.get() + start, firstPart, buffer);
+        std::copy_n(_samples.get(), count - firstPart, buffer + firstPart);
+
+        _tail.store(tail + count, std::memory_order_release);
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// WaveFileWriter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a writer which isn't running.
+WaveFileWriter::WaveFileWriter() :
+    _ring(nullptr),
+    _sampleCount(0),
+    _sampleRate(0),
+    _isStopping(false)
+{
+}
+
+//! @brief Ensures the background thread is stopped and the file is complete.
+WaveFileWriter::~WaveFileWriter()
+{
+    stop();
+}
+
+//! @brief Determines if the writer is draining samples to a file.
+bool WaveFileWriter::isRunning() const
+{
+    return _thread.joinable();
+}
+
+//! @brief Gets the sample rate recorded in the file, 0 until the first
+//! samples are drained.
+uint32_t WaveFileWriter::getSampleRate() const
+{
+    return _sampleRate.load();
+}
+
+//! @brief Gets the count of stereo samples written to the file.
+uint64_t WaveFileWriter::getSampleCount() const
+{
+    return _sampleCount.load();
+}
+
+//! @brief Creates a WAV file and starts draining samples to it.
+//! @param[in] ring The samples to drain, which must outlive the writer or
+//! the next call to stop().
+//! @param[in] fileName The path to the WAV file to create.
+//! @param[out] error Receives a description of why the file couldn't be
+//! created.
+//! @retval true The file was created and the background thread started.
+//! @retval false The writer was already running or the file couldn't be
+//! created.
+bool WaveFileWriter::tryStart(SoundSampleRing &ring, const std::string &fileName,
+                              std::string &error)
+{
+    bool isStarted = false;
+
+    if (isRunning())
+    {
+        error = "A WAV file is already being written.";
+    }
+    else
+    {
+        _output.open(fileName, std::ios::binary | std::ios::trunc);
+
+        if (_output.is_open())
+        {
+            // Reserve space for the header, it is completed by stop().
+            writeFileHeader(_output, 0, 0);
+
+            _ring = &ring;
+            _buffer.resize(WriterChunkSize);
+            _sampleCount.store(0);
+            _sampleRate.store(0);
+            _isStopping.store(false);
+            _thread = std::thread(&WaveFileWriter::run, this);
+            isStarted = true;
+        }
+        else
+        {
+            error = "Failed to create WAV file '" + fileName + "'.";
+        }
+    }
+
+    return isStarted;
+}
+
+//! @brief Stops the background thread after writing any samples remaining in
+//! the ring, then completes the header and closes the file.
+void WaveFileWriter::stop()
+{
+    if (_thread.joinable())
+    {
+        _isStopping.store(true);
+        _thread.join();
+
+        drain();
+
+        _output.seekp(0);
+        writeFileHeader(_output, _sampleRate.load(), _sampleCount.load());
+        _output.close();
+        _ring = nullptr;
+    }
+}
+
+//! @brief Writes the RIFF header of a 16-bit stereo PCM WAV file.
+//! @param[in] output The binary stream to write to.
+//! @param[in] sampleRate The count of stereo samples per second.
+//! @param[in] sampleCount The count of stereo samples which follow.
+//! @note The header is written little-endian, as the file format requires.
+void WaveFileWriter::writeFileHeader(std::ostream &output, uint32_t sampleRate,
+                                     uint64_t sampleCount)
+{
+    constexpr uint32_t BlockAlign = sizeof(StereoSample);
+    constexpr uint32_t MaxDataSize = UINT32_MAX - WaveHeaderSize;
+    const uint32_t dataSize = static_cast<uint32_t>(std::min<uint64_t>(sampleCount * BlockAlign,
+                                                                       MaxDataSize));
+    uint8_t header[WaveHeaderSize];
+    uint8_t *next = header;
+
+    auto append = [&next](const void *data, size_t size) {
+        std::memcpy(next, data, size);
+        next += size;
+    };
+
+    auto append32 = [&next](uint32_t value) {
+        for (uint32_t i = 0; i < 4; ++i, value >>= 8)
+        {
+            *next++ = static_cast<uint8_t>(value);
+        }
+    };
+
+    auto append16 = [&next](uint16_t value) {
+        *next++ = static_cast<uint8_t>(value);
+        *next++ = static_cast<uint8_t>(value >> 8);
+    };
+
+    append("RIFF", 4);
+    append32(dataSize + WaveHeaderSize - 8);
+    append("WAVE", 4);
+    append("fmt ", 4);
+    append32(16);                       // Format chunk size.
+    append16(1);                        // PCM.
+    append16(2);                        // Channels.
+    append32(sampleRate);
+    append32(sampleRate * BlockAlign);  // Bytes per second.
+    append16(BlockAlign);
+    append16(16);                       // Bits per sample.
+    append("data", 4);
+    append32(dataSize);
+
+    output.write(reinterpret_cast<const char *>(header), sizeof(header));
+}
+
+//! @brief The entry point of the background thread.
+void WaveFileWriter::run()
+{
+    while (_isStopping.load() == false)
+    {
+        if (_ring->getAvailable() > 0)
+        {
+            drain();
+        }
+        else
+        {
+            std::this_thread::sleep_for(WriterIdleTime);
+        }
+    }
+}
+
+//! @brief Writes all samples currently in the ring to the file.
+void WaveFileWriter::drain()
+{
+    size_t count;
+
+    while ((count = _ring->read(_buffer.data(), _buffer.size())) > 0)
+    {
+        if (_sampleRate.load() == 0)
+        {
+            // The rate of the samples just read is at least as recent.
+            _sampleRate.store(_ring->getSampleRate());
+        }
+
+        // WAV files are little-endian, convert the samples in place.
+        uint8_t *bytes = reinterpret_cast<uint8_t *>(_buffer.data());
+
+        for (size_t i = 0; i < count; ++i, bytes += sizeof(StereoSample))
+        {
+            const uint16_t left = static_cast<uint16_t>(_buffer[i].Left);
+            const uint16_t right = static_cast<uint16_t>(_buffer[i].Right);
+
+            bytes[0] = static_cast<uint8_t>(left);
+            bytes[1] = static_cast<uint8_t>(left >> 8);
+            bytes[2] = static_cast<uint8_t>(right);
+            bytes[3] = static_cast<uint8_t>(right >> 8);
+        }
+
+        _output.write(reinterpret_cast<const char *>(_buffer.data()),
+                      static_cast<std::streamsize>(count * sizeof(StereoSample)));
+
+        _sampleCount.fetch_add(count);
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,7 @@ struct GenericSystemTraits
         using DecoderType = ARMv2InstructionDecoder<HardwareType, RegisterFileType>;
         using InstructionWordType = uint32_t; // or uint16_t
         static constexpr uint8_t InstructionSizePow2 = 2; // or 1
+        using InstrumentationType = NullPipelineInstrumentation; // or InstructionClassCounter
     };
 
     using PrimaryPipelineType = InstructionPipeline<typename GenericSystemTraits::PrimaryPipelineTraits>;
@@ -70,6 +71,11 @@ struct GenericSystemTraits
     using ExecutionUnitType = SingleModeExecutionUnit<typename GenericSystemTraits::HardwareType,
                                                       typename GenericSystemTraits::RegisterFileType,
                                                       typename GenericSystemTraits::PrimaryPipelineType>;
+
+    //! @brief The traits of the same system, but with hardware which counts
+    //! accesses to memory mapped devices, i.e. HardwareType::CountsMmio is
+    //! true, or the same traits if there are no devices to count.
+    using MmioCountingTraits = GenericSystemTraits;
 };
 
 //! @brief Defines the traits of a basic ARMv2-based system with test bed hardware.
@@ -91,6 +97,7 @@ struct ArmV2TestSystemTraits
         using DecoderType = ARMv2InstructionDecoder<HardwareType, RegisterFileType>;
         using InstructionWordType = uint32_t;
         static constexpr uint8_t InstructionSizePow2 = 2;
+        using InstrumentationType = NullPipelineInstrumentation;
     };
 
     using PrimaryPipelineType = InstructionPipeline<typename ArmV2TestSystemTraits::PrimaryPipelineTraits>;
@@ -98,6 +105,9 @@ struct ArmV2TestSystemTraits
     using ExecutionUnitType = SingleModeExecutionUnit<typename ArmV2TestSystemTraits::HardwareType,
                                                       typename ArmV2TestSystemTraits::RegisterFileType,
                                                       typename ArmV2TestSystemTraits::PrimaryPipelineType>;
+
+    // The test bed has no memory mapped devices to count accesses to.
+    using MmioCountingTraits = ArmV2TestSystemTraits;
 };
 
 //! @brief Defines the traits of a basic ARMv2a-based system with test bed hardware.
@@ -119,6 +129,7 @@ struct ArmV2aTestSystemTraits
         using DecoderType = ARMv2aInstructionDecoder<HardwareType, RegisterFileType>;
         using InstructionWordType = uint32_t;
         static constexpr uint8_t InstructionSizePow2 = 2;
+        using InstrumentationType = NullPipelineInstrumentation;
     };
 
     using PrimaryPipelineType = InstructionPipeline<typename ArmV2aTestSystemTraits::PrimaryPipelineTraits>;
@@ -126,66 +137,169 @@ struct ArmV2aTestSystemTraits
     using ExecutionUnitType = SingleModeExecutionUnit<typename ArmV2aTestSystemTraits::HardwareType,
                                                       typename ArmV2aTestSystemTraits::RegisterFileType,
                                                       typename ArmV2aTestSystemTraits::PrimaryPipelineType>;
+
+    // The test bed has no memory mapped devices to count accesses to.
+    using MmioCountingTraits = ArmV2aTestSystemTraits;
 };
 
 
 //! @brief Defines the traits of an ARMv2-based system with
 //! MEMC/IOC/VIDC hardware.
-struct ArmV2MemcSystemTraits
+//! @tparam THardware The type of MEMC hardware, either MemcHardware or
+//! CountingMemcHardware.
+template<typename THardware>
+struct BasicArmV2MemcSystemTraits
 {
     // Public Types
     //! @brief The data type of the object which manages the physical address
     //! map and major hardware resources.
-    using HardwareType = MemcHardware;
+    using HardwareType = THardware;
 
     //! @brief The data type of the object which holds state of the processor
     //! in terms of register contents, this includes co-processor state.
-    using RegisterFileType = ARMv2CoreRegisterFile<MemcHardware>;
+    using RegisterFileType = ARMv2CoreRegisterFile<THardware>;
 
     struct PrimaryPipelineTraits
     {
-        using HardwareType = ArmV2MemcSystemTraits::HardwareType;
-        using RegisterFileType = ArmV2MemcSystemTraits::RegisterFileType;
+        using HardwareType = THardware;
+        using RegisterFileType = ARMv2CoreRegisterFile<THardware>;
         using DecoderType = ARMv2InstructionDecoder<HardwareType, RegisterFileType>;
         using InstructionWordType = uint32_t;
         static constexpr uint8_t InstructionSizePow2 = 2;
+        using InstrumentationType = NullPipelineInstrumentation;
     };
 
-    using PrimaryPipelineType = InstructionPipeline<ArmV2MemcSystemTraits::PrimaryPipelineTraits>;
+    using PrimaryPipelineType = InstructionPipeline<PrimaryPipelineTraits>;
+
+    using ExecutionUnitType = SingleModeExecutionUnit<HardwareType,
+                                                      RegisterFileType,
+                                                      PrimaryPipelineType>;
 
-    using ExecutionUnitType = SingleModeExecutionUnit<ArmV2MemcSystemTraits::HardwareType,
-                                                      ArmV2MemcSystemTraits::RegisterFileType,
-                                                      ArmV2MemcSystemTraits::PrimaryPipelineType>;
+    //! @brief The traits of the same system with hardware which counts
+    //! accesses to memory mapped devices, see InstrumentedSystemTraits.
+    using MmioCountingTraits = BasicArmV2MemcSystemTraits<CountingMemcHardware>;
 };
 
-//! @brief Defines the traits of a basic ARMv2a-based system with 
+//! @brief Defines the traits of a basic ARMv2a-based system with
 //! MEMC/IOC/VIDC hardware.
-struct ArmV2aMemcSystemTraits
+//! @tparam THardware The type of MEMC hardware, either MemcHardware or
+//! CountingMemcHardware.
+template<typename THardware>
+struct BasicArmV2aMemcSystemTraits
 {
     // Public Types
     //! @brief The data type of the object which manages the physical address
     //! map and major hardware resources.
-    using HardwareType = MemcHardware;
+    using HardwareType = THardware;
 
     //! @brief The data type of the object which holds state of the processor
     //! in terms of register contents, this includes co-processor state.
-    using RegisterFileType = ARMv2aCoreRegisterFile<ArmV2aMemcSystemTraits::HardwareType>;
+    using RegisterFileType = ARMv2aCoreRegisterFile<THardware>;
 
     struct PrimaryPipelineTraits
     {
-        using HardwareType = ArmV2aMemcSystemTraits::HardwareType;
-        using RegisterFileType = ArmV2aMemcSystemTraits::RegisterFileType;
-        using DecoderType = ARMv2aInstructionDecoder<ArmV2aMemcSystemTraits::HardwareType,
-                                                     ArmV2aMemcSystemTraits::RegisterFileType>;
+        using HardwareType = THardware;
+        using RegisterFileType = ARMv2aCoreRegisterFile<THardware>;
+        using DecoderType = ARMv2aInstructionDecoder<HardwareType, RegisterFileType>;
         using InstructionWordType = uint32_t;
         static constexpr uint8_t InstructionSizePow2 = 2;
+        using InstrumentationType = NullPipelineInstrumentation;
+    };
+
+    using PrimaryPipelineType = InstructionPipeline<PrimaryPipelineTraits>;
+
+    using ExecutionUnitType = SingleModeExecutionUnit<HardwareType,
+                                                      RegisterFileType,
+                                                      PrimaryPipelineType>;
+
+    //! @brief The traits of the same system with hardware which counts
+    //! accesses to memory mapped devices, see InstrumentedSystemTraits.
+    using MmioCountingTraits = BasicArmV2aMemcSystemTraits<CountingMemcHardware>;
+};
+
+//! @brief Defines the traits of an ARMv2-based system with
+//! MEMC/IOC/VIDC hardware.
+using ArmV2MemcSystemTraits = BasicArmV2MemcSystemTraits<MemcHardware>;
+
+//! @brief Defines the traits of an ARMv2a-based system with
+//! MEMC/IOC/VIDC hardware.
+using ArmV2aMemcSystemTraits = BasicArmV2aMemcSystemTraits<MemcHardware>;
+
+//! @brief Defines the traits of a system based on another set of traits,
+//! but with an execution unit which samples the guest call stack, counts
+//! the instructions executed at each address and can trace execution.
+//! @tparam TBaseTraits The traits of the system to profile, e.g.
+//! ArmV2MemcSystemTraits.
+template<typename TBaseTraits>
+struct ProfiledSystemTraits : public TBaseTraits
+{
+    // Public Types
+    using ExecutionUnitType = SingleModeExecutionUnit<typename TBaseTraits::HardwareType,
+                                                      typename TBaseTraits::RegisterFileType,
+                                                      typename TBaseTraits::PrimaryPipelineType,
+                                                      ProfileSampler,
+                                                      InstructionCounter,
+                                                      NullCoverageRecorder,
+                                                      ExecutionTracer>;
+};
+
+//! @brief Defines the traits of a system based on another set of traits,
+//! but with an execution unit which can write a trace of the instructions
+//! it executes.
+//! @tparam TBaseTraits The traits of the system to trace, e.g.
+//! ArmV2MemcSystemTraits.
+template<typename TBaseTraits>
+struct TracedSystemTraits : public TBaseTraits
+{
+    // Public Types
+    using ExecutionUnitType = SingleModeExecutionUnit<typename TBaseTraits::HardwareType,
+                                                      typename TBaseTraits::RegisterFileType,
+                                                      typename TBaseTraits::PrimaryPipelineType,
+                                                      NullProfileSampler,
+                                                      NullInstructionCounter,
+                                                      NullCoverageRecorder,
+                                                      ExecutionTracer>;
+};
+
+//! @brief Defines the traits of a system based on another set of traits,
+//! but with an execution unit which records the address of every
+//! instruction executed for code coverage analysis.
+//! @tparam TBaseTraits The traits of the system to record, e.g.
+//! ArmV2MemcSystemTraits.
+template<typename TBaseTraits>
+struct CoverageSystemTraits : public TBaseTraits
+{
+    // Public Types
+    using ExecutionUnitType = SingleModeExecutionUnit<typename TBaseTraits::HardwareType,
+                                                      typename TBaseTraits::RegisterFileType,
+                                                      typename TBaseTraits::PrimaryPipelineType,
+                                                      NullProfileSampler,
+                                                      NullInstructionCounter,
+                                                      CoverageRecorder>;
+};
+
+//! @brief Defines the traits of a system based on another set of traits,
+//! but with an instruction pipeline which counts the instructions it
+//! executes by class and hardware which counts accesses to memory mapped
+//! devices.
+//! @tparam TBaseTraits The traits of the system to instrument, e.g.
+//! ArmV2MemcSystemTraits.
+template<typename TBaseTraits>
+struct InstrumentedSystemTraits : public TBaseTraits::MmioCountingTraits
+{
+    // Public Types
+    using CountingTraits = typename TBaseTraits::MmioCountingTraits;
+
+    struct PrimaryPipelineTraits : public CountingTraits::PrimaryPipelineTraits
+    {
+        using InstrumentationType = InstructionClassCounter;
     };
 
-    using PrimaryPipelineType = InstructionPipeline<ArmV2aMemcSystemTraits::PrimaryPipelineTraits>;
+    using PrimaryPipelineType = InstructionPipeline<PrimaryPipelineTraits>;
 
-    using ExecutionUnitType = SingleModeExecutionUnit<ArmV2aMemcSystemTraits::HardwareType,
-                                                      ArmV2aMemcSystemTraits::RegisterFileType,
-                                                      ArmV2aMemcSystemTraits::PrimaryPipelineType>;
+    using ExecutionUnitType = SingleModeExecutionUnit<typename CountingTraits::HardwareType,
+                                                      typename CountingTraits::RegisterFileType,
+                                                      PrimaryPipelineType>;
 };
 
 }} // namespace Mo::Arm
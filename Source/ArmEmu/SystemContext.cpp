@@ -11,13 +11,36 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <thread>
+
+#include "ArmEmu/ArmSystem.hpp"
 #include "ArmEmu/EmuOptions.hpp"
 #include "ArmEmu/GuestEventQueue.hpp"
 #include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
 
 namespace Mo {
 namespace Arm {
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The count of slices each second of emulated time is divided into
+//! when pacing emulation against the wall clock.
+constexpr uint64_t PacingSlicesPerSecond = 1000;
+
+//! @brief How close to a pacing deadline the emulation thread stops sleeping
+//! and starts spinning, host sleeps tend to overshoot by about this much.
+constexpr std::chrono::microseconds PacingSpinThreshold(200);
+
+//! @brief How far emulation can fall behind the wall clock before the debt
+//! is written off rather than being repaid by running flat out.
+constexpr std::chrono::milliseconds PacingMaxLag(50);
+
+} // Anonymous namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 // SystemContext Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +58,13 @@ SystemContext::SystemContext(const Options &sysConfig,
     _taskQueueHead(nullptr),
     _masterClock(0),
     _masterFreq(sysConfig.getProcessorSpeedMHz() * 1000000u),
+    _pacingBaseTime(PacingClock::now()),
+    _pacingBaseTicks(0),
+    _pacingSliceTicks(0),
+    _hostIdleTimeNs(0),
+    _isTurboEnabled(false),
+    _isPacingEnabled(sysConfig.isRealTimePacingEnabled()),
+    _heldOutputs(HeldOutput::None),
     _cpuClockShift(0),
     _fuzzIndex(0)
 {
@@ -58,6 +88,19 @@ SystemContext::SystemContext(const Options &sysConfig,
 
         _fuzz[i] = fuzz;
     }
+
+    if (_isPacingEnabled)
+    {
+        // Schedule a recurring task which throttles emulation to the
+        // configured processor speed.
+        _pacingSliceTicks = std::max<uint64_t>(_masterFreq / PacingSlicesPerSecond, 1);
+        _pacingTask.At = _pacingSliceTicks;
+        _pacingTask.Context = 0;
+        _pacingTask.Next = nullptr;
+        _pacingTask.Task = &SystemContext::onPacingSliceElapsed;
+
+        scheduleTask(&_pacingTask);
+    }
 }
 
 //! @brief Gets the emulated system being interfaced with.
@@ -87,6 +130,74 @@ uint64_t SystemContext::getMasterClockFrequency() const
     return _masterFreq;
 }
 
+//! @brief Determines whether the emulated system is throttled to run at the
+//! processor speed it was configured with.
+bool SystemContext::isRealTimePacingEnabled() const
+{
+    return _isPacingEnabled;
+}
+
+//! @brief Determines whether real time pacing has been temporarily
+//! overridden so that the emulated system runs as fast as possible.
+bool SystemContext::isTurboEnabled() const
+{
+    return _isTurboEnabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Temporarily overrides real time pacing so that the emulated system
+//! runs as fast as possible.
+//! @param[in] isEnabled True to run flat out, false to return to the speed
+//! set by the system configuration.
+//! @note This member function can be called from any thread.
+void SystemContext::setTurbo(bool isEnabled)
+{
+    _isTurboEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+//! @brief Gets the outputs of the emulated system which are being held back
+//! from the host, a combination of HeldOutput flags.
+uint8_t SystemContext::getHeldOutputs() const
+{
+    return _heldOutputs;
+}
+
+//! @brief Determines whether a specific output is being held back from
+//! the host.
+//! @param[in] output The HeldOutput flag to test.
+bool SystemContext::isOutputHeld(uint8_t output) const
+{
+    return (_heldOutputs & output) != 0;
+}
+
+//! @brief Sets the outputs of the emulated system to hold back from the host.
+//! @param[in] outputs A combination of HeldOutput flags.
+//! @note The setting isn't part of the captured state, it belongs to
+//! whoever is running the system.
+void SystemContext::setHeldOutputs(uint8_t outputs)
+{
+    _heldOutputs = static_cast<uint8_t>(outputs & HeldOutput::All);
+}
+
+//! @brief Gets the total time in nanoseconds the emulation thread has spent
+//! sleeping in order to keep to real time or waiting for the host.
+uint64_t SystemContext::getHostIdleTimeNs() const
+{
+    return _hostIdleTimeNs;
+}
+
+//! @brief Gets the count of tasks waiting to be run by the scheduler.
+uint32_t SystemContext::getScheduledTaskCount() const
+{
+    uint32_t taskCount = 0;
+
+    for (const GuestTask *task = _taskQueueHead; task != nullptr; task = task->Next)
+    {
+        ++taskCount;
+    }
+
+    return taskCount;
+}
+
 //! @brief Gets random data to report by reads to assigned regions of memory.
 //! @return A random 32-bit value which changes after each call.
 uint32_t SystemContext::getFuzz()
@@ -119,6 +230,16 @@ void SystemContext::incrementCPUClock(uint32_t cycles)
     }
 }
 
+//! @brief Advances the clock by processor cycles during which the processor
+//! was denied access to the memory bus, i.e. by DMA.
+//! @param[in] cycles The count of processor cycles taken.
+//! @note Only to be called from within a scheduled task, tasks which become
+//! due are performed by the incrementCPUClock() call which ran the task.
+void SystemContext::stealCPUCycles(uint32_t cycles)
+{
+    _masterClock += static_cast<uint64_t>(cycles) << _cpuClockShift;
+}
+
 //! @brief Schedules a task to be executed at a specific time.
 //! @param[in] task The task description which is owned by the task owner.
 void SystemContext::scheduleTask(GuestTask *task)
@@ -145,6 +266,97 @@ void SystemContext::scheduleTask(GuestTask *task)
     }
 }
 
+//! @brief Removes a task from the schedule before it is executed.
+//! @param[in] task The task to remove, which need not be scheduled.
+void SystemContext::cancelTask(GuestTask *task)
+{
+    GuestTask **link = &_taskQueueHead;
+
+    while ((*link != nullptr) && (*link != task))
+    {
+        link = &(*link)->Next;
+    }
+
+    if (*link != nullptr)
+    {
+        // Unlink the task from the queue.
+        *link = task->Next;
+        task->Next = nullptr;
+    }
+}
+
+//! @brief Appends the state of emulated time, including the schedule of
+//! pending tasks, to a snapshot.
+//! @param[in] snapshot The snapshot to append to.
+//! @note Scheduled tasks are captured by address, so the snapshot can only
+//! be restored to the same system.
+void SystemContext::captureState(SystemSnapshot &snapshot) const
+{
+    const uint32_t taskCount = getScheduledTaskCount();
+
+    snapshot.writeValue(_masterClock);
+    snapshot.writeValue(_fuzzIndex);
+    snapshot.writeValue(taskCount);
+
+    for (const GuestTask *task = _taskQueueHead; task != nullptr; task = task->Next)
+    {
+        snapshot.writeValue(reinterpret_cast<uintptr_t>(task));
+        snapshot.writeValue(task->At);
+    }
+}
+
+//! @brief Restores the state of emulated time written by captureState().
+//! @param[in] reader The object to read state from.
+//! @note Host statistics, such as idle time, and the turbo setting are
+//! unaffected.
+void SystemContext::restoreState(SnapshotReader &reader)
+{
+    uint32_t taskCount = 0;
+
+    reader.readValue(_masterClock);
+    reader.readValue(_fuzzIndex);
+    reader.readValue(taskCount);
+
+    // Rebuild the task queue in the order it was captured.
+    GuestTask **link = &_taskQueueHead;
+
+    for (uint32_t i = 0; i < taskCount; ++i)
+    {
+        uintptr_t address = 0;
+        uint64_t at = 0;
+
+        if (reader.readValue(address) && reader.readValue(at))
+        {
+            GuestTask *task = reinterpret_cast<GuestTask *>(address);
+            task->At = at;
+
+            *link = task;
+            link = &task->Next;
+        }
+    }
+
+    *link = nullptr;
+}
+
+//! @brief Re-aligns emulated time with the wall clock, typically before
+//! resuming execution after the emulated system has been paused.
+//! @details Without this, time spent paused would be treated as time the
+//! emulator had fallen behind.
+void SystemContext::resynchronisePacing()
+{
+    _pacingBaseTime = PacingClock::now();
+    _pacingBaseTicks = _masterClock;
+}
+
+//! @brief Accounts for time the emulation thread spent blocked waiting for
+//! the host outside of real time pacing, such as for the host to consume
+//! sound samples.
+//! @param[in] idleTime The time for which the thread was blocked.
+void SystemContext::addHostIdleTime(std::chrono::nanoseconds idleTime)
+{
+    _hostIdleTimeNs += static_cast<uint64_t>(idleTime.count());
+}
+
 //! @brief Attempts to post a message to the host input thread without blocking.
 //! @param[in] eventID The type of the event to raise.
 //! @param[in] data1 The first item of event-specific data.
@@ -158,6 +370,86 @@ bool SystemContext::postMessageToHost(uint32_t eventID, uintptr_t data1,
     return _eventQueue.enque(eventID, data1, data2);
 }
 
+//! @brief Requests that high-rate messages of a specific type posted to the
+//! host are coalesced so that only the latest is waiting at any time.
+//! @param[in] eventID The type of message to coalesce.
+//! @retval true Messages of the type will be coalesced.
+//! @retval false The message type could not be coalesced, every message
+//! will be queued.
+//! @note This should be called when devices are connected, before the
+//! emulated system starts running.
+bool SystemContext::tryCoalesceMessages(uint32_t eventID)
+{
+    return _eventQueue.tryEnableCoalescing(eventID);
+}
+
+//! @brief A guest task called after each slice of emulated time when real
+//! time pacing is enabled.
+//! @param[in] guestContext The context which scheduled the task.
+void SystemContext::onPacingSliceElapsed(SystemContext &guestContext,
+                                         uintptr_t /*taskContext*/)
+{
+    guestContext.throttleToRealTime();
+
+    // Re-schedule for the end of the next slice.
+    guestContext._pacingTask.At += guestContext._pacingSliceTicks;
+    guestContext.scheduleTask(&guestContext._pacingTask);
+}
+
+//! @brief Blocks the emulation thread until the wall clock catches up with
+//! the emulated master clock.
+//! @details The deadline is always calculated from the previous deadline
+//! rather than the time the thread woke, so that overshoot from sleeping is
+//! paid back over subsequent slices rather than accumulating as drift.
+void SystemContext::throttleToRealTime()
+{
+    const PacingClock::time_point now = PacingClock::now();
+
+    if (_isTurboEnabled.load(std::memory_order_relaxed))
+    {
+        // Run flat out, but keep the base current so that normal speed
+        // resumes smoothly when turbo is turned off.
+        _pacingBaseTime = now;
+        _pacingBaseTicks = _masterClock;
+        return;
+    }
+
+    // Calculate the wall clock time at which the emulated clock should
+    // have reached its current value.
+    const uint64_t elapsedTicks = _masterClock - _pacingBaseTicks;
+    const std::chrono::nanoseconds elapsed((elapsedTicks * 1000000000u) / _masterFreq);
+    const PacingClock::time_point deadline = _pacingBaseTime + elapsed;
+
+    if (now > deadline + PacingMaxLag)
+    {
+        // The host can't keep up or the process was suspended, write off
+        // the debt rather than running in a catch-up burst.
+        _pacingBaseTime = now;
+    }
+    else
+    {
+        if (deadline - now > PacingSpinThreshold)
+        {
+            // Sleep for the bulk of the time remaining, accounting the time
+            // for which the host core was actually released.
+            std::this_thread::sleep_for(deadline - now - PacingSpinThreshold);
+
+            const auto slept = std::chrono::duration_cast<std::chrono::nanoseconds>(PacingClock::now() - now);
+            _hostIdleTimeNs += static_cast<uint64_t>(slept.count());
+        }
+
+        // Spin out the remainder for a more accurate deadline.
+        while (PacingClock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+
+        _pacingBaseTime = deadline;
+    }
+
+    _pacingBaseTicks = _masterClock;
+}
+
 }} // namespace Mo::Arm
 ////////////////////////////////////////////////////////////////////////////////
 
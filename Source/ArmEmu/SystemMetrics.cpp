@@ -0,0 +1,585 @@
+//! @file ArmEmu/SystemMetrics.cpp
+//! @brief The definition of objects which publish periodic measurements of
+//! the health of a running emulated system and export them to other
+//! processes.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "ArmEmu/SystemMetrics.hpp"
+
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+// Platforms without the flag don't raise SIGPIPE from send().
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The value of MetricsExporter::_socket when no socket is open.
+constexpr intptr_t NoSocket = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates the rate at which a counter increased over a period.
+//! @param[in] previous The earlier value of the counter.
+//! @param[in] current The later value of the counter.
+//! @param[in] periodNs The time between the two values in nanoseconds.
+//! @return The increase per second, or zero if the period was empty.
+double calculateRate(uint64_t previous, uint64_t current, uint64_t periodNs)
+{
+    double rate = 0.0;
+
+    if ((periodNs > 0) && (current > previous))
+    {
+        rate = (static_cast<double>(current - previous) * 1e9) /
+               static_cast<double>(periodNs);
+    }
+
+    return rate;
+}
+
+//! @brief Appends a single sample in Prometheus text format.
+//! @param[in] buffer The text to append to.
+//! @param[in] name The name of the metric, without the common prefix.
+//! @param[in] type The Prometheus type, i.e. gauge or counter.
+//! @param[in] help The text describing the metric.
+//! @param[in] value The value to format.
+void appendPrometheusSample(std::string &buffer, const char *name,
+                            const char *type, const char *help, double value)
+{
+    char text[256];
+
+    std::snprintf(text, sizeof(text),
+                  "# HELP mightyoak_%s %s\n"
+                  "# TYPE mightyoak_%s %s\n"
+                  "mightyoak_%s %.9g\n",
+                  name, help, name, type, name, value);
+
+    buffer.append(text);
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// SystemCounters Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a set of counters which are all zero.
+SystemCounters::SystemCounters() :
+    HostTimeNs(0),
+    InstructionCount(0),
+    CycleCount(0),
+    IrqCount(0),
+    FastIrqCount(0),
+    MmioAccessCount(0),
+    HostIdleTimeNs(0)
+{
+}
+
+//! @brief Gets the current host monotonic time in the units of
+//! SystemCounters::HostTimeNs.
+uint64_t SystemCounters::getHostTimeNs()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SystemMetrics Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty snapshot.
+SystemMetrics::SystemMetrics() :
+    Sequence(0),
+    SampleTimeNs(0),
+    PeriodNs(0),
+    IsRunning(0),
+    InstructionCount(0),
+    CycleCount(0),
+    ScheduledTaskCount(0),
+    EventQueueBacklog(0),
+    LastCaptureTimeNs(0),
+    LastRestoreTimeNs(0),
+    MIPS(0.0),
+    ClockMHz(0.0),
+    HostUtilisation(0.0),
+    IrqRate(0.0),
+    FastIrqRate(0.0),
+    MmioAccessRate(0.0)
+{
+}
+
+//! @brief Updates the totals and rates from two readings of the counters
+//! of an emulated system.
+//! @param[in] previous The counters at the start of the period.
+//! @param[in] current The counters at the end of the period.
+void SystemMetrics::calculateRates(const SystemCounters &previous,
+                                   const SystemCounters &current)
+{
+    SampleTimeNs = current.HostTimeNs;
+    PeriodNs = (current.HostTimeNs > previous.HostTimeNs) ?
+        current.HostTimeNs - previous.HostTimeNs : 0;
+    InstructionCount = current.InstructionCount;
+    CycleCount = current.CycleCount;
+
+    MIPS = calculateRate(previous.InstructionCount, current.InstructionCount,
+                         PeriodNs) / 1e6;
+    ClockMHz = calculateRate(previous.CycleCount, current.CycleCount,
+                             PeriodNs) / 1e6;
+    IrqRate = calculateRate(previous.IrqCount, current.IrqCount, PeriodNs);
+    FastIrqRate = calculateRate(previous.FastIrqCount, current.FastIrqCount,
+                                PeriodNs);
+    MmioAccessRate = calculateRate(previous.MmioAccessCount,
+                                   current.MmioAccessCount, PeriodNs);
+
+    HostUtilisation = 0.0;
+
+    if (PeriodNs > 0)
+    {
+        const uint64_t idleNs = current.HostIdleTimeNs - previous.HostIdleTimeNs;
+
+        if (idleNs < PeriodNs)
+        {
+            HostUtilisation = 1.0 - (static_cast<double>(idleNs) /
+                                     static_cast<double>(PeriodNs));
+        }
+    }
+}
+
+//! @brief Appends the snapshot to a buffer in Prometheus text exposition
+//! format.
+//! @param[in] buffer The text to append to.
+void SystemMetrics::formatPrometheus(std::string &buffer) const
+{
+    appendPrometheusSample(buffer, "running", "gauge",
+                           "1 if the emulated processor is running.",
+                           static_cast<double>(IsRunning));
+    appendPrometheusSample(buffer, "instructions_total", "counter",
+                           "Instructions executed.",
+                           static_cast<double>(InstructionCount));
+    appendPrometheusSample(buffer, "cycles_total", "counter",
+                           "Emulated processor cycles elapsed.",
+                           static_cast<double>(CycleCount));
+    appendPrometheusSample(buffer, "mips", "gauge",
+                           "Millions of instructions executed per second.", MIPS);
+    appendPrometheusSample(buffer, "clock_mhz", "gauge",
+                           "Effective emulated processor clock speed.", ClockMHz);
+    appendPrometheusSample(buffer, "host_utilisation", "gauge",
+                           "Proportion of a host core occupied by emulation.",
+                           HostUtilisation);
+    appendPrometheusSample(buffer, "irq_rate", "gauge",
+                           "Interrupts taken per second.", IrqRate);
+    appendPrometheusSample(buffer, "fiq_rate", "gauge",
+                           "Fast interrupts taken per second.", FastIrqRate);
+    appendPrometheusSample(buffer, "mmio_access_rate", "gauge",
+                           "Memory mapped device accesses per second.",
+                           MmioAccessRate);
+    appendPrometheusSample(buffer, "scheduled_tasks", "gauge",
+                           "Tasks waiting in the emulated scheduler.",
+                           static_cast<double>(ScheduledTaskCount));
+    appendPrometheusSample(buffer, "event_queue_backlog", "gauge",
+                           "Guest events waiting to be read by the host.",
+                           static_cast<double>(EventQueueBacklog));
+    appendPrometheusSample(buffer, "snapshot_capture_seconds", "gauge",
+                           "Host time taken by the last state capture.",
+                           static_cast<double>(LastCaptureTimeNs) / 1e9);
+    appendPrometheusSample(buffer, "snapshot_restore_seconds", "gauge",
+                           "Host time taken by the last state restore.",
+                           static_cast<double>(LastRestoreTimeNs) / 1e9);
+}
+
+//! @brief Appends the snapshot to a buffer as a single line JSON object.
+//! @param[in] buffer The text to append to.
+void SystemMetrics::formatJson(std::string &buffer) const
+{
+    char text[768];
+
+    std::snprintf(text, sizeof(text),
+                  "{\"sequence\":%llu,\"sampleTimeNs\":%llu,\"periodNs\":%llu,"
+                  "\"running\":%s,\"instructions\":%llu,\"cycles\":%llu,"
+                  "\"mips\":%.9g,\"clockMHz\":%.9g,\"hostUtilisation\":%.9g,"
+                  "\"irqRate\":%.9g,\"fiqRate\":%.9g,\"mmioAccessRate\":%.9g,"
+                  "\"scheduledTasks\":%llu,\"eventQueueBacklog\":%llu,"
+                  "\"lastCaptureNs\":%llu,\"lastRestoreNs\":%llu}\n",
+                  static_cast<unsigned long long>(Sequence),
+                  static_cast<unsigned long long>(SampleTimeNs),
+                  static_cast<unsigned long long>(PeriodNs),
+                  IsRunning ? "true" : "false",
+                  static_cast<unsigned long long>(InstructionCount),
+                  static_cast<unsigned long long>(CycleCount),
+                  MIPS, ClockMHz, HostUtilisation,
+                  IrqRate, FastIrqRate, MmioAccessRate,
+                  static_cast<unsigned long long>(ScheduledTaskCount),
+                  static_cast<unsigned long long>(EventQueueBacklog),
+                  static_cast<unsigned long long>(LastCaptureTimeNs),
+                  static_cast<unsigned long long>(LastRestoreTimeNs));
+
+    buffer.append(text);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SystemMetricsPublisher Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a publisher holding an empty snapshot.
+SystemMetricsPublisher::SystemMetricsPublisher() :
+    _sequence(0)
+{
+    publish(SystemMetrics());
+    _sequence.store(0);
+}
+
+//! @brief Gets the count of snapshots published, which can be used to
+//! determine if a new snapshot is available without copying it.
+//! @note This member function can be called from any thread.
+uint64_t SystemMetricsPublisher::getPublishedCount() const
+{
+    return _sequence.load(std::memory_order_acquire) / 2;
+}
+
+//! @brief Copies the most recently published snapshot.
+//! @note This member function can be called from any thread.
+SystemMetrics SystemMetricsPublisher::read() const
+{
+    uint64_t words[WordCount];
+    uint64_t before;
+    uint64_t after;
+
+    do
+    {
+        before = _sequence.load(std::memory_order_acquire);
+
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _sequence.load(std::memory_order_relaxed);
+
+        // Retry if a snapshot was being written or was written while
+        // copying.
+    } while ((before != after) || (before & 1));
+
+    SystemMetrics metrics;
+    std::memcpy(&metrics, words, sizeof(metrics));
+
+    return metrics;
+}
+
+//! @brief Replaces the snapshot seen by readers.
+//! @param[in] metrics The snapshot to publish.
+//! @note This member function must only be called from one thread, usually
+//! the emulator thread.
+void SystemMetricsPublisher::publish(const SystemMetrics &metrics)
+{
+    uint64_t words[WordCount];
+    std::memcpy(words, &metrics, sizeof(metrics));
+
+    const uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+
+    // Mark the snapshot as being updated.
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WordCount; ++i)
+    {
+        _words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// MetricsExporter Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an exporter which isn't running.
+MetricsExporter::MetricsExporter() :
+    _interval(DefaultInterval),
+    _source(nullptr),
+    _writeFailureCount(0),
+    _socket(NoSocket),
+    _target(MetricsTarget::File),
+    _format(MetricsFormat::Prometheus),
+    _isStopping(false)
+{
+}
+
+//! @brief Ensures the background thread is stopped.
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+//! @brief Determines if the exporter is writing updates.
+bool MetricsExporter::isRunning() const
+{
+    return _thread.joinable();
+}
+
+//! @brief Gets the count of updates which couldn't be written, for example
+//! because nothing was listening on the socket.
+uint64_t MetricsExporter::getWriteFailureCount() const
+{
+    return _writeFailureCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Starts writing the metrics of a system periodically.
+//! @param[in] source The publisher to read from, usually obtained from
+//! IArmSystem::getMetrics(), which must outlive the exporter or the next
+//! call to stop().
+//! @param[in] target The type of object to write to.
+//! @param[in] format The text format to write.
+//! @param[in] path The path to the file or socket to write to.
+//! @param[out] error Receives a description of why the exporter couldn't
+//! be started.
+//! @param[in] interval The period between updates.
+//! @retval true The background thread was started.
+//! @retval false The exporter was already running or the target isn't
+//! supported on the host platform.
+//! @note A socket which can't be connected to is retried at each update,
+//! so the exporter can be started before whatever consumes the metrics.
+bool MetricsExporter::tryStart(const SystemMetricsPublisher &source,
+                               MetricsTarget target, MetricsFormat format,
+                               const std::string &path, std::string &error,
+                               std::chrono::milliseconds interval)
+{
+    bool isStarted = false;
+
+    if (isRunning())
+    {
+        error = "Metrics are already being exported.";
+    }
+    else if (path.empty())
+    {
+        error = "No path was specified to export metrics to.";
+    }
+#ifdef _WIN32
+    else if (target == MetricsTarget::UnixSocket)
+    {
+        error = "Unix domain sockets are not supported on this platform.";
+    }
+#endif
+    else
+    {
+        _source = &source;
+        _target = target;
+        _format = format;
+        _path = path;
+        _interval = std::max(interval, std::chrono::milliseconds(1));
+        _isStopping = false;
+        _thread = std::thread(&MetricsExporter::run, this);
+        isStarted = true;
+    }
+
+    return isStarted;
+}
+
+//! @brief Stops the background thread and closes any socket.
+void MetricsExporter::stop()
+{
+    if (_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _isStopping = true;
+        }
+
+        _wakeUp.notify_all();
+        _thread.join();
+
+        closeSocket();
+        _source = nullptr;
+    }
+}
+
+//! @brief The entry point of the background thread.
+void MetricsExporter::run()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    uint64_t lastSequence = ~static_cast<uint64_t>(0);
+
+    while (_isStopping == false)
+    {
+        guard.unlock();
+
+        const SystemMetrics metrics = _source->read();
+
+        // Prometheus output describes the current state, so is always
+        // refreshed, but don't repeat lines in a log of changes.
+        if ((_format == MetricsFormat::Prometheus) ||
+            (metrics.Sequence != lastSequence))
+        {
+            if (tryExport(metrics))
+            {
+                lastSequence = metrics.Sequence;
+            }
+            else
+            {
+                _writeFailureCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        guard.lock();
+        _wakeUp.wait_for(guard, _interval, [this]() { return _isStopping; });
+    }
+}
+
+//! @brief Formats and writes a snapshot to the target.
+//! @param[in] metrics The snapshot to write.
+//! @retval true The snapshot was written.
+//! @retval false The snapshot couldn't be written.
+bool MetricsExporter::tryExport(const SystemMetrics &metrics)
+{
+    _buffer.clear();
+
+    if (_format == MetricsFormat::Prometheus)
+    {
+        metrics.formatPrometheus(_buffer);
+    }
+    else
+    {
+        metrics.formatJson(_buffer);
+    }
+
+    return (_target == MetricsTarget::File) ? tryWriteFile(_buffer) :
+                                              tryWriteSocket(_buffer);
+}
+
+//! @brief Writes formatted metrics to the target file.
+//! @param[in] text The text to write.
+//! @retval true The text was written.
+//! @retval false The file couldn't be written.
+bool MetricsExporter::tryWriteFile(const std::string &text)
+{
+    bool isWritten = false;
+
+    if (_format == MetricsFormat::Prometheus)
+    {
+        // Write a new file and replace the old one, so that a collector
+        // never sees a partial update.
+        const std::string tempPath = _path + ".tmp";
+        std::ofstream output(tempPath, std::ios::trunc);
+
+        if (output.is_open())
+        {
+            output.write(text.data(), static_cast<std::streamsize>(text.length()));
+            output.close();
+
+            std::error_code renameError;
+            std::filesystem::rename(tempPath, _path, renameError);
+            isWritten = !renameError;
+        }
+    }
+    else
+    {
+        std::ofstream output(_path, std::ios::app);
+
+        if (output.is_open())
+        {
+            output.write(text.data(), static_cast<std::streamsize>(text.length()));
+            isWritten = output.good();
+        }
+    }
+
+    return isWritten;
+}
+
+//! @brief Writes formatted metrics to the target socket, connecting to it
+//! if necessary.
+//! @param[in] text The text to write.
+//! @retval true The text was written.
+//! @retval false The socket couldn't be connected to or the text couldn't
+//! be written without blocking.
+bool MetricsExporter::tryWriteSocket(const std::string &text)
+{
+    bool isWritten = false;
+
+#ifndef _WIN32
+    if (_socket == NoSocket)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+
+        const int handle = (_path.length() < sizeof(address.sun_path)) ?
+                               ::socket(AF_UNIX, SOCK_STREAM, 0) : -1;
+
+        if (handle >= 0)
+        {
+            std::memcpy(address.sun_path, _path.c_str(), _path.length());
+
+            if (::connect(handle, reinterpret_cast<const sockaddr *>(&address),
+                          sizeof(address)) == 0)
+            {
+                _socket = handle;
+            }
+            else
+            {
+                ::close(handle);
+            }
+        }
+    }
+
+    if (_socket != NoSocket)
+    {
+        // Never block the exporter on a slow consumer, drop the update.
+        const ssize_t sent = ::send(static_cast<int>(_socket), text.data(),
+                                    text.length(), MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (sent == static_cast<ssize_t>(text.length()))
+        {
+            isWritten = true;
+        }
+        else
+        {
+            // Reconnect at the next update, so that a consumer never sees
+            // a partial update.
+            closeSocket();
+        }
+    }
+#else
+    static_cast<void>(text);
+#endif
+
+    return isWritten;
+}
+
+//! @brief Closes the socket to the consumer, if open.
+void MetricsExporter::closeSocket()
+{
+#ifndef _WIN32
+    if (_socket != NoSocket)
+    {
+        ::close(static_cast<int>(_socket));
+    }
+#endif
+
+    _socket = NoSocket;
+}
+
+}} // namespace Mo::Arm
+
+////////////////////////////////////////////////////////////////////////////////
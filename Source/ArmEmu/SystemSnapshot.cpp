@@ -0,0 +1,118 @@
+//! @file ArmEmu/SystemSnapshot.cpp
+//! @brief The definition of objects which capture and restore the state of
+//! an emulated system in host memory.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstring>
+
+#include "ArmEmu/SystemSnapshot.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// SystemSnapshot Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Determines whether any state has been captured.
+bool SystemSnapshot::isEmpty() const
+{
+    return _data.empty();
+}
+
+//! @brief Gets the count of bytes of state captured.
+size_t SystemSnapshot::getSize() const
+{
+    return _data.size();
+}
+
+//! @brief Gets a pointer to the bytes of state captured.
+const uint8_t *SystemSnapshot::getData() const
+{
+    return _data.data();
+}
+
+//! @brief Disposes of captured state, but retains the memory used to
+//! store it in preparation for the next capture.
+void SystemSnapshot::clear()
+{
+    _data.clear();
+}
+
+//! @brief Appends bytes to the captured state.
+//! @param[in] data The bytes to append.
+//! @param[in] byteCount The count of bytes pointed to by data.
+void SystemSnapshot::write(const void *data, size_t byteCount)
+{
+    if (byteCount > 0)
+    {
+        size_t offset = _data.size();
+        _data.resize(offset + byteCount);
+
+        std::memcpy(_data.data() + offset, data, byteCount);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SnapshotReader Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object to read state from the start of a snapshot.
+//! @param[in] snapshot The snapshot to read, which must outlive the reader.
+SnapshotReader::SnapshotReader(const SystemSnapshot &snapshot) :
+    _position(snapshot.getData()),
+    _end(snapshot.getData() + snapshot.getSize()),
+    _hasFailed(false)
+{
+}
+
+//! @brief Determines whether all of the captured state has been read
+//! without any attempt to read beyond the end of it.
+bool SnapshotReader::isComplete() const
+{
+    return (_position == _end) && (_hasFailed == false);
+}
+
+//! @brief Determines whether an attempt was made to read more state than
+//! was captured.
+bool SnapshotReader::hasFailed() const
+{
+    return _hasFailed;
+}
+
+//! @brief Reads the next block of bytes from the snapshot.
+//! @param[out] data The buffer to receive the bytes.
+//! @param[in] byteCount The count of bytes to read.
+//! @retval true The bytes were read.
+//! @retval false The snapshot didn't contain enough data, the buffer is
+//! unmodified.
+bool SnapshotReader::read(void *data, size_t byteCount)
+{
+    bool isRead = false;
+
+    if (static_cast<size_t>(_end - _position) >= byteCount)
+    {
+        if (byteCount > 0)
+        {
+            std::memcpy(data, _position, byteCount);
+            _position += byteCount;
+        }
+
+        isRead = true;
+    }
+    else
+    {
+        _hasFailed = true;
+    }
+
+    return isRead;
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
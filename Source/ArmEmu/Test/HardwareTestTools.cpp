@@ -0,0 +1,66 @@
+//! @file ArmEmu/HardwareTestTools.cpp
+//! @brief The definition of tools used by unit tests which drive the
+//! emulated MEMC-based hardware directly.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <set>
+
+#include "ArmEmu/SystemContext.hpp"
+
+#include "MemcHardware.hpp"
+#include "HardwareTestTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Global Function Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Connects each device in the address maps of a specimen to an
+//! interop context so that devices can find IOC and schedule tasks.
+//! @param[in] specimen The MEMC hardware whose devices should be connected.
+//! @param[in] context The context the devices should schedule tasks on.
+void connectTestDevices(MemcHardware &specimen, SystemContext &context)
+{
+    const AddressMap maps[] = {
+        specimen.createMasterReadMap(),
+        specimen.createMasterWriteMap()
+    };
+
+    HardwareDevicePool devices;
+    ConnectionContext connection(&context, devices, maps[0], maps[1]);
+    std::set<IAddressRegion *> visitedDevices;
+
+    for (const AddressMap &map : maps)
+    {
+        for (const auto &mapping : map.getMappings())
+        {
+            if (visitedDevices.insert(mapping.Region).second)
+            {
+                mapping.Region->connect(connection);
+            }
+        }
+    }
+}
+
+//! @brief Runs the processor clock until the master clock reaches a time.
+//! @param[in] context The context whose clock should be advanced.
+//! @param[in] masterTicks The master clock time to advance to.
+void runUntil(SystemContext &context, uint64_t masterTicks)
+{
+    while (context.getMasterClockTicks() < masterTicks)
+    {
+        context.incrementCPUClock(1);
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
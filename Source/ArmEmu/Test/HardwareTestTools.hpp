@@ -0,0 +1,37 @@
+//! @file ArmEmu/HardwareTestTools.hpp
+//! @brief The declaration of tools used by unit tests which drive the
+//! emulated MEMC-based hardware directly.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_HARDWARE_TEST_TOOLS_HPP__
+#define __ARM_EMU_HARDWARE_TEST_TOOLS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+class MemcHardware;
+class SystemContext;
+
+////////////////////////////////////////////////////////////////////////////////
+// Function Declarations
+////////////////////////////////////////////////////////////////////////////////
+void connectTestDevices(MemcHardware &specimen, SystemContext &context);
+void runUntil(SystemContext &context, uint64_t masterTicks);
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
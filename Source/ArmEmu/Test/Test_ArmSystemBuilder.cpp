@@ -13,6 +13,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <gtest/gtest.h>
 
+#include "Ag/Core/Exception.hpp"
 #include "ArmEmu/AddressMap.hpp"
 #include "ArmEmu/ArmSystemBuilder.hpp"
 #include "TestBedHardware.inl"
@@ -289,6 +290,20 @@ GTEST_TEST(ArmSystemBuilder, CanCreateArmV2aTestSystem)
     ASSERT_TRUE(emulatedSystem);
 }
 
+GTEST_TEST(ArmSystemBuilder, RejectsCoverageWithTracing)
+{
+    Options opts;
+    opts.setHardwareArchitecture(SystemModel::TestBed);
+    opts.setProcessorVariant(ProcessorModel::ARM2);
+    opts.setSystemRom(SystemROMPreset::Custom);
+    opts.setGuestCoverage(true);
+    opts.setExecutionTracing(true);
+
+    ArmSystemBuilder specimen(opts);
+
+    EXPECT_THROW({ specimen.createSystem(); }, Ag::NotSupportedException);
+}
+
 } // Anonymous namespace
 
 }} // namespace Mo::Arm
@@ -47,6 +47,40 @@ const CoreTestParams armV2CPAccessDenied[] = {
                             "STC CP1,CR0,[R2]" },
 };
 
+//! @brief A program which reads the counter co-processor from user mode,
+//! finishing at the breakpoint appended by prepareTestSystem().
+const char *CounterCPProgram =
+    "MRC CP7,0,R0,CR2,CR0,0\n"     // R0 = Instructions (low)
+    "MOV R5,R5\n"
+    "MRC CP7,0,R1,CR2,CR0,0\n"     // R1 = Instructions (low)
+    "MRC CP7,0,R2,CR3,CR0,0\n"     // R2 = Instructions (high)
+    "MRC CP7,0,R3,CR0,CR0,0\n"     // R3 = Cycles (low)
+    "MRC CP7,0,R4,CR0,CR0,0\n"     // R4 = Cycles (low)
+    "MRC CP7,0,R6,CR4,CR0,0\n"     // R6 = Host time (low)
+    "MRC CP7,0,R7,CR5,CR0,0\n"     // R7 = Host time (high)
+    "MRC CP7,0,R8,CR9,CR0,0\n";    // R8 = Unused register
+
+//! @brief Verifies the values read by CounterCPProgram.
+//! @param[in] specimen The system which has run the program.
+template<typename TSysTraits>
+void verifyCounterCPProgram(const ArmSystem<TSysTraits> &specimen)
+{
+    // Only the instructions between the reads should be counted.
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R1) -
+              specimen.getCoreRegister(CoreRegister::R0), 2u);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R2), 0u);
+
+    // Cycles always advance.
+    EXPECT_GT(specimen.getCoreRegister(CoreRegister::R4),
+              specimen.getCoreRegister(CoreRegister::R3));
+
+    // Host time should be non-zero.
+    EXPECT_NE(specimen.getCoreRegister(CoreRegister::R6) |
+              specimen.getCoreRegister(CoreRegister::R7), 0u);
+
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R8), 0u);
+}
+
 const CoreTestParams armV2aCP15Access[] = {
     // MCR CP15.
     { TLOC, "MRC_ReadCP15_CR0", "R9=0xCAFEBABE,Mode=Svc26",
@@ -134,6 +168,32 @@ const CoreTestParams armV2aCP15Access[] = {
                         "STC CP15,CR0,[R2]" },
 };
 
+GTEST_TEST(CounterCoProcessor, ReadFromUserModeARMv2)
+{
+    Options opts;
+    opts.setCounterCoProcessor(true);
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, CounterCPProgram));
+
+    specimen.run();
+
+    verifyCounterCPProgram(specimen);
+}
+
+GTEST_TEST(CounterCoProcessor, ReadFromUserModeARMv2a)
+{
+    Options opts;
+    opts.setCounterCoProcessor(true);
+    ArmSystem<ArmV2aTestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, CounterCPProgram));
+
+    specimen.run();
+
+    verifyCounterCPProgram(specimen);
+}
+
 } // Anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
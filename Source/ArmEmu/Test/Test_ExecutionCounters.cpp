@@ -0,0 +1,137 @@
+//! @file Test_ExecutionCounters.cpp
+//! @brief The definition of unit tests of counting the instructions executed
+//! at each guest address.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which runs a loop a fixed number of times before
+//! reaching the breakpoint appended by prepareTestSystem().
+const char *CountedLoopProgram =
+    "MOV R0,#10\n"
+    ".Loop\n"
+    "SUBS R0,R0,#1\n"
+    "BNE Loop\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(ExecutionCounterTable, RecordsSparsePages)
+{
+    ExecutionCounterTable specimen;
+    ExecutionCount count;
+
+    EXPECT_FALSE(specimen.isEnabled());
+    EXPECT_TRUE(specimen.isEmpty());
+    EXPECT_FALSE(specimen.tryGetCount(0x8000, count));
+
+    specimen.record(0x8000, 2);
+    specimen.record(0x8000, 3);
+    specimen.record(0x3800004, 1);
+
+    EXPECT_FALSE(specimen.isEmpty());
+    EXPECT_EQ(specimen.getPageCount(), 2u);
+
+    ASSERT_TRUE(specimen.tryGetCount(0x8000, count));
+    EXPECT_EQ(count.Executions, 2u);
+    EXPECT_EQ(count.Cycles, 5u);
+
+    ASSERT_TRUE(specimen.tryGetCount(0x3800004, count));
+    EXPECT_EQ(count.Executions, 1u);
+
+    EXPECT_FALSE(specimen.tryGetCount(0x8004, count));
+    EXPECT_EQ(specimen.getMaxExecutions(), 2u);
+
+    specimen.clear();
+    EXPECT_TRUE(specimen.isEmpty());
+    EXPECT_FALSE(specimen.tryGetCount(0x8000, count));
+}
+
+GTEST_TEST(ExecutionCounterTable, RanksHottestBlocks)
+{
+    ExecutionCounterTable specimen;
+
+    // A block executed once.
+    specimen.record(0x8000, 1);
+    specimen.record(0x8004, 1);
+
+    // A loop body executed three times.
+    for (int i = 0; i < 3; ++i)
+    {
+        specimen.record(0x8008, 1);
+        specimen.record(0x800C, 3);
+    }
+
+    // A block after a gap in execution.
+    specimen.record(0x8020, 1);
+
+    std::vector<HotBlock> blocks = specimen.findHottestBlocks(2);
+
+    ASSERT_EQ(blocks.size(), 2u);
+    EXPECT_EQ(blocks[0].StartAddr, 0x8008u);
+    EXPECT_EQ(blocks[0].EndAddr, 0x8010u);
+    EXPECT_EQ(blocks[0].Executions, 3u);
+    EXPECT_EQ(blocks[0].Cycles, 12u);
+
+    EXPECT_EQ(blocks[1].StartAddr, 0x8000u);
+    EXPECT_EQ(blocks[1].EndAddr, 0x8008u);
+    EXPECT_EQ(blocks[1].Cycles, 2u);
+
+    EXPECT_EQ(specimen.findHottestBlocks(10).size(), 3u);
+}
+
+GTEST_TEST(ExecutionCounterTable, CountsExecutedInstructions)
+{
+    Options opts;
+    ArmSystem<ProfiledSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, CountedLoopProgram));
+
+    ExecutionCounterTable *counters = specimen.getExecutionCounters();
+    ASSERT_NE(counters, nullptr);
+
+    counters->setEnabled(true);
+    specimen.run();
+    counters->setEnabled(false);
+
+    const uint32_t base = TestBedHardware::RamBase;
+    ExecutionCount count;
+
+    ASSERT_TRUE(counters->tryGetCount(base, count));
+    EXPECT_EQ(count.Executions, 1u);
+
+    ASSERT_TRUE(counters->tryGetCount(base + 4, count));
+    EXPECT_EQ(count.Executions, 10u);
+
+    ASSERT_TRUE(counters->tryGetCount(base + 8, count));
+    EXPECT_EQ(count.Executions, 10u);
+    EXPECT_GT(count.Cycles, count.Executions);
+
+    std::vector<HotBlock> blocks = counters->findHottestBlocks(1);
+    ASSERT_EQ(blocks.size(), 1u);
+    EXPECT_EQ(blocks.front().StartAddr, base + 4);
+    EXPECT_EQ(blocks.front().EndAddr, base + 12);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,301 @@
+//! @file Test_ExecutionTrace.cpp
+//! @brief The definition of unit tests of capturing, storing and decoding
+//! execution traces.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program with a branch which skips one instruction before reaching
+//! the breakpoint appended by prepareTestSystem().
+const char *BranchingProgram =
+    "MOV R0,#2\n"
+    "ADD R1,R0,#3\n"
+    "B Skip\n"
+    "MOV R1,#0\n"
+    ".Skip\n"
+    "MOV R2,R1\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates an encoded record with no address, PSR or registers.
+std::vector<uint32_t> makeRecord(uint32_t instruction, uint32_t header)
+{
+    return std::vector<uint32_t>({ instruction, header });
+}
+
+//! @brief Creates an encoded key frame record.
+std::vector<uint32_t> makeKeyFrame(uint32_t address, uint32_t psr,
+                                   uint32_t regBase)
+{
+    std::vector<uint32_t> record;
+    record.push_back(0xE1A00000);
+    record.push_back(TraceFormat::KeyFrame | TraceFormat::ExplicitAddress |
+                     TraceFormat::PsrFollows | TraceFormat::ChangedRegsMask |
+                     (3u << TraceFormat::ModeShift));
+    record.push_back(address);
+    record.push_back(psr);
+
+    for (uint32_t i = 0; i < 15; ++i)
+    {
+        record.push_back(regBase + i);
+    }
+
+    return record;
+}
+
+//! @brief Drains a ring into a decoder and returns the records which pass
+//! a filter.
+std::vector<TraceRecord> decodeAll(ExecutionTraceRing &ring,
+                                   const TraceFilter &filter = TraceFilter())
+{
+    ExecutionTraceDecoder decoder;
+    std::vector<uint32_t> buffer(ring.getAvailable());
+    std::vector<TraceRecord> records;
+
+    decoder.append(buffer.data(), ring.read(buffer.data(), buffer.size()));
+
+    TraceRecord record;
+
+    while (decoder.tryDecodeNext(record))
+    {
+        if (filter.matches(record))
+        {
+            records.push_back(record);
+        }
+    }
+
+    return records;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(ExecutionTraceRing, DropsWholeRecordsWhenFull)
+{
+    ExecutionTraceRing specimen(64);
+    const std::vector<uint32_t> keyFrame = makeKeyFrame(0x8000, 0, 0);
+
+    EXPECT_EQ(specimen.getCapacity(), 64u);
+    EXPECT_TRUE(specimen.tryWrite(keyFrame.data(), keyFrame.size()));
+    EXPECT_TRUE(specimen.tryWrite(keyFrame.data(), keyFrame.size()));
+    EXPECT_TRUE(specimen.tryWrite(keyFrame.data(), keyFrame.size()));
+    EXPECT_FALSE(specimen.tryWrite(keyFrame.data(), keyFrame.size()));
+    EXPECT_EQ(specimen.getAvailable(), keyFrame.size() * 3);
+}
+
+GTEST_TEST(ExecutionTraceRing, WrapsAround)
+{
+    ExecutionTraceRing specimen(64);
+    std::vector<uint32_t> buffer(64);
+    std::vector<uint32_t> words(48);
+
+    for (uint32_t i = 0; i < words.size(); ++i)
+    {
+        words[i] = i;
+    }
+
+    ASSERT_TRUE(specimen.tryWrite(words.data(), words.size()));
+    EXPECT_EQ(specimen.read(buffer.data(), 40), 40u);
+
+    // The second block straddles the end of the buffer.
+    ASSERT_TRUE(specimen.tryWrite(words.data(), words.size()));
+    ASSERT_EQ(specimen.read(buffer.data(), buffer.size()), 56u);
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(buffer[i], 40 + i);
+    }
+
+    for (uint32_t i = 0; i < 48; ++i)
+    {
+        EXPECT_EQ(buffer[8 + i], i);
+    }
+
+    EXPECT_EQ(specimen.getAvailable(), 0u);
+}
+
+GTEST_TEST(ExecutionTraceDecoder, SkipsToFirstKeyFrame)
+{
+    ExecutionTraceDecoder specimen;
+    const std::vector<uint32_t> delta = makeRecord(0xE3A00001, 0);
+    const std::vector<uint32_t> keyFrame = makeKeyFrame(0x8000, 0xF0000003, 100);
+    const std::vector<uint32_t> next = makeRecord(0xE2811001,
+                                                  (1u << 1) | (2u << TraceFormat::CycleCountShift));
+    TraceRecord record;
+
+    // Start part way through the stream, before a key frame.
+    specimen.append(delta.data(), 1);
+    EXPECT_FALSE(specimen.tryDecodeNext(record));
+
+    specimen.append(delta.data() + 1, 1);
+    specimen.append(keyFrame.data(), keyFrame.size());
+
+    // Split the next record, and its register value, across two chunks.
+    std::vector<uint32_t> tail(next);
+    tail.push_back(42);
+    specimen.append(tail.data(), 2);
+
+    ASSERT_TRUE(specimen.tryDecodeNext(record));
+    EXPECT_EQ(record.Address, 0x8000u);
+    EXPECT_EQ(record.PSR, 0xF0000003u);
+    EXPECT_EQ(record.ChangedRegs, TraceFormat::ChangedRegsMask);
+    EXPECT_EQ(record.Regs[14], 114u);
+    EXPECT_EQ(record.Mode, ProcessorMode::Svc26);
+
+    EXPECT_FALSE(specimen.tryDecodeNext(record));
+    specimen.append(tail.data() + 2, 1);
+
+    ASSERT_TRUE(specimen.tryDecodeNext(record));
+    EXPECT_EQ(record.Address, 0x8004u);
+    EXPECT_EQ(record.Instruction, 0xE2811001u);
+    EXPECT_EQ(record.PSR, 0xF0000003u);
+    EXPECT_EQ(record.ChangedRegs, 1u << 1);
+    EXPECT_EQ(record.Regs[0], 100u);
+    EXPECT_EQ(record.Regs[1], 42u);
+    EXPECT_EQ(record.Cycles, 2u);
+    EXPECT_EQ(record.Mode, ProcessorMode::User26);
+
+    EXPECT_EQ(specimen.getDecodedCount(), 2u);
+    EXPECT_EQ(specimen.getSkippedCount(), 1u);
+}
+
+GTEST_TEST(ExecutionTraceDecoder, ReadsFileHeader)
+{
+    std::stringstream buffer;
+    std::string error;
+
+    ExecutionTraceWriter::writeFileHeader(buffer);
+    EXPECT_TRUE(ExecutionTraceDecoder::tryReadFileHeader(buffer, error));
+
+    std::istringstream badInput("Not a trace");
+    EXPECT_FALSE(ExecutionTraceDecoder::tryReadFileHeader(badInput, error));
+    EXPECT_FALSE(error.empty());
+}
+
+GTEST_TEST(TraceFilter, MatchesAddressAndMode)
+{
+    TraceFilter specimen;
+    TraceRecord record = {};
+
+    record.Address = 0x8000;
+    record.Mode = ProcessorMode::User26;
+    EXPECT_TRUE(specimen.matches(record));
+
+    specimen.MinAddress = 0x8004;
+    EXPECT_FALSE(specimen.matches(record));
+
+    record.Address = 0x8004;
+    EXPECT_TRUE(specimen.matches(record));
+
+    specimen.addMode(ProcessorMode::Svc26);
+    EXPECT_FALSE(specimen.matches(record));
+
+    specimen.addMode(ProcessorMode::User26);
+    EXPECT_TRUE(specimen.matches(record));
+}
+
+GTEST_TEST(ExecutionTrace, RecordsNothingUntilEnabled)
+{
+    Options opts;
+    ArmSystem<TracedSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, BranchingProgram));
+
+    ExecutionTrace *trace = specimen.getExecutionTrace();
+    ASSERT_NE(trace, nullptr);
+    EXPECT_FALSE(trace->isEnabled());
+
+    specimen.run();
+
+    EXPECT_EQ(trace->getRecordCount(), 0u);
+    EXPECT_EQ(trace->getRing().getAvailable(), 0u);
+}
+
+GTEST_TEST(ExecutionTrace, RecordsChangedState)
+{
+    Options opts;
+    ArmSystem<TracedSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, BranchingProgram));
+
+    const ProcessorMode startMode = specimen.getMode();
+    ExecutionTrace *trace = specimen.getExecutionTrace();
+    ASSERT_NE(trace, nullptr);
+
+    trace->setEnabled(true);
+    specimen.run();
+
+    EXPECT_EQ(trace->getDroppedCount(), 0u);
+
+    std::vector<TraceRecord> records = decodeAll(trace->getRing());
+    ASSERT_GE(records.size(), 4u);
+    EXPECT_EQ(records.size(), trace->getRecordCount());
+
+    EXPECT_EQ(records[0].Address, TestBedHardware::RamBase);
+    EXPECT_EQ(records[0].Instruction, 0xE3A00002u);
+    EXPECT_EQ(records[0].ChangedRegs, TraceFormat::ChangedRegsMask);
+    EXPECT_EQ(records[0].Regs[0], 2u);
+    EXPECT_EQ(records[0].Mode, startMode);
+
+    EXPECT_EQ(records[1].Address, TestBedHardware::RamBase + 4);
+    EXPECT_EQ(records[1].Instruction, 0xE2801003u);
+    EXPECT_EQ(records[1].ChangedRegs, 1u << 1);
+    EXPECT_EQ(records[1].Regs[1], 5u);
+
+    EXPECT_EQ(records[2].Address, TestBedHardware::RamBase + 8);
+    EXPECT_EQ(records[2].ChangedRegs, 0u);
+
+    EXPECT_EQ(records[3].Address, TestBedHardware::RamBase + 16);
+    EXPECT_EQ(records[3].ChangedRegs, 1u << 2);
+    EXPECT_EQ(records[3].Regs[2], 5u);
+}
+
+GTEST_TEST(ExecutionTrace, FiltersByAddress)
+{
+    Options opts;
+    ArmSystem<TracedSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, BranchingProgram));
+
+    ExecutionTrace *trace = specimen.getExecutionTrace();
+    ASSERT_NE(trace, nullptr);
+
+    trace->setEnabled(true);
+    specimen.run();
+
+    TraceFilter filter;
+    filter.MinAddress = TestBedHardware::RamBase + 8;
+    filter.MaxAddress = TestBedHardware::RamBase + 16;
+
+    std::vector<TraceRecord> records = decodeAll(trace->getRing(), filter);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].Address, TestBedHardware::RamBase + 8);
+    EXPECT_EQ(records[1].Address, TestBedHardware::RamBase + 16);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,261 @@
+//! @file Test_FrameConverter.cpp
+//! @brief The definition of unit tests of converting palettised VIDC video
+//! memory into host pixels.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/FrameConverter.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates a palette where every colour is different.
+VidcPalette createTestPalette()
+{
+    VidcPalette palette;
+
+    for (uint8_t i = 0; i < VidcPalette::ColourCount; ++i)
+    {
+        palette.Colours[i] = static_cast<uint16_t>(i | ((15 - i) << 4) | ((i ^ 5) << 8));
+    }
+
+    palette.Border = 0xF00;
+    palette.Cursor[0] = 0x00F;
+    palette.Cursor[1] = 0x0F0;
+    palette.Cursor[2] = 0xFFF;
+
+    return palette;
+}
+
+//! @brief Creates a block of video memory holding every possible byte value.
+std::vector<uint8_t> createTestPixels(size_t byteCount)
+{
+    std::vector<uint8_t> pixels(byteCount);
+
+    for (size_t i = 0; i < byteCount; ++i)
+    {
+        pixels[i] = static_cast<uint8_t>((i * 0x9D) ^ (i >> 8));
+    }
+
+    return pixels;
+}
+
+//! @brief Creates the display geometry of a 16 x 2 pixel display area
+//! surrounded by a 4 pixel border.
+VidcTiming createTestTiming(uint8_t bitsPerPixelPow2)
+{
+    VidcTiming timing;
+    timing.BitsPerPixelPow2 = bitsPerPixelPow2;
+    timing.HorzCycle = 40;
+    timing.HorzBorderStart = 2;
+    timing.HorzDisplayStart = 6;
+    timing.HorzDisplayEnd = 22;
+    timing.HorzBorderEnd = 26;
+    timing.HorzCursorStart = 20;
+    timing.VertCycle = 12;
+    timing.VertBorderStart = 1;
+    timing.VertDisplayStart = 5;
+    timing.VertDisplayEnd = 7;
+    timing.VertBorderEnd = 11;
+
+    return timing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(VidcPalette, ConvertsPhysicalColours)
+{
+    EXPECT_EQ(VidcPalette::toHostColour(0x000), 0xFF000000u);
+    EXPECT_EQ(VidcPalette::toHostColour(0x00F), 0xFF0000FFu);
+    EXPECT_EQ(VidcPalette::toHostColour(0x0F0), 0xFF00FF00u);
+    EXPECT_EQ(VidcPalette::toHostColour(0xF00), 0xFFFF0000u);
+    EXPECT_EQ(VidcPalette::toHostColour(0x123), 0xFF112233u);
+
+    // The supremacy bit doesn't affect the colour.
+    EXPECT_EQ(VidcPalette::toHostColour(0x1123), 0xFF112233u);
+}
+
+GTEST_TEST(VidcPalette, Maps256ColourPixels)
+{
+    VidcPalette specimen;
+    specimen.Colours[5] = 0x1FFF;
+    specimen.Colours[6] = 0x0246;
+
+    // The high colour bits come from the pixel, the rest from the palette.
+    EXPECT_EQ(specimen.getColour256(0x05), 0x1737u);
+    EXPECT_EQ(specimen.getColour256(0x15), 0x173Fu);
+    EXPECT_EQ(specimen.getColour256(0x25), 0x1777u);
+    EXPECT_EQ(specimen.getColour256(0x45), 0x17B7u);
+    EXPECT_EQ(specimen.getColour256(0x85), 0x1F37u);
+    EXPECT_EQ(specimen.getColour256(0xF6), 0x0ACEu);
+}
+
+GTEST_TEST(VidcTiming, DescribesGeometry)
+{
+    VidcTiming specimen;
+    EXPECT_FALSE(specimen.isValid());
+
+    specimen = createTestTiming(2);
+    EXPECT_TRUE(specimen.isValid());
+    EXPECT_EQ(specimen.getFrameWidth(), 24);
+    EXPECT_EQ(specimen.getFrameHeight(), 10);
+    EXPECT_EQ(specimen.getDisplayWidth(), 16);
+    EXPECT_EQ(specimen.getDisplayHeight(), 2);
+    EXPECT_EQ(specimen.getDisplayBytesPerLine(), 8u);
+    EXPECT_EQ(specimen.getPixelClockHz(), 8000000u);
+
+    // The display area must be within the border.
+    specimen.HorzDisplayStart = 1;
+    EXPECT_FALSE(specimen.isValid());
+}
+
+GTEST_TEST(FrameConverter, VectorKernelsMatchReference)
+{
+    const VidcPalette palette = createTestPalette();
+    const std::vector<uint8_t> source = createTestPixels(1024);
+
+    FrameConverter reference(SimdLevel::Scalar);
+    reference.setPalette(palette);
+    ASSERT_EQ(reference.getSimdLevel(), SimdLevel::Scalar);
+
+    for (uint8_t level = 0; level < static_cast<uint8_t>(SimdLevel::Max); ++level)
+    {
+        FrameConverter specimen(static_cast<SimdLevel>(level));
+        specimen.setPalette(palette);
+
+        SCOPED_TRACE(FrameConverter::getSimdLevelName(specimen.getSimdLevel()));
+
+        for (uint8_t bppPow2 = 0; bppPow2 < 4; ++bppPow2)
+        {
+            // Include counts which don't fill whole bytes or vectors.
+            for (uint32_t pixelCount : { 1u, 3u, 7u, 8u, 13u, 31u, 64u, 255u, 640u })
+            {
+                std::vector<uint32_t> expected(pixelCount + 1, 0xCCCCCCCC);
+                std::vector<uint32_t> actual(pixelCount + 1, 0xCCCCCCCC);
+
+                reference.convertPixels(source.data() + 1, expected.data(),
+                                        pixelCount, bppPow2);
+                specimen.convertPixels(source.data() + 1, actual.data(),
+                                       pixelCount, bppPow2);
+
+                EXPECT_EQ(actual, expected) << "At " << (1 << bppPow2)
+                                            << " bpp, " << pixelCount << " pixels";
+                EXPECT_EQ(actual.back(), 0xCCCCCCCCu);
+            }
+        }
+    }
+}
+
+GTEST_TEST(FrameConverter, ConvertsPackedPixels)
+{
+    const VidcPalette palette = createTestPalette();
+    FrameConverter specimen;
+    specimen.setPalette(palette);
+
+    // Left-most pixels are in the least significant bits.
+    const uint8_t source[] = { 0xE4 };
+    uint32_t target[8];
+
+    specimen.convertPixels(source, target, 8, 0);
+    EXPECT_EQ(target[0], VidcPalette::toHostColour(palette.Colours[0]));
+    EXPECT_EQ(target[2], VidcPalette::toHostColour(palette.Colours[1]));
+    EXPECT_EQ(target[7], VidcPalette::toHostColour(palette.Colours[1]));
+
+    specimen.convertPixels(source, target, 4, 1);
+    EXPECT_EQ(target[0], VidcPalette::toHostColour(palette.Colours[0]));
+    EXPECT_EQ(target[1], VidcPalette::toHostColour(palette.Colours[1]));
+    EXPECT_EQ(target[2], VidcPalette::toHostColour(palette.Colours[2]));
+    EXPECT_EQ(target[3], VidcPalette::toHostColour(palette.Colours[3]));
+
+    specimen.convertPixels(source, target, 2, 2);
+    EXPECT_EQ(target[0], VidcPalette::toHostColour(palette.Colours[4]));
+    EXPECT_EQ(target[1], VidcPalette::toHostColour(palette.Colours[14]));
+
+    specimen.convertPixels(source, target, 1, 3);
+    EXPECT_EQ(target[0], VidcPalette::toHostColour(palette.getColour256(0xE4)));
+}
+
+GTEST_TEST(FrameConverter, UpdatesPalette)
+{
+    VidcPalette palette = createTestPalette();
+    FrameConverter specimen;
+    specimen.setPalette(palette);
+
+    const uint8_t source[] = { 0x00 };
+    uint32_t target[2];
+
+    specimen.convertPixels(source, target, 2, 2);
+    EXPECT_EQ(target[0], VidcPalette::toHostColour(palette.Colours[0]));
+
+    palette.Colours[0] = 0x0ABC;
+    specimen.setPalette(palette);
+    EXPECT_TRUE(specimen.getPalette() == palette);
+
+    specimen.convertPixels(source, target, 2, 2);
+    EXPECT_EQ(target[0], 0xFFAABBCCu);
+    EXPECT_EQ(target[1], 0xFFAABBCCu);
+}
+
+GTEST_TEST(FrameConverter, RendersBorderAndCursor)
+{
+    const VidcPalette palette = createTestPalette();
+    const VidcTiming timing = createTestTiming(2);
+    const std::vector<uint8_t> source = createTestPixels(8);
+    const uint32_t border = VidcPalette::toHostColour(palette.Border);
+
+    FrameConverter specimen;
+    specimen.setPalette(palette);
+
+    std::vector<uint32_t> line(timing.getFrameWidth(), 0);
+
+    // A line of border.
+    specimen.renderLine(timing, nullptr, nullptr, line.data());
+    EXPECT_EQ(line, std::vector<uint32_t>(timing.getFrameWidth(), border));
+
+    // A display line with border either side.
+    std::vector<uint32_t> display(timing.getDisplayWidth());
+    specimen.convertPixels(source.data(), display.data(), timing.getDisplayWidth(), 2);
+    specimen.renderLine(timing, source.data(), nullptr, line.data());
+
+    for (uint32_t x = 0; x < timing.getFrameWidth(); ++x)
+    {
+        const bool isDisplay = (x >= 4) && (x < 20);
+
+        EXPECT_EQ(line[x], isDisplay ? display[x - 4] : border) << "At x = " << x;
+    }
+
+    // A cursor which overlaps the right border and is clipped. Pixel values
+    // of 0 are transparent.
+    const uint8_t cursor[VidcTiming::CursorBytesPerLine] = {
+        0x1B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+
+    specimen.renderLine(timing, source.data(), cursor, line.data());
+
+    EXPECT_EQ(line[17], display[13]);
+    EXPECT_EQ(line[18], VidcPalette::toHostColour(palette.Cursor[2]));
+    EXPECT_EQ(line[19], VidcPalette::toHostColour(palette.Cursor[1]));
+    EXPECT_EQ(line[20], VidcPalette::toHostColour(palette.Cursor[0]));
+    EXPECT_EQ(line[21], border);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+//! @file Test_GuestCoverage.cpp
+//! @brief The definition of unit tests of recording guest code coverage and
+//! exporting it as an lcov tracefile.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+#include "AsmTools.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program with a branch which skips one line before reaching the
+//! breakpoint appended by prepareTestSystem().
+const char *BranchingProgram =
+    "MOV R0,#2\n"
+    "CMP R0,#3\n"
+    "BEQ Skip\n"
+    "MOV R1,#1\n"
+    "B Done\n"
+    ".Skip\n"
+    "MOV R1,#2\n"
+    ".Done\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(GuestCoverageMap, RecordsSparsePages)
+{
+    GuestCoverageMap specimen;
+
+    EXPECT_TRUE(specimen.isEmpty());
+    EXPECT_FALSE(specimen.isCovered(0x8000));
+
+    specimen.mark(0x8000);
+    specimen.mark(0x8000);
+    specimen.mark(0x800C);
+    specimen.mark(0x3800004);
+
+    EXPECT_FALSE(specimen.isEmpty());
+    EXPECT_EQ(specimen.getPageCount(), 2u);
+    EXPECT_EQ(specimen.getCoveredWordCount(), 3u);
+
+    EXPECT_TRUE(specimen.isCovered(0x8000));
+    EXPECT_FALSE(specimen.isCovered(0x8004));
+    EXPECT_TRUE(specimen.isCovered(0x3800004));
+
+    EXPECT_TRUE(specimen.isRangeCovered(0x8004, 12));
+    EXPECT_FALSE(specimen.isRangeCovered(0x8004, 8));
+
+    specimen.clear();
+    EXPECT_TRUE(specimen.isEmpty());
+    EXPECT_FALSE(specimen.isCovered(0x8000));
+}
+
+GTEST_TEST(GuestCoverageMap, MergesRuns)
+{
+    GuestCoverageMap first;
+    GuestCoverageMap second;
+
+    first.mark(0x8000);
+    second.mark(0x8004);
+    second.mark(0x20000);
+
+    first.merge(second);
+
+    EXPECT_EQ(first.getCoveredWordCount(), 3u);
+    EXPECT_TRUE(first.isCovered(0x8000));
+    EXPECT_TRUE(first.isCovered(0x8004));
+    EXPECT_TRUE(first.isCovered(0x20000));
+}
+
+GTEST_TEST(GuestLineTable, WritesLcovTrace)
+{
+    GuestCoverageMap coverage;
+    GuestLineTable specimen;
+
+    specimen.addLine(0x8000, 4, "Main.arm", 3);
+    specimen.addLine(0x8004, 8, "Main.arm", 1);
+    specimen.addLine(0x800C, 4, "Lib.arm", 10);
+    specimen.addLine(0x8010, 4, "Main.arm", 3);
+
+    coverage.mark(0x8008);
+    coverage.mark(0x8010);
+
+    std::ostringstream output;
+    specimen.writeLcovTrace(output, coverage, "Unit");
+
+    EXPECT_EQ(specimen.getCount(), 4u);
+    EXPECT_STREQ(output.str().c_str(),
+                 "TN:Unit\n"
+                 "SF:Main.arm\n"
+                 "DA:1,1\n"
+                 "DA:3,1\n"
+                 "LF:2\n"
+                 "LH:2\n"
+                 "end_of_record\n"
+                 "SF:Lib.arm\n"
+                 "DA:10,0\n"
+                 "LF:1\n"
+                 "LH:0\n"
+                 "end_of_record\n");
+}
+
+GTEST_TEST(GuestCoverage, MapsExecutionToSourceLines)
+{
+    Options opts;
+    ArmSystem<CoverageSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, BranchingProgram));
+
+    GuestCoverageMap *coverage = specimen.getCoverage();
+    ASSERT_NE(coverage, nullptr);
+
+    specimen.run();
+
+    // Assemble the program again to obtain its line table.
+    Asm::Options asmOpts;
+    asmOpts.setLoadAddress(TestBedHardware::RamBase);
+    asmOpts.setInstructionSet(Asm::InstructionSet::ArmV4);
+
+    Asm::Messages log;
+    Asm::ObjectCode code = Asm::assembleText(BranchingProgram, asmOpts, log);
+    ASSERT_FALSE(log.hasErrors());
+
+    GuestLineTable lines;
+
+    for (const Asm::SourceLineMapping &mapping : code.getLineTable())
+    {
+        lines.addLine(mapping.Address, mapping.Size,
+                      mapping.FileName.toUtf8View(), mapping.LineNo);
+    }
+
+    std::ostringstream output;
+    lines.writeLcovTrace(output, *coverage, "Branching");
+
+    EXPECT_STREQ(output.str().c_str(),
+                 "TN:Branching\n"
+                 "SF:(buffer)\n"
+                 "DA:1,1\n"
+                 "DA:2,1\n"
+                 "DA:3,1\n"
+                 "DA:4,1\n"
+                 "DA:5,1\n"
+                 "DA:7,0\n"
+                 "LF:6\n"
+                 "LH:5\n"
+                 "end_of_record\n");
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
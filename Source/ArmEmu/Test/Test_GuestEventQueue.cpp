@@ -13,6 +13,7 @@
 #include <chrono>
 #include <future>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -66,6 +67,51 @@ struct Listener
 
 using ListenerDataSPtr = std::shared_ptr<ListenerData>;
 
+//! @brief Passes events from a producer to a consumer thread.
+//! @param[in] eventCount The count of events to send.
+//! @param[in] batchSize The maximum count of events to dequeue at once.
+//! @retval true Every event was received in order.
+//! @retval false Events were received out of order.
+bool transferEvents(size_t eventCount, size_t batchSize)
+{
+    GuestEventQueue specimen(0x1234);
+
+    auto producer = std::async(std::launch::async, [&specimen, eventCount]()
+    {
+        for (size_t i = 0; i < eventCount; ++i)
+        {
+            // Spin while the queue is full, as the emulator would.
+            while (specimen.enque(1, i, 0) == false)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<GuestEvent> batch(batchSize);
+    size_t received = 0;
+    bool receivedInOrder = true;
+
+    while (received < eventCount)
+    {
+        size_t count = specimen.tryDequeMany(batch.data(), batch.size());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            receivedInOrder &= (batch[i].Data1 == received++);
+        }
+
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.wait();
+
+    return receivedInOrder;
+}
+
 void compareEvents(size_t index, const GuestEvent &expected, const GuestEvent &actual)
 {
     std::string trace = "Testing message " + std::to_string(index);
@@ -116,6 +162,65 @@ GTEST_TEST(CoreLogic, CrossThreadMessages)
     compareEvents(0, GuestEvent(0xDEADBEEF, 0, 0, 0), specimenWrapper->Received[5]);
 }
 
+GTEST_TEST(CoreLogic, BatchDeque)
+{
+    GuestEventQueue specimen(0xDEADBEEF);
+    GuestEvent batch[4];
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(specimen.enque(i + 1, i * 2, i * 3));
+    }
+
+    EXPECT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 4u);
+    compareEvents(0, GuestEvent(0xDEADBEEF, 1, 0, 0), batch[0]);
+    compareEvents(3, GuestEvent(0xDEADBEEF, 4, 6, 9), batch[3]);
+
+    EXPECT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 4u);
+    compareEvents(4, GuestEvent(0xDEADBEEF, 5, 8, 12), batch[0]);
+
+    EXPECT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 2u);
+    compareEvents(9, GuestEvent(0xDEADBEEF, 10, 18, 27), batch[1]);
+
+    EXPECT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 0u);
+}
+
+GTEST_TEST(CoreLogic, CoalescedMessages)
+{
+    GuestEventQueue specimen(0xDEADBEEF);
+    GuestEvent batch[8];
+
+    EXPECT_FALSE(specimen.isCoalesced(5));
+    ASSERT_TRUE(specimen.tryEnableCoalescing(5));
+    EXPECT_TRUE(specimen.isCoalesced(5));
+
+    // Flood the queue with a high rate event, only the latest should survive.
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(specimen.enque(5, i, i + 1));
+    }
+
+    ASSERT_TRUE(specimen.enque(6, 42, 69));
+
+    ASSERT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 2u);
+    compareEvents(0, GuestEvent(0xDEADBEEF, 5, 999, 1000), batch[0]);
+    compareEvents(1, GuestEvent(0xDEADBEEF, 6, 42, 69), batch[1]);
+
+    // Once drained, the next event of the type should be queued afresh.
+    ASSERT_TRUE(specimen.enque(5, 7, 8));
+    ASSERT_EQ(specimen.tryDequeMany(batch, std::size(batch)), 1u);
+    compareEvents(2, GuestEvent(0xDEADBEEF, 5, 7, 8), batch[0]);
+}
+
+GTEST_TEST(CoreLogic, CrossThreadOrdering)
+{
+    // Enough events to wrap the queue many times over.
+    constexpr size_t EventCount = 20000;
+
+    EXPECT_TRUE(transferEvents(EventCount, 1));
+    EXPECT_TRUE(transferEvents(EventCount, 32));
+}
+
 } // Anonymous namespace
 
 }} // namespace Mo::Arm
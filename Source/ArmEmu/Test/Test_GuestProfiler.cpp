@@ -0,0 +1,181 @@
+//! @file Test_GuestProfiler.cpp
+//! @brief The definition of unit tests of sampling and exporting guest call
+//! stacks.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+#include "AsmTools.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which spends most of its time in a leaf function called
+//! via an intermediate function which stacks its return address.
+const char *NestedCallProgram =
+    "MOV R13,#0x10000\n"
+    ".Outer\n"
+    "BL Middle\n"
+    "B Outer\n"
+    ".Middle\n"
+    "STMFD R13!,{R14}\n"
+    "BL Inner\n"
+    "LDMFD R13!,{PC}\n"
+    ".Inner\n"
+    "MOV R0,#100\n"
+    ".Spin\n"
+    "SUBS R0,R0,#1\n"
+    "BNE Spin\n"
+    "MOV PC,R14\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Assembles a test program to obtain its symbols.
+void getProgramSymbols(const char *source, GuestSymbolTable &symbols)
+{
+    Asm::Options opts;
+    opts.setLoadAddress(TestBedHardware::RamBase);
+    opts.setInstructionSet(Asm::InstructionSet::ArmV4);
+
+    Asm::Messages log;
+    Asm::ObjectCode objectCode = Asm::assembleText(source, opts, log);
+
+    ASSERT_FALSE(log.hasErrors());
+    symbols.addSymbols(objectCode.getSymbols());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(GuestSymbolTable, ResolvesNearestPrecedingSymbol)
+{
+    GuestSymbolTable specimen;
+    specimen.addSymbol(0x8100, "Second");
+    specimen.addSymbol(0x8000, "First");
+
+    std::string_view name;
+    uint32_t offset = 0;
+
+    EXPECT_FALSE(specimen.tryFindSymbol(0x7FFC, name, offset));
+
+    ASSERT_TRUE(specimen.tryFindSymbol(0x8000, name, offset));
+    EXPECT_EQ(name, "First");
+    EXPECT_EQ(offset, 0u);
+
+    ASSERT_TRUE(specimen.tryFindSymbol(0x80FC, name, offset));
+    EXPECT_EQ(name, "First");
+    EXPECT_EQ(offset, 0xFCu);
+
+    ASSERT_TRUE(specimen.tryFindSymbol(0x9000, name, offset));
+    EXPECT_EQ(name, "Second");
+    EXPECT_EQ(offset, 0xF00u);
+
+    EXPECT_EQ(specimen.getFunctionName(0x8004), "First");
+    EXPECT_EQ(specimen.getFunctionName(0x0004), "0x00000004");
+}
+
+GTEST_TEST(GuestProfiler, WritesFoldedStacks)
+{
+    GuestProfiler specimen;
+    GuestSymbolTable symbols;
+    symbols.addSymbol(0x8000, "Main");
+    symbols.addSymbol(0x8100, "Leaf");
+
+    // Stacks are recorded leaf first.
+    const uint32_t firstStack[] = { 0x8104, 0x8010 };
+    const uint32_t secondStack[] = { 0x8108, 0x8010 };
+    const uint32_t thirdStack[] = { 0x8020 };
+
+    specimen.recordSample(firstStack, 2);
+    specimen.recordSample(secondStack, 2);
+    specimen.recordSample(firstStack, 2);
+    specimen.recordSample(thirdStack, 1);
+
+    EXPECT_EQ(specimen.getSampleCount(), 4u);
+    EXPECT_EQ(specimen.getUniqueStackCount(), 3u);
+
+    std::ostringstream output;
+    specimen.writeFoldedStacks(output, symbols);
+
+    // Stacks in the same functions are merged.
+    EXPECT_EQ(output.str(), "Main 1\nMain;Leaf 3\n");
+
+    specimen.clear();
+    EXPECT_EQ(specimen.getSampleCount(), 0u);
+    EXPECT_EQ(specimen.getUniqueStackCount(), 0u);
+}
+
+GTEST_TEST(GuestProfiler, WritesPprofProfile)
+{
+    GuestProfiler specimen;
+    GuestSymbolTable symbols;
+    symbols.addSymbol(0x8000, "Main");
+
+    const uint32_t stack[] = { 0x8004, 0x8010 };
+    specimen.recordSample(stack, 2);
+
+    std::ostringstream output(std::ios::out | std::ios::binary);
+    specimen.writePprofProfile(output, symbols);
+    const std::string profile = output.str();
+
+    ASSERT_FALSE(profile.empty());
+
+    // The message should start with a length-delimited sample_type field.
+    EXPECT_EQ(profile[0], '\x0A');
+
+    // The string table should contain the symbol name.
+    EXPECT_NE(profile.find("Main"), std::string::npos);
+}
+
+GTEST_TEST(GuestProfiler, SamplesNestedCalls)
+{
+    Options opts;
+    ArmSystem<ProfiledSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+    GuestSymbolTable symbols;
+
+    getProgramSymbols(NestedCallProgram, symbols);
+    ASSERT_TRUE(prepareTestSystem(&specimen, NestedCallProgram));
+
+    GuestProfiler *profiler = specimen.getProfiler();
+    ASSERT_NE(profiler, nullptr);
+
+    // Nothing should be recorded until enabled.
+    specimen.runFor(100);
+    EXPECT_EQ(profiler->getSampleCount(), 0u);
+
+    profiler->setSamplePeriod(97);
+    profiler->setEnabled(true);
+    specimen.runFor(1000);
+    profiler->setEnabled(false);
+
+    EXPECT_GT(profiler->getSampleCount(), 10u);
+
+    std::ostringstream output;
+    profiler->writeFoldedStacks(output, symbols);
+
+    // Most time is spent in the loop within the inner function, which
+    // should be attributed via both R14 and the stacked return address.
+    EXPECT_NE(output.str().find("Outer;Middle;Spin "), std::string::npos) << output.str();
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,257 @@
+//! @file Test_HleHooks.cpp
+//! @brief The definition of unit tests of host functions which replace
+//! guest SWIs and routines.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which calls a guest routine at &8010 which increments R0.
+const char *RoutineProgram =
+    "MOV R0,#1\n"
+    "BL Routine\n"
+    "MOV R5,R0\n"
+    "B Done\n"
+    ".Routine\n"            // Address &8010
+    "ADD R0,R0,#1\n"
+    "MOV PC,R14\n"
+    ".Done\n";
+
+//! @brief The address of the routine in RoutineProgram.
+constexpr uint32_t RoutineAddress = 0x8010;
+
+//! @brief A program which fills a block of memory using a SWI, then calls
+//! the X form of a second SWI which fails.
+const char *SwiProgram =
+    "MOV R0,#&9000\n"
+    "MOV R1,#64\n"
+    "SWI &40\n"             // Fill memory
+    "MOVVS R9,#1\n"
+    "MOV R6,R0\n"
+    "SWI &20041\n"          // XFail
+    "MOVVS R8,#1\n"
+    "MOV R7,R0\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A routine hook which multiplies R0 by 10.
+HleResult multiplyByTen(HleCall &call, uintptr_t /*context*/)
+{
+    call.Registers[0] *= 10;
+
+    return HleResult::Completed;
+}
+
+//! @brief A SWI hook which fills R1 bytes at R0 with the context value,
+//! returning the count of bytes filled in R0.
+HleResult fillMemory(HleCall &call, uintptr_t context)
+{
+    HleResult result = HleResult::Completed;
+    uint32_t spanLength = 0;
+    uint8_t *span = call.getWritableSpan(call.Registers[0], call.Registers[1],
+                                         spanLength);
+
+    if (span == nullptr)
+    {
+        result = HleResult::Failed;
+    }
+    else
+    {
+        std::memset(span, static_cast<int>(context), spanLength);
+        call.releaseWritableSpan(call.Registers[0], spanLength);
+        call.Registers[0] = spanLength;
+    }
+
+    return result;
+}
+
+//! @brief A SWI hook which always fails, returning the SWI number in R0.
+HleResult alwaysFail(HleCall &call, uintptr_t /*context*/)
+{
+    call.Registers[0] = call.SwiNumber | (call.IsXSwi ? 0x80000000 : 0);
+
+    return HleResult::Failed;
+}
+
+//! @brief A hook which leaves the call to the guest.
+HleResult alwaysDecline(HleCall &/*call*/, uintptr_t /*context*/)
+{
+    return HleResult::Declined;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(HleHooks, ReplaceRoutine)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, RoutineProgram));
+
+    HleHookTable &hooks = specimen.getHleHooks();
+    std::string error;
+    size_t hookId = 0;
+
+    ASSERT_TRUE(hooks.tryAddRoutineHook("Multiply", RoutineAddress,
+                                        multiplyByTen, 0, hookId, error)) << error;
+
+    // The same routine can't be hooked twice.
+    size_t duplicateId = 0;
+    EXPECT_FALSE(hooks.tryAddRoutineHook("Duplicate", RoutineAddress,
+                                         multiplyByTen, 0, duplicateId, error));
+    EXPECT_FALSE(hooks.tryAddRoutineHook("Unaligned", RoutineAddress + 2,
+                                         multiplyByTen, 0, duplicateId, error));
+
+    specimen.run();
+
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R5), 10u);
+
+    HleHookStatistics stats = hooks.getStatistics(hookId);
+    EXPECT_STREQ(stats.Name.c_str(), "Multiply");
+    EXPECT_FALSE(stats.IsSwiHook);
+    EXPECT_EQ(stats.Address, RoutineAddress);
+    EXPECT_EQ(stats.CallCount, 1u);
+    EXPECT_EQ(stats.DeclinedCount, 0u);
+    EXPECT_EQ(stats.BypassedCount, 0u);
+}
+
+GTEST_TEST(HleHooks, DisabledRoutineRunsGuestCode)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, RoutineProgram));
+
+    HleHookTable &hooks = specimen.getHleHooks();
+    std::string error;
+    size_t hookId = 0;
+
+    ASSERT_TRUE(hooks.tryAddRoutineHook("Multiply", RoutineAddress,
+                                        multiplyByTen, 0, hookId, error)) << error;
+    hooks.setHookEnabled(hookId, false);
+    EXPECT_FALSE(hooks.isHookEnabled(hookId));
+
+    specimen.run();
+
+    // The displaced instruction was executed in place of the trap.
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R5), 2u);
+
+    HleHookStatistics stats = hooks.getStatistics(hookId);
+    EXPECT_FALSE(stats.IsEnabled);
+    EXPECT_EQ(stats.CallCount, 0u);
+    EXPECT_EQ(stats.BypassedCount, 1u);
+}
+
+GTEST_TEST(HleHooks, DeclinedRoutineRunsGuestCode)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, RoutineProgram));
+
+    HleHookTable &hooks = specimen.getHleHooks();
+    std::string error;
+    size_t hookId = 0;
+
+    ASSERT_TRUE(hooks.tryAddRoutineHook("Decline", RoutineAddress,
+                                        alwaysDecline, 0, hookId, error)) << error;
+
+    specimen.run();
+
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R5), 2u);
+    EXPECT_EQ(hooks.getStatistics(hookId).DeclinedCount, 1u);
+}
+
+GTEST_TEST(HleHooks, ReplaceSwis)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, SwiProgram));
+
+    HleHookTable &hooks = specimen.getHleHooks();
+    std::string error;
+    size_t fillId = 0;
+    size_t failId = 0;
+
+    ASSERT_TRUE(hooks.tryAddSwiHook("Fill", 0x40, fillMemory, 0xA5,
+                                    fillId, error)) << error;
+    ASSERT_TRUE(hooks.tryAddSwiHook("Fail", 0x41, alwaysFail, 0,
+                                    failId, error)) << error;
+
+    // A SWI can only have one hook.
+    size_t duplicateId = 0;
+    EXPECT_FALSE(hooks.tryAddSwiHook("Duplicate", 0x20040, fillMemory, 0,
+                                     duplicateId, error));
+
+    specimen.run();
+
+    // The block was filled directly through host memory.
+    uint8_t filled[64] = { 0 };
+    uint8_t expected[64];
+    std::memset(expected, 0xA5, sizeof(expected));
+
+    readFromLogicalAddress(&specimen, 0x9000, filled, sizeof(filled));
+    EXPECT_EQ(std::memcmp(filled, expected, sizeof(filled)), 0);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R6), 64u);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R9), 0u);
+
+    // The failure was reported with V set.
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R8), 1u);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R7), 0x80000041u);
+
+    EXPECT_EQ(hooks.getStatistics(fillId).CallCount, 1u);
+    EXPECT_EQ(hooks.getStatistics(failId).CallCount, 1u);
+    EXPECT_TRUE(hooks.getStatistics(failId).IsSwiHook);
+
+    hooks.resetStatistics();
+    EXPECT_EQ(hooks.getStatistics(fillId).CallCount, 0u);
+}
+
+GTEST_TEST(HleHooks, DeclinedSwiReachesGuest)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, SwiProgram));
+
+    HleHookTable &hooks = specimen.getHleHooks();
+    std::string error;
+    size_t hookId = 0;
+
+    ASSERT_TRUE(hooks.tryAddSwiHook("Decline", 0x40, alwaysDecline, 0,
+                                    hookId, error)) << error;
+
+    specimen.run();
+
+    // The SWI entered the guest SWI vector, which holds a breakpoint.
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R6), 0u);
+    EXPECT_EQ(hooks.getStatistics(hookId).DeclinedCount, 1u);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+//! @file Test_HostFileSystem.cpp
+//! @brief The definition of unit tests of host filing system SWIs serviced
+//! outside of the emulated processor.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which loads a file, saves part of it under a new name
+//! and then fails to load a file which doesn't exist.
+const char *HostFsProgram =
+    "MOV R0,#&C000\n"       // R0 => "Data/bin"
+    "MOV R1,#&D000\n"
+    "MOV R2,#&1000\n"
+    "SWI &56AC1\n"          // HostFS_Load
+    "MOVVS R9,#1\n"
+    "MOV R6,R2\n"           // R6 = Bytes loaded
+    "MOV R0,#&C100\n"       // R0 => "Out.Copy/bin"
+    "MOV R1,#&D000\n"
+    "MOV R2,#4\n"
+    "SWI &56AC2\n"          // HostFS_Save
+    "MOVVS R9,#2\n"
+    "MOV R0,#&C200\n"       // R0 => "Missing"
+    "SWI &76AC1\n"          // XHostFS_Load
+    "MOVVS R8,#1\n";
+
+//! @brief The contents of the file loaded by HostFsProgram.
+const char FileContents[] = "MightyOak";
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A test fixture which creates a host directory to expose to an
+//! emulated system.
+class HostFileSystemTests : public ::testing::Test
+{
+protected:
+    std::filesystem::path _rootDir;
+    Options _options;
+
+    HostFileSystemTests() :
+        _rootDir(std::filesystem::temp_directory_path() / "MoTest_HostFileSystem")
+    {
+        std::filesystem::remove_all(_rootDir);
+        std::filesystem::create_directories(_rootDir / "Out");
+
+        std::ofstream output(_rootDir / "Data.bin", std::ios::binary);
+        output.write(FileContents, sizeof(FileContents) - 1);
+    }
+
+    virtual ~HostFileSystemTests()
+    {
+        std::error_code error;
+        std::filesystem::remove_all(_rootDir, error);
+    }
+
+    //! @brief Exposes the host directory to systems created with _options.
+    void enableHostFileSystem()
+    {
+        Ag::Fs::Path rootPath;
+
+        ASSERT_TRUE(Ag::Fs::Path::tryParse(Ag::String(std::string_view(_rootDir.string())),
+                                           rootPath));
+        _options.setHostFileSystemRoot(rootPath);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Writes the object names used by HostFsProgram into guest memory.
+void writeObjectNames(IArmSystem *system)
+{
+    const char *names[] = { "Data/bin", "Out.Copy/bin", "Missing" };
+    uint32_t address = 0xC000;
+
+    for (const char *name : names)
+    {
+        const uint32_t length = static_cast<uint32_t>(std::strlen(name) + 1);
+
+        ASSERT_EQ(writeToLogicalAddress(system, address, name, length), length);
+        address += 0x100;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(HostFileSystemTests, TrapSwiRange)
+{
+    EXPECT_TRUE(HostFileSystem::isHostSwi(0xEF056AC0));
+    EXPECT_TRUE(HostFileSystem::isHostSwi(0xEF056AFF));
+    EXPECT_TRUE(HostFileSystem::isHostSwi(0x6F076AC1));
+    EXPECT_FALSE(HostFileSystem::isHostSwi(0xEF056ABF));
+    EXPECT_FALSE(HostFileSystem::isHostSwi(0xEF056B00));
+    EXPECT_FALSE(HostFileSystem::isHostSwi(0xEF000000));
+}
+
+TEST_F(HostFileSystemTests, LoadAndSaveFromGuest)
+{
+    enableHostFileSystem();
+    ArmSystem<ArmV2TestSystemTraits> specimen(_options);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, HostFsProgram));
+    writeObjectNames(&specimen);
+
+    specimen.run();
+
+    // The file was loaded directly into guest memory.
+    char loaded[sizeof(FileContents)] = { 0 };
+    readFromLogicalAddress(&specimen, 0xD000, loaded, sizeof(FileContents) - 1);
+    EXPECT_STREQ(loaded, FileContents);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R6), sizeof(FileContents) - 1);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R9), 0u);
+
+    // Part of it was saved with RISC OS name conversion applied.
+    std::ifstream input(_rootDir / "Out" / "Copy.bin", std::ios::binary);
+    std::string saved((std::istreambuf_iterator<char>(input)),
+                      std::istreambuf_iterator<char>());
+    EXPECT_STREQ(saved.c_str(), "Migh");
+
+    // The missing file is reported with V set.
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R8), 1u);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R0),
+              static_cast<uint32_t>(HostFsError::NotFound));
+}
+
+TEST_F(HostFileSystemTests, DisabledSwisReachGuest)
+{
+    ArmSystem<ArmV2TestSystemTraits> specimen(_options);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, HostFsProgram));
+    writeObjectNames(&specimen);
+
+    specimen.run();
+
+    // The first SWI entered the guest SWI vector, which holds a breakpoint.
+    char loaded[sizeof(FileContents)] = { 0 };
+    readFromLogicalAddress(&specimen, 0xD000, loaded, sizeof(FileContents) - 1);
+    EXPECT_STREQ(loaded, "");
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R6), 0u);
+    EXPECT_FALSE(std::filesystem::exists(_rootDir / "Out" / "Copy.bin"));
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
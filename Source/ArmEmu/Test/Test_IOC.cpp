@@ -0,0 +1,198 @@
+//! @file Test_IOC.cpp
+//! @brief The definition of unit tests for the emulated IOC interrupt and
+//! control pin logic.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/IOC.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
+#include "MemcHardware.hpp"
+#include "HardwareTestTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t IocControl = 0x3200000;
+constexpr uint32_t KartRxData = 0x3200004;
+constexpr uint32_t IrqClear = 0x3200014;
+constexpr uint32_t IrqStatusB = 0x3200020;
+constexpr uint32_t IrqMaskB = 0x3200028;
+constexpr uint32_t FirqStatus = 0x3200030;
+constexpr uint32_t FirqMask = 0x3200038;
+constexpr uint32_t KartLatchLow = 0x3200070;
+constexpr uint32_t KartLatchHigh = 0x3200074;
+constexpr uint32_t KartGo = 0x3200078;
+
+//! @brief The bit of IRQ register B set when the KART has received a byte.
+constexpr uint8_t KartRxIrqBit = 0x80;
+
+//! @brief The bits of the FIRQ registers driven by control pins C[3:5].
+constexpr uint8_t CtrlPinFirqBits = 0x38;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Reads the low byte of a register mapped by the hardware.
+uint8_t readByte(MemcHardware &specimen, uint32_t address)
+{
+    uint32_t value = 0;
+
+    EXPECT_TRUE(specimen.read<uint32_t>(address, value));
+
+    return static_cast<uint8_t>(value);
+}
+
+//! @brief Determines whether the IRQ line to the CPU is raised.
+bool isCpuIrqRaised(const MemcHardware &specimen)
+{
+    return (specimen.getIrqStatus() & IrqState::IrqPending) != 0;
+}
+
+//! @brief Determines whether the FIRQ line to the CPU is raised.
+bool isCpuFirqRaised(const MemcHardware &specimen)
+{
+    return (specimen.getIrqStatus() & IrqState::FastIrqPending) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(IocIrqState, ControlPinsSetAndClearFirqs)
+{
+    IocIrqState specimen;
+
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0u);
+    EXPECT_FALSE(specimen.getFirqPinState());
+
+    // All pins start high, so updating one copies the state of C[3:5].
+    EXPECT_TRUE(specimen.setControlPinInputState(3, false));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0x30u);
+
+    EXPECT_TRUE(specimen.setControlPinInputState(4, false));
+    EXPECT_FALSE(specimen.setControlPinInputState(5, false));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0u);
+
+    // Raising a pin must set its FIRQ status bit, not just clear it.
+    EXPECT_TRUE(specimen.setControlPinInputState(3, true));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0x08u);
+
+    EXPECT_TRUE(specimen.setControlPinInputState(5, true));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0x28u);
+
+    // Pins C[0:2] are not connected to FIRQs.
+    EXPECT_TRUE(specimen.setControlPinInputState(0, false));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0x28u);
+    EXPECT_EQ(specimen.readCtrlRegister() & 0x3F, 0x2Eu);
+
+    // The FIRQ line only follows enabled pins.
+    EXPECT_FALSE(specimen.setFirqMask(0x10));
+    EXPECT_FALSE(specimen.getFirqPinState());
+    EXPECT_TRUE(specimen.setControlPinInputState(4, true));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), CtrlPinFirqBits);
+
+    EXPECT_FALSE(specimen.setControlPinInputState(4, false));
+    EXPECT_EQ(specimen.getUnmaskedFirqState(), 0x28u);
+}
+
+GTEST_TEST(IOC, KartRxRaisesCpuIrq)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    connectTestDevices(specimen, context);
+    specimen.setPrivilegedMode(true);
+
+    // Clear the power-on reset interrupt and leave only KART Rx unmasked.
+    EXPECT_TRUE(specimen.write<uint32_t>(IrqClear, 0x10));
+    EXPECT_TRUE(specimen.write<uint32_t>(IrqMaskB, static_cast<uint8_t>(~KartRxIrqBit)));
+    EXPECT_FALSE(isCpuIrqRaised(specimen));
+
+    // Clock the KART as fast as possible: 11 bits at 16 counts per bit.
+    EXPECT_TRUE(specimen.write<uint32_t>(KartLatchLow, 1));
+    EXPECT_TRUE(specimen.write<uint32_t>(KartLatchHigh, 0));
+    EXPECT_TRUE(specimen.write<uint32_t>(KartGo, 0));
+
+    const uint64_t byteTicks = (context.getMasterClockFrequency() / 2000000) * 16 * 11;
+    const uint64_t startTicks = context.getMasterClockTicks();
+
+    specimen.getIOController().writeKartByte(0x5A);
+
+    // Nothing is received until the KART has clocked in a whole byte.
+    runUntil(context, startTicks + (byteTicks / 2));
+    EXPECT_EQ(readByte(specimen, IrqStatusB) & KartRxIrqBit, 0u);
+    EXPECT_FALSE(isCpuIrqRaised(specimen));
+
+    runUntil(context, startTicks + byteTicks);
+    EXPECT_EQ(readByte(specimen, IrqStatusB) & KartRxIrqBit, KartRxIrqBit);
+    EXPECT_TRUE(isCpuIrqRaised(specimen));
+
+    // Reading the byte clears the interrupt.
+    EXPECT_EQ(readByte(specimen, KartRxData), 0x5Au);
+    EXPECT_EQ(readByte(specimen, IrqStatusB) & KartRxIrqBit, 0u);
+    EXPECT_FALSE(isCpuIrqRaised(specimen));
+}
+
+GTEST_TEST(IOC, HostPinChangesApplyOnPoll)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    connectTestDevices(specimen, context);
+    specimen.setPrivilegedMode(true);
+
+    // Host input is applied 1000 times per emulated second.
+    const uint64_t pollTicks = context.getMasterClockFrequency() / 1000;
+    IOC &ioc = specimen.getIOController();
+
+    ioc.setCtrlPinInputState(3, false);
+
+    // The change is only queued until the emulation thread polls for it.
+    runUntil(context, pollTicks / 2);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & CtrlPinFirqBits, 0u);
+    EXPECT_EQ(readByte(specimen, IocControl) & 0x3F, 0x3Fu);
+    EXPECT_FALSE(isCpuFirqRaised(specimen));
+
+    runUntil(context, pollTicks);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & CtrlPinFirqBits, 0x30u);
+    EXPECT_EQ(readByte(specimen, IocControl) & 0x3F, 0x37u);
+    EXPECT_TRUE(isCpuFirqRaised(specimen));
+
+    // Only enable the FIRQ driven by C3, which is currently low.
+    EXPECT_TRUE(specimen.write<uint32_t>(FirqMask, 0x08));
+    EXPECT_FALSE(isCpuFirqRaised(specimen));
+
+    ioc.setCtrlPinInputState(3, true);
+    runUntil(context, pollTicks + (pollTicks / 2));
+    EXPECT_EQ(readByte(specimen, FirqStatus) & CtrlPinFirqBits, 0x30u);
+    EXPECT_FALSE(isCpuFirqRaised(specimen));
+
+    runUntil(context, pollTicks * 2);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & CtrlPinFirqBits, CtrlPinFirqBits);
+    EXPECT_TRUE(isCpuFirqRaised(specimen));
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
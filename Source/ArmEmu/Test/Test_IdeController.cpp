@@ -0,0 +1,383 @@
+//! @file Test_IdeController.cpp
+//! @brief The definition of unit tests of copy-on-write hard disc images and
+//! the IDE hard disc interface.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/HardDiscImage.hpp"
+#include "ArmEmu/IdeController.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
+#include "MemcHardware.hpp"
+#include "HardwareTestTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The count of sectors in the test image, 20 cylinders of the
+//! default translation.
+constexpr uint32_t TestSectorCount = 20 * 16 * 63;
+
+constexpr uint32_t IdeData = IdeController::BaseAddress + 0x00;
+constexpr uint32_t IdeError = IdeController::BaseAddress + 0x04;
+constexpr uint32_t IdeSectorCount = IdeController::BaseAddress + 0x08;
+constexpr uint32_t IdeSectorNumber = IdeController::BaseAddress + 0x0C;
+constexpr uint32_t IdeCylinderLow = IdeController::BaseAddress + 0x10;
+constexpr uint32_t IdeCylinderHigh = IdeController::BaseAddress + 0x14;
+constexpr uint32_t IdeDeviceHead = IdeController::BaseAddress + 0x18;
+constexpr uint32_t IdeCommand = IdeController::BaseAddress + 0x1C;
+constexpr uint32_t IdeStatus = IdeController::BaseAddress + 0x1C;
+constexpr uint32_t IdeAltStatus = IdeController::BaseAddress + 0x38;
+constexpr uint32_t IrqStatusB = 0x3200020;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A test fixture which creates a base hard disc image with each
+//! sector labelled with its address.
+class HardDiscTests : public ::testing::Test
+{
+protected:
+    std::string _baseFileName;
+    std::string _overlayFileNames[2];
+
+    HardDiscTests() :
+        _baseFileName(::testing::TempDir() + "MightyOakHardDiscTest.img")
+    {
+        std::vector<uint8_t> image(TestSectorCount * HardDiscImage::SectorSize, 0);
+
+        for (uint32_t lba = 0; lba < TestSectorCount; ++lba)
+        {
+            uint8_t *sector = image.data() + (lba * HardDiscImage::SectorSize);
+            sector[0] = static_cast<uint8_t>(lba);
+            sector[1] = static_cast<uint8_t>(lba >> 8);
+            sector[HardDiscImage::SectorSize - 1] = 0xAA;
+        }
+
+        std::ofstream output(_baseFileName, std::ios::binary);
+        output.write(reinterpret_cast<const char *>(image.data()), image.size());
+
+        for (uint8_t i = 0; i < 2; ++i)
+        {
+            _overlayFileNames[i] = ::testing::TempDir() + "MightyOakHardDiscTest" +
+                                   std::to_string(i) + ".cow";
+            std::remove(_overlayFileNames[i].c_str());
+        }
+    }
+
+    virtual ~HardDiscTests()
+    {
+        std::remove(_baseFileName.c_str());
+        std::remove(_overlayFileNames[0].c_str());
+        std::remove(_overlayFileNames[1].c_str());
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Gets the size of a file.
+std::streamoff getFileSize(const std::string &fileName)
+{
+    std::ifstream input(fileName, std::ios::binary | std::ios::ate);
+
+    return input.tellg();
+}
+
+//! @brief Reads a register mapped by the hardware.
+uint32_t readWord(MemcHardware &specimen, uint32_t address)
+{
+    uint32_t value = 0;
+
+    EXPECT_TRUE(specimen.read<uint32_t>(address, value));
+
+    return value;
+}
+
+//! @brief Determines whether the IDE interrupt, IOC IL3, is active.
+bool isIdeIrqActive(MemcHardware &specimen)
+{
+    return (readWord(specimen, IrqStatusB) & 0x08) != 0;
+}
+
+//! @brief Overwrites an entry in the block allocation table of an overlay.
+//! @param[in] overlayFileName The path to the overlay file.
+//! @param[in] block The index of the table entry to overwrite.
+//! @param[in] value The 1-based index of the stored block, or 0.
+void setOverlayTableEntry(const std::string &overlayFileName, uint32_t block,
+                          uint32_t value)
+{
+    // The table follows the 64-byte header.
+    std::fstream overlay(overlayFileName, std::ios::binary | std::ios::in | std::ios::out);
+    overlay.seekp(64 + (block * sizeof(uint32_t)));
+    overlay.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+//! @brief Writes an LBA address and sector count to the task file.
+void setLbaAddress(MemcHardware &specimen, uint32_t lba, uint8_t count)
+{
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeSectorCount, count));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeSectorNumber, lba & 0xFF));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCylinderLow, (lba >> 8) & 0xFF));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCylinderHigh, (lba >> 16) & 0xFF));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeDeviceHead, 0xE0 | ((lba >> 24) & 0x0F)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+TEST_F(HardDiscTests, CopyBlocksOnWrite)
+{
+    HardDiscImage specimen;
+    HardDiscImage sibling;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error)) << error;
+    ASSERT_TRUE(sibling.tryOpen(_baseFileName, _overlayFileNames[1], error)) << error;
+    EXPECT_FALSE(specimen.isWriteProtected());
+    EXPECT_EQ(specimen.getSectorCount(), TestSectorCount);
+    EXPECT_EQ(specimen.getBlockSize(), HardDiscImage::DefaultBlockSize);
+    EXPECT_EQ(specimen.getAllocatedBlockCount(), 0u);
+
+    // A new overlay only holds its header and allocation table.
+    EXPECT_EQ(getFileSize(_overlayFileNames[0]), 4096);
+
+    // The first write copies the block containing the sector.
+    uint8_t *sector = specimen.getWritableSector(100);
+    ASSERT_NE(sector, nullptr);
+    EXPECT_EQ(sector[0], 100);
+    EXPECT_EQ(sector[HardDiscImage::SectorSize - 1], 0xAA);
+    sector[2] = 0x77;
+
+    EXPECT_EQ(specimen.getAllocatedBlockCount(), 1u);
+    EXPECT_TRUE(specimen.isBlockAllocated((100 * HardDiscImage::SectorSize) /
+                                          HardDiscImage::DefaultBlockSize));
+    EXPECT_EQ(specimen.getSector(100)[2], 0x77);
+    EXPECT_EQ(specimen.getSector(101)[0], 101);
+    EXPECT_EQ(specimen.flush(), 1u);
+    EXPECT_EQ(getFileSize(_overlayFileNames[0]),
+              4096 + static_cast<std::streamoff>(HardDiscImage::DefaultBlockSize));
+
+    // Other instances sharing the base don't see the change.
+    EXPECT_EQ(sibling.getSector(100)[2], 0);
+    EXPECT_EQ(specimen.getSector(TestSectorCount), nullptr);
+    EXPECT_EQ(specimen.getWritableSector(TestSectorCount), nullptr);
+
+    specimen.close();
+    sibling.close();
+
+    // The base image is never written.
+    std::ifstream input(_baseFileName, std::ios::binary);
+    input.seekg((100 * HardDiscImage::SectorSize) + 2);
+    EXPECT_EQ(input.get(), 0);
+    input.close();
+
+    // The change persists in the overlay.
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error)) << error;
+    EXPECT_EQ(specimen.getAllocatedBlockCount(), 1u);
+    EXPECT_EQ(specimen.getSector(100)[2], 0x77);
+    specimen.close();
+
+    // Without an overlay the disc is write protected.
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, std::string(), error)) << error;
+    EXPECT_TRUE(specimen.isWriteProtected());
+    EXPECT_EQ(specimen.getWritableSector(0), nullptr);
+    EXPECT_EQ(specimen.getSector(100)[2], 0);
+}
+
+TEST_F(HardDiscTests, RejectMismatchedOverlay)
+{
+    HardDiscImage specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error)) << error;
+    specimen.close();
+
+    // Change the start of the base image.
+    {
+        std::fstream base(_baseFileName, std::ios::binary | std::ios::in | std::ios::out);
+        base.seekp(0);
+        base.put(0x55);
+    }
+
+    EXPECT_FALSE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error));
+    EXPECT_FALSE(specimen.isOpen());
+    EXPECT_FALSE(error.empty());
+
+    EXPECT_FALSE(specimen.tryOpen(_baseFileName, _overlayFileNames[1], error, 1000));
+    EXPECT_FALSE(specimen.isOpen());
+}
+
+TEST_F(HardDiscTests, RejectCorruptAllocationTable)
+{
+    HardDiscImage specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error)) << error;
+    ASSERT_NE(specimen.getWritableSector(100), nullptr);
+    EXPECT_EQ(specimen.getAllocatedBlockCount(), 1u);
+    specimen.close();
+
+    const uint32_t block = (100 * HardDiscImage::SectorSize) / HardDiscImage::DefaultBlockSize;
+
+    // Two blocks can't share the same stored block.
+    setOverlayTableEntry(_overlayFileNames[0], block + 1, 1);
+    EXPECT_FALSE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error));
+    EXPECT_FALSE(specimen.isOpen());
+    EXPECT_FALSE(error.empty());
+
+    // Nor refer to a block beyond those stored.
+    setOverlayTableEntry(_overlayFileNames[0], block + 1, 0);
+    setOverlayTableEntry(_overlayFileNames[0], block, 2);
+    EXPECT_FALSE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error));
+    EXPECT_FALSE(specimen.isOpen());
+
+    // The repaired table is accepted.
+    setOverlayTableEntry(_overlayFileNames[0], block, 1);
+    ASSERT_TRUE(specimen.tryOpen(_baseFileName, _overlayFileNames[0], error)) << error;
+    EXPECT_EQ(specimen.getAllocatedBlockCount(), 1u);
+    EXPECT_TRUE(specimen.isBlockAllocated(block));
+}
+
+TEST_F(HardDiscTests, IdentifyAndTransferSectors)
+{
+    Options options;
+    options.setHardDiskTechnology(HardDiskInterface::IDE);
+    options.setHardDriveCount(1);
+
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    IdeController ide(options);
+    std::string error;
+
+    ASSERT_TRUE(ide.tryAttachDisc(0, _baseFileName, _overlayFileNames[0], error)) << error;
+    EXPECT_FALSE(ide.tryAttachDisc(1, _baseFileName, _overlayFileNames[1], error));
+
+    AddressMap readDevices, writeDevices;
+    ASSERT_TRUE(readDevices.tryInsert(IdeController::BaseAddress, &ide));
+    ASSERT_TRUE(writeDevices.tryInsert(IdeController::BaseAddress, &ide));
+
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    specimen.setPrivilegedMode(true);
+    connectTestDevices(specimen, context);
+
+    // Identify the drive.
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeDeviceHead, 0xA0));
+    EXPECT_EQ(readWord(specimen, IdeAltStatus) & 0xFF, 0x50);
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0xEC));
+    EXPECT_TRUE(isIdeIrqActive(specimen));
+    EXPECT_EQ(readWord(specimen, IdeStatus) & 0xFF, 0x58);
+    EXPECT_FALSE(isIdeIrqActive(specimen));
+
+    std::vector<uint16_t> identity;
+
+    while ((readWord(specimen, IdeAltStatus) & 0x08) && (identity.size() < 512))
+    {
+        identity.push_back(static_cast<uint16_t>(readWord(specimen, IdeData)));
+    }
+
+    ASSERT_EQ(identity.size(), 256u);
+    EXPECT_EQ(identity[1], 20);
+    EXPECT_EQ(identity[3], 16);
+    EXPECT_EQ(identity[6], 63);
+    EXPECT_EQ(identity[27], ('M' << 8) | 'i');
+    EXPECT_EQ(identity[60] | (static_cast<uint32_t>(identity[61]) << 16), TestSectorCount);
+
+    // Read 2 sectors by LBA.
+    setLbaAddress(specimen, 300, 2);
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0x20));
+    std::vector<uint16_t> data;
+    uint32_t interruptCount = 0;
+
+    while ((readWord(specimen, IdeAltStatus) & 0x08) && (data.size() < 1024))
+    {
+        if (isIdeIrqActive(specimen))
+        {
+            ++interruptCount;
+            readWord(specimen, IdeStatus);
+        }
+
+        data.push_back(static_cast<uint16_t>(readWord(specimen, IdeData)));
+    }
+
+    ASSERT_EQ(data.size(), 512u);
+    EXPECT_EQ(interruptCount, 2u);
+    EXPECT_EQ(data[0], 300);
+    EXPECT_EQ(data[255], 0xAA00);
+    EXPECT_EQ(data[256], 301);
+    EXPECT_EQ(readWord(specimen, IdeSectorNumber) & 0xFF, 301 & 0xFF);
+
+    // Read cylinder 1, head 2, sector 5 by CHS.
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeSectorCount, 1));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeSectorNumber, 5));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCylinderLow, 1));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCylinderHigh, 0));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeDeviceHead, 0xA2));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0x20));
+    EXPECT_EQ(readWord(specimen, IdeData) & 0xFFFF, ((1 * 16) + 2) * 63 + 4);
+
+    // Write a sector, which goes to the overlay.
+    setLbaAddress(specimen, 5000, 1);
+    readWord(specimen, IdeStatus);
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0x30));
+    EXPECT_FALSE(isIdeIrqActive(specimen));
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(IdeData, 0x1234));
+    }
+
+    EXPECT_TRUE(isIdeIrqActive(specimen));
+    EXPECT_EQ(readWord(specimen, IdeStatus) & 0xFF, 0x50);
+    EXPECT_EQ(ide.getDisc(0).getSector(5000)[0], 0x34);
+    EXPECT_EQ(ide.getDisc(0).getSector(5000)[1], 0x12);
+    EXPECT_EQ(ide.getDisc(0).getAllocatedBlockCount(), 1u);
+    EXPECT_EQ(ide.flushDiscs(), 1u);
+
+    // Addresses beyond the end of the disc aren't found.
+    setLbaAddress(specimen, TestSectorCount, 1);
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0x20));
+    EXPECT_EQ(readWord(specimen, IdeStatus) & 0xFF, 0x51);
+    EXPECT_EQ(readWord(specimen, IdeError) & 0xFF, 0x10);
+
+    // Unsupported commands are aborted.
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0xC8));
+    EXPECT_EQ(readWord(specimen, IdeStatus) & 0xFF, 0x51);
+    EXPECT_EQ(readWord(specimen, IdeError) & 0xFF, 0x04);
+
+    // nIEN masks the interrupt.
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeAltStatus, 0x02));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeCommand, 0xEF));
+    EXPECT_FALSE(isIdeIrqActive(specimen));
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeAltStatus, 0x00));
+    EXPECT_TRUE(isIdeIrqActive(specimen));
+
+    // The absent second drive doesn't respond.
+    EXPECT_TRUE(specimen.write<uint32_t>(IdeDeviceHead, 0xB0));
+    EXPECT_EQ(readWord(specimen, IdeStatus) & 0xFF, 0x00);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,159 @@
+//! @file Test_Instrumentation.cpp
+//! @brief The definition of unit tests of counting the instructions executed
+//! by an instrumented pipeline by class.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "PipelineInstrumentation.inl"
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which executes a known mix of instructions before
+//! reaching the breakpoint appended by prepareTestSystem().
+const char *InstructionMixProgram =
+    "MOV R13,#0x10000\n"
+    "MOV R0,#3\n"
+    ".Loop\n"
+    "STMFD R13!,{R0,R1}\n"
+    "LDMFD R13!,{R0,R1}\n"
+    "ADD R1,R1,R0,LSL R0\n"
+    "LDR R2,[R13]\n"
+    "SUBS R0,R0,#1\n"
+    "BNE Loop\n"
+    "MOVEQ R3,R0\n"
+    "MOVNE R3,R1\n";
+
+//! @brief A program which branches to itself until interrupted.
+const char *EndlessLoopProgram =
+    "MOV R0,#0\n"
+    ".Loop\n"
+    "B Loop\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(PipelineInstrumentation, ClassifiesInstructions)
+{
+    InstructionClassCounter specimen;
+    ExecutionBreakdown breakdown;
+
+    specimen.onInstructionExecuted(0xE3A00001); // MOV R0,#1
+    specimen.onInstructionExecuted(0xE0810002); // ADD R0,R1,R2
+    specimen.onInstructionExecuted(0xE0810312); // ADD R0,R1,R2,LSL R3
+    specimen.onInstructionExecuted(0xE0000291); // MUL R0,R1,R2
+    specimen.onInstructionExecuted(0xE1020091); // SWP R0,R1,[R2]
+    specimen.onInstructionExecuted(0xE5910000); // LDR R0,[R1]
+    specimen.onInstructionExecuted(0xE890000E); // LDMIA R0,{R1-R3}
+    specimen.onInstructionExecuted(0xEA000000); // B
+    specimen.onInstructionExecuted(0xEF000000); // SWI 0
+    specimen.onInstructionExecuted(0xEE000000); // CDP
+    specimen.onInstructionExecuted(0xED900100); // LDC
+    specimen.onInstructionExecuted(0xE7000010); // Undefined
+    specimen.onInstructionExecuted(0xE1200070); // BKPT
+    specimen.onConditionFailed();
+    specimen.onResult(ExecResult::PipelineChange | 3);
+    specimen.onResult(ExecResult::FlushPipeline | 3);
+    specimen.onResult(1);
+
+    specimen.harvest(breakdown);
+
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluImmediate), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluRegister), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluShiftByRegister), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::Multiply), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::Swap), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::SingleTransfer), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::MultiTransfer), 1u);
+    EXPECT_EQ(breakdown.MultiTransferSizes[3], 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::Branch), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::SoftwareInterrupt), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::CoProcessor), 2u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::Other), 2u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::ConditionFailed), 1u);
+    EXPECT_EQ(breakdown.getInstructionCount(), 14u);
+    EXPECT_EQ(breakdown.PipelineFlushes, 2u);
+    EXPECT_EQ(breakdown.ModeChanges, 1u);
+
+    // Harvesting should reset the counts.
+    ExecutionBreakdown empty;
+    specimen.harvest(empty);
+    EXPECT_TRUE(empty.isEmpty());
+}
+
+GTEST_TEST(PipelineInstrumentation, EmptyBreakdownUnlessConfigured)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, InstructionMixProgram));
+
+    ExecutionMetrics metrics = specimen.run();
+
+    EXPECT_GT(metrics.InstructionCount, 0u);
+    EXPECT_TRUE(metrics.Breakdown.isEmpty());
+}
+
+GTEST_TEST(PipelineInstrumentation, CountsExecutedInstructions)
+{
+    Options opts;
+    ArmSystem<InstrumentedSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, InstructionMixProgram));
+
+    ExecutionMetrics metrics = specimen.run();
+    const ExecutionBreakdown &breakdown = metrics.Breakdown;
+
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluImmediate), 5u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluRegister), 1u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::AluShiftByRegister), 3u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::SingleTransfer), 3u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::MultiTransfer), 6u);
+    EXPECT_EQ(breakdown.MultiTransferSizes[2], 6u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::Branch), 2u);
+    EXPECT_EQ(breakdown.getClassCount(InstructionClass::ConditionFailed), 2u);
+    EXPECT_GE(breakdown.PipelineFlushes, 2u);
+
+    // The test bed has no memory mapped devices.
+    EXPECT_EQ(breakdown.MmioAccesses, 0u);
+}
+
+GTEST_TEST(PipelineInstrumentation, HostExitDoesNotRecountLastResult)
+{
+    Options opts;
+    ArmSystem<InstrumentedSystemTraits<ArmV2TestSystemTraits>> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, EndlessLoopProgram));
+
+    // The run limit raises a host interrupt just after a taken branch.
+    ExecutionMetrics metrics = specimen.runFor(100);
+    const ExecutionBreakdown &breakdown = metrics.Breakdown;
+
+    EXPECT_EQ(metrics.ExecResult, ExecutionMetrics::Result::TimeLimit);
+    EXPECT_GT(breakdown.getClassCount(InstructionClass::Branch), 1u);
+
+    // Only the branches flush the pipeline, the exit should add nothing.
+    EXPECT_EQ(breakdown.PipelineFlushes,
+              breakdown.getClassCount(InstructionClass::Branch));
+    EXPECT_EQ(breakdown.ModeChanges, 0u);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -10,9 +10,15 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
 #include "MemcHardware.hpp"
+#include "HardwareTestTools.hpp"
 
 namespace Mo {
 namespace Arm {
@@ -38,6 +44,28 @@ protected:
 ////////////////////////////////////////////////////////////////////////////////
 // Local Functions
 ////////////////////////////////////////////////////////////////////////////////
+//! @brief Encodes a word written to a VIDC display timing register.
+//! @param[in] index The index of the register relative to
+//! VidcRegister::TimingBase.
+//! @param[in] value The value to write.
+uint32_t makeVidcTiming(uint8_t index, uint16_t value)
+{
+    // The horizontal cursor start register has an extra bit of precision.
+    const uint8_t shift = (index == 6) ? 13 : 14;
+
+    return (static_cast<uint32_t>(VidcRegister::TimingBase + index) << 26) |
+           (static_cast<uint32_t>(value) << shift);
+}
+
+//! @brief Encodes the address written to set a MEMC DMA address register.
+//! @param[in] registerId The register to write, 0 to 6.
+//! @param[in] physAddr The physical address to set, a multiple of 16 bytes.
+uint32_t makeMemcDmaAddress(uint8_t registerId, uint32_t physAddr)
+{
+    return 0x3600000 | (static_cast<uint32_t>(registerId) << 17) |
+           ((physAddr >> 4) << 2);
+}
+
 uint32_t make4KMapping(uint16_t logicalPage, uint16_t physPage, uint8_t ppl)
 {
     uint32_t address = 0x3800000;
@@ -114,6 +142,55 @@ uint32_t make32KMapping(uint16_t logicalPage, uint16_t physPage, uint8_t ppl)
     return address;
 }
 
+//! @brief Programs a 512 x 3 pixel 4 bpp display area so that each line
+//! occupies a separate 256 byte block of RAM, with the cursor on the middle
+//! line.
+void configureTestDisplay(MemcHardware &specimen)
+{
+    specimen.setPrivilegedMode(true);
+
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0xE0000008));
+
+    const uint16_t timingRegisters[] = {
+        300, 0, 2, 1, 257, 261, 0, 0,   // Horizontal
+        9, 0, 1, 2, 5, 6, 3, 4          // Vertical
+    };
+
+    for (uint8_t i = 0; i < std::size(timingRegisters); ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart,
+                                             makeVidcTiming(i, timingRegisters[i])));
+    }
+
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(0, 0), 0)); // Vinit
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(1, 0), 0)); // Vstart
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(2, 752), 0)); // Vend
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(3, 0x1000), 0)); // Cinit
+    EXPECT_TRUE(specimen.write<uint32_t>(0x36E0400, 0)); // Enable video DMA.
+}
+
+//! @brief Determines whether the IOC IR (vertical flyback) interrupt is
+//! active, then clears it.
+bool takeVerticalFlyback(MemcHardware &specimen)
+{
+    uint32_t status = 0;
+
+    EXPECT_TRUE(specimen.read<uint32_t>(0x3200010, status)); // IRQ Status A
+    EXPECT_TRUE(specimen.write<uint32_t>(0x3200014, 0x08));  // IRQ Clear
+
+    return (status & 0x08) != 0;
+}
+
+//! @brief Determines whether the IOC SIRQ (sound buffer) interrupt is active.
+bool isSoundBufferIrqActive(MemcHardware &specimen)
+{
+    uint32_t status = 0;
+
+    EXPECT_TRUE(specimen.read<uint32_t>(0x3200020, status)); // IRQ Status B
+
+    return (status & 0x02) != 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Unit Tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -841,6 +918,454 @@ TEST_F(MemcHardwareTests, ExchangeBytes)
     EXPECT_EQ(value, AltSample8);
 }
 
+TEST_F(MemcHardwareTests, WriteVidcRegisters)
+{
+    specimen.setPrivilegedMode(true);
+
+    // Palette, border and cursor colours.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x00001ABC));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x3C000123));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart + 0x40, 0x40000F00));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x4C0000F0));
+
+    // Stereo image position, sound frequency and control.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x64000005));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0xC0000042));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0xE000000D));
+
+    const VIDC10 &vidc = specimen.getVideoController();
+    const VidcPalette &palette = vidc.getPalette();
+
+    EXPECT_EQ(palette.Colours[0], 0x1ABCu);
+    EXPECT_EQ(palette.Colours[15], 0x0123u);
+    EXPECT_EQ(palette.Border, 0x0F00u);
+    EXPECT_EQ(palette.Cursor[2], 0x00F0u);
+    EXPECT_EQ(vidc.getStereoPosition(1), 5u);
+    EXPECT_EQ(vidc.getSoundFrequency(), 0x42u);
+    EXPECT_EQ(vidc.getControlRegister(), 0x0Du);
+
+    // Timing registers are decoded with the offsets from the data sheet.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, makeVidcTiming(0, 31)));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, makeVidcTiming(3, 1)));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, makeVidcTiming(6, 1025)));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, makeVidcTiming(11, 2)));
+
+    VidcTiming timing = vidc.getTiming();
+    EXPECT_EQ(timing.BitsPerPixelPow2, 3u);
+    EXPECT_EQ(timing.PixelRate, 1u);
+    EXPECT_EQ(timing.getPixelClockHz(), 12000000u);
+    EXPECT_EQ(timing.HorzCycle, 64u);
+    EXPECT_EQ(timing.HorzDisplayStart, 7u);
+    EXPECT_EQ(timing.HorzCursorStart, 1031u);
+    EXPECT_EQ(timing.VertDisplayStart, 3u);
+}
+
+TEST_F(MemcHardwareTests, RenderFrameFromVideoMemory)
+{
+    specimen.setPrivilegedMode(true);
+
+    // A 16 x 3 pixel 4 bpp display area with a 4 pixel border left and right,
+    // 1 raster line top and bottom.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0xE0000008));
+
+    const uint16_t timingRegisters[] = {
+        31, 0, 2, 1, 9, 14, 0, 0,   // Horizontal
+        9, 0, 1, 2, 5, 6, 3, 4      // Vertical
+    };
+
+    for (uint8_t i = 0; i < std::size(timingRegisters); ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart,
+                                             makeVidcTiming(i, timingRegisters[i])));
+    }
+
+    for (uint32_t i = 0; i < VidcPalette::ColourCount; ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, (i << 26) | (i * 0x111)));
+    }
+
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x40000F00)); // Border
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x4400000F)); // Cursor 1
+
+    // Put the display area in the first 32 bytes of RAM, starting half way
+    // through so that the DMA pointer wraps.
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint8_t>(MEMC::PhysRamStart + i,
+                                            static_cast<uint8_t>(i * 0x11)));
+    }
+
+    EXPECT_TRUE(specimen.write<uint8_t>(MEMC::PhysRamStart + 0x100, 0x01));
+
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(0, 16), 0)); // Vinit
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(1, 0), 0)); // Vstart
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(2, 16), 0)); // Vend
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(3, 0x100), 0)); // Cinit
+
+    const VidcTiming timing = specimen.getVideoController().getTiming();
+    ASSERT_TRUE(timing.isValid());
+    ASSERT_EQ(timing.getFrameWidth(), 24u);
+    ASSERT_EQ(timing.getFrameHeight(), 5u);
+
+    FrameConverter converter;
+    std::vector<uint32_t> frame(24 * 5, 0);
+
+    // Video DMA is disabled, so only the border is visible.
+    const uint32_t border = VidcPalette::toHostColour(0xF00);
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), 24));
+    EXPECT_EQ(frame, std::vector<uint32_t>(frame.size(), border));
+
+    EXPECT_TRUE(specimen.write<uint32_t>(0x36E0400, 0));
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), 24));
+
+    const uint32_t lineAddresses[] = { 16, 24, 0 };
+
+    for (uint32_t y = 0; y < 5; ++y)
+    {
+        for (uint32_t x = 0; x < 24; ++x)
+        {
+            uint32_t expected = border;
+
+            if ((y >= 1) && (y < 4) && (x >= 4) && (x < 20))
+            {
+                // The pixels are palette indexes, each byte holding 2.
+                uint32_t addr = lineAddresses[y - 1] + ((x - 4) / 2);
+                uint32_t pixel = ((addr * 0x11) >> ((x & 1) * 4)) & 0x0F;
+
+                expected = VidcPalette::toHostColour(static_cast<uint16_t>(pixel * 0x111));
+            }
+            else if ((y == 2) && (x == 1))
+            {
+                // The cursor appears in the border.
+                expected = VidcPalette::toHostColour(0x00F);
+            }
+
+            EXPECT_EQ(frame[(y * 24) + x], expected) << "At " << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(MemcHardwareTests, RenderOnlyChangedLines)
+{
+    configureTestDisplay(specimen);
+
+    const VidcTiming timing = specimen.getVideoController().getTiming();
+    ASSERT_TRUE(timing.isValid());
+    ASSERT_EQ(timing.getDisplayBytesPerLine(), 256u);
+
+    const uint32_t width = timing.getFrameWidth();
+    FrameConverter converter;
+    std::vector<uint32_t> frame(width * timing.getFrameHeight(), 0);
+
+    // The first frame is rendered in its entirety.
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+
+    // Nothing has changed.
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 0u);
+
+    // Palette changes cause a full refresh.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, (3u << 26) | 0x0ABC));
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+
+    // Modify the second display line, which is the third line of the frame.
+    EXPECT_TRUE(specimen.write<uint8_t>(MEMC::PhysRamStart + 300, 0x30));
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 1u);
+
+    const uint32_t displayLeft = timing.HorzDisplayStart - timing.HorzBorderStart;
+    EXPECT_EQ(frame[(2 * width) + displayLeft + 88], VidcPalette::toHostColour(0));
+    EXPECT_EQ(frame[(2 * width) + displayLeft + 89], VidcPalette::toHostColour(0x0ABC));
+
+    // Writes outside the video buffer are ignored.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::PhysRamStart + 0x10000, 0x12345678));
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 0u);
+
+    // Moving the cursor only updates the line it appears on.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, makeVidcTiming(6, 100)));
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 1u);
+
+    // As do changes to the border colour.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart, 0x40000F00)); // Border
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+
+    // As does changing the video DMA registers.
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(0, 256), 0)); // Vinit
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+}
+
+TEST_F(MemcHardwareTests, RenderLinesWrittenByHost)
+{
+    configureTestDisplay(specimen);
+    specimen.setPrivilegedMode(true);
+
+    const VidcTiming timing = specimen.getVideoController().getTiming();
+    ASSERT_TRUE(timing.isValid());
+
+    const uint32_t width = timing.getFrameWidth();
+    FrameConverter converter;
+    std::vector<uint32_t> frame(width * timing.getFrameHeight(), 0);
+
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+
+    void *hostBlock = nullptr;
+    uint32_t hostLength = 0;
+
+    ASSERT_EQ(specimen.tryGetWriteHostMapping(MEMC::PhysRamStart, hostBlock,
+                                              hostLength), AddrMapResult::Success);
+    uint8_t *ram = static_cast<uint8_t *>(hostBlock);
+
+    // Writes which bypass the processor are only seen once marked.
+    ram[300] = 0x30;
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 0u);
+
+    specimen.markHostWrite(MEMC::PhysRamStart + 300, 1);
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 1u);
+
+    // A run which covers the whole of RAM marks every line.
+    specimen.markHostWrite(MEMC::PhysRamStart, hostLength);
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 5u);
+
+    // Runs outside the video buffer or physical RAM are ignored.
+    specimen.markHostWrite(MEMC::PhysRamStart + 0x10000, 0x100);
+    specimen.markHostWrite(MEMC::IOAddrStart, 0x100);
+    ASSERT_TRUE(specimen.renderFrame(converter, frame.data(), width));
+    EXPECT_EQ(specimen.getRenderedLineCount(), 0u);
+}
+
+GTEST_TEST(MemcHardware, PublishFramesCarryingChanges)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    options.setVideoOutput(true);
+
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    configureTestDisplay(specimen);
+
+    VideoFrameExchange *exchange = specimen.getVideoFrames();
+    ASSERT_NE(exchange, nullptr);
+
+    uint64_t sequence = 0;
+    uint32_t dirtyLineCount = 0;
+
+    // The first frame is published in its entirety.
+    ASSERT_TRUE(specimen.publishFrame(sequence, dirtyLineCount));
+    EXPECT_EQ(sequence, 1u);
+    EXPECT_EQ(dirtyLineCount, 5u);
+
+    // Nothing is published if nothing has changed.
+    EXPECT_FALSE(specimen.publishFrame(sequence, dirtyLineCount));
+
+    // A frame replacing one not yet acquired carries its changes.
+    EXPECT_TRUE(specimen.write<uint8_t>(MEMC::PhysRamStart + 300, 0x30));
+    ASSERT_TRUE(specimen.publishFrame(sequence, dirtyLineCount));
+    EXPECT_EQ(sequence, 2u);
+    EXPECT_EQ(dirtyLineCount, 5u);
+
+    const VideoFrame *frame = exchange->tryAcquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->Sequence, 2u);
+    EXPECT_EQ(frame->Display[300], 0x30);
+
+    // Once acquired, only new changes are published.
+    EXPECT_TRUE(specimen.write<uint8_t>(MEMC::PhysRamStart + 301, 0x31));
+    ASSERT_TRUE(specimen.publishFrame(sequence, dirtyLineCount));
+    EXPECT_EQ(sequence, 3u);
+    EXPECT_EQ(dirtyLineCount, 1u);
+
+    frame = exchange->tryAcquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_TRUE(frame->isLineDirty(2));
+    EXPECT_EQ(frame->Display[301], 0x31);
+
+    // The consumer can ask for the whole frame again.
+    exchange->requestFullRefresh();
+    ASSERT_TRUE(specimen.publishFrame(sequence, dirtyLineCount));
+    EXPECT_EQ(dirtyLineCount, 5u);
+}
+
+TEST_F(MemcHardwareTests, NoVideoFramesWhenHeadless)
+{
+    uint64_t sequence = 0;
+    uint32_t dirtyLineCount = 0;
+
+    configureTestDisplay(specimen);
+
+    EXPECT_EQ(specimen.getVideoFrames(), nullptr);
+    EXPECT_FALSE(specimen.publishFrame(sequence, dirtyLineCount));
+}
+
+GTEST_TEST(MemcHardware, VerticalFlybackEachFrame)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    configureTestDisplay(specimen);
+    connectTestDevices(specimen, context);
+
+    const VIDC10 &vidc = specimen.getVideoController();
+    const VidcTiming timing = vidc.getTiming();
+    ASSERT_TRUE(timing.isValid());
+
+    const uint64_t frameTicks = (context.getMasterClockFrequency() *
+                                 timing.HorzCycle * timing.VertCycle) /
+                                timing.getPixelClockHz();
+
+    // 3 display lines of 16 requests and 1 cursor line of a single request,
+    // 5 cycles per request.
+    const uint64_t frameDmaCycles = (3 * 16 * 5) + 5;
+
+    EXPECT_FALSE(takeVerticalFlyback(specimen));
+
+    // Nothing happens until the end of the frame.
+    runUntil(context, frameTicks - 1);
+    EXPECT_EQ(vidc.getFrameCount(), 0u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), 0u);
+    EXPECT_FALSE(takeVerticalFlyback(specimen));
+
+    runUntil(context, frameTicks);
+    EXPECT_EQ(vidc.getFrameCount(), 1u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), frameDmaCycles);
+    EXPECT_TRUE(takeVerticalFlyback(specimen));
+
+    // Frames continue at the same rate.
+    runUntil(context, frameTicks * 3);
+    EXPECT_EQ(vidc.getFrameCount(), 3u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), frameDmaCycles * 3);
+    EXPECT_TRUE(takeVerticalFlyback(specimen));
+
+    // No cycles are taken while video DMA is disabled, from the next frame.
+    EXPECT_TRUE(specimen.write<uint32_t>(0x36E0000, 0));
+    runUntil(context, frameTicks * 5);
+    EXPECT_EQ(vidc.getFrameCount(), 5u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), frameDmaCycles * 4);
+}
+
+GTEST_TEST(MemcHardware, VerticalFlybackAtEndOfDisplay)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    options.setScanlineTiming(true);
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+    configureTestDisplay(specimen);
+    connectTestDevices(specimen, context);
+
+    const VIDC10 &vidc = specimen.getVideoController();
+    const VidcTiming timing = vidc.getTiming();
+    ASSERT_TRUE(timing.isValid());
+
+    const uint64_t lineTicks = (context.getMasterClockFrequency() * timing.HorzCycle) /
+                               timing.getPixelClockHz();
+
+    EXPECT_FALSE(takeVerticalFlyback(specimen));
+
+    // DMA cycles are taken as each display line starts.
+    runUntil(context, (lineTicks * timing.VertDisplayStart) + 1);
+    EXPECT_EQ(vidc.getStolenCycleCount(), 16u * 5u);
+    EXPECT_EQ(vidc.getFrameCount(), 0u);
+
+    // Flyback starts on the line after the display, not at the end of the frame.
+    runUntil(context, (lineTicks * timing.VertDisplayEnd) - 1);
+    EXPECT_EQ(vidc.getFrameCount(), 0u);
+    EXPECT_FALSE(takeVerticalFlyback(specimen));
+
+    runUntil(context, (lineTicks * timing.VertDisplayEnd) + 1);
+    EXPECT_EQ(vidc.getFrameCount(), 1u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), (3u * 16u * 5u) + 5u);
+    EXPECT_TRUE(takeVerticalFlyback(specimen));
+
+    // The next frame starts at the same point in the raster.
+    runUntil(context, (lineTicks * (timing.VertCycle + timing.VertDisplayEnd)) + 1);
+    EXPECT_EQ(vidc.getFrameCount(), 2u);
+    EXPECT_TRUE(takeVerticalFlyback(specimen));
+}
+
+GTEST_TEST(MemcHardware, SoundDmaSwapsBuffers)
+{
+    AddressMap readDevices, writeDevices;
+    Options options;
+    options.setSoundOutput(true);
+    GuestEventQueue events;
+    SystemContext context(options, events, nullptr);
+    MemcHardware specimen(options, readDevices, writeDevices);
+    specimen.reset();
+
+    SoundSampleRing *ring = specimen.getSoundSamples();
+    ASSERT_NE(ring, nullptr);
+
+    // Play a byte every 8 microseconds, channel 0 full left.
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart,
+                                         (static_cast<uint32_t>(VidcRegister::SoundFrequency) << 26) | 6));
+    EXPECT_TRUE(specimen.write<uint32_t>(MEMC::VidcStart,
+                                         (static_cast<uint32_t>(VidcRegister::StereoBase) << 26) | 1));
+
+    // A buffer of 2 blocks, the first at full scale, the second silent.
+    for (uint32_t offset = 0; offset < 16; offset += 4)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(MEMC::PhysRamStart + 0x2000 + offset, 0xFEFEFEFE));
+    }
+
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(4, 0x2000), 0)); // Sstart
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(5, 0x2010), 0)); // SendN
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(6, 0), 0));      // Sptr
+    EXPECT_TRUE(specimen.write<uint32_t>(0x36E0800, 0)); // Enable sound DMA.
+    connectTestDevices(specimen, context);
+
+    const VIDC10 &vidc = specimen.getVideoController();
+    const uint64_t blockTicks = (context.getMasterClockFrequency() * 16 * 8) / 1000000;
+    EXPECT_EQ(vidc.getSoundSampleRate(), 125000u);
+
+    runUntil(context, blockTicks - 1);
+    EXPECT_EQ(vidc.getSoundSampleCount(), 0u);
+
+    runUntil(context, blockTicks);
+    EXPECT_EQ(vidc.getSoundSampleCount(), 16u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), 5u);
+    EXPECT_FALSE(isSoundBufferIrqActive(specimen));
+
+    // The end of the buffer requests the next.
+    runUntil(context, blockTicks * 2);
+    EXPECT_EQ(vidc.getSoundSampleCount(), 32u);
+    EXPECT_TRUE(isSoundBufferIrqActive(specimen));
+
+    // Programming the next buffer acknowledges the interrupt.
+    EXPECT_TRUE(specimen.write<uint32_t>(makeMemcDmaAddress(4, 0x3000), 0));
+    EXPECT_FALSE(isSoundBufferIrqActive(specimen));
+
+    // The samples were converted and queued for the host.
+    StereoSample samples[32];
+    EXPECT_EQ(ring->getSampleRate(), 125000u);
+    ASSERT_EQ(ring->read(samples, 32), 32u);
+    EXPECT_GT(samples[0].Left, 32000);
+    EXPECT_EQ(samples[0].Right, 0);
+    EXPECT_EQ(samples[1].Left, samples[1].Right);
+    EXPECT_EQ(samples[16].Left, 0);
+    EXPECT_EQ(samples[16].Right, 0);
+
+    // No cycles are taken while sound DMA is disabled.
+    EXPECT_TRUE(specimen.write<uint32_t>(0x36E0000, 0));
+    runUntil(context, blockTicks * 4);
+    EXPECT_EQ(vidc.getSoundSampleCount(), 32u);
+    EXPECT_EQ(vidc.getStolenCycleCount(), 10u);
+}
+
 } // Anonymous namespace
 
 }} // namespace Mo::Arm
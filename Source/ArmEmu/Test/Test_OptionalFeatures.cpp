@@ -0,0 +1,121 @@
+//! @file Test_OptionalFeatures.cpp
+//! @brief The definition of unit tests which verify that the optional
+//! diagnostic features of an emulated system are only compiled into the
+//! systems configured to have them.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "PipelineInstrumentation.inl"
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes the guest call stack profiler.
+struct ProfilerFeature
+{
+    using ConfiguredTraits = ProfiledSystemTraits<ArmV2TestSystemTraits>;
+
+    template<typename TSysTraits>
+    static bool isPresent(ArmSystem<TSysTraits> &system)
+    {
+        return system.getProfiler() != nullptr;
+    }
+};
+
+//! @brief Describes the per-address execution counters.
+struct ExecutionCountersFeature
+{
+    using ConfiguredTraits = ProfiledSystemTraits<ArmV2TestSystemTraits>;
+
+    template<typename TSysTraits>
+    static bool isPresent(ArmSystem<TSysTraits> &system)
+    {
+        return system.getExecutionCounters() != nullptr;
+    }
+};
+
+//! @brief Describes the guest code coverage recorder.
+struct CoverageFeature
+{
+    using ConfiguredTraits = CoverageSystemTraits<ArmV2TestSystemTraits>;
+
+    template<typename TSysTraits>
+    static bool isPresent(ArmSystem<TSysTraits> &system)
+    {
+        return system.getCoverage() != nullptr;
+    }
+};
+
+//! @brief Describes the execution trace.
+struct ExecutionTraceFeature
+{
+    using ConfiguredTraits = TracedSystemTraits<ArmV2TestSystemTraits>;
+
+    template<typename TSysTraits>
+    static bool isPresent(ArmSystem<TSysTraits> &system)
+    {
+        return system.getExecutionTrace() != nullptr;
+    }
+};
+
+//! @brief Describes the instruction class counts of the pipeline, which
+//! have no accessor as they are reported in ExecutionMetrics::Breakdown.
+struct InstrumentationFeature
+{
+    using ConfiguredTraits = InstrumentedSystemTraits<ArmV2TestSystemTraits>;
+
+    template<typename TSysTraits>
+    static bool isPresent(ArmSystem<TSysTraits> &/*system*/)
+    {
+        return TSysTraits::PrimaryPipelineType::Instrumentation::IsEnabled;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+class OptionalFeature : public testing::Test
+{
+public:
+};
+
+TYPED_TEST_SUITE_P(OptionalFeature);
+
+TYPED_TEST_P(OptionalFeature, NotPresentUnlessConfigured)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> plainSystem(opts);
+    ArmSystem<typename TypeParam::ConfiguredTraits> configuredSystem(opts);
+
+    EXPECT_FALSE(TypeParam::isPresent(plainSystem));
+    EXPECT_TRUE(TypeParam::isPresent(configuredSystem));
+}
+
+REGISTER_TYPED_TEST_SUITE_P(OptionalFeature, NotPresentUnlessConfigured);
+
+INSTANTIATE_TYPED_TEST_SUITE_P(GuestProfiler, OptionalFeature, ProfilerFeature);
+INSTANTIATE_TYPED_TEST_SUITE_P(ExecutionCounterTable, OptionalFeature, ExecutionCountersFeature);
+INSTANTIATE_TYPED_TEST_SUITE_P(GuestCoverage, OptionalFeature, CoverageFeature);
+INSTANTIATE_TYPED_TEST_SUITE_P(ExecutionTrace, OptionalFeature, ExecutionTraceFeature);
+INSTANTIATE_TYPED_TEST_SUITE_P(PipelineInstrumentation, OptionalFeature, InstrumentationFeature);
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -177,6 +177,30 @@ GTEST_TEST(Options, InvalidArchimedesConfiguration)
     specimen.setRamSizeKb(4096);
 }
 
+GTEST_TEST(Options, CoverageExcludesProfilingAndTracing)
+{
+    Options specimen;
+    Ag::String error;
+
+    specimen.setGuestProfiling(true);
+    specimen.setExecutionTracing(true);
+    specimen.setInstrumentation(true);
+    EXPECT_TRUE(specimen.validate(error));
+    EXPECT_TRUE(error.isEmpty()) << error.toUtf8();
+
+    specimen.setGuestCoverage(true);
+    EXPECT_FALSE(specimen.validate(error));
+    EXPECT_TRUE(error.contains("coverage"));
+
+    specimen.setGuestProfiling(false);
+    EXPECT_FALSE(specimen.validate(error));
+    EXPECT_TRUE(error.contains("coverage"));
+
+    specimen.setExecutionTracing(false);
+    EXPECT_TRUE(specimen.validate(error));
+    EXPECT_TRUE(error.isEmpty()) << error.toUtf8();
+}
+
 } // Anonymous namespace
 
 }} // namespace Mo::Arm
@@ -0,0 +1,265 @@
+//! @file Test_PerfTestResults.cpp
+//! @brief The definition of unit tests of storing and comparing the results
+//! of EmuPerfTest benchmark runs.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cmath>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "PerfTestResults.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates the results of a workload with a set of speed samples.
+WorkloadResult makeResult(const char *workload, std::vector<double> mipsSamples)
+{
+    WorkloadResult result;
+    result.Configuration = "ARMv2-MEMC";
+    result.Workload = workload;
+    result.Iterations = 1000;
+    result.Instructions = 123456789;
+    result.Cycles = 234567890;
+    result.MipsSamples = std::move(mipsSamples);
+    result.SecondsSamples.assign(result.MipsSamples.size(), 0.5);
+
+    return result;
+}
+
+//! @brief Creates statistics of a sample set with a specific mean and
+//! standard deviation.
+SampleStatistics makeStats(size_t count, double mean, double stdDev)
+{
+    return SampleStatistics { count, mean, stdDev, mean, mean };
+}
+
+//! @brief Attempts to read results from a string.
+bool tryReadText(SuiteResults &results, const char *text, std::string &error)
+{
+    std::istringstream input(text);
+
+    return results.tryRead(input, error);
+}
+
+//! @brief Finds the comparison of a specific workload.
+const ResultComparison *findComparison(const std::vector<ResultComparison> &comparisons,
+                                       const char *workload)
+{
+    const ResultComparison *match = nullptr;
+
+    for (const ResultComparison &comparison : comparisons)
+    {
+        if (comparison.Workload == workload)
+        {
+            match = &comparison;
+            break;
+        }
+    }
+
+    return match;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SuiteResults, WriteThenReadRoundTrips)
+{
+    HostInfo host;
+    host.OperatingSystem = "Linux 6.1";
+    host.Processor = "Quoted \"CPU\" with a \\ and a\ttab";
+    host.Compiler = "GCC 12.2";
+    host.BuildType = "Release";
+    host.Timestamp = "2024-05-01T12:00:00Z";
+    host.LogicalCores = 16;
+
+    SuiteResults original;
+    original.setHost(host);
+    original.addResult(makeResult("Dhrystone", { 12.5, 13.25, 12.75 }));
+    original.addResult(makeResult("Empty", {}));
+
+    std::ostringstream output;
+    original.write(output);
+
+    SuiteResults specimen;
+    std::istringstream input(output.str());
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryRead(input, error)) << error;
+
+    const HostInfo &readHost = specimen.getHost();
+    EXPECT_EQ(readHost.OperatingSystem, host.OperatingSystem);
+    EXPECT_EQ(readHost.Processor, host.Processor);
+    EXPECT_EQ(readHost.Compiler, host.Compiler);
+    EXPECT_EQ(readHost.BuildType, host.BuildType);
+    EXPECT_EQ(readHost.Timestamp, host.Timestamp);
+    EXPECT_EQ(readHost.LogicalCores, host.LogicalCores);
+
+    ASSERT_EQ(specimen.getResults().size(), 2u);
+
+    const WorkloadResult *result = specimen.findResult("ARMv2-MEMC", "Dhrystone");
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->Iterations, 1000u);
+    EXPECT_EQ(result->Instructions, 123456789u);
+    EXPECT_EQ(result->Cycles, 234567890u);
+    EXPECT_EQ(result->MipsSamples, std::vector<double>({ 12.5, 13.25, 12.75 }));
+    EXPECT_EQ(result->SecondsSamples, std::vector<double>({ 0.5, 0.5, 0.5 }));
+
+    result = specimen.findResult("ARMv2-MEMC", "Empty");
+    ASSERT_NE(result, nullptr);
+    EXPECT_TRUE(result->MipsSamples.empty());
+}
+
+GTEST_TEST(SuiteResults, RejectsMalformedDocuments)
+{
+    const char *malformed[] = {
+        "",
+        "{",
+        "{ \"tool\": \"EmuPerfTest\", \"host\": {}, \"results\": [ }",
+        "{ \"tool\": \"EmuPerfTest\", \"host\": {}, \"results\": [] } trailing",
+        "{ \"tool\": \"EmuPerfTest\" \"host\": {} }",
+        "{ \"tool\": \"EmuPerfTest\", \"host\": { \"os\": \"Unterminated } }",
+        "[ 1, 2, 3 ]",
+        "{ \"tool\": \"OtherTool\", \"host\": {}, \"results\": [] }",
+        "{ \"tool\": \"EmuPerfTest\", \"results\": [] }",
+        "{ \"tool\": \"EmuPerfTest\", \"host\": {}, \"results\": {} }",
+    };
+
+    for (const char *text : malformed)
+    {
+        SuiteResults specimen;
+        specimen.addResult(makeResult("Existing", { 1.0 }));
+        std::string error;
+
+        EXPECT_FALSE(tryReadText(specimen, text, error)) << text;
+        EXPECT_FALSE(error.empty()) << text;
+
+        // The existing results should be left alone.
+        EXPECT_NE(specimen.findResult("ARMv2-MEMC", "Existing"), nullptr) << text;
+    }
+}
+
+GTEST_TEST(SuiteResults, RejectsDeeplyNestedDocuments)
+{
+    SuiteResults specimen;
+    std::string text(100, '[');
+    text.append(100, ']');
+    std::string error;
+
+    EXPECT_FALSE(tryReadText(specimen, text.c_str(), error));
+    EXPECT_FALSE(error.empty());
+}
+
+GTEST_TEST(SuiteResults, CompareFlagsSignificantChanges)
+{
+    SuiteResults baseline;
+    baseline.addResult(makeResult("Slower", { 10.0, 10.1, 9.9, 10.0, 10.05, 9.95 }));
+    baseline.addResult(makeResult("Faster", { 10.0, 10.1, 9.9, 10.0, 10.05, 9.95 }));
+    baseline.addResult(makeResult("Same", { 10.0, 10.1, 9.9, 10.0, 10.05, 9.95 }));
+    baseline.addResult(makeResult("Tiny", { 10.0, 10.001, 9.999, 10.0 }));
+    baseline.addResult(makeResult("Noisy", { 5.0, 15.0, 8.0, 12.0 }));
+
+    SuiteResults current;
+    current.addResult(makeResult("Slower", { 8.0, 8.1, 7.9, 8.0, 8.05, 7.95 }));
+    current.addResult(makeResult("Faster", { 12.0, 12.1, 11.9, 12.0, 12.05, 11.95 }));
+    current.addResult(makeResult("Same", { 10.0, 10.1, 9.9, 10.0, 10.05, 9.95 }));
+    current.addResult(makeResult("Tiny", { 10.1, 10.101, 10.099, 10.1 }));
+    current.addResult(makeResult("Noisy", { 6.0, 16.0, 9.0, 13.0 }));
+    current.addResult(makeResult("New", { 10.0, 10.0 }));
+
+    std::vector<ResultComparison> comparisons = current.compare(baseline);
+
+    // Workloads missing from the baseline are not compared.
+    EXPECT_EQ(comparisons.size(), 5u);
+    EXPECT_EQ(findComparison(comparisons, "New"), nullptr);
+
+    const ResultComparison *slower = findComparison(comparisons, "Slower");
+    ASSERT_NE(slower, nullptr);
+    EXPECT_NEAR(slower->RelativeChange, -0.2, 1e-9);
+    EXPECT_LT(slower->PValue, SuiteResults::DefaultSignificance);
+    EXPECT_TRUE(slower->IsRegression);
+    EXPECT_FALSE(slower->IsImprovement);
+
+    const ResultComparison *faster = findComparison(comparisons, "Faster");
+    ASSERT_NE(faster, nullptr);
+    EXPECT_NEAR(faster->RelativeChange, 0.2, 1e-9);
+    EXPECT_LT(faster->PValue, SuiteResults::DefaultSignificance);
+    EXPECT_FALSE(faster->IsRegression);
+    EXPECT_TRUE(faster->IsImprovement);
+
+    const ResultComparison *same = findComparison(comparisons, "Same");
+    ASSERT_NE(same, nullptr);
+    EXPECT_DOUBLE_EQ(same->RelativeChange, 0.0);
+    EXPECT_DOUBLE_EQ(same->PValue, 1.0);
+    EXPECT_FALSE(same->IsRegression);
+    EXPECT_FALSE(same->IsImprovement);
+
+    // Significant, but smaller than the minimum change reported.
+    const ResultComparison *tiny = findComparison(comparisons, "Tiny");
+    ASSERT_NE(tiny, nullptr);
+    EXPECT_LT(tiny->PValue, SuiteResults::DefaultSignificance);
+    EXPECT_FALSE(tiny->IsRegression);
+    EXPECT_FALSE(tiny->IsImprovement);
+
+    // Large, but not significant given the spread of the samples.
+    const ResultComparison *noisy = findComparison(comparisons, "Noisy");
+    ASSERT_NE(noisy, nullptr);
+    EXPECT_GT(noisy->RelativeChange, SuiteResults::DefaultMinimumChange);
+    EXPECT_GT(noisy->PValue, SuiteResults::DefaultSignificance);
+    EXPECT_FALSE(noisy->IsRegression);
+    EXPECT_FALSE(noisy->IsImprovement);
+}
+
+GTEST_TEST(WelchTTest, MatchesKnownDistributionValues)
+{
+    // With 2 samples per set and unit deviations, dof = 2 and the error
+    // variance is 1, so t is the difference in means. The two-tailed p-value
+    // for 2 degrees of freedom is 1 - t / sqrt(2 + t^2).
+    EXPECT_NEAR(calculateWelchPValue(makeStats(2, 1.0, 1.0), makeStats(2, 0.0, 1.0)),
+                1.0 - (1.0 / std::sqrt(3.0)), 1e-9);
+    EXPECT_NEAR(calculateWelchPValue(makeStats(2, 4.302652730, 1.0), makeStats(2, 0.0, 1.0)),
+                0.05, 1e-6);
+
+    // With 6 samples per set and variance 3, dof = 10 and the error
+    // variance is 1. Compare against the critical values of Student's t.
+    const double stdDev = std::sqrt(3.0);
+    EXPECT_NEAR(calculateWelchPValue(makeStats(6, 2.228138852, stdDev), makeStats(6, 0.0, stdDev)),
+                0.05, 1e-6);
+    EXPECT_NEAR(calculateWelchPValue(makeStats(6, 0.0, stdDev), makeStats(6, 3.169272673, stdDev)),
+                0.01, 1e-6);
+    EXPECT_NEAR(calculateWelchPValue(makeStats(6, 1.812461123, stdDev), makeStats(6, 0.0, stdDev)),
+                0.10, 1e-6);
+
+    // Equal means can't be told apart.
+    EXPECT_DOUBLE_EQ(calculateWelchPValue(makeStats(6, 5.0, stdDev), makeStats(6, 5.0, stdDev)),
+                     1.0);
+}
+
+GTEST_TEST(WelchTTest, HandlesDegenerateSamples)
+{
+    // Too few samples to draw a conclusion.
+    EXPECT_DOUBLE_EQ(calculateWelchPValue(makeStats(1, 10.0, 0.0), makeStats(5, 1.0, 0.1)), 1.0);
+    EXPECT_DOUBLE_EQ(calculateWelchPValue(makeStats(5, 10.0, 0.1), makeStats(0, 0.0, 0.0)), 1.0);
+
+    // No variance at all.
+    EXPECT_DOUBLE_EQ(calculateWelchPValue(makeStats(4, 10.0, 0.0), makeStats(4, 10.0, 0.0)), 1.0);
+    EXPECT_DOUBLE_EQ(calculateWelchPValue(makeStats(4, 10.0, 0.0), makeStats(4, 9.0, 0.0)), 0.0);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
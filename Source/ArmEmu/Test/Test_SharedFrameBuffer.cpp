@@ -0,0 +1,199 @@
+//! @file Test_SharedFrameBuffer.cpp
+//! @brief The definition of unit tests of exporting the emulated display
+//! through shared memory.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/SharedFrameBuffer.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates a shared memory object name unique to the test process.
+std::string createTestName()
+{
+    std::string name("MightyOakTestFrames");
+
+#ifndef _WIN32
+    name.append(std::to_string(::getpid()));
+#endif
+
+    return name;
+}
+
+//! @brief Publishes a complete 24 x 10 frame with a 16 x 2 4 bpp display
+//! area of a single colour.
+void publishTestFrame(VideoFrameExchange &exchange, uint8_t pixels,
+                      uint64_t sequence, bool isComplete)
+{
+    VideoFrame &frame = exchange.getBackFrame();
+    VidcTiming &timing = frame.Timing;
+    timing = VidcTiming();
+    timing.BitsPerPixelPow2 = 2;
+    timing.HorzCycle = 40;
+    timing.HorzBorderStart = 2;
+    timing.HorzDisplayStart = 6;
+    timing.HorzDisplayEnd = 22;
+    timing.HorzBorderEnd = 26;
+    timing.VertCycle = 12;
+    timing.VertBorderStart = 1;
+    timing.VertDisplayStart = 5;
+    timing.VertDisplayEnd = 7;
+    timing.VertBorderEnd = 11;
+
+    frame.Palette.Border = 0x00F;
+    frame.Palette.Colours[3] = 0xF00;
+    frame.Palette.Colours[5] = 0x0F0;
+    frame.Display.assign(timing.getDisplayBytesPerLine() * timing.getDisplayHeight(),
+                         pixels);
+    frame.Cursor.clear();
+    frame.DirtyLines.assign(1, 0);
+    frame.IsDisplayEnabled = true;
+    frame.Sequence = sequence;
+
+    if (isComplete)
+    {
+        for (uint16_t line = 0; line < timing.getFrameHeight(); ++line)
+        {
+            frame.markLineDirty(line);
+        }
+    }
+    else
+    {
+        // Only the second display line has changed.
+        frame.markLineDirty(5);
+    }
+
+    exchange.publish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SharedFrameBuffer, RejectInvalidParameters)
+{
+    SharedFrameWriter writer;
+    SharedFrameReader reader;
+    std::string error;
+
+    EXPECT_FALSE(writer.tryCreate(std::string(), error));
+    EXPECT_FALSE(error.empty());
+
+    error.clear();
+    EXPECT_FALSE(writer.tryCreate(createTestName(), error, 640,
+                                  SharedFrameHeader::MaxLineCount + 1));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(writer.isOpen());
+
+    error.clear();
+    EXPECT_FALSE(reader.tryOpen(createTestName() + "Missing", error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(reader.isOpen());
+}
+
+#ifndef _WIN32
+GTEST_TEST(SharedFrameBuffer, ExportFramesToReader)
+{
+    const std::string name = createTestName();
+    const uint32_t border = VidcPalette::toHostColour(0x00F);
+    const uint32_t red = VidcPalette::toHostColour(0xF00);
+    const uint32_t green = VidcPalette::toHostColour(0x0F0);
+
+    VideoFrameExchange exchange;
+    SharedFrameWriter writer;
+    SharedFrameReader reader;
+    std::string error;
+
+    ASSERT_TRUE(writer.tryCreate(name, error, 64, 32)) << error;
+    ASSERT_TRUE(reader.tryOpen(name, error)) << error;
+
+    const SharedFrameHeader *header = reader.getHeader();
+    EXPECT_EQ(header->Magic, SharedFrameHeader::MagicNumber);
+    EXPECT_EQ(header->MaxWidth, 64u);
+    EXPECT_EQ(header->MaxHeight, 32u);
+    EXPECT_EQ(header->Width, 0u);
+
+    // Nothing to publish.
+    EXPECT_FALSE(writer.tryPublish(exchange));
+
+    // A partial first frame can't be applied, a full refresh is requested.
+    publishTestFrame(exchange, 0x33, 1, false);
+    EXPECT_FALSE(writer.tryPublish(exchange));
+    EXPECT_TRUE(exchange.tryTakeRefreshRequest());
+
+    publishTestFrame(exchange, 0x33, 2, true);
+    ASSERT_TRUE(writer.tryPublish(exchange));
+
+    // The reader sees the pixels written, in place.
+    uint64_t update = reader.beginRead();
+    EXPECT_EQ(update, 2u);
+    EXPECT_EQ(header->Width, 24u);
+    EXPECT_EQ(header->Height, 10u);
+    EXPECT_EQ(header->FrameSequence, 2u);
+    EXPECT_EQ(header->DirtyLines[0], 0x3FFu);
+    EXPECT_EQ(reader.getPixels()[0], border);
+    EXPECT_EQ(reader.getPixels()[(4 * 64) + 4], red);
+    EXPECT_TRUE(reader.isReadConsistent(update));
+
+    // A partial update only changes the dirty lines.
+    publishTestFrame(exchange, 0x55, 3, false);
+    ASSERT_TRUE(writer.tryPublish(exchange));
+    EXPECT_FALSE(reader.isReadConsistent(update));
+
+    std::vector<uint32_t> pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint64_t sequence = 0;
+
+    ASSERT_TRUE(reader.tryCopyFrame(pixels, width, height, sequence));
+    EXPECT_EQ(width, 24u);
+    EXPECT_EQ(height, 10u);
+    EXPECT_EQ(sequence, 3u);
+    EXPECT_EQ(header->DirtyLines[0], 0x20u);
+    EXPECT_EQ(pixels[(4 * 24) + 4], red);
+    EXPECT_EQ(pixels[(5 * 24) + 4], green);
+
+    // Readers keep their mapping once the writer has gone.
+    writer.close();
+    EXPECT_EQ(header->FrameSequence, 3u);
+    EXPECT_FALSE(SharedFrameReader().tryOpen(name, error));
+}
+
+GTEST_TEST(SharedFrameBuffer, SkipFramesTooLarge)
+{
+    VideoFrameExchange exchange;
+    SharedFrameWriter writer;
+    std::string error;
+
+    ASSERT_TRUE(writer.tryCreate(createTestName(), error, 16, 8)) << error;
+
+    publishTestFrame(exchange, 0x33, 1, true);
+    EXPECT_FALSE(writer.tryPublish(exchange));
+    EXPECT_EQ(writer.getHeader()->UpdateCount.load(), 0u);
+}
+#endif
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,254 @@
+//! @file Test_SoundOutput.cpp
+//! @brief The definition of unit tests of converting VIDC sound samples and
+//! handing them to the host.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/SoundOutput.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Reads a little-endian 32-bit value from a buffer.
+uint32_t readLE32(const std::vector<uint8_t> &bytes, size_t offset)
+{
+    return static_cast<uint32_t>(bytes[offset]) |
+           (static_cast<uint32_t>(bytes[offset + 1]) << 8) |
+           (static_cast<uint32_t>(bytes[offset + 2]) << 16) |
+           (static_cast<uint32_t>(bytes[offset + 3]) << 24);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SoundMixer, ConvertLogarithmicSamples)
+{
+    EXPECT_EQ(SoundMixer::toLinear(0x00), 0);
+    EXPECT_EQ(SoundMixer::toLinear(0x01), 0);
+
+    // Full scale, positive and negative.
+    EXPECT_EQ(SoundMixer::toLinear(0xFE), 8031 * 4);
+    EXPECT_EQ(SoundMixer::toLinear(0xFF), -8031 * 4);
+
+    // The magnitude increases with the sample value.
+    for (uint32_t sample = 2; sample < 256; sample += 2)
+    {
+        EXPECT_GT(SoundMixer::toLinear(static_cast<uint8_t>(sample)),
+                  SoundMixer::toLinear(static_cast<uint8_t>(sample - 2)));
+        EXPECT_EQ(SoundMixer::toLinear(static_cast<uint8_t>(sample + 1)),
+                  -SoundMixer::toLinear(static_cast<uint8_t>(sample)));
+    }
+}
+
+GTEST_TEST(SoundMixer, PositionChannels)
+{
+    int16_t left = 0;
+    int16_t right = 0;
+
+    SoundMixer::getStereoGains(1, left, right);
+    EXPECT_EQ(left, 32767);
+    EXPECT_EQ(right, 0);
+
+    SoundMixer::getStereoGains(4, left, right);
+    EXPECT_EQ(left, right);
+
+    SoundMixer::getStereoGains(7, left, right);
+    EXPECT_EQ(left, 0);
+    EXPECT_EQ(right, 32767);
+
+    // Channel 0 full left, channel 1 full right, the rest centred.
+    SoundMixer specimen(SimdLevel::Scalar);
+    const uint8_t positions[] = { 1, 7, 4, 4, 4, 4, 4, 4 };
+    EXPECT_TRUE(specimen.setStereoPositions(positions));
+    EXPECT_FALSE(specimen.setStereoPositions(positions));
+
+    const uint8_t source[] = { 0xFE, 0xFE, 0xFE };
+    StereoSample target[3];
+    specimen.mix(source, target, 3);
+
+    EXPECT_GT(target[0].Left, 32000);
+    EXPECT_EQ(target[0].Right, 0);
+    EXPECT_EQ(target[1].Left, 0);
+    EXPECT_GT(target[1].Right, 32000);
+    EXPECT_EQ(target[2].Left, target[2].Right);
+    EXPECT_GT(target[2].Left, 16000);
+}
+
+GTEST_TEST(SoundMixer, VectorMatchesScalar)
+{
+    const uint8_t positions[] = { 1, 2, 3, 4, 5, 6, 7, 0 };
+    std::vector<uint8_t> source(256 + 5);
+
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        source[i] = static_cast<uint8_t>((i * 97) + 13);
+    }
+
+    SoundMixer reference(SimdLevel::Scalar);
+    reference.setStereoPositions(positions);
+
+    std::vector<StereoSample> expected(source.size());
+    reference.mix(source.data(), expected.data(), static_cast<uint32_t>(source.size()));
+
+    for (SimdLevel level : { SimdLevel::SSE2, SimdLevel::AVX2 })
+    {
+        SoundMixer specimen(level);
+        specimen.setStereoPositions(positions);
+
+        std::vector<StereoSample> actual(source.size());
+        specimen.mix(source.data(), actual.data(), static_cast<uint32_t>(source.size()));
+
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            EXPECT_EQ(actual[i].Left, expected[i].Left) << "Sample " << i;
+            EXPECT_EQ(actual[i].Right, expected[i].Right) << "Sample " << i;
+        }
+    }
+}
+
+GTEST_TEST(SoundSampleRing, WrapAndDrop)
+{
+    SoundSampleRing specimen(64);
+    StereoSample block[40];
+    StereoSample result[64];
+
+    for (int16_t i = 0; i < 40; ++i)
+    {
+        block[i] = StereoSample { i, static_cast<int16_t>(-i) };
+    }
+
+    EXPECT_EQ(specimen.getCapacity(), 64u);
+    EXPECT_TRUE(specimen.tryWrite(block, 40));
+    EXPECT_EQ(specimen.read(result, 30), 30u);
+
+    // Wraps around the end of the buffer.
+    EXPECT_TRUE(specimen.tryWrite(block, 40));
+    EXPECT_EQ(specimen.getAvailable(), 50u);
+
+    // No room, dropped whole.
+    EXPECT_FALSE(specimen.tryWrite(block, 40));
+    EXPECT_EQ(specimen.getDroppedCount(), 40u);
+    EXPECT_FALSE(specimen.waitForSpace(40, std::chrono::milliseconds(1)));
+
+    EXPECT_EQ(specimen.read(result, 64), 50u);
+    EXPECT_EQ(result[9].Left, 39);
+    EXPECT_EQ(result[10].Left, 0);
+    EXPECT_EQ(result[49].Right, -39);
+    EXPECT_EQ(specimen.getWrittenCount(), 80u);
+    EXPECT_TRUE(specimen.waitForSpace(64, std::chrono::milliseconds(1)));
+}
+
+GTEST_TEST(SoundSampleRing, ConcurrentTransfer)
+{
+    constexpr int32_t BlockCount = 20000;
+    constexpr int32_t BlockSize = 16;
+    SoundSampleRing specimen(1024);
+
+    std::thread producer([&]() {
+        StereoSample block[BlockSize];
+
+        for (int32_t i = 0; i < BlockCount; ++i)
+        {
+            for (int32_t j = 0; j < BlockSize; ++j)
+            {
+                const int16_t value = static_cast<int16_t>((i * BlockSize) + j);
+                block[j] = StereoSample { value, static_cast<int16_t>(~value) };
+            }
+
+            // Pace the producer by the consumer, as when sound pacing.
+            while (specimen.tryWrite(block, BlockSize) == false)
+            {
+                specimen.waitForSpace(BlockSize, std::chrono::milliseconds(100));
+            }
+        }
+    });
+
+    StereoSample buffer[100];
+    int32_t received = 0;
+    bool isConsistent = true;
+
+    while (received < (BlockCount * BlockSize))
+    {
+        const size_t count = specimen.read(buffer, std::size(buffer));
+
+        for (size_t i = 0; i < count; ++i, ++received)
+        {
+            isConsistent &= (buffer[i].Left == static_cast<int16_t>(received)) &&
+                            (buffer[i].Right == static_cast<int16_t>(~received));
+        }
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(isConsistent);
+    EXPECT_EQ(specimen.getWrittenCount(), static_cast<uint64_t>(BlockCount * BlockSize));
+}
+
+GTEST_TEST(WaveFileWriter, WriteHeadlessCapture)
+{
+    const std::string fileName = ::testing::TempDir() + "MightyOakSoundTest.wav";
+    SoundSampleRing ring(256);
+    WaveFileWriter specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryStart(ring, fileName, error)) << error;
+    EXPECT_TRUE(specimen.isRunning());
+    EXPECT_FALSE(specimen.tryStart(ring, fileName, error));
+
+    const StereoSample samples[] = { { 1, -1 }, { 0x1234, -0x1234 }, { 32767, -32768 } };
+    ring.setSampleRate(20833);
+    ASSERT_TRUE(ring.tryWrite(samples, std::size(samples)));
+
+    specimen.stop();
+    EXPECT_FALSE(specimen.isRunning());
+    EXPECT_EQ(specimen.getSampleCount(), 3u);
+    EXPECT_EQ(specimen.getSampleRate(), 20833u);
+
+    std::ifstream input(fileName, std::ios::binary);
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(input)),
+                               std::istreambuf_iterator<char>());
+    input.close();
+    std::remove(fileName.c_str());
+
+    ASSERT_EQ(bytes.size(), 44u + 12u);
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + 4), "RIFF");
+    EXPECT_EQ(readLE32(bytes, 4), 36u + 12u);
+    EXPECT_EQ(std::string(bytes.begin() + 8, bytes.begin() + 16), "WAVEfmt ");
+    EXPECT_EQ(readLE32(bytes, 24), 20833u);
+    EXPECT_EQ(readLE32(bytes, 28), 20833u * 4u);
+    EXPECT_EQ(std::string(bytes.begin() + 36, bytes.begin() + 40), "data");
+    EXPECT_EQ(readLE32(bytes, 40), 12u);
+
+    // Samples are little-endian.
+    EXPECT_EQ(bytes[48], 0x34);
+    EXPECT_EQ(bytes[49], 0x12);
+    EXPECT_EQ(bytes[52], 0xFF);
+    EXPECT_EQ(bytes[53], 0x7F);
+    EXPECT_EQ(bytes[54], 0x00);
+    EXPECT_EQ(bytes[55], 0x80);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,144 @@
+//! @file Test_SystemContext.cpp
+//! @brief The definition of unit tests of the real time pacing of emulated
+//! time by SystemContext.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/EmuOptions.hpp"
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/SystemContext.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The processor speed of the emulated systems.
+constexpr uint16_t ProcessorSpeedMHz = 8;
+
+//! @brief The count of processor cycles advanced by each call to
+//! incrementCPUClock(), roughly a slice of instructions.
+constexpr uint32_t CyclesPerStep = 1000;
+
+using TestClock = std::chrono::steady_clock;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Advances emulated time by a number of milliseconds.
+//! @param[in] context The context whose clock to advance.
+//! @param[in] milliseconds The emulated time to advance by.
+//! @return The wall clock time it took.
+std::chrono::milliseconds advanceEmulatedTime(SystemContext &context,
+                                              uint32_t milliseconds)
+{
+    const uint32_t stepCount = (ProcessorSpeedMHz * 1000u * milliseconds) / CyclesPerStep;
+    const TestClock::time_point start = TestClock::now();
+
+    for (uint32_t i = 0; i < stepCount; ++i)
+    {
+        context.incrementCPUClock(CyclesPerStep);
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(TestClock::now() - start);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SystemContext, UnpacedRunsFlatOut)
+{
+    Options options;
+    options.setProcessorSpeedMHz(ProcessorSpeedMHz);
+    options.setRealTimePacing(false);
+
+    GuestEventQueue events;
+    SystemContext specimen(options, events, nullptr);
+
+    EXPECT_FALSE(specimen.isRealTimePacingEnabled());
+    EXPECT_EQ(specimen.getScheduledTaskCount(), 0u);
+
+    // A second of emulated time should take a fraction of that.
+    EXPECT_LT(advanceEmulatedTime(specimen, 1000).count(), 500);
+    EXPECT_EQ(specimen.getHostIdleTimeNs(), 0u);
+}
+
+GTEST_TEST(SystemContext, PacedKeepsToWallClock)
+{
+    Options options;
+    options.setProcessorSpeedMHz(ProcessorSpeedMHz);
+    options.setRealTimePacing(true);
+
+    GuestEventQueue events;
+    const TestClock::time_point start = TestClock::now();
+    SystemContext specimen(options, events, nullptr);
+
+    EXPECT_TRUE(specimen.isRealTimePacingEnabled());
+    EXPECT_EQ(specimen.getScheduledTaskCount(), 1u);
+
+    advanceEmulatedTime(specimen, 100);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(TestClock::now() - start);
+
+    // Emulation can't get ahead of the wall clock, and the thread was
+    // released to the host for some of the time.
+    EXPECT_GE(elapsed.count(), 100);
+    EXPECT_GT(specimen.getHostIdleTimeNs(), 0u);
+
+    // The pacing task remains scheduled.
+    EXPECT_EQ(specimen.getScheduledTaskCount(), 1u);
+}
+
+GTEST_TEST(SystemContext, TurboOverridesPacing)
+{
+    Options options;
+    options.setProcessorSpeedMHz(ProcessorSpeedMHz);
+    options.setRealTimePacing(true);
+
+    GuestEventQueue events;
+    SystemContext specimen(options, events, nullptr);
+    specimen.setTurbo(true);
+
+    EXPECT_TRUE(specimen.isTurboEnabled());
+    EXPECT_LT(advanceEmulatedTime(specimen, 1000).count(), 500);
+    EXPECT_EQ(specimen.getHostIdleTimeNs(), 0u);
+
+    // Normal speed resumes without a catch-up burst.
+    specimen.setTurbo(false);
+    const auto elapsed = advanceEmulatedTime(specimen, 50);
+
+    EXPECT_GE(elapsed.count(), 40);
+    EXPECT_GT(specimen.getHostIdleTimeNs(), 0u);
+}
+
+GTEST_TEST(SystemContext, AccountsIdleTimeOutsidePacing)
+{
+    Options options;
+    options.setProcessorSpeedMHz(ProcessorSpeedMHz);
+    options.setRealTimePacing(false);
+
+    GuestEventQueue events;
+    SystemContext specimen(options, events, nullptr);
+
+    // Time spent waiting for the host, such as for sound, is also idle.
+    specimen.addHostIdleTime(std::chrono::microseconds(250));
+    specimen.addHostIdleTime(std::chrono::nanoseconds(50));
+    EXPECT_EQ(specimen.getHostIdleTimeNs(), 250050u);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,262 @@
+//! @file Test_SystemMetrics.cpp
+//! @brief The definition of unit tests of publishing and exporting the
+//! metrics of a running emulated system.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which never ends.
+const char *LoopProgram =
+    "MOV R0,#0\n"
+    ".Loop\n"
+    "ADD R0,R0,#1\n"
+    "B Loop\n";
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SystemMetrics, CalculatesRates)
+{
+    SystemCounters previous;
+    SystemCounters current;
+    SystemMetrics specimen;
+
+    previous.HostTimeNs = 1000000000;
+    previous.InstructionCount = 1000;
+    previous.CycleCount = 2000;
+    previous.IrqCount = 10;
+    previous.HostIdleTimeNs = 100;
+
+    current.HostTimeNs = 1500000000;
+    current.InstructionCount = 2001000;
+    current.CycleCount = 4002000;
+    current.IrqCount = 60;
+    current.FastIrqCount = 5;
+    current.MmioAccessCount = 500;
+    current.HostIdleTimeNs = 125000100;
+
+    specimen.calculateRates(previous, current);
+
+    EXPECT_EQ(specimen.PeriodNs, 500000000u);
+    EXPECT_EQ(specimen.InstructionCount, 2001000u);
+    EXPECT_DOUBLE_EQ(specimen.MIPS, 4.0);
+    EXPECT_DOUBLE_EQ(specimen.ClockMHz, 8.0);
+    EXPECT_DOUBLE_EQ(specimen.IrqRate, 100.0);
+    EXPECT_DOUBLE_EQ(specimen.FastIrqRate, 10.0);
+    EXPECT_DOUBLE_EQ(specimen.MmioAccessRate, 1000.0);
+    EXPECT_DOUBLE_EQ(specimen.HostUtilisation, 0.75);
+
+    // An empty period shouldn't divide by zero.
+    specimen.calculateRates(current, current);
+    EXPECT_EQ(specimen.PeriodNs, 0u);
+    EXPECT_EQ(specimen.MIPS, 0.0);
+    EXPECT_EQ(specimen.HostUtilisation, 0.0);
+}
+
+GTEST_TEST(SystemMetrics, FormatsText)
+{
+    SystemMetrics specimen;
+    specimen.Sequence = 3;
+    specimen.IsRunning = 1;
+    specimen.MIPS = 12.5;
+    specimen.EventQueueBacklog = 7;
+
+    std::string prometheus;
+    specimen.formatPrometheus(prometheus);
+
+    EXPECT_NE(prometheus.find("# TYPE mightyoak_mips gauge\n"), std::string::npos);
+    EXPECT_NE(prometheus.find("mightyoak_mips 12.5\n"), std::string::npos);
+    EXPECT_NE(prometheus.find("mightyoak_running 1\n"), std::string::npos);
+    EXPECT_NE(prometheus.find("mightyoak_event_queue_backlog 7\n"), std::string::npos);
+
+    std::string json;
+    specimen.formatJson(json);
+
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '\n');
+    EXPECT_EQ(json.find('\n'), json.length() - 1);
+    EXPECT_NE(json.find("\"sequence\":3,"), std::string::npos);
+    EXPECT_NE(json.find("\"running\":true,"), std::string::npos);
+    EXPECT_NE(json.find("\"mips\":12.5,"), std::string::npos);
+}
+
+GTEST_TEST(SystemMetricsPublisher, ReadsConsistentSnapshots)
+{
+    SystemMetricsPublisher specimen;
+    std::atomic_bool isDone(false);
+    uint64_t inconsistentCount = 0;
+
+    EXPECT_EQ(specimen.getPublishedCount(), 0u);
+
+    std::thread reader([&]() {
+        while (isDone.load() == false)
+        {
+            const SystemMetrics metrics = specimen.read();
+
+            if ((metrics.InstructionCount != metrics.Sequence * 2) ||
+                (metrics.LastRestoreTimeNs != metrics.Sequence * 3))
+            {
+                ++inconsistentCount;
+            }
+        }
+    });
+
+    SystemMetrics metrics;
+
+    for (uint64_t i = 0; i < 100000; ++i)
+    {
+        metrics.Sequence = i;
+        metrics.InstructionCount = i * 2;
+        metrics.LastRestoreTimeNs = i * 3;
+        specimen.publish(metrics);
+    }
+
+    isDone.store(true);
+    reader.join();
+
+    EXPECT_EQ(inconsistentCount, 0u);
+    EXPECT_EQ(specimen.getPublishedCount(), 100000u);
+    EXPECT_EQ(specimen.read().Sequence, 99999u);
+}
+
+GTEST_TEST(SystemMetricsPublisher, PublishedByRunningSystem)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, LoopProgram));
+
+    const SystemMetricsPublisher &publisher = specimen.getMetrics();
+    const uint64_t initialCount = publisher.getPublishedCount();
+
+    // Run for long enough for at least one periodic sample.
+    ExecutionMetrics runMetrics = specimen.runFor(250000);
+    ASSERT_EQ(runMetrics.ExecResult, ExecutionMetrics::Result::TimeLimit);
+
+    // One sample at each end of the run and at least two in between.
+    EXPECT_GE(publisher.getPublishedCount(), initialCount + 4);
+
+    SystemMetrics metrics = publisher.read();
+    EXPECT_EQ(metrics.IsRunning, 0u);
+    EXPECT_GE(metrics.InstructionCount, runMetrics.InstructionCount);
+    EXPECT_GT(metrics.CycleCount, 0u);
+    EXPECT_GE(metrics.ScheduledTaskCount, 1u);
+    EXPECT_EQ(metrics.LastCaptureTimeNs, 0u);
+
+    SystemSnapshot snapshot;
+    specimen.captureState(snapshot);
+
+    metrics = publisher.read();
+    EXPECT_GT(metrics.LastCaptureTimeNs, 0u);
+    EXPECT_EQ(metrics.LastRestoreTimeNs, 0u);
+
+    ASSERT_TRUE(specimen.restoreState(snapshot));
+    EXPECT_GT(publisher.read().LastRestoreTimeNs, 0u);
+}
+
+GTEST_TEST(MetricsExporter, WritesJsonLinesToFile)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                       "MoTest_SystemMetrics.jsonl";
+    std::filesystem::remove(path);
+
+    SystemMetricsPublisher publisher;
+    SystemMetrics metrics;
+    metrics.Sequence = 42;
+    metrics.MIPS = 3.5;
+    publisher.publish(metrics);
+
+    MetricsExporter specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryStart(publisher, MetricsTarget::File,
+                                  MetricsFormat::JsonLines, path.string(),
+                                  error, std::chrono::milliseconds(1)));
+    EXPECT_TRUE(specimen.isRunning());
+    EXPECT_FALSE(specimen.tryStart(publisher, MetricsTarget::File,
+                                   MetricsFormat::JsonLines, path.string(),
+                                   error));
+    EXPECT_FALSE(error.empty());
+
+    // Let several intervals pass without a new snapshot being published.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    specimen.stop();
+    EXPECT_FALSE(specimen.isRunning());
+    EXPECT_EQ(specimen.getWriteFailureCount(), 0u);
+
+    std::ifstream input(path);
+    std::string line;
+    size_t lineCount = 0;
+
+    while (std::getline(input, line))
+    {
+        EXPECT_NE(line.find("\"sequence\":42,"), std::string::npos);
+        EXPECT_NE(line.find("\"mips\":3.5,"), std::string::npos);
+        ++lineCount;
+    }
+
+    // Unchanged snapshots aren't repeated.
+    EXPECT_EQ(lineCount, 1u);
+
+    input.close();
+    std::filesystem::remove(path);
+}
+
+GTEST_TEST(MetricsExporter, ReplacesPrometheusFile)
+{
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                       "MoTest_SystemMetrics.prom";
+    std::filesystem::remove(path);
+
+    SystemMetricsPublisher publisher;
+    MetricsExporter specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryStart(publisher, MetricsTarget::File,
+                                  MetricsFormat::Prometheus, path.string(),
+                                  error, std::chrono::milliseconds(1)));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    specimen.stop();
+
+    std::ifstream input(path);
+    std::string text((std::istreambuf_iterator<char>(input)),
+                     std::istreambuf_iterator<char>());
+
+    // The file holds exactly one set of samples.
+    const size_t first = text.find("mightyoak_mips 0\n");
+    EXPECT_NE(first, std::string::npos);
+    EXPECT_EQ(text.find("mightyoak_mips 0\n", first + 1), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+    input.close();
+    std::filesystem::remove(path);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
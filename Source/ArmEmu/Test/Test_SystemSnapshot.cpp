@@ -0,0 +1,166 @@
+//! @file Test_SystemSnapshot.cpp
+//! @brief The definition of unit tests of capturing and restoring the state
+//! of an emulated system and of running ahead using snapshots.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+#include "ArmEmu.hpp"
+
+#include "TestExecTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A program which never ends, incrementing a counter in both a
+//! register and RAM.
+const char *CounterProgram =
+    "MOV R0,#0\n"
+    "MOV R1,#0x9000\n"
+    ".Loop\n"
+    "ADD R0,R0,#1\n"
+    "STR R0,[R1]\n"
+    "B Loop\n";
+
+//! @brief The address the counter program stores its count at.
+constexpr uint32_t CounterAddr = 0x9000;
+
+//! @brief The period of emulated time to run for in each step of a test.
+constexpr uint32_t StepPeriod = 100;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+uint32_t readCounter(IArmSystem *system)
+{
+    uint32_t count = 0;
+
+    readFromLogicalAddress(system, CounterAddr, &count, sizeof(count));
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(SystemSnapshot, RunForStopsAtTimeLimit)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, CounterProgram));
+
+    ExecutionMetrics metrics = specimen.runFor(StepPeriod);
+
+    EXPECT_EQ(metrics.ExecResult, ExecutionMetrics::Result::TimeLimit);
+    EXPECT_GT(metrics.InstructionCount, 0u);
+    EXPECT_GT(specimen.getCoreRegister(CoreRegister::R0), 0u);
+
+    // Ensure the limit doesn't linger to stop the next run early.
+    ExecutionMetrics nextMetrics = specimen.runFor(StepPeriod);
+
+    EXPECT_EQ(nextMetrics.ExecResult, ExecutionMetrics::Result::TimeLimit);
+    EXPECT_GT(nextMetrics.InstructionCount, metrics.InstructionCount / 2);
+}
+
+GTEST_TEST(SystemSnapshot, RestoreRepeatsExecution)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+    SystemSnapshot snapshot;
+
+    ASSERT_TRUE(prepareTestSystem(&specimen, CounterProgram));
+    specimen.runFor(StepPeriod);
+
+    const uint32_t capturedCount = specimen.getCoreRegister(CoreRegister::R0);
+    const uint32_t capturedPC = specimen.getCoreRegister(CoreRegister::PC);
+
+    specimen.captureState(snapshot);
+    EXPECT_FALSE(snapshot.isEmpty());
+
+    ExecutionMetrics firstRun = specimen.runFor(StepPeriod);
+    const uint32_t firstCount = specimen.getCoreRegister(CoreRegister::R0);
+    EXPECT_GT(firstCount, capturedCount);
+    EXPECT_EQ(readCounter(&specimen), firstCount);
+
+    // Roll back and verify the state matches the point of capture.
+    ASSERT_TRUE(specimen.restoreState(snapshot));
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R0), capturedCount);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::PC), capturedPC);
+    EXPECT_EQ(readCounter(&specimen), capturedCount);
+
+    // Running the same period again should produce an identical result.
+    ExecutionMetrics secondRun = specimen.runFor(StepPeriod);
+
+    EXPECT_EQ(secondRun.CycleCount, firstRun.CycleCount);
+    EXPECT_EQ(secondRun.InstructionCount, firstRun.InstructionCount);
+    EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R0), firstCount);
+    EXPECT_EQ(readCounter(&specimen), firstCount);
+}
+
+GTEST_TEST(SystemSnapshot, RejectsSnapshotOfOtherSystem)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> source(opts);
+    ArmSystem<ArmV2TestSystemTraits> target(opts);
+    SystemSnapshot snapshot;
+
+    ASSERT_TRUE(prepareTestSystem(&source, CounterProgram));
+    ASSERT_TRUE(prepareTestSystem(&target, CounterProgram));
+
+    source.captureState(snapshot);
+
+    EXPECT_FALSE(target.restoreState(snapshot));
+}
+
+GTEST_TEST(RunAheadController, MatchesNormalExecution)
+{
+    Options opts;
+    ArmSystem<ArmV2TestSystemTraits> reference(opts);
+    ArmSystem<ArmV2TestSystemTraits> specimen(opts);
+
+    ASSERT_TRUE(prepareTestSystem(&reference, CounterProgram));
+    ASSERT_TRUE(prepareTestSystem(&specimen, CounterProgram));
+
+    RunAheadController controller(&specimen);
+    controller.setFramePeriod(StepPeriod);
+    controller.setFramesAhead(2);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        reference.runFor(StepPeriod);
+
+        ExecutionMetrics metrics = controller.runFrame();
+
+        EXPECT_EQ(metrics.ExecResult, ExecutionMetrics::Result::TimeLimit);
+        EXPECT_EQ(specimen.getCoreRegister(CoreRegister::R0),
+                  reference.getCoreRegister(CoreRegister::R0));
+        EXPECT_EQ(readCounter(&specimen), readCounter(&reference));
+
+        // Output held back while running ahead should be released.
+        EXPECT_EQ(specimen.getHeldOutputs(), HeldOutput::None);
+    }
+
+    const RunAheadMetrics &runAhead = controller.getMetrics();
+
+    EXPECT_EQ(runAhead.FrameCount, 3u);
+    EXPECT_EQ(runAhead.SpeculativeFrameCount, 6u);
+    EXPECT_EQ(runAhead.BudgetOverrunCount, 0u);
+    EXPECT_GT(runAhead.getOverheadTime(), 0);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
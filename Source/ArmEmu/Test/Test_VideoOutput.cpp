@@ -0,0 +1,289 @@
+//! @file Test_VideoOutput.cpp
+//! @brief The definition of unit tests of handing snapshots of the emulated
+//! display to a render thread.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/VideoOutput.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A presenter which records the frames it is given.
+class TestPresenter : public IVideoPresenter
+{
+public:
+    std::mutex Lock;
+    std::condition_variable Presented;
+    std::vector<uint32_t> Pixels;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint64_t LastSequence = 0;
+
+    //! @brief Waits for a frame with a specific sequence number to be
+    //! presented.
+    bool waitForSequence(uint64_t sequence)
+    {
+        std::unique_lock<std::mutex> guard(Lock);
+
+        return Presented.wait_for(guard, std::chrono::seconds(5),
+                                  [&]() { return LastSequence >= sequence; });
+    }
+
+    // Overrides
+    virtual void onFrameRendered(const uint32_t *pixels, uint32_t width,
+                                 uint32_t height, uint64_t sequence) override
+    {
+        {
+            std::lock_guard<std::mutex> guard(Lock);
+            Pixels.assign(pixels, pixels + (static_cast<size_t>(width) * height));
+            Width = width;
+            Height = height;
+            LastSequence = sequence;
+        }
+
+        Presented.notify_all();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Creates the display geometry of a 16 x 2 pixel 4 bpp display area
+//! surrounded by a 4 pixel border.
+VidcTiming createTestTiming()
+{
+    VidcTiming timing;
+    timing.BitsPerPixelPow2 = 2;
+    timing.HorzCycle = 40;
+    timing.HorzBorderStart = 2;
+    timing.HorzDisplayStart = 6;
+    timing.HorzDisplayEnd = 22;
+    timing.HorzBorderEnd = 26;
+    timing.HorzCursorStart = 0;
+    timing.VertCycle = 12;
+    timing.VertBorderStart = 1;
+    timing.VertDisplayStart = 5;
+    timing.VertDisplayEnd = 7;
+    timing.VertBorderEnd = 11;
+
+    return timing;
+}
+
+//! @brief Fills a snapshot with a complete frame of a single colour.
+void fillFrame(VideoFrame &frame, uint8_t pixels, uint64_t sequence)
+{
+    frame.Timing = createTestTiming();
+    frame.Palette.Border = 0x00F;
+    frame.Palette.Colours[3] = 0xF00;
+    frame.Palette.Colours[5] = 0x0F0;
+    frame.Display.assign(frame.Timing.getDisplayBytesPerLine() *
+                             frame.Timing.getDisplayHeight(), pixels);
+    frame.Cursor.clear();
+    frame.DirtyLines.assign(1, 0);
+    frame.IsDisplayEnabled = true;
+    frame.Sequence = sequence;
+
+    for (uint16_t line = 0; line < frame.Timing.getFrameHeight(); ++line)
+    {
+        frame.markLineDirty(line);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(VideoFrame, TracksDirtyLines)
+{
+    VideoFrame specimen;
+    specimen.DirtyLines.assign(2, 0);
+
+    EXPECT_EQ(specimen.getDirtyLineCount(), 0u);
+
+    specimen.markLineDirty(3);
+    specimen.markLineDirty(64);
+    specimen.markLineDirty(200); // Out of range, ignored.
+
+    EXPECT_TRUE(specimen.isLineDirty(3));
+    EXPECT_TRUE(specimen.isLineDirty(64));
+    EXPECT_FALSE(specimen.isLineDirty(4));
+    EXPECT_FALSE(specimen.isLineDirty(200));
+    EXPECT_EQ(specimen.getDirtyLineCount(), 2u);
+}
+
+GTEST_TEST(VideoFrame, RendersOnlyDirtyLines)
+{
+    VideoFrame specimen;
+    fillFrame(specimen, 0x33, 1);
+
+    const uint32_t width = specimen.Timing.getFrameWidth();
+    const uint32_t border = VidcPalette::toHostColour(0x00F);
+    const uint32_t red = VidcPalette::toHostColour(0xF00);
+    std::vector<uint32_t> frame(width * specimen.Timing.getFrameHeight(), 0);
+    FrameConverter converter;
+
+    EXPECT_EQ(specimen.render(converter, frame.data(), width), 10u);
+    EXPECT_EQ(frame[0], border);
+    EXPECT_EQ(frame[(4 * width) + 4], red);
+    EXPECT_EQ(frame[(5 * width) + 19], red);
+
+    // Change the second display line only.
+    std::fill(specimen.Display.begin(), specimen.Display.end(), 0x55);
+    specimen.DirtyLines.assign(1, 0);
+    specimen.markLineDirty(5);
+
+    EXPECT_EQ(specimen.render(converter, frame.data(), width), 1u);
+    EXPECT_EQ(frame[(4 * width) + 4], red);
+    EXPECT_EQ(frame[(5 * width) + 4], VidcPalette::toHostColour(0x0F0));
+}
+
+GTEST_TEST(VideoFrameExchange, HandsOverLatestFrame)
+{
+    VideoFrameExchange specimen;
+
+    EXPECT_FALSE(specimen.isPending());
+    EXPECT_EQ(specimen.tryAcquire(), nullptr);
+
+    specimen.getBackFrame().Sequence = 1;
+    specimen.publish();
+    EXPECT_TRUE(specimen.isPending());
+
+    // The frame replaced is never seen by the consumer.
+    specimen.getBackFrame().Sequence = 2;
+    specimen.publish();
+    EXPECT_EQ(specimen.getPublishedCount(), 2u);
+
+    const VideoFrame *frame = specimen.tryAcquire();
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->Sequence, 2u);
+    EXPECT_FALSE(specimen.isPending());
+    EXPECT_EQ(specimen.tryAcquire(), nullptr);
+
+    // The producer never writes to the frame the consumer holds.
+    EXPECT_NE(&specimen.getBackFrame(), frame);
+    specimen.getBackFrame().Sequence = 3;
+    specimen.publish();
+    EXPECT_NE(&specimen.getBackFrame(), frame);
+    EXPECT_EQ(frame->Sequence, 2u);
+}
+
+GTEST_TEST(VideoFrameExchange, RequestsFullRefresh)
+{
+    VideoFrameExchange specimen;
+
+    EXPECT_FALSE(specimen.tryTakeRefreshRequest());
+
+    specimen.requestFullRefresh();
+    EXPECT_TRUE(specimen.tryTakeRefreshRequest());
+    EXPECT_FALSE(specimen.tryTakeRefreshRequest());
+}
+
+GTEST_TEST(VideoFrameExchange, ConcurrentHandOver)
+{
+    constexpr uint64_t FrameCount = 100000;
+    VideoFrameExchange specimen;
+
+    std::thread producer([&]() {
+        for (uint64_t sequence = 1; sequence <= FrameCount; ++sequence)
+        {
+            VideoFrame &frame = specimen.getBackFrame();
+            frame.Sequence = sequence;
+            frame.DirtyLines.assign(1, sequence);
+            specimen.publish();
+        }
+    });
+
+    uint64_t lastSequence = 0;
+    bool isConsistent = true;
+
+    while (lastSequence < FrameCount)
+    {
+        if (const VideoFrame *frame = specimen.tryAcquire())
+        {
+            // Frames may be skipped, but never arrive out of order or torn.
+            isConsistent &= (frame->Sequence > lastSequence);
+            isConsistent &= (frame->DirtyLines.size() == 1) &&
+                            (frame->DirtyLines.front() == frame->Sequence);
+            lastSequence = frame->Sequence;
+        }
+    }
+
+    producer.join();
+
+    EXPECT_TRUE(isConsistent);
+    EXPECT_EQ(lastSequence, FrameCount);
+    EXPECT_EQ(specimen.getPublishedCount(), FrameCount);
+}
+
+GTEST_TEST(VideoRenderThread, PresentsPublishedFrames)
+{
+    VideoFrameExchange exchange;
+    TestPresenter presenter;
+    VideoRenderThread specimen;
+
+    EXPECT_FALSE(specimen.isRunning());
+    EXPECT_FALSE(specimen.tryStart(exchange, nullptr));
+    ASSERT_TRUE(specimen.tryStart(exchange, &presenter));
+    EXPECT_TRUE(specimen.isRunning());
+    EXPECT_FALSE(specimen.tryStart(exchange, &presenter));
+
+    // The render thread asks for a complete first frame.
+    EXPECT_TRUE(exchange.tryTakeRefreshRequest());
+
+    fillFrame(exchange.getBackFrame(), 0x33, 1);
+    exchange.publish();
+    specimen.notifyFramePending();
+
+    ASSERT_TRUE(presenter.waitForSequence(1));
+
+    {
+        std::lock_guard<std::mutex> guard(presenter.Lock);
+        EXPECT_EQ(presenter.Width, 24u);
+        EXPECT_EQ(presenter.Height, 10u);
+        EXPECT_EQ(presenter.Pixels[(4 * 24) + 4], VidcPalette::toHostColour(0xF00));
+    }
+
+    // A partial update applied to the frame already rendered.
+    VideoFrame &update = exchange.getBackFrame();
+    fillFrame(update, 0x55, 2);
+    update.DirtyLines.assign(1, 0);
+    update.markLineDirty(5);
+    exchange.publish();
+    specimen.notifyFramePending();
+
+    ASSERT_TRUE(presenter.waitForSequence(2));
+
+    {
+        std::lock_guard<std::mutex> guard(presenter.Lock);
+        EXPECT_EQ(presenter.Pixels[(4 * 24) + 4], VidcPalette::toHostColour(0xF00));
+        EXPECT_EQ(presenter.Pixels[(5 * 24) + 4], VidcPalette::toHostColour(0x0F0));
+    }
+
+    specimen.stop();
+    EXPECT_FALSE(specimen.isRunning());
+    EXPECT_EQ(specimen.getRenderedFrameCount(), 2u);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,329 @@
+//! @file Test_WD1772.cpp
+//! @brief The definition of unit tests of floppy disc images and the WD1772
+//! floppy disc controller.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ArmEmu/DiscImage.hpp"
+#include "ArmEmu/GuestEventQueue.hpp"
+#include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/WD1772.hpp"
+
+#include "MemcHardware.hpp"
+#include "HardwareTestTools.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t FdcStatus = WD1772::BaseAddress + 0x00;
+constexpr uint32_t FdcCommand = WD1772::BaseAddress + 0x00;
+constexpr uint32_t FdcSector = WD1772::BaseAddress + 0x08;
+constexpr uint32_t FdcData = WD1772::BaseAddress + 0x0C;
+constexpr uint32_t FirqStatus = 0x3200030;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A test fixture which connects a WD1772 to the IOC of a MEMC-based
+//! system with an 800 KB ADFS disc image in drive 0.
+class WD1772Tests : public ::testing::Test
+{
+protected:
+    std::string _fileName;
+    Options _options;
+    GuestEventQueue _events;
+    AddressMap _readDevices, _writeDevices;
+
+    WD1772Tests() :
+        _fileName(::testing::TempDir() + "MightyOakFloppyTest.adf")
+    {
+        // Label each sector with its track, side and sector number.
+        std::vector<uint8_t> image(819200, 0xE5);
+
+        for (uint8_t track = 0; track < 80; ++track)
+        {
+            for (uint8_t side = 0; side < 2; ++side)
+            {
+                for (uint8_t sector = 0; sector < 5; ++sector)
+                {
+                    uint8_t *data = image.data() + ((((track * 2) + side) * 5) + sector) * 1024;
+                    data[0] = track;
+                    data[1] = side;
+                    data[2] = sector;
+                }
+            }
+        }
+
+        std::ofstream output(_fileName, std::ios::binary);
+        output.write(reinterpret_cast<const char *>(image.data()), image.size());
+    }
+
+    virtual ~WD1772Tests()
+    {
+        std::remove(_fileName.c_str());
+    }
+
+    //! @brief Maps a controller and its drive latch at their Archimedes
+    //! addresses.
+    void mapController(WD1772 &fdc)
+    {
+        ASSERT_TRUE(_readDevices.tryInsert(WD1772::BaseAddress, &fdc));
+        ASSERT_TRUE(_writeDevices.tryInsert(WD1772::BaseAddress, &fdc));
+        ASSERT_TRUE(_writeDevices.tryInsert(FloppyDriveLatch::BaseAddress,
+                                            &fdc.getDriveLatch()));
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Reads the low byte of a register mapped by the hardware.
+uint8_t readByte(MemcHardware &specimen, uint32_t address)
+{
+    uint32_t value = 0;
+
+    EXPECT_TRUE(specimen.read<uint32_t>(address, value));
+
+    return static_cast<uint8_t>(value);
+}
+
+//! @brief Writes a command to the controller, then runs the clock for long
+//! enough to execute it in fast disc mode.
+void issueCommand(MemcHardware &specimen, SystemContext &context, uint8_t command)
+{
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcCommand, command));
+    runUntil(context, context.getMasterClockTicks() + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(DiscGeometry, DeduceFromImageSize)
+{
+    DiscGeometry geometry;
+
+    EXPECT_FALSE(geometry.isValid());
+
+    ASSERT_TRUE(DiscGeometry::tryDeduce(819200, geometry));
+    EXPECT_EQ(geometry.TrackCount, 80);
+    EXPECT_EQ(geometry.SideCount, 2);
+    EXPECT_EQ(geometry.SectorsPerTrack, 5);
+    EXPECT_EQ(geometry.SectorSize, 1024);
+    EXPECT_EQ(geometry.getSectorSizeCode(), 3);
+
+    ASSERT_TRUE(DiscGeometry::tryDeduce(655360, geometry));
+    EXPECT_EQ(geometry.SideCount, 2);
+    EXPECT_EQ(geometry.SectorsPerTrack, 16);
+    EXPECT_EQ(geometry.SectorSize, 256);
+    EXPECT_EQ(geometry.getSectorSizeCode(), 1);
+
+    ASSERT_TRUE(DiscGeometry::tryDeduce(327680, geometry));
+    EXPECT_EQ(geometry.TrackCount, 80);
+    EXPECT_EQ(geometry.SideCount, 1);
+
+    ASSERT_TRUE(DiscGeometry::tryDeduce(163840, geometry));
+    EXPECT_EQ(geometry.TrackCount, 40);
+
+    EXPECT_FALSE(DiscGeometry::tryDeduce(819201, geometry));
+}
+
+TEST_F(WD1772Tests, MapAndWriteBackImage)
+{
+    DiscImage specimen;
+    std::string error;
+
+    ASSERT_TRUE(specimen.tryOpen(_fileName, false, error)) << error;
+    EXPECT_TRUE(specimen.isOpen());
+    EXPECT_FALSE(specimen.isWriteProtected());
+    EXPECT_EQ(specimen.getGeometry().getImageSize(), 819200u);
+
+    // Sides are interleaved.
+    const uint8_t *sector = specimen.getSector(12, 1, 4);
+    ASSERT_NE(sector, nullptr);
+    EXPECT_EQ(sector[0], 12);
+    EXPECT_EQ(sector[1], 1);
+    EXPECT_EQ(sector[2], 4);
+    EXPECT_EQ(specimen.getSector(80, 0, 0), nullptr);
+    EXPECT_EQ(specimen.getSector(0, 0, 5), nullptr);
+
+    // Writing only marks the sector changed.
+    uint8_t *writable = specimen.getWritableSector(12, 1, 4);
+    ASSERT_NE(writable, nullptr);
+    writable[3] = 0xA5;
+    EXPECT_TRUE(specimen.isSectorDirty(12, 1, 4));
+    EXPECT_FALSE(specimen.isSectorDirty(12, 0, 4));
+    EXPECT_EQ(specimen.getDirtySectorCount(), 1u);
+
+    EXPECT_EQ(specimen.flush(), 1u);
+    EXPECT_EQ(specimen.getDirtySectorCount(), 0u);
+    specimen.close();
+    EXPECT_FALSE(specimen.isOpen());
+
+    // The change reached the file.
+    std::ifstream input(_fileName, std::ios::binary);
+    input.seekg((((12 * 2) + 1) * 5 + 4) * 1024 + 3);
+    EXPECT_EQ(input.get(), 0xA5);
+    input.close();
+
+    // Write protected images can't be changed.
+    ASSERT_TRUE(specimen.tryOpen(_fileName, true, error)) << error;
+    EXPECT_EQ(specimen.getWritableSector(12, 1, 4), nullptr);
+    EXPECT_FALSE(specimen.tryOpen(_fileName + ".missing", false, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST_F(WD1772Tests, SeekAndReadSector)
+{
+    _options.setFastDisc(true);
+    SystemContext context(_options, _events, nullptr);
+    WD1772 fdc(_options);
+    std::string error;
+
+    ASSERT_TRUE(fdc.tryInsertDisc(0, _fileName, false, error)) << error;
+    EXPECT_FALSE(fdc.tryInsertDisc(1, _fileName, false, error));
+    mapController(fdc);
+
+    MemcHardware specimen(_options, _readDevices, _writeDevices);
+    specimen.reset();
+    specimen.setPrivilegedMode(true);
+    connectTestDevices(specimen, context);
+
+    // Select drive 0, side 1.
+    EXPECT_TRUE(specimen.write<uint32_t>(FloppyDriveLatch::BaseAddress, 0xEE));
+
+    // Seek to track 3.
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcData, 3));
+    issueCommand(specimen, context, 0x10);
+    EXPECT_EQ(fdc.getHeadTrack(0), 3);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x03, 0x02); // INTRQ
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x15, 0x00);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x03, 0x00);
+
+    // Read sector 2.
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcSector, 2));
+    issueCommand(specimen, context, 0x88);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x03, 0x01); // DRQ
+
+    std::vector<uint8_t> data;
+
+    while ((readByte(specimen, FirqStatus) & 0x01) && (data.size() < 2048))
+    {
+        data.push_back(readByte(specimen, FdcData));
+    }
+
+    ASSERT_EQ(data.size(), 1024u);
+    EXPECT_EQ(data[0], 3);
+    EXPECT_EQ(data[1], 1);
+    EXPECT_EQ(data[2], 2);
+    EXPECT_EQ(data[3], 0xE5);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x03, 0x02);
+    EXPECT_EQ(readByte(specimen, FdcStatus), 0x80); // Motor on only.
+
+    // A sector beyond the end of the track isn't found.
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcSector, 5));
+    issueCommand(specimen, context, 0x88);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x11, 0x10);
+}
+
+TEST_F(WD1772Tests, WriteSectorMarksDirty)
+{
+    _options.setFastDisc(true);
+    SystemContext context(_options, _events, nullptr);
+    WD1772 fdc(_options);
+    std::string error;
+
+    ASSERT_TRUE(fdc.tryInsertDisc(0, _fileName, false, error)) << error;
+    mapController(fdc);
+
+    MemcHardware specimen(_options, _readDevices, _writeDevices);
+    specimen.reset();
+    specimen.setPrivilegedMode(true);
+    connectTestDevices(specimen, context);
+
+    // Select drive 0, side 0 on track 0.
+    EXPECT_TRUE(specimen.write<uint32_t>(FloppyDriveLatch::BaseAddress, 0xFE));
+    issueCommand(specimen, context, 0x00);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x04, 0x04); // Track 00
+
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcSector, 4));
+    issueCommand(specimen, context, 0xA8);
+
+    for (uint32_t i = 0; (i < 1024) && (readByte(specimen, FirqStatus) & 0x01); ++i)
+    {
+        EXPECT_TRUE(specimen.write<uint32_t>(FdcData, 0x5A));
+    }
+
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x7F, 0x00);
+    EXPECT_TRUE(fdc.getDisc(0).isSectorDirty(0, 0, 4));
+    EXPECT_EQ(fdc.getDisc(0).getSector(0, 0, 4)[0], 0x5A);
+    EXPECT_EQ(fdc.getDisc(0).getSector(0, 0, 4)[1023], 0x5A);
+    EXPECT_EQ(fdc.flushDiscs(), 1u);
+
+    // A write protected disc is rejected before searching.
+    ASSERT_TRUE(fdc.tryInsertDisc(0, _fileName, true, error)) << error;
+    issueCommand(specimen, context, 0xA8);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x41, 0x40);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x01, 0x00);
+}
+
+TEST_F(WD1772Tests, StepAtDriveSpeed)
+{
+    SystemContext context(_options, _events, nullptr);
+    WD1772 fdc(_options);
+    std::string error;
+
+    ASSERT_TRUE(fdc.tryInsertDisc(0, _fileName, false, error)) << error;
+    EXPECT_FALSE(fdc.isFastDiscEnabled());
+    mapController(fdc);
+
+    MemcHardware specimen(_options, _readDevices, _writeDevices);
+    specimen.reset();
+    specimen.setPrivilegedMode(true);
+    connectTestDevices(specimen, context);
+    EXPECT_TRUE(specimen.write<uint32_t>(FloppyDriveLatch::BaseAddress, 0xFE));
+
+    // Seek 2 tracks at 6 ms per step without waiting for spin-up.
+    const uint64_t seekTicks = (context.getMasterClockFrequency() * 12000) / 1000000;
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcData, 2));
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcCommand, 0x18));
+
+    runUntil(context, seekTicks - 1);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x01, 0x01); // Busy
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x02, 0x00);
+
+    runUntil(context, seekTicks);
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x02, 0x02);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x01, 0x00);
+    EXPECT_EQ(fdc.getHeadTrack(0), 2);
+
+    // Force interrupt terminates a command in progress.
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcSector, 0));
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcCommand, 0x88));
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x01, 0x01);
+    EXPECT_TRUE(specimen.write<uint32_t>(FdcCommand, 0xD8));
+    EXPECT_EQ(readByte(specimen, FirqStatus) & 0x03, 0x02);
+    EXPECT_EQ(readByte(specimen, FdcStatus) & 0x01, 0x00);
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
@@ -28,7 +28,8 @@ namespace Arm {
 ////////////////////////////////////////////////////////////////////////////////
 //! @brief An example of an implementation of a hardware layer underlying
 //! register files and data transfer.
-class TestBedHardware : public BasicIrqManagerHardware
+class TestBedHardware : public BasicIrqManagerHardware,
+                        public HostServicesHardware
 {
 public:
     // Public Constants
@@ -43,6 +44,9 @@ public:
     static constexpr uint32_t HighRomBase = AddrTop - RomSize;
     static constexpr uint32_t HighRomEnd = AddrTop;
 
+    // The test bed has no memory mapped devices to count accesses to.
+    static constexpr bool CountsMmio = false;
+
 private:
     // Internal Fields
     HostBuffer _rom;
@@ -100,6 +104,22 @@ public:
         // Nothing to do?
     }
 
+    // Based on GenericHardware::captureState().
+    void captureState(SystemSnapshot &snapshot) const
+    {
+        BasicIrqManagerHardware::captureState(snapshot);
+
+        // NOTE: ROM cannot be written by the guest, so it isn't captured.
+        snapshot.write(_ram.data(), _ram.size());
+    }
+
+    // Based on GenericHardware::restoreState().
+    void restoreState(SnapshotReader &reader)
+    {
+        BasicIrqManagerHardware::restoreState(reader);
+        reader.read(_ram.data(), _ram.size());
+    }
+
     template<typename T>
     bool write(uint32_t logicalAddr, T value)
     {
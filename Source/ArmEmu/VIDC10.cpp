@@ -2,7 +2,7 @@
 //! @brief The definition of an object which emulates the function of the
 //! VL86C310 VIDC part.
 //! @author GiantRobotLemur@na-se.co.uk
-//! @date 2023
+//! @date 2023-2024
 //! @copyright This file is part of the Mighty Oak project which is released
 //! under LGPL 3 license. See LICENSE file at the repository root or go to
 //! https://github.com/GiantRobotLemur/MightyOak for full license details.
@@ -11,19 +11,408 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Header File Includes
 ////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "Ag/Core/Binary.hpp"
+
 #include "ArmEmu/VIDC10.hpp"
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/EmuOptions.hpp"
+#include "ArmEmu/HostMessageID.hpp"
 #include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+
+#include "MemcHardware.hpp"
 
 namespace Mo {
 namespace Arm {
 
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the display timing registers by their offset from
+//! VidcRegister::TimingBase.
+struct TimingRegister
+{
+    static constexpr uint8_t HorzCycle = 0;
+    static constexpr uint8_t HorzSyncWidth = 1;
+    static constexpr uint8_t HorzBorderStart = 2;
+    static constexpr uint8_t HorzDisplayStart = 3;
+    static constexpr uint8_t HorzDisplayEnd = 4;
+    static constexpr uint8_t HorzBorderEnd = 5;
+    static constexpr uint8_t HorzCursorStart = 6;
+    static constexpr uint8_t HorzInterlace = 7;
+    static constexpr uint8_t VertCycle = 8;
+    static constexpr uint8_t VertSyncWidth = 9;
+    static constexpr uint8_t VertBorderStart = 10;
+    static constexpr uint8_t VertDisplayStart = 11;
+    static constexpr uint8_t VertDisplayEnd = 12;
+    static constexpr uint8_t VertBorderEnd = 13;
+    static constexpr uint8_t VertCursorStart = 14;
+    static constexpr uint8_t VertCursorEnd = 15;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The physical colour bits replaced by pixel bits 4-7 in 8 bpp modes.
+constexpr uint16_t Colour256Mask = 0x08C8;
+
+//! @brief The pixel offsets added to the horizontal display start and end
+//! registers, indexed by bits per pixel as a power of 2.
+//! @note See VL86C310 data sheet, the offsets account for the pipeline delay
+//! in the pixel serialiser.
+constexpr uint16_t HorzDisplayOffsets[] = { 19, 11, 7, 5 };
+
+//! @brief The pixel clock frequencies selected by bits 0-1 of the control
+//! register, assuming the standard 24 MHz crystal.
+constexpr uint32_t PixelClockFrequencies[] = {
+    8000000, 12000000, 16000000, 24000000
+};
+
+//! @brief The count of bytes MEMC fetches in each video or cursor DMA
+//! request.
+constexpr uint32_t DmaBytesPerRequest = 16;
+
+//! @brief The count of processor cycles the memory bus is unavailable for
+//! during each DMA request, one non-sequential and three sequential cycles.
+constexpr uint32_t DmaCyclesPerRequest = 5;
+
+//! @brief The frame rate assumed while the timing registers are invalid.
+constexpr uint64_t NominalFrameRate = 50;
+
+//! @brief The frequency of the clock which times the sound DAC, 1 MHz
+//! derived from the 24 MHz crystal.
+constexpr uint64_t SoundClockFrequency = 1000000;
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// VidcPalette Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs a palette with all colours set to black.
+VidcPalette::VidcPalette() :
+    Border(0)
+{
+    std::fill_n(Colours, ColourCount, static_cast<uint16_t>(0));
+    std::fill_n(Cursor, CursorColourCount, static_cast<uint16_t>(0));
+}
+
+//! @brief Determines whether two palettes define the same colours.
+bool VidcPalette::operator==(const VidcPalette &rhs) const
+{
+    return std::equal(Colours, Colours + ColourCount, rhs.Colours) &&
+           (Border == rhs.Border) &&
+           std::equal(Cursor, Cursor + CursorColourCount, rhs.Cursor);
+}
+
+//! @brief Determines whether two palettes define different colours.
+bool VidcPalette::operator!=(const VidcPalette &rhs) const
+{
+    return (*this == rhs) == false;
+}
+
+//! @brief Gets the physical colour displayed for a pixel in an 8 bpp mode.
+//! @param[in] pixel The pixel value. Bits 0-3 select a logical colour, bits 4-7
+//! directly drive red bit 3, green bits 2 and 3 and blue bit 3 respectively.
+//! @return The 13-bit physical colour to display.
+uint16_t VidcPalette::getColour256(uint8_t pixel) const
+{
+    uint16_t colour = Colours[pixel & 0x0F] & ~Colour256Mask;
+
+    colour |= Ag::Bin::extractAndShiftBits<uint16_t, 4, 3, 1>(pixel);
+    colour |= Ag::Bin::extractAndShiftBits<uint16_t, 5, 6, 2>(pixel);
+    colour |= Ag::Bin::extractAndShiftBits<uint16_t, 7, 11, 1>(pixel);
+
+    return colour;
+}
+
+//! @brief Converts a VIDC physical colour to a 32-bit host colour.
+//! @param[in] physicalColour The 13-bit colour programmed into the VIDC.
+//! @return The colour as 8-bit red, green, blue and alpha components in
+//! ascending order of significance, i.e. RGBA bytes in little-endian memory.
+//! Alpha is always opaque.
+uint32_t VidcPalette::toHostColour(uint16_t physicalColour)
+{
+    // Scale each 4-bit component to 8-bits so that 0xF becomes 0xFF.
+    uint32_t red = (physicalColour & 0x0F) * 0x11;
+    uint32_t green = ((physicalColour >> 4) & 0x0F) * 0x11;
+    uint32_t blue = ((physicalColour >> 8) & 0x0F) * 0x11;
+
+    return red | (green << 8) | (blue << 16) | 0xFF000000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VidcTiming Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty, invalid, display geometry.
+VidcTiming::VidcTiming() :
+    HorzCycle(0),
+    HorzBorderStart(0),
+    HorzDisplayStart(0),
+    HorzDisplayEnd(0),
+    HorzBorderEnd(0),
+    HorzCursorStart(0),
+    VertCycle(0),
+    VertBorderStart(0),
+    VertDisplayStart(0),
+    VertDisplayEnd(0),
+    VertBorderEnd(0),
+    VertCursorStart(0),
+    VertCursorEnd(0),
+    BitsPerPixelPow2(0),
+    PixelRate(0)
+{
+}
+
+//! @brief Determines whether the timing describes a display area within a
+//! border within a raster which can be rendered.
+bool VidcTiming::isValid() const
+{
+    return (HorzBorderStart <= HorzDisplayStart) &&
+           (HorzDisplayStart < HorzDisplayEnd) &&
+           (HorzDisplayEnd <= HorzBorderEnd) &&
+           (HorzBorderEnd <= HorzCycle) &&
+           (VertBorderStart <= VertDisplayStart) &&
+           (VertDisplayStart < VertDisplayEnd) &&
+           (VertDisplayEnd <= VertBorderEnd) &&
+           (VertBorderEnd <= VertCycle) &&
+           (((getDisplayWidth() << BitsPerPixelPow2) & 7) == 0);
+}
+
+//! @brief Determines whether two sets of timings produce the same frame
+//! geometry, ignoring the position of the cursor.
+//! @param[in] rhs The timings to compare against.
+//! @retval true Frames have the same size, layout and pixel format.
+//! @retval false Frames rendered using one set of timings cannot be reused
+//! by the other.
+bool VidcTiming::isSameDisplay(const VidcTiming &rhs) const
+{
+    return (HorzCycle == rhs.HorzCycle) &&
+           (HorzBorderStart == rhs.HorzBorderStart) &&
+           (HorzDisplayStart == rhs.HorzDisplayStart) &&
+           (HorzDisplayEnd == rhs.HorzDisplayEnd) &&
+           (HorzBorderEnd == rhs.HorzBorderEnd) &&
+           (VertCycle == rhs.VertCycle) &&
+           (VertBorderStart == rhs.VertBorderStart) &&
+           (VertDisplayStart == rhs.VertDisplayStart) &&
+           (VertDisplayEnd == rhs.VertDisplayEnd) &&
+           (VertBorderEnd == rhs.VertBorderEnd) &&
+           (BitsPerPixelPow2 == rhs.BitsPerPixelPow2) &&
+           (PixelRate == rhs.PixelRate);
+}
+
+//! @brief Gets the width of the display area and border in pixels.
+uint16_t VidcTiming::getFrameWidth() const
+{
+    return HorzBorderEnd - HorzBorderStart;
+}
+
+//! @brief Gets the height of the display area and border in raster lines.
+uint16_t VidcTiming::getFrameHeight() const
+{
+    return VertBorderEnd - VertBorderStart;
+}
+
+//! @brief Gets the width of the display area in pixels.
+uint16_t VidcTiming::getDisplayWidth() const
+{
+    return HorzDisplayEnd - HorzDisplayStart;
+}
+
+//! @brief Gets the height of the display area in raster lines.
+uint16_t VidcTiming::getDisplayHeight() const
+{
+    return VertDisplayEnd - VertDisplayStart;
+}
+
+//! @brief Gets the count of bytes of video memory read to display each
+//! raster line of the display area.
+uint32_t VidcTiming::getDisplayBytesPerLine() const
+{
+    return (static_cast<uint32_t>(getDisplayWidth()) << BitsPerPixelPow2) / 8;
+}
+
+//! @brief Gets the frequency at which pixels are displayed.
+uint32_t VidcTiming::getPixelClockHz() const
+{
+    return PixelClockFrequencies[PixelRate & 3];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // VIDC10 Member Definitions
 ////////////////////////////////////////////////////////////////////////////////
-VIDC10::VIDC10(MemcHardware &parent) :
+//! @brief Constructs an emulation of the VIDC.
+//! @param[in] parent The memory controller which performs DMA for the VIDC.
+//! @param[in] options The configuration of the emulated system.
+VIDC10::VIDC10(MemcHardware &parent, const Options &options) :
     _parent(parent),
-    _context(nullptr)
+    _context(nullptr),
+    _frameStartTicks(0),
+    _frameTicks(1),
+    _frameCount(0),
+    _stolenCycleCount(0),
+    _soundSampleCount(0),
+    _displayDmaCycles(0),
+    _frameDmaCycles(0),
+    _soundFrequency(0),
+    _control(0),
+    _rasterLine(0),
+    _isScanlineTimingEnabled(options.isScanlineTimingEnabled())
+{
+    std::fill_n(_timing, TimingRegisterCount, static_cast<uint16_t>(0));
+    std::fill_n(_stereoPositions, StereoRegisterCount, static_cast<uint8_t>(0));
+
+    Ag::zeroFill(_rasterTask);
+    _rasterTask.Task = VIDC10::onRasterDue;
+    _rasterTask.Context = reinterpret_cast<uintptr_t>(this);
+
+    Ag::zeroFill(_soundTask);
+    _soundTask.Task = VIDC10::onSoundDue;
+    _soundTask.Context = reinterpret_cast<uintptr_t>(this);
+}
+
+//! @brief Gets the colours last programmed into the palette registers.
+const VidcPalette &VIDC10::getPalette() const
+{
+    return _palette;
+}
+
+//! @brief Decodes the display geometry from the timing and control registers.
+//! @note The offsets applied to each register are described in the
+//! VL86C310 data sheet.
+VidcTiming VIDC10::getTiming() const
+{
+    VidcTiming timing;
+    timing.BitsPerPixelPow2 = Ag::Bin::extractBits<uint8_t, 2, 2>(_control);
+    timing.PixelRate = Ag::Bin::extractBits<uint8_t, 0, 2>(_control);
+
+    const uint16_t displayOffset = HorzDisplayOffsets[timing.BitsPerPixelPow2];
+
+    timing.HorzCycle = (_timing[TimingRegister::HorzCycle] * 2) + 2;
+    timing.HorzBorderStart = (_timing[TimingRegister::HorzBorderStart] * 2) + 1;
+    timing.HorzDisplayStart = (_timing[TimingRegister::HorzDisplayStart] * 2) + displayOffset;
+    timing.HorzDisplayEnd = (_timing[TimingRegister::HorzDisplayEnd] * 2) + displayOffset;
+    timing.HorzBorderEnd = (_timing[TimingRegister::HorzBorderEnd] * 2) + 1;
+    timing.HorzCursorStart = _timing[TimingRegister::HorzCursorStart] + 6;
+
+    timing.VertCycle = _timing[TimingRegister::VertCycle] + 1;
+    timing.VertBorderStart = _timing[TimingRegister::VertBorderStart] + 1;
+    timing.VertDisplayStart = _timing[TimingRegister::VertDisplayStart] + 1;
+    timing.VertDisplayEnd = _timing[TimingRegister::VertDisplayEnd] + 1;
+    timing.VertBorderEnd = _timing[TimingRegister::VertBorderEnd] + 1;
+    timing.VertCursorStart = _timing[TimingRegister::VertCursorStart] + 1;
+    timing.VertCursorEnd = _timing[TimingRegister::VertCursorEnd] + 1;
+
+    return timing;
+}
+
+//! @brief Gets the count of vertical flyback periods which have started.
+uint64_t VIDC10::getFrameCount() const
+{
+    return _frameCount;
+}
+
+//! @brief Gets the total count of processor cycles taken by video, cursor
+//! and sound DMA.
+uint64_t VIDC10::getStolenCycleCount() const
+{
+    return _stolenCycleCount;
+}
+
+//! @brief Gets the total count of 8-bit samples fetched by sound DMA.
+uint64_t VIDC10::getSoundSampleCount() const
+{
+    return _soundSampleCount;
+}
+
+//! @brief Gets the rate at which the DAC plays bytes of sound data, in Hz.
+//! @note Each byte is played on the next of the 8 channel slots, so the
+//! rate at which each channel is sampled is an eighth of this.
+uint32_t VIDC10::getSoundSampleRate() const
+{
+    return static_cast<uint32_t>(SoundClockFrequency /
+                                 ((_soundFrequency & 0xFF) + 2));
+}
+
+//! @brief Gets the raw value last written to a display timing register.
+//! @param[in] index The index of the register relative to
+//! VidcRegister::TimingBase.
+uint16_t VIDC10::getTimingRegister(uint8_t index) const
 {
+    return (index < TimingRegisterCount) ? _timing[index] : 0;
+}
+
+//! @brief Gets the stereo image position of a sound channel.
+//! @param[in] channel The index of the channel, 0 to 7.
+uint8_t VIDC10::getStereoPosition(uint8_t channel) const
+{
+    return (channel < StereoRegisterCount) ? _stereoPositions[channel] : 0;
+}
+
+//! @brief Gets the value last written to the sound frequency register.
+uint16_t VIDC10::getSoundFrequency() const
+{
+    return _soundFrequency;
+}
+
+//! @brief Gets the value last written to the control register.
+uint16_t VIDC10::getControlRegister() const
+{
+    return _control;
+}
+
+//! @brief Writes a VIDC register.
+//! @param[in] value The word written, the register is identified by bits
+//! 26-31, bits 24-25 should always be zero.
+void VIDC10::writeRegister(uint32_t value)
+{
+    uint8_t registerId = Ag::Bin::extractBits<uint8_t, 26, 6>(value);
+
+    if (registerId < VidcRegister::Border)
+    {
+        _palette.Colours[registerId] = Ag::Bin::extractBits<uint16_t, 0, 13>(value);
+    }
+    else if (registerId == VidcRegister::Border)
+    {
+        _palette.Border = Ag::Bin::extractBits<uint16_t, 0, 13>(value);
+    }
+    else if (registerId < VidcRegister::CursorBase + VidcPalette::CursorColourCount)
+    {
+        _palette.Cursor[registerId - VidcRegister::CursorBase] =
+            Ag::Bin::extractBits<uint16_t, 0, 13>(value);
+    }
+    else if (registerId < VidcRegister::StereoBase)
+    {
+        // Reserved.
+    }
+    else if (registerId < VidcRegister::TimingBase)
+    {
+        _stereoPositions[registerId - VidcRegister::StereoBase] =
+            Ag::Bin::extractBits<uint8_t, 0, 3>(value);
+    }
+    else if (registerId < VidcRegister::SoundFrequency)
+    {
+        uint8_t index = registerId - VidcRegister::TimingBase;
+
+        // The horizontal cursor start register has an extra bit of
+        // precision, all others are 10 bits.
+        _timing[index] = (index == TimingRegister::HorzCursorStart) ?
+            Ag::Bin::extractBits<uint16_t, 13, 11>(value) :
+            Ag::Bin::extractBits<uint16_t, 14, 10>(value);
+    }
+    else if (registerId == VidcRegister::SoundFrequency)
+    {
+        // Theoretically 9 bits, but bit 8 is for testing only.
+        _soundFrequency = Ag::Bin::extractBits<uint16_t, 0, 9>(value);
+    }
+    else if (registerId == VidcRegister::Control)
+    {
+        // Theoretically 16 bits, but only the least significant
+        // 8 bits are useful outside of testing.
+        _control = static_cast<uint16_t>(value);
+    }
 }
 
 // Inherited from IAddressRegion.
@@ -62,9 +451,11 @@ uint32_t VIDC10::read(uint32_t /*offset*/)
 }
 
 // Inherited from IMMIOBlock.
-void VIDC10::write(uint32_t /*offset*/, uint32_t /*value*/)
+void VIDC10::write(uint32_t /*offset*/, uint32_t value)
 {
-    // TODO: Implement MMIO registers.
+    // NOTE: MemcHardware decodes writes to the VIDC address space itself and
+    // calls writeRegister(), but the address isn't significant either way.
+    writeRegister(value);
 }
 
 // Inherited from IMMIOBlock.
@@ -72,8 +463,265 @@ void VIDC10::connect(const ConnectionContext &context)
 {
     // Connect to the rest of the emulated system.
     _context = context.getInteropContext();
+
+    if (_parent.getVideoFrames() != nullptr)
+    {
+        // The display is published at each vertical flyback. The host only
+        // needs to know about the latest frame.
+        _context->tryCoalesceMessages(HostMessageID::VideoFrameReady);
+    }
+
+    if (_parent.getSoundSamples() != nullptr)
+    {
+        // The host drains all samples available whenever it is notified.
+        _context->tryCoalesceMessages(HostMessageID::SoundSamplesReady);
+    }
+
+    // Start following the raster.
+    beginFrame(_context->getMasterClockTicks());
+    _context->scheduleTask(&_rasterTask);
+
+    // Start playing sound.
+    _soundTask.At = _context->getMasterClockTicks() + getSoundBlockTicks();
+    _context->scheduleTask(&_soundTask);
+}
+
+// Inherited from IHardwareDevice.
+void VIDC10::captureState(SystemSnapshot &snapshot) const
+{
+    snapshot.write(_palette.Colours, sizeof(_palette.Colours));
+    snapshot.writeValue(_palette.Border);
+    snapshot.write(_palette.Cursor, sizeof(_palette.Cursor));
+    snapshot.write(_timing, sizeof(_timing));
+    snapshot.write(_stereoPositions, sizeof(_stereoPositions));
+    snapshot.writeValue(_soundFrequency);
+    snapshot.writeValue(_control);
+    snapshot.writeValue(_frameStartTicks);
+    snapshot.writeValue(_rasterLine);
+}
+
+// Inherited from IHardwareDevice.
+void VIDC10::restoreState(SnapshotReader &reader)
+{
+    reader.read(_palette.Colours, sizeof(_palette.Colours));
+    reader.readValue(_palette.Border);
+    reader.read(_palette.Cursor, sizeof(_palette.Cursor));
+    reader.read(_timing, sizeof(_timing));
+    reader.read(_stereoPositions, sizeof(_stereoPositions));
+    reader.readValue(_soundFrequency);
+    reader.readValue(_control);
+
+    uint64_t frameStartTicks = 0;
+    uint16_t rasterLine = 0;
+    reader.readValue(frameStartTicks);
+    reader.readValue(rasterLine);
+
+    if (_context != nullptr)
+    {
+        // Resume the raster where it was, the task was restored with the
+        // rest of the schedule and must keep its place in it.
+        const uint64_t dueTicks = _rasterTask.At;
+
+        beginFrame(frameStartTicks);
+        _rasterLine = rasterLine;
+        _rasterTask.At = dueTicks;
+    }
+}
+
+//! @brief Latches the display timing for a new frame and schedules the
+//! first raster event within it.
+//! @param[in] startTicks The master clock time at which the frame starts.
+//! @note Changes to the timing registers take effect from the next frame.
+void VIDC10::beginFrame(uint64_t startTicks)
+{
+    const uint64_t clockFrequency = _context->getMasterClockFrequency();
+
+    _frameTiming = getTiming();
+    _frameStartTicks = startTicks;
+    _rasterLine = 0;
+    _displayDmaCycles = 0;
+    _frameDmaCycles = 0;
+
+    if (_frameTiming.isValid())
+    {
+        _frameTicks = getLineStartTicks(_frameTiming.VertCycle);
+
+        // Each display line is fetched 16 bytes at a time.
+        const uint32_t displayRequests = (_frameTiming.getDisplayBytesPerLine() +
+                                          DmaBytesPerRequest - 1) / DmaBytesPerRequest;
+        _displayDmaCycles = displayRequests * DmaCyclesPerRequest;
+
+        for (uint16_t line = 0; line < _frameTiming.VertCycle; ++line)
+        {
+            _frameDmaCycles += getLineDmaCycles(line);
+        }
+    }
+    else
+    {
+        _frameTicks = clockFrequency / NominalFrameRate;
+    }
+
+    _frameTicks = std::max<uint64_t>(_frameTicks, 1);
+
+    if (_isScanlineTimingEnabled && _frameTiming.isValid())
+    {
+        _rasterTask.At = _frameStartTicks;
+    }
+    else
+    {
+        // Only vertical flyback is signalled, at the end of the frame.
+        _rasterTask.At = _frameStartTicks + _frameTicks;
+    }
+}
+
+//! @brief Calculates the time a raster line starts relative to the start of
+//! the frame latched by beginFrame().
+//! @param[in] line The 0-based raster line, VertCycle for the end of the
+//! frame.
+uint64_t VIDC10::getLineStartTicks(uint16_t line) const
+{
+    // Avoid accumulating rounding errors by calculating from the frame start.
+    return (_context->getMasterClockFrequency() * _frameTiming.HorzCycle * line) /
+           _frameTiming.getPixelClockHz();
+}
+
+//! @brief Calculates the count of processor cycles taken by DMA during a
+//! raster line of the frame latched by beginFrame().
+//! @param[in] line The 0-based raster line.
+uint32_t VIDC10::getLineDmaCycles(uint16_t line) const
+{
+    uint32_t cycles = 0;
+
+    if (_parent.isVideoDmaEnabled())
+    {
+        if ((line >= _frameTiming.VertDisplayStart) && (line < _frameTiming.VertDisplayEnd))
+        {
+            cycles += _displayDmaCycles;
+        }
+
+        if ((line >= _frameTiming.VertCursorStart) && (line < _frameTiming.VertCursorEnd))
+        {
+            // The cursor data for a line is less than a single request.
+            cycles += DmaCyclesPerRequest;
+        }
+    }
+
+    return cycles;
+}
+
+//! @brief Signals the start of vertical flyback to the IOC and publishes the
+//! frame just displayed to the host, unless video output is held, see
+//! HeldOutput::Video.
+//! @param[in] guestContext The context which scheduled the task.
+void VIDC10::onVerticalFlyback(SystemContext &guestContext)
+{
+    uint64_t sequence = 0;
+    uint32_t dirtyLineCount = 0;
+
+    ++_frameCount;
+    _parent.getIOController().raiseVerticalFlyback();
+
+    if ((guestContext.isOutputHeld(HeldOutput::Video) == false) &&
+        _parent.publishFrame(sequence, dirtyLineCount))
+    {
+        guestContext.postMessageToHost(HostMessageID::VideoFrameReady,
+                                       static_cast<uintptr_t>(sequence),
+                                       dirtyLineCount);
+    }
+}
+
+//! @brief A recurring task which follows the raster, either at the start of
+//! each line or at the end of each frame.
+//! @param[in] guestContext The context which scheduled the task.
+//! @param[in] taskContext A pointer to the VIDC10 instance.
+void VIDC10::onRasterDue(SystemContext &guestContext, uintptr_t taskContext)
+{
+    VIDC10 *vidc = reinterpret_cast<VIDC10 *>(taskContext);
+    uint32_t stolenCycles = 0;
+
+    if (vidc->_isScanlineTimingEnabled && vidc->_frameTiming.isValid())
+    {
+        const uint16_t line = vidc->_rasterLine++;
+
+        stolenCycles = vidc->getLineDmaCycles(line);
+
+        // Flyback starts at the end of the display, or the last line if the
+        // display fills the frame.
+        if (line == std::min<uint16_t>(vidc->_frameTiming.VertDisplayEnd,
+                                       vidc->_frameTiming.VertCycle - 1))
+        {
+            vidc->onVerticalFlyback(guestContext);
+        }
+
+        if (vidc->_rasterLine < vidc->_frameTiming.VertCycle)
+        {
+            vidc->_rasterTask.At = vidc->_frameStartTicks +
+                                   vidc->getLineStartTicks(vidc->_rasterLine);
+        }
+        else
+        {
+            vidc->beginFrame(vidc->_frameStartTicks + vidc->_frameTicks);
+        }
+    }
+    else
+    {
+        // Account for the whole frame at once.
+        stolenCycles = vidc->_frameDmaCycles;
+        vidc->onVerticalFlyback(guestContext);
+        vidc->beginFrame(vidc->_frameStartTicks + vidc->_frameTicks);
+    }
+
+    if (stolenCycles > 0)
+    {
+        vidc->_stolenCycleCount += stolenCycles;
+        guestContext.stealCPUCycles(stolenCycles);
+    }
+
+    guestContext.scheduleTask(&vidc->_rasterTask);
+}
+
+//! @brief Calculates the time taken for the DAC to play a block of samples
+//! fetched by a single sound DMA request.
+uint64_t VIDC10::getSoundBlockTicks() const
+{
+    const uint64_t ticks = (_context->getMasterClockFrequency() *
+                            MemcHardware::SoundDmaBlockSize *
+                            ((_soundFrequency & 0xFF) + 2)) / SoundClockFrequency;
+
+    return std::max<uint64_t>(ticks, 1);
+}
+
+//! @brief A recurring task which requests sound DMA each time the DAC has
+//! played a block of samples.
+//! @param[in] guestContext The context which scheduled the task.
+//! @param[in] taskContext A pointer to the VIDC10 instance.
+void VIDC10::onSoundDue(SystemContext &guestContext, uintptr_t taskContext)
+{
+    VIDC10 *vidc = reinterpret_cast<VIDC10 *>(taskContext);
+    uint8_t samples[MemcHardware::SoundDmaBlockSize];
+    bool isQueued = false;
+
+    if (vidc->_parent.performSoundDma(guestContext, samples, isQueued))
+    {
+        vidc->_soundSampleCount += MemcHardware::SoundDmaBlockSize;
+        vidc->_stolenCycleCount += DmaCyclesPerRequest;
+        guestContext.stealCPUCycles(DmaCyclesPerRequest);
+
+        if (isQueued)
+        {
+            const SoundSampleRing *ring = vidc->_parent.getSoundSamples();
+
+            guestContext.postMessageToHost(HostMessageID::SoundSamplesReady,
+                                           ring->getAvailable(),
+                                           ring->getSampleRate());
+        }
+    }
+
+    // The period is re-evaluated each block so that changes to the sound
+    // frequency register take effect promptly.
+    vidc->_soundTask.At += vidc->getSoundBlockTicks();
+    guestContext.scheduleTask(&vidc->_soundTask);
 }
 
 }} // namespace Mo::Arm
 ////////////////////////////////////////////////////////////////////////////////
-
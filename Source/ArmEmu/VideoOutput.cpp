@@ -0,0 +1,350 @@
+//! @file ArmEmu/VideoOutput.cpp
+//! @brief The definition of objects which hand snapshots of the emulated
+//! display from the emulation thread to a render thread.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+
+#include "ArmEmu/VideoOutput.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// VideoFrame Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an empty snapshot which describes no valid frame.
+VideoFrame::VideoFrame() :
+    Sequence(0),
+    IsDisplayEnabled(false)
+{
+}
+
+//! @brief Determines whether a line of the frame has changed.
+//! @param[in] index The index of the line relative to VertBorderStart.
+bool VideoFrame::isLineDirty(uint16_t index) const
+{
+    const size_t word = index / 64;
+
+    return (word < DirtyLines.size()) &&
+           (((DirtyLines[word] >> (index % 64)) & 1) != 0);
+}
+
+//! @brief Gets the count of lines of the frame which have changed.
+uint32_t VideoFrame::getDirtyLineCount() const
+{
+    uint32_t count = 0;
+
+    for (uint64_t word : DirtyLines)
+    {
+        for (; word != 0; word &= word - 1)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+//! @brief Marks a line of the frame as changed.
+//! @param[in] index The index of the line relative to VertBorderStart.
+void VideoFrame::markLineDirty(uint16_t index)
+{
+    const size_t word = index / 64;
+
+    if (word < DirtyLines.size())
+    {
+        DirtyLines[word] |= static_cast<uint64_t>(1) << (index % 64);
+    }
+}
+
+//! @brief Renders the dirty lines of the frame into host pixels.
+//! @param[in] converter The object to convert pixels with, its palette is
+//! updated from the snapshot.
+//! @param[in,out] target The host pixels of the frame previously rendered,
+//! VidcTiming::getFrameHeight() lines of VidcTiming::getFrameWidth() pixels.
+//! @param[in] stride The count of host pixels between the start of each line
+//! in target.
+//! @return The count of lines rendered.
+uint32_t VideoFrame::render(FrameConverter &converter, uint32_t *target,
+                            size_t stride) const
+{
+    const uint32_t bytesPerLine = Timing.getDisplayBytesPerLine();
+    uint32_t renderedCount = 0;
+
+    converter.setPalette(Palette);
+
+    for (uint16_t line = Timing.VertBorderStart; line < Timing.VertBorderEnd;
+         ++line, target += stride)
+    {
+        if (isLineDirty(line - Timing.VertBorderStart))
+        {
+            const uint8_t *source = nullptr;
+            const uint8_t *cursor = nullptr;
+
+            if (IsDisplayEnabled)
+            {
+                if ((line >= Timing.VertDisplayStart) && (line < Timing.VertDisplayEnd))
+                {
+                    source = Display.data() + ((line - Timing.VertDisplayStart) * bytesPerLine);
+                }
+
+                if ((line >= Timing.VertCursorStart) && (line < Timing.VertCursorEnd) &&
+                    (Cursor.empty() == false))
+                {
+                    cursor = Cursor.data() +
+                             ((line - Timing.VertCursorStart) * VidcTiming::CursorBytesPerLine);
+                }
+            }
+
+            converter.renderLine(Timing, source, cursor, target);
+            ++renderedCount;
+        }
+    }
+
+    return renderedCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VideoFrameExchange Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an exchange with no frame pending.
+VideoFrameExchange::VideoFrameExchange() :
+    _publishedCount(0),
+    _middle(1),
+    _isRefreshRequested(false),
+    _back(0),
+    _front(2)
+{
+}
+
+//! @brief Gets the count of frames published since construction.
+//! @note This member function can be called from any thread.
+uint64_t VideoFrameExchange::getPublishedCount() const
+{
+    return _publishedCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Determines whether a published frame has yet to be acquired by
+//! the consumer.
+//! @note When called by the producer, a result of false is definitive, a
+//! result of true may be out of date by the time it is acted upon.
+bool VideoFrameExchange::isPending() const
+{
+    return (_middle.load(std::memory_order_acquire) & PendingFlag) != 0;
+}
+
+//! @brief Gets the frame the producer should update before calling
+//! publish().
+//! @note This member function should only be called from the producer thread.
+VideoFrame &VideoFrameExchange::getBackFrame()
+{
+    return _frames[_back];
+}
+
+//! @brief Makes the back frame available to the consumer, replacing any
+//! frame it has yet to acquire.
+//! @note This member function should only be called from the producer thread.
+void VideoFrameExchange::publish()
+{
+    const uint8_t previous = _middle.exchange(_back | PendingFlag,
+                                              std::memory_order_acq_rel);
+
+    _back = previous & IndexMask;
+    _publishedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+//! @brief Attempts to take ownership of the most recently published frame.
+//! @return The frame, which remains valid until the next successful call,
+//! or nullptr if nothing has been published since the last call.
+//! @note This member function should only be called from the consumer thread.
+const VideoFrame *VideoFrameExchange::tryAcquire()
+{
+    const VideoFrame *frame = nullptr;
+
+    if (isPending())
+    {
+        const uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+
+        _front = previous & IndexMask;
+        frame = &_frames[_front];
+    }
+
+    return frame;
+}
+
+//! @brief Asks the producer to mark every line of the next frame as dirty,
+//! for example because the consumer has lost the frame it rendered.
+//! @note This member function can be called from any thread.
+void VideoFrameExchange::requestFullRefresh()
+{
+    _isRefreshRequested.store(true, std::memory_order_release);
+}
+
+//! @brief Determines whether a full refresh was requested, clearing the
+//! request.
+//! @note This member function should only be called from the producer thread.
+bool VideoFrameExchange::tryTakeRefreshRequest()
+{
+    return _isRefreshRequested.load(std::memory_order_relaxed) &&
+           _isRefreshRequested.exchange(false, std::memory_order_acq_rel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// VideoRenderThread Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an object with no thread running.
+VideoRenderThread::VideoRenderThread() :
+    _source(nullptr),
+    _presenter(nullptr),
+    _renderedFrameCount(0),
+    _isPending(false),
+    _isStopping(false)
+{
+}
+
+//! @brief Ensures the render thread is stopped.
+VideoRenderThread::~VideoRenderThread()
+{
+    stop();
+}
+
+//! @brief Determines whether the render thread has been started.
+bool VideoRenderThread::isRunning() const
+{
+    return _thread.joinable();
+}
+
+//! @brief Gets the count of frames rendered and presented.
+//! @note This member function can be called from any thread.
+uint64_t VideoRenderThread::getRenderedFrameCount() const
+{
+    return _renderedFrameCount.load(std::memory_order_relaxed);
+}
+
+//! @brief Attempts to start rendering frames on a new thread.
+//! @param[in] source The exchange frames are published to by the emulated
+//! system, see IArmSystem::getVideoFrames().
+//! @param[in] presenter The object to pass each rendered frame to.
+//! @retval true The thread was started.
+//! @retval false The thread was already running or no presenter was given.
+//! @note A full refresh is requested from the producer so that the first
+//! frame rendered is complete.
+bool VideoRenderThread::tryStart(VideoFrameExchange &source,
+                                 IVideoPresenter *presenter)
+{
+    bool isStarted = false;
+
+    if ((isRunning() == false) && (presenter != nullptr))
+    {
+        _source = &source;
+        _presenter = presenter;
+        _geometry = VidcTiming();
+        _isPending = false;
+        _isStopping = false;
+
+        source.requestFullRefresh();
+        _thread = std::thread(&VideoRenderThread::run, this);
+        isStarted = true;
+    }
+
+    return isStarted;
+}
+
+//! @brief Stops the render thread, waiting for any frame being rendered.
+void VideoRenderThread::stop()
+{
+    if (_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _isStopping = true;
+        }
+
+        _wakeUp.notify_all();
+        _thread.join();
+
+        _source = nullptr;
+        _presenter = nullptr;
+    }
+}
+
+//! @brief Wakes the render thread to render the latest published frame.
+//! @note This member function can be called from any thread other than the
+//! emulation thread, typically by the IGuestEventListener on receipt of a
+//! HostMessageID::VideoFrameReady message.
+void VideoRenderThread::notifyFramePending()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _isPending = true;
+    }
+
+    _wakeUp.notify_one();
+}
+
+//! @brief The entry point of the render thread.
+void VideoRenderThread::run()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+
+    while (_isStopping == false)
+    {
+        _wakeUp.wait(guard, [this]() { return _isPending || _isStopping; });
+        _isPending = false;
+
+        if (_isStopping == false)
+        {
+            guard.unlock();
+
+            if (const VideoFrame *frame = _source->tryAcquire())
+            {
+                renderFrame(*frame);
+            }
+
+            guard.lock();
+        }
+    }
+}
+
+//! @brief Applies the changes in a snapshot to the host frame and passes it
+//! to the presenter.
+//! @param[in] frame The snapshot acquired from the exchange.
+void VideoRenderThread::renderFrame(const VideoFrame &frame)
+{
+    const uint32_t width = frame.Timing.getFrameWidth();
+    const uint32_t height = frame.Timing.getFrameHeight();
+    bool isRenderable = true;
+
+    if (frame.Timing.isSameDisplay(_geometry) == false)
+    {
+        // The producer marks every line as dirty when the geometry changes,
+        // or on request. A partial frame would leave lines undefined, so wait
+        // for the full refresh.
+        isRenderable = (frame.getDirtyLineCount() == height);
+
+        if (isRenderable)
+        {
+            _pixels.assign(static_cast<size_t>(width) * height, 0);
+            _geometry = frame.Timing;
+        }
+    }
+
+    if (isRenderable)
+    {
+        frame.render(_converter, _pixels.data(), width);
+        _presenter->onFrameRendered(_pixels.data(), width, height, frame.Sequence);
+        _renderedFrameCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
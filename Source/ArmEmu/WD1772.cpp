@@ -0,0 +1,1091 @@
+//! @file ArmEmu/WD1772.cpp
+//! @brief The definition of an object which emulates the function of the
+//! WD1772 floppy disc controller and the drives attached to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+#include "Ag/Core/Binary.hpp"
+#include "Ag/Core/Utils.hpp"
+
+#include "ArmEmu/ArmSystem.hpp"
+#include "ArmEmu/EmuOptions.hpp"
+#include "ArmEmu/IOC.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+#include "ArmEmu/WD1772.hpp"
+
+namespace Mo {
+namespace Arm {
+
+namespace {
+////////////////////////////////////////////////////////////////////////////////
+// Local Data Types
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the bits of the status register. Some bits have a
+//! different meaning after Type I commands.
+struct StatusBit
+{
+    static constexpr uint8_t Busy = 0x01;
+    static constexpr uint8_t DataRequest = 0x02;    // Type I: Index.
+    static constexpr uint8_t LostData = 0x04;       // Type I: Track 00.
+    static constexpr uint8_t CrcError = 0x08;
+    static constexpr uint8_t RecordNotFound = 0x10; // Type I: Seek Error.
+    static constexpr uint8_t SpinUpComplete = 0x20; // Type II: Record Type.
+    static constexpr uint8_t WriteProtect = 0x40;
+    static constexpr uint8_t MotorOn = 0x80;
+
+    static constexpr uint8_t Index = DataRequest;
+    static constexpr uint8_t Track00 = LostData;
+    static constexpr uint8_t SeekError = RecordNotFound;
+};
+
+//! @brief Identifies the flag bits of commands.
+struct CommandBit
+{
+    static constexpr uint8_t Verify = 0x04;         // Type I.
+    static constexpr uint8_t Settle = 0x04;         // Type II/III.
+    static constexpr uint8_t NoSpinUp = 0x08;
+    static constexpr uint8_t UpdateTrack = 0x10;    // Step commands.
+    static constexpr uint8_t MultipleSectors = 0x10;
+    static constexpr uint8_t ImmediateInterrupt = 0x08;
+    static constexpr uint8_t IndexInterrupt = 0x04;
+};
+
+//! @brief Identifies commands by their most significant bits.
+struct Command
+{
+    static constexpr uint8_t Restore = 0x00;
+    static constexpr uint8_t Seek = 0x10;
+    static constexpr uint8_t Step = 0x20;
+    static constexpr uint8_t StepIn = 0x40;
+    static constexpr uint8_t StepOut = 0x60;
+    static constexpr uint8_t ReadSector = 0x80;
+    static constexpr uint8_t WriteSector = 0xA0;
+    static constexpr uint8_t ReadAddress = 0xC0;
+    static constexpr uint8_t ForceInterrupt = 0xD0;
+    static constexpr uint8_t ReadTrack = 0xE0;
+    static constexpr uint8_t WriteTrack = 0xF0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Data
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The time taken for a revolution of the disc at 300 RPM, in
+//! microseconds.
+constexpr uint64_t RevolutionTime = 200000;
+
+//! @brief The time taken to read or write a byte at 250 Kbit/s, in
+//! microseconds.
+constexpr uint64_t ByteTime = 32;
+
+//! @brief The duration of the index pulse at the start of each revolution,
+//! in microseconds.
+constexpr uint64_t IndexPulseTime = 4000;
+
+//! @brief The delay before the head is assumed to have stopped moving, in
+//! microseconds.
+constexpr uint64_t SettleTime = 15000;
+
+//! @brief The time taken for each step of the head, in microseconds, indexed
+//! by bits 0-1 of a Type I command.
+constexpr uint64_t StepTimes[] = { 6000, 12000, 2000, 3000 };
+
+//! @brief The count of index pulses waited for to let the motor spin up.
+constexpr uint8_t SpinUpRevolutions = 6;
+
+//! @brief The count of index pulses after the last command before the motor
+//! is turned off.
+constexpr uint8_t MotorOffRevolutions = 9;
+
+//! @brief The count of index pulses after which a sector is not found.
+constexpr uint8_t SearchRevolutions = 5;
+
+//! @brief The count of byte times after an ID field before the first byte
+//! must be written.
+constexpr uint32_t WriteGapBytes = 11;
+
+//! @brief Indicates that no drive is selected by the drive latch.
+constexpr uint8_t NoDrive = 0xFF;
+
+////////////////////////////////////////////////////////////////////////////////
+// Local Functions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Calculates the CRC recorded after a sector ID field, including the
+//! address mark which precedes it.
+//! @param[in] idField The track, side, sector and length code.
+uint16_t calculateIdCrc(const uint8_t *idField)
+{
+    const uint8_t addressMark[] = { 0xA1, 0xA1, 0xA1, 0xFE };
+    uint16_t crc = 0xFFFF;
+
+    auto update = [&crc](uint8_t value) {
+        crc ^= static_cast<uint16_t>(value) << 8;
+
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) :
+                                   static_cast<uint16_t>(crc << 1);
+        }
+    };
+
+    std::for_each(addressMark, addressMark + 4, update);
+    std::for_each(idField, idField + 4, update);
+
+    return crc;
+}
+
+} // Anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// FloppyDriveLatch Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs the latch which selects the drive a WD1772 uses.
+//! @param[in] parent The controller the latch selects drives for.
+FloppyDriveLatch::FloppyDriveLatch(WD1772 &parent) :
+    _parent(parent),
+    _context(nullptr)
+{
+}
+
+// Inherited from IAddressRegion.
+RegionType FloppyDriveLatch::getType() const
+{
+    return RegionType::MMIO;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t FloppyDriveLatch::getName() const
+{
+    static const Ag::String name("Floppy Drive Latch");
+
+    return name;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t FloppyDriveLatch::getDescription() const
+{
+    static const Ag::String description("The latch which selects the floppy "
+                                        "drive and side in use.");
+
+    return description;
+}
+
+// Inherited from IAddressRegion.
+uint32_t FloppyDriveLatch::getSize() const
+{
+    return 4;
+}
+
+// Inherited from IMMIOBlock.
+uint32_t FloppyDriveLatch::read(uint32_t /*offset*/)
+{
+    // The latch is write-only.
+    return (_context == nullptr) ? 0 : _context->getFuzz();
+}
+
+// Inherited from IMMIOBlock.
+void FloppyDriveLatch::write(uint32_t /*offset*/, uint32_t value)
+{
+    _parent.selectDrive(static_cast<uint8_t>(value));
+}
+
+// Inherited from IMMIOBlock.
+void FloppyDriveLatch::connect(const ConnectionContext &context)
+{
+    _context = context.getInteropContext();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// WD1772 Member Definitions
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Constructs an emulation of the WD1772 with empty drives.
+//! @param[in] options The configuration of the emulated system, which
+//! specifies the count of drives and whether fast disc mode is enabled.
+WD1772::WD1772(const Options &options) :
+    _latch(*this),
+    _context(nullptr),
+    _ioController(nullptr),
+    _readBuffer(nullptr),
+    _writeBuffer(nullptr),
+    _idleSinceTicks(0),
+    _transferOffset(0),
+    _transferSize(0),
+    _driveCount(std::min(options.getFloppyDiskCount(), MaxDriveCount)),
+    _selectedDrive(NoDrive),
+    _selectedSide(0),
+    _command(0),
+    _status(0),
+    _track(0),
+    _sector(0),
+    _data(0),
+    _stepDirection(1),
+    _pendingStatus(0),
+    _nextAddressSector(0),
+    _phase(Phase::Idle),
+    _isMotorOn(false),
+    _isTypeIStatus(true),
+    _isDataRequestActive(false),
+    _isInterruptRequestActive(false),
+    _isFastDiscEnabled(options.isFastDiscEnabled())
+{
+    std::fill_n(_idField, std::size(_idField), static_cast<uint8_t>(0));
+    std::fill_n(_heldSector, std::size(_heldSector), static_cast<uint8_t>(0));
+    std::fill_n(_headTracks, MaxDriveCount, static_cast<uint8_t>(0));
+
+    Ag::zeroFill(_task);
+    _task.Task = WD1772::onTaskDue;
+    _task.Context = reinterpret_cast<uintptr_t>(this);
+}
+
+//! @brief Gets the count of drives attached to the controller.
+uint8_t WD1772::getDriveCount() const
+{
+    return _driveCount;
+}
+
+//! @brief Determines whether commands complete as soon as the data has been
+//! transferred rather than at the speed of a real drive.
+bool WD1772::isFastDiscEnabled() const
+{
+    return _isFastDiscEnabled;
+}
+
+//! @brief Gets the disc image inserted in a drive.
+//! @param[in] drive The 0-based index of the drive.
+//! @return The image, which will not be open if the drive is empty.
+const DiscImage &WD1772::getDisc(uint8_t drive) const
+{
+    return _discs[drive % MaxDriveCount];
+}
+
+//! @brief Gets the physical track the head of a drive is positioned over.
+//! @param[in] drive The 0-based index of the drive.
+uint8_t WD1772::getHeadTrack(uint8_t drive) const
+{
+    return _headTracks[drive % MaxDriveCount];
+}
+
+//! @brief Gets the latch which selects the drive the controller uses, which
+//! should be mapped at FloppyDriveLatch::BaseAddress.
+FloppyDriveLatch &WD1772::getDriveLatch()
+{
+    return _latch;
+}
+
+//! @brief Attempts to insert a disc image into a drive.
+//! @param[in] drive The 0-based index of the drive.
+//! @param[in] fileName The path to an ADFS floppy disc image file.
+//! @param[in] isWriteProtected True to prevent the guest writing to the disc.
+//! @param[out] error Receives a description of why the disc couldn't be
+//! inserted.
+//! @retval true The image was mapped, replacing any disc in the drive.
+//! @retval false The image couldn't be mapped, error is updated.
+//! @note This member function should only be called on the emulation thread
+//! or while the emulated system isn't running.
+bool WD1772::tryInsertDisc(uint8_t drive, const std::string &fileName,
+                           bool isWriteProtected, std::string &error)
+{
+    bool isInserted = false;
+
+    if (drive >= _driveCount)
+    {
+        error = "The floppy drive specified isn't attached.";
+    }
+    else
+    {
+        ejectDisc(drive);
+        isInserted = _discs[drive].tryOpen(fileName, isWriteProtected, error);
+    }
+
+    return isInserted;
+}
+
+//! @brief Removes the disc from a drive, writing back any changed sectors.
+//! @param[in] drive The 0-based index of the drive.
+//! @note This member function should only be called on the emulation thread
+//! or while the emulated system isn't running.
+void WD1772::ejectDisc(uint8_t drive)
+{
+    if (drive < _driveCount)
+    {
+        if ((drive == _selectedDrive) && (_phase != Phase::Idle))
+        {
+            // Abandon the transfer from the disc being removed.
+            forceInterrupt(0);
+        }
+
+        _discs[drive].close();
+    }
+}
+
+//! @brief Writes back sectors changed on all discs inserted.
+//! @return The count of dirty sectors written back.
+uint32_t WD1772::flushDiscs()
+{
+    uint32_t flushedCount = 0;
+
+    for (uint8_t drive = 0; drive < _driveCount; ++drive)
+    {
+        flushedCount += _discs[drive].flush();
+    }
+
+    return flushedCount;
+}
+
+//! @brief Selects the drive and side subsequent commands operate on.
+//! @param[in] latchValue The value written to the drive latch.
+void WD1772::selectDrive(uint8_t latchValue)
+{
+    _selectedDrive = NoDrive;
+    _selectedSide = Ag::Bin::extractBit<4>(latchValue) ? 0 : 1;
+
+    for (uint8_t drive = 0; drive < _driveCount; ++drive)
+    {
+        // Drive select lines are active low.
+        if ((latchValue & (1u << drive)) == 0)
+        {
+            _selectedDrive = drive;
+            break;
+        }
+    }
+}
+
+// Inherited from IAddressRegion.
+RegionType WD1772::getType() const
+{
+    return RegionType::MMIO;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t WD1772::getName() const
+{
+    static const Ag::String name("WD1772");
+
+    return name;
+}
+
+// Inherited from IAddressRegion.
+Ag::string_cref_t WD1772::getDescription() const
+{
+    static const Ag::String description("The WD1772 Floppy Disc Controller");
+
+    return description;
+}
+
+// Inherited from IAddressRegion.
+uint32_t WD1772::getSize() const
+{
+    return 0x10;
+}
+
+// Inherited from IMMIOBlock.
+uint32_t WD1772::read(uint32_t offset)
+{
+    uint32_t result = 0;
+
+    switch (Ag::Bin::extractBits<uint8_t, 2, 2>(offset))
+    {
+    case 0: result = readStatus(); break;
+    case 1: result = _track; break;
+    case 2: result = _sector; break;
+    case 3: result = readData(); break;
+    }
+
+    return result;
+}
+
+// Inherited from IMMIOBlock.
+void WD1772::write(uint32_t offset, uint32_t value)
+{
+    const uint8_t byte = static_cast<uint8_t>(value);
+
+    switch (Ag::Bin::extractBits<uint8_t, 2, 2>(offset))
+    {
+    case 0: beginCommand(byte); break;
+    case 1: _track = byte; break;
+    case 2: _sector = byte; break;
+    case 3: writeData(byte); break;
+    }
+}
+
+// Inherited from IMMIOBlock.
+void WD1772::connect(const ConnectionContext &context)
+{
+    // Connect to the rest of the emulated system.
+    _context = context.getInteropContext();
+    IHardwareDevice *iocDevice = nullptr;
+
+    if (context.tryFindDevice("IOC", iocDevice))
+    {
+        _ioController = dynamic_cast<IOC *>(iocDevice);
+    }
+}
+
+// Inherited from IHardwareDevice.
+void WD1772::captureState(SystemSnapshot &snapshot) const
+{
+    // NOTE: The contents of discs aren't captured, they are external media.
+    snapshot.write(_headTracks, sizeof(_headTracks));
+    snapshot.write(_idField, sizeof(_idField));
+    snapshot.writeValue(_idleSinceTicks);
+    snapshot.writeValue(_transferOffset);
+    snapshot.writeValue(_transferSize);
+    snapshot.writeValue(_selectedDrive);
+    snapshot.writeValue(_selectedSide);
+    snapshot.writeValue(_command);
+    snapshot.writeValue(_status);
+    snapshot.writeValue(_track);
+    snapshot.writeValue(_sector);
+    snapshot.writeValue(_data);
+    snapshot.writeValue(_stepDirection);
+    snapshot.writeValue(_pendingStatus);
+    snapshot.writeValue(_nextAddressSector);
+    snapshot.writeValue(static_cast<uint8_t>(_phase));
+    snapshot.writeValue(_isMotorOn);
+    snapshot.writeValue(_isTypeIStatus);
+    snapshot.writeValue(_isDataRequestActive);
+    snapshot.writeValue(_isInterruptRequestActive);
+}
+
+// Inherited from IHardwareDevice.
+void WD1772::restoreState(SnapshotReader &reader)
+{
+    uint8_t phase = 0;
+
+    reader.read(_headTracks, sizeof(_headTracks));
+    reader.read(_idField, sizeof(_idField));
+    reader.readValue(_idleSinceTicks);
+    reader.readValue(_transferOffset);
+    reader.readValue(_transferSize);
+    reader.readValue(_selectedDrive);
+    reader.readValue(_selectedSide);
+    reader.readValue(_command);
+    reader.readValue(_status);
+    reader.readValue(_track);
+    reader.readValue(_sector);
+    reader.readValue(_data);
+    reader.readValue(_stepDirection);
+    reader.readValue(_pendingStatus);
+    reader.readValue(_nextAddressSector);
+    reader.readValue(phase);
+    reader.readValue(_isMotorOn);
+    reader.readValue(_isTypeIStatus);
+    reader.readValue(_isDataRequestActive);
+    reader.readValue(_isInterruptRequestActive);
+
+    _phase = static_cast<Phase>(phase);
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+
+    if (((_phase == Phase::Reading) || (_phase == Phase::Writing)) &&
+        (attachTransfer() == false))
+    {
+        // The disc has changed since the snapshot was taken.
+        _context->cancelTask(&_task);
+        completeCommand(StatusBit::RecordNotFound);
+    }
+}
+
+//! @brief Gets the disc in the selected drive, or nullptr if no drive is
+//! selected or the drive is empty.
+DiscImage *WD1772::getSelectedDisc()
+{
+    DiscImage *disc = nullptr;
+
+    if ((_selectedDrive < _driveCount) && _discs[_selectedDrive].isOpen())
+    {
+        disc = &_discs[_selectedDrive];
+    }
+
+    return disc;
+}
+
+//! @brief Converts a time in microseconds to master clock ticks.
+uint64_t WD1772::toTicks(uint64_t microseconds) const
+{
+    return (_context->getMasterClockFrequency() * microseconds) / 1000000;
+}
+
+//! @brief Calculates the time until a position on the track next passes
+//! under the head.
+//! @param[in] position The 0-based index of the position.
+//! @param[in] count The count of equally spaced positions on the track.
+uint64_t WD1772::getRotationTicks(uint32_t position, uint32_t count) const
+{
+    const uint64_t revolutionTicks = toTicks(RevolutionTime);
+    const uint64_t angle = _context->getMasterClockTicks() % revolutionTicks;
+    const uint64_t target = (revolutionTicks * position) / count;
+
+    return (target + revolutionTicks - angle) % revolutionTicks;
+}
+
+//! @brief Schedules the next stage of the command being executed.
+//! @param[in] phase The stage to enter when the task is due.
+//! @param[in] delayTicks The count of master clock ticks until the task is due.
+void WD1772::schedule(Phase phase, uint64_t delayTicks)
+{
+    _phase = phase;
+    _context->cancelTask(&_task);
+    _task.At = _context->getMasterClockTicks() + delayTicks;
+    _context->scheduleTask(&_task);
+}
+
+//! @brief Sets the state of the DRQ output, connected to IOC FH0.
+void WD1772::setDataRequest(bool isActive)
+{
+    _isDataRequestActive = isActive;
+
+    if (_isTypeIStatus == false)
+    {
+        _status = isActive ? (_status | StatusBit::DataRequest) :
+                             (_status & ~StatusBit::DataRequest);
+    }
+
+    if (_ioController != nullptr)
+    {
+        _ioController->setFastHighInterrupt(0, isActive);
+    }
+}
+
+//! @brief Sets the state of the INTRQ output, connected to IOC FH1.
+void WD1772::setInterruptRequest(bool isActive)
+{
+    _isInterruptRequestActive = isActive;
+
+    if (_ioController != nullptr)
+    {
+        _ioController->setFastHighInterrupt(1, isActive);
+    }
+}
+
+//! @brief Starts executing a command written to the command register.
+//! @param[in] command The command byte.
+void WD1772::beginCommand(uint8_t command)
+{
+    updateMotorState();
+
+    if ((command & 0xF0) == Command::ForceInterrupt)
+    {
+        forceInterrupt(command & 0x0F);
+    }
+    else if ((_status & StatusBit::Busy) == 0)
+    {
+        const uint8_t drive = _selectedDrive;
+        const bool isTypeI = (command & 0x80) == 0;
+        uint64_t delay = 0;
+
+        _command = command;
+        _isTypeIStatus = isTypeI;
+        _status = StatusBit::Busy;
+        _pendingStatus = 0;
+        setInterruptRequest(false);
+        setDataRequest(false);
+
+        if ((_isMotorOn == false) && ((command & CommandBit::NoSpinUp) == 0))
+        {
+            delay += RevolutionTime * SpinUpRevolutions;
+            _pendingStatus |= StatusBit::SpinUpComplete;
+        }
+
+        _isMotorOn = true;
+
+        if (isTypeI)
+        {
+            // Move the head immediately, the command completes once the
+            // time taken to step has elapsed.
+            int32_t steps = 0;
+            int32_t direction = (_stepDirection != 0) ? 1 : -1;
+
+            switch (command & 0xE0)
+            {
+            case Command::Restore:
+                if ((command & 0xF0) == Command::Restore)
+                {
+                    // Step out until the track 00 sensor is active.
+                    steps = (drive < _driveCount) ? _headTracks[drive] : 255;
+                    direction = -1;
+                    _track = 0;
+                }
+                else
+                {
+                    // Seek to the track in the data register.
+                    steps = std::abs(static_cast<int32_t>(_data) - _track);
+                    direction = (_data > _track) ? 1 : -1;
+                    _track = _data;
+                }
+                break;
+
+            case Command::Step:
+                steps = 1;
+                break;
+
+            case Command::StepIn:
+                steps = 1;
+                direction = 1;
+                break;
+
+            case Command::StepOut:
+                steps = 1;
+                direction = -1;
+                break;
+            }
+
+            if ((command & 0xE0) != Command::Restore)
+            {
+                _stepDirection = (direction > 0) ? 1 : 0;
+
+                if (command & CommandBit::UpdateTrack)
+                {
+                    _track = static_cast<uint8_t>(_track + direction);
+                }
+            }
+
+            if (drive < _driveCount)
+            {
+                const int32_t head = std::clamp(_headTracks[drive] + (steps * direction),
+                                                0, static_cast<int32_t>(MaxHeadTrack));
+
+                _headTracks[drive] = static_cast<uint8_t>(head);
+            }
+
+            delay += StepTimes[command & 3] * static_cast<uint64_t>(steps);
+
+            if (command & CommandBit::Verify)
+            {
+                // Check that the head is over the track expected.
+                const DiscImage *disc = getSelectedDisc();
+                delay += SettleTime;
+
+                if ((disc == nullptr) ||
+                    (_headTracks[drive] >= disc->getGeometry().TrackCount) ||
+                    (_headTracks[drive] != _track))
+                {
+                    _pendingStatus |= StatusBit::SeekError;
+                }
+            }
+
+            schedule(Phase::Completing, _isFastDiscEnabled ? 0 : toTicks(delay));
+        }
+        else
+        {
+            if (command & CommandBit::Settle)
+            {
+                delay += SettleTime;
+            }
+
+            schedule(Phase::Searching, _isFastDiscEnabled ? 0 : toTicks(delay));
+        }
+    }
+}
+
+//! @brief Executes the Force Interrupt command, terminating any command in
+//! progress.
+//! @param[in] condition Bits 0-3 of the command. Interrupts requested on
+//! the next index pulse are raised immediately.
+void WD1772::forceInterrupt(uint8_t condition)
+{
+    if (_context != nullptr)
+    {
+        _context->cancelTask(&_task);
+    }
+
+    _phase = Phase::Idle;
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    setDataRequest(false);
+
+    if (_status & StatusBit::Busy)
+    {
+        // The status of the interrupted command is preserved.
+        _status &= ~StatusBit::Busy;
+    }
+    else
+    {
+        _isTypeIStatus = true;
+        _status = 0;
+    }
+
+    setInterruptRequest((condition & (CommandBit::ImmediateInterrupt |
+                                      CommandBit::IndexInterrupt)) != 0);
+}
+
+//! @brief Ends the command being executed and raises INTRQ.
+//! @param[in] statusBits The status bits to report.
+void WD1772::completeCommand(uint8_t statusBits)
+{
+    _phase = Phase::Idle;
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+    _status = statusBits & ~(StatusBit::Busy | StatusBit::DataRequest);
+    _idleSinceTicks = _context->getMasterClockTicks();
+    setDataRequest(false);
+    setInterruptRequest(true);
+}
+
+//! @brief Turns off the motor if enough revolutions have passed since the
+//! last command completed.
+void WD1772::updateMotorState()
+{
+    if (_isMotorOn && (_phase == Phase::Idle) && (_context != nullptr) &&
+        ((_context->getMasterClockTicks() - _idleSinceTicks) >=
+         toTicks(RevolutionTime * MotorOffRevolutions)))
+    {
+        _isMotorOn = false;
+    }
+}
+
+//! @brief Searches for the sector ID field addressed by a Type II or III
+//! command and schedules the transfer of its data.
+void WD1772::findSector()
+{
+    DiscImage *disc = getSelectedDisc();
+    const uint8_t operation = _command & 0xE0;
+    bool isFound = false;
+
+    if ((operation == Command::WriteSector) && (disc != nullptr) &&
+        disc->isWriteProtected())
+    {
+        // The command is terminated before searching.
+        completeCommand(StatusBit::WriteProtect);
+    }
+    else
+    {
+        uint64_t delay = 0;
+
+        if ((_command & 0xF0) == Command::ReadAddress)
+        {
+            const uint8_t head = _headTracks[_selectedDrive % MaxDriveCount];
+
+            if ((disc != nullptr) && (head < disc->getGeometry().TrackCount) &&
+                (_selectedSide < disc->getGeometry().SideCount))
+            {
+                // Report the next sector ID to pass under the head.
+                const uint8_t sectorCount = disc->getGeometry().SectorsPerTrack;
+                const uint8_t sector = _nextAddressSector++ % sectorCount;
+
+                _idField[0] = head;
+                _idField[1] = _selectedSide;
+                _idField[2] = sector;
+                _idField[3] = disc->getGeometry().getSectorSizeCode();
+
+                const uint16_t crc = calculateIdCrc(_idField);
+                _idField[4] = static_cast<uint8_t>(crc >> 8);
+                _idField[5] = static_cast<uint8_t>(crc);
+
+                delay = getRotationTicks(sector, sectorCount);
+                isFound = true;
+            }
+        }
+        else if ((operation == Command::ReadSector) ||
+                 (operation == Command::WriteSector))
+        {
+            if ((disc != nullptr) &&
+                (_sector < disc->getGeometry().SectorsPerTrack))
+            {
+                delay = getRotationTicks(_sector, disc->getGeometry().SectorsPerTrack);
+            }
+
+            isFound = attachTransfer();
+        }
+
+        if (isFound && ((_command & 0xF0) == Command::ReadAddress))
+        {
+            isFound = attachTransfer();
+        }
+
+        if (isFound == false)
+        {
+            // Give up after the disc has rotated enough times.
+            _pendingStatus = StatusBit::RecordNotFound;
+            schedule(Phase::Completing, _isFastDiscEnabled ? 0 :
+                                            toTicks(RevolutionTime * SearchRevolutions));
+        }
+        else if (_isFastDiscEnabled)
+        {
+            // Transfer data as fast as the guest can move it.
+            _phase = (_writeBuffer != nullptr) ? Phase::Writing : Phase::Reading;
+
+            if (_phase == Phase::Reading)
+            {
+                _data = _readBuffer[_transferOffset++];
+            }
+
+            setDataRequest(true);
+        }
+        else if (_writeBuffer != nullptr)
+        {
+            // Ask for the first byte, which must arrive before the data
+            // field is written.
+            setDataRequest(true);
+            schedule(Phase::Writing, delay + toTicks(ByteTime * WriteGapBytes));
+        }
+        else
+        {
+            schedule(Phase::Reading, delay + toTicks(ByteTime));
+        }
+    }
+}
+
+//! @brief Connects the transfer of the command in progress to the data of
+//! the sector or ID field it addresses.
+//! @retval true The data was found.
+//! @retval false The sector doesn't exist.
+//! @note While storage output is held, see HeldOutput::Storage, data written
+//! to an existing sector goes to a scratch buffer and is discarded.
+bool WD1772::attachTransfer()
+{
+    DiscImage *disc = getSelectedDisc();
+    bool isAttached = false;
+
+    _readBuffer = nullptr;
+    _writeBuffer = nullptr;
+
+    if ((_command & 0xF0) == Command::ReadAddress)
+    {
+        _readBuffer = _idField;
+        _transferSize = static_cast<uint32_t>(std::size(_idField));
+        isAttached = true;
+    }
+    else if ((disc != nullptr) && (_headTracks[_selectedDrive] == _track))
+    {
+        // The track in the ID field must match the track register.
+        const uint8_t operation = _command & 0xE0;
+        _transferSize = disc->getGeometry().SectorSize;
+
+        if (operation == Command::WriteSector)
+        {
+            if ((_context != nullptr) &&
+                _context->isOutputHeld(HeldOutput::Storage))
+            {
+                // Fail in the same way, but leave the disc image alone.
+                if ((disc->isWriteProtected() == false) &&
+                    (disc->getSector(_track, _selectedSide, _sector) != nullptr))
+                {
+                    _writeBuffer = _heldSector;
+                }
+            }
+            else
+            {
+                _writeBuffer = disc->getWritableSector(_track, _selectedSide, _sector);
+            }
+
+            isAttached = (_writeBuffer != nullptr);
+        }
+        else if (operation == Command::ReadSector)
+        {
+            _readBuffer = disc->getSector(_track, _selectedSide, _sector);
+            isAttached = (_readBuffer != nullptr);
+        }
+    }
+
+    if (_phase == Phase::Searching)
+    {
+        _transferOffset = 0;
+    }
+
+    return isAttached;
+}
+
+//! @brief Moves the next byte between the disc and the data register at the
+//! speed of a real drive.
+void WD1772::transferByte()
+{
+    if (_transferOffset >= _transferSize)
+    {
+        // The CRC has passed under the head.
+        completeSector();
+    }
+    else if (_phase == Phase::Reading)
+    {
+        if (_isDataRequestActive)
+        {
+            // The guest didn't read the previous byte in time.
+            _status |= StatusBit::LostData;
+        }
+
+        _data = _readBuffer[_transferOffset++];
+        setDataRequest(true);
+        schedule(Phase::Reading, toTicks(ByteTime));
+    }
+    else if (_isDataRequestActive && (_transferOffset == 0))
+    {
+        // The first byte wasn't written in time, nothing is written.
+        completeCommand(StatusBit::LostData);
+    }
+    else
+    {
+        if (_isDataRequestActive)
+        {
+            // The guest didn't write the next byte in time, zeros are
+            // written in its place.
+            _status |= StatusBit::LostData;
+            _data = 0;
+        }
+
+        _writeBuffer[_transferOffset++] = _data;
+        setDataRequest(_transferOffset < _transferSize);
+        schedule(Phase::Writing, toTicks(ByteTime));
+    }
+}
+
+//! @brief Completes the transfer of a sector, moving on to the next if a
+//! multiple sector command is being executed.
+void WD1772::completeSector()
+{
+    const uint8_t lostData = _status & StatusBit::LostData;
+
+    if ((_command & 0xF0) == Command::ReadAddress)
+    {
+        // The track address is copied into the sector register.
+        _sector = _idField[0];
+        completeCommand(lostData);
+    }
+    else if (_command & CommandBit::MultipleSectors)
+    {
+        // Carry on until the sector isn't found.
+        ++_sector;
+        _phase = Phase::Searching;
+        findSector();
+    }
+    else
+    {
+        completeCommand(lostData);
+    }
+}
+
+//! @brief Reads the data register, acknowledging DRQ.
+uint8_t WD1772::readData()
+{
+    const uint8_t value = _data;
+
+    if (_isDataRequestActive && (_phase == Phase::Reading))
+    {
+        setDataRequest(false);
+
+        if (_isFastDiscEnabled)
+        {
+            if (_transferOffset < _transferSize)
+            {
+                _data = _readBuffer[_transferOffset++];
+                setDataRequest(true);
+            }
+            else
+            {
+                completeSector();
+            }
+        }
+    }
+
+    return value;
+}
+
+//! @brief Writes the data register, acknowledging DRQ.
+//! @param[in] value The byte written.
+void WD1772::writeData(uint8_t value)
+{
+    _data = value;
+
+    if (_isDataRequestActive && (_phase == Phase::Writing))
+    {
+        setDataRequest(false);
+
+        if (_isFastDiscEnabled)
+        {
+            _writeBuffer[_transferOffset++] = value;
+
+            if (_transferOffset < _transferSize)
+            {
+                setDataRequest(true);
+            }
+            else
+            {
+                completeSector();
+            }
+        }
+    }
+}
+
+//! @brief Reads the status register, acknowledging INTRQ.
+uint8_t WD1772::readStatus()
+{
+    updateMotorState();
+    uint8_t status = _status & ~StatusBit::MotorOn;
+
+    if (_isMotorOn)
+    {
+        status |= StatusBit::MotorOn;
+    }
+
+    if (_isTypeIStatus)
+    {
+        const DiscImage *disc = getSelectedDisc();
+        status &= ~(StatusBit::Index | StatusBit::Track00 | StatusBit::WriteProtect);
+
+        if ((_selectedDrive < _driveCount) && (_headTracks[_selectedDrive] == 0))
+        {
+            status |= StatusBit::Track00;
+        }
+
+        if (disc != nullptr)
+        {
+            if (disc->isWriteProtected())
+            {
+                status |= StatusBit::WriteProtect;
+            }
+
+            if (_isMotorOn &&
+                ((_context->getMasterClockTicks() % toTicks(RevolutionTime)) <
+                 toTicks(IndexPulseTime)))
+            {
+                status |= StatusBit::Index;
+            }
+        }
+    }
+
+    if (_isInterruptRequestActive)
+    {
+        setInterruptRequest(false);
+    }
+
+    return status;
+}
+
+//! @brief The task which performs each timed stage of a command.
+//! @param[in] guestContext The context which scheduled the task.
+//! @param[in] taskContext A pointer to the WD1772 instance.
+void WD1772::onTaskDue(SystemContext &/*guestContext*/, uintptr_t taskContext)
+{
+    WD1772 *fdc = reinterpret_cast<WD1772 *>(taskContext);
+
+    switch (fdc->_phase)
+    {
+    case Phase::Searching:
+        fdc->findSector();
+        break;
+
+    case Phase::Reading:
+    case Phase::Writing:
+        fdc->transferByte();
+        break;
+
+    case Phase::Completing:
+        fdc->completeCommand(fdc->_pendingStatus);
+        break;
+
+    case Phase::Idle:
+        break;
+    }
+}
+
+}} // namespace Mo::Arm
+////////////////////////////////////////////////////////////////////////////////
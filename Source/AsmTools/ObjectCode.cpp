@@ -12,6 +12,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <cstdlib>
 #include <cstring>
+#include <utility>
+
 #include "AsmTools/ObjectCode.hpp"
 
 namespace Mo {
@@ -39,6 +41,23 @@ ObjectCode::ObjectCode(std::vector<uint8_t> &&machineCode,
 {
 }
 
+//! @brief Constructs an object to hold assembled machine code annotated
+//! with the source code lines which produced each instruction.
+//! @param[in] machineCode A vector of object code bytes to take ownership of.
+//! @param[in] symbolMap A map of symbols defined at global scope in the
+//! assembled code.
+//! @param[in] lineTable The source lines of the instructions in the code in
+//! ascending address order.
+//! @param[in] loadAddress The 32-bit address at which the code is expected to run.
+ObjectCode::ObjectCode(std::vector<uint8_t> &&machineCode, SymbolMap &&symbolMap,
+                       LineTable &&lineTable, uint32_t loadAddress) :
+    _code(std::move(machineCode)),
+    _symbols(std::move(symbolMap)),
+    _lines(std::move(lineTable)),
+    _loadAddress(loadAddress)
+{
+}
+
 //! @brief Disposes of the object machine code.
 ObjectCode::~ObjectCode()
 {
@@ -77,11 +96,20 @@ const SymbolMap &ObjectCode::getSymbols() const
     return _symbols;
 }
 
+//! @brief Gets the mapping of instruction addresses to the source code lines
+//! which produced them, in ascending address order.
+//! @details Only instruction statements are mapped, data directives are not.
+const LineTable &ObjectCode::getLineTable() const
+{
+    return _lines;
+}
+
 //! @brief Frees any object code and resets the object to an empty state.
 void ObjectCode::clear()
 {
     _code.clear();
     _symbols.clear();
+    _lines.clear();
 }
 
 }} // namespace Mo::Asm
@@ -94,6 +94,7 @@ uint32_t ObjectCodeBuilder::getCurrentAddress() const
 void ObjectCodeBuilder::clear()
 {
     _code.clear();
+    _lines.clear();
 }
 
 //! @brief Provides a hint as to the expected size of the object code written
@@ -181,6 +182,14 @@ void ObjectCodeBuilder::beginFinalPass()
     _finalPass = true;
 }
 
+//! @brief Sets the source lines which will annotate the object code created.
+//! @param[in] lines The source lines of each instruction statement in
+//! ascending address order.
+void ObjectCodeBuilder::setLineTable(const LineTable &lines)
+{
+    _lines = lines;
+}
+
 //! @brief Constructs an immutable object code object and resets the current
 //! object back to an empty state.
 ObjectCode ObjectCodeBuilder::createObjectCode()
@@ -188,7 +197,8 @@ ObjectCode ObjectCodeBuilder::createObjectCode()
     _finalPass = false;
     SymbolMap emptySymbols;
 
-    return ObjectCode(std::move(_code), std::move(emptySymbols), _baseAddress);
+    return ObjectCode(std::move(_code), std::move(emptySymbols),
+                      std::move(_lines), _baseAddress);
 }
 
 //! @brief Constructs an immutable object code object annotated with symbols
@@ -208,7 +218,8 @@ ObjectCode ObjectCodeBuilder::createObjectCode(const SymbolTable &topLevelSymbol
         }
     }
 
-    return ObjectCode(std::move(_code), std::move(symbols), _baseAddress);
+    return ObjectCode(std::move(_code), std::move(symbols),
+                      std::move(_lines), _baseAddress);
 }
 
 }} // namespace Mo::Asm
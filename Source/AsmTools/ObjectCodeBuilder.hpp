@@ -62,6 +62,7 @@ public:
     void writeLongWord(uint64_t value);
     void writeZeros(size_t byteCount);
     void beginFinalPass();
+    void setLineTable(const LineTable &lines);
 
     ObjectCode createObjectCode();
     ObjectCode createObjectCode(const SymbolTable &symbols);
@@ -70,6 +71,7 @@ private:
     Messages &_output;
     const Ag::Bin::ByteOrder *_encoder;
     std::vector<uint8_t> _code;
+    LineTable _lines;
     uint32_t _baseAddress;
     uint32_t _initialOffset;
     bool _finalPass;
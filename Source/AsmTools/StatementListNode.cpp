@@ -343,6 +343,7 @@ ObjectCode StatementListNode::assemble(Messages &messages) const
 
     ObjectCodeBuilder builder(messages, _baseAddress, 0);
     builder.reserve(predictedSize);
+    builder.setLineTable(_lines);
     builder.beginFinalPass();
 
     // Append the contents of each block to the builder, merely copying some
@@ -479,20 +480,29 @@ void StatementListNode::processStatementNode(ParseContext &context,
             // Ensure a symbol context is set to the current assembly position
             // before attempting to assemble the instruction or directive.
             IScopedContext *currentContext = getScope();
-            currentContext->setAssemblyOffset(getAssemblyOffset());
+            const uint32_t offset = getAssemblyOffset();
+            const bool isInstruction = (statement->getType() == StatementType::Instruction);
+            uint32_t size = 0;
+            currentContext->setAssemblyOffset(offset);
 
             if (statement->assemble(*_currentState, currentContext, builder))
             {
                 // The code was successfully assembled on the first pass.
+                size = static_cast<uint32_t>(builder.getSize());
                 appendObjectCode(builder);
             }
             else
             {
                 // Assembly needs to be deferred, keep the statement for
                 // later processing.
-                uint32_t predictedSize = statement->calculateObjectCodeSize(currentContext);
+                size = statement->calculateObjectCodeSize(currentContext);
 
-                deferAssembly(std::move(statement), predictedSize);
+                deferAssembly(std::move(statement), size);
+            }
+
+            if (isInstruction)
+            {
+                mapSourceLine(parsedStatment->getStart(), offset, size);
             }
         } break;
 
@@ -671,6 +681,12 @@ void StatementListNode::processIncludedFile(ParseContext &parentContext,
                 std::move(includedStatements._blocks.begin(),
                           includedStatements._blocks.end(),
                           std::back_inserter(_blocks));
+
+                // The included code follows on from ours, so its source
+                // lines remain in address order.
+                std::move(includedStatements._lines.begin(),
+                          includedStatements._lines.end(),
+                          std::back_inserter(_lines));
             }
             else
             {
@@ -734,6 +750,27 @@ void StatementListNode::deferAssembly(StatementUPtr &&statement,
     }
 }
 
+//! @brief Records the source line of an instruction statement so that the
+//! object code it produces can be mapped back to it.
+//! @param[in] source The location of the start of the statement.
+//! @param[in] offset The offset of the first byte of object code the
+//! statement produced.
+//! @param[in] size The count of bytes of object code the statement produced.
+void StatementListNode::mapSourceLine(const Location &source, uint32_t offset,
+                                      uint32_t size)
+{
+    if ((size > 0) && source.isValid())
+    {
+        SourceLineMapping mapping;
+        mapping.Address = _baseAddress + offset;
+        mapping.Size = size;
+        mapping.FileName = source.FileName;
+        mapping.LineNo = source.LineNo;
+
+        _lines.push_back(mapping);
+    }
+}
+
 //! @brief Gets the variable scope at the top of the scope stack.
 IScopedContext *StatementListNode::getScope()
 {
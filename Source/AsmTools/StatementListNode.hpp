@@ -126,11 +126,13 @@ private:
                              const Location &includedFrom);
     void appendObjectCode(const ObjectCodeBuilder &objectCode);
     void deferAssembly(StatementUPtr &&statement, uint32_t predictedSize);
+    void mapSourceLine(const Location &source, uint32_t offset, uint32_t size);
     IScopedContext *getScope();
 
     // Internal Fields
     std::vector<StatementBlockUPtr> _blocks;
     std::vector<IScopedContextSPtr> _scopeStack;
+    LineTable _lines;
     AssemblyStateSPtr _currentState;
     uint32_t _baseAddress;
     uint32_t _initialAssemblyOffset;
@@ -0,0 +1,74 @@
+//! @file Test_LineTable.cpp
+//! @brief The definition of unit tests for mapping assembled instructions
+//! back to the source code lines which produced them.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Header File Includes
+////////////////////////////////////////////////////////////////////////////////
+#include <gtest/gtest.h>
+
+#include "TestTools.hpp"
+
+namespace Mo {
+namespace Asm {
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+// Unit Tests
+////////////////////////////////////////////////////////////////////////////////
+GTEST_TEST(LineTable, MapsInstructionsToLines)
+{
+    Messages log;
+    Ag::String source = "MOV R0,#1\n"
+        "EQUD 0xCAFEBABE\n"
+        ".loop\n"
+        "SUBS R0,R0,#1\n"
+        "BNE done\n"
+        "B loop\n"
+        ".done\n"
+        "MOV PC,R14\n";
+    ObjectCode code = assembleText(source, getDefaultOptions(), log);
+
+    ASSERT_FALSE(code.isEmpty());
+    EXPECT_FALSE(log.hasErrors());
+
+    // Data directives and labels should not be mapped, forward references
+    // assembled on the final pass should be.
+    const LineTable &lines = code.getLineTable();
+    ASSERT_EQ(lines.size(), 5u);
+
+    const uint32_t expectedAddrs[] = { 0x8000, 0x8008, 0x800C, 0x8010, 0x8014 };
+    const int expectedLines[] = { 1, 4, 5, 6, 8 };
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(lines[i].Address, expectedAddrs[i]);
+        EXPECT_EQ(lines[i].Size, 4u);
+        EXPECT_EQ(lines[i].LineNo, expectedLines[i]);
+        EXPECT_STREQ(lines[i].FileName.getUtf8Bytes(), "(buffer)");
+    }
+}
+
+GTEST_TEST(LineTable, EmptyWithoutInstructions)
+{
+    Messages log;
+    Ag::String source = "EQUD 0xCAFEBABE\n"
+        "EQUS 'Hello World!',13,10\n";
+    ObjectCode code = assembleText(source, getDefaultOptions(), log);
+
+    ASSERT_FALSE(code.isEmpty());
+    EXPECT_FALSE(log.hasErrors());
+    EXPECT_TRUE(code.getLineTable().empty());
+}
+
+} // Anonymous namespace
+
+}} // namespace Mo::Asm
+////////////////////////////////////////////////////////////////////////////////
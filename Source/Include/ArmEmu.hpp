@@ -18,10 +18,27 @@
 #include "ArmEmu/AddressMap.hpp"
 #include "ArmEmu/GuestEventQueue.hpp"
 #include "ArmEmu/SystemContext.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+#include "ArmEmu/ExecutionCounters.hpp"
+#include "ArmEmu/GuestProfiler.hpp"
+#include "ArmEmu/ExecutionTrace.hpp"
+#include "ArmEmu/GuestCoverage.hpp"
+#include "ArmEmu/SystemMetrics.hpp"
 #include "ArmEmu/IOC.hpp"
 #include "ArmEmu/VIDC10.hpp"
+#include "ArmEmu/FrameConverter.hpp"
+#include "ArmEmu/VideoOutput.hpp"
+#include "ArmEmu/SharedFrameBuffer.hpp"
+#include "ArmEmu/SoundOutput.hpp"
+#include "ArmEmu/DiscImage.hpp"
+#include "ArmEmu/WD1772.hpp"
+#include "ArmEmu/HardDiscImage.hpp"
+#include "ArmEmu/IdeController.hpp"
+#include "ArmEmu/HostFileSystem.hpp"
+#include "ArmEmu/HleHooks.hpp"
 #include "ArmEmu/ArmSystem.hpp"
 #include "ArmEmu/ArmSystemBuilder.hpp"
+#include "ArmEmu/RunAheadController.hpp"
 
 #endif // Header guard
 ////////////////////////////////////////////////////////////////////////////////
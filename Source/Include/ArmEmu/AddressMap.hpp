@@ -39,6 +39,8 @@ enum class RegionType : uint8_t
 ////////////////////////////////////////////////////////////////////////////////
 class ConnectionContext;
 class SystemContext;
+class SystemSnapshot;
+class SnapshotReader;
 using SystemContextPtr = SystemContext *;
 
 //! @brief Describes a mapping of a virtual address to a physical address.
@@ -97,6 +99,18 @@ struct IHardwareDevice
     //! @param[in] context An object which provides useful information and
     //! services before the emulator starts.
     virtual void connect(const ConnectionContext &context) = 0;
+
+    //! @brief Appends the state of the device which changes as the emulated
+    //! system runs to a snapshot.
+    //! @param[in] snapshot The snapshot to append state to.
+    //! @note The base implementation captures nothing, which is correct for
+    //! devices with no state or whose state is owned by the host.
+    virtual void captureState(SystemSnapshot &snapshot) const;
+
+    //! @brief Restores state previously written by captureState().
+    //! @param[in] reader The object to read state from, positioned where
+    //! captureState() started writing.
+    virtual void restoreState(SnapshotReader &reader);
 };
 
 //! @brief An alias for a pointer to an implementation of the
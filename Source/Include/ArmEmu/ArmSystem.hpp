@@ -116,10 +116,42 @@ enum class MemoryAccess : uint8_t
     ReadWrite = 0x03,
 };
 
+//! @brief Flags identifying outputs of an emulated system which can be held
+//! back from the host, see IArmSystem::setHeldOutputs().
+struct HeldOutput
+{
+    //! @brief All output reaches the host as normal.
+    static constexpr uint8_t None = 0x00;
+
+    //! @brief Video frames aren't published at vertical sync.
+    static constexpr uint8_t Video = 0x01;
+
+    //! @brief Sound samples aren't queued for the host, so the emulated
+    //! system isn't paced by the host audio device either.
+    static constexpr uint8_t Sound = 0x02;
+
+    //! @brief Sectors written to disc images and changes made to files by
+    //! the host filing system are discarded.
+    static constexpr uint8_t Storage = 0x04;
+
+    //! @brief A mask which covers every output which can be held.
+    static constexpr uint8_t All = 0x07;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
 struct GuestEvent;
+class ExecutionCounterTable;
+class ExecutionTrace;
+class GuestCoverageMap;
+class GuestProfiler;
+class HleHookTable;
+class IGuestEventListener;
+class SystemMetricsPublisher;
+class SoundSampleRing;
+class SystemSnapshot;
+class VideoFrameExchange;
 
 //! @brief An abstract interface to a component which emulates a 32-bit ARM
 //! processor core and associated devices.
@@ -164,12 +196,95 @@ public:
     virtual bool logicalToPhysicalAddress(uint32_t logicalAddr,
                                           PageMapping &mapping) const = 0;
 
+    //! @brief Determines whether real time pacing has been overridden to
+    //! allow the emulated system to run as fast as the host allows.
+    virtual bool isTurboEnabled() const = 0;
+
+    //! @brief Overrides real time pacing, if configured, to allow the
+    //! emulated system to run as fast as the host allows.
+    //! @param[in] isEnabled True to run flat out, false to run at the
+    //! configured processor speed.
+    //! @note This member function can be called from any thread.
+    virtual void setTurbo(bool isEnabled) = 0;
+
+    //! @brief Gets the outputs currently held back from the host.
+    //! @return A combination of HeldOutput flags.
+    virtual uint8_t getHeldOutputs() const = 0;
+
+    //! @brief Holds outputs back from the host so that running frames which
+    //! will be rolled back by restoreState() has no lasting side effects,
+    //! see RunAheadController.
+    //! @param[in] outputs A combination of HeldOutput flags, or
+    //! HeldOutput::None to return to normal.
+    //! @note While storage is held, the guest reads what was on disc before
+    //! any writes it made. This must only be called from the thread which
+    //! calls run().
+    virtual void setHeldOutputs(uint8_t outputs) = 0;
+
+    //! @brief Gets the object which samples the guest call stack.
+    //! @return The profiler or nullptr if the system was built without
+    //! profiling support, see Options::setGuestProfiling().
+    virtual GuestProfiler *getProfiler() = 0;
+
+    //! @brief Gets the object which counts the instructions executed at
+    //! each address.
+    //! @return The counters or nullptr if the system was built without
+    //! profiling support, see Options::setGuestProfiling().
+    virtual ExecutionCounterTable *getExecutionCounters() = 0;
+
+    //! @brief Gets the object which records the address of every
+    //! instruction executed.
+    //! @return The coverage map or nullptr if the system was built without
+    //! coverage support, see Options::setGuestCoverage().
+    virtual GuestCoverageMap *getCoverage() = 0;
+
+    //! @brief Gets the object which transfers a trace of the instructions
+    //! executed to a consumer on another thread.
+    //! @return The trace or nullptr if the system was built without
+    //! tracing support, see Options::setExecutionTracing().
+    virtual ExecutionTrace *getExecutionTrace() = 0;
+
+    //! @brief Gets the object which publishes periodic measurements of the
+    //! health of the system, such as its speed and interrupt rates.
+    //! @note The metrics can be read from any thread without locking, see
+    //! MetricsExporter to write them to a file or socket.
+    virtual const SystemMetricsPublisher &getMetrics() const = 0;
+
+    //! @brief Gets the object which hands snapshots of the emulated display
+    //! to a render thread at each vertical sync.
+    //! @return The exchange or nullptr if the system has no video hardware or
+    //! video output is disabled, see Options::setVideoOutput().
+    //! @note A HostMessageID::VideoFrameReady message is posted each time a
+    //! snapshot is published, see VideoRenderThread.
+    virtual VideoFrameExchange *getVideoFrames() = 0;
+
+    //! @brief Gets the ring which queues sound samples played by the emulated
+    //! system for a host audio thread.
+    //! @return The ring or nullptr if the system has no sound hardware or
+    //! sound output is disabled, see Options::setSoundOutput().
+    //! @note A HostMessageID::SoundSamplesReady message is posted each time
+    //! samples are queued, see WaveFileWriter.
+    virtual SoundSampleRing *getSoundSamples() = 0;
+
+    //! @brief Gets the table of host functions which replace selected guest
+    //! SWIs and routines.
+    //! @note Hooks must only be added while the system isn't running, but
+    //! can be enabled, disabled and their statistics read at any time.
+    virtual HleHookTable &getHleHooks() = 0;
+
     // Operations
     //! @brief Runs the processor until a host or debug interrupt occurs.
     //! @return Metrics summarising how many instructions were executed and
     //! how many simulated processor cycles they took.
     virtual ExecutionMetrics run() = 0;
 
+    //! @brief Runs the processor until a period of emulated time has elapsed
+    //! or a host or debug interrupt occurs.
+    //! @param[in] microseconds The period of emulated time to run for.
+    //! @return Metrics summarising the run, with a result of TimeLimit if
+    //! the period elapsed.
+    virtual ExecutionMetrics runFor(uint32_t microseconds) = 0;
+
     //! @brief Runs the processor for a single instruction.
     //! @return Metrics summarising how many instructions were executed
     //! (theoretically 1) and how many simulated processor cycles they took.
@@ -179,6 +294,15 @@ public:
     //! return.
     virtual void raiseHostInterrupt() = 0;
 
+    //! @brief Informs the emulated hardware that the host has written
+    //! directly to a run of physical memory, so that state derived from it,
+    //! such as the display, is brought up to date.
+    //! @param[in] physicalAddr The physical address of the first byte written.
+    //! @param[in] length The count of bytes written.
+    //! @note writeToPhysicalAddress() and writeToLogicalAddress() call this
+    //! on behalf of the caller.
+    virtual void markHostWrite(uint32_t physicalAddr, uint32_t length) = 0;
+
     //! @brief Attempts to extract a message from the system's external
     //! event queue.
     //! @param[out] next Receives the next message if one is available.
@@ -187,6 +311,49 @@ public:
     //! @note This and only this member function can be called from a separate
     //! thread from that which the processor is running in.
     virtual bool tryGetNextMessage(GuestEvent &next) = 0;
+
+    //! @brief Attempts to extract a batch of messages from the system's
+    //! external event queue in a single call.
+    //! @param[out] messages An array to receive the messages.
+    //! @param[in] maxCount The count of elements in messages.
+    //! @return The count of messages extracted, 0 if none were available.
+    //! @note As with tryGetNextMessage(), this can be called from a thread
+    //! other than that which the processor is running in.
+    virtual size_t tryGetNextMessages(GuestEvent *messages, size_t maxCount) = 0;
+
+    //! @brief Sets an object to be notified when messages are posted to the
+    //! system's external event queue, so that it need not be polled.
+    //! @param[in] listener The object to notify, or nullptr to rely on
+    //! polling tryGetNextMessage().
+    //! @note This should only be called when the processor isn't running.
+    virtual void setEventListener(IGuestEventListener *listener) = 0;
+
+    //! @brief Posts a message to the system's external event queue on behalf
+    //! of the thread which runs the processor.
+    //! @param[in] type The type of the message, see HostMessageID.
+    //! @param[in] data1 The first item of message-specific data.
+    //! @param[in] data2 The second item of message-specific data.
+    //! @retval true The message was queued.
+    //! @retval false The queue was full.
+    //! @note This must only be called from the thread which calls run(), so
+    //! that the queue keeps a single producer.
+    virtual bool postMessageToHost(uint32_t type, uintptr_t data1, uintptr_t data2) = 0;
+
+    //! @brief Captures the complete state of the emulated system in
+    //! host memory.
+    //! @param[out] snapshot Receives the state, replacing any already held.
+    //! @note This must only be called when the processor isn't running and
+    //! from the thread which calls run().
+    virtual void captureState(SystemSnapshot &snapshot) const = 0;
+
+    //! @brief Returns the emulated system to a state previously captured.
+    //! @param[in] snapshot The state captured by the same object.
+    //! @retval true The state was restored.
+    //! @retval false The snapshot was captured from a different system or
+    //! was incomplete.
+    //! @note This must only be called when the processor isn't running and
+    //! from the thread which calls run().
+    virtual bool restoreState(const SystemSnapshot &snapshot) = 0;
 };
 
 //! @brief A custom deleter for IArmSystem implementations.
@@ -32,6 +32,9 @@ namespace Arm {
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
+class IdeController;
+class WD1772;
+
 //! @brief An object used to incrementally construct an implementation of the
 //! IArmSystem interface representing an emulated ARM-based system.
 class ArmSystemBuilder
@@ -48,6 +51,8 @@ public:
     void addDevice(IHardwareDeviceUPtr &&device);
     void addMapping(IAddressRegionPtr region, uint32_t baseAddr, MemoryAccess access);
     void addMapping(IAddressRegionUPtr &&region, uint32_t baseAddr, MemoryAccess access);
+    WD1772 *addFloppyDiscController();
+    IdeController *addIdeController();
     void reset(const Options &baseOptions);
     IArmSystemUPtr createSystem();
 private:
@@ -0,0 +1,105 @@
+//! @file ArmEmu/DiscImage.hpp
+//! @brief The declaration of an object which maps a floppy disc image file
+//! into memory and tracks the sectors written to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_DISC_IMAGE_HPP__
+#define __ARM_EMU_DISC_IMAGE_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes the physical layout of a double density floppy disc.
+struct DiscGeometry
+{
+    //! @brief The count of tracks on each side of the disc.
+    uint16_t TrackCount;
+
+    //! @brief The count of sides, 1 or 2.
+    uint8_t SideCount;
+
+    //! @brief The count of sectors on each track, numbered from 0.
+    uint8_t SectorsPerTrack;
+
+    //! @brief The count of bytes in each sector, 128 to 1024.
+    uint16_t SectorSize;
+
+    DiscGeometry();
+    DiscGeometry(uint16_t trackCount, uint8_t sideCount,
+                 uint8_t sectorsPerTrack, uint16_t sectorSize);
+
+    bool isValid() const;
+    uint32_t getSectorCount() const;
+    uint32_t getTrackSize() const;
+    uint32_t getImageSize() const;
+    uint8_t getSectorSizeCode() const;
+
+    static bool tryDeduce(uint64_t imageSize, DiscGeometry &geometry);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which maps an ADFS floppy disc image file directly into
+//! memory so that sectors can be transferred without file I/O.
+//! @details The geometry is deduced from the size of the file. Tracks of
+//! double sided discs are interleaved, side 0 then side 1. Sectors written
+//! are changed in place in the shared mapping and recorded so that
+//! flush() only writes back the pages which changed.
+class DiscImage
+{
+public:
+    // Construction/Destruction
+    DiscImage();
+    DiscImage(const DiscImage &) = delete;
+    DiscImage &operator=(const DiscImage &) = delete;
+    ~DiscImage();
+
+    // Accessors
+    bool isOpen() const;
+    bool isWriteProtected() const;
+    const std::string &getFileName() const;
+    const DiscGeometry &getGeometry() const;
+    uint32_t getDirtySectorCount() const;
+    bool isSectorDirty(uint16_t track, uint8_t side, uint8_t sector) const;
+    const uint8_t *getSector(uint16_t track, uint8_t side, uint8_t sector) const;
+    uint8_t *getWritableSector(uint16_t track, uint8_t side, uint8_t sector);
+
+    // Operations
+    bool tryOpen(const std::string &fileName, bool isWriteProtected,
+                 std::string &error);
+    uint32_t flush();
+    void close();
+private:
+    // Internal Functions
+    int32_t getSectorIndex(uint16_t track, uint8_t side, uint8_t sector) const;
+
+    // Internal Fields
+    std::string _fileName;
+    std::vector<uint64_t> _dirtySectors;
+    DiscGeometry _geometry;
+    uint8_t *_data;
+    size_t _size;
+    uint32_t _dirtySectorCount;
+    bool _isWriteProtected;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -161,6 +161,28 @@ public:
     void setProcessorVariant(ProcessorModel processor);
     uint16_t getProcessorSpeedMHz() const;
     void setProcessorSpeedMHz(uint16_t clockFreqMHz);
+    bool isRealTimePacingEnabled() const;
+    void setRealTimePacing(bool isEnabled);
+    bool isGuestProfilingEnabled() const;
+    void setGuestProfiling(bool isEnabled);
+    bool isInstrumentationEnabled() const;
+    void setInstrumentation(bool isEnabled);
+    bool isGuestCoverageEnabled() const;
+    void setGuestCoverage(bool isEnabled);
+    bool isExecutionTracingEnabled() const;
+    void setExecutionTracing(bool isEnabled);
+    bool isCounterCoProcessorEnabled() const;
+    void setCounterCoProcessor(bool isEnabled);
+    bool isVideoOutputEnabled() const;
+    void setVideoOutput(bool isEnabled);
+    bool isScanlineTimingEnabled() const;
+    void setScanlineTiming(bool isEnabled);
+    bool isSoundOutputEnabled() const;
+    void setSoundOutput(bool isEnabled);
+    bool isSoundPacingEnabled() const;
+    void setSoundPacing(bool isEnabled);
+    bool isFastDiscEnabled() const;
+    void setFastDisc(bool isEnabled);
     uint32_t getRamSizeKb() const;
     void setRamSizeKb(uint32_t ramSizeKb);
     uint32_t getVideoRamSizeKb() const;
@@ -181,6 +203,8 @@ public:
     void setSystemRom(SystemROMPreset presetRom);
     Ag::Fs::Path getRomPath() const;
     void setCustomRom(const Ag::Fs::Path &romPath);
+    const Ag::Fs::Path &getHostFileSystemRoot() const;
+    void setHostFileSystemRoot(const Ag::Fs::Path &rootPath);
 
     // Operations
     bool validate(Ag::String &error) const;
@@ -195,6 +219,7 @@ private:
 
     // Internal Fields
     Ag::Fs::Path _customRomPath;
+    Ag::Fs::Path _hostFsRootPath;
     SystemModel _model;
     ProcessorModel _processor;
     uint16_t _processorSpeedMHz;
@@ -207,6 +232,17 @@ private:
     JoystickInterface _joystickType;
     uint8_t _joystickCount;
     SystemROMPreset _systemRom;
+    bool _isRealTimePacingEnabled;
+    bool _isGuestProfilingEnabled;
+    bool _isInstrumentationEnabled;
+    bool _isGuestCoverageEnabled;
+    bool _isExecutionTracingEnabled;
+    bool _isCounterCoProcessorEnabled;
+    bool _isVideoOutputEnabled;
+    bool _isScanlineTimingEnabled;
+    bool _isSoundOutputEnabled;
+    bool _isSoundPacingEnabled;
+    bool _isFastDiscEnabled;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,133 @@
+//! @file ArmEmu/ExecutionCounters.hpp
+//! @brief The declaration of an object which counts how many times each
+//! instruction in the guest address space has been executed.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_EXECUTION_COUNTERS_HPP__
+#define __ARM_EMU_EXECUTION_COUNTERS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The counts accumulated for a single instruction address.
+struct ExecutionCount
+{
+    //! @brief The count of times the instruction was executed.
+    uint64_t Executions;
+
+    //! @brief The total count of processor cycles spent executing the
+    //! instruction.
+    uint64_t Cycles;
+};
+
+//! @brief Describes a run of consecutive instructions which were all
+//! executed the same number of times, i.e. a basic block.
+struct HotBlock
+{
+    //! @brief The logical address of the first instruction in the block.
+    uint32_t StartAddr;
+
+    //! @brief The logical address immediately after the last instruction.
+    uint32_t EndAddr;
+
+    //! @brief The count of times each instruction in the block was executed.
+    uint64_t Executions;
+
+    //! @brief The total count of processor cycles spent in the block.
+    uint64_t Cycles;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which holds exact execution and cycle counts for every
+//! word-aligned address from which an instruction has been executed.
+//! @details Counters are stored in 4 KB pages which are only allocated when
+//! code within them is first executed, so the cost of an update is an index
+//! into a page table. Counts are keyed on logical address. Counting can be
+//! enabled from any thread, but counts should only be read while the system
+//! isn't running.
+class ExecutionCounterTable
+{
+public:
+    // Public Constants
+    //! @brief The power of 2 size of a page of counters in guest bytes.
+    static constexpr uint32_t PageShift = 12;
+
+    //! @brief The count of instruction words covered by a page of counters.
+    static constexpr uint32_t WordsPerPage = 1u << (PageShift - 2);
+
+    // Construction/Destruction
+    ExecutionCounterTable();
+    ~ExecutionCounterTable() = default;
+
+    // Accessors
+    bool isEnabled() const;
+    void setEnabled(bool isEnabled);
+    bool isEmpty() const;
+    size_t getPageCount() const;
+    bool tryGetCount(uint32_t address, ExecutionCount &count) const;
+    uint64_t getMaxExecutions() const;
+
+    // Operations
+    void clear();
+    std::vector<HotBlock> findHottestBlocks(size_t maxCount) const;
+
+    //! @brief Accounts for the execution of an instruction.
+    //! @param[in] address The logical address of the instruction.
+    //! @param[in] cycleCount The count of cycles the instruction took.
+    void record(uint32_t address, uint32_t cycleCount)
+    {
+        const uint32_t pageIndex = address >> PageShift;
+        Page *page = (pageIndex < _pages.size()) ? _pages[pageIndex].get() :
+                                                   nullptr;
+
+        if (page == nullptr)
+        {
+            page = allocatePage(pageIndex);
+        }
+
+        ExecutionCount &count = page->Counts[(address >> 2) & (WordsPerPage - 1)];
+        ++count.Executions;
+        count.Cycles += cycleCount;
+    }
+private:
+    // Internal Types
+    //! @brief A page of counters covering a contiguous range of addresses.
+    struct Page
+    {
+        ExecutionCount Counts[WordsPerPage];
+    };
+
+    using PageUPtr = std::unique_ptr<Page>;
+
+    // Internal Functions
+    Page *allocatePage(uint32_t pageIndex);
+
+    // Internal Fields
+    std::vector<PageUPtr> _pages;
+    size_t _pageCount;
+    std::atomic_bool _isEnabled;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
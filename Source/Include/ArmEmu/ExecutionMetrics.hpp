@@ -14,14 +14,112 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
+#include <cstddef>
+#include <cstdint>
+
 #include "Ag/Core/Timer.hpp"
 
 namespace Mo {
 namespace Arm {
 
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies broad classes of instruction which have distinct costs
+//! to emulate.
+enum class InstructionClass : uint8_t
+{
+    //! @brief A data processing instruction with an immediate operand 2.
+    AluImmediate,
+
+    //! @brief A data processing instruction with a register operand 2,
+    //! possibly shifted by a constant.
+    AluRegister,
+
+    //! @brief A data processing instruction with a register operand 2
+    //! shifted by an amount held in another register.
+    AluShiftByRegister,
+
+    //! @brief A MUL or MLA instruction.
+    Multiply,
+
+    //! @brief A single register LDR or STR instruction.
+    SingleTransfer,
+
+    //! @brief An atomic SWP instruction.
+    Swap,
+
+    //! @brief An LDM or STM instruction.
+    MultiTransfer,
+
+    //! @brief A B or BL instruction.
+    Branch,
+
+    //! @brief A SWI instruction.
+    SoftwareInterrupt,
+
+    //! @brief A co-processor data operation, register or data transfer.
+    CoProcessor,
+
+    //! @brief An instruction which wasn't recognised by the classifier.
+    Other,
+
+    //! @brief An instruction which was skipped because its condition
+    //! wasn't met.
+    ConditionFailed,
+
+    Max,
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which describes the mix of instructions and events which
+//! occurred during a run of an instrumented instruction pipeline.
+//! @details The breakdown is only populated by systems built with
+//! instrumentation, see Options::setInstrumentation(), otherwise all counts
+//! remain zero.
+struct ExecutionBreakdown
+{
+    // Public Constants
+    //! @brief The count of instruction classes.
+    static constexpr size_t ClassCount = static_cast<size_t>(InstructionClass::Max);
+
+    //! @brief The maximum count of registers an LDM or STM can transfer.
+    static constexpr size_t MaxTransferRegisters = 16;
+
+    // Public Fields
+    //! @brief The count of instructions executed in each class, indexed by
+    //! InstructionClass.
+    uint64_t ClassCounts[ClassCount];
+
+    //! @brief The count of LDM/STM instructions executed indexed by the
+    //! count of registers they transferred.
+    uint64_t MultiTransferSizes[MaxTransferRegisters + 1];
+
+    //! @brief The count of times the instruction pipeline was flushed.
+    uint64_t PipelineFlushes;
+
+    //! @brief The count of times the processor changed mode.
+    uint64_t ModeChanges;
+
+    //! @brief The count of reads and writes passed to memory mapped devices.
+    uint64_t MmioAccesses;
+
+    // Construction
+    ExecutionBreakdown();
+
+    // Accessors
+    bool isEmpty() const;
+    uint64_t getClassCount(InstructionClass instructionClass) const;
+    uint64_t getInstructionCount() const;
+    static const char *getClassName(InstructionClass instructionClass);
+
+    // Operations
+    void reset();
+    ExecutionBreakdown &operator+=(const ExecutionBreakdown &rhs);
+};
+
 //! @brief An object which describes the performance of the run of the
 //! emulated instruction pipeline.
 struct ExecutionMetrics
@@ -43,6 +141,10 @@ struct ExecutionMetrics
         //! @brief The execSingleStep() function exited as expected.
         SingleStep,
 
+        //! @brief The runFor() function exited because the requested period
+        //! of emulated time had elapsed.
+        TimeLimit,
+
         //! @brief An unexpected failure occurred from within the emulator.
         Failure,
     };
@@ -58,16 +160,26 @@ struct ExecutionMetrics
     //! High Resolution Monotonic timer.
     Ag::MonotonicTicks ElapsedTime;
 
+    //! @brief The time in nanoseconds within ElapsedTime that the emulation
+    //! thread spent sleeping to keep to real time, rather than occupying a
+    //! host core.
+    uint64_t HostIdleTimeNs;
+
     //! @brief Specifies the result of the last call to exec() or
     //! execSingleStep() IArmSystem member functions.
     Result ExecResult;
 
+    //! @brief The mix of instructions executed, only populated by systems
+    //! built with instrumentation.
+    ExecutionBreakdown Breakdown;
+
     // Construction
     ExecutionMetrics();
 
     // Accessors
     double calculateClockFrequency() const;
     double calculateSpeedInMIPS() const;
+    double calculateHostUtilisation() const;
 
     // Operations
     void reset();
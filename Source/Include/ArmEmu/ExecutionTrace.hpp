@@ -0,0 +1,269 @@
+//! @file ArmEmu/ExecutionTrace.hpp
+//! @brief The declaration of objects which capture, store and decode a
+//! compact trace of the instructions executed by an emulated processor.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_EXECUTION_TRACE_HPP__
+#define __ARM_EMU_EXECUTION_TRACE_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <atomic>
+#include <fstream>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ArmEmu/ArmSystem.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Describes the layout of the records in an execution trace.
+//! @details Each record is a whole number of 32-bit words. It starts with
+//! the instruction word and a header word, followed by the optional words
+//! the header announces, in this order:
+//! - The address of the instruction, if it didn't follow the previous one.
+//! - The PSR after the instruction, if it changed.
+//! - The value of each of R0-R14 which changed, lowest register first.
+//!
+//! The length of a record can be calculated from its header alone, so a
+//! reader can step over records without decoding them. A key frame record
+//! contains the address, PSR and all registers, so a reader can start
+//! decoding from it.
+struct TraceFormat
+{
+    //! @brief The first word of a trace file, 'MOTR' in little-endian order.
+    static constexpr uint32_t FileSignature = 0x52544F4D;
+
+    //! @brief The second word of a trace file.
+    static constexpr uint32_t FileVersion = 1;
+
+    //! @brief The header bits marking which of R0-R14 follow.
+    static constexpr uint32_t ChangedRegsMask = 0x7FFF;
+
+    //! @brief The header bit set if the instruction address follows.
+    static constexpr uint32_t ExplicitAddress = 0x8000;
+
+    //! @brief The position of the instruction cycle count in the header.
+    static constexpr uint8_t CycleCountShift = 16;
+
+    //! @brief The mask of the cycle count once shifted, counts saturate.
+    static constexpr uint32_t CycleCountMask = 0xFF;
+
+    //! @brief The header bit set if the PSR follows.
+    static constexpr uint32_t PsrFollows = 0x01000000;
+
+    //! @brief The header bit set if the record is a key frame.
+    static constexpr uint32_t KeyFrame = 0x02000000;
+
+    //! @brief The position in the header of the mode the processor was in
+    //! when the instruction executed.
+    static constexpr uint8_t ModeShift = 26;
+
+    //! @brief The mask of the processor mode once shifted.
+    static constexpr uint32_t ModeMask = 0x1F;
+
+    //! @brief The maximum size of a record in words.
+    static constexpr size_t MaxRecordWords = 19;
+};
+
+//! @brief The state of the processor after executing a traced instruction.
+struct TraceRecord
+{
+    //! @brief The logical address of the instruction.
+    uint32_t Address;
+
+    //! @brief The instruction word.
+    uint32_t Instruction;
+
+    //! @brief The PSR after the instruction executed.
+    uint32_t PSR;
+
+    //! @brief The values of R0-R14 after the instruction executed.
+    uint32_t Regs[15];
+
+    //! @brief A bit mask of the registers in Regs which were changed by the
+    //! instruction, or set for all registers in a key frame.
+    uint16_t ChangedRegs;
+
+    //! @brief The count of processor cycles the instruction took, up to 255.
+    uint8_t Cycles;
+
+    //! @brief The mode the processor was in when the instruction executed.
+    ProcessorMode Mode;
+};
+
+//! @brief Selects the records of an execution trace to report.
+struct TraceFilter
+{
+    //! @brief The lowest instruction address to accept.
+    uint32_t MinAddress;
+
+    //! @brief The highest instruction address to accept.
+    uint32_t MaxAddress;
+
+    //! @brief A bit mask with bit (1 << ProcessorMode) set for each mode
+    //! in which instructions are accepted, 0 to accept all modes.
+    uint32_t ModeMask;
+
+    TraceFilter();
+
+    void addMode(ProcessorMode mode);
+    bool matches(const TraceRecord &record) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A single-producer, single-consumer ring buffer of 32-bit words
+//! which can be written and read concurrently without locks.
+class ExecutionTraceRing
+{
+public:
+    // Public Constants
+    //! @brief The default capacity, in words, 4 MB.
+    static constexpr size_t DefaultCapacity = size_t(1) << 20;
+
+    // Construction/Destruction
+    ExecutionTraceRing(size_t capacity = DefaultCapacity);
+    ~ExecutionTraceRing() = default;
+
+    // Accessors
+    size_t getCapacity() const;
+    size_t getAvailable() const;
+
+    // Operations
+    bool tryWrite(const uint32_t *words, size_t count);
+    size_t read(uint32_t *buffer, size_t maxCount);
+private:
+    // Internal Fields
+    std::unique_ptr<uint32_t[]> _words;
+    size_t _mask;
+
+    // Keep the indices on separate cache lines so that the producer and
+    // consumer threads don't contend.
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+//! @brief An object which holds the instruction trace of an emulated system
+//! while it is being transferred from the emulator thread to a consumer.
+//! @details Records are written by the execution unit of a system built with
+//! tracing support, see Options::setExecutionTracing(). If the consumer
+//! doesn't keep up, records are dropped and the next one written is a key
+//! frame. Tracing can be enabled from any thread.
+class ExecutionTrace
+{
+public:
+    // Construction/Destruction
+    ExecutionTrace(size_t capacity = ExecutionTraceRing::DefaultCapacity);
+    ~ExecutionTrace() = default;
+
+    // Accessors
+    bool isEnabled() const;
+    void setEnabled(bool isEnabled);
+    uint64_t getRecordCount() const;
+    uint64_t getDroppedCount() const;
+    ExecutionTraceRing &getRing();
+
+    // Operations
+    void requestKeyFrame();
+    bool tryAppend(const uint32_t *words, size_t count);
+
+    //! @brief Determines if a key frame was requested since the last call,
+    //! for example because a consumer discarded the records before it.
+    bool tryTakeKeyFrameRequest()
+    {
+        return _isKeyFrameRequested.load(std::memory_order_relaxed) &&
+               _isKeyFrameRequested.exchange(false, std::memory_order_relaxed);
+    }
+private:
+    // Internal Fields
+    ExecutionTraceRing _ring;
+    std::atomic_uint64_t _recordCount;
+    std::atomic_uint64_t _droppedCount;
+    std::atomic_bool _isEnabled;
+    std::atomic_bool _isKeyFrameRequested;
+};
+
+//! @brief An object which drains an execution trace to a file on a
+//! background thread.
+class ExecutionTraceWriter
+{
+public:
+    // Construction/Destruction
+    ExecutionTraceWriter();
+    ~ExecutionTraceWriter();
+
+    // Accessors
+    bool isRunning() const;
+
+    // Operations
+    bool tryStart(ExecutionTrace &trace, const std::string &fileName,
+                  std::string &error);
+    void stop();
+
+    static void writeFileHeader(std::ostream &output);
+private:
+    // Internal Functions
+    void run();
+    void drain();
+
+    // Internal Fields
+    std::ofstream _output;
+    std::thread _thread;
+    std::vector<uint32_t> _buffer;
+    ExecutionTrace *_trace;
+    std::atomic_bool _isStopping;
+};
+
+//! @brief An object which decodes a stream of execution trace words into
+//! records.
+//! @details Words can be appended in arbitrary sized chunks, records split
+//! across chunks are decoded once complete. Records before the first key
+//! frame are skipped, as the state of the processor is unknown.
+class ExecutionTraceDecoder
+{
+public:
+    // Construction/Destruction
+    ExecutionTraceDecoder();
+    ~ExecutionTraceDecoder() = default;
+
+    // Accessors
+    uint64_t getDecodedCount() const;
+    uint64_t getSkippedCount() const;
+
+    // Operations
+    void reset();
+    void append(const uint32_t *words, size_t count);
+    bool tryDecodeNext(TraceRecord &record);
+
+    static bool tryReadFileHeader(std::istream &input, std::string &error);
+private:
+    // Internal Fields
+    std::vector<uint32_t> _pending;
+    size_t _position;
+    uint64_t _decodedCount;
+    uint64_t _skippedCount;
+    TraceRecord _state;
+    bool _isSynchronised;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,97 @@
+//! @file ArmEmu/FrameConverter.hpp
+//! @brief The declaration of an object which converts palettised VIDC video
+//! memory into host pixels.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_FRAME_CONVERTER_HPP__
+#define __ARM_EMU_FRAME_CONVERTER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include "VIDC10.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the sets of host vector instructions pixel conversion
+//! can be performed with.
+enum class SimdLevel : uint8_t
+{
+    //! @brief A portable reference implementation which converts one pixel
+    //! at a time.
+    Scalar,
+
+    //! @brief 128-bit x86 vector instructions.
+    SSE2,
+
+    //! @brief 256-bit x86 vector instructions, including gathers.
+    AVX2,
+
+    Max,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which converts 1, 2, 4 and 8 bpp palettised video memory
+//! into 32-bit host pixels as produced by VidcPalette::toHostColour().
+//! @details Vector implementations expand each byte of video memory into
+//! several host pixels using tables rebuilt whenever the palette changes.
+class FrameConverter
+{
+public:
+    // Construction/Destruction
+    FrameConverter();
+    FrameConverter(SimdLevel level);
+    ~FrameConverter() = default;
+
+    // Accessors
+    SimdLevel getSimdLevel() const;
+    static SimdLevel getSupportedSimdLevel();
+    static const char *getSimdLevelName(SimdLevel level);
+    const VidcPalette &getPalette() const;
+
+    // Operations
+    bool setPalette(const VidcPalette &palette);
+    void convertPixels(const uint8_t *source, uint32_t *target,
+                       uint32_t pixelCount, uint8_t bitsPerPixelPow2) const;
+    void renderLine(const VidcTiming &timing, const uint8_t *source,
+                    const uint8_t *cursor, uint32_t *target) const;
+private:
+    // Internal Types
+    using ConvertFn = void(*)(const uint32_t *table, const uint8_t *source,
+                              uint32_t *target, uint32_t byteCount);
+
+    // Internal Constants
+    static constexpr uint8_t ModeCount = 4;
+    static constexpr size_t TableSize = 256 * (8 + 4 + 2 + 1);
+
+    // Internal Functions
+    void rebuildTables();
+
+    // Internal Fields
+    uint32_t _tables[TableSize];
+    uint32_t _hostPalette[VidcPalette::ColourCount];
+    uint32_t _hostCursor[VidcPalette::CursorColourCount];
+    VidcPalette _palette;
+    const uint32_t *_kernelTables[ModeCount];
+    ConvertFn _kernels[ModeCount];
+    uint32_t _hostBorder;
+    SimdLevel _level;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,136 @@
+//! @file ArmEmu/GuestCoverage.hpp
+//! @brief The declaration of objects which record which guest instructions
+//! have been executed and report the coverage against guest source code.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_GUEST_COVERAGE_HPP__
+#define __ARM_EMU_GUEST_COVERAGE_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which holds one bit for every word-aligned address from
+//! which an instruction has been executed.
+//! @details Bits are stored in pages which are only allocated when code
+//! within them is first executed, so recording an instruction costs an index
+//! into a page table and an OR. Bits are keyed on logical address and should
+//! only be read while the system isn't running.
+class GuestCoverageMap
+{
+public:
+    // Public Constants
+    //! @brief The power of 2 size of the guest address range covered by a
+    //! page of bits.
+    static constexpr uint32_t PageShift = 16;
+
+    //! @brief The count of instruction words covered by a page of bits.
+    static constexpr uint32_t WordsPerPage = 1u << (PageShift - 2);
+
+    // Construction/Destruction
+    GuestCoverageMap();
+    ~GuestCoverageMap() = default;
+
+    // Accessors
+    bool isEmpty() const;
+    size_t getPageCount() const;
+    bool isCovered(uint32_t address) const;
+    bool isRangeCovered(uint32_t address, uint32_t size) const;
+    size_t getCoveredWordCount() const;
+
+    // Operations
+    void clear();
+    void merge(const GuestCoverageMap &rhs);
+
+    //! @brief Marks an instruction as executed.
+    //! @param[in] address The logical address of the instruction.
+    void mark(uint32_t address)
+    {
+        const uint32_t pageIndex = address >> PageShift;
+        Page *page = (pageIndex < _pages.size()) ? _pages[pageIndex].get() :
+                                                   nullptr;
+
+        if (page == nullptr)
+        {
+            page = allocatePage(pageIndex);
+        }
+
+        const uint32_t wordIndex = (address >> 2) & (WordsPerPage - 1);
+        page->Bits[wordIndex >> 6] |= uint64_t(1) << (wordIndex & 63);
+    }
+private:
+    // Internal Types
+    //! @brief A page of bits covering a contiguous range of addresses.
+    struct Page
+    {
+        uint64_t Bits[WordsPerPage / 64];
+    };
+
+    using PageUPtr = std::unique_ptr<Page>;
+
+    // Internal Functions
+    Page *allocatePage(uint32_t pageIndex);
+
+    // Internal Fields
+    std::vector<PageUPtr> _pages;
+    size_t _pageCount;
+};
+
+//! @brief An object which maps ranges of guest addresses back to the lines
+//! of source code which produced them, so that coverage can be reported.
+class GuestLineTable
+{
+public:
+    // Construction/Destruction
+    GuestLineTable() = default;
+    ~GuestLineTable() = default;
+
+    // Accessors
+    bool isEmpty() const;
+    size_t getCount() const;
+
+    // Operations
+    void clear();
+    void addLine(uint32_t address, uint32_t size,
+                 std::string_view fileName, int lineNo);
+    void writeLcovTrace(std::ostream &output, const GuestCoverageMap &coverage,
+                        std::string_view testName) const;
+private:
+    // Internal Types
+    struct Line
+    {
+        uint32_t Address;
+        uint32_t Size;
+        uint32_t FileIndex;
+        int LineNo;
+    };
+
+    // Internal Fields
+    std::vector<Line> _lines;
+    std::vector<std::string> _fileNames;
+    std::map<std::string, uint32_t, std::less<>> _fileIndexByName;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
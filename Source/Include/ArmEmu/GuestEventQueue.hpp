@@ -14,6 +14,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+
 #include "readerwriterqueue.h"
 
 #include "Ag/Core/Memory.hpp"
@@ -43,6 +45,23 @@ struct GuestEvent
                uintptr_t data1, uintptr_t data2);
 };
 
+//! @brief An interface to an object which is notified when messages become
+//! available from an emulated system, rather than having to poll for them.
+class IGuestEventListener
+{
+public:
+    // Construction/Destruction
+    virtual ~IGuestEventListener() = default;
+
+    // Operations
+    //! @brief Called on the emulator thread when a message is posted and no
+    //! previous notification is outstanding.
+    //! @details The notification is re-armed when the observer thread finds
+    //! the queue empty, so it should wake the observer and return without
+    //! blocking, the observer should then drain the queue.
+    virtual void onGuestEventsPending() = 0;
+};
+
 //! @brief An object which manages messages marshalled out of the emulator
 //! thread and into an observer thread.
 class GuestEventQueue
@@ -56,18 +75,52 @@ public:
     // Accessors
     uintptr_t getSourceID() const;
     void setSourceID(uintptr_t sourceID);
+    IGuestEventListener *getListener() const;
+    void setListener(IGuestEventListener *listener);
+    size_t getBacklog() const;
+
+    bool isCoalesced(uint32_t type) const;
 
     // Operations
+    bool tryEnableCoalescing(uint32_t type);
     bool enque(int32_t type, uintptr_t data1, uintptr_t data2);
     bool tryDeque(GuestEvent &next);
+    size_t tryDequeMany(GuestEvent *events, size_t maxCount);
 
 private:
     // Internal Types
     using Queue = moodycamel::ReaderWriterQueue<GuestEvent>;
 
+    //! @brief Holds the most recent data posted with an event type which is
+    //! coalesced, so that at most one such event is queued at a time.
+    struct CoalescedEvent
+    {
+        //! @brief A sequence lock which is odd while the data is being updated.
+        std::atomic_uint32_t Sequence;
+        std::atomic<uintptr_t> Data1;
+        std::atomic<uintptr_t> Data2;
+
+        //! @brief Indicates whether an event of the type is in the queue.
+        std::atomic_bool IsQueued;
+        uint32_t Type;
+
+        CoalescedEvent();
+    };
+
+    // Internal Constants
+    static constexpr size_t MaxCoalescedTypes = 4;
+
+    // Internal Functions
+    CoalescedEvent *findCoalescedEvent(uint32_t type);
+    void resolveCoalescedEvent(GuestEvent &event);
+
     // Internal Fields
     Queue _queue;
     uintptr_t _sourceID;
+    IGuestEventListener *_listener;
+    std::atomic_bool _isWakeupPending;
+    uint8_t _coalescedCount;
+    CoalescedEvent _coalescedEvents[MaxCoalescedTypes];
 };
 
 using GuestEventQueueUPtr = std::unique_ptr<GuestEventQueue, Ag::AlignedDeleter<GuestEventQueue>>;
@@ -0,0 +1,124 @@
+//! @file ArmEmu/GuestProfiler.hpp
+//! @brief The declaration of objects which gather and export statistical
+//! profiles of where an emulated system spends its time.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_GUEST_PROFILER_HPP__
+#define __ARM_EMU_GUEST_PROFILER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Ag/Core/String.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which maps guest addresses to the names of the nearest
+//! preceding symbols.
+class GuestSymbolTable
+{
+public:
+    // Construction/Destruction
+    GuestSymbolTable() = default;
+    ~GuestSymbolTable() = default;
+
+    // Accessors
+    bool isEmpty() const;
+    size_t getCount() const;
+    bool tryFindSymbol(uint32_t address, std::string_view &name,
+                       uint32_t &offset) const;
+    std::string getFunctionName(uint32_t address) const;
+
+    // Operations
+    void clear();
+    void addSymbol(uint32_t address, std::string_view name);
+    void addSymbols(const std::unordered_map<Ag::String, uint32_t> &symbols);
+private:
+    // Internal Types
+    struct Symbol
+    {
+        uint32_t Address;
+        std::string Name;
+
+        bool operator<(const Symbol &rhs) const { return Address < rhs.Address; }
+    };
+
+    // Internal Fields
+    std::vector<Symbol> _symbols;
+};
+
+//! @brief An object which accumulates samples of guest call stacks and
+//! exports them for analysis by external tools.
+//! @details Samples are recorded by the execution unit of a system built with
+//! profiling traits, see ProfiledSystemTraits. Enabling and configuring the
+//! profiler can be done from any thread, but samples should only be read or
+//! exported while the system isn't running.
+class GuestProfiler
+{
+public:
+    // Public Constants
+    //! @brief The default count of processor cycles between samples.
+    static constexpr uint32_t DefaultSamplePeriod = 10000;
+
+    //! @brief The maximum count of frames recorded in a single sample.
+    static constexpr uint8_t MaxStackDepth = 32;
+
+    // Construction/Destruction
+    GuestProfiler();
+    ~GuestProfiler() = default;
+
+    // Accessors
+    bool isEnabled() const;
+    void setEnabled(bool isEnabled);
+    uint32_t getSamplePeriod() const;
+    void setSamplePeriod(uint32_t cycleCount);
+    uint64_t getSampleCount() const;
+    size_t getUniqueStackCount() const;
+
+    // Operations
+    void clear();
+    void recordSample(const uint32_t *frames, uint8_t depth);
+    void writeFoldedStacks(std::ostream &output,
+                           const GuestSymbolTable &symbols) const;
+    void writePprofProfile(std::ostream &output,
+                           const GuestSymbolTable &symbols) const;
+private:
+    // Internal Types
+    //! @brief Calculates a hash of a call stack, leaf first.
+    struct StackHash
+    {
+        size_t operator()(const std::vector<uint32_t> &stack) const;
+    };
+
+    using StackCountMap = std::unordered_map<std::vector<uint32_t>, uint64_t, StackHash>;
+
+    // Internal Fields
+    StackCountMap _stackCounts;
+    std::vector<uint32_t> _sampleStack;
+    uint64_t _sampleCount;
+    std::atomic_uint32_t _samplePeriod;
+    std::atomic_bool _isEnabled;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
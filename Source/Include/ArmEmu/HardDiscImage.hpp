@@ -0,0 +1,100 @@
+//! @file ArmEmu/HardDiscImage.hpp
+//! @brief The declaration of an object which presents a hard disc image
+//! shared read-only between emulated systems with a private, sparse
+//! copy-on-write overlay of the blocks each one has written.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_HARD_DISC_IMAGE_HPP__
+#define __ARM_EMU_HARD_DISC_IMAGE_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which presents a raw hard disc image as an array of
+//! 512 byte sectors, keeping changes in a separate overlay file.
+//! @details The base image is mapped read-only, so the pages of an image
+//! shared by many emulated systems are only held once by the host. The
+//! overlay starts with a header and a block allocation table, followed by
+//! the blocks which have been written, in the order they were first written.
+//! The first write to a block copies it from the base image into the
+//! overlay, later reads of the block come from the overlay. The overlay is
+//! mapped too and only grows as blocks are written, so a new overlay costs
+//! a few pages of disc space and memory.
+//! @note An image opened without an overlay is write protected.
+class HardDiscImage
+{
+public:
+    // Public Constants
+    //! @brief The count of bytes in each sector.
+    static constexpr uint32_t SectorSize = 512;
+
+    //! @brief The count of bytes copied into a new overlay the first time
+    //! part of it is written.
+    static constexpr uint32_t DefaultBlockSize = 32 * 1024;
+
+    // Construction/Destruction
+    HardDiscImage();
+    HardDiscImage(const HardDiscImage &) = delete;
+    HardDiscImage &operator=(const HardDiscImage &) = delete;
+    ~HardDiscImage();
+
+    // Accessors
+    bool isOpen() const;
+    bool isWriteProtected() const;
+    const std::string &getBaseFileName() const;
+    const std::string &getOverlayFileName() const;
+    uint32_t getSectorCount() const;
+    uint32_t getBlockSize() const;
+    uint32_t getBlockCount() const;
+    uint32_t getAllocatedBlockCount() const;
+    bool isBlockAllocated(uint32_t block) const;
+    const uint8_t *getSector(uint32_t lba) const;
+    uint8_t *getWritableSector(uint32_t lba);
+
+    // Operations
+    bool tryOpen(const std::string &baseFileName,
+                 const std::string &overlayFileName,
+                 std::string &error,
+                 uint32_t blockSize = DefaultBlockSize);
+    uint32_t flush();
+    void close();
+private:
+    // Internal Functions
+    bool tryAllocateBlock(uint32_t block);
+
+    // Internal Fields
+    std::string _baseFileName;
+    std::string _overlayFileName;
+    std::vector<uint64_t> _dirtyBlocks;
+    const uint8_t *_base;
+    uint8_t *_overlay;
+    uint32_t *_allocationTable;
+    uint8_t *_overlayBlocks;
+    size_t _baseSize;
+    size_t _overlayMapSize;
+    int _overlayHandle;
+    uint32_t _sectorCount;
+    uint32_t _blockSize;
+    uint32_t _blockCount;
+    uint32_t _dirtyBlockCount;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
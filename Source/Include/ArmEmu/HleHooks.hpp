@@ -0,0 +1,195 @@
+//! @file ArmEmu/HleHooks.hpp
+//! @brief The declaration of a table of host functions which replace
+//! selected guest SWIs and routines, high level emulation.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_HLE_HOOKS_HPP__
+#define __ARM_EMU_HLE_HOOKS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+class IArmSystem;
+
+//! @brief Identifies the outcome of a call to a high level emulation hook.
+enum class HleResult : uint8_t
+{
+    //! @brief The hook didn't handle the call, the guest implementation
+    //! should be executed as if the hook didn't exist.
+    Declined,
+
+    //! @brief The hook completed the call, V is cleared.
+    Completed,
+
+    //! @brief The hook completed the call with an error, V is set.
+    Failed,
+};
+
+//! @brief Describes the state of the processor passed to and returned by a
+//! high level emulation hook.
+struct HleCall
+{
+    //! @brief The count of elements in Registers.
+    static constexpr uint8_t RegisterCount = 15;
+
+    //! @brief The system whose memory the hook can access.
+    IArmSystem *System;
+
+    //! @brief The values of R0-R14 in the current processor mode.
+    //! @note For a routine hook, execution continues at the address in R14
+    //! when the hook has completed.
+    uint32_t Registers[RegisterCount];
+
+    //! @brief The logical address of the SWI instruction or hooked routine.
+    uint32_t Address;
+
+    //! @brief The SWI number without the X bit, zero for a routine hook.
+    uint32_t SwiNumber;
+
+    //! @brief The N, Z, C and V flags in the low nibble, updated by the hook.
+    uint8_t Flags;
+
+    //! @brief The count of processor cycles the call should appear to take,
+    //! which can be updated by the hook.
+    uint8_t Cycles;
+
+    //! @brief True if the X form of a SWI was called.
+    bool IsXSwi;
+
+    const uint8_t *getReadableSpan(uint32_t logicalAddr, uint32_t length,
+                                   uint32_t &spanLength) const;
+    uint8_t *getWritableSpan(uint32_t logicalAddr, uint32_t length,
+                             uint32_t &spanLength) const;
+    void releaseWritableSpan(uint32_t logicalAddr, uint32_t bytesWritten) const;
+};
+
+//! @brief The signature of a function which implements a hook.
+//! @param[in,out] call The state of the processor, updated by the hook.
+//! @param[in] context The value passed when the hook was added.
+//! @return The outcome of the call.
+using HleHookFn = HleResult (*)(HleCall &call, uintptr_t context);
+
+//! @brief A summary of the configuration and activity of a hook.
+struct HleHookStatistics
+{
+    //! @brief The name given to the hook when it was added.
+    std::string Name;
+
+    //! @brief The SWI number the hook replaces, without the X bit.
+    uint32_t SwiNumber;
+
+    //! @brief The logical address of the routine the hook replaces.
+    uint32_t Address;
+
+    //! @brief True if the hook is keyed on a SWI number rather than an
+    //! address.
+    bool IsSwiHook;
+
+    //! @brief True if the hook is called, false if the guest implementation
+    //! is always executed.
+    bool IsEnabled;
+
+    //! @brief The count of calls which the hook completed or failed.
+    uint64_t CallCount;
+
+    //! @brief The count of calls which the hook declined.
+    uint64_t DeclinedCount;
+
+    //! @brief The count of calls passed to the guest implementation while
+    //! the hook was disabled.
+    uint64_t BypassedCount;
+
+    //! @brief The total host time spent in the hook function.
+    uint64_t HostTimeNs;
+};
+
+//! @brief A table of host functions which replace selected SWIs and guest
+//! routines.
+//! @details Hooks are keyed either on a SWI number, when they are called
+//! in place of the guest SWI handler, or on the logical address of a
+//! routine or vector entry point, when they are called in place of the
+//! routine. Routine hooks replace the instruction at the address with a
+//! trap, an LDR form which ARM defines as undefined, so that they cost
+//! nothing until the routine is entered. The displaced instruction is
+//! executed instead when the hook declines or is disabled.
+//!
+//! Each hook can be disabled to compare its results with the guest
+//! implementation and keeps counts of its calls and the host time it took.
+//! @note Hooks must only be added while the processor isn't running. They
+//! can be enabled, disabled and their statistics read from any thread.
+class HleHookTable
+{
+public:
+    // Public Constants
+    //! @brief The mask and value to apply to an instruction word to
+    //! identify a trap placed by a routine hook.
+    static constexpr uint32_t TrapMask = 0x0FF000F0;
+    static constexpr uint32_t TrapBits = 0x07F000F0;
+
+    //! @brief The maximum count of hooks which can be added.
+    static constexpr size_t MaxHookCount = 0x10000;
+
+    // Construction/Destruction
+    HleHookTable();
+    HleHookTable(const HleHookTable &) = delete;
+    HleHookTable &operator=(const HleHookTable &) = delete;
+    ~HleHookTable();
+
+    // Accessors
+    size_t getHookCount() const;
+    HleHookStatistics getStatistics(size_t hookId) const;
+    bool isHookEnabled(size_t hookId) const;
+    void setHookEnabled(size_t hookId, bool isEnabled);
+    void resetStatistics();
+
+    bool tryFindSwiHook(uint32_t instruction, size_t &hookId) const;
+    bool tryFindRoutineHook(uint32_t address, uint32_t instruction,
+                            size_t &hookId) const;
+    uint32_t getDisplacedInstruction(size_t hookId) const;
+
+    // Operations
+    void connect(IArmSystem *system);
+    bool tryAddSwiHook(std::string_view name, uint32_t swiNumber,
+                       HleHookFn fn, uintptr_t context, size_t &hookId,
+                       std::string &error);
+    bool tryAddRoutineHook(std::string_view name, uint32_t address,
+                           HleHookFn fn, uintptr_t context, size_t &hookId,
+                           std::string &error);
+    HleResult callHook(size_t hookId, HleCall &call);
+private:
+    // Internal Types
+    struct Hook;
+    using HookUPtr = std::unique_ptr<Hook>;
+
+    // Internal Functions
+    bool tryCreateHook(std::string_view name, HleHookFn fn, uintptr_t context,
+                       std::string &error);
+
+    // Internal Fields
+    std::vector<HookUPtr> _hooks;
+    std::unordered_map<uint32_t, uint32_t> _swiHooks;
+    IArmSystem *_system;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
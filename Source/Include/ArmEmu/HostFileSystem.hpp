@@ -0,0 +1,170 @@
+//! @file ArmEmu/HostFileSystem.hpp
+//! @brief The declaration of an object which services a range of emulator-only
+//! SWIs giving guest code direct access to files in a host directory.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_HOST_FILE_SYSTEM_HPP__
+#define __ARM_EMU_HOST_FILE_SYSTEM_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the operations of the host filing system, each of which
+//! is called with the SWI HostFileSystem::SwiBase + operation.
+//! @details R0 always points to a null terminated object name in RISC OS
+//! form, relative to the host directory, i.e. using '.' to separate
+//! directories and '/' before an extension. An empty name or "$" refers to
+//! the host directory itself.
+enum class HostFsOperation : uint8_t
+{
+    //! @brief Reads the type and length of an object.
+    //! On exit R1 = HostFsObjectType, R2 = length in bytes.
+    ReadInfo,
+
+    //! @brief Loads a whole file into guest memory.
+    //! On entry R1 = address, R2 = maximum byte count.
+    //! On exit R2 = bytes loaded, R3 = length of the file.
+    Load,
+
+    //! @brief Creates or replaces a file with a block of guest memory.
+    //! On entry R1 = address, R2 = byte count.
+    Save,
+
+    //! @brief Reads part of a file into guest memory.
+    //! On entry R1 = address, R2 = byte count, R3 = file offset.
+    //! On exit R2 = bytes read, fewer at the end of the file.
+    ReadBlock,
+
+    //! @brief Writes a block of guest memory to part of a file, creating or
+    //! extending the file as required.
+    //! On entry R1 = address, R2 = byte count, R3 = file offset.
+    WriteBlock,
+
+    //! @brief Deletes a file or an empty directory.
+    Delete,
+
+    //! @brief Creates a directory, succeeding if it already exists.
+    CreateDirectory,
+
+    //! @brief Reads the names of objects in a directory in sorted order.
+    //! On entry R1 = buffer address, R2 = buffer size, R3 = index of the
+    //! first entry to read.
+    //! On exit R3 = index of the next entry or -1 if there are no more,
+    //! R4 = count of null terminated names written to the buffer.
+    ReadDirectory,
+
+    Max,
+};
+
+//! @brief Identifies the type of an object reported by HostFsOperation::ReadInfo.
+enum class HostFsObjectType : uint32_t
+{
+    NotFound,
+    File,
+    Directory,
+};
+
+//! @brief Identifies errors returned in R0 with the V flag set by
+//! host filing system SWIs.
+enum class HostFsError : uint32_t
+{
+    None,
+    BadOperation,
+    BadName,
+    NotFound,
+    WrongType,
+    BadAddress,
+    HostError,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+class IArmSystem;
+
+//! @brief An object which services a range of emulator-only SWIs by reading
+//! and writing files in a host directory directly to and from guest memory.
+//! @details Moving files through an emulated disc controller costs the
+//! emulated processor seconds, whereas a host filing system SWI completes
+//! within the execution of a single instruction. The SWIs are trapped
+//! before the processor takes the SWI exception, so they work whichever
+//! operating system is running, with a guest filing system module doing
+//! no more than passing calls on.
+//!
+//! Errors are always returned by setting V with a HostFsError in R0, as
+//! if the X form of the SWI was called. Guest memory is accessed through
+//! logical addresses without regard to page protection.
+//! @note The object isn't present, and SWIs are passed on to the
+//! processor as normal, unless enabled with
+//! Options::setHostFileSystemRoot().
+//! @note While the system holds storage output, see HeldOutput::Storage,
+//! operations which would change host files report success without doing so.
+class HostFileSystem
+{
+public:
+    // Public Constants
+    //! @brief The number of the first SWI in the chunk reserved for the
+    //! host filing system, without the X bit.
+    static constexpr uint32_t SwiBase = 0x56AC0;
+
+    //! @brief The count of SWI numbers reserved for the host filing system.
+    static constexpr uint32_t SwiChunkSize = 64;
+
+    //! @brief The count of registers, starting at R0, which SWIs can
+    //! use to pass parameters and return results.
+    static constexpr uint8_t ArgumentCount = 5;
+
+    // Construction/Destruction
+    HostFileSystem();
+    ~HostFileSystem() = default;
+
+    // Accessors
+    bool isPresent() const;
+    const std::filesystem::path &getRootPath() const;
+    static bool isHostSwi(uint32_t instruction);
+
+    // Operations
+    void connect(IArmSystem *system, const std::filesystem::path &rootPath);
+    bool service(uint32_t instruction, uint32_t (&args)[ArgumentCount]);
+private:
+    // Internal Functions
+    bool isStorageHeld() const;
+    bool tryReadName(uint32_t address, std::filesystem::path &hostPath,
+                     HostFsError &error) const;
+    HostFsError readInfo(const std::filesystem::path &hostPath,
+                         uint32_t (&args)[ArgumentCount]) const;
+    HostFsError readBlock(const std::filesystem::path &hostPath,
+                          uint32_t (&args)[ArgumentCount], uint64_t offset,
+                          bool isWholeFile);
+    HostFsError writeBlock(const std::filesystem::path &hostPath,
+                           uint32_t (&args)[ArgumentCount], uint64_t offset,
+                           bool isReplaced);
+    HostFsError readDirectory(const std::filesystem::path &hostPath,
+                              uint32_t (&args)[ArgumentCount]);
+
+    // Internal Fields
+    std::filesystem::path _rootPath;
+    std::vector<uint8_t> _buffer;
+    IArmSystem *_system;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -26,7 +26,17 @@ namespace Arm {
 //! emulator to the host system.
 enum HostMessageID : uint32_t
 {
-
+    //! @brief A snapshot of the display has been published at vertical sync,
+    //! see IArmSystem::getVideoFrames(). Data1 holds the sequence number of
+    //! the snapshot and Data2 the count of lines which changed. Messages are
+    //! coalesced so only the latest is ever queued.
+    VideoFrameReady,
+
+    //! @brief Sound samples have been queued, see
+    //! IArmSystem::getSoundSamples(). Data1 holds the count of samples
+    //! waiting to be read and Data2 the sample rate in Hz. Messages are
+    //! coalesced so only the latest is ever queued.
+    SoundSamplesReady,
 
     LastHostMessage
 };
@@ -14,7 +14,6 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
-#include <atomic>
 #include <new>
 
 #include "readerwriterqueue.h"
@@ -36,8 +35,10 @@ class AcornKeyboardController;
 
 using SynchronisedByteQueue = moodycamel::ReaderWriterQueue<uint8_t>;
 
-//! @brief A structure representing state which can be read/written by
-//! both the emulation and input thread.
+//! @brief A structure representing the interrupt and control pin state of the
+//! IOC which is owned exclusively by the emulation thread.
+//! @note Changes originating on the host are delivered via the queues in
+//! IocSynchronisedState and applied by the emulation thread.
 class IocIrqState
 {
 public:
@@ -76,27 +77,27 @@ private:
     // Interrupt management registers.
 
     //! @brief The current activation of interrupts.
-    std::atomic_uint16_t _irqStatus;
+    uint16_t _irqStatus;
 
     //! @brief The state of the interrupt mask registers (A and B).
-    std::atomic_uint16_t _irqMask;
+    uint16_t _irqMask;
 
     //! @brief The current activation of fast interrupts.
-    std::atomic_uint8_t _firqStatus;
+    uint8_t _firqStatus;
 
     //! @brief The state of the fast interrupt mask.
-    std::atomic_uint8_t _firqMask;
+    uint8_t _firqMask;
 
     //! @brief The state of inputs to pins C0-C5 set by external devices.
     //! @note C3-C5 activate FIRQs.
-    std::atomic_uint8_t _ctrlInput;
+    uint8_t _ctrlInput;
 
     //! @brief The state of output pins C0-C5.
-    std::atomic_uint8_t _ctrlOutput;
+    uint8_t _ctrlOutput;
 
     //! @brief Indicates whether pins C0-C5 can receive input (1) or
     //! transmit output (0).
-    std::atomic_uint8_t _ctrlState;
+    uint8_t _ctrlState;
 };
 
 #ifdef _MSC_VER
@@ -111,13 +112,18 @@ private:
 struct IocSynchronisedState
 {
     static constexpr size_t CacheLineMask = ~static_cast<size_t>(std::hardware_destructive_interference_size - 1);
-    static constexpr size_t SharedStateSize = (sizeof(IocIrqState) + std::hardware_destructive_interference_size - 1) & CacheLineMask;
     static constexpr size_t QueueSize = (sizeof(SynchronisedByteQueue) + std::hardware_destructive_interference_size - 1) & CacheLineMask;
 
-    alignas(std::hardware_destructive_interference_size) IocIrqState InterruptState;
+    //! @brief Bytes sent by the keyboard to be received by the KART.
     alignas(std::hardware_destructive_interference_size) SynchronisedByteQueue RxQueue;
+
+    //! @brief Bytes transmitted by the KART to be received by the keyboard.
     alignas(std::hardware_destructive_interference_size) SynchronisedByteQueue TxQueue;
 
+    //! @brief Changes to the input state of control pins C[0:5] made by the
+    //! host, encoded as the pin number with bit 7 holding the new state.
+    alignas(std::hardware_destructive_interference_size) SynchronisedByteQueue PinQueue;
+
     IocSynchronisedState() = default;
     ~IocSynchronisedState() = default;
 };
@@ -150,6 +156,8 @@ public:
 
     // Operations
     void powerOnReset();
+    void raiseVerticalFlyback();
+    void setSoundBufferInterrupt(bool state);
     void setInterruptLow(uint8_t ilNo, bool state);
     void setFastHighInterrupt(uint8_t fhNo, bool state);
     void setFastLowInterrupt(bool state);
@@ -170,6 +178,8 @@ public:
     virtual uint32_t read(uint32_t offset) override;
     virtual void write(uint32_t offset, uint32_t value) override;
     virtual void connect(const ConnectionContext &context) override;
+    virtual void captureState(SystemSnapshot &snapshot) const override;
+    virtual void restoreState(SnapshotReader &reader) override;
 private:
     // Internal Types
     class Counter
@@ -189,6 +199,8 @@ private:
         // Operations
         void go(SystemContext *context);
         void latch(SystemContext *context);
+        void captureState(SystemSnapshot &snapshot) const;
+        void restoreState(SnapshotReader &reader);
 
     protected:
         void start(SystemContext *context, uint64_t countFactor);
@@ -227,12 +239,16 @@ private:
     static void onCounterReachesZero(SystemContext &guestContext, uintptr_t taskContext);
     static void onKartCounterReachesZero(SystemContext &guestContext,
                                          uintptr_t taskContext);
+    static void onPollHostInput(SystemContext &guestContext, uintptr_t taskContext);
+    void applyHostPinChanges();
+    static void captureQueue(SystemSnapshot &snapshot, SynchronisedByteQueue &queue);
+    static void restoreQueue(SnapshotReader &reader, SynchronisedByteQueue &queue);
 
     // Internal Fields
     IocSyncStatePtr _synchronisedData;
     MemcHardware &_parent;
     SystemContext *_context;
-    IocIrqState *_irqState;
+    IocIrqState _irqState;
     AcornKeyboardController *_keyboard;
 
     // NOTE: These two must be consecutive to appear as an array of Timer[4].
@@ -241,8 +257,11 @@ private:
 
     CounterEventContext _timer0Context;
     CounterEventContext _timer1Context;
+    GuestTask _hostInputTask;
+    uint64_t _hostInputPollTicks;
     SynchronisedByteQueue *_kartRxQueue;
     SynchronisedByteQueue *_kartTxQueue;
+    SynchronisedByteQueue *_hostPinQueue;
     uint8_t _kartRxByte;
 };
 
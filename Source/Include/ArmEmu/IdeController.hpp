@@ -0,0 +1,139 @@
+//! @file ArmEmu/IdeController.hpp
+//! @brief The declaration of an object which emulates an IDE hard disc
+//! interface and the drives attached to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_IDE_CONTROLLER_HPP__
+#define __ARM_EMU_IDE_CONTROLLER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <string>
+
+#include "AddressMap.hpp"
+#include "HardDiscImage.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+class IOC;
+class Options;
+
+//! @brief An object which emulates an IDE interface with up to two ATA hard
+//! drives, each backed by a HardDiscImage.
+//! @details The task file registers occupy word offsets 0-7 and the
+//! alternate status/device control register word offset 14. The data
+//! register transfers 16 bits at a time directly from the mapped image and
+//! INTRQ drives IOC IL3. Commands complete immediately, the drive is never
+//! seen busy.
+//! @note Only PIO transfers are supported: Identify Device, Read/Write
+//! Sector(s), Read Verify, Seek, Recalibrate, Initialise Device Parameters,
+//! Set Features and Flush Cache. Other commands are aborted.
+class IdeController : public IMMIOBlock
+{
+public:
+    // Public Constants
+    //! @brief The physical address of the interface registers in an
+    //! A5000-class system.
+    static constexpr uint32_t BaseAddress = 0x3012000;
+
+    //! @brief The maximum count of drives which can be attached.
+    static constexpr uint8_t MaxDriveCount = 2;
+
+    // Construction/Destruction
+    IdeController(const Options &options);
+    virtual ~IdeController() = default;
+
+    // Accessors
+    uint8_t getDriveCount() const;
+    const HardDiscImage &getDisc(uint8_t drive) const;
+
+    // Operations
+    bool tryAttachDisc(uint8_t drive, const std::string &baseFileName,
+                       const std::string &overlayFileName, std::string &error);
+    void detachDisc(uint8_t drive);
+    uint32_t flushDiscs();
+
+    // Overrides
+    virtual RegionType getType() const override;
+    virtual Ag::string_cref_t getName() const override;
+    virtual Ag::string_cref_t getDescription() const override;
+    virtual uint32_t getSize() const override;
+
+    virtual uint32_t read(uint32_t offset) override;
+    virtual void write(uint32_t offset, uint32_t value) override;
+    virtual void connect(const ConnectionContext &context) override;
+    virtual void captureState(SystemSnapshot &snapshot) const override;
+    virtual void restoreState(SnapshotReader &reader) override;
+private:
+    // Internal Types
+    //! @brief Identifies the direction of the data transfer in progress.
+    enum class Phase : uint8_t
+    {
+        Idle,
+        DataIn,
+        DataOut,
+    };
+
+    //! @brief The translation between CHS and logical addresses of a drive.
+    struct Geometry
+    {
+        uint16_t Cylinders;
+        uint8_t Heads;
+        uint8_t SectorsPerTrack;
+    };
+
+    // Internal Functions
+    HardDiscImage *getSelectedDisc();
+    uint8_t getStatus() const;
+    void setInterruptRequest(bool isPending);
+    bool tryGetAddress(uint32_t &lba) const;
+    void setAddress(uint32_t lba);
+    void executeCommand(uint8_t command);
+    void abortCommand(uint8_t errorBits);
+    void identifyDevice();
+    bool attachTransfer();
+    void completeSector();
+    uint16_t readData();
+    void writeData(uint16_t value);
+    void softReset();
+
+    // Internal Fields
+    HardDiscImage _discs[MaxDriveCount];
+    Geometry _geometries[MaxDriveCount];
+    uint8_t _identity[HardDiscImage::SectorSize];
+    uint8_t _heldSector[HardDiscImage::SectorSize];
+    SystemContext *_context;
+    IOC *_ioController;
+    const uint8_t *_readBuffer;
+    uint8_t *_writeBuffer;
+    uint32_t _transferOffset;
+    uint16_t _sectorsRemaining;
+    uint8_t _driveCount;
+    uint8_t _command;
+    uint8_t _error;
+    uint8_t _features;
+    uint8_t _sectorCount;
+    uint8_t _sectorNumber;
+    uint8_t _cylinderLow;
+    uint8_t _cylinderHigh;
+    uint8_t _deviceHead;
+    uint8_t _deviceControl;
+    Phase _phase;
+    bool _isErrorActive;
+    bool _isInterruptPending;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
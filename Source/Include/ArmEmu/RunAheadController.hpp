@@ -0,0 +1,123 @@
+//! @file ArmEmu/RunAheadController.hpp
+//! @brief The declaration of an object which reduces input latency by
+//! speculatively running an emulated system ahead of real time.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_RUN_AHEAD_CONTROLLER_HPP__
+#define __ARM_EMU_RUN_AHEAD_CONTROLLER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include "Ag/Core/Timer.hpp"
+
+#include "ArmEmu/ExecutionMetrics.hpp"
+#include "ArmEmu/SystemSnapshot.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+class IArmSystem;
+
+//! @brief Statistics describing the cost of running ahead.
+struct RunAheadMetrics
+{
+    // Public Fields
+    //! @brief The count of frames which were run for real.
+    uint64_t FrameCount;
+
+    //! @brief The count of frames which were run speculatively and then
+    //! rolled back.
+    uint64_t SpeculativeFrameCount;
+
+    //! @brief The count of frames where fewer speculative frames were run
+    //! than configured because the frame budget was exhausted.
+    uint64_t BudgetOverrunCount;
+
+    //! @brief The host time spent running frames for real.
+    Ag::MonotonicTicks FrameTime;
+
+    //! @brief The host time spent capturing the system state.
+    Ag::MonotonicTicks CaptureTime;
+
+    //! @brief The host time spent running speculative frames.
+    Ag::MonotonicTicks SpeculationTime;
+
+    //! @brief The host time spent restoring the system state.
+    Ag::MonotonicTicks RestoreTime;
+
+    // Construction
+    RunAheadMetrics();
+
+    // Accessors
+    Ag::MonotonicTicks getOverheadTime() const;
+    double calculateOverhead() const;
+    double calculateOverheadPerFrameMs() const;
+
+    // Operations
+    void reset();
+};
+
+//! @brief An object which runs an emulated system a frame at a time, then
+//! runs one or more frames further ahead using the latest input before
+//! rolling back, so that the host can present output earlier than the
+//! emulated hardware would produce it.
+//! @details While running ahead, the system holds back output which would
+//! otherwise escape the roll back, see IArmSystem::setHeldOutputs(). The
+//! video of the real frame and all but the last speculative frame isn't
+//! published, so the frame presented is the furthest ahead. Sound samples
+//! are only queued by the real frame and changes to discs and host files
+//! made by speculative frames are discarded.
+//! @note The host is expected to call runFrame() once per displayed frame, so
+//! the system should not also be configured for real time pacing.
+//! @note AcornKeyboardController doesn't yet pass host keyboard or mouse
+//! input on to the guest, so running ahead can't reduce input latency until
+//! it does.
+class RunAheadController
+{
+public:
+    // Public Constants
+    //! @brief The default period of a frame, matching a 50 Hz display.
+    static constexpr uint32_t DefaultFramePeriod = 20000;
+
+    // Construction/Destruction
+    RunAheadController(IArmSystem *system);
+    ~RunAheadController() = default;
+
+    // Accessors
+    uint8_t getFramesAhead() const;
+    void setFramesAhead(uint8_t frameCount);
+    uint32_t getFramePeriod() const;
+    void setFramePeriod(uint32_t microseconds);
+    uint32_t getFrameBudget() const;
+    void setFrameBudget(uint32_t microseconds);
+    const RunAheadMetrics &getMetrics() const;
+
+    // Operations
+    ExecutionMetrics runFrame();
+    void resetMetrics();
+private:
+    // Internal Functions
+    bool isBudgetExhausted(Ag::MonotonicTicks startTime) const;
+
+    // Internal Fields
+    IArmSystem *_system;
+    SystemSnapshot _snapshot;
+    RunAheadMetrics _metrics;
+    uint32_t _framePeriod;
+    uint32_t _frameBudget;
+    uint8_t _framesAhead;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,173 @@
+//! @file ArmEmu/SharedFrameBuffer.hpp
+//! @brief The declaration of objects which export the rendered display of an
+//! emulated system through shared memory so that other processes can observe
+//! it without copies or sockets.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_SHARED_FRAME_BUFFER_HPP__
+#define __ARM_EMU_SHARED_FRAME_BUFFER_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VideoOutput.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The header at the start of a shared memory region written by a
+//! SharedFrameWriter, followed at PixelOffset by MaxHeight lines of MaxWidth
+//! host pixels in the format produced by VidcPalette::toHostColour().
+//! @details The header and pixels are protected by a sequence lock. The
+//! UpdateCount is odd while an update is being written, a reader should take
+//! a copy of the count, read what it needs, then discard what it read if the
+//! count has changed.
+struct SharedFrameHeader
+{
+    // Public Constants
+    //! @brief The value of the Magic field, 'MOFB' in little-endian.
+    static constexpr uint32_t MagicNumber = 0x42464F4D;
+
+    //! @brief The layout version described by this structure.
+    static constexpr uint32_t CurrentVersion = 1;
+
+    //! @brief The offset of the first pixel from the start of the region.
+    static constexpr uint32_t PixelOffset = 256;
+
+    //! @brief The maximum number of lines a region can hold.
+    static constexpr uint32_t MaxLineCount = 1024;
+
+    //! @brief The count of 64-bit words in the dirty line bitmap.
+    static constexpr uint32_t DirtyWordCount = MaxLineCount / 64;
+
+    // Public Fields
+    //! @brief Identifies the region, set to MagicNumber.
+    uint32_t Magic;
+
+    //! @brief The layout version of the region, set to CurrentVersion.
+    uint32_t Version;
+
+    //! @brief The offset of the first pixel from the start of the region.
+    uint32_t PixelDataOffset;
+
+    //! @brief The count of pixels between the start of each line, and the
+    //! maximum width of a frame.
+    uint32_t MaxWidth;
+
+    //! @brief The maximum count of lines in a frame.
+    uint32_t MaxHeight;
+
+    //! @brief The width of the current frame in pixels, 0 until the first
+    //! frame is written.
+    uint32_t Width;
+
+    //! @brief The height of the current frame in lines.
+    uint32_t Height;
+
+    //! @brief Reserved, set to 0.
+    uint32_t Reserved;
+
+    //! @brief The sequence lock, incremented before and after each update.
+    std::atomic_uint64_t UpdateCount;
+
+    //! @brief The VideoFrame::Sequence of the last snapshot written.
+    uint64_t FrameSequence;
+
+    //! @brief One bit per line of the frame, set if the line was changed by
+    //! the last update. A reader which missed an update, i.e. UpdateCount
+    //! advanced by more than 2, should assume every line changed.
+    uint64_t DirtyLines[DirtyWordCount];
+};
+
+static_assert(sizeof(SharedFrameHeader) <= SharedFrameHeader::PixelOffset,
+              "The shared frame header overlaps the pixels.");
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which creates a named shared memory region and renders
+//! VideoFrame snapshots directly into it.
+//! @details Intended for headless hosts, tryPublish() should be called on
+//! receipt of a HostMessageID::VideoFrameReady message in place of running a
+//! VideoRenderThread.
+class SharedFrameWriter
+{
+public:
+    // Public Constants
+    //! @brief The default maximum width of frames which can be exported.
+    static constexpr uint32_t DefaultMaxWidth = 1024;
+
+    //! @brief The default maximum height of frames which can be exported.
+    static constexpr uint32_t DefaultMaxHeight = 768;
+
+    // Construction/Destruction
+    SharedFrameWriter();
+    ~SharedFrameWriter();
+
+    // Accessors
+    bool isOpen() const;
+    const std::string &getName() const;
+    const SharedFrameHeader *getHeader() const;
+    const uint32_t *getPixels() const;
+
+    // Operations
+    bool tryCreate(const std::string &name, std::string &error,
+                   uint32_t maxWidth = DefaultMaxWidth,
+                   uint32_t maxHeight = DefaultMaxHeight);
+    void close();
+    bool tryPublish(VideoFrameExchange &source);
+private:
+    // Internal Fields
+    std::string _name;
+    FrameConverter _converter;
+    VidcTiming _geometry;
+    SharedFrameHeader *_header;
+    uint32_t *_pixels;
+    size_t _regionSize;
+};
+
+//! @brief An object which maps a region created by a SharedFrameWriter in
+//! another process for reading.
+class SharedFrameReader
+{
+public:
+    // Construction/Destruction
+    SharedFrameReader();
+    ~SharedFrameReader();
+
+    // Accessors
+    bool isOpen() const;
+    const SharedFrameHeader *getHeader() const;
+    const uint32_t *getPixels() const;
+
+    // Operations
+    bool tryOpen(const std::string &name, std::string &error);
+    void close();
+    uint64_t beginRead() const;
+    bool isReadConsistent(uint64_t updateCount) const;
+    bool tryCopyFrame(std::vector<uint32_t> &pixels, uint32_t &width,
+                      uint32_t &height, uint64_t &sequence) const;
+private:
+    // Internal Fields
+    const SharedFrameHeader *_header;
+    const uint32_t *_pixels;
+    size_t _regionSize;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+//! @file ArmEmu/SoundOutput.hpp
+//! @brief The declaration of objects which convert the logarithmic samples
+//! played by the VIDC into linear stereo and hand them from the emulation
+//! thread to a host audio thread.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_SOUND_OUTPUT_HPP__
+#define __ARM_EMU_SOUND_OUTPUT_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameConverter.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A single 16-bit linear stereo sample in host byte order, as
+//! written to a 16-bit PCM WAV file.
+struct StereoSample
+{
+    int16_t Left;
+    int16_t Right;
+};
+
+static_assert(sizeof(StereoSample) == 4, "Stereo samples must be tightly packed.");
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which converts the 8-bit logarithmic samples fetched by
+//! sound DMA into linear stereo samples positioned by the VIDC stereo image
+//! registers.
+//! @details The VIDC DAC cycles through 8 channel slots, one per byte, each
+//! with its own stereo position. Bytes are converted one-for-one, the first
+//! byte of each block converted being for channel 0.
+class SoundMixer
+{
+public:
+    // Public Constants
+    //! @brief The count of stereo image registers samples cycle through.
+    static constexpr uint8_t ChannelCount = 8;
+
+    // Construction/Destruction
+    SoundMixer();
+    SoundMixer(SimdLevel level);
+    ~SoundMixer() = default;
+
+    // Accessors
+    SimdLevel getSimdLevel() const;
+    static int16_t toLinear(uint8_t logSample);
+    static void getStereoGains(uint8_t position, int16_t &left, int16_t &right);
+
+    // Operations
+    bool setStereoPositions(const uint8_t *positions);
+    void mix(const uint8_t *source, StereoSample *target,
+             uint32_t sampleCount) const;
+private:
+    // Internal Types
+    using MixFn = void(*)(const int16_t *linear, const int16_t *gains,
+                          const uint8_t *source, StereoSample *target,
+                          uint32_t sampleCount);
+
+    // Internal Fields
+    int16_t _gains[ChannelCount * 2];
+    uint8_t _positions[ChannelCount];
+    MixFn _kernel;
+    SimdLevel _level;
+};
+
+//! @brief A single-producer, single-consumer ring buffer of stereo samples
+//! which can be written and read concurrently without locks.
+class SoundSampleRing
+{
+public:
+    // Public Constants
+    //! @brief The default capacity, in samples, around 0.4 seconds at the
+    //! sample rate RISC OS uses by default.
+    static constexpr size_t DefaultCapacity = size_t(1) << 16;
+
+    // Construction/Destruction
+    SoundSampleRing(size_t capacity = DefaultCapacity);
+    ~SoundSampleRing() = default;
+
+    // Accessors
+    size_t getCapacity() const;
+    size_t getAvailable() const;
+    uint32_t getSampleRate() const;
+    void setSampleRate(uint32_t sampleRate);
+    uint64_t getWrittenCount() const;
+    uint64_t getDroppedCount() const;
+
+    // Operations
+    bool tryWrite(const StereoSample *samples, size_t count);
+    bool waitForSpace(size_t count, std::chrono::milliseconds timeout) const;
+    size_t read(StereoSample *buffer, size_t maxCount);
+private:
+    // Internal Fields
+    std::unique_ptr<StereoSample[]> _samples;
+    size_t _mask;
+    std::atomic_uint32_t _sampleRate;
+    std::atomic_uint64_t _droppedCount;
+
+    // Keep the indices on separate cache lines so that the producer and
+    // consumer threads don't contend.
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+//! @brief An object which drains sound samples to a 16-bit stereo PCM WAV
+//! file on a background thread, allowing sound to be captured from a
+//! headless system.
+//! @details The sample rate of the file is that of the ring when the first
+//! samples are drained. Samples played at a different rate later are
+//! written unchanged.
+class WaveFileWriter
+{
+public:
+    // Construction/Destruction
+    WaveFileWriter();
+    ~WaveFileWriter();
+
+    // Accessors
+    bool isRunning() const;
+    uint32_t getSampleRate() const;
+    uint64_t getSampleCount() const;
+
+    // Operations
+    bool tryStart(SoundSampleRing &ring, const std::string &fileName,
+                  std::string &error);
+    void stop();
+
+    static void writeFileHeader(std::ostream &output, uint32_t sampleRate,
+                                uint64_t sampleCount);
+private:
+    // Internal Functions
+    void run();
+    void drain();
+
+    // Internal Fields
+    std::ofstream _output;
+    std::thread _thread;
+    std::vector<StereoSample> _buffer;
+    SoundSampleRing *_ring;
+    std::atomic_uint64_t _sampleCount;
+    std::atomic_uint32_t _sampleRate;
+    std::atomic_bool _isStopping;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -14,6 +14,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 
 namespace Mo {
@@ -25,6 +27,8 @@ namespace Arm {
 class IArmSystem;
 class GuestEventQueue;
 class SystemContext;
+class SystemSnapshot;
+class SnapshotReader;
 class Options;
 
 //! @brief A description of a task scheduled and run on the emulator thread.
@@ -60,12 +64,27 @@ public:
     uint64_t getCPUClockTicks() const;
     uint64_t getMasterClockTicks() const;
     uint64_t getMasterClockFrequency() const;
+    bool isRealTimePacingEnabled() const;
+    bool isTurboEnabled() const;
+    void setTurbo(bool isEnabled);
+    uint8_t getHeldOutputs() const;
+    bool isOutputHeld(uint8_t output) const;
+    void setHeldOutputs(uint8_t outputs);
+    uint64_t getHostIdleTimeNs() const;
+    uint32_t getScheduledTaskCount() const;
 
     // Operations
     uint32_t getFuzz();
     void incrementCPUClock(uint32_t cycles);
+    void stealCPUCycles(uint32_t cycles);
+    void resynchronisePacing();
+    void addHostIdleTime(std::chrono::nanoseconds idleTime);
     void scheduleTask(GuestTask *task);
+    void cancelTask(GuestTask *task);
+    void captureState(SystemSnapshot &snapshot) const;
+    void restoreState(SnapshotReader &reader);
     bool postMessageToHost(uint32_t eventID, uintptr_t data1, uintptr_t data2);
+    bool tryCoalesceMessages(uint32_t eventID);
 private:
     // Internal Constants
     // Ensure the size of the fuzz array is a power of 2 to allow easy wrapping.
@@ -73,12 +92,27 @@ private:
     static constexpr uint8_t FuzzSizeMask = (static_cast<uint8_t>(1) << FuzzSizePow2) - 1;
     static constexpr size_t FuzzSize = 1 << FuzzSizePow2;
 
+    using PacingClock = std::chrono::steady_clock;
+
+    // Internal Functions
+    static void onPacingSliceElapsed(SystemContext &guestContext,
+                                     uintptr_t taskContext);
+    void throttleToRealTime();
+
     // Internal Fields
     GuestEventQueue &_eventQueue;
     IArmSystem *_parentSystem;
     GuestTask *_taskQueueHead;
     uint64_t _masterClock;
     uint64_t _masterFreq;
+    GuestTask _pacingTask;
+    PacingClock::time_point _pacingBaseTime;
+    uint64_t _pacingBaseTicks;
+    uint64_t _pacingSliceTicks;
+    uint64_t _hostIdleTimeNs;
+    std::atomic_bool _isTurboEnabled;
+    bool _isPacingEnabled;
+    uint8_t _heldOutputs;
     uint8_t _cpuClockShift;
     uint8_t _fuzzIndex;
     uint32_t _fuzz[FuzzSize];
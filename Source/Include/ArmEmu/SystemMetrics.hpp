@@ -0,0 +1,238 @@
+//! @file ArmEmu/SystemMetrics.hpp
+//! @brief The declaration of objects which publish periodic measurements of
+//! the health of a running emulated system and export them to other
+//! processes.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_SYSTEM_METRICS_HPP__
+#define __ARM_EMU_SYSTEM_METRICS_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies the text formats a MetricsExporter can write.
+enum class MetricsFormat : uint8_t
+{
+    //! @brief The Prometheus text exposition format, a complete set of
+    //! samples is written on each update.
+    Prometheus,
+
+    //! @brief One JSON object per line for each update.
+    JsonLines,
+};
+
+//! @brief Identifies where a MetricsExporter writes updates to.
+enum class MetricsTarget : uint8_t
+{
+    //! @brief A local file. Prometheus output replaces the file so that it
+    //! can be picked up by a text file collector, JSON lines are appended.
+    File,
+
+    //! @brief A Unix domain stream socket which the exporter connects to.
+    UnixSocket,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief The running totals an emulated system keeps from which rates
+//! are calculated.
+struct SystemCounters
+{
+    //! @brief The host monotonic time the totals were read, in nanoseconds.
+    uint64_t HostTimeNs;
+
+    //! @brief The count of instructions executed.
+    uint64_t InstructionCount;
+
+    //! @brief The count of emulated processor clock cycles elapsed.
+    uint64_t CycleCount;
+
+    //! @brief The count of normal interrupts taken by the processor.
+    uint64_t IrqCount;
+
+    //! @brief The count of fast interrupts taken by the processor.
+    uint64_t FastIrqCount;
+
+    //! @brief The count of reads and writes passed to memory mapped devices,
+    //! only counted by systems built with instrumentation, see
+    //! Options::setInstrumentation().
+    uint64_t MmioAccessCount;
+
+    //! @brief The time the emulation thread has spent sleeping to keep to
+    //! real time, in nanoseconds.
+    uint64_t HostIdleTimeNs;
+
+    SystemCounters();
+
+    static uint64_t getHostTimeNs();
+};
+
+//! @brief A snapshot of the health of an emulated system.
+//! @details All fields are 64-bit so that the snapshot can be copied between
+//! threads a word at a time, see SystemMetricsPublisher.
+struct SystemMetrics
+{
+    // Public Fields
+    //! @brief The count of snapshots published before this one.
+    uint64_t Sequence;
+
+    //! @brief The host monotonic time the snapshot was taken, in nanoseconds.
+    uint64_t SampleTimeNs;
+
+    //! @brief The period of host time the rates were measured over, in
+    //! nanoseconds.
+    uint64_t PeriodNs;
+
+    //! @brief Non-zero if the system was running when the snapshot was
+    //! taken, the rates of a stopped system describe its last period.
+    uint64_t IsRunning;
+
+    //! @brief The total count of instructions executed.
+    uint64_t InstructionCount;
+
+    //! @brief The total count of emulated processor cycles elapsed.
+    uint64_t CycleCount;
+
+    //! @brief The count of tasks in the emulated system's scheduler.
+    uint64_t ScheduledTaskCount;
+
+    //! @brief The approximate count of messages waiting to be read from the
+    //! guest event queue.
+    uint64_t EventQueueBacklog;
+
+    //! @brief The host time taken by the last call to
+    //! IArmSystem::captureState(), in nanoseconds.
+    uint64_t LastCaptureTimeNs;
+
+    //! @brief The host time taken by the last call to
+    //! IArmSystem::restoreState(), in nanoseconds.
+    uint64_t LastRestoreTimeNs;
+
+    //! @brief Millions of instructions executed per second of host time.
+    double MIPS;
+
+    //! @brief The effective emulated processor clock speed in MHz.
+    double ClockMHz;
+
+    //! @brief The proportion of host time the emulation thread was
+    //! occupying a core, from 0.0 to 1.0.
+    double HostUtilisation;
+
+    //! @brief Normal interrupts taken per second of host time.
+    double IrqRate;
+
+    //! @brief Fast interrupts taken per second of host time.
+    double FastIrqRate;
+
+    //! @brief Memory mapped device accesses per second of host time.
+    double MmioAccessRate;
+
+    // Construction
+    SystemMetrics();
+
+    // Operations
+    void calculateRates(const SystemCounters &previous,
+                        const SystemCounters &current);
+    void formatPrometheus(std::string &buffer) const;
+    void formatJson(std::string &buffer) const;
+};
+
+//! @brief An object which allows the emulator thread to publish snapshots of
+//! SystemMetrics to be read from any other thread without locking.
+//! @details A sequence lock is used, readers retry if a snapshot is
+//! published while they are copying it.
+class SystemMetricsPublisher
+{
+public:
+    // Construction/Destruction
+    SystemMetricsPublisher();
+    ~SystemMetricsPublisher() = default;
+
+    // Accessors
+    uint64_t getPublishedCount() const;
+    SystemMetrics read() const;
+
+    // Operations
+    void publish(const SystemMetrics &metrics);
+private:
+    // Internal Constants
+    static constexpr size_t WordCount = sizeof(SystemMetrics) / sizeof(uint64_t);
+    static_assert((WordCount * sizeof(uint64_t)) == sizeof(SystemMetrics),
+                  "SystemMetrics must be made up of whole 64-bit fields.");
+
+    // Internal Fields
+    std::atomic_uint64_t _sequence;
+    std::atomic_uint64_t _words[WordCount];
+};
+
+//! @brief An object which periodically writes the metrics published by an
+//! emulated system to a file or socket on a background thread.
+class MetricsExporter
+{
+public:
+    // Public Constants
+    //! @brief The default period between updates written by the exporter.
+    static constexpr std::chrono::milliseconds DefaultInterval =
+        std::chrono::milliseconds(1000);
+
+    // Construction/Destruction
+    MetricsExporter();
+    ~MetricsExporter();
+
+    // Accessors
+    bool isRunning() const;
+    uint64_t getWriteFailureCount() const;
+
+    // Operations
+    bool tryStart(const SystemMetricsPublisher &source, MetricsTarget target,
+                  MetricsFormat format, const std::string &path,
+                  std::string &error,
+                  std::chrono::milliseconds interval = DefaultInterval);
+    void stop();
+private:
+    // Internal Functions
+    void run();
+    bool tryExport(const SystemMetrics &metrics);
+    bool tryWriteFile(const std::string &text);
+    bool tryWriteSocket(const std::string &text);
+    void closeSocket();
+
+    // Internal Fields
+    std::mutex _lock;
+    std::condition_variable _wakeUp;
+    std::thread _thread;
+    std::string _path;
+    std::string _buffer;
+    std::chrono::milliseconds _interval;
+    const SystemMetricsPublisher *_source;
+    std::atomic_uint64_t _writeFailureCount;
+    intptr_t _socket;
+    MetricsTarget _target;
+    MetricsFormat _format;
+    bool _isStopping;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
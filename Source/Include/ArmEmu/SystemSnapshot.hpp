@@ -0,0 +1,106 @@
+//! @file ArmEmu/SystemSnapshot.hpp
+//! @brief The declaration of objects which capture and restore the state of
+//! an emulated system in host memory.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_SYSTEM_SNAPSHOT_HPP__
+#define __ARM_EMU_SYSTEM_SNAPSHOT_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+
+#include <type_traits>
+#include <vector>
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief An object which holds the captured state of an emulated system as
+//! an opaque block of host memory.
+//! @details A snapshot is only meaningful to the system instance which
+//! captured it, as it can contain pointers to objects owned by that system.
+//! The buffer is retained between captures so that repeatedly capturing the
+//! same system doesn't allocate memory.
+class SystemSnapshot
+{
+public:
+    // Construction/Destruction
+    SystemSnapshot() = default;
+    ~SystemSnapshot() = default;
+
+    // Accessors
+    bool isEmpty() const;
+    size_t getSize() const;
+    const uint8_t *getData() const;
+
+    // Operations
+    void clear();
+    void write(const void *data, size_t byteCount);
+
+    //! @brief Appends the bytes of a value to the snapshot.
+    //! @tparam T The data type of the value, which must be trivially copyable.
+    //! @param[in] value The value to append.
+    template<typename T>
+    void writeValue(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable values can be captured.");
+
+        write(&value, sizeof(T));
+    }
+private:
+    // Internal Fields
+    std::vector<uint8_t> _data;
+};
+
+//! @brief An object which reads state back out of a SystemSnapshot in the
+//! order it was written.
+class SnapshotReader
+{
+public:
+    // Construction/Destruction
+    SnapshotReader(const SystemSnapshot &snapshot);
+    ~SnapshotReader() = default;
+
+    // Accessors
+    bool isComplete() const;
+    bool hasFailed() const;
+
+    // Operations
+    bool read(void *data, size_t byteCount);
+
+    //! @brief Reads the bytes of a value from the snapshot.
+    //! @tparam T The data type of the value, which must be trivially copyable.
+    //! @param[out] value Receives the value read.
+    //! @retval true The value was read.
+    //! @retval false The snapshot didn't contain enough data, value is
+    //! unmodified.
+    template<typename T>
+    bool readValue(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "Only trivially copyable values can be restored.");
+
+        return read(&value, sizeof(T));
+    }
+private:
+    // Internal Fields
+    const uint8_t *_position;
+    const uint8_t *_end;
+    bool _hasFailed;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
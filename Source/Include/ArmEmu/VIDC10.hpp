@@ -1,4 +1,4 @@
-//! @file ArmEmu/name_here.hpp
+//! @file ArmEmu/VIDC10.hpp
 //! @brief The declaration of an object which emulates the function of the
 //! VL86C310 VIDC part.
 //! @author GiantRobotLemur@na-se.co.uk
@@ -15,23 +15,190 @@
 // Dependent Header Files
 ////////////////////////////////////////////////////////////////////////////////
 #include "AddressMap.hpp"
+#include "SystemContext.hpp"
 
 namespace Mo {
 namespace Arm {
 
+////////////////////////////////////////////////////////////////////////////////
+// Data Type Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief Identifies VIDC registers by the value in the top 6 bits of the
+//! word written to the VIDC, the address written to is not significant.
+struct VidcRegister
+{
+    //! @brief The first of 16 logical colour palette registers.
+    static constexpr uint8_t PaletteBase = 0;       // 0x00 - 0x3C
+
+    //! @brief The border colour register.
+    static constexpr uint8_t Border = 16;           // 0x40
+
+    //! @brief The first of 3 cursor colour registers.
+    static constexpr uint8_t CursorBase = 17;       // 0x44 - 0x4C
+
+    //! @brief The first of 8 stereo image position registers.
+    static constexpr uint8_t StereoBase = 24;       // 0x60 - 0x7C
+
+    //! @brief The first of 16 display timing registers, the horizontal cycle
+    //! register. They are ordered as the fields of VidcTiming::Register.
+    static constexpr uint8_t TimingBase = 32;       // 0x80 - 0xBC
+
+    //! @brief The sound frequency register.
+    static constexpr uint8_t SoundFrequency = 48;   // 0xC0
+
+    //! @brief The control register.
+    static constexpr uint8_t Control = 56;          // 0xE0
+};
+
+//! @brief The colours programmed into the VIDC palette registers.
+//! @details Physical colours are 13-bit values, bits 0-3 are red, 4-7 green
+//! and 8-11 blue. Bit 12 is the external supremacy bit which doesn't affect
+//! the colour displayed.
+struct VidcPalette
+{
+    // Public Constants
+    //! @brief The count of logical colours in the palette.
+    static constexpr uint8_t ColourCount = 16;
+
+    //! @brief The count of colours the cursor can display.
+    static constexpr uint8_t CursorColourCount = 3;
+
+    // Public Fields
+    //! @brief The physical colours of each logical colour.
+    uint16_t Colours[ColourCount];
+
+    //! @brief The physical colour of the border.
+    uint16_t Border;
+
+    //! @brief The physical colours of cursor pixel values 1 to 3.
+    uint16_t Cursor[CursorColourCount];
+
+    // Construction
+    VidcPalette();
+
+    // Accessors
+    bool operator==(const VidcPalette &rhs) const;
+    bool operator!=(const VidcPalette &rhs) const;
+    uint16_t getColour256(uint8_t pixel) const;
+
+    static uint32_t toHostColour(uint16_t physicalColour);
+};
+
+//! @brief The display geometry described by the VIDC timing and control
+//! registers.
+//! @details Horizontal positions are in pixels and vertical positions in
+//! raster lines, both measured from the start of the sync pulse.
+struct VidcTiming
+{
+    // Public Fields
+    //! @brief The total count of pixels in a raster line.
+    uint16_t HorzCycle;
+
+    //! @brief The first pixel of the left border.
+    uint16_t HorzBorderStart;
+
+    //! @brief The first pixel of the display area.
+    uint16_t HorzDisplayStart;
+
+    //! @brief The first pixel beyond the display area.
+    uint16_t HorzDisplayEnd;
+
+    //! @brief The first pixel beyond the right border.
+    uint16_t HorzBorderEnd;
+
+    //! @brief The position of the left edge of the cursor.
+    uint16_t HorzCursorStart;
+
+    //! @brief The total count of raster lines in a field.
+    uint16_t VertCycle;
+
+    //! @brief The first raster line of the top border.
+    uint16_t VertBorderStart;
+
+    //! @brief The first raster line of the display area.
+    uint16_t VertDisplayStart;
+
+    //! @brief The first raster line beyond the display area.
+    uint16_t VertDisplayEnd;
+
+    //! @brief The first raster line beyond the bottom border.
+    uint16_t VertBorderEnd;
+
+    //! @brief The first raster line of the cursor.
+    uint16_t VertCursorStart;
+
+    //! @brief The first raster line beyond the cursor.
+    uint16_t VertCursorEnd;
+
+    //! @brief The count of bits per pixel as a power of 2, 0 to 3.
+    uint8_t BitsPerPixelPow2;
+
+    //! @brief The pixel rate selected, 0 to 3 for 8, 12, 16 and 24 MHz.
+    uint8_t PixelRate;
+
+    // Public Constants
+    //! @brief The width of the cursor in pixels.
+    static constexpr uint8_t CursorWidth = 32;
+
+    //! @brief The count of bytes of cursor image data per raster line.
+    static constexpr uint8_t CursorBytesPerLine = CursorWidth / 4;
+
+    // Construction
+    VidcTiming();
+
+    // Accessors
+    bool isValid() const;
+    bool isSameDisplay(const VidcTiming &rhs) const;
+    uint16_t getFrameWidth() const;
+    uint16_t getFrameHeight() const;
+    uint16_t getDisplayWidth() const;
+    uint16_t getDisplayHeight() const;
+    uint32_t getDisplayBytesPerLine() const;
+    uint32_t getPixelClockHz() const;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
 class MemcHardware;
+class Options;
 
 //! @brief An object which emulates the function of the VL86C310 VIDC part.
+//! @details The raster is followed using a GuestTask, either a line at a
+//! time or, by default, a frame at a time. At the start of vertical flyback
+//! the IOC IR interrupt is raised and the display published to the host.
+//! Memory cycles taken by video and cursor DMA are taken from the processor.
+//! A second task requests sound DMA from MEMC at the rate set by the sound
+//! frequency register.
 class VIDC10 : public IMMIOBlock
 {
 public:
+    // Public Constants
+    //! @brief The count of display timing registers.
+    static constexpr uint8_t TimingRegisterCount = 16;
+
+    //! @brief The count of stereo image position registers.
+    static constexpr uint8_t StereoRegisterCount = 8;
+
     // Construction/Destruction
-    VIDC10(MemcHardware &parent);
+    VIDC10(MemcHardware &parent, const Options &options);
     virtual ~VIDC10() = default;
 
+    // Accessors
+    const VidcPalette &getPalette() const;
+    VidcTiming getTiming() const;
+    uint64_t getFrameCount() const;
+    uint64_t getStolenCycleCount() const;
+    uint64_t getSoundSampleCount() const;
+    uint32_t getSoundSampleRate() const;
+    uint16_t getTimingRegister(uint8_t index) const;
+    uint8_t getStereoPosition(uint8_t channel) const;
+    uint16_t getSoundFrequency() const;
+    uint16_t getControlRegister() const;
+
+    // Operations
+    void writeRegister(uint32_t value);
+
     // Overrides
     virtual RegionType getType() const override;
     virtual Ag::string_cref_t getName() const override;
@@ -41,10 +208,38 @@ public:
     virtual uint32_t read(uint32_t offset) override;
     virtual void write(uint32_t offset, uint32_t value) override;
     virtual void connect(const ConnectionContext &context) override;
+    virtual void captureState(SystemSnapshot &snapshot) const override;
+    virtual void restoreState(SnapshotReader &reader) override;
 private:
+    // Internal Functions
+    void beginFrame(uint64_t startTicks);
+    uint64_t getLineStartTicks(uint16_t line) const;
+    uint32_t getLineDmaCycles(uint16_t line) const;
+    void onVerticalFlyback(SystemContext &guestContext);
+    static void onRasterDue(SystemContext &guestContext, uintptr_t taskContext);
+    uint64_t getSoundBlockTicks() const;
+    static void onSoundDue(SystemContext &guestContext, uintptr_t taskContext);
+
     // Internal Fields
     MemcHardware &_parent;
     SystemContext *_context;
+    GuestTask _rasterTask;
+    GuestTask _soundTask;
+    VidcPalette _palette;
+    VidcTiming _frameTiming;
+    uint64_t _frameStartTicks;
+    uint64_t _frameTicks;
+    uint64_t _frameCount;
+    uint64_t _stolenCycleCount;
+    uint64_t _soundSampleCount;
+    uint32_t _displayDmaCycles;
+    uint32_t _frameDmaCycles;
+    uint16_t _timing[TimingRegisterCount];
+    uint8_t _stereoPositions[StereoRegisterCount];
+    uint16_t _soundFrequency;
+    uint16_t _control;
+    uint16_t _rasterLine;
+    bool _isScanlineTimingEnabled;
 };
 
 }} // namespace Mo::Arm
@@ -0,0 +1,179 @@
+//! @file ArmEmu/VideoOutput.hpp
+//! @brief The declaration of objects which hand snapshots of the emulated
+//! display from the emulation thread to a render thread.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_VIDEO_OUTPUT_HPP__
+#define __ARM_EMU_VIDEO_OUTPUT_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FrameConverter.hpp"
+#include "VIDC10.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+//! @brief A consistent snapshot of the state of the emulated display taken
+//! at vertical sync.
+//! @details Only the video memory of lines marked as dirty is captured, the
+//! rest is left as it was when the snapshot object was last used.
+struct VideoFrame
+{
+    // Public Fields
+    //! @brief The colours programmed into the VIDC.
+    VidcPalette Palette;
+
+    //! @brief The geometry of the frame.
+    VidcTiming Timing;
+
+    //! @brief The video memory of each line of the display area,
+    //! VidcTiming::getDisplayBytesPerLine() bytes each.
+    std::vector<uint8_t> Display;
+
+    //! @brief The cursor image, VidcTiming::CursorBytesPerLine bytes for each
+    //! line from VertCursorStart to VertCursorEnd.
+    std::vector<uint8_t> Cursor;
+
+    //! @brief One bit for each line of the frame, starting at VertBorderStart,
+    //! set if the line has changed since the previous snapshot was read.
+    std::vector<uint64_t> DirtyLines;
+
+    //! @brief The number of the snapshot, incremented for each published.
+    uint64_t Sequence;
+
+    //! @brief True if video DMA was enabled, otherwise the display area is
+    //! rendered as border.
+    bool IsDisplayEnabled;
+
+    // Construction
+    VideoFrame();
+
+    // Accessors
+    bool isLineDirty(uint16_t index) const;
+    uint32_t getDirtyLineCount() const;
+
+    // Operations
+    void markLineDirty(uint16_t index);
+    uint32_t render(FrameConverter &converter, uint32_t *target,
+                    size_t stride) const;
+};
+
+//! @brief A lock-free triple buffer which passes VideoFrame snapshots from
+//! the emulation thread to a single render thread.
+//! @details The producer always has a frame to write into and the consumer
+//! always has the latest published frame to read, neither ever waits for the
+//! other. Frames published faster than they are read are replaced, so a
+//! producer must carry the dirty lines of a frame still pending into the
+//! next it publishes.
+class VideoFrameExchange
+{
+public:
+    // Construction/Destruction
+    VideoFrameExchange();
+    ~VideoFrameExchange() = default;
+
+    // Accessors
+    uint64_t getPublishedCount() const;
+    bool isPending() const;
+
+    // Operations
+    VideoFrame &getBackFrame();
+    void publish();
+    const VideoFrame *tryAcquire();
+    void requestFullRefresh();
+    bool tryTakeRefreshRequest();
+private:
+    // Internal Constants
+    static constexpr uint8_t IndexMask = 0x03;
+    static constexpr uint8_t PendingFlag = 0x04;
+
+    // Internal Fields
+    VideoFrame _frames[3];
+    std::atomic_uint64_t _publishedCount;
+    std::atomic_uint8_t _middle;
+    std::atomic_bool _isRefreshRequested;
+    uint8_t _back;
+    uint8_t _front;
+};
+
+//! @brief An interface to an object which displays frames produced by a
+//! VideoRenderThread.
+class IVideoPresenter
+{
+public:
+    // Construction/Destruction
+    virtual ~IVideoPresenter() = default;
+
+    // Operations
+    //! @brief Called on the render thread each time the frame is updated.
+    //! @param[in] pixels The host pixels of the entire frame, including
+    //! border, as produced by VidcPalette::toHostColour().
+    //! @param[in] width The count of pixels in each line.
+    //! @param[in] height The count of lines.
+    //! @param[in] sequence The VideoFrame::Sequence of the last snapshot
+    //! rendered.
+    //! @note The pixels are only valid for the duration of the call.
+    virtual void onFrameRendered(const uint32_t *pixels, uint32_t width,
+                                 uint32_t height, uint64_t sequence) = 0;
+};
+
+//! @brief An object which converts VideoFrame snapshots into host pixels on
+//! a dedicated thread so that emulation and presentation can proceed on
+//! separate cores.
+//! @details The host should call notifyFramePending() when it receives a
+//! HostMessageID::VideoFrameReady message from the emulated system.
+class VideoRenderThread
+{
+public:
+    // Construction/Destruction
+    VideoRenderThread();
+    ~VideoRenderThread();
+
+    // Accessors
+    bool isRunning() const;
+    uint64_t getRenderedFrameCount() const;
+
+    // Operations
+    bool tryStart(VideoFrameExchange &source, IVideoPresenter *presenter);
+    void stop();
+    void notifyFramePending();
+private:
+    // Internal Functions
+    void run();
+    void renderFrame(const VideoFrame &frame);
+
+    // Internal Fields
+    std::mutex _lock;
+    std::condition_variable _wakeUp;
+    std::thread _thread;
+    FrameConverter _converter;
+    std::vector<uint32_t> _pixels;
+    VidcTiming _geometry;
+    VideoFrameExchange *_source;
+    IVideoPresenter *_presenter;
+    std::atomic_uint64_t _renderedFrameCount;
+    bool _isPending;
+    bool _isStopping;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,186 @@
+//! @file ArmEmu/WD1772.hpp
+//! @brief The declaration of an object which emulates the function of the
+//! WD1772 floppy disc controller and the drives attached to it.
+//! @author GiantRobotLemur@na-se.co.uk
+//! @date 2024
+//! @copyright This file is part of the Mighty Oak project which is released
+//! under LGPL 3 license. See LICENSE file at the repository root or go to
+//! https://github.com/GiantRobotLemur/MightyOak for full license details.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __ARM_EMU_WD1772_HPP__
+#define __ARM_EMU_WD1772_HPP__
+
+////////////////////////////////////////////////////////////////////////////////
+// Dependent Header Files
+////////////////////////////////////////////////////////////////////////////////
+#include <string>
+
+#include "AddressMap.hpp"
+#include "DiscImage.hpp"
+#include "SystemContext.hpp"
+
+namespace Mo {
+namespace Arm {
+
+////////////////////////////////////////////////////////////////////////////////
+// Class Declarations
+////////////////////////////////////////////////////////////////////////////////
+class IOC;
+class Options;
+class WD1772;
+
+//! @brief An object which emulates the latch which selects the floppy drive
+//! and side the WD1772 operates on.
+//! @details Bits 0-3 select drives 0-3 when low, bit 4 selects side 1 when
+//! low. The other bits drive the motor and in-use lines of the drive and are
+//! ignored, the WD1772 controls its own motor.
+class FloppyDriveLatch : public IMMIOBlock
+{
+public:
+    // Public Constants
+    //! @brief The physical address of the latch in an Archimedes system, IOC
+    //! bank 5, latch A.
+    static constexpr uint32_t BaseAddress = 0x3350040;
+
+    // Construction/Destruction
+    FloppyDriveLatch(WD1772 &parent);
+    virtual ~FloppyDriveLatch() = default;
+
+    // Overrides
+    virtual RegionType getType() const override;
+    virtual Ag::string_cref_t getName() const override;
+    virtual Ag::string_cref_t getDescription() const override;
+    virtual uint32_t getSize() const override;
+
+    virtual uint32_t read(uint32_t offset) override;
+    virtual void write(uint32_t offset, uint32_t value) override;
+    virtual void connect(const ConnectionContext &context) override;
+private:
+    // Internal Fields
+    WD1772 &_parent;
+    SystemContext *_context;
+};
+
+//! @brief An object which emulates the function of the WD1772 floppy disc
+//! controller and the drives attached to it.
+//! @details Disc images are mapped into memory, see DiscImage, and bytes
+//! are transferred through the data register directly from the mapping. DRQ
+//! drives IOC FH0 and INTRQ drives FH1. By default transfers, steps and
+//! spin-up take as long as on a real drive. In fast disc mode commands
+//! complete as soon as the guest has moved the data, see
+//! Options::setFastDisc().
+//! @note Read Track and Write Track aren't supported and fail with Record
+//! Not Found.
+class WD1772 : public IMMIOBlock
+{
+public:
+    // Public Constants
+    //! @brief The physical address of the controller registers in an
+    //! Archimedes system, IOC bank 1, synchronous access.
+    static constexpr uint32_t BaseAddress = 0x3310000;
+
+    //! @brief The maximum count of drives which can be attached.
+    static constexpr uint8_t MaxDriveCount = 4;
+
+    //! @brief The highest physical track the drive head can be stepped to.
+    static constexpr uint8_t MaxHeadTrack = 83;
+
+    // Construction/Destruction
+    WD1772(const Options &options);
+    virtual ~WD1772() = default;
+
+    // Accessors
+    uint8_t getDriveCount() const;
+    bool isFastDiscEnabled() const;
+    const DiscImage &getDisc(uint8_t drive) const;
+    uint8_t getHeadTrack(uint8_t drive) const;
+    FloppyDriveLatch &getDriveLatch();
+
+    // Operations
+    bool tryInsertDisc(uint8_t drive, const std::string &fileName,
+                       bool isWriteProtected, std::string &error);
+    void ejectDisc(uint8_t drive);
+    uint32_t flushDiscs();
+    void selectDrive(uint8_t latchValue);
+
+    // Overrides
+    virtual RegionType getType() const override;
+    virtual Ag::string_cref_t getName() const override;
+    virtual Ag::string_cref_t getDescription() const override;
+    virtual uint32_t getSize() const override;
+
+    virtual uint32_t read(uint32_t offset) override;
+    virtual void write(uint32_t offset, uint32_t value) override;
+    virtual void connect(const ConnectionContext &context) override;
+    virtual void captureState(SystemSnapshot &snapshot) const override;
+    virtual void restoreState(SnapshotReader &reader) override;
+private:
+    // Internal Types
+    //! @brief Identifies the stage of the command being executed.
+    enum class Phase : uint8_t
+    {
+        Idle,
+        Searching,
+        Reading,
+        Writing,
+        Completing,
+    };
+
+    // Internal Functions
+    DiscImage *getSelectedDisc();
+    uint64_t toTicks(uint64_t microseconds) const;
+    uint64_t getRotationTicks(uint32_t position, uint32_t count) const;
+    void schedule(Phase phase, uint64_t delayTicks);
+    void setDataRequest(bool isActive);
+    void setInterruptRequest(bool isActive);
+    void beginCommand(uint8_t command);
+    void forceInterrupt(uint8_t condition);
+    void completeCommand(uint8_t statusBits);
+    void updateMotorState();
+    void findSector();
+    bool attachTransfer();
+    void transferByte();
+    void completeSector();
+    uint8_t readData();
+    void writeData(uint8_t value);
+    uint8_t readStatus();
+    static void onTaskDue(SystemContext &guestContext, uintptr_t taskContext);
+
+    // Internal Fields
+    DiscImage _discs[MaxDriveCount];
+    FloppyDriveLatch _latch;
+    SystemContext *_context;
+    IOC *_ioController;
+    GuestTask _task;
+    const uint8_t *_readBuffer;
+    uint8_t *_writeBuffer;
+    uint64_t _idleSinceTicks;
+    uint32_t _transferOffset;
+    uint32_t _transferSize;
+    uint8_t _idField[6];
+    uint8_t _heldSector[1024];
+    uint8_t _headTracks[MaxDriveCount];
+    uint8_t _driveCount;
+    uint8_t _selectedDrive;
+    uint8_t _selectedSide;
+    uint8_t _command;
+    uint8_t _status;
+    uint8_t _track;
+    uint8_t _sector;
+    uint8_t _data;
+    uint8_t _stepDirection;
+    uint8_t _pendingStatus;
+    uint8_t _nextAddressSector;
+    Phase _phase;
+    bool _isMotorOn;
+    bool _isTypeIStatus;
+    bool _isDataRequestActive;
+    bool _isInterruptRequestActive;
+    bool _isFastDiscEnabled;
+};
+
+}} // namespace Mo::Arm
+
+#endif // Header guard
+////////////////////////////////////////////////////////////////////////////////
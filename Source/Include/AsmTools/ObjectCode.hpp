@@ -28,6 +28,27 @@ namespace Asm {
 ////////////////////////////////////////////////////////////////////////////////
 using SymbolMap = std::unordered_map<Ag::String, uint32_t>;
 
+//! @brief Maps a range of assembled instructions back to the source code
+//! statement which produced them.
+struct SourceLineMapping
+{
+    //! @brief The address of the first byte of the instructions.
+    uint32_t Address;
+
+    //! @brief The count of bytes of object code the statement produced.
+    uint32_t Size;
+
+    //! @brief The name of the file containing the statement.
+    Ag::String FileName;
+
+    //! @brief The 1-based index of the line containing the statement.
+    int LineNo;
+};
+
+//! @brief A table of instruction addresses and the source lines which
+//! produced them, in ascending address order.
+using LineTable = std::vector<SourceLineMapping>;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class Declarations
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +60,8 @@ public:
     ObjectCode();
     ObjectCode(std::vector<uint8_t> &&machineCode, SymbolMap &&symbolMap,
                uint32_t loadAddress);
+    ObjectCode(std::vector<uint8_t> &&machineCode, SymbolMap &&symbolMap,
+               LineTable &&lineTable, uint32_t loadAddress);
     ~ObjectCode();
 
     // Accessors
@@ -47,6 +70,7 @@ public:
     size_t getCodeSize() const;
     uint32_t getLoadAddress() const;
     const SymbolMap &getSymbols() const;
+    const LineTable &getLineTable() const;
 private:
     // Internal Functions
     void clear();
@@ -54,6 +78,7 @@ private:
     // Internal Fields
     std::vector<uint8_t> _code;
     SymbolMap _symbols;
+    LineTable _lines;
     uint32_t _loadAddress;
 };
 